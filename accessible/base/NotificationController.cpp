@@ -203,6 +203,15 @@ NotificationController::WillRefresh(mozilla::TimeStamp aTime)
       return;
   }
 
+  // Materialize a slice of the subtrees the windowed initial tree build put
+  // off. The per-tick budget means a huge document grows its off-screen tree
+  // over several refresh ticks instead of blocking the client attach.
+  if (mDocument->HasDeferredCacheRoots()) {
+    mDocument->CacheDeferredSubtrees();
+    if (!mDocument)
+      return;
+  }
+
   // Process rendered text change notifications.
   mTextHash.EnumerateEntries(TextEnumerator, mDocument);
   mTextHash.Clear();
@@ -297,6 +306,7 @@ NotificationController::WillRefresh(mozilla::TimeStamp aTime)
   if (mContentInsertions.IsEmpty() && mNotifications.IsEmpty() &&
       mEvents.IsEmpty() && mTextHash.Count() == 0 &&
       mHangingChildDocuments.IsEmpty() &&
+      !mDocument->HasDeferredCacheRoots() &&
       mDocument->HasLoadState(DocAccessible::eCompletelyLoaded) &&
       mPresShell->RemoveRefreshObserver(this, Flush_Display)) {
     mObservingState = eNotObservingRefresh;
@@ -84,6 +84,7 @@ DocAccessible::
   mDocumentNode(aDocument),
   mScrollPositionChangedTicks(0),
   mLoadState(eTreeConstructionPending), mDocFlags(0), mLoadEventType(0),
+  mWindowedTreeBuild(false), mCacheBudget(0),
   mVirtualCursor(nullptr),
   mPresShell(aPresShell), mIPCDoc(nullptr)
 {
@@ -470,6 +471,7 @@ DocAccessible::Shutdown()
 
   mDependentIDsHash.Clear();
   mNodeToAccessibleMap.Clear();
+  mDeferredCacheRoots.Clear();
 
   {
     // We're about to get rid of all of our children so there won't be anything
@@ -1410,6 +1412,13 @@ DocAccessible::NotifyOfLoading(bool aIsReloading)
   FireDelayedEvent(stateEvent);
 }
 
+// Number of accessibles the initial tree build may create before it starts
+// deferring off-screen subtrees, and the number a deferred slice may create
+// per refresh tick thereafter. Documents smaller than the initial budget are
+// built in one go exactly as before.
+static const uint32_t kInitialTreeBuildBudget = 5000;
+static const uint32_t kDeferredTreeBuildBudget = 2000;
+
 void
 DocAccessible::DoInitialUpdate()
 {
@@ -1428,9 +1437,15 @@ DocAccessible::DoInitialUpdate()
   }
 
   // Build initial tree.  Since its the initial tree there's no group info to
-  // invalidate.
+  // invalidate. The build is windowed: once the budget runs out, subtrees
+  // scrolled out of the viewport are put off until later refresh ticks, so
+  // attach time scales with visible content rather than document size.
+  mWindowedTreeBuild = true;
+  mCacheBudget = kInitialTreeBuildBudget;
   AutoTreeMutation mut(this, false);
   CacheChildrenInSubtree(this);
+  mWindowedTreeBuild = false;
+  mCacheBudget = 0;
 
   // Fire reorder event after the document tree is constructed. Note, since
   // this reorder event is processed by parent document then events targeted to
@@ -1865,6 +1880,8 @@ DocAccessible::CacheChildrenInSubtree(Accessible* aRoot,
     *aFocusedAcc = aRoot;
 
   aRoot->EnsureChildren();
+  if (mCacheBudget)
+    mCacheBudget--;
 
   // Make sure we create accessible tree defined in DOM only, i.e. if accessible
   // provides specific tree (like XUL trees) then tree creation is handled by
@@ -1874,8 +1891,16 @@ DocAccessible::CacheChildrenInSubtree(Accessible* aRoot,
     Accessible* child = aRoot->ContentChildAt(idx);
     NS_ASSERTION(child, "Illicit tree change while tree is created!");
     // Don't cross document boundaries.
-    if (child && child->IsContent())
+    if (child && child->IsContent()) {
+      // If the windowed build used up its budget then put off subtrees the
+      // user can't see yet; CacheDeferredSubtrees builds them in later ticks.
+      if (mWindowedTreeBuild && !mCacheBudget &&
+          ShouldDeferSubtreeCache(child)) {
+        mDeferredCacheRoots.AppendElement(child);
+        continue;
+      }
       CacheChildrenInSubtree(child, aFocusedAcc);
+    }
   }
 
   // Fire document load complete on ARIA documents.
@@ -1887,6 +1912,59 @@ DocAccessible::CacheChildrenInSubtree(Accessible* aRoot,
   }
 }
 
+bool
+DocAccessible::ShouldDeferSubtreeCache(Accessible* aAcc) const
+{
+  nsIFrame* frame = aAcc->GetFrame();
+  if (!frame)
+    return false;
+
+  nsIFrame* rootFrame = mPresShell->GetRootFrame();
+  if (!rootFrame)
+    return false;
+
+  // Compare against the viewport extended by a screen height in both
+  // directions so that content a small scroll away is still built eagerly.
+  nsRect visibleArea = PresContext()->GetVisibleArea();
+  visibleArea.Inflate(0, visibleArea.height);
+
+  nsRect bounds = frame->GetVisualOverflowRect();
+  bounds.MoveBy(frame->GetOffsetTo(rootFrame));
+  return !bounds.Intersects(visibleArea);
+}
+
+void
+DocAccessible::CacheDeferredSubtrees()
+{
+  // Run with a fresh budget so that every tick creates a bounded number of
+  // accessibles; subtrees that are still off screen when the budget runs out
+  // get deferred again.
+  mWindowedTreeBuild = true;
+  mCacheBudget = kDeferredTreeBuildBudget;
+
+  uint32_t idx = 0;
+  while (idx < mDeferredCacheRoots.Length() && mCacheBudget) {
+    Accessible* root = mDeferredCacheRoots[idx++];
+    if (root->IsDefunct() || !root->IsInDocument())
+      continue;
+
+    {
+      // The subtree is brand new so there's no group info to invalidate.
+      AutoTreeMutation mut(root, false);
+      CacheChildrenInSubtree(root);
+    }
+
+    // Clients may have walked into the placeholder already; let them know its
+    // children showed up.
+    nsRefPtr<AccReorderEvent> reorderEvent = new AccReorderEvent(root);
+    FireDelayedEvent(reorderEvent);
+  }
+  mDeferredCacheRoots.RemoveElementsAt(0, idx);
+
+  mWindowedTreeBuild = false;
+  mCacheBudget = 0;
+}
+
 void
 DocAccessible::UncacheChildrenInSubtree(Accessible* aRoot)
 {
@@ -493,6 +493,27 @@ protected:
   void CacheChildrenInSubtree(Accessible* aRoot,
                               Accessible** aFocusedAcc = nullptr);
 
+  /**
+   * Return true if the given accessible's subtree may be left unconstructed
+   * for now because it's scrolled well out of the viewport. Used by
+   * CacheChildrenInSubtree when the tree is built in windowed mode.
+   */
+  bool ShouldDeferSubtreeCache(Accessible* aAcc) const;
+
+  /**
+   * Return true if initial tree construction put off any subtrees.
+   */
+  bool HasDeferredCacheRoots() const
+    { return !mDeferredCacheRoots.IsEmpty(); }
+
+  /**
+   * Create accessible subtrees that were deferred by windowed tree
+   * construction. Creates a bounded number of accessibles per call; the
+   * notification controller calls this once per refresh tick until no
+   * deferred subtrees remain.
+   */
+  void CacheDeferredSubtrees();
+
   /**
    * Remove accessibles in subtree from node to accessible map.
    */
@@ -644,6 +665,27 @@ protected:
    */
   nsTArray<nsIContent*> mInvalidationList;
 
+  /**
+   * Roots of subtrees whose accessible construction was deferred because they
+   * were scrolled out of the viewport while the tree was being built in
+   * windowed mode.
+   *
+   * @see CacheDeferredSubtrees
+   */
+  nsTArray<nsRefPtr<Accessible> > mDeferredCacheRoots;
+
+  /**
+   * True while the accessible tree is constructed in windowed mode, i.e.
+   * off-screen subtrees may be deferred once the build budget is used up.
+   */
+  bool mWindowedTreeBuild;
+
+  /**
+   * Number of accessibles the current windowed tree build may still visit
+   * before off-screen subtrees start being deferred.
+   */
+  uint32_t mCacheBudget;
+
   /**
    * Used to process notification from core and accessible events.
    */
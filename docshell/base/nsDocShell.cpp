@@ -132,6 +132,8 @@
 
 #include "nsPIDOMWindow.h"
 #include "nsGlobalWindow.h"
+#include "jsapi.h"
+#include "js/GCAPI.h"
 #include "nsPIWindowRoot.h"
 #include "nsICachingChannel.h"
 #include "nsIMultiPartChannel.h"
@@ -857,6 +859,7 @@ nsDocShell::nsDocShell():
     mAffectPrivateSessionLifetime(true),
     mInvisible(false),
     mHasLoadedNonBlankURI(false),
+    mSessionStateChangeCount(0),
     mDefaultLoadFlags(nsIRequest::LOAD_NORMAL),
     mFrameType(eFrameTypeRegular),
     mOwnOrContainingAppId(nsIScriptSecurityManager::UNKNOWN_APP_ID),
@@ -1957,11 +1960,15 @@ nsDocShell::SetCurrentURI(nsIURI *aURI, nsIRequest *aRequest,
     }
 
     mCurrentURI = NS_TryToMakeImmutable(aURI);
-    
+
     if (!NS_IsAboutBlank(mCurrentURI)) {
       mHasLoadedNonBlankURI = true;
     }
 
+    // The current URI is part of what session store captures for this
+    // docshell, so any change to it dirties the stored state.
+    ++mSessionStateChangeCount;
+
     bool isRoot = false;   // Is this the root docshell
     bool isSubFrame = false;  // Is this a subframe navigation?
 
@@ -2320,6 +2327,15 @@ nsDocShell::GetHasLoadedNonBlankURI(bool* aResult)
     return NS_OK;
 }
 
+NS_IMETHODIMP
+nsDocShell::GetSessionStateChangeCount(uint64_t* aResult)
+{
+    NS_ENSURE_ARG_POINTER(aResult);
+
+    *aResult = mSessionStateChangeCount;
+    return NS_OK;
+}
+
 NS_IMETHODIMP
 nsDocShell::GetUseRemoteTabs(bool* aUseRemoteTabs)
 {
@@ -2889,22 +2905,22 @@ nsDocShell::PopProfileTimelineMarkers(JSContext* aCx,
   nsTArray<mozilla::dom::ProfileTimelineMarker> profileTimelineMarkers;
 
   // If we see an unpaired START, we keep it around for the next call
-  // to PopProfileTimelineMarkers.  We store the kept START objects in
+  // to PopProfileTimelineMarkers.  We store the kept START records in
   // this array.
-  nsTArray<TimelineMarker*> keptMarkers;
+  nsTArray<TimelineMarkerRecord> keptMarkers;
 
   for (uint32_t i = 0; i < mProfileTimelineMarkers.Length(); ++i) {
-    TimelineMarker* startPayload = mProfileTimelineMarkers[i];
-    const char* startMarkerName = startPayload->GetName();
+    // Copy, since we may remove the record from the buffer below.
+    TimelineMarkerRecord startRecord = mProfileTimelineMarkers[i];
 
     bool hasSeenPaintedLayer = false;
-    bool isPaint = strcmp(startMarkerName, "Paint") == 0;
+    bool isPaint = strcmp(startRecord.mName, "Paint") == 0;
 
     // If we are processing a Paint marker, we append information from
     // all the embedded Layer markers to this array.
     mozilla::dom::Sequence<mozilla::dom::ProfileTimelineLayerRect> layerRectangles;
 
-    if (startPayload->GetMetaData() == TRACING_INTERVAL_START) {
+    if (startRecord.mMetaData == TRACING_INTERVAL_START) {
       bool hasSeenEnd = false;
 
       // DOM events can be nested, so we must take care when searching
@@ -2916,23 +2932,29 @@ nsDocShell::PopProfileTimelineMarkers(JSContext* aCx,
       // enough for the amount of markers to always be small enough that the
       // nested for loop isn't going to be a performance problem.
       for (uint32_t j = i + 1; j < mProfileTimelineMarkers.Length(); ++j) {
-        TimelineMarker* endPayload = mProfileTimelineMarkers[j];
-        const char* endMarkerName = endPayload->GetName();
+        const TimelineMarkerRecord& endRecord = mProfileTimelineMarkers[j];
 
         // Look for Layer markers to stream out paint markers.
-        if (isPaint && strcmp(endMarkerName, "Layer") == 0) {
+        if (isPaint && strcmp(endRecord.mName, "Layer") == 0) {
           hasSeenPaintedLayer = true;
-          endPayload->AddLayerRectangles(layerRectangles);
+          endRecord.mDetails->AddLayerRectangles(layerRectangles);
         }
 
-        if (!startPayload->Equals(endPayload)) {
+        // Only consult the detail payloads when both markers have one;
+        // detail-free records match by name, which is what the base
+        // TimelineMarker::Equals does anyway.
+        if (startRecord.mDetails && endRecord.mDetails) {
+          if (!startRecord.mDetails->Equals(endRecord.mDetails)) {
+            continue;
+          }
+        } else if (strcmp(startRecord.mName, endRecord.mName) != 0) {
           continue;
         }
 
         // Pair start and end markers.
-        if (endPayload->GetMetaData() == TRACING_INTERVAL_START) {
+        if (endRecord.mMetaData == TRACING_INTERVAL_START) {
           ++markerDepth;
-        } else if (endPayload->GetMetaData() == TRACING_INTERVAL_END) {
+        } else if (endRecord.mMetaData == TRACING_INTERVAL_END) {
           if (markerDepth > 0) {
             --markerDepth;
           } else {
@@ -2940,13 +2962,13 @@ nsDocShell::PopProfileTimelineMarkers(JSContext* aCx,
             if (!isPaint || (isPaint && hasSeenPaintedLayer)) {
               mozilla::dom::ProfileTimelineMarker marker;
 
-              marker.mName = NS_ConvertUTF8toUTF16(startPayload->GetName());
-              marker.mStart = startPayload->GetTime();
-              marker.mEnd = endPayload->GetTime();
+              marker.mName = NS_ConvertUTF8toUTF16(startRecord.mName);
+              marker.mStart = startRecord.mTime;
+              marker.mEnd = endRecord.mTime;
               if (isPaint) {
                 marker.mRectangles.Construct(layerRectangles);
-              } else {
-                startPayload->AddDetails(marker);
+              } else if (startRecord.mDetails) {
+                startRecord.mDetails->AddDetails(marker);
               }
               profileTimelineMarkers.AppendElement(marker);
             }
@@ -2961,7 +2983,7 @@ nsDocShell::PopProfileTimelineMarkers(JSContext* aCx,
 
       // If we did not see the corresponding END, keep the START.
       if (!hasSeenEnd) {
-        keptMarkers.AppendElement(mProfileTimelineMarkers[i]);
+        keptMarkers.AppendElement(startRecord);
         mProfileTimelineMarkers.RemoveElementAt(i);
         --i;
       }
@@ -2996,8 +3018,13 @@ nsDocShell::AddProfileTimelineMarker(const char* aName,
 {
 #ifdef MOZ_ENABLE_PROFILER_SPS
   if (mProfileTimelineRecording) {
-    TimelineMarker* marker = new TimelineMarker(this, aName, aMetaData);
-    mProfileTimelineMarkers.AppendElement(marker);
+    // Common detail-free markers are recorded straight into the flat
+    // buffer, without allocating a TimelineMarker.
+    TimelineMarkerRecord* record = mProfileTimelineMarkers.AppendElement();
+    record->mName = aName;
+    Now(&record->mTime);
+    record->mMetaData = aMetaData;
+    record->mDetails = nullptr;
   }
 #endif
 }
@@ -3007,7 +3034,11 @@ nsDocShell::AddProfileTimelineMarker(UniquePtr<TimelineMarker>& aMarker)
 {
 #ifdef MOZ_ENABLE_PROFILER_SPS
   if (mProfileTimelineRecording) {
-    mProfileTimelineMarkers.AppendElement(aMarker.release());
+    TimelineMarkerRecord* record = mProfileTimelineMarkers.AppendElement();
+    record->mName = aMarker->GetName();
+    record->mTime = aMarker->GetTime();
+    record->mMetaData = aMarker->GetMetaData();
+    record->mDetails = aMarker.release();
   }
 #endif
 }
@@ -3017,7 +3048,7 @@ nsDocShell::ClearProfileTimelineMarkers()
 {
 #ifdef MOZ_ENABLE_PROFILER_SPS
   for (uint32_t i = 0; i < mProfileTimelineMarkers.Length(); ++i) {
-    delete mProfileTimelineMarkers[i];
+    delete mProfileTimelineMarkers[i].mDetails;
   }
   mProfileTimelineMarkers.Clear();
 #endif
@@ -5639,6 +5670,10 @@ nsDocShell::Destroy()
     // Make sure we don't record profile timeline markers anymore
     SetRecordProfileTimelineMarkers(false);
 
+    // The compaction timer must not outlive us; its callback holds a raw
+    // pointer back to this docshell.
+    CancelHiddenTabCompaction();
+
     // Remove our pref observers
     if (mObserveErrorPages) {
         mObserveErrorPages = false;
@@ -6040,6 +6075,21 @@ nsDocShell::SetIsActive(bool aIsActive)
         }
     }
 
+    // Hidden-tab memory compaction. Only the root docshell of a content
+    // tree owns the timer; CompactHiddenTab walks the whole subtree when
+    // it fires.
+    if (mItemType == typeContent) {
+        nsCOMPtr<nsIDocShellTreeItem> sameTypeParent;
+        GetSameTypeParent(getter_AddRefs(sameTypeParent));
+        if (!sameTypeParent) {
+            if (aIsActive) {
+                CancelHiddenTabCompaction();
+            } else {
+                ScheduleHiddenTabCompaction();
+            }
+        }
+    }
+
     return NS_OK;
 }
 
@@ -6050,6 +6100,149 @@ nsDocShell::GetIsActive(bool *aIsActive)
     return NS_OK;
 }
 
+void
+nsDocShell::ScheduleHiddenTabCompaction()
+{
+    if (mCompactHiddenTabTimer || mIsBeingDestroyed)
+        return;
+
+    if (!Preferences::GetBool("docshell.hidden_tab_compaction.enabled",
+                              false)) {
+        return;
+    }
+
+    int32_t delaySeconds =
+        Preferences::GetInt("docshell.hidden_tab_compaction.delay_seconds",
+                            600);
+    if (delaySeconds <= 0)
+        return;
+
+    nsCOMPtr<nsITimer> timer = do_CreateInstance(NS_TIMER_CONTRACTID);
+    if (!timer)
+        return;
+
+    nsresult rv =
+        timer->InitWithFuncCallback(CompactHiddenTabTimerCallback, this,
+                                    delaySeconds * 1000,
+                                    nsITimer::TYPE_ONE_SHOT);
+    if (NS_SUCCEEDED(rv))
+        mCompactHiddenTabTimer = timer;
+}
+
+void
+nsDocShell::CancelHiddenTabCompaction()
+{
+    if (mCompactHiddenTabTimer) {
+        mCompactHiddenTabTimer->Cancel();
+        mCompactHiddenTabTimer = nullptr;
+    }
+}
+
+/* static */ void
+nsDocShell::CompactHiddenTabTimerCallback(nsITimer *aTimer, void *aClosure)
+{
+    // The timer holds no reference to the docshell; it is cancelled from
+    // Destroy() before the docshell goes away.
+    static_cast<nsDocShell*>(aClosure)->CompactHiddenTab();
+}
+
+void
+nsDocShell::CompactHiddenTab()
+{
+    mCompactHiddenTabTimer = nullptr;
+
+    if (mIsActive || mIsBeingDestroyed)
+        return;
+
+    bool preparedZone = false;
+    CollectHiddenTabMemory(&preparedZone);
+
+    // One shrinking GC covers every zone the walk scheduled, returning
+    // free GC chunks and shrunk heap arenas to the OS.
+    if (preparedZone && mScriptGlobal) {
+        if (JSObject *global = mScriptGlobal->GetGlobalJSObject())
+            JS::ShrinkingGC(JS_GetObjectRuntime(global),
+                            JS::gcreason::PAGE_HIDE);
+    }
+}
+
+void
+nsDocShell::CollectHiddenTabMemory(bool *aPreparedZone)
+{
+    if (mScriptGlobal) {
+        // Drop decoded image data; it is redecoded on demand if the tab
+        // is shown again.
+        nsCOMPtr<nsIDocument> doc = mScriptGlobal->GetExtantDoc();
+        if (doc)
+            doc->RequestDiscardOfImages();
+
+        if (JSObject *global = mScriptGlobal->GetGlobalJSObject()) {
+            JS::PrepareZoneForGC(JS::GetObjectZone(global));
+            *aPreparedZone = true;
+        }
+    }
+
+    // Sweep unused style data back into the presentation arena's free pages.
+    nsCOMPtr<nsIPresShell> presShell = GetPresShell();
+    if (presShell)
+        presShell->CompactMemory();
+
+    nsTObserverArray<nsDocLoader*>::ForwardIterator iter(mChildList);
+    while (iter.HasMore()) {
+        nsCOMPtr<nsIDocShell> docshell = do_QueryObject(iter.GetNext());
+        if (docshell) {
+            nsRefPtr<nsDocShell> child =
+                docshell.forget().downcast<nsDocShell>();
+            child->CollectHiddenTabMemory(aPreparedZone);
+        }
+    }
+}
+
+NS_IMETHODIMP
+nsDocShell::Warmup()
+{
+    if (mIsActive || mIsBeingDestroyed)
+        return NS_OK;
+
+    if (!Preferences::GetBool("docshell.tab_warming.enabled", true))
+        return NS_OK;
+
+    // The user is probably about to switch here; a pending compaction
+    // would only throw away what we are warming up.
+    CancelHiddenTabCompaction();
+
+    WarmupPresentation();
+    return NS_OK;
+}
+
+void
+nsDocShell::WarmupPresentation()
+{
+    nsCOMPtr<nsIPresShell> presShell = GetPresShell();
+    if (presShell) {
+        // Queue redecode of the images the presentation knows to be
+        // visible; the decoding itself runs on the image decode pool.
+        presShell->WarmUpVisibleImages();
+
+        // Schedule a paint so the refresh driver rebuilds the layer tree
+        // (and uploads its textures) ahead of the first composite after
+        // the switch.
+        nsIFrame* rootFrame = presShell->GetRootFrame();
+        if (rootFrame)
+            rootFrame->SchedulePaint();
+    }
+
+    nsTObserverArray<nsDocLoader*>::ForwardIterator iter(mChildList);
+    while (iter.HasMore()) {
+        nsCOMPtr<nsIDocShell> docshell = do_QueryObject(iter.GetNext());
+        if (docshell) {
+            nsRefPtr<nsDocShell> child =
+                docshell.forget().downcast<nsDocShell>();
+            child->WarmupPresentation();
+        }
+    }
+}
+
 NS_IMETHODIMP
 nsDocShell::SetIsAppTab(bool aIsAppTab)
 {
@@ -11469,6 +11662,10 @@ nsDocShell::AddState(JS::Handle<JS::Value> aData, const nsAString& aTitle,
         CopyFavicon(oldURI, newURI, mInPrivateBrowsing);
     }
     else {
+        // SetCurrentURI was not called, but the state object (and possibly
+        // the session history entry) changed, so the stored session state
+        // for this docshell is stale all the same.
+        ++mSessionStateChangeCount;
         FireDummyOnLocationChange();
     }
     document->SetStateObject(scContainer);
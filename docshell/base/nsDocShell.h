@@ -337,6 +337,21 @@ public:
         nsString mCause;
     };
 
+    // A single entry in the timeline marker buffer.  The fields every
+    // marker carries are stored inline in a flat record, so that the
+    // common detail-free markers can be appended without allocating
+    // anything; markers that carry extra details (causes, event phases,
+    // layer rectangles) also own a TimelineMarker payload, which is
+    // only consulted when the buffer is drained through
+    // PopProfileTimelineMarkers.
+    struct TimelineMarkerRecord
+    {
+        const char* mName; // always a static string
+        DOMHighResTimeStamp mTime;
+        TracingMetadata mMetaData;
+        TimelineMarker* mDetails; // owned; null for detail-free markers
+    };
+
     // Add new profile timeline markers to this docShell. This will only add
     // markers if the docShell is currently recording profile timeline markers.
     // See nsIDocShell::recordProfileTimelineMarkers
@@ -754,6 +769,20 @@ protected:
     bool DoAppRedirectIfNeeded(nsIURI * aURI,
                                nsIDocShellLoadInfo * aLoadInfo,
                                bool aFirstParty);
+
+    // Hidden-tab memory compaction. When the root docshell of a content
+    // tree stays inactive past the pref'd delay, CompactHiddenTab walks the
+    // subtree discarding decoded images, sweeping unused style data and
+    // scheduling each window's JS zone for one shrinking GC.
+    void ScheduleHiddenTabCompaction();
+    void CancelHiddenTabCompaction();
+    void CompactHiddenTab();
+    void CollectHiddenTabMemory(bool * aPreparedZone);
+    static void CompactHiddenTabTimerCallback(nsITimer * aTimer,
+                                              void * aClosure);
+
+    // Speculative tab warming; the recursive part of nsIDocShell::warmup().
+    void WarmupPresentation();
 protected:
     nsresult GetCurScrollPos(int32_t scrollOrientation, int32_t * curPos);
     nsresult SetCurScrollPosEx(int32_t curHorizontalPos, int32_t curVerticalPos);
@@ -883,6 +912,10 @@ protected:
     // Checked in nsMixedContentBlocker, to see if the channels match.
     nsCOMPtr<nsIChannel>       mMixedContentChannel;
 
+    // One-shot timer started when a content root docshell becomes inactive;
+    // fires CompactHiddenTab(). Cancelled on reactivation and in Destroy().
+    nsCOMPtr<nsITimer>         mCompactHiddenTabTimer;
+
     // WEAK REFERENCES BELOW HERE.
     // Note these are intentionally not addrefd.  Doing so will create a cycle.
     // For that reasons don't use nsCOMPtr.
@@ -997,6 +1030,10 @@ protected:
     bool                       mAffectPrivateSessionLifetime;
     bool                       mInvisible;
     bool                       mHasLoadedNonBlankURI;
+
+    // @see nsIDocShell::sessionStateChangeCount
+    uint64_t                   mSessionStateChangeCount;
+
     uint64_t                   mHistoryID;
     uint32_t                   mDefaultLoadFlags;
 
@@ -1036,7 +1073,7 @@ private:
     // True if recording profiles.
     bool mProfileTimelineRecording;
 
-    nsTArray<TimelineMarker*> mProfileTimelineMarkers;
+    nsTArray<TimelineMarkerRecord> mProfileTimelineMarkers;
 
     // Get rid of all the timeline markers accumulated so far
     void ClearProfileTimelineMarkers();
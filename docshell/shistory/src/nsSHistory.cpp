@@ -26,6 +26,7 @@
 #include "nsCOMArray.h"
 #include "nsDocShell.h"
 #include "mozilla/Attributes.h"
+#include "nsIDocument.h"
 #include "nsISHEntry.h"
 #include "nsISHTransaction.h"
 #include "nsISHistoryListener.h"
@@ -240,6 +241,23 @@ EvictContentViewerForTransaction(nsISHTransaction *aTrans)
   }
 }
 
+// Partial retention: keep the cached presentation but drop its decoded
+// image data.  The frame tree survives, so a back navigation to this
+// entry still avoids a full reload; the images are redecoded on demand.
+void
+DiscardImagesForTransaction(nsISHTransaction *aTrans)
+{
+  nsCOMPtr<nsIContentViewer> viewer = GetContentViewerForTransaction(aTrans);
+  if (!viewer) {
+    return;
+  }
+
+  nsIDocument* doc = viewer->GetDocument();
+  if (doc) {
+    doc->RequestDiscardOfImages();
+  }
+}
+
 } // anonymous namespace
 
 //*****************************************************************************
@@ -1026,9 +1044,14 @@ namespace {
 class TransactionAndDistance
 {
 public:
-  TransactionAndDistance(nsISHTransaction *aTrans, uint32_t aDist)
+  TransactionAndDistance(nsISHTransaction *aTrans, uint32_t aDist,
+                         uint32_t aRevisitCount)
     : mTransaction(aTrans)
+    , mLastTouched(0)
     , mDistance(aDist)
+    , mRevisitCount(aRevisitCount)
+    , mKeepScore(0)
+    , mScrolledIntoPage(false)
   {
     mViewer = GetContentViewerForTransaction(aTrans);
     NS_ASSERTION(mViewer, "Transaction should have a content viewer");
@@ -1043,16 +1066,42 @@ public:
       NS_WARNING("Can't cast to nsISHEntryInternal?");
       mLastTouched = 0;
     }
+
+    if (shentry) {
+      int32_t scrollX = 0, scrollY = 0;
+      shentry->GetScrollPosition(&scrollX, &scrollY);
+      mScrolledIntoPage = scrollY > 0;
+    }
+  }
+
+  // Folds the eviction signals into a single revisit-likelihood score.
+  // Called once mDistance has reached its final value.  Distance from
+  // the current index dominates; the other signals together can promote
+  // an entry past at most one step of distance.
+  void ComputeKeepScore()
+  {
+    mKeepScore = -4 * mDistance;
+
+    // A page that recurs elsewhere in its session history is one the
+    // user keeps coming back to.
+    mKeepScore += int32_t(std::min(mRevisitCount, 3u));
+
+    // The user had scrolled into the page, so evicting the presentation
+    // also loses their place in it.
+    if (mScrolledIntoPage) {
+      mKeepScore += 2;
+    }
   }
 
   bool operator<(const TransactionAndDistance &aOther) const
   {
-    // Compare distances first, and fall back to last-accessed times.
-    if (aOther.mDistance != this->mDistance) {
-      return this->mDistance < aOther.mDistance;
+    // Sort the most evictable entries last: highest revisit likelihood
+    // first, with the most recently touched entry winning ties.
+    if (aOther.mKeepScore != this->mKeepScore) {
+      return this->mKeepScore > aOther.mKeepScore;
     }
 
-    return this->mLastTouched < aOther.mLastTouched;
+    return this->mLastTouched > aOther.mLastTouched;
   }
 
   bool operator==(const TransactionAndDistance &aOther) const
@@ -1060,7 +1109,7 @@ public:
     // This is a little silly; we need == so the default comaprator can be
     // instantiated, but this function is never actually called when we sort
     // the list of TransactionAndDistance objects.
-    return aOther.mDistance == this->mDistance &&
+    return aOther.mKeepScore == this->mKeepScore &&
            aOther.mLastTouched == this->mLastTouched;
   }
 
@@ -1068,6 +1117,9 @@ public:
   nsCOMPtr<nsIContentViewer> mViewer;
   uint32_t mLastTouched;
   int32_t mDistance;
+  uint32_t mRevisitCount;
+  int32_t mKeepScore;
+  bool mScrolledIntoPage;
 };
 
 } // anonymous namespace
@@ -1107,6 +1159,27 @@ nsSHistory::GloballyEvictContentViewers()
     int32_t startIndex = std::max(0, shist->mIndex - gHistoryMaxViewers);
     int32_t endIndex = std::min(shist->mLength - 1,
                               shist->mIndex + gHistoryMaxViewers);
+
+    // Collect the URI of every entry in this history, so that we can
+    // tell how often a cached page recurs in it.  A page the user keeps
+    // coming back to within a session is a likely back/forward target.
+    nsCOMArray<nsIURI> historyURIs;
+    {
+      nsCOMPtr<nsISHTransaction> walk;
+      shist->GetTransactionAtIndex(0, getter_AddRefs(walk));
+      while (walk) {
+        nsCOMPtr<nsISHEntry> entry;
+        walk->GetSHEntry(getter_AddRefs(entry));
+        nsCOMPtr<nsIURI> uri;
+        if (entry) {
+          entry->GetURI(getter_AddRefs(uri));
+        }
+        historyURIs.AppendObject(uri);
+        nsISHTransaction *temp = walk;
+        temp->GetNext(getter_AddRefs(walk));
+      }
+    }
+
     nsCOMPtr<nsISHTransaction> trans;
     shist->GetTransactionAtIndex(startIndex, getter_AddRefs(trans));
     for (int32_t i = startIndex; trans && i <= endIndex; i++) {
@@ -1131,7 +1204,33 @@ nsSHistory::GloballyEvictContentViewers()
         // If we didn't find a TransactionAndDistance for this content viewer, make a new
         // one.
         if (!found) {
-          TransactionAndDistance container(trans, DeprecatedAbs(i - shist->mIndex));
+          // Count how many other entries in this history share this
+          // entry's URI.
+          uint32_t revisits = 0;
+          nsCOMPtr<nsISHEntry> shentry;
+          trans->GetSHEntry(getter_AddRefs(shentry));
+          nsCOMPtr<nsIURI> uri;
+          if (shentry) {
+            shentry->GetURI(getter_AddRefs(uri));
+          }
+          if (uri) {
+            for (int32_t k = 0; k < historyURIs.Count(); ++k) {
+              bool sameURI = false;
+              if (historyURIs[k] &&
+                  NS_SUCCEEDED(uri->Equals(historyURIs[k], &sameURI)) &&
+                  sameURI) {
+                revisits++;
+              }
+            }
+            // Don't count the entry itself.
+            if (revisits > 0) {
+              revisits--;
+            }
+          }
+
+          TransactionAndDistance container(trans,
+                                           DeprecatedAbs(i - shist->mIndex),
+                                           revisits);
           shTransactions.AppendElement(container);
         }
       }
@@ -1152,10 +1251,14 @@ nsSHistory::GloballyEvictContentViewers()
     return;
   }
 
-  // If we need to evict, sort our list of transactions and evict the largest
-  // ones.  (We could of course get better algorithmic complexity here by using
-  // a heap or something more clever.  But sHistoryMaxTotalViewers isn't large,
-  // so let's not worry about it.)
+  // If we need to evict, compute each entry's revisit-likelihood score
+  // now that its distance is final, then sort our list of transactions
+  // and evict the lowest-scored ones.  (We could of course get better
+  // algorithmic complexity here by using a heap or something more clever.
+  // But sHistoryMaxTotalViewers isn't large, so let's not worry about it.)
+  for (uint32_t i = 0; i < transactions.Length(); ++i) {
+    transactions[i].ComputeKeepScore();
+  }
   transactions.Sort();
 
   for (int32_t i = transactions.Length() - 1;
@@ -1164,6 +1267,15 @@ nsSHistory::GloballyEvictContentViewers()
     EvictContentViewerForTransaction(transactions[i].mTransaction);
 
   }
+
+  // The surviving presentations with the lowest scores are retained only
+  // partially: their decoded image data is dropped, so that running near
+  // the viewer cap doesn't also keep a full complement of image memory
+  // alive.
+  for (int32_t i = sHistoryMaxTotalViewers - 1;
+       i >= sHistoryMaxTotalViewers / 2; --i) {
+    DiscardImagesForTransaction(transactions[i].mTransaction);
+  }
 }
 
 nsresult
@@ -6,13 +6,17 @@
 #include "mozilla/dom/DOMRect.h"
 
 #include "nsPresContext.h"
+#include "nsWrapperCacheInlines.h"
 #include "mozilla/dom/DOMRectListBinding.h"
 #include "mozilla/dom/DOMRectBinding.h"
 
 using namespace mozilla;
 using namespace mozilla::dom;
 
-NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE(DOMRectReadOnly, mParent)
+// Rects with a black preserved wrapper are known live and can stay out of
+// the CC graph.  Others must be traversed: a rect's mParent is often its
+// owning DOMRectList, which holds the rect right back through mArray.
+NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE_LEAF(DOMRectReadOnly, mParent)
 NS_IMPL_CYCLE_COLLECTING_ADDREF(DOMRectReadOnly)
 NS_IMPL_CYCLE_COLLECTING_RELEASE(DOMRectReadOnly)
 NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(DOMRectReadOnly)
@@ -31,7 +31,7 @@ protected:
 
 public:
   NS_DECL_CYCLE_COLLECTING_ISUPPORTS
-  NS_DECL_CYCLE_COLLECTION_SCRIPT_HOLDER_CLASS(DOMRectReadOnly)
+  NS_DECL_CYCLE_COLLECTION_SKIPPABLE_SCRIPT_HOLDER_CLASS(DOMRectReadOnly)
 
   explicit DOMRectReadOnly(nsISupports* aParent)
     : mParent(aParent)
@@ -0,0 +1,357 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=2 sw=2 et tw=79: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "WindowCapture.h"
+
+#include "gfxASurface.h"
+#include "gfxContext.h"
+#include "imgIEncoder.h"
+#include "mozilla/Base64.h"
+#include "mozilla/ClearOnShutdown.h"
+#include "mozilla/StaticPtr.h"
+#include "mozilla/Vector.h"
+#include "mozilla/unused.h"
+#include "mozilla/dom/Promise.h"
+#include "mozilla/gfx/2D.h"
+#include "mozilla/gfx/DataSurfaceHelpers.h"
+#include "nsCSSParser.h"
+#include "nsComponentManagerUtils.h"
+#include "nsContentUtils.h"
+#include "nsGlobalWindow.h"
+#include "nsIDocShell.h"
+#include "nsIInputStream.h"
+#include "nsIPresShell.h"
+#include "nsPresContext.h"
+#include "nsError.h"
+#include "nsRuleNode.h"
+#include "nsThreadUtils.h"
+
+#include <cmath>
+
+using namespace mozilla::gfx;
+
+namespace mozilla {
+namespace dom {
+
+// Captures tend to arrive at a steady rate (thumbnail services take a couple
+// of shots per second), so recycle the render surfaces instead of allocating
+// and freeing a multi-megabyte buffer for every shot.  The pool only ever
+// holds surfaces whose capture has completed; it is touched on the main
+// thread exclusively, which also keeps the non-atomic surface refcounts safe.
+static const size_t kMaxPooledCaptureSurfaces = 2;
+static StaticAutoPtr<nsTArray<RefPtr<DataSourceSurface>>> sCaptureSurfacePool;
+
+static TemporaryRef<DataSourceSurface>
+AcquireCaptureSurface(const IntSize& aSize)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (sCaptureSurfacePool) {
+    for (size_t i = 0; i < sCaptureSurfacePool->Length(); ++i) {
+      if ((*sCaptureSurfacePool)[i]->GetSize() == aSize) {
+        RefPtr<DataSourceSurface> surface = (*sCaptureSurfacePool)[i];
+        sCaptureSurfacePool->RemoveElementAt(i);
+        return surface.forget();
+      }
+    }
+  }
+
+  return Factory::CreateDataSourceSurface(aSize, SurfaceFormat::B8G8R8A8);
+}
+
+static void
+ReleaseCaptureSurface(DataSourceSurface* aSurface)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!sCaptureSurfacePool) {
+    sCaptureSurfacePool = new nsTArray<RefPtr<DataSourceSurface>>();
+    ClearOnShutdown(&sCaptureSurfacePool);
+  }
+  if (sCaptureSurfacePool->Length() < kMaxPooledCaptureSurfaces) {
+    sCaptureSurfacePool->AppendElement(aSurface);
+  }
+}
+
+// Runs back on the main thread once the encoder thread is done.  The promise
+// and the capture surface have non-atomic refcounts, so this event owns the
+// only references to them and both are created and released on the main
+// thread; the encoder thread never sees more than the raw mapped pixels.
+class CaptureCompleteEvent MOZ_FINAL : public nsRunnable
+{
+public:
+  CaptureCompleteEvent(Promise* aPromise,
+                       DataSourceSurface* aSurface,
+                       nsIThread* aEncoderThread)
+    : mPromise(aPromise)
+    , mSurface(aSurface)
+    , mEncoderThread(aEncoderThread)
+    , mRv(NS_ERROR_NOT_INITIALIZED)
+  {
+    MOZ_ASSERT(NS_IsMainThread());
+  }
+
+  NS_IMETHOD Run() MOZ_OVERRIDE
+  {
+    MOZ_ASSERT(NS_IsMainThread());
+
+    mSurface->Unmap();
+    ReleaseCaptureSurface(mSurface);
+    mSurface = nullptr;
+
+    if (NS_SUCCEEDED(mRv)) {
+      mPromise->MaybeResolve(NS_ConvertUTF8toUTF16(mDataURI));
+    } else {
+      mPromise->MaybeReject(mRv);
+    }
+    mPromise = nullptr;
+
+    mEncoderThread->Shutdown();
+    return NS_OK;
+  }
+
+  // Called on the encoder thread, strictly before this event is dispatched.
+  void SetResult(nsresult aRv, const nsACString& aDataURI)
+  {
+    mRv = aRv;
+    mDataURI = aDataURI;
+  }
+
+private:
+  virtual ~CaptureCompleteEvent() {}
+
+  nsRefPtr<Promise> mPromise;
+  RefPtr<DataSourceSurface> mSurface;
+  nsCOMPtr<nsIThread> mEncoderThread;
+  nsCString mDataURI;
+  nsresult mRv;
+};
+
+// Converts and encodes the mapped pixels on the encoder thread.  The encoder
+// performs the ARGB swizzle and unpremultiply itself (INPUT_FORMAT_HOSTARGB),
+// so none of the per-pixel work runs on the main thread.
+class CaptureEncodeRunnable MOZ_FINAL : public nsRunnable
+{
+public:
+  CaptureEncodeRunnable(imgIEncoder* aEncoder,
+                        uint8_t* aData,
+                        int32_t aStride,
+                        const IntSize& aSize,
+                        const nsACString& aMimeType,
+                        CaptureCompleteEvent* aCompleteEvent)
+    : mEncoder(aEncoder)
+    , mData(aData)
+    , mStride(aStride)
+    , mSize(aSize)
+    , mMimeType(aMimeType)
+    , mCompleteEvent(aCompleteEvent)
+  {}
+
+  nsresult Encode(nsACString& aDataURI)
+  {
+    nsresult rv =
+      mEncoder->InitFromData(mData,
+                             BufferSizeFromStrideAndHeight(mStride,
+                                                           mSize.height),
+                             mSize.width,
+                             mSize.height,
+                             mStride,
+                             imgIEncoder::INPUT_FORMAT_HOSTARGB,
+                             EmptyString());
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    nsCOMPtr<nsIInputStream> imgStream;
+    CallQueryInterface(mEncoder.get(), getter_AddRefs(imgStream));
+    if (!imgStream) {
+      return NS_ERROR_FAILURE;
+    }
+
+    uint64_t bufSize64;
+    rv = imgStream->Available(&bufSize64);
+    NS_ENSURE_SUCCESS(rv, rv);
+    NS_ENSURE_TRUE(bufSize64 < UINT32_MAX - 16, NS_ERROR_FILE_TOO_BIG);
+
+    // Leave some slack so the final read can report end-of-stream.
+    uint32_t bufSize = (uint32_t)bufSize64 + 16;
+    uint32_t imgSize = 0;
+    Vector<char> imgData;
+    if (!imgData.initCapacity(bufSize)) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+    uint32_t numReadThisTime = 0;
+    while ((rv = imgStream->Read(imgData.begin() + imgSize,
+                                 bufSize - imgSize,
+                                 &numReadThisTime)) == NS_OK &&
+           numReadThisTime > 0) {
+      imgData.growByUninitialized(numReadThisTime);
+      imgSize += numReadThisTime;
+      if (imgSize == bufSize) {
+        bufSize *= 2;
+        if (!imgData.resizeUninitialized(bufSize)) {
+          return NS_ERROR_OUT_OF_MEMORY;
+        }
+      }
+    }
+    NS_ENSURE_SUCCESS(rv, rv);
+    NS_ENSURE_TRUE(!imgData.empty(), NS_ERROR_FAILURE);
+
+    nsAutoCString encodedImg;
+    rv = Base64Encode(Substring(imgData.begin(), imgSize), encodedImg);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    aDataURI.AssignLiteral("data:");
+    aDataURI.Append(mMimeType);
+    aDataURI.AppendLiteral(";base64,");
+    aDataURI.Append(encodedImg);
+    return NS_OK;
+  }
+
+  NS_IMETHOD Run() MOZ_OVERRIDE
+  {
+    nsAutoCString dataURI;
+    nsresult rv = Encode(dataURI);
+    mCompleteEvent->SetResult(rv, dataURI);
+
+    rv = NS_DispatchToMainThread(mCompleteEvent);
+    if (NS_FAILED(rv)) {
+      // Better to leak the event than to release its main-thread-only
+      // members here.
+      mCompleteEvent.forget();
+    }
+    return rv;
+  }
+
+private:
+  virtual ~CaptureEncodeRunnable() {}
+
+  nsCOMPtr<imgIEncoder> mEncoder;
+  uint8_t* mData;
+  int32_t mStride;
+  const IntSize mSize;
+  nsAutoCString mMimeType;
+  nsRefPtr<CaptureCompleteEvent> mCompleteEvent;
+};
+
+/* static */ already_AddRefed<Promise>
+WindowCapture::CaptureToDataURL(const GlobalObject& aGlobal,
+                                nsGlobalWindow& aWindow,
+                                double aX, double aY, double aW, double aH,
+                                const nsAString& aMimeType,
+                                const nsAString& aBgColor,
+                                ErrorResult& aRv)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  nsCOMPtr<nsIGlobalObject> global = do_QueryInterface(aGlobal.GetAsSupports());
+  nsRefPtr<Promise> promise = Promise::Create(global, aRv);
+  if (aRv.Failed()) {
+    return nullptr;
+  }
+
+  // Protect against too-large surfaces that will cause allocation or
+  // overflow issues.
+  if (!gfxASurface::CheckSurfaceSize(gfxIntSize(int32_t(aW), int32_t(aH)),
+                                     0xffff) ||
+      aW < 1 || aH < 1) {
+    promise->MaybeReject(NS_ERROR_INVALID_ARG);
+    return promise.forget();
+  }
+
+  nsContentUtils::FlushLayoutForTree(&aWindow);
+
+  nsRefPtr<nsPresContext> presContext;
+  nsIDocShell* docshell = aWindow.GetDocShell();
+  if (docshell) {
+    docshell->GetPresContext(getter_AddRefs(presContext));
+  }
+  if (!presContext) {
+    promise->MaybeReject(NS_ERROR_FAILURE);
+    return promise.forget();
+  }
+
+  nscolor backgroundColor;
+  nsCSSValue value;
+  nsCSSParser parser;
+  if (!parser.ParseColorString(aBgColor, nullptr, 0, value) ||
+      !nsRuleNode::ComputeColor(value, presContext, nullptr,
+                                backgroundColor)) {
+    promise->MaybeReject(NS_ERROR_INVALID_ARG);
+    return promise.forget();
+  }
+
+  NS_ConvertUTF16toUTF8 mimeType(aMimeType);
+  nsAutoCString encoderCID(
+    NS_LITERAL_CSTRING("@mozilla.org/image/encoder;2?type=") + mimeType);
+  nsCOMPtr<imgIEncoder> encoder = do_CreateInstance(encoderCID.get());
+  if (!encoder) {
+    promise->MaybeReject(NS_IMAGELIB_ERROR_NO_ENCODER);
+    return promise.forget();
+  }
+
+  IntSize size(int32_t(ceil(aW)), int32_t(ceil(aH)));
+  RefPtr<DataSourceSurface> surface = AcquireCaptureSurface(size);
+  if (!surface) {
+    promise->MaybeReject(NS_ERROR_OUT_OF_MEMORY);
+    return promise.forget();
+  }
+
+  DataSourceSurface::MappedSurface map;
+  if (!surface->Map(DataSourceSurface::MapType::READ_WRITE, &map)) {
+    ReleaseCaptureSurface(surface);
+    promise->MaybeReject(NS_ERROR_FAILURE);
+    return promise.forget();
+  }
+
+  RefPtr<DrawTarget> dt =
+    Factory::CreateDrawTargetForData(BackendType::CAIRO, map.mData, size,
+                                     map.mStride, SurfaceFormat::B8G8R8A8);
+  if (!dt) {
+    surface->Unmap();
+    ReleaseCaptureSurface(surface);
+    promise->MaybeReject(NS_ERROR_FAILURE);
+    return promise.forget();
+  }
+
+  // The paint itself has to happen on the main thread; everything after it
+  // (swizzle, compression, base64) is handed to the encoder thread.
+  nsRect r(nsPresContext::CSSPixelsToAppUnits((float)aX),
+           nsPresContext::CSSPixelsToAppUnits((float)aY),
+           nsPresContext::CSSPixelsToAppUnits((float)aW),
+           nsPresContext::CSSPixelsToAppUnits((float)aH));
+  uint32_t renderDocFlags = (nsIPresShell::RENDER_IGNORE_VIEWPORT_SCROLLING |
+                             nsIPresShell::RENDER_DOCUMENT_RELATIVE);
+  nsRefPtr<gfxContext> thebes = new gfxContext(dt);
+  nsCOMPtr<nsIPresShell> shell = presContext->PresShell();
+  unused << shell->RenderDocument(r, renderDocFlags, backgroundColor, thebes);
+  dt->Flush();
+
+  nsCOMPtr<nsIThread> encoderThread;
+  nsresult rv = NS_NewThread(getter_AddRefs(encoderThread), nullptr);
+  if (NS_FAILED(rv)) {
+    surface->Unmap();
+    ReleaseCaptureSurface(surface);
+    promise->MaybeReject(rv);
+    return promise.forget();
+  }
+
+  nsRefPtr<CaptureCompleteEvent> completeEvent =
+    new CaptureCompleteEvent(promise, surface, encoderThread);
+  nsCOMPtr<nsIRunnable> event =
+    new CaptureEncodeRunnable(encoder, map.mData, map.mStride, size, mimeType,
+                              completeEvent);
+  rv = encoderThread->Dispatch(event, NS_DISPATCH_NORMAL);
+  if (NS_FAILED(rv)) {
+    encoderThread->Shutdown();
+    surface->Unmap();
+    ReleaseCaptureSurface(surface);
+    promise->MaybeReject(rv);
+  }
+
+  return promise.forget();
+}
+
+} // namespace dom
+} // namespace mozilla
@@ -0,0 +1,44 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=2 sw=2 et tw=79: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_dom_WindowCapture_h
+#define mozilla_dom_WindowCapture_h
+
+#include "nsCOMPtr.h"
+#include "nsStringGlue.h"
+
+class nsGlobalWindow;
+
+namespace mozilla {
+
+class ErrorResult;
+
+namespace dom {
+
+class GlobalObject;
+class Promise;
+
+/**
+ * Chrome-only window capture helper backing WindowCapture.webidl.
+ *
+ * The document is painted on the main thread into a recycled data surface;
+ * format conversion and image encoding then run on a background thread so
+ * that repeated captures (e.g. for thumbnailing) do not jank the UI.
+ */
+class WindowCapture
+{
+public:
+  static already_AddRefed<Promise>
+  CaptureToDataURL(const GlobalObject& aGlobal, nsGlobalWindow& aWindow,
+                   double aX, double aY, double aW, double aH,
+                   const nsAString& aMimeType, const nsAString& aBgColor,
+                   ErrorResult& aRv);
+};
+
+} // namespace dom
+} // namespace mozilla
+
+#endif // mozilla_dom_WindowCapture_h
@@ -0,0 +1,168 @@
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+# Reads nsGkAtomList.h and emits a perfect hash table over the atom
+# strings, as read-only data the compiler can place in the shared
+# .rodata segment.  Lookup on the C++ side (nsGkAtoms::GetAtomByString)
+# is two hashes, one displacement fetch and a single string compare.
+#
+# The scheme is hash-and-displace: atoms are grouped into buckets by one
+# hash, and each bucket is assigned a displacement that is XORed into a
+# second hash to produce a collision-free slot for every atom in the
+# bucket.  The displacements are found here at build time by trial;
+# if the search fails for some bucket, both hash bases are changed and
+# the whole table is rebuilt.
+
+from __future__ import print_function
+
+import re
+import sys
+
+ATOM_PATTERN = re.compile(r'^GK_ATOM\((\w+),\s*"([^"]*)"\)')
+
+FNV_PRIME = 16777619
+FNV_BASIS = 0x811c9dc5
+MASK32 = 0xffffffff
+
+NO_ATOM = 0xffff
+
+
+def fnv1a(string, basis):
+    """32-bit FNV-1a over the code units of an ASCII atom string.
+    Must match HashAtomString() in nsGkAtoms.cpp."""
+    result = basis
+    for char in string:
+        result = ((result ^ ord(char)) * FNV_PRIME) & MASK32
+    return result
+
+
+def next_power_of_two(n):
+    result = 1
+    while result < n:
+        result *= 2
+    return result
+
+
+def read_atoms(path):
+    """Returns (index, value) pairs, where index is the atom's position
+    in the GkAtoms_info array built from the same list."""
+    atoms = []
+    seen = set()
+    position = 0
+    with open(path) as f:
+        for line in f:
+            match = ATOM_PATTERN.match(line)
+            if not match:
+                continue
+            value = match.group(2)
+            # The atom table maps duplicate strings to a single atom, so
+            # only the first occurrence needs a slot.
+            if value not in seen:
+                seen.add(value)
+                atoms.append((position, value))
+            position += 1
+    return atoms
+
+
+def try_build(atoms, bucket_count, slot_count, bucket_basis, slot_basis):
+    bucket_mask = bucket_count - 1
+    slot_mask = slot_count - 1
+
+    buckets = [[] for _ in range(bucket_count)]
+    for index, value in atoms:
+        buckets[fnv1a(value, bucket_basis) & bucket_mask].append((index, value))
+
+    displacements = [0] * bucket_count
+    slots = [NO_ATOM] * slot_count
+
+    # Place the fullest buckets first, while the table is still empty.
+    order = sorted(range(bucket_count), key=lambda b: -len(buckets[b]))
+    for bucket in order:
+        members = buckets[bucket]
+        if not members:
+            continue
+        hashes = [fnv1a(value, slot_basis) for _, value in members]
+        for displacement in range(slot_count):
+            targets = [(h ^ displacement) & slot_mask for h in hashes]
+            if len(set(targets)) == len(targets) and \
+               all(slots[t] == NO_ATOM for t in targets):
+                for (index, _), target in zip(members, targets):
+                    slots[target] = index
+                displacements[bucket] = displacement
+                break
+        else:
+            return None
+    return displacements, slots
+
+
+def build(atoms):
+    if len(atoms) >= NO_ATOM:
+        raise Exception("too many atoms for a uint16_t slot table")
+
+    # Buckets average ~4 atoms; slots run at ~70% load.
+    bucket_count = next_power_of_two((len(atoms) + 3) // 4)
+    slot_count = next_power_of_two(len(atoms) * 3 // 2)
+
+    bucket_basis = FNV_BASIS
+    slot_basis = (FNV_BASIS * FNV_PRIME) & MASK32
+    for _ in range(64):
+        table = try_build(atoms, bucket_count, slot_count,
+                          bucket_basis, slot_basis)
+        if table:
+            return bucket_count, slot_count, bucket_basis, slot_basis, table
+        bucket_basis = (bucket_basis * FNV_PRIME + 1) & MASK32
+        slot_basis = (slot_basis * FNV_PRIME + 1) & MASK32
+    raise Exception("failed to find a perfect hash for the atom list")
+
+
+def verify(atoms, bucket_count, slot_count, bucket_basis, slot_basis, table):
+    displacements, slots = table
+    for index, value in atoms:
+        bucket = fnv1a(value, bucket_basis) & (bucket_count - 1)
+        slot = (fnv1a(value, slot_basis) ^ displacements[bucket]) & \
+               (slot_count - 1)
+        if slots[slot] != index:
+            raise Exception("self-check failed for atom '%s'" % value)
+
+
+def write_array(f, name, values):
+    f.write("static const uint16_t %s[%d] = {\n" % (name, len(values)))
+    for start in range(0, len(values), 8):
+        f.write("  %s,\n" % ", ".join("0x%04x" % v
+                                      for v in values[start:start + 8]))
+    f.write("};\n")
+
+
+def main(argv):
+    if len(argv) != 3:
+        print("usage: gkatomhash.py nsGkAtomList.h output.h",
+              file=sys.stderr)
+        return 1
+
+    atoms = read_atoms(argv[1])
+    if not atoms:
+        print("gkatomhash.py: no atoms found in %s" % argv[1],
+              file=sys.stderr)
+        return 1
+
+    bucket_count, slot_count, bucket_basis, slot_basis, table = build(atoms)
+    verify(atoms, bucket_count, slot_count, bucket_basis, slot_basis, table)
+    displacements, slots = table
+
+    with open(argv[2], "w") as f:
+        f.write("/* THIS FILE IS GENERATED BY gkatomhash.py "
+                "FROM nsGkAtomList.h.  DO NOT EDIT. */\n\n")
+        f.write("#define GKATOM_HASH_BUCKET_BASIS 0x%08xu\n" % bucket_basis)
+        f.write("#define GKATOM_HASH_SLOT_BASIS 0x%08xu\n" % slot_basis)
+        f.write("#define GKATOM_HASH_BUCKET_MASK 0x%x\n" % (bucket_count - 1))
+        f.write("#define GKATOM_HASH_SLOT_MASK 0x%x\n" % (slot_count - 1))
+        f.write("#define GKATOM_HASH_NO_ATOM 0x%04x\n\n" % NO_ATOM)
+        write_array(f, "sGkAtomDisplacements", displacements)
+        f.write("\n")
+        write_array(f, "sGkAtomSlots", slots)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -26,6 +26,7 @@
 #include "nsStyledElement.h"
 #include "nsIURI.h"
 #include "nsIDocument.h"
+#include "nsThreadUtils.h"
 #include <algorithm>
 
 using namespace mozilla;
@@ -120,6 +121,19 @@ MiscContainer::Evict()
 
 nsTArray<const nsAttrValue::EnumTable*>* nsAttrValue::sEnumTableArray = nullptr;
 
+// Cache of recently created attribute value string buffers, so that equal
+// short values produced independently (repeated class names and the like)
+// share one refcounted nsStringBuffer instead of each getting a private
+// copy.  The cache is direct mapped and bounded: a newly created buffer
+// simply replaces the previous occupant of its slot.  Main thread only.
+#define ATTR_VALUE_STRING_CACHE_SIZE 512
+
+// Only values up to this many characters are considered for sharing; longer
+// ones are unlikely to repeat and would monopolize the cache.
+#define ATTR_VALUE_STRING_CACHE_MAX_LEN 64
+
+static nsStringBuffer** sStringBufferCache = nullptr;
+
 nsAttrValue::nsAttrValue()
     : mBits(0)
 {
@@ -168,7 +182,9 @@ nsAttrValue::Init()
 
   sEnumTableArray = new nsTArray<const EnumTable*>;
   NS_ENSURE_TRUE(sEnumTableArray, NS_ERROR_OUT_OF_MEMORY);
-  
+
+  sStringBufferCache = new nsStringBuffer*[ATTR_VALUE_STRING_CACHE_SIZE]();
+
   return NS_OK;
 }
 
@@ -178,6 +194,16 @@ nsAttrValue::Shutdown()
 {
   delete sEnumTableArray;
   sEnumTableArray = nullptr;
+
+  if (sStringBufferCache) {
+    for (uint32_t i = 0; i < ATTR_VALUE_STRING_CACHE_SIZE; ++i) {
+      if (sStringBufferCache[i]) {
+        sStringBufferCache[i]->Release();
+      }
+    }
+    delete [] sStringBufferCache;
+    sStringBufferCache = nullptr;
+  }
 }
 
 nsAttrValue::ValueType
@@ -1876,6 +1902,24 @@ nsAttrValue::GetStringBuffer(const nsAString& aValue) const
     return buf.forget();
   }
 
+  // Short values repeat a lot across a document, so check whether we
+  // already hold a buffer with these contents and share it instead of
+  // allocating a duplicate.
+  nsStringBuffer** slot = nullptr;
+  if (sStringBufferCache && len <= ATTR_VALUE_STRING_CACHE_MAX_LEN &&
+      NS_IsMainThread()) {
+    uint32_t hash = HashString(aValue.BeginReading(), len);
+    slot = &sStringBufferCache[hash & (ATTR_VALUE_STRING_CACHE_SIZE - 1)];
+    nsStringBuffer* cached = *slot;
+    if (cached &&
+        (cached->StorageSize() / sizeof(char16_t) - 1) == len &&
+        !memcmp(cached->Data(), aValue.BeginReading(),
+                len * sizeof(char16_t))) {
+      cached->AddRef();
+      return dont_AddRef(cached);
+    }
+  }
+
   buf = nsStringBuffer::Alloc((len + 1) * sizeof(char16_t));
   if (!buf) {
     return nullptr;
@@ -1883,6 +1927,16 @@ nsAttrValue::GetStringBuffer(const nsAString& aValue) const
   char16_t *data = static_cast<char16_t*>(buf->Data());
   CopyUnicodeTo(aValue, 0, data, len);
   data[len] = char16_t(0);
+
+  if (slot) {
+    // Replace whatever occupied this slot; the cache holds its own
+    // reference so the buffer's contents stay valid for later comparisons.
+    if (*slot) {
+      (*slot)->Release();
+    }
+    *slot = buf;
+    (*slot)->AddRef();
+  }
   return buf.forget();
 }
 
@@ -21,6 +21,9 @@
 #include "nsFocusManager.h"
 #include "mozilla/dom/DataTransfer.h"
 
+#include "nsIContentIterator.h"
+#include "nsThreadUtils.h"
+
 #include "nsIDocShell.h"
 #include "nsIContentViewerEdit.h"
 #include "nsIClipboardDragDropHooks.h"
@@ -270,10 +273,105 @@ SelectionCopyHelper(nsISelection *aSel, nsIDocument *aDoc,
   return rv;
 }
 
+// Counts the nodes covered by the selection's ranges, stopping as soon as
+// aLimit is reached so that probing a huge selection stays cheap.
+static uint32_t
+CountSelectionNodes(nsISelection* aSel, uint32_t aLimit)
+{
+  uint32_t count = 0;
+  int32_t rangeCount = 0;
+  aSel->GetRangeCount(&rangeCount);
+  for (int32_t i = 0; i < rangeCount && count < aLimit; ++i) {
+    nsCOMPtr<nsIDOMRange> range;
+    aSel->GetRangeAt(i, getter_AddRefs(range));
+    if (!range)
+      continue;
+    nsCOMPtr<nsIContentIterator> iter = NS_NewContentIterator();
+    if (!iter || NS_FAILED(iter->Init(range)))
+      continue;
+    for (iter->First(); !iter->IsDone() && count < aLimit; iter->Next()) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+// Clones the selection's ranges into a standalone selection, so a deferred
+// copy serializes what the user selected even if the live selection moves
+// before the runnable gets to encode it.
+static nsresult
+SnapshotSelection(nsISelection* aSel, nsISelection** aSnapshot)
+{
+  *aSnapshot = nullptr;
+
+  nsCOMPtr<nsISelection> snapshot;
+  nsresult rv = NS_NewDomSelection(getter_AddRefs(snapshot));
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  int32_t rangeCount = 0;
+  aSel->GetRangeCount(&rangeCount);
+  for (int32_t i = 0; i < rangeCount; ++i) {
+    nsCOMPtr<nsIDOMRange> domRange;
+    rv = aSel->GetRangeAt(i, getter_AddRefs(domRange));
+    NS_ENSURE_SUCCESS(rv, rv);
+    NS_ENSURE_TRUE(domRange, NS_ERROR_FAILURE);
+    nsRefPtr<nsRange> clone = static_cast<nsRange*>(domRange.get())->CloneRange();
+    rv = snapshot->AddRange(clone);
+    NS_ENSURE_SUCCESS(rv, rv);
+  }
+
+  snapshot.swap(*aSnapshot);
+  return NS_OK;
+}
+
+// Carries a selection snapshot to a later main thread tick, where the
+// expensive nsDocumentEncoder passes run after the copy keypress has been
+// fully processed and painted. The DOM is main-thread-only, so the encoding
+// itself can't move to a background thread; deferring it keeps the input
+// event responsive and still populates the clipboard asynchronously.
+class DeferredHTMLCopyEvent : public nsRunnable
+{
+public:
+  DeferredHTMLCopyEvent(nsISelection* aSnapshot, nsIDocument* aDoc,
+                        int16_t aClipboardID)
+    : mSnapshot(aSnapshot)
+    , mDocument(aDoc)
+    , mClipboardID(aClipboardID)
+  {
+  }
+
+  NS_IMETHOD Run()
+  {
+    SelectionCopyHelper(mSnapshot, mDocument, true, mClipboardID,
+                        nsIDocumentEncoder::SkipInvisibleContent,
+                        nullptr);
+    return NS_OK;
+  }
+
+private:
+  nsCOMPtr<nsISelection> mSnapshot;
+  nsCOMPtr<nsIDocument> mDocument;
+  int16_t mClipboardID;
+};
+
 nsresult
 nsCopySupport::HTMLCopy(nsISelection* aSel, nsIDocument* aDoc,
                         int16_t aClipboardID)
 {
+  // Selections spanning at least this many nodes get their serialization
+  // deferred out of the copy event; small selections keep the synchronous
+  // path so the clipboard is populated before the caller returns. Zero
+  // disables the deferred path entirely.
+  uint32_t minNodes =
+    Preferences::GetUint("clipboard.async_copy.min_nodes", 4096);
+  if (minNodes && CountSelectionNodes(aSel, minNodes) >= minNodes) {
+    nsCOMPtr<nsISelection> snapshot;
+    if (NS_SUCCEEDED(SnapshotSelection(aSel, getter_AddRefs(snapshot)))) {
+      return NS_DispatchToCurrentThread(
+        new DeferredHTMLCopyEvent(snapshot, aDoc, aClipboardID));
+    }
+  }
+
   return SelectionCopyHelper(aSel, aDoc, true, aClipboardID,
                              nsIDocumentEncoder::SkipInvisibleContent,
                              nullptr);
@@ -37,21 +37,21 @@ nsDOMAttributeMap::nsDOMAttributeMap(Element* aContent)
 }
 
 /**
- * Clear map pointer for attributes.
+ * Clear map pointer for attributes and drop them from the cache.
  */
-PLDHashOperator
-RemoveMapRef(nsAttrHashKey::KeyType aKey, nsRefPtr<Attr>& aData,
-             void* aUserArg)
+static void
+RemoveMapRefs(nsDOMAttributeMap::AttrCache& aCache)
 {
-  aData->SetMap(nullptr);
-
-  return PL_DHASH_REMOVE;
+  for (uint32_t i = 0; i < aCache.Count(); ++i) {
+    aCache.DataAt(i)->SetMap(nullptr);
+  }
+  aCache.Clear();
 }
 
 nsDOMAttributeMap::~nsDOMAttributeMap()
 {
   if (mAttributeCache) {
-    mAttributeCache->Enumerate(RemoveMapRef, nullptr);
+    RemoveMapRefs(*mAttributeCache);
   }
 }
 
@@ -59,7 +59,7 @@ void
 nsDOMAttributeMap::DropReference()
 {
   if (mAttributeCache) {
-    mAttributeCache->Enumerate(RemoveMapRef, nullptr);
+    RemoveMapRefs(*mAttributeCache);
   }
   mContent = nullptr;
 }
@@ -73,21 +73,12 @@ NS_IMPL_CYCLE_COLLECTION_UNLINK_BEGIN(nsDOMAttributeMap)
 NS_IMPL_CYCLE_COLLECTION_UNLINK_END
 
 
-PLDHashOperator
-TraverseMapEntry(nsAttrHashKey::KeyType aKey, nsRefPtr<Attr>& aData,
-                 void* aUserArg)
-{
-  nsCycleCollectionTraversalCallback *cb = 
-    static_cast<nsCycleCollectionTraversalCallback*>(aUserArg);
-
-  cb->NoteXPCOMChild(static_cast<nsINode*>(aData.get()));
-
-  return PL_DHASH_NEXT;
-}
-
 NS_IMPL_CYCLE_COLLECTION_TRAVERSE_BEGIN(nsDOMAttributeMap)
   if (tmp->mAttributeCache) {
-    tmp->mAttributeCache->Enumerate(TraverseMapEntry, &cb);
+    for (uint32_t i = 0; i < tmp->mAttributeCache->Count(); ++i) {
+      cb.NoteXPCOMChild(
+        static_cast<nsINode*>(tmp->mAttributeCache->DataAt(i).get()));
+    }
   }
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE_SCRIPT_OBJECTS
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mContent)
@@ -129,22 +120,14 @@ NS_INTERFACE_MAP_END
 NS_IMPL_CYCLE_COLLECTING_ADDREF(nsDOMAttributeMap)
 NS_IMPL_CYCLE_COLLECTING_RELEASE(nsDOMAttributeMap)
 
-PLDHashOperator
-SetOwnerDocumentFunc(nsAttrHashKey::KeyType aKey,
-                     nsRefPtr<Attr>& aData,
-                     void* aUserArg)
-{
-  nsresult rv = aData->SetOwnerDocument(static_cast<nsIDocument*>(aUserArg));
-
-  return NS_FAILED(rv) ? PL_DHASH_STOP : PL_DHASH_NEXT;
-}
-
 nsresult
 nsDOMAttributeMap::SetOwnerDocument(nsIDocument* aDocument)
 {
   if (mAttributeCache) {
-    uint32_t n = mAttributeCache->Enumerate(SetOwnerDocumentFunc, aDocument);
-    NS_ENSURE_TRUE(n == mAttributeCache->Count(), NS_ERROR_FAILURE);
+    for (uint32_t i = 0; i < mAttributeCache->Count(); ++i) {
+      nsresult rv = mAttributeCache->DataAt(i)->SetOwnerDocument(aDocument);
+      NS_ENSURE_SUCCESS(rv, NS_ERROR_FAILURE);
+    }
   }
   return NS_OK;
 }
@@ -154,13 +137,10 @@ nsDOMAttributeMap::DropAttribute(int32_t aNamespaceID, nsIAtom* aLocalName)
 {
   nsAttrKey attr(aNamespaceID, aLocalName);
   if (mAttributeCache) {
-    Attr *node = mAttributeCache->GetWeak(attr);
-    if (node) {
+    nsRefPtr<Attr> node;
+    if (mAttributeCache->Remove(attr, &node)) {
       // Break link to map
       node->SetMap(nullptr);
-
-      // Remove from cache
-      mAttributeCache->Remove(attr);
     }
   }
 }
@@ -173,12 +153,9 @@ nsDOMAttributeMap::RemoveAttribute(mozilla::dom::NodeInfo* aNodeInfo)
   nsAttrKey attr(aNodeInfo->NamespaceID(), aNodeInfo->NameAtom());
 
   nsRefPtr<Attr> node;
-  if (mAttributeCache && mAttributeCache->Get(attr, getter_AddRefs(node))) {
+  if (mAttributeCache && mAttributeCache->Remove(attr, &node)) {
     // Break link to map
     node->SetMap(nullptr);
-
-    // Remove from cache
-    mAttributeCache->Remove(attr);
   } else {
     nsAutoString value;
     // As we are removing the attribute we need to set the current value in
@@ -199,7 +176,8 @@ nsDOMAttributeMap::GetAttribute(mozilla::dom::NodeInfo* aNodeInfo, bool aNsAware
   nsAttrKey attr(aNodeInfo->NamespaceID(), aNodeInfo->NameAtom());
 
   EnsureAttributeCache();
-  Attr* node = mAttributeCache->GetWeak(attr);
+  nsRefPtr<Attr>* cached = mAttributeCache->Lookup(attr);
+  Attr* node = cached ? cached->get() : nullptr;
   if (!node) {
     nsRefPtr<mozilla::dom::NodeInfo> ni = aNodeInfo;
     nsRefPtr<Attr> newAttr =
@@ -550,29 +528,33 @@ nsDOMAttributeMap::Count() const
 }
 
 uint32_t
-nsDOMAttributeMap::Enumerate(AttrCache::EnumReadFunction aFunc,
-                             void *aUserArg) const
+nsDOMAttributeMap::Enumerate(AttrEnumFunc aFunc, void *aUserArg) const
 {
-  return mAttributeCache ? mAttributeCache->EnumerateRead(aFunc, aUserArg) : 0;
-}
+  if (!mAttributeCache) {
+    return 0;
+  }
 
-size_t
-AttrCacheSizeEnumerator(const nsAttrKey& aKey,
-                        const nsRefPtr<Attr>& aValue,
-                        MallocSizeOf aMallocSizeOf,
-                        void* aUserArg)
-{
-  return aMallocSizeOf(aValue.get());
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < mAttributeCache->Count(); ++i) {
+    ++n;
+    if (aFunc(mAttributeCache->KeyAt(i), mAttributeCache->DataAt(i),
+              aUserArg) == PL_DHASH_STOP) {
+      break;
+    }
+  }
+  return n;
 }
 
 size_t
 nsDOMAttributeMap::SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const
 {
   size_t n = aMallocSizeOf(this);
-  n += mAttributeCache
-     ? mAttributeCache->SizeOfExcludingThis(AttrCacheSizeEnumerator,
-                                            aMallocSizeOf)
-     : 0;
+  if (mAttributeCache) {
+    n += mAttributeCache->SizeOfExcludingThis(aMallocSizeOf);
+    for (uint32_t i = 0; i < mAttributeCache->Count(); ++i) {
+      n += aMallocSizeOf(mAttributeCache->DataAt(i).get());
+    }
+  }
 
   // NB: mContent is non-owning and thus not counted.
   return n;
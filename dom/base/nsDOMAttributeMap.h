@@ -15,9 +15,11 @@
 #include "mozilla/dom/Attr.h"
 #include "mozilla/ErrorResult.h"
 #include "nsCycleCollectionParticipant.h"
+#include "nsAutoPtr.h"
 #include "nsIDOMMozNamedAttrMap.h"
-#include "nsRefPtrHashtable.h"
 #include "nsString.h"
+#include "nsTSmallSortedMap.h"
+#include "pldhash.h"
 #include "nsWrapperCache.h"
 
 class nsIAtom;
@@ -35,8 +37,8 @@ public:
   int32_t  mNamespaceID;
 
   /**
-   * The atom for attribute, weak ref. is fine as we only use it for the
-   * hashcode, we never dereference it.
+   * The atom for attribute, weak ref. is fine as we only compare it,
+   * we never dereference it.
    */
   nsIAtom* mLocalName;
 
@@ -45,40 +47,20 @@ public:
 
   nsAttrKey(const nsAttrKey& aAttr)
     : mNamespaceID(aAttr.mNamespaceID), mLocalName(aAttr.mLocalName) {}
-};
-
-/**
- * PLDHashEntryHdr implementation for nsAttrKey.
- */
-class nsAttrHashKey : public PLDHashEntryHdr
-{
-public:
-  typedef const nsAttrKey& KeyType;
-  typedef const nsAttrKey* KeyTypePointer;
 
-  explicit nsAttrHashKey(KeyTypePointer aKey) : mKey(*aKey) {}
-  nsAttrHashKey(const nsAttrHashKey& aCopy) : mKey(aCopy.mKey) {}
-  ~nsAttrHashKey() {}
-
-  KeyType GetKey() const { return mKey; }
-  bool KeyEquals(KeyTypePointer aKey) const
+  bool operator==(const nsAttrKey& aOther) const
     {
-      return mKey.mLocalName == aKey->mLocalName &&
-             mKey.mNamespaceID == aKey->mNamespaceID;
+      return mLocalName == aOther.mLocalName &&
+             mNamespaceID == aOther.mNamespaceID;
     }
 
-  static KeyTypePointer KeyToPointer(KeyType aKey) { return &aKey; }
-  static PLDHashNumber HashKey(KeyTypePointer aKey)
+  bool operator<(const nsAttrKey& aOther) const
     {
-      if (!aKey)
-        return 0;
-
-      return mozilla::HashGeneric(aKey->mNamespaceID, aKey->mLocalName);
+      if (mNamespaceID != aOther.mNamespaceID) {
+        return mNamespaceID < aOther.mNamespaceID;
+      }
+      return mLocalName < aOther.mLocalName;
     }
-  enum { ALLOW_MEMMOVE = true };
-
-private:
-  nsAttrKey mKey;
 };
 
 // Helper class that implements the nsIDOMMozNamedAttrMap interface.
@@ -126,7 +108,12 @@ public:
    */
   uint32_t Count() const;
 
-  typedef nsRefPtrHashtable<nsAttrHashKey, Attr> AttrCache;
+  // Elements rarely have more than a handful of attributes, so a flat
+  // sorted map is both smaller and faster here than a hashtable.
+  typedef nsTSmallSortedMap<nsAttrKey, nsRefPtr<Attr>> AttrCache;
+
+  typedef PLDHashOperator
+    (*AttrEnumFunc)(const nsAttrKey& aKey, Attr* aAttr, void* aUserArg);
 
   /**
    * Enumerates over the attribute nodess in the map and calls aFunc for each
@@ -134,7 +121,7 @@ public:
    *
    * @return The number of attribute nodes that aFunc was called for.
    */
-  uint32_t Enumerate(AttrCache::EnumReadFunction aFunc, void *aUserArg) const;
+  uint32_t Enumerate(AttrEnumFunc aFunc, void *aUserArg) const;
 
   Element* GetParentObject() const
   {
@@ -2002,6 +2002,8 @@ NS_IMPL_CYCLE_COLLECTION_TRAVERSE_BEGIN_INTERNAL(nsDocument)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mLayoutHistoryState)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mOnloadBlocker)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mFirstBaseNodeWithHref)
+  NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mBatchedAppendContainer)
+  NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mBatchedAppendFirst)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mDOMImplementation)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mImageMaps)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mOriginalDocument)
@@ -2087,6 +2089,8 @@ NS_IMPL_CYCLE_COLLECTION_UNLINK_BEGIN(nsDocument)
   tmp->mCachedRootElement = nullptr; // Avoid a dangling pointer
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mDisplayDocument)
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mFirstBaseNodeWithHref)
+  NS_IMPL_CYCLE_COLLECTION_UNLINK(mBatchedAppendContainer)
+  NS_IMPL_CYCLE_COLLECTION_UNLINK(mBatchedAppendFirst)
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mDOMImplementation)
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mImageMaps)
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mOriginalDocument)
@@ -4899,6 +4903,59 @@ nsDocument::EndUpdate(nsUpdateType aUpdateType)
   MaybeInitializeFinalizeFrameLoaders();
 }
 
+void
+nsDocument::BeginBatchMutation()
+{
+  ++mBatchMutationDepth;
+}
+
+void
+nsDocument::EndBatchMutation()
+{
+  NS_ASSERTION(mBatchMutationDepth != 0, "unbalanced EndBatchMutation");
+  if (--mBatchMutationDepth == 0) {
+    FlushBatchedNotifications();
+  }
+}
+
+void
+nsDocument::QueueBatchedContentAppended(nsIContent* aContainer,
+                                        nsIContent* aFirstNewContent,
+                                        int32_t aNewIndexInContainer)
+{
+  MOZ_ASSERT(IsInBatchMutation());
+  if (mBatchedAppendContainer == aContainer) {
+    // The pending run already ends at the container's last child, so the
+    // eventual notification covers the new children too.
+    return;
+  }
+
+  FlushBatchedNotifications();
+  mBatchedAppendContainer = aContainer;
+  mBatchedAppendFirst = aFirstNewContent;
+  mBatchedAppendIndex = aNewIndexInContainer;
+}
+
+void
+nsDocument::FlushBatchedNotifications()
+{
+  if (!mBatchedAppendContainer) {
+    return;
+  }
+
+  nsCOMPtr<nsIContent> container = mBatchedAppendContainer.forget();
+  nsCOMPtr<nsIContent> first = mBatchedAppendFirst.forget();
+
+  // The run may have been orphaned by a non-notifying removal; in that case
+  // there is nothing to announce.
+  if (first->GetParent() != container) {
+    return;
+  }
+
+  MOZ_AUTO_DOC_UPDATE(this, UPDATE_CONTENT_MODEL, true);
+  nsNodeUtils::NotifyContentAppended(container, first, mBatchedAppendIndex);
+}
+
 void
 nsDocument::BeginLoad()
 {
@@ -7566,7 +7623,7 @@ nsIDocument::GetCompatMode(nsString& aCompatMode) const
 static void BlastSubtreeToPieces(nsINode *aNode);
 
 PLDHashOperator
-BlastFunc(nsAttrHashKey::KeyType aKey, Attr *aData, void* aUserArg)
+BlastFunc(const nsAttrKey& aKey, Attr *aData, void* aUserArg)
 {
   nsCOMPtr<nsIAttribute> *attr =
     static_cast<nsCOMPtr<nsIAttribute>*>(aUserArg);
@@ -8091,6 +8148,10 @@ nsDocument::FlushPendingNotifications(mozFlushType aType)
 {
   nsDocumentOnStack dos(this);
 
+  // If a batch mutation scope is open, deliver the coalesced appends before
+  // any style or layout flush can look at the frame tree.
+  FlushBatchedNotifications();
+
   // We need to flush the sink for non-HTML documents (because the XML
   // parser still does insertion with deferred notifications).  We
   // also need to flush the sink if this is a layout-related flush, to
@@ -10464,6 +10525,14 @@ nsDocument::SetImageLockingState(bool aLocked)
   return NS_OK;
 }
 
+void
+nsDocument::RequestDiscardOfImages()
+{
+  // Locked images refuse discard requests, and visible documents keep their
+  // images locked, so this only drops decoded data for hidden documents.
+  mImageTracker.EnumerateRead(RequestDiscardEnumerator, nullptr);
+}
+
 PLDHashOperator IncrementAnimationEnumerator(imgIRequest* aKey,
                                              uint32_t aData,
                                              void*    userArg)
@@ -866,6 +866,14 @@ public:
   virtual void BeginLoad() MOZ_OVERRIDE;
   virtual void EndLoad() MOZ_OVERRIDE;
 
+  virtual void BeginBatchMutation() MOZ_OVERRIDE;
+  virtual void EndBatchMutation() MOZ_OVERRIDE;
+  virtual void QueueBatchedContentAppended(nsIContent* aContainer,
+                                           nsIContent* aFirstNewContent,
+                                           int32_t aNewIndexInContainer)
+                                             MOZ_OVERRIDE;
+  virtual void FlushBatchedNotifications() MOZ_OVERRIDE;
+
   virtual void SetReadyStateInternal(ReadyState rs) MOZ_OVERRIDE;
 
   virtual void ContentStateChanged(nsIContent* aContent,
@@ -1138,6 +1146,7 @@ public:
   virtual nsresult AddImage(imgIRequest* aImage);
   virtual nsresult RemoveImage(imgIRequest* aImage, uint32_t aFlags);
   virtual nsresult SetImageLockingState(bool aLocked);
+  virtual void RequestDiscardOfImages();
 
   // AddPlugin adds a plugin-related element to mPlugins when the element is
   // added to the tree.
@@ -1670,6 +1679,13 @@ public:
   // Our update nesting level
   uint32_t mUpdateNestLevel;
 
+  // The pending coalesced append run recorded while a batch mutation scope
+  // is open; see QueueBatchedContentAppended.  The run always extends from
+  // mBatchedAppendFirst through the container's last child.
+  nsCOMPtr<nsIContent> mBatchedAppendContainer;
+  nsCOMPtr<nsIContent> mBatchedAppendFirst;
+  int32_t mBatchedAppendIndex;
+
   // The application cache that this document is associated with, if
   // any.  This can change during the lifetime of the document.
   nsCOMPtr<nsIApplicationCache> mApplicationCache;
@@ -30,6 +30,9 @@
 #include "xpcpublic.h"
 #include "mozilla/CycleCollectedJSRuntime.h"
 #include "mozilla/Preferences.h"
+#include "mozilla/scache/StartupCache.h"
+#include "mozilla/scache/StartupCacheUtils.h"
+#include "nsAutoPtr.h"
 #include "mozilla/dom/File.h"
 #include "mozilla/dom/nsIContentParent.h"
 #include "mozilla/dom/PermissionMessageUtils.h"
@@ -1503,6 +1506,45 @@ nsFrameScriptExecutor::TryCacheLoadAndCompileScript(const nsAString& aURL,
     return;
   }
 
+  // Check the startup cache for an XDR copy before loading the source.
+  // Frame scripts are recompiled in every session and in every content
+  // process, so decoding bytecode here skips the full parse, the same
+  // way mozJSComponentLoader does for components.  The key includes the
+  // scope flavor since it affects how the script is compiled.
+  mozilla::scache::StartupCache* startupCache =
+    mozilla::scache::StartupCache::GetSingleton();
+  nsAutoCString cachePath(aRunInGlobalScope ? "jsframescript/g"
+                                            : "jsframescript/s");
+  bool writeToStartupCache = false;
+  if (startupCache &&
+      NS_SUCCEEDED(mozilla::scache::PathifyURI(uri, cachePath))) {
+    nsAutoArrayPtr<char> buf;
+    uint32_t len;
+    if (NS_SUCCEEDED(startupCache->GetBuffer(cachePath.get(),
+                                             getter_Transfers(buf), &len))) {
+      AutoSafeJSContext cx;
+      JS::Rooted<JSObject*> global(cx, mGlobal->GetJSObject());
+      if (global) {
+        JSAutoCompartment ac(cx, global);
+        JS::Rooted<JSScript*> script(cx, JS_DecodeScript(cx, buf, len));
+        if (script) {
+          aScriptp.set(script);
+          if (aShouldCache) {
+            nsFrameScriptObjectExecutorHolder* holder =
+              new nsFrameScriptObjectExecutorHolder(cx, script,
+                                                    aRunInGlobalScope);
+            sCachedScripts->Put(aURL, holder);
+          }
+          return;
+        }
+        // A stale or corrupt buffer is not fatal; fall through and
+        // compile from source, which will overwrite the cached copy.
+        JS_ClearPendingException(cx);
+      }
+    }
+    writeToStartupCache = true;
+  }
+
   nsCOMPtr<nsIChannel> channel;
   NS_NewChannel(getter_AddRefs(channel),
                 uri,
@@ -1572,6 +1614,18 @@ nsFrameScriptExecutor::TryCacheLoadAndCompileScript(const nsAString& aURL,
           holder = new nsFrameScriptObjectExecutorHolder(cx, script, aRunInGlobalScope);
         }
         sCachedScripts->Put(aURL, holder);
+
+        if (writeToStartupCache && script) {
+          // Failure to write is not fatal; we'll just recompile next
+          // session.
+          uint32_t size;
+          void* data = JS_EncodeScript(cx, script, &size);
+          if (data) {
+            startupCache->PutBuffer(cachePath.get(),
+                                    static_cast<char*>(data), size);
+            js_free(data);
+          }
+        }
       }
     }
   }
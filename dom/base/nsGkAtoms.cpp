@@ -11,6 +11,9 @@
 
 #include "nsGkAtoms.h"
 #include "nsStaticAtom.h"
+#include "nsString.h"
+
+#include <string.h>
 
 using namespace mozilla;
 
@@ -29,8 +32,53 @@ static const nsStaticAtom GkAtoms_info[] = {
 #undef GK_ATOM
 };
 
+// Perfect hash table over GkAtoms_info, generated at build time by
+// gkatomhash.py from nsGkAtomList.h.
+#include "nsGkAtomHash.h"
+
 void nsGkAtoms::AddRefAtoms()
 {
   NS_RegisterStaticAtoms(GkAtoms_info);
 }
 
+// 32-bit FNV-1a, matching fnv1a() in gkatomhash.py.
+static inline uint32_t
+HashAtomString(const char16_t* aChars, uint32_t aLength, uint32_t aBasis)
+{
+  uint32_t hash = aBasis;
+  for (uint32_t i = 0; i < aLength; ++i) {
+    hash = (hash ^ aChars[i]) * 16777619u;
+  }
+  return hash;
+}
+
+/* static */ nsIAtom*
+nsGkAtoms::GetAtomByString(const nsAString& aString)
+{
+  const char16_t* chars = aString.BeginReading();
+  uint32_t length = aString.Length();
+
+  uint32_t bucket = HashAtomString(chars, length, GKATOM_HASH_BUCKET_BASIS) &
+                    GKATOM_HASH_BUCKET_MASK;
+  uint32_t slot = (HashAtomString(chars, length, GKATOM_HASH_SLOT_BASIS) ^
+                   sGkAtomDisplacements[bucket]) & GKATOM_HASH_SLOT_MASK;
+
+  uint16_t index = sGkAtomSlots[slot];
+  if (index == GKATOM_HASH_NO_ATOM) {
+    return nullptr;
+  }
+
+  // The hash is perfect over the atom list, so at most one entry can
+  // match; a single compare confirms or rejects it.
+  const nsStaticAtom& entry = GkAtoms_info[index];
+  uint32_t entryLength =
+    entry.mStringBuffer->StorageSize() / sizeof(char16_t) - 1;
+  if (entryLength != length ||
+      memcmp(entry.mStringBuffer->Data(), chars,
+             length * sizeof(char16_t)) != 0) {
+    return nullptr;
+  }
+
+  return *entry.mAtom;
+}
+
@@ -12,6 +12,8 @@
 #ifndef nsGkAtoms_h___
 #define nsGkAtoms_h___
 
+#include "nsStringFwd.h"
+
 class nsIAtom;
 
 class nsGkAtoms {
@@ -19,6 +21,15 @@ public:
 
   static void AddRefAtoms();
 
+  /**
+   * Returns the gklayout atom whose string is aString, or null if there
+   * is none.  Backed by a perfect hash table generated at build time
+   * from nsGkAtomList.h, so this is a hash and a single string compare
+   * against read-only shared data; unlike NS_GetStaticAtom() it never
+   * touches a runtime hashtable.  Only valid after AddRefAtoms() has run.
+   */
+  static nsIAtom* GetAtomByString(const nsAString& aString);
+
   /* Declare all atoms
 
      The atom names and values are stored in nsGkAtomList.h and
@@ -1191,6 +1191,29 @@ public:
   virtual void BeginLoad() = 0;
   virtual void EndLoad() = 0;
 
+  // Batch mutation scopes.  While at least one scope is open on a document,
+  // ContentAppended notifications for consecutive appends into the same
+  // in-document container are coalesced into one pending notification
+  // covering the whole run of new children, so observers (in particular the
+  // frame constructor) process thousands of appendChild() calls as a single
+  // range-based pass.  Any other kind of mutation notification flushes the
+  // pending run first, so observers always see notifications in tree order.
+  // To make this easy and painless, use the mozAutoBatchMutation helper
+  // class.
+  bool IsInBatchMutation() const
+  {
+    return mBatchMutationDepth != 0;
+  }
+  virtual void BeginBatchMutation() = 0;
+  virtual void EndBatchMutation() = 0;
+  // Records an append run for later notification.  Only called by
+  // nsNodeUtils while IsInBatchMutation().
+  virtual void QueueBatchedContentAppended(nsIContent* aContainer,
+                                           nsIContent* aFirstNewContent,
+                                           int32_t aNewIndexInContainer) = 0;
+  // Fires the pending coalesced ContentAppended notification, if any.
+  virtual void FlushBatchedNotifications() = 0;
+
   enum ReadyState { READYSTATE_UNINITIALIZED = 0, READYSTATE_LOADING = 1, READYSTATE_INTERACTIVE = 3, READYSTATE_COMPLETE = 4};
   virtual void SetReadyStateInternal(ReadyState rs) = 0;
   ReadyState GetReadyStateEnum()
@@ -2083,6 +2106,10 @@ public:
   // state is unlocked/false.
   virtual nsresult SetImageLockingState(bool aLocked) = 0;
 
+  // Ask all tracked images to discard their decoded data now. Locked images
+  // ignore the request, so this only reclaims memory for hidden documents.
+  virtual void RequestDiscardOfImages() = 0;
+
   virtual nsresult AddPlugin(nsIObjectLoadingContent* aPlugin) = 0;
   virtual void RemovePlugin(nsIObjectLoadingContent* aPlugin) = 0;
   virtual void GetPlugins(nsTArray<nsIObjectLoadingContent*>& aPlugins) = 0;
@@ -2830,6 +2857,9 @@ protected:
   uint32_t mBlockDOMContentLoaded;
   bool mDidFireDOMContentLoaded:1;
 
+  // Depth of open batch mutation scopes; see IsInBatchMutation.
+  uint32_t mBatchMutationDepth;
+
   // Our live MediaQueryLists
   PRCList mDOMMediaQueryLists;
 };
@@ -2878,6 +2908,34 @@ private:
   nsCOMPtr<nsIDocument> mSubtreeOwner;
 };
 
+/**
+ * mozAutoBatchMutation opens a batch mutation scope on a document so that
+ * runs of consecutive appends are announced to mutation observers as a
+ * single ContentAppended notification covering the whole run.
+ * See nsIDocument::BeginBatchMutation.
+ */
+class MOZ_STACK_CLASS mozAutoBatchMutation
+{
+public:
+  explicit mozAutoBatchMutation(nsIDocument* aDocument)
+    : mDocument(aDocument)
+  {
+    if (mDocument) {
+      mDocument->BeginBatchMutation();
+    }
+  }
+
+  ~mozAutoBatchMutation()
+  {
+    if (mDocument) {
+      mDocument->EndBatchMutation();
+    }
+  }
+
+private:
+  nsCOMPtr<nsIDocument> mDocument;
+};
+
 class MOZ_STACK_CLASS nsAutoSyncOperation
 {
 public:
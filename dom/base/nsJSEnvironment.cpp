@@ -87,6 +87,7 @@
 #include "mozilla/ContentEvents.h"
 
 #include "nsCycleCollectionNoteRootCallback.h"
+#include "nsRefreshDriver.h"
 #include "GeckoProfiler.h"
 
 using namespace mozilla;
@@ -128,6 +129,16 @@ static const int64_t kICCSliceBudget = 5; // ms
 // Maximum total duration for an ICC
 static const uint32_t kMaxICCDuration = 2000; // ms
 
+// A full GC is considered safe to run if the refresh driver doesn't expect
+// to tick within this window.
+static const uint32_t kFullGCIdleWindow = 100; // ms
+
+// A full GC that comes due while the refresh driver is ticking is pushed
+// back by this much so it lands in an idle period instead of mid-animation,
+// at most kMaxFullGCDeferrals times so steady animation can't starve it.
+static const uint32_t kFullGCDeferralDelay = 2000; // ms
+static const uint32_t kMaxFullGCDeferrals = 10;
+
 // Force a CC after this long if there's more than NS_CC_FORCED_PURPLE_LIMIT
 // objects in the purple buffer.
 #define NS_CC_FORCED                (2 * 60 * PR_USEC_PER_SEC) // 2 min
@@ -190,6 +201,12 @@ static bool sNeedsGCAfterCC = false;
 static bool sIncrementalCC = false;
 static bool sDidPaintAfterPreviousICCSlice = false;
 
+// Main-thread time the collectors have consumed since the last paint.  GC
+// and CC slices carve their budgets out of this shared per-frame allowance,
+// so that a GC slice followed by a CC slice can't blow a single frame.
+static TimeDuration sCollectorTimeSincePaint;
+static TimeStamp sCurrentGCSliceStart;
+
 static nsScriptNameSpaceManager *gNameSpaceManager;
 
 static nsIJSRuntimeService *sRuntimeService;
@@ -1424,6 +1441,28 @@ FullGCTimerFired(nsITimer* aTimer, void* aClosure)
 {
   nsJSContext::KillFullGCTimer();
   MOZ_ASSERT(!aClosure, "Don't pass a closure to FullGCTimerFired");
+
+  // Full collections are the most expensive ones we run.  If the refresh
+  // driver expects to tick shortly we are likely animating, so push the
+  // collection back until a genuinely idle period.
+  static uint32_t deferralCount = 0;
+  if (!sShuttingDown && deferralCount < kMaxFullGCDeferrals) {
+    TimeStamp idleBy = TimeStamp::Now() +
+      TimeDuration::FromMilliseconds(kFullGCIdleWindow);
+    if (nsRefreshDriver::GetIdleDeadlineHint(idleBy) < idleBy) {
+      ++deferralCount;
+      CallCreateInstance("@mozilla.org/timer;1", &sFullGCTimer);
+      if (sFullGCTimer) {
+        sFullGCTimer->InitWithFuncCallback(FullGCTimerFired,
+                                           nullptr,
+                                           kFullGCDeferralDelay,
+                                           nsITimer::TYPE_ONE_SHOT);
+        return;
+      }
+    }
+  }
+  deferralCount = 0;
+
   nsJSContext::GarbageCollectNow(JS::gcreason::FULL_GC_TIMER,
                                  nsJSContext::IncrementalGC);
 }
@@ -1578,6 +1617,8 @@ struct CycleCollectorStats
     mMaxSliceTime = std::max(mMaxSliceTime, sliceTime);
     mMaxSliceTimeSinceClear = std::max(mMaxSliceTimeSinceClear, sliceTime);
     mTotalSliceTime += sliceTime;
+    // Account this slice against the shared per-frame collector budget.
+    sCollectorTimeSincePaint += mEndSliceTime - mBeginSliceTime;
     mBeginSliceTime = TimeStamp();
     MOZ_ASSERT(mExtraForgetSkippableCalls == 0, "Forget to reset extra forget skippable calls?");
   }
@@ -1684,6 +1725,32 @@ nsJSContext::CycleCollectNow(nsICycleCollectorListener *aListener,
   gCCStats.FinishCycleCollectionSlice();
 }
 
+// Computes the time budget for a collector slice that wants aDefaultBudget
+// milliseconds.  GC and CC slices share a single per-frame allowance: the
+// default budget is first reduced by the collector time already consumed
+// since the last paint and then clamped to the refresh driver's next
+// expected tick.  When no tick is expected before the slice would end we
+// are effectively idle, so the accounting is reset and the full budget is
+// granted.  At least 1ms is always returned, so a collection in progress
+// keeps making some progress every slice.
+static int64_t
+CollectorSliceBudget(int64_t aDefaultBudget)
+{
+  TimeStamp now = TimeStamp::Now();
+  TimeStamp defaultDeadline =
+    now + TimeDuration::FromMilliseconds(aDefaultBudget);
+  TimeStamp deadline = nsRefreshDriver::GetIdleDeadlineHint(defaultDeadline);
+  if (deadline >= defaultDeadline) {
+    sCollectorTimeSincePaint = TimeDuration();
+    return aDefaultBudget;
+  }
+
+  int64_t budget =
+    aDefaultBudget - int64_t(sCollectorTimeSincePaint.ToMilliseconds());
+  budget = std::min(budget, int64_t((deadline - now).ToMilliseconds()));
+  return std::max(budget, int64_t(1));
+}
+
 //static
 void
 nsJSContext::RunCycleCollectorSlice()
@@ -1702,18 +1769,29 @@ nsJSContext::RunCycleCollectorSlice()
   js::SliceBudget budget;
 
   if (sIncrementalCC) {
+    int64_t sliceBudget = -1;
     if (gCCStats.mBeginTime.IsNull()) {
       // If no CC is in progress, use the standard slice time.
-      budget = js::SliceBudget(js::TimeBudget(kICCSliceBudget));
+      sliceBudget = kICCSliceBudget;
     } else {
       TimeStamp now = TimeStamp::Now();
 
       // Only run a limited slice if we're within the max running time.
       if (TimeBetween(gCCStats.mBeginTime, now) < kMaxICCDuration) {
         float sliceMultiplier = std::max(TimeBetween(gCCStats.mEndSliceTime, now) / (float)kICCIntersliceDelay, 1.0f);
-        budget = js::SliceBudget(js::TimeBudget(kICCSliceBudget * sliceMultiplier));
+        sliceBudget = int64_t(kICCSliceBudget * sliceMultiplier);
       }
     }
+
+    if (sliceBudget >= 0) {
+      // Carve the slice out of the shared per-frame collector budget, so
+      // that a GC slice which already ran this frame shrinks this one and
+      // collection doesn't eat into a paint deadline.  An over-max-duration
+      // CC still runs unlimited slices above, so repeatedly shortened
+      // slices can't stall collection forever.
+      budget =
+        js::SliceBudget(js::TimeBudget(CollectorSliceBudget(sliceBudget)));
+    }
   }
 
   nsCycleCollector_collectSlice(budget, sDidPaintAfterPreviousICCSlice);
@@ -1961,10 +2039,13 @@ void
 InterSliceGCTimerFired(nsITimer *aTimer, void *aClosure)
 {
   nsJSContext::KillInterSliceGCTimer();
+  // Carve the slice out of the shared per-frame collector budget, like the
+  // CC does; when no paint is expected soon the full budget applies.
+  int64_t budget = CollectorSliceBudget(NS_INTERSLICE_GC_BUDGET);
   nsJSContext::GarbageCollectNow(JS::gcreason::INTER_SLICE_GC,
                                  nsJSContext::IncrementalGC,
                                  nsJSContext::NonShrinkingGC,
-                                 NS_INTERSLICE_GC_BUDGET);
+                                 budget);
 }
 
 // static
@@ -2334,6 +2415,15 @@ DOMGCSliceCallback(JSRuntime *aRt, JS::GCProgress aProgress, const JS::GCDescrip
 {
   NS_ASSERTION(NS_IsMainThread(), "GCs must run on the main thread");
 
+  // Bracket each slice so its time is accounted against the shared
+  // per-frame collector budget.
+  if (aProgress == JS::GC_CYCLE_BEGIN || aProgress == JS::GC_SLICE_BEGIN) {
+    sCurrentGCSliceStart = TimeStamp::Now();
+  } else if (!sCurrentGCSliceStart.IsNull()) {
+    sCollectorTimeSincePaint += TimeStamp::Now() - sCurrentGCSliceStart;
+    sCurrentGCSliceStart = TimeStamp();
+  }
+
   if (aProgress == JS::GC_CYCLE_END) {
     PRTime delta = GetCollectionTimeDelta();
 
@@ -2453,6 +2543,8 @@ mozilla::dom::StartupJSEnvironment()
   sCCLockedOut = false;
   sCCLockedOutTime = 0;
   sLastCCEndTime = TimeStamp();
+  sCollectorTimeSincePaint = TimeDuration();
+  sCurrentGCSliceStart = TimeStamp();
   sHasRunGC = false;
   sPendingLoadCount = 0;
   sLoadingInProgress = false;
@@ -2866,6 +2958,8 @@ void
 nsJSContext::NotifyDidPaint()
 {
   sDidPaintAfterPreviousICCSlice = true;
+  // A new frame starts here, so the collectors get a fresh allowance.
+  sCollectorTimeSincePaint = TimeDuration();
 }
 
 nsScriptNameSpaceManager*
@@ -70,11 +70,23 @@ using mozilla::AutoJSContext;
   }                                                               \
   PR_END_MACRO
 
+// Flushes the append run pending on an open batch mutation scope, if any,
+// so that every other kind of notification still reaches observers in tree
+// order.  See nsIDocument::BeginBatchMutation.
+static inline void
+FlushBatchedMutations(nsIDocument* aDoc)
+{
+  if (aDoc->IsInBatchMutation()) {
+    aDoc->FlushBatchedNotifications();
+  }
+}
+
 void
 nsNodeUtils::CharacterDataWillChange(nsIContent* aContent,
                                      CharacterDataChangeInfo* aInfo)
 {
   nsIDocument* doc = aContent->OwnerDoc();
+  FlushBatchedMutations(doc);
   IMPL_MUTATION_NOTIFICATION(CharacterDataWillChange, aContent,
                              (doc, aContent, aInfo));
 }
@@ -84,6 +96,7 @@ nsNodeUtils::CharacterDataChanged(nsIContent* aContent,
                                   CharacterDataChangeInfo* aInfo)
 {
   nsIDocument* doc = aContent->OwnerDoc();
+  FlushBatchedMutations(doc);
   IMPL_MUTATION_NOTIFICATION(CharacterDataChanged, aContent,
                              (doc, aContent, aInfo));
 }
@@ -95,6 +108,7 @@ nsNodeUtils::AttributeWillChange(Element* aElement,
                                  int32_t aModType)
 {
   nsIDocument* doc = aElement->OwnerDoc();
+  FlushBatchedMutations(doc);
   IMPL_MUTATION_NOTIFICATION(AttributeWillChange, aElement,
                              (doc, aElement, aNameSpaceID, aAttribute,
                               aModType));
@@ -107,6 +121,7 @@ nsNodeUtils::AttributeChanged(Element* aElement,
                               int32_t aModType)
 {
   nsIDocument* doc = aElement->OwnerDoc();
+  FlushBatchedMutations(doc);
   IMPL_MUTATION_NOTIFICATION(AttributeChanged, aElement,
                              (doc, aElement, aNameSpaceID, aAttribute,
                               aModType));
@@ -118,6 +133,7 @@ nsNodeUtils::AttributeSetToCurrentValue(Element* aElement,
                                         nsIAtom* aAttribute)
 {
   nsIDocument* doc = aElement->OwnerDoc();
+  FlushBatchedMutations(doc);
   IMPL_MUTATION_NOTIFICATION(AttributeSetToCurrentValue, aElement,
                              (doc, aElement, aNameSpaceID, aAttribute));
 }
@@ -129,6 +145,24 @@ nsNodeUtils::ContentAppended(nsIContent* aContainer,
 {
   nsIDocument* doc = aContainer->OwnerDoc();
 
+  if (doc->IsInBatchMutation() && aContainer->IsInDoc()) {
+    // A batch mutation scope is open; fold this append into the pending
+    // run so observers see one ContentAppended for the whole run.
+    doc->QueueBatchedContentAppended(aContainer, aFirstNewContent,
+                                     aNewIndexInContainer);
+    return;
+  }
+
+  NotifyContentAppended(aContainer, aFirstNewContent, aNewIndexInContainer);
+}
+
+void
+nsNodeUtils::NotifyContentAppended(nsIContent* aContainer,
+                                   nsIContent* aFirstNewContent,
+                                   int32_t aNewIndexInContainer)
+{
+  nsIDocument* doc = aContainer->OwnerDoc();
+
   IMPL_MUTATION_NOTIFICATION(ContentAppended, aContainer,
                              (doc, aContainer, aFirstNewContent,
                               aNewIndexInContainer));
@@ -144,6 +178,7 @@ nsNodeUtils::ContentInserted(nsINode* aContainer,
                   "container must be an nsIContent or an nsIDocument");
   nsIContent* container;
   nsIDocument* doc = aContainer->OwnerDoc();
+  FlushBatchedMutations(doc);
   nsIDocument* document;
   if (aContainer->IsNodeOfType(nsINode::eCONTENT)) {
     container = static_cast<nsIContent*>(aContainer);
@@ -169,6 +204,7 @@ nsNodeUtils::ContentRemoved(nsINode* aContainer,
                   "container must be an nsIContent or an nsIDocument");
   nsIContent* container;
   nsIDocument* doc = aContainer->OwnerDoc();
+  FlushBatchedMutations(doc);
   nsIDocument* document;
   if (aContainer->IsNodeOfType(nsINode::eCONTENT)) {
     container = static_cast<nsIContent*>(aContainer);
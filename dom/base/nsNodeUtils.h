@@ -75,7 +75,10 @@ public:
                                          nsIAtom* aAttribute);
 
   /**
-   * Send ContentAppended notifications to nsIMutationObservers
+   * Send ContentAppended notifications to nsIMutationObservers.  If a batch
+   * mutation scope is open on the owner document and aContainer is in the
+   * document, the notification is instead coalesced into the document's
+   * pending append run; see nsIDocument::BeginBatchMutation.
    * @param aContainer           Node into which new child/children were added
    * @param aFirstNewContent     First new child
    * @param aNewIndexInContainer Index of first new child
@@ -85,6 +88,15 @@ public:
                               nsIContent* aFirstNewContent,
                               int32_t aNewIndexInContainer);
 
+  /**
+   * Send ContentAppended notifications unconditionally, bypassing any open
+   * batch mutation scope.  Only meant to be used by
+   * nsIDocument::FlushBatchedNotifications.
+   */
+  static void NotifyContentAppended(nsIContent* aContainer,
+                                    nsIContent* aFirstNewContent,
+                                    int32_t aNewIndexInContainer);
+
   /**
    * Send ContentInserted notifications to nsIMutationObservers
    * @param aContainer        Node into which new child was inserted
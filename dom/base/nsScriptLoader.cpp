@@ -50,6 +50,7 @@
 #include "ImportManager.h"
 #include "mozilla/dom/EncodingUtils.h"
 
+#include "mozilla/CheckedInt.h"
 #include "mozilla/CORSMode.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/unused.h"
@@ -175,7 +176,7 @@ nsScriptLoader::~nsScriptLoader()
   }  
 }
 
-NS_IMPL_ISUPPORTS(nsScriptLoader, nsIStreamLoaderObserver)
+NS_IMPL_ISUPPORTS0(nsScriptLoader)
 
 // Helper method for checking if the script element is an event-handler
 // This means that it has both a for-attribute and a event-attribute.
@@ -355,11 +356,10 @@ nsScriptLoader::StartLoad(nsScriptLoadRequest *aRequest, const nsAString &aType,
     timedChannel->SetInitiatorType(NS_LITERAL_STRING("script"));
   }
 
-  nsCOMPtr<nsIStreamLoader> loader;
-  rv = NS_NewStreamLoader(getter_AddRefs(loader), this);
-  NS_ENSURE_SUCCESS(rv, rv);
+  nsRefPtr<nsScriptLoadHandler> handler =
+    new nsScriptLoadHandler(this, aRequest);
 
-  nsCOMPtr<nsIStreamListener> listener = loader.get();
+  nsCOMPtr<nsIStreamListener> listener = handler.get();
 
   if (aRequest->mCORSMode != CORS_NONE) {
     bool withCredentials = (aRequest->mCORSMode == CORS_USE_CREDENTIALS);
@@ -1402,19 +1402,15 @@ nsScriptLoader::ConvertToUTF16(nsIChannel* aChannel, const uint8_t* aData,
   return rv;
 }
 
-NS_IMETHODIMP
-nsScriptLoader::OnStreamComplete(nsIStreamLoader* aLoader,
-                                 nsISupports* aContext,
-                                 nsresult aStatus,
-                                 uint32_t aStringLen,
-                                 const uint8_t* aString)
+nsresult
+nsScriptLoader::OnStreamComplete(nsScriptLoadRequest* aRequest,
+                                 nsIRequest* aChannelRequest,
+                                 nsresult aStatus)
 {
-  nsScriptLoadRequest* request = static_cast<nsScriptLoadRequest*>(aContext);
-  NS_ASSERTION(request, "null request in stream complete handler");
-  NS_ENSURE_TRUE(request, NS_ERROR_FAILURE);
+  NS_ASSERTION(aRequest, "null request in stream complete handler");
+  NS_ENSURE_TRUE(aRequest, NS_ERROR_FAILURE);
 
-  nsresult rv = PrepareLoadedRequest(request, aLoader, aStatus, aStringLen,
-                                     aString);
+  nsresult rv = PrepareLoadedRequest(aRequest, aChannelRequest, aStatus);
   if (NS_FAILED(rv)) {
     /*
      * Handle script not loading error because source was a tracking URL.
@@ -1422,33 +1418,29 @@ nsScriptLoader::OnStreamComplete(nsIStreamLoader* aLoader,
      * array of blocked tracking nodes under its parent document.
      */
     if (rv == NS_ERROR_TRACKING_URI) {
-      nsCOMPtr<nsIContent> cont = do_QueryInterface(request->mElement);
+      nsCOMPtr<nsIContent> cont = do_QueryInterface(aRequest->mElement);
       mDocument->AddBlockedTrackingNode(cont);
     }
 
-    if (mDeferRequests.RemoveElement(request) ||
-        mAsyncRequests.RemoveElement(request) ||
-        mNonAsyncExternalScriptInsertedRequests.RemoveElement(request) ||
-        mXSLTRequests.RemoveElement(request)) {
-      FireScriptAvailable(rv, request);
-    } else if (mParserBlockingRequest == request) {
+    if (mDeferRequests.RemoveElement(aRequest) ||
+        mAsyncRequests.RemoveElement(aRequest) ||
+        mNonAsyncExternalScriptInsertedRequests.RemoveElement(aRequest) ||
+        mXSLTRequests.RemoveElement(aRequest)) {
+      FireScriptAvailable(rv, aRequest);
+    } else if (mParserBlockingRequest == aRequest) {
       mParserBlockingRequest = nullptr;
-      UnblockParser(request);
-      FireScriptAvailable(rv, request);
-      ContinueParserAsync(request);
+      UnblockParser(aRequest);
+      FireScriptAvailable(rv, aRequest);
+      ContinueParserAsync(aRequest);
     } else {
-      mPreloads.RemoveElement(request, PreloadRequestComparator());
+      mPreloads.RemoveElement(aRequest, PreloadRequestComparator());
     }
-    rv = NS_OK;
-  } else {
-    moz_free(const_cast<uint8_t *>(aString));
-    rv = NS_SUCCESS_ADOPTED_DATA;
   }
 
   // Process our request and/or any pending ones
   ProcessPendingRequests();
 
-  return rv;
+  return NS_OK;
 }
 
 void
@@ -1465,10 +1457,8 @@ nsScriptLoader::ContinueParserAsync(nsScriptLoadRequest* aParserBlockingRequest)
 
 nsresult
 nsScriptLoader::PrepareLoadedRequest(nsScriptLoadRequest* aRequest,
-                                     nsIStreamLoader* aLoader,
-                                     nsresult aStatus,
-                                     uint32_t aStringLen,
-                                     const uint8_t* aString)
+                                     nsIRequest* aChannelRequest,
+                                     nsresult aStatus)
 {
   if (NS_FAILED(aStatus)) {
     return aStatus;
@@ -1481,12 +1471,10 @@ nsScriptLoader::PrepareLoadedRequest(nsScriptLoadRequest* aRequest,
   }
 
   // If the load returned an error page, then we need to abort
-  nsCOMPtr<nsIRequest> req;
-  nsresult rv = aLoader->GetRequest(getter_AddRefs(req));
-  NS_ASSERTION(req, "StreamLoader's request went away prematurely");
-  NS_ENSURE_SUCCESS(rv, rv);
+  NS_ASSERTION(aChannelRequest, "channel request went away prematurely");
+  nsresult rv;
 
-  nsCOMPtr<nsIHttpChannel> httpChannel = do_QueryInterface(req);
+  nsCOMPtr<nsIHttpChannel> httpChannel = do_QueryInterface(aChannelRequest);
   if (httpChannel) {
     bool requestSucceeded;
     rv = httpChannel->GetRequestSucceeded(&requestSucceeded);
@@ -1502,7 +1490,7 @@ nsScriptLoader::PrepareLoadedRequest(nsScriptLoadRequest* aRequest,
     }
   }
 
-  nsCOMPtr<nsIChannel> channel = do_QueryInterface(req);
+  nsCOMPtr<nsIChannel> channel = do_QueryInterface(aChannelRequest);
   // If this load was subject to a CORS check; don't flag it with a
   // separate origin principal, so that it will treat our document's
   // principal as the origin principal
@@ -1512,22 +1500,8 @@ nsScriptLoader::PrepareLoadedRequest(nsScriptLoadRequest* aRequest,
     NS_ENSURE_SUCCESS(rv, rv);
   }
 
-  if (aStringLen) {
-    // Check the charset attribute to determine script charset.
-    nsAutoString hintCharset;
-    if (!aRequest->IsPreload()) {
-      aRequest->mElement->GetScriptCharset(hintCharset);
-    } else {
-      nsTArray<PreloadInfo>::index_type i =
-        mPreloads.IndexOf(aRequest, 0, PreloadRequestComparator());
-      NS_ASSERTION(i != mPreloads.NoIndex, "Incorrect preload bookkeeping");
-      hintCharset = mPreloads[i].mCharset;
-    }
-    rv = ConvertToUTF16(channel, aString, aStringLen, hintCharset, mDocument,
-                        aRequest->mScriptTextBuf, aRequest->mScriptTextLength);
-
-    NS_ENSURE_SUCCESS(rv, rv);
-  }
+  // The script text was decoded incrementally by nsScriptLoadHandler as
+  // the data arrived, so aRequest->mScriptTextBuf is already populated.
 
   // This assertion could fire errorously if we ran out of memory when
   // inserting the request in the array. However it's an unlikely case
@@ -1622,3 +1596,225 @@ nsScriptLoader::MaybeRemovedDeferRequests()
   }
   return false;
 }
+
+//////////////////////////////////////////////////////////////
+// nsScriptLoadHandler
+//////////////////////////////////////////////////////////////
+
+nsScriptLoadHandler::nsScriptLoadHandler(nsScriptLoader *aScriptLoader,
+                                         nsScriptLoadRequest *aRequest)
+  : mScriptLoader(aScriptLoader),
+    mRequest(aRequest),
+    mDecodingStatus(NS_OK)
+{
+}
+
+nsScriptLoadHandler::~nsScriptLoadHandler()
+{
+}
+
+NS_IMPL_ISUPPORTS(nsScriptLoadHandler, nsIStreamListener, nsIRequestObserver)
+
+NS_IMETHODIMP
+nsScriptLoadHandler::OnStartRequest(nsIRequest *aRequest,
+                                    nsISupports *aContext)
+{
+  return NS_OK;
+}
+
+namespace {
+
+struct ScriptDecodeClosure
+{
+  nsScriptLoadHandler* mHandler;
+  nsIRequest* mChannelRequest;
+};
+
+} // anonymous namespace
+
+NS_IMETHODIMP
+nsScriptLoadHandler::OnDataAvailable(nsIRequest *aRequest,
+                                     nsISupports *aContext,
+                                     nsIInputStream *aInputStream,
+                                     uint64_t aOffset,
+                                     uint32_t aCount)
+{
+  ScriptDecodeClosure closure = { this, aRequest };
+  uint32_t read;
+  return aInputStream->ReadSegments(DecodeRawSegment, &closure, aCount, &read);
+}
+
+/* static */ NS_METHOD
+nsScriptLoadHandler::DecodeRawSegment(nsIInputStream *aInputStream,
+                                      void *aClosure,
+                                      const char *aSegment,
+                                      uint32_t aToOffset,
+                                      uint32_t aCount,
+                                      uint32_t *aWriteCount)
+{
+  ScriptDecodeClosure* closure = static_cast<ScriptDecodeClosure*>(aClosure);
+  nsScriptLoadHandler* handler = closure->mHandler;
+
+  // Always consume the segment; a decoding failure is remembered and
+  // reported from OnStopRequest, just like a conversion failure was when
+  // the whole buffer used to be converted at completion.
+  if (NS_SUCCEEDED(handler->mDecodingStatus)) {
+    nsresult rv =
+      handler->OnRawData(closure->mChannelRequest,
+                         reinterpret_cast<const uint8_t*>(aSegment),
+                         aCount, false);
+    if (NS_FAILED(rv)) {
+      handler->mDecodingStatus = rv;
+    }
+  }
+
+  *aWriteCount = aCount;
+  return NS_OK;
+}
+
+nsresult
+nsScriptLoadHandler::OnRawData(nsIRequest *aChannelRequest,
+                               const uint8_t *aData,
+                               uint32_t aDataLength,
+                               bool aEndOfStream)
+{
+  if (mDecoder) {
+    return DecodeRawData(aData, aDataLength, aEndOfStream);
+  }
+
+  if (aDataLength) {
+    mRawBuffer.AppendElements(aData, aDataLength);
+  }
+
+  if (!EnsureDecoder(aChannelRequest, mRawBuffer.Elements(),
+                     mRawBuffer.Length(), aEndOfStream)) {
+    // Wait until there's enough data to rule out a BOM.
+    return NS_OK;
+  }
+
+  nsresult rv = DecodeRawData(mRawBuffer.Elements(), mRawBuffer.Length(),
+                              aEndOfStream);
+  mRawBuffer.Clear();
+  return rv;
+}
+
+nsresult
+nsScriptLoadHandler::DecodeRawData(const uint8_t *aData,
+                                   uint32_t aDataLength,
+                                   bool aEndOfStream)
+{
+  int32_t srcLen = aDataLength;
+  const char *src = reinterpret_cast<const char *>(aData);
+  int32_t dstLen;
+  nsresult rv = mDecoder->GetMaxLength(src, srcLen, &dstLen);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  size_t haveRead = mRequest->mScriptTextLength;
+  CheckedInt<size_t> capacity = haveRead;
+  capacity += dstLen;
+  CheckedInt<size_t> bufLen = capacity * sizeof(char16_t);
+  if (!bufLen.isValid()) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+
+  char16_t *scriptText = static_cast<char16_t *>(
+    js_realloc(mRequest->mScriptTextBuf, bufLen.value()));
+  if (!scriptText) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+  mRequest->mScriptTextBuf = scriptText;
+
+  rv = mDecoder->Convert(src, &srcLen, scriptText + haveRead, &dstLen);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  mRequest->mScriptTextLength = haveRead + dstLen;
+  return NS_OK;
+}
+
+bool
+nsScriptLoadHandler::EnsureDecoder(nsIRequest *aChannelRequest,
+                                   const uint8_t *aData,
+                                   uint32_t aDataLength,
+                                   bool aEndOfStream)
+{
+  MOZ_ASSERT(!mDecoder);
+
+  // The encoding info precedence is as follows from high to low:
+  // The BOM
+  // HTTP Content-Type (if name recognized)
+  // charset attribute (if name recognized)
+  // The encoding of the document
+
+  nsAutoCString charset;
+
+  if (DetectByteOrderMark(aData, aDataLength, charset)) {
+    // charset is now "UTF-8" or "UTF-16". The UTF-16 decoder will re-sniff
+    // the BOM for endianness. Both the UTF-16 and the UTF-8 decoder will
+    // take care of swallowing the BOM.
+    mDecoder = EncodingUtils::DecoderForEncoding(charset);
+    return true;
+  }
+
+  if (!aEndOfStream && aDataLength < 3) {
+    // A BOM is at most three bytes; hold off until we can rule one out.
+    return false;
+  }
+
+  nsCOMPtr<nsIChannel> channel = do_QueryInterface(aChannelRequest);
+  if (channel &&
+      NS_SUCCEEDED(channel->GetContentCharset(charset)) &&
+      EncodingUtils::FindEncodingForLabel(charset, charset)) {
+    mDecoder = EncodingUtils::DecoderForEncoding(charset);
+    return true;
+  }
+
+  // Check the charset attribute to determine script charset.
+  nsAutoString hintCharset;
+  if (!mRequest->IsPreload()) {
+    mRequest->mElement->GetScriptCharset(hintCharset);
+  } else {
+    nsTArray<nsScriptLoader::PreloadInfo>::index_type i =
+      mScriptLoader->mPreloads.IndexOf(mRequest, 0,
+                                       nsScriptLoader::PreloadRequestComparator());
+    NS_ASSERTION(i != mScriptLoader->mPreloads.NoIndex,
+                 "Incorrect preload bookkeeping");
+    hintCharset = mScriptLoader->mPreloads[i].mCharset;
+  }
+
+  if (EncodingUtils::FindEncodingForLabel(hintCharset, charset)) {
+    mDecoder = EncodingUtils::DecoderForEncoding(charset);
+    return true;
+  }
+
+  nsIDocument* document = mScriptLoader->mDocument;
+  if (document) {
+    charset = document->GetDocumentCharacterSet();
+    mDecoder = EncodingUtils::DecoderForEncoding(charset);
+    return true;
+  }
+
+  // The fallback in the old code was ISO-8859-1, which behaved like
+  // windows-1252. Saying windows-1252 for clarity and for compliance
+  // with the Encoding Standard.
+  mDecoder = EncodingUtils::DecoderForEncoding("windows-1252");
+  return true;
+}
+
+NS_IMETHODIMP
+nsScriptLoadHandler::OnStopRequest(nsIRequest *aRequest,
+                                   nsISupports *aContext,
+                                   nsresult aStatus)
+{
+  nsresult status = aStatus;
+  if (NS_SUCCEEDED(status)) {
+    status = mDecodingStatus;
+  }
+
+  if (NS_SUCCEEDED(status) && !mDecoder && !mRawBuffer.IsEmpty()) {
+    // The stream was too short to sniff a BOM from; pick the charset from
+    // what we know now and decode the buffered bytes.
+    status = OnRawData(aRequest, nullptr, 0, true);
+  }
+
+  return mScriptLoader->OnStreamComplete(mRequest, aRequest, status);
+}
@@ -16,10 +16,12 @@
 #include "nsTArray.h"
 #include "nsAutoPtr.h"
 #include "nsIDocument.h"
-#include "nsIStreamLoader.h"
+#include "nsIStreamListener.h"
 #include "mozilla/net/ReferrerPolicy.h"
 
+class nsScriptLoadHandler;
 class nsScriptLoadRequest;
+class nsIUnicodeDecoder;
 class nsIURI;
 
 namespace JS {
@@ -36,7 +38,7 @@ class AutoJSAPI;
 // Script loader implementation
 //////////////////////////////////////////////////////////////
 
-class nsScriptLoader MOZ_FINAL : public nsIStreamLoaderObserver
+class nsScriptLoader MOZ_FINAL : public nsISupports
 {
   class MOZ_STACK_CLASS AutoCurrentScriptUpdater
   {
@@ -58,13 +60,13 @@ class nsScriptLoader MOZ_FINAL : public nsIStreamLoaderObserver
   };
 
   friend class nsScriptRequestProcessor;
+  friend class nsScriptLoadHandler;
   friend class AutoCurrentScriptUpdater;
 
 public:
   explicit nsScriptLoader(nsIDocument* aDocument);
 
   NS_DECL_ISUPPORTS
-  NS_DECL_NSISTREAMLOADEROBSERVER
 
   /**
    * The loader maintains a weak reference to the document with
@@ -325,11 +327,18 @@ private:
                                     JS::Handle<JSObject *> aScopeChain,
                                     JS::CompileOptions *aOptions);
 
+  /**
+   * Called by nsScriptLoadHandler once the channel has finished and the
+   * script text has been decoded. aChannelRequest is the request the
+   * channel completed with.
+   */
+  nsresult OnStreamComplete(nsScriptLoadRequest* aRequest,
+                            nsIRequest* aChannelRequest,
+                            nsresult aStatus);
+
   nsresult PrepareLoadedRequest(nsScriptLoadRequest* aRequest,
-                                nsIStreamLoader* aLoader,
-                                nsresult aStatus,
-                                uint32_t aStringLen,
-                                const uint8_t* aString);
+                                nsIRequest* aChannelRequest,
+                                nsresult aStatus);
 
   void AddDeferRequest(nsScriptLoadRequest* aRequest);
   bool MaybeRemovedDeferRequests();
@@ -394,4 +403,69 @@ public:
   nsRefPtr<nsScriptLoader> mLoader;
 };
 
+/**
+ * Stream listener for external scripts.  The incoming bytes are decoded to
+ * UTF-16 incrementally as they arrive from the network, so the charset
+ * conversion overlaps the download instead of running over the whole
+ * buffer once the last byte is in.  When the channel finishes, the decoded
+ * script text is handed to the script loader ready for compilation.
+ */
+class nsScriptLoadHandler MOZ_FINAL : public nsIStreamListener
+{
+public:
+  nsScriptLoadHandler(nsScriptLoader* aScriptLoader,
+                      nsScriptLoadRequest* aRequest);
+
+  NS_DECL_ISUPPORTS
+  NS_DECL_NSIREQUESTOBSERVER
+  NS_DECL_NSISTREAMLISTENER
+
+private:
+  virtual ~nsScriptLoadHandler();
+
+  /*
+   * Decode the given bytes onto the end of the request's script text
+   * buffer.  The decoder must already have been determined.
+   */
+  nsresult DecodeRawData(const uint8_t* aData, uint32_t aDataLength,
+                         bool aEndOfStream);
+
+  /*
+   * Determine the charset and create the decoder, looking at the BOM, the
+   * channel's charset, the charset attribute and the document's charset in
+   * that order.  Returns false if more data is needed to rule out a BOM;
+   * always succeeds when aEndOfStream is true.
+   */
+  bool EnsureDecoder(nsIRequest* aChannelRequest, const uint8_t* aData,
+                     uint32_t aDataLength, bool aEndOfStream);
+
+  /*
+   * Feed raw network bytes to the decoder, buffering them while the
+   * charset is still undetermined.
+   */
+  nsresult OnRawData(nsIRequest* aChannelRequest, const uint8_t* aData,
+                     uint32_t aDataLength, bool aEndOfStream);
+
+  static NS_METHOD DecodeRawSegment(nsIInputStream* aInputStream,
+                                    void* aClosure, const char* aSegment,
+                                    uint32_t aToOffset, uint32_t aCount,
+                                    uint32_t* aWriteCount);
+
+  // Loader to hand the decoded script to once the channel completes.
+  nsRefPtr<nsScriptLoader> mScriptLoader;
+
+  // The request being loaded; owns the script text buffer we decode into.
+  nsRefPtr<nsScriptLoadRequest> mRequest;
+
+  // First failure hit while decoding; reported from OnStopRequest.
+  nsresult mDecodingStatus;
+
+  // Unicode decoder for the script's charset, created lazily once the
+  // charset can be determined.
+  nsCOMPtr<nsIUnicodeDecoder> mDecoder;
+
+  // Raw bytes received before the charset could be determined.
+  nsTArray<uint8_t> mRawBuffer;
+};
+
 #endif //__nsScriptLoader_h__
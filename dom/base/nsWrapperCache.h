@@ -392,4 +392,40 @@ NS_DEFINE_STATIC_IID_ACCESSOR(nsWrapperCache, NS_WRAPPERCACHE_IID)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE_END                    \
   NS_IMPL_CYCLE_COLLECTION_TRACE_WRAPPERCACHE(_class)
 
+// Cycle collector macros for wrapper-cached leaf classes.
+//
+// A "leaf" class in this sense is a small value object (DOMRect and
+// friends) whose only strong references are its parent chain.  Such an
+// object can be skipped by the cycle collector while its preserved wrapper
+// is black: a black wrapper proves the object is alive, so neither it nor
+// the edges out of it can be part of a garbage cycle.  Objects with no
+// preserved wrapper must NOT be skipped - the parent pointer commonly
+// points at a collection that holds the object right back (e.g. DOMRect's
+// mParent is its owning DOMRectList), and hiding that back-edge from the
+// collector would make the whole cycle appear externally referenced and
+// leak it.  Leaf value objects can make up a large share of the graph on
+// busy pages, so keeping the live ones out of it is a substantial win.
+//
+// Use together with NS_DECL_CYCLE_COLLECTION_SKIPPABLE_SCRIPT_HOLDER_CLASS
+// in the class declaration, and make sure the implementing translation unit
+// includes nsWrapperCacheInlines.h for IsBlack().
+#define NS_IMPL_CYCLE_COLLECTION_CAN_SKIP_WRAPPERCACHE_LEAF(_class)            \
+  NS_IMPL_CYCLE_COLLECTION_CAN_SKIP_BEGIN(_class)                              \
+    return tmp->PreservingWrapper() && tmp->IsBlack();                         \
+  NS_IMPL_CYCLE_COLLECTION_CAN_SKIP_END                                        \
+  NS_IMPL_CYCLE_COLLECTION_CAN_SKIP_IN_CC_BEGIN(_class)                        \
+    return tmp->PreservingWrapper() && tmp->IsBlack();                         \
+  NS_IMPL_CYCLE_COLLECTION_CAN_SKIP_IN_CC_END                                  \
+  NS_IMPL_CYCLE_COLLECTION_CAN_SKIP_THIS_BEGIN(_class)                         \
+    return tmp->PreservingWrapper() && tmp->IsBlack();                         \
+  NS_IMPL_CYCLE_COLLECTION_CAN_SKIP_THIS_END
+
+#define NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE_LEAF_0(_class)                   \
+  NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE_0(_class)                              \
+  NS_IMPL_CYCLE_COLLECTION_CAN_SKIP_WRAPPERCACHE_LEAF(_class)
+
+#define NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE_LEAF(_class, ...)                \
+  NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE(_class, __VA_ARGS__)                   \
+  NS_IMPL_CYCLE_COLLECTION_CAN_SKIP_WRAPPERCACHE_LEAF(_class)
+
 #endif /* nsWrapperCache_h___ */
@@ -77,6 +77,8 @@
 #include "mozilla/Preferences.h"
 #include "private/pprio.h"
 
+#include <algorithm>
+
 using namespace mozilla;
 using namespace mozilla::dom;
 
@@ -3943,6 +3945,7 @@ ArrayBufferBuilder::ArrayBufferBuilder()
   : mDataPtr(nullptr),
     mCapacity(0),
     mLength(0),
+    mChunksLength(0),
     mMapPtr(nullptr)
 {
 }
@@ -3959,6 +3962,12 @@ ArrayBufferBuilder::reset()
     JS_free(nullptr, mDataPtr);
   }
 
+  for (uint32_t i = 0; i < mChunks.Length(); ++i) {
+    js_free(mChunks[i].mData);
+  }
+  mChunks.Clear();
+  mChunksLength = 0;
+
   if (mMapPtr) {
     JS_ReleaseMappedArrayBufferContents(mMapPtr, mLength);
     mMapPtr = nullptr;
@@ -3991,6 +4000,18 @@ ArrayBufferBuilder::setCapacity(uint32_t aNewCap)
     mLength = aNewCap;
   }
 
+  // Coalesce any overflow chunks back into the contiguous buffer; this is
+  // the only place large downloads of unknown length copy their data.
+  for (uint32_t i = 0; i < mChunks.Length(); ++i) {
+    Chunk& chunk = mChunks[i];
+    uint32_t toCopy = std::min(chunk.mLength, mCapacity - mLength);
+    memcpy(mDataPtr + mLength, chunk.mData, toCopy);
+    mLength += toCopy;
+    js_free(chunk.mData);
+  }
+  mChunks.Clear();
+  mChunksLength = 0;
+
   return true;
 }
 
@@ -4000,6 +4021,54 @@ ArrayBufferBuilder::append(const uint8_t *aNewData, uint32_t aDataLen,
 {
   MOZ_ASSERT(!mMapPtr);
 
+  // Once the contiguous buffer has reached aMaxGrowth, stop reallocating:
+  // each realloc of a large buffer risks copying everything accumulated so
+  // far, which for a big download of unknown length adds up to many times
+  // the payload size.  Spill into overflow chunks instead and coalesce them
+  // with a single copy in setCapacity().
+  if (!mChunks.IsEmpty() ||
+      (aMaxGrowth && mCapacity >= aMaxGrowth &&
+       mLength + aDataLen > mCapacity)) {
+    // Top off the contiguous buffer so the spill invariant holds.
+    if (mChunks.IsEmpty() && mLength < mCapacity) {
+      uint32_t toCopy = mCapacity - mLength;
+      memcpy(mDataPtr + mLength, aNewData, toCopy);
+      mLength += toCopy;
+      aNewData += toCopy;
+      aDataLen -= toCopy;
+    }
+
+    while (aDataLen) {
+      if (!mChunks.IsEmpty() &&
+          mChunks.LastElement().mLength < mChunks.LastElement().mCapacity) {
+        Chunk& last = mChunks.LastElement();
+        uint32_t toCopy = std::min(aDataLen, last.mCapacity - last.mLength);
+        memcpy(last.mData + last.mLength, aNewData, toCopy);
+        last.mLength += toCopy;
+        mChunksLength += toCopy;
+        aNewData += toCopy;
+        aDataLen -= toCopy;
+        continue;
+      }
+
+      uint32_t chunkCap = std::max(aMaxGrowth, aDataLen);
+      uint8_t* chunkData = (uint8_t *) js_malloc(chunkCap);
+      if (!chunkData) {
+        return false;
+      }
+      Chunk* chunk = mChunks.AppendElement();
+      if (!chunk) {
+        js_free(chunkData);
+        return false;
+      }
+      chunk->mData = chunkData;
+      chunk->mCapacity = chunkCap;
+      chunk->mLength = 0;
+    }
+
+    return true;
+  }
+
   if (mLength + aDataLen > mCapacity) {
     uint32_t newcap;
     // Double while under aMaxGrowth or if not specified.
@@ -4049,10 +4118,10 @@ ArrayBufferBuilder::getArrayBuffer(JSContext* aCx)
     return obj;
   }
 
-  // we need to check for mLength == 0, because nothing may have been
+  // we need to check for length() == 0, because nothing may have been
   // added
-  if (mCapacity > mLength || mLength == 0) {
-    if (!setCapacity(mLength)) {
+  if (!mChunks.IsEmpty() || mCapacity > mLength || mLength == 0) {
+    if (!setCapacity(length())) {
       return nullptr;
     }
   }
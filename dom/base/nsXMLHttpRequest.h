@@ -58,6 +58,11 @@ class File;
 // A helper for building up an ArrayBuffer object's data
 // before creating the ArrayBuffer itself.  Will do doubling
 // based reallocation, up to an optional maximum growth given.
+// Once the contiguous buffer reaches that maximum, further data
+// accumulates in a list of overflow chunks instead, so a large
+// download of unknown length never pays repeated realloc copies;
+// the chunks are coalesced with a single copy when the buffer is
+// next resized or handed to JS.
 //
 // When all the data has been appended, call getArrayBuffer,
 // passing in the JSContext* for which the ArrayBuffer object
@@ -65,9 +70,21 @@ class File;
 // or it can be reset explicitly at any point by calling reset().
 class ArrayBufferBuilder
 {
+  // An overflow chunk; only the tail chunk has free capacity.
+  struct Chunk
+  {
+    uint8_t* mData;
+    uint32_t mCapacity;
+    uint32_t mLength;
+  };
+
   uint8_t* mDataPtr;
   uint32_t mCapacity;
   uint32_t mLength;
+  // Data appended after the contiguous buffer stopped growing.  Non-empty
+  // only when mDataPtr is full (mLength == mCapacity).
+  nsTArray<Chunk> mChunks;
+  uint32_t mChunksLength;
   void* mMapPtr;
 public:
   ArrayBufferBuilder();
@@ -75,20 +92,22 @@ public:
 
   void reset();
 
-  // Will truncate if aNewCap is < length().
+  // Will truncate if aNewCap is < length().  Coalesces any overflow
+  // chunks back into the contiguous buffer.
   bool setCapacity(uint32_t aNewCap);
 
   // Append aDataLen bytes from data to the current buffer.  If we
   // need to grow the buffer, grow by doubling the size up to a
-  // maximum of aMaxGrowth (if given).  If aDataLen is greater than
-  // what the new capacity would end up as, then grow by aDataLen.
+  // maximum of aMaxGrowth (if given).  Once the buffer has reached
+  // aMaxGrowth, further data goes into overflow chunks of aMaxGrowth
+  // bytes rather than reallocating.
   //
   // The data parameter must not overlap with anything beyond the
   // builder's current valid contents [0..length)
   bool append(const uint8_t* aNewData, uint32_t aDataLen,
               uint32_t aMaxGrowth = 0);
 
-  uint32_t length()   { return mLength; }
+  uint32_t length()   { return mLength + mChunksLength; }
   uint32_t capacity() { return mCapacity; }
 
   JSObject* getArrayBuffer(JSContext* aCx);
@@ -512,7 +512,16 @@ public:
   explicit AdjustedTarget(CanvasRenderingContext2D* ctx,
                           const mgfx::Rect *aBounds = nullptr)
   {
-    mTarget = ctx->mTarget;
+    if (ctx->NeedToDrawShadow() || ctx->NeedToApplyFilter()) {
+      // Shadows and filters snapshot intermediate surfaces and mutate filter
+      // nodes, neither of which can be recorded for later replay. Realize any
+      // captured commands and work against the backing target directly so
+      // that draw order is preserved.
+      ctx->FlushCapturedCommands();
+      mTarget = ctx->BackingTarget();
+    } else {
+      mTarget = ctx->mTarget;
+    }
 
     // All rects in this function are in the device space of ctx->mTarget.
 
@@ -815,8 +824,10 @@ public:
       return;
 
     // Since SkiaGL default to store drawing command until flush
-    // We will have to flush it before present.
-    context->mTarget->Flush();
+    // We will have to flush it before present. The same goes for any
+    // commands recorded by a capture target.
+    context->FlushCapturedCommands();
+    context->BackingTarget()->Flush();
   }
 
   static void DidTransactionCallback(void* aData)
@@ -1032,6 +1043,8 @@ CanvasRenderingContext2D::Reset()
   }
 
   mTarget = nullptr;
+  mBackingTarget = nullptr;
+  mCaptureTarget = nullptr;
 
   // reset hit regions
   mHitRegionsOptions.ClearAndRetainStorage();
@@ -1183,9 +1196,13 @@ bool CanvasRenderingContext2D::SwitchRenderingMode(RenderingMode aRenderingMode)
   }
 #endif
 
-  RefPtr<SourceSurface> snapshot = mTarget->Snapshot();
+  FlushCapturedCommands();
+
+  RefPtr<SourceSurface> snapshot = BackingTarget()->Snapshot();
   RefPtr<DrawTarget> oldTarget = mTarget;
   mTarget = nullptr;
+  mBackingTarget = nullptr;
+  mCaptureTarget = nullptr;
   mResetLayer = true;
 
   // Recreate target using the new rendering mode
@@ -1389,6 +1406,21 @@ CanvasRenderingContext2D::EnsureTarget(RenderingMode aRenderingMode)
       JS_updateMallocCounter(context, mWidth * mHeight * 4);
     }
 
+    // When enabled, record drawing commands into a capture target and replay
+    // them in one batched pass when the frame is presented or read back. This
+    // keeps the per-call overhead low for content that issues very large
+    // numbers of simple draw calls. SkiaGL batches internally and hands its
+    // backing texture to the compositor, so leave it alone.
+    if (mode == RenderingMode::SoftwareBackendMode &&
+        Preferences::GetBool("gfx.canvas.capture.enabled", false)) {
+      RefPtr<DrawTargetCapture> capture = mTarget->CreateCaptureDT(size);
+      if (capture) {
+        mBackingTarget = mTarget;
+        mCaptureTarget = capture;
+        mTarget = capture;
+      }
+    }
+
     mTarget->ClearRect(mgfx::Rect(Point(0, 0), Size(mWidth, mHeight)));
     if (mTarget->GetBackendType() == mgfx::BackendType::CAIRO) {
       // Cairo doesn't play well with huge clips. When given a very big clip it
@@ -1415,6 +1447,22 @@ CanvasRenderingContext2D::EnsureTarget(RenderingMode aRenderingMode)
   return mode;
 }
 
+void
+CanvasRenderingContext2D::FlushCapturedCommands()
+{
+  if (!mCaptureTarget || mCaptureTarget->IsEmpty()) {
+    return;
+  }
+
+  MOZ_ASSERT(mTarget == mCaptureTarget);
+  MOZ_ASSERT(mBackingTarget);
+
+  // Replay the whole recording in one pass and keep the command storage
+  // around for the next batch.
+  mBackingTarget->DrawCapturedDT(mCaptureTarget, Matrix());
+  mCaptureTarget->PurgeDrawCommands();
+}
+
 #ifdef DEBUG
 int32_t
 CanvasRenderingContext2D::GetWidth() const
@@ -1578,7 +1626,8 @@ CanvasRenderingContext2D::GetImageBuffer(uint8_t** aImageBuffer,
   *aFormat = 0;
 
   EnsureTarget();
-  RefPtr<SourceSurface> snapshot = mTarget->Snapshot();
+  FlushCapturedCommands();
+  RefPtr<SourceSurface> snapshot = BackingTarget()->Snapshot();
   if (!snapshot) {
     return;
   }
@@ -3810,6 +3859,109 @@ gfxFontGroup *CanvasRenderingContext2D::GetCurrentFontStyle()
   return CurrentState().fontGroup;
 }
 
+void
+CanvasRenderingContext2D::MeasureTextWidths(const Sequence<nsString>& aTexts,
+                                            nsTArray<double>& aWidths,
+                                            ErrorResult& aError)
+{
+  if (!mCanvasElement && !mDocShell) {
+    NS_WARNING("Canvas element must be non-null or a docshell must be provided");
+    aError.Throw(NS_ERROR_FAILURE);
+    return;
+  }
+
+  nsCOMPtr<nsIPresShell> presShell = GetPresShell();
+  if (!presShell) {
+    aError.Throw(NS_ERROR_FAILURE);
+    return;
+  }
+
+  nsIDocument* document = presShell->GetDocument();
+
+  // for now, default to ltr if not in doc
+  bool isRTL = false;
+
+  nsRefPtr<nsStyleContext> canvasStyle;
+  if (mCanvasElement && mCanvasElement->IsInDoc()) {
+    // try to find the closest context
+    canvasStyle =
+      nsComputedDOMStyle::GetStyleContextForElement(mCanvasElement,
+                                                    nullptr,
+                                                    presShell);
+    if (!canvasStyle) {
+      aError.Throw(NS_ERROR_FAILURE);
+      return;
+    }
+
+    isRTL = canvasStyle->StyleVisibility()->mDirection ==
+      NS_STYLE_DIRECTION_RTL;
+  } else {
+    isRTL = GET_BIDI_OPTION_DIRECTION(document->GetBidiOptions()) == IBMBIDI_TEXTDIRECTION_RTL;
+  }
+
+  gfxFontGroup* currentFontStyle = GetCurrentFontStyle();
+  NS_ASSERTION(currentFontStyle, "font group is null");
+
+  // ensure user font set is up to date
+  currentFontStyle->
+    SetUserFontSet(presShell->GetPresContext()->GetUserFontSet());
+
+  if (currentFontStyle->GetStyle()->size == 0.0F) {
+    for (uint32_t i = 0; i < aTexts.Length(); ++i) {
+      aWidths.AppendElement(0.0);
+    }
+    return;
+  }
+
+  // The style resolution, reference context and processor setup above are
+  // shared by the whole batch, as are the shaped-word caches the font group
+  // fills in; only the bidi measurement pass runs per string.
+  CanvasBidiProcessor processor;
+
+  processor.mTextRunFlags = canvasStyle ?
+    nsLayoutUtils::GetTextRunFlagsForStyle(canvasStyle,
+                                           canvasStyle->StyleFont(),
+                                           canvasStyle->StyleText(),
+                                           0) : 0;
+
+  GetAppUnitsValues(&processor.mAppUnitsPerDevPixel, nullptr);
+  processor.mPt = gfxPoint(0, 0);
+  processor.mThebes =
+    new gfxContext(gfxPlatform::GetPlatform()->ScreenReferenceDrawTarget());
+  processor.mCtx = this;
+  processor.mOp = TextDrawOperation::MEASURE;
+  processor.mBoundingBox = gfxRect(0, 0, 0, 0);
+  processor.mDoMeasureBoundingBox = false;
+  processor.mState = &CurrentState();
+  processor.mFontgrp = currentFontStyle;
+
+  nsBidi bidiEngine;
+  for (uint32_t i = 0; i < aTexts.Length(); ++i) {
+    // replace all the whitespace characters with U+0020 SPACE
+    nsAutoString textToMeasure(aTexts[i]);
+    TextReplaceWhitespaceCharacters(textToMeasure);
+
+    nscoord totalWidthCoord;
+    nsresult rv = nsBidiPresUtils::ProcessText(textToMeasure.get(),
+                                               textToMeasure.Length(),
+                                               isRTL ? NSBIDI_RTL : NSBIDI_LTR,
+                                               presShell->GetPresContext(),
+                                               processor,
+                                               nsBidiPresUtils::MODE_MEASURE,
+                                               nullptr,
+                                               0,
+                                               &totalWidthCoord,
+                                               &bidiEngine);
+    if (NS_FAILED(rv)) {
+      aError.Throw(rv);
+      return;
+    }
+
+    aWidths.AppendElement(double(totalWidthCoord) /
+                          processor.mAppUnitsPerDevPixel);
+  }
+}
+
 //
 // line caps/joins
 //
@@ -4872,7 +5024,8 @@ CanvasRenderingContext2D::GetImageDataArray(JSContext* aCx,
   IntRect srcReadRect = srcRect.Intersect(destRect);
   RefPtr<DataSourceSurface> readback;
   if (!srcReadRect.IsEmpty() && !mZero) {
-    RefPtr<SourceSurface> snapshot = mTarget->Snapshot();
+    FlushCapturedCommands();
+    RefPtr<SourceSurface> snapshot = BackingTarget()->Snapshot();
     if (snapshot) {
       readback = snapshot->GetDataSurface();
     }
@@ -5246,7 +5399,8 @@ CanvasRenderingContext2D::GetCanvasLayer(nsDisplayListBuilder* aBuilder,
     return nullptr;
   }
 
-  mTarget->Flush();
+  FlushCapturedCommands();
+  BackingTarget()->Flush();
 
   if (!mResetLayer && aOldLayer) {
     CanvasRenderingContext2DUserData* userData =
@@ -5263,7 +5417,7 @@ CanvasRenderingContext2D::GetCanvasLayer(nsDisplayListBuilder* aBuilder,
       data.mGLContext = glue->GetGLContext();
       data.mFrontbufferGLTex = skiaGLTex;
     } else {
-      data.mDrawTarget = mTarget;
+      data.mDrawTarget = BackingTarget();
     }
 
     if (userData && userData->IsForContext(this) && aOldLayer->IsDataValid(data)) {
@@ -5312,7 +5466,13 @@ CanvasRenderingContext2D::GetCanvasLayer(nsDisplayListBuilder* aBuilder,
     data.mGLContext = glue->GetGLContext();
     data.mFrontbufferGLTex = skiaGLTex;
   } else {
-    data.mDrawTarget = mTarget;
+    if (mCaptureTarget) {
+      // Captured commands must be replayed into the backing target before
+      // the compositor snapshots it.
+      canvasLayer->SetPreTransactionCallback(
+              CanvasRenderingContext2DUserData::PreTransactionCallback, userData);
+    }
+    data.mDrawTarget = BackingTarget();
   }
 
   canvasLayer->Initialize(data);
@@ -266,6 +266,9 @@ public:
                   mozilla::ErrorResult& error);
   TextMetrics*
     MeasureText(const nsAString& rawText, mozilla::ErrorResult& error);
+  void MeasureTextWidths(const Sequence<nsString>& texts,
+                         nsTArray<double>& retval,
+                         mozilla::ErrorResult& error);
 
   void AddHitRegion(const HitRegionOptions& options, mozilla::ErrorResult& error);
   void RemoveHitRegion(const nsAString& id);
@@ -510,7 +513,8 @@ public:
     if (aPremultAlpha) {
       *aPremultAlpha = true;
     }
-    return mTarget->Snapshot();
+    FlushCapturedCommands();
+    return BackingTarget()->Snapshot();
   }
 
   NS_IMETHOD SetIsOpaque(bool isOpaque) MOZ_OVERRIDE;
@@ -697,6 +701,28 @@ protected:
    */
   void ClearTarget();
 
+  /*
+   * Replays any drawing commands recorded by the capture target into the
+   * backing target in a single pass. This must be called before the canvas
+   * pixels are read back or drawn to the backing target directly, so that
+   * command order is preserved. Does nothing when command capture is not
+   * active.
+   */
+  void FlushCapturedCommands();
+
+  /*
+   * The draw target that owns the canvas pixels. This is the same as mTarget
+   * unless command capture is active, in which case mTarget only records
+   * commands for later replay here.
+   */
+  mozilla::gfx::DrawTarget* BackingTarget() const
+  {
+    if (mBackingTarget) {
+      return mBackingTarget;
+    }
+    return mTarget;
+  }
+
   /**
    * Check if the target is valid after calling EnsureTarget.
    */
@@ -775,6 +801,14 @@ protected:
   // sErrorTarget.
   mozilla::RefPtr<mozilla::gfx::DrawTarget> mTarget;
 
+  // When gfx.canvas.capture.enabled is set, mTarget is a DrawTargetCapture
+  // recording drawing commands into a compact buffer and mBackingTarget is
+  // the draw target that owns the actual pixels. FlushCapturedCommands()
+  // replays the recording into mBackingTarget in one batched pass. Both are
+  // null when command capture is not active.
+  mozilla::RefPtr<mozilla::gfx::DrawTarget> mBackingTarget;
+  mozilla::RefPtr<mozilla::gfx::DrawTargetCapture> mCaptureTarget;
+
   uint32_t SkiaGLTex() const;
 
   // This observes our draw calls at the beginning of the canvas
@@ -1315,7 +1315,23 @@ protected:
         if (!mPixelStorePremultiplyAlpha)
             flags |= nsLayoutUtils::SFE_PREFER_NO_PREMULTIPLY_ALPHA;
 
-        return nsLayoutUtils::SurfaceFromElement(element, flags);
+        // With default unpack state the decoded surface is interchangeable
+        // with the one 2D canvas keeps for drawImage, so repeated uploads of
+        // the same image (e.g. an atlas reuploaded every level load) skip
+        // the decode and readback entirely.
+        bool cacheable = flags == nsLayoutUtils::SFE_WANT_IMAGE_SURFACE;
+        if (cacheable) {
+            nsLayoutUtils::SurfaceFromElementResult cached =
+                CachedSurfaceFromElement(element);
+            if (cached.mSourceSurface)
+                return cached;
+        }
+
+        nsLayoutUtils::SurfaceFromElementResult res =
+            nsLayoutUtils::SurfaceFromElement(element, flags);
+        if (cacheable)
+            CacheElementSurface(element, res);
+        return res;
     }
 
     template<class ElementType>
@@ -1324,6 +1340,17 @@ protected:
        return SurfaceFromElement(&element);
     }
 
+    // Counterparts of CanvasRenderingContext2D::CachedSurfaceFromElement:
+    // reuse a decoded surface another canvas consumer already produced for
+    // this element, and publish ours for them, via the shared
+    // CanvasImageCache.
+    nsLayoutUtils::SurfaceFromElementResult
+    CachedSurfaceFromElement(dom::Element* element);
+
+    void
+    CacheElementSurface(dom::Element* element,
+                        nsLayoutUtils::SurfaceFromElementResult& res);
+
     nsresult
     SurfaceFromElementResultToImageSurface(nsLayoutUtils::SurfaceFromElementResult& res,
                                            RefPtr<gfx::DataSourceSurface>& imageOut,
@@ -27,10 +27,14 @@
 
 #include "nsContentUtils.h"
 #include "nsError.h"
+#include "nsIImageLoadingContent.h"
 #include "nsLayoutUtils.h"
 
+#include "CanvasImageCache.h"
 #include "CanvasUtils.h"
+#include "gfx2DGlue.h"
 #include "gfxUtils.h"
+#include "imgIRequest.h"
 
 #include "jsfriendapi.h"
 
@@ -45,6 +49,7 @@
 
 #include "mozilla/DebugOnly.h"
 #include "mozilla/dom/BindingUtils.h"
+#include "mozilla/dom/Element.h"
 #include "mozilla/dom/ImageData.h"
 #include "mozilla/dom/ToJSValue.h"
 #include "mozilla/Endian.h"
@@ -2684,6 +2689,72 @@ WebGLContext::StencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum
     gl->fStencilOpSeparate(face, sfail, dpfail, dppass);
 }
 
+nsLayoutUtils::SurfaceFromElementResult
+WebGLContext::CachedSurfaceFromElement(dom::Element* element)
+{
+    nsLayoutUtils::SurfaceFromElementResult res;
+
+    nsCOMPtr<nsIImageLoadingContent> imageLoader = do_QueryInterface(element);
+    if (!imageLoader)
+        return res;
+
+    nsCOMPtr<imgIRequest> imgRequest;
+    imageLoader->GetRequest(nsIImageLoadingContent::CURRENT_REQUEST,
+                            getter_AddRefs(imgRequest));
+    if (!imgRequest)
+        return res;
+
+    uint32_t status;
+    if (NS_FAILED(imgRequest->GetImageStatus(&status)) ||
+        !(status & imgIRequest::STATUS_LOAD_COMPLETE))
+    {
+        return res;
+    }
+
+    nsCOMPtr<nsIPrincipal> principal;
+    if (NS_FAILED(imgRequest->GetImagePrincipal(getter_AddRefs(principal))) ||
+        !principal)
+    {
+        return res;
+    }
+
+    res.mSourceSurface = CanvasImageCache::SimpleLookup(element);
+    if (!res.mSourceSurface)
+        return res;
+
+    // The surface came straight out of the image request, so re-derive the
+    // security-relevant state from that request; the usual checks in
+    // SurfaceFromElementResultToImageSurface still run on what we return.
+    int32_t corsmode = imgIRequest::CORS_NONE;
+    if (NS_SUCCEEDED(imgRequest->GetCORSMode(&corsmode)))
+        res.mCORSUsed = corsmode != imgIRequest::CORS_NONE;
+
+    res.mSize = ThebesIntSize(res.mSourceSurface->GetSize());
+    res.mPrincipal = principal.forget();
+    res.mIsWriteOnly = false;
+    res.mImageRequest = imgRequest.forget();
+
+    return res;
+}
+
+void
+WebGLContext::CacheElementSurface(dom::Element* element,
+                                  nsLayoutUtils::SurfaceFromElementResult& res)
+{
+    // Only image elements with a finished request produce surfaces that
+    // later lookups (ours or 2D canvas's) can validate, and only
+    // premultiplied surfaces mean the same thing to every consumer.
+    if (!res.mSourceSurface || !res.mImageRequest || res.mIsWriteOnly ||
+        !res.mIsPremultiplied || !mCanvasElement)
+    {
+        return;
+    }
+
+    CanvasImageCache::NotifyDrawImage(element, mCanvasElement,
+                                      res.mImageRequest, res.mSourceSurface,
+                                      res.mSize);
+}
+
 nsresult
 WebGLContext::SurfaceFromElementResultToImageSurface(nsLayoutUtils::SurfaceFromElementResult& res,
                                                      RefPtr<DataSourceSurface>& imageOut,
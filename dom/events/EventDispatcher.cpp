@@ -358,13 +358,20 @@ EventTargetChainItem::HandleEventTargetChain(
   }
 }
 
-static nsTArray<EventTargetChainItem>* sCachedMainThreadChain = nullptr;
+// Recycled storage for event target chains, so that high-frequency events
+// like mousemove don't reallocate the chain on every dispatch. Nested
+// dispatch (a listener dispatching another event synchronously) takes more
+// than one buffer at a time, so a small stack of buffers is kept rather
+// than a single one.
+static nsTArray<nsTArray<EventTargetChainItem>>* sCachedMainThreadChains = nullptr;
+static const uint32_t kCachedMainThreadChainSize = 128;
+static const uint32_t kMaxCachedMainThreadChains = 8;
 
 /* static */ void
 EventDispatcher::Shutdown()
 {
-  delete sCachedMainThreadChain;
-  sCachedMainThreadChain = nullptr;
+  delete sCachedMainThreadChains;
+  sCachedMainThreadChains = nullptr;
 }
 
 EventTargetChainItem*
@@ -506,11 +513,15 @@ EventDispatcher::Dispatch(nsISupports* aTarget,
   ELMCreationDetector cd;
   nsTArray<EventTargetChainItem> chain;
   if (cd.IsMainThread()) {
-    if (!sCachedMainThreadChain) {
-      sCachedMainThreadChain = new nsTArray<EventTargetChainItem>();
+    if (!sCachedMainThreadChains) {
+      sCachedMainThreadChains = new nsTArray<nsTArray<EventTargetChainItem>>();
     }
-    chain.SwapElements(*sCachedMainThreadChain);
-    chain.SetCapacity(128);
+    if (!sCachedMainThreadChains->IsEmpty()) {
+      uint32_t last = sCachedMainThreadChains->Length() - 1;
+      chain.SwapElements((*sCachedMainThreadChains)[last]);
+      sCachedMainThreadChains->RemoveElementAt(last);
+    }
+    chain.SetCapacity(kCachedMainThreadChainSize);
   }
 
   // Create the event target chain item for the event target.
@@ -662,9 +673,14 @@ EventDispatcher::Dispatch(nsISupports* aTarget,
     *aEventStatus = preVisitor.mEventStatus;
   }
 
-  if (cd.IsMainThread() && chain.Capacity() == 128 && sCachedMainThreadChain) {
+  // Return the chain buffer to the pool. Buffers which grew past the
+  // default capacity are kept as-is, so repeated dispatches through deep
+  // trees don't reallocate either.
+  if (cd.IsMainThread() && sCachedMainThreadChains &&
+      chain.Capacity() >= kCachedMainThreadChainSize &&
+      sCachedMainThreadChains->Length() < kMaxCachedMainThreadChains) {
     chain.ClearAndRetainStorage();
-    chain.SwapElements(*sCachedMainThreadChain);
+    sCachedMainThreadChains->AppendElement()->SwapElements(chain);
   }
 
   return rv;
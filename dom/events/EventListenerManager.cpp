@@ -105,6 +105,7 @@ EventListenerManager::EventListenerManager(EventTarget* aTarget)
   , mIsMainThreadELM(NS_IsMainThread())
   , mNoListenerForEvent(0)
   , mTarget(aTarget)
+  , mEventTypeBits(0)
 {
   NS_ASSERTION(aTarget, "unexpected null pointer");
 
@@ -136,6 +137,7 @@ EventListenerManager::RemoveAllListeners()
   }
   mClearingListeners = true;
   mListeners.Clear();
+  mEventTypeBits = 0;
   mClearingListeners = false;
 }
 
@@ -259,6 +261,7 @@ EventListenerManager::AddEventListenerInternal(
   listener->mListenerIsHandler = aHandler;
   listener->mHandlerIsString = false;
   listener->mAllEvents = aAllEvents;
+  mEventTypeBits |= ListenerTypeBits(listener);
 
   // Detect the type of event listener.
   nsCOMPtr<nsIXPConnectWrappedJS> wjs;
@@ -504,6 +507,7 @@ EventListenerManager::RemoveEventListenerInternal(
         --count;
         mNoListenerForEvent = NS_EVENT_NULL;
         mNoListenerForEventAtom = nullptr;
+        RecomputeEventTypeBits();
         if (mTarget && aUserType) {
           mTarget->EventListenerRemoved(aUserType);
         }
@@ -558,6 +562,31 @@ EventListenerManager::ListenerCanHandle(Listener* aListener,
   return aListener->mEventType == aEvent->message;
 }
 
+uint64_t
+EventListenerManager::ListenerTypeBits(Listener* aListener)
+{
+  // All-events listeners and listeners identified only by a type string (on
+  // non-main-thread event targets) have to match against every dispatch.
+  if (aListener->mAllEvents || !aListener->mTypeAtom) {
+    return ~uint64_t(0);
+  }
+  // A listener can be reached either through its event message or, when an
+  // event whose type maps to the same atom is dispatched with message
+  // NS_USER_DEFINED_EVENT, through its type atom; see ListenerCanHandle.
+  return EventTypeBit(aListener->mEventType, aListener->mTypeAtom) |
+         EventTypeBit(NS_USER_DEFINED_EVENT, aListener->mTypeAtom);
+}
+
+void
+EventListenerManager::RecomputeEventTypeBits()
+{
+  mEventTypeBits = 0;
+  uint32_t count = mListeners.Length();
+  for (uint32_t i = 0; i < count; ++i) {
+    mEventTypeBits |= ListenerTypeBits(&mListeners.ElementAt(i));
+  }
+}
+
 void
 EventListenerManager::AddEventListenerByType(
                         const EventListenerHolder& aListenerHolder,
@@ -764,6 +793,7 @@ EventListenerManager::RemoveEventHandler(nsIAtom* aName,
     mListeners.RemoveElementAt(uint32_t(listener - &mListeners.ElementAt(0)));
     mNoListenerForEvent = NS_EVENT_NULL;
     mNoListenerForEventAtom = nullptr;
+    RecomputeEventTypeBits();
     if (mTarget && aName) {
       mTarget->EventListenerRemoved(aName);
     }
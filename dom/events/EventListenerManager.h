@@ -320,6 +320,12 @@ public:
       return;
     }
 
+    // Check the bitmap of listened-for event types so that dispatching an
+    // event no listener was added for costs only a load and a branch.
+    if (!(mEventTypeBits & EventTypeBit(aEvent->message, aEvent->userType))) {
+      return;
+    }
+
     // Check if we already know that there is no event listener for the event.
     if (mNoListenerForEvent == aEvent->message &&
         (mNoListenerForEvent != NS_USER_DEFINED_EVENT ||
@@ -417,6 +423,28 @@ public:
   dom::EventTarget* GetTarget() { return mTarget; }
 
 protected:
+  /**
+   * Returns the mEventTypeBits bit under which listeners for events with the
+   * given message (and type atom, for NS_USER_DEFINED_EVENT) are recorded.
+   */
+  static uint64_t EventTypeBit(uint32_t aEventMessage, nsIAtom* aTypeAtom)
+  {
+    uintptr_t hash = aEventMessage == NS_USER_DEFINED_EVENT ?
+      reinterpret_cast<uintptr_t>(aTypeAtom) >> 4 : aEventMessage;
+    return uint64_t(1) << (hash & 63);
+  }
+
+  /**
+   * Returns the set of mEventTypeBits bits under which events handled by
+   * aListener may be dispatched.
+   */
+  uint64_t ListenerTypeBits(Listener* aListener);
+
+  /**
+   * Recomputes mEventTypeBits from scratch after a listener was removed.
+   */
+  void RecomputeEventTypeBits();
+
   void HandleEventInternal(nsPresContext* aPresContext,
                            WidgetEvent* aEvent,
                            nsIDOMEvent** aDOMEvent,
@@ -560,6 +588,10 @@ protected:
   nsAutoTObserverArray<Listener, 2> mListeners;
   dom::EventTarget* mTarget;  // WEAK
   nsCOMPtr<nsIAtom> mNoListenerForEventAtom;
+  // Approximate bitmap of the event types mListeners contains listeners for;
+  // see EventTypeBit. Since unrelated types can hash to the same bit, a set
+  // bit doesn't guarantee a listener, but a clear bit means there is none.
+  uint64_t mEventTypeBits;
 
   friend class ELMCreationDetector;
   static uint32_t sMainThreadCreatedCount;
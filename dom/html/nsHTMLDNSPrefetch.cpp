@@ -23,10 +23,13 @@
 #include "nsICancelable.h"
 #include "nsGkAtoms.h"
 #include "nsIDocument.h"
+#include "nsTHashtable.h"
+#include "nsHashKeys.h"
 #include "nsThreadUtils.h"
 #include "nsITimer.h"
 #include "nsIObserverService.h"
 #include "mozilla/dom/Link.h"
+#include "mozilla/TimeStamp.h"
 
 #include "mozilla/Preferences.h"
 
@@ -41,6 +44,41 @@ static nsIDNSService *sDNSService = nullptr;
 static nsHTMLDNSPrefetch::nsDeferrals *sPrefetches = nullptr;
 static nsHTMLDNSPrefetch::nsListener *sDNSListener = nullptr;
 
+// Hostnames submitted for speculative resolution recently.  The speculation
+// scanner and the deferral queue emit one prefetch per anchor, so pages with
+// hundreds of links to a few hosts would otherwise submit the same names
+// over and over.  The set is cleared once a minute (or when it grows large)
+// so it never blocks a TTL-driven refresh in the DNS cache for long.
+static nsTHashtable<nsCStringHashKey> *sRecentPrefetches = nullptr;
+static mozilla::TimeStamp sRecentPrefetchEpoch;
+static const uint32_t kRecentPrefetchSeconds = 60;
+static const uint32_t kRecentPrefetchMaxEntries = 512;
+
+// Returns true if a resolve for this host should be submitted, and records
+// the submission.  Returns false for a duplicate of a recent submission.
+static bool
+RecordPrefetchSubmission(const nsACString &hostname)
+{
+  NS_ASSERTION(NS_IsMainThread(),
+               "RecordPrefetchSubmission must be on main thread");
+
+  if (!sRecentPrefetches)
+    return true;
+
+  mozilla::TimeStamp now = mozilla::TimeStamp::Now();
+  if (sRecentPrefetches->Count() >= kRecentPrefetchMaxEntries ||
+      (now - sRecentPrefetchEpoch).ToSeconds() >= kRecentPrefetchSeconds) {
+    sRecentPrefetches->Clear();
+    sRecentPrefetchEpoch = now;
+  }
+
+  if (sRecentPrefetches->Contains(hostname))
+    return false;
+
+  sRecentPrefetches->PutEntry(hostname);
+  return true;
+}
+
 nsresult
 nsHTMLDNSPrefetch::Initialize()
 {
@@ -55,6 +93,9 @@ nsHTMLDNSPrefetch::Initialize()
   sDNSListener = new nsHTMLDNSPrefetch::nsListener();
   NS_ADDREF(sDNSListener);
 
+  sRecentPrefetches = new nsTHashtable<nsCStringHashKey>();
+  sRecentPrefetchEpoch = mozilla::TimeStamp::Now();
+
   sPrefetches->Activate();
 
   Preferences::AddBoolVarCache(&sDisablePrefetchHTTPSPref,
@@ -87,7 +128,10 @@ nsHTMLDNSPrefetch::Shutdown()
   NS_IF_RELEASE(sDNSService);
   NS_IF_RELEASE(sPrefetches);
   NS_IF_RELEASE(sDNSListener);
-  
+
+  delete sRecentPrefetches;
+  sRecentPrefetches = nullptr;
+
   return NS_OK;
 }
 
@@ -132,11 +176,13 @@ nsHTMLDNSPrefetch::PrefetchHigh(Link *aElement)
 nsresult
 nsHTMLDNSPrefetch::Prefetch(const nsAString &hostname, uint16_t flags)
 {
+  NS_ConvertUTF16toUTF8 hostname8(hostname);
+
   if (IsNeckoChild()) {
     // We need to check IsEmpty() because net_IsValidHostName()
     // considers empty strings to be valid hostnames
-    if (!hostname.IsEmpty() &&
-        net_IsValidHostName(NS_ConvertUTF16toUTF8(hostname))) {
+    if (!hostname.IsEmpty() && net_IsValidHostName(hostname8) &&
+        RecordPrefetchSubmission(hostname8)) {
       gNeckoChild->SendHTMLDNSPrefetch(nsAutoString(hostname), flags);
     }
     return NS_OK;
@@ -145,10 +191,13 @@ nsHTMLDNSPrefetch::Prefetch(const nsAString &hostname, uint16_t flags)
   if (!(sInitialized && sDNSService && sPrefetches && sDNSListener))
     return NS_ERROR_NOT_AVAILABLE;
 
+  if (!RecordPrefetchSubmission(hostname8))
+    return NS_OK;
+
   nsCOMPtr<nsICancelable> tmpOutstanding;
-  return sDNSService->AsyncResolve(NS_ConvertUTF16toUTF8(hostname),
+  return sDNSService->AsyncResolve(hostname8,
                                    flags | nsIDNSService::RESOLVE_SPECULATE,
-                                   sDNSListener, nullptr, 
+                                   sDNSListener, nullptr,
                                    getter_AddRefs(tmpOutstanding));
 }
 
@@ -315,7 +364,11 @@ nsHTMLDNSPrefetch::nsDeferrals::SubmitQueue()
           hrefURI->GetAsciiHost(hostName);
 
         if (!hostName.IsEmpty()) {
-          if (IsNeckoChild()) {
+          if (!RecordPrefetchSubmission(hostName)) {
+            // A resolve for this host was submitted moments ago; the cache
+            // already has (or is fetching) the answer.
+            link->OnDNSPrefetchRequested();
+          } else if (IsNeckoChild()) {
             gNeckoChild->SendHTMLDNSPrefetch(NS_ConvertUTF8toUTF16(hostName),
                                            mEntries[mTail].mFlags);
           } else {
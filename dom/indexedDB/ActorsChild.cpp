@@ -2019,6 +2019,9 @@ BackgroundRequestChild::Recv__delete__(const RequestResponse& aResponse)
     case RequestResponse::TObjectStorePutResponse:
       return HandleResponse(aResponse.get_ObjectStorePutResponse().key());
 
+    case RequestResponse::TObjectStorePutAllResponse:
+      return HandleResponse(aResponse.get_ObjectStorePutAllResponse().keys());
+
     case RequestResponse::TObjectStoreGetResponse:
       return HandleResponse(aResponse.get_ObjectStoreGetResponse().cloneInfo());
 
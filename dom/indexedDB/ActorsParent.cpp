@@ -4523,22 +4523,26 @@ class ObjectStoreAddOrPutRequestOp MOZ_FINAL
 
   struct StoredFileInfo;
 
-  const ObjectStoreAddPutParams mParams;
+  // One entry per record. putAll() sends many records in a single request;
+  // add() and put() are simply batches of length 1.
+  nsTArray<ObjectStoreAddPutParams> mParamsArray;
   Maybe<UniqueIndexTable> mUniqueIndexTable;
 
   // This must be non-const so that we can update the mNextAutoIncrementId field
   // if we are modifying an autoIncrement objectStore.
   nsRefPtr<FullObjectStoreMetadata> mMetadata;
 
-  FallibleTArray<StoredFileInfo> mStoredFileInfos;
+  // Parallel to mParamsArray.
+  nsTArray<FallibleTArray<StoredFileInfo>> mStoredFileInfoArrays;
 
   nsRefPtr<FileManager> mFileManager;
 
-  Key mResponse;
+  nsTArray<Key> mResponses;
   const nsCString mGroup;
   const nsCString mOrigin;
   const PersistenceType mPersistenceType;
   const bool mOverwrite;
+  const bool mPutAll;
 
 private:
   // Only created by TransactionBase.
@@ -4551,6 +4555,13 @@ private:
   nsresult
   CopyFileData(nsIInputStream* aInputStream, nsIOutputStream* aOutputStream);
 
+  nsresult
+  PerformInsert(TransactionBase* aTransaction,
+                const ObjectStoreAddPutParams& aParams,
+                FallibleTArray<StoredFileInfo>& aStoredFileInfos,
+                int64_t& aNextAutoIncrementId,
+                Key& aResponse);
+
   virtual bool
   Init(TransactionBase* aTransaction) MOZ_OVERRIDE;
 
@@ -6914,6 +6925,31 @@ TransactionBase::VerifyRequestParams(const RequestParams& aParams) const
       break;
     }
 
+    case RequestParams::TObjectStorePutAllParams: {
+      const nsTArray<ObjectStoreAddPutParams>& paramsArray =
+        aParams.get_ObjectStorePutAllParams().commonParams();
+      if (NS_WARN_IF(paramsArray.IsEmpty())) {
+        ASSERT_UNLESS_FUZZING();
+        return false;
+      }
+      // Every record in a putAll() must target the same object store.
+      const int64_t objectStoreId = paramsArray[0].objectStoreId();
+      for (uint32_t count = paramsArray.Length(), index = 0;
+           index < count;
+           index++) {
+        const ObjectStoreAddPutParams& params = paramsArray[index];
+        if (NS_WARN_IF(params.objectStoreId() != objectStoreId)) {
+          ASSERT_UNLESS_FUZZING();
+          return false;
+        }
+        if (NS_WARN_IF(!VerifyRequestParams(params))) {
+          ASSERT_UNLESS_FUZZING();
+          return false;
+        }
+      }
+      break;
+    }
+
     case RequestParams::TObjectStoreGetParams: {
       const ObjectStoreGetParams& params = aParams.get_ObjectStoreGetParams();
       const nsRefPtr<FullObjectStoreMetadata> objectStoreMetadata =
@@ -7538,6 +7574,7 @@ TransactionBase::AllocRequest(const RequestParams& aParams, bool aTrustParams)
   switch (aParams.type()) {
     case RequestParams::TObjectStoreAddParams:
     case RequestParams::TObjectStorePutParams:
+    case RequestParams::TObjectStorePutAllParams:
       actor = new ObjectStoreAddOrPutRequestOp(this, aParams);
       break;
 
@@ -14511,19 +14548,36 @@ ObjectStoreAddOrPutRequestOp::ObjectStoreAddOrPutRequestOp(
                                                   TransactionBase* aTransaction,
                                                   const RequestParams& aParams)
   : NormalTransactionOp(aTransaction)
-  , mParams(aParams.type() == RequestParams::TObjectStoreAddParams ?
-              aParams.get_ObjectStoreAddParams().commonParams() :
-              aParams.get_ObjectStorePutParams().commonParams())
   , mGroup(aTransaction->GetDatabase()->Group())
   , mOrigin(aTransaction->GetDatabase()->Origin())
   , mPersistenceType(aTransaction->GetDatabase()->Type())
-  , mOverwrite(aParams.type() == RequestParams::TObjectStorePutParams)
+  , mOverwrite(aParams.type() != RequestParams::TObjectStoreAddParams)
+  , mPutAll(aParams.type() == RequestParams::TObjectStorePutAllParams)
 {
-  MOZ_ASSERT(aParams.type() == RequestParams::TObjectStoreAddParams ||
-             aParams.type() == RequestParams::TObjectStorePutParams);
+  switch (aParams.type()) {
+    case RequestParams::TObjectStoreAddParams:
+      mParamsArray.AppendElement(
+        aParams.get_ObjectStoreAddParams().commonParams());
+      break;
+
+    case RequestParams::TObjectStorePutParams:
+      mParamsArray.AppendElement(
+        aParams.get_ObjectStorePutParams().commonParams());
+      break;
+
+    case RequestParams::TObjectStorePutAllParams:
+      mParamsArray.AppendElements(
+        aParams.get_ObjectStorePutAllParams().commonParams());
+      break;
+
+    default:
+      MOZ_CRASH("Should never get here!");
+  }
+
+  MOZ_ASSERT(!mParamsArray.IsEmpty());
 
   mMetadata =
-    aTransaction->GetMetadataForObjectStoreId(mParams.objectStoreId());
+    aTransaction->GetMetadataForObjectStoreId(mParamsArray[0].objectStoreId());
   MOZ_ASSERT(mMetadata);
 }
 
@@ -14587,13 +14641,27 @@ ObjectStoreAddOrPutRequestOp::Init(TransactionBase* aTransaction)
 {
   AssertIsOnOwningThread();
 
-  const nsTArray<IndexUpdateInfo>& indexUpdateInfos =
-    mParams.indexUpdateInfos();
+  const uint32_t paramsCount = mParamsArray.Length();
+  MOZ_ASSERT(paramsCount);
+
+  if (mOverwrite) {
+    // Kinda lame...
+    mUniqueIndexTable.emplace();
+  }
+
+  for (uint32_t paramsIndex = 0; paramsIndex < paramsCount; paramsIndex++) {
+    const nsTArray<IndexUpdateInfo>& indexUpdateInfos =
+      mParamsArray[paramsIndex].indexUpdateInfos();
+
+    if (indexUpdateInfos.IsEmpty()) {
+      continue;
+    }
 
-  if (!indexUpdateInfos.IsEmpty()) {
     const uint32_t count = indexUpdateInfos.Length();
 
-    mUniqueIndexTable.emplace();
+    if (!mUniqueIndexTable) {
+      mUniqueIndexTable.emplace();
+    }
 
     for (uint32_t index = 0; index < count; index++) {
       const IndexUpdateInfo& updateInfo = indexUpdateInfos[index];
@@ -14608,16 +14676,16 @@ ObjectStoreAddOrPutRequestOp::Init(TransactionBase* aTransaction)
       const bool& unique = indexMetadata->mCommonMetadata.unique();
 
       MOZ_ASSERT(indexId == updateInfo.indexId());
-      MOZ_ASSERT_IF(!indexMetadata->mCommonMetadata.multiEntry(),
-                    !mUniqueIndexTable.ref().Get(indexId));
+
+      if (mUniqueIndexTable.ref().Get(indexId, nullptr)) {
+        // Already known from an earlier record of this batch.
+        continue;
+      }
 
       if (NS_WARN_IF(!mUniqueIndexTable.ref().Put(indexId, unique, fallible))) {
         return false;
       }
     }
-  } else if (mOverwrite) {
-    // Kinda lame...
-    mUniqueIndexTable.emplace();
   }
 
 #ifdef DEBUG
@@ -14626,18 +14694,32 @@ ObjectStoreAddOrPutRequestOp::Init(TransactionBase* aTransaction)
   }
 #endif
 
-  const nsTArray<DatabaseFileOrMutableFileId>& files = mParams.files();
+  nsRefPtr<FileManager> fileManager;
+
+  mStoredFileInfoArrays.SetCapacity(paramsCount);
+
+  for (uint32_t paramsIndex = 0; paramsIndex < paramsCount; paramsIndex++) {
+    const nsTArray<DatabaseFileOrMutableFileId>& files =
+      mParamsArray[paramsIndex].files();
+
+    FallibleTArray<StoredFileInfo>* storedFileInfos =
+      mStoredFileInfoArrays.AppendElement();
+    MOZ_ASSERT(storedFileInfos);
+
+    if (files.IsEmpty()) {
+      continue;
+    }
 
-  if (!files.IsEmpty()) {
     const uint32_t count = files.Length();
 
-    if (NS_WARN_IF(!mStoredFileInfos.SetCapacity(count))) {
+    if (NS_WARN_IF(!storedFileInfos->SetCapacity(count))) {
       return false;
     }
 
-    nsRefPtr<FileManager> fileManager =
-      aTransaction->GetDatabase()->GetFileManager();
-    MOZ_ASSERT(fileManager);
+    if (!fileManager) {
+      fileManager = aTransaction->GetDatabase()->GetFileManager();
+      MOZ_ASSERT(fileManager);
+    }
 
     for (uint32_t index = 0; index < count; index++) {
       const DatabaseFileOrMutableFileId& fileOrFileId = files[index];
@@ -14646,7 +14728,7 @@ ObjectStoreAddOrPutRequestOp::Init(TransactionBase* aTransaction)
                      TPBackgroundIDBDatabaseFileParent ||
                  fileOrFileId.type() == DatabaseFileOrMutableFileId::Tint64_t);
 
-      StoredFileInfo* storedFileInfo = mStoredFileInfos.AppendElement();
+      StoredFileInfo* storedFileInfo = storedFileInfos->AppendElement();
       MOZ_ASSERT(storedFileInfo);
 
       switch (fileOrFileId.type()) {
@@ -14688,7 +14770,7 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(TransactionBase* aTransaction)
 {
   MOZ_ASSERT(aTransaction);
   aTransaction->AssertIsOnTransactionThread();
-  MOZ_ASSERT_IF(mFileManager, !mStoredFileInfos.IsEmpty());
+  MOZ_ASSERT(mParamsArray.Length() == mStoredFileInfoArrays.Length());
 
   PROFILER_LABEL("IndexedDB",
                  "ObjectStoreAddOrPutRequestOp::DoDatabaseWork",
@@ -14698,18 +14780,67 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(TransactionBase* aTransaction)
     return NS_ERROR_DOM_INDEXEDDB_QUOTA_ERR;
   }
 
+  // All the records of a batch succeed or fail together under one savepoint.
   TransactionBase::AutoSavepoint autoSave;
   nsresult rv = autoSave.Start(aTransaction);
   if (NS_WARN_IF(NS_FAILED(rv))) {
     return rv;
   }
 
+  // Records later in the batch must see the autoIncrement ids consumed by
+  // records earlier in the batch, but mMetadata must not be updated until the
+  // whole batch has actually hit the database.
+  int64_t nextAutoIncrementId = mMetadata->mNextAutoIncrementId;
+
+  mResponses.SetCapacity(mParamsArray.Length());
+
+  for (uint32_t count = mParamsArray.Length(), index = 0;
+       index < count;
+       index++) {
+    Key* response = mResponses.AppendElement();
+    MOZ_ASSERT(response);
+
+    rv = PerformInsert(aTransaction,
+                       mParamsArray[index],
+                       mStoredFileInfoArrays[index],
+                       nextAutoIncrementId,
+                       *response);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+  }
+
+  rv = autoSave.Commit();
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    return rv;
+  }
+
+  if (nextAutoIncrementId != mMetadata->mNextAutoIncrementId) {
+    mMetadata->mNextAutoIncrementId = nextAutoIncrementId;
+    aTransaction->NoteModifiedAutoIncrementObjectStore(mMetadata);
+  }
+
+  return NS_OK;
+}
+
+nsresult
+ObjectStoreAddOrPutRequestOp::PerformInsert(
+                                TransactionBase* aTransaction,
+                                const ObjectStoreAddPutParams& aParams,
+                                FallibleTArray<StoredFileInfo>& aStoredFileInfos,
+                                int64_t& aNextAutoIncrementId,
+                                Key& aResponse)
+{
+  aTransaction->AssertIsOnTransactionThread();
+
+  nsresult rv;
+
   // This will be the final key we use.
-  Key& key = mResponse;
-  key = mParams.key();
+  Key& key = aResponse;
+  key = aParams.key();
 
   const bool keyUnset = key.IsUnset();
-  const int64_t osid = mParams.objectStoreId();
+  const int64_t osid = aParams.objectStoreId();
   const KeyPath& keyPath = mMetadata->mCommonMetadata.keyPath();
 
   // The "|| keyUnset" here is mostly a debugging tool. If a key isn't
@@ -14745,7 +14876,7 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(TransactionBase* aTransaction)
 
   if (mMetadata->mCommonMetadata.autoIncrement()) {
     if (keyUnset) {
-      autoIncrementNum = mMetadata->mNextAutoIncrementId;
+      autoIncrementNum = aNextAutoIncrementId;
 
       MOZ_ASSERT(autoIncrementNum > 0);
 
@@ -14756,12 +14887,12 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(TransactionBase* aTransaction)
 
       key.SetFromInteger(autoIncrementNum);
     } else if (key.IsFloat() &&
-               key.ToFloat() >= mMetadata->mNextAutoIncrementId) {
+               key.ToFloat() >= aNextAutoIncrementId) {
       autoIncrementNum = floor(key.ToFloat());
     }
 
     if (keyUnset && keyPath.IsValid()) {
-      const SerializedStructuredCloneWriteInfo& cloneInfo = mParams.cloneInfo();
+      const SerializedStructuredCloneWriteInfo& cloneInfo = aParams.cloneInfo();
       MOZ_ASSERT(cloneInfo.offsetToKeyProp());
       MOZ_ASSERT(cloneInfo.data().Length() > sizeof(uint64_t));
       MOZ_ASSERT(cloneInfo.offsetToKeyProp() <=
@@ -14784,8 +14915,8 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(TransactionBase* aTransaction)
 
   // Compress the bytes before adding into the database.
   const char* uncompressed =
-    reinterpret_cast<const char*>(mParams.cloneInfo().data().Elements());
-  size_t uncompressedLength = mParams.cloneInfo().data().Length();
+    reinterpret_cast<const char*>(aParams.cloneInfo().data().Elements());
+  size_t uncompressedLength = aParams.cloneInfo().data().Length();
 
   // We don't have a smart pointer class that calls moz_free, so we need to
   // manage | compressed | manually.
@@ -14846,13 +14977,13 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(TransactionBase* aTransaction)
     MOZ_ASSERT(isDirectory);
   }
 
-  if (!mStoredFileInfos.IsEmpty()) {
+  if (!aStoredFileInfos.IsEmpty()) {
     nsAutoString fileIds;
 
-    for (uint32_t count = mStoredFileInfos.Length(), index = 0;
+    for (uint32_t count = aStoredFileInfos.Length(), index = 0;
          index < count;
          index++) {
-      StoredFileInfo& storedFileInfo = mStoredFileInfos[index];
+      StoredFileInfo& storedFileInfo = aStoredFileInfos[index];
       MOZ_ASSERT(storedFileInfo.mFileInfo);
 
       const int64_t id = storedFileInfo.mFileInfo->Id();
@@ -15014,7 +15145,7 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(TransactionBase* aTransaction)
   }
 
   // Update our indexes if needed.
-  if (mOverwrite || !mParams.indexUpdateInfos().IsEmpty()) {
+  if (mOverwrite || !aParams.indexUpdateInfos().IsEmpty()) {
     MOZ_ASSERT(mUniqueIndexTable);
 
     rv = UpdateIndexes(aTransaction,
@@ -15022,20 +15153,14 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(TransactionBase* aTransaction)
                        key,
                        mOverwrite,
                        objectDataId,
-                       mParams.indexUpdateInfos());
+                       aParams.indexUpdateInfos());
     if (NS_FAILED(rv)) {
       return rv;
     }
   }
 
-  rv = autoSave.Commit();
-  if (NS_WARN_IF(NS_FAILED(rv))) {
-    return rv;
-  }
-
   if (autoIncrementNum) {
-    mMetadata->mNextAutoIncrementId = autoIncrementNum + 1;
-    aTransaction->NoteModifiedAutoIncrementObjectStore(mMetadata);
+    aNextAutoIncrementId = autoIncrementNum + 1;
   }
 
   return NS_OK;
@@ -15046,10 +15171,14 @@ ObjectStoreAddOrPutRequestOp::GetResponse(RequestResponse& aResponse)
 {
   AssertIsOnOwningThread();
 
-  if (mOverwrite) {
-    aResponse = ObjectStorePutResponse(mResponse);
+  MOZ_ASSERT(mResponses.Length() == mParamsArray.Length());
+
+  if (mPutAll) {
+    aResponse = ObjectStorePutAllResponse(mResponses);
+  } else if (mOverwrite) {
+    aResponse = ObjectStorePutResponse(mResponses[0]);
   } else {
-    aResponse = ObjectStoreAddResponse(mResponse);
+    aResponse = ObjectStoreAddResponse(mResponses[0]);
   }
 }
 
@@ -15058,11 +15187,16 @@ ObjectStoreAddOrPutRequestOp::Cleanup()
 {
   AssertIsOnOwningThread();
 
-  if (!mStoredFileInfos.IsEmpty()) {
-    for (uint32_t count = mStoredFileInfos.Length(), index = 0;
+  for (uint32_t arrayCount = mStoredFileInfoArrays.Length(), arrayIndex = 0;
+       arrayIndex < arrayCount;
+       arrayIndex++) {
+    FallibleTArray<StoredFileInfo>& storedFileInfos =
+      mStoredFileInfoArrays[arrayIndex];
+
+    for (uint32_t count = storedFileInfos.Length(), index = 0;
          index < count;
          index++) {
-      StoredFileInfo& storedFileInfo = mStoredFileInfos[index];
+      StoredFileInfo& storedFileInfo = storedFileInfos[index];
       nsRefPtr<DatabaseFile>& fileActor = storedFileInfo.mFileActor;
 
       MOZ_ASSERT_IF(!fileActor, !storedFileInfo.mCopiedSuccessfully);
@@ -15071,10 +15205,10 @@ ObjectStoreAddOrPutRequestOp::Cleanup()
         fileActor->ClearInputStream();
       }
     }
-
-    mStoredFileInfos.Clear();
   }
 
+  mStoredFileInfoArrays.Clear();
+
   NormalTransactionOp::Cleanup();
 }
 
@@ -195,6 +195,7 @@ TabChildBase::TabChildBase()
   : mContentDocumentIsDisplayed(false)
   , mTabChildGlobal(nullptr)
   , mInnerSize(0, 0)
+  , mFrameMetricsFlushScheduled(false)
 {
   mozilla::HoldJSObjects(this);
 }
@@ -534,6 +535,52 @@ TabChildBase::UpdateFrameHandler(const FrameMetrics& aFrameMetrics)
 {
   MOZ_ASSERT(aFrameMetrics.GetScrollId() != FrameMetrics::NULL_SCROLL_ID);
 
+  // The compositor can produce frame updates faster than we consume them,
+  // e.g. one per vsync during a fling while the content thread is busy.
+  // Queue the newest metrics for each scroll frame and apply them all in one
+  // batch from the tail of the event queue, so a burst of updates costs one
+  // repaint request and one scroll event instead of one per message.
+  for (uint32_t i = 0; i < mPendingFrameMetrics.Length(); i++) {
+    if (mPendingFrameMetrics[i].GetScrollId() == aFrameMetrics.GetScrollId() &&
+        mPendingFrameMetrics[i].GetIsRoot() == aFrameMetrics.GetIsRoot()) {
+      mPendingFrameMetrics[i] = aFrameMetrics;
+      return true;
+    }
+  }
+  mPendingFrameMetrics.AppendElement(aFrameMetrics);
+
+  if (!mFrameMetricsFlushScheduled) {
+    nsCOMPtr<nsIRunnable> flusher =
+      NS_NewRunnableMethod(this, &TabChildBase::FlushPendingFrameMetrics);
+    if (NS_SUCCEEDED(NS_DispatchToCurrentThread(flusher))) {
+      mFrameMetricsFlushScheduled = true;
+    } else {
+      // If the flush can't be scheduled, apply the update right away rather
+      // than dropping it.
+      mPendingFrameMetrics.Clear();
+      return ApplyFrameMetrics(aFrameMetrics);
+    }
+  }
+  return true;
+}
+
+void
+TabChildBase::FlushPendingFrameMetrics()
+{
+  mFrameMetricsFlushScheduled = false;
+
+  // Applying metrics can run script, which may deliver new updates; move the
+  // queue aside so those start a fresh batch.
+  nsTArray<FrameMetrics> metrics;
+  metrics.SwapElements(mPendingFrameMetrics);
+  for (uint32_t i = 0; i < metrics.Length(); i++) {
+    ApplyFrameMetrics(metrics[i]);
+  }
+}
+
+bool
+TabChildBase::ApplyFrameMetrics(const FrameMetrics& aFrameMetrics)
+{
   if (aFrameMetrics.GetIsRoot()) {
     nsCOMPtr<nsIDOMWindowUtils> utils(GetDOMWindowUtils());
     if (APZCCallbackHelper::HasValidPresShellId(utils, aFrameMetrics)) {
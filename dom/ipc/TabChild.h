@@ -228,12 +228,22 @@ protected:
 
     bool UpdateFrameHandler(const mozilla::layers::FrameMetrics& aFrameMetrics);
 
+    // Apply a single frame metrics update to the appropriate scroll frame.
+    bool ApplyFrameMetrics(const mozilla::layers::FrameMetrics& aFrameMetrics);
+
+    // Apply all queued frame metrics updates in one batch.
+    void FlushPendingFrameMetrics();
+
 protected:
     CSSSize mOldViewportSize;
     bool mContentDocumentIsDisplayed;
     nsRefPtr<TabChildGlobal> mTabChildGlobal;
     ScreenIntSize mInnerSize;
     mozilla::layers::FrameMetrics mLastRootMetrics;
+    // Frame metrics updates from the compositor that have arrived but not yet
+    // been applied; at most one entry per scroll id, newest wins.
+    nsTArray<mozilla::layers::FrameMetrics> mPendingFrameMetrics;
+    bool mFrameMetricsFlushScheduled;
     mozilla::layout::ScrollingBehavior mScrolling;
     nsCOMPtr<nsIWebBrowserChrome3> mWebBrowserChrome;
 };
@@ -82,7 +82,7 @@ DownmixAndInterleave(const nsTArray<const void*>& aChannelData,
   channelData.SetLength(aChannelData.Length());
   if (aSourceFormat != AUDIO_FORMAT_FLOAT32) {
     NS_ASSERTION(aSourceFormat == AUDIO_FORMAT_S16, "unknown format");
-    downmixConversionBuffer.SetLength(aDuration*aChannelData.Length());
+    downmixConversionBuffer.SetLengthUninitialized(aDuration*aChannelData.Length());
     for (uint32_t i = 0; i < aChannelData.Length(); ++i) {
       float* conversionBuf = downmixConversionBuffer.Elements() + (i*aDuration);
       const int16_t* sourceBuf = static_cast<const int16_t*>(aChannelData[i]);
@@ -97,7 +97,7 @@ DownmixAndInterleave(const nsTArray<const void*>& aChannelData,
     }
   }
 
-  downmixOutputBuffer.SetLength(aDuration*aOutputChannels);
+  downmixOutputBuffer.SetLengthUninitialized(aDuration*aOutputChannels);
   nsAutoTArray<float*,GUESS_AUDIO_CHANNELS> outputChannelBuffers;
   nsAutoTArray<const void*,GUESS_AUDIO_CHANNELS> outputChannelData;
   outputChannelBuffers.SetLength(aOutputChannels);
@@ -160,7 +160,8 @@ AudioSegment::WriteTo(uint64_t aID, AudioMixer& aMixer, uint32_t aOutputChannels
   }
 
   uint32_t outBufferLength = GetDuration() * aOutputChannels;
-  buf.SetLength(outBufferLength);
+  // Every sample is either written or memset below, so skip construction.
+  buf.SetLengthUninitialized(outBufferLength);
 
 
   for (ChunkIterator ci(*this); !ci.IsEnded(); ci.Next()) {
@@ -205,7 +205,9 @@ public:
       uint32_t outSize = (c.mDuration * aOutRate + aInRate - 1) / aInRate;
       for (uint32_t i = 0; i < channels; i++) {
         const T* in = static_cast<const T*>(c.mChannelData[i]);
-        T* out = output[i].AppendElements(outSize);
+        // The resampler writes every frame it reports back, and the array
+        // is then truncated to that count, so don't construct the samples.
+        T* out = output[i].AppendElementsUninitialized(outSize);
         uint32_t outFrames = outSize;
 
         dom::WebAudioUtils::SpeexResamplerProcess(aResampler, i,
@@ -5,6 +5,7 @@
 
 #include <MediaStreamGraphImpl.h>
 #include "CubebUtils.h"
+#include "nsThreadManager.h"
 
 #ifdef XP_MACOSX
 #include <sys/sysctl.h>
@@ -191,6 +192,10 @@ public:
     char aLocal;
     STREAM_LOG(PR_LOG_DEBUG, ("Starting system thread"));
     profiler_register_thread("MediaStreamGraph", &aLocal);
+    // The graph thread feeds audio callbacks, so let platform policy pin it
+    // to whatever cores are reserved for latency-sensitive work.
+    nsThreadManager::get()->SetCurrentThreadClass(
+      nsThreadManager::THREAD_CLASS_REALTIME_AUDIO);
     LIFECYCLE_LOG("Starting a new system driver for graph %p\n",
                   mDriver->mGraphImpl);
     if (mDriver->mPreviousDriver) {
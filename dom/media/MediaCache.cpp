@@ -381,6 +381,10 @@ MediaCacheStream::MediaCacheStream(ChannelMediaResource* aClient)
     mStreamLength(-1),
     mStreamOffset(0),
     mPlaybackBytesPerSecond(10000),
+    mRecentBytesPerSecond(0),
+    mConsumptionWindowBytes(0),
+    mCacheHitCount(0),
+    mCacheMissCount(0),
     mPinCount(0),
     mCurrentMode(MODE_PLAYBACK),
     mMetadataInPartialBlockBuffer(false),
@@ -1000,7 +1004,7 @@ MediaCache::PredictNextUse(TimeStamp aNow, int32_t aBlock)
       int64_t bytesBehind =
         bo->mStream->mStreamOffset - static_cast<int64_t>(bo->mStreamBlock)*BLOCK_SIZE;
       int64_t millisecondsBehind =
-        bytesBehind*1000/bo->mStream->mPlaybackBytesPerSecond;
+        bytesBehind*1000/bo->mStream->GetEffectivePlaybackRate();
       prediction = TimeDuration::FromMilliseconds(
           std::min<int64_t>(millisecondsBehind*REPLAY_PENALTY_FACTOR, INT32_MAX));
       break;
@@ -1011,7 +1015,7 @@ MediaCache::PredictNextUse(TimeStamp aNow, int32_t aBlock)
       NS_ASSERTION(bytesAhead >= 0,
                    "Readahead block before the current stream position?");
       int64_t millisecondsAhead =
-        bytesAhead*1000/bo->mStream->mPlaybackBytesPerSecond;
+        bytesAhead*1000/bo->mStream->GetEffectivePlaybackRate();
       prediction = TimeDuration::FromMilliseconds(
           std::min<int64_t>(millisecondsAhead, INT32_MAX));
       break;
@@ -1039,7 +1043,7 @@ MediaCache::PredictNextUseForIncomingData(MediaCacheStream* aStream)
   }
   if (bytesAhead <= 0)
     return TimeDuration(0);
-  int64_t millisecondsAhead = bytesAhead*1000/aStream->mPlaybackBytesPerSecond;
+  int64_t millisecondsAhead = bytesAhead*1000/aStream->GetEffectivePlaybackRate();
   return TimeDuration::FromMilliseconds(
       std::min<int64_t>(millisecondsAhead, INT32_MAX));
 }
@@ -2006,6 +2010,10 @@ MediaCacheStream::CloseInternal(ReentrantMonitorAutoEnter& aReentrantMonitor)
   if (mClosed)
     return;
   mClosed = true;
+  CACHE_LOG(PR_LOG_DEBUG,
+            ("Stream %p closing: %u cache hits, %u misses, %f seconds stalled",
+             this, mCacheHitCount, mCacheMissCount,
+             mCacheStallTime.ToSeconds()));
   // Closing a stream will change the return value of
   // MediaCacheStream::AreAllStreamsForResourceSuspended as well as
   // ChannelMediaResource::IsSuspendedByCache. Let's notify it.
@@ -2146,6 +2154,34 @@ MediaCacheStream::SetReadMode(ReadMode aMode)
   gMediaCache->QueueUpdate();
 }
 
+uint32_t
+MediaCacheStream::GetEffectivePlaybackRate()
+{
+  gMediaCache->GetReentrantMonitor().AssertCurrentThreadIn();
+  return std::max(mPlaybackBytesPerSecond, mRecentBytesPerSecond);
+}
+
+uint32_t
+MediaCacheStream::GetCacheHitCount()
+{
+  ReentrantMonitorAutoEnter mon(gMediaCache->GetReentrantMonitor());
+  return mCacheHitCount;
+}
+
+uint32_t
+MediaCacheStream::GetCacheMissCount()
+{
+  ReentrantMonitorAutoEnter mon(gMediaCache->GetReentrantMonitor());
+  return mCacheMissCount;
+}
+
+double
+MediaCacheStream::GetCacheStallSeconds()
+{
+  ReentrantMonitorAutoEnter mon(gMediaCache->GetReentrantMonitor());
+  return mCacheStallTime.ToSeconds();
+}
+
 void
 MediaCacheStream::SetPlaybackRate(uint32_t aBytesPerSecond)
 {
@@ -2215,6 +2251,7 @@ MediaCacheStream::Read(char* aBuffer, uint32_t aCount, uint32_t* aBytes)
     return NS_ERROR_FAILURE;
 
   uint32_t count = 0;
+  bool missed = false;
   // Read one block (or part of a block) at a time
   while (count < aCount) {
     uint32_t streamBlock = uint32_t(mStreamOffset/BLOCK_SIZE);
@@ -2276,7 +2313,15 @@ MediaCacheStream::Read(char* aBuffer, uint32_t aCount, uint32_t* aBytes)
       }
 
       // No data has been read yet, so block
+      if (!missed) {
+        missed = true;
+        ++mCacheMissCount;
+      }
+      TimeStamp blockedAt = TimeStamp::Now();
       mon.Wait();
+      TimeDuration blocked = TimeStamp::Now() - blockedAt;
+      mCacheStallTime += blocked;
+      mConsumptionWindowStall += blocked;
       if (mClosed) {
         // We may have successfully read some data, but let's just throw
         // that out.
@@ -2302,6 +2347,33 @@ MediaCacheStream::Read(char* aBuffer, uint32_t aCount, uint32_t* aBytes)
   }
 
   if (count > 0) {
+    if (!missed) {
+      ++mCacheHitCount;
+    }
+
+    // Track the recent consumption rate over windows of roughly a second
+    // of demand, excluding time spent blocked above, so the readahead
+    // target follows local bitrate spikes that the decoder's long-term
+    // average rate smooths away (see GetEffectivePlaybackRate).
+    TimeStamp now = TimeStamp::Now();
+    if (mConsumptionWindowStart.IsNull()) {
+      mConsumptionWindowStart = now;
+    }
+    mConsumptionWindowBytes += count;
+    double elapsed = (now - mConsumptionWindowStart).ToSeconds() -
+                     mConsumptionWindowStall.ToSeconds();
+    if (elapsed >= 1.0) {
+      uint32_t rate = uint32_t(std::min<double>(
+        mConsumptionWindowBytes/elapsed, UINT32_MAX));
+      // Blend with the previous window so one burst doesn't whipsaw the
+      // readahead target
+      mRecentBytesPerSecond =
+        mRecentBytesPerSecond ? (mRecentBytesPerSecond + rate)/2 : rate;
+      mConsumptionWindowStart = now;
+      mConsumptionWindowStall = TimeDuration();
+      mConsumptionWindowBytes = 0;
+    }
+
     // Some data was read, so queue an update since block priorities may
     // have changed
     gMediaCache->QueueUpdate();
@@ -11,6 +11,7 @@
 #include "nsCOMPtr.h"
 #include "nsHashKeys.h"
 #include "nsTHashtable.h"
+#include "mozilla/TimeStamp.h"
 
 class nsIPrincipal;
 
@@ -349,6 +350,16 @@ public:
 
   size_t SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const;
 
+  // Per-stream cache effectiveness counters for diagnostics. A hit is a
+  // Read() satisfied entirely from cached data without blocking; a miss is
+  // a Read() that had to block waiting for data. GetCacheStallSeconds()
+  // returns the cumulative time Read() has spent blocked, i.e. stall risk
+  // realized for this stream. These take the cache monitor and can be
+  // called from any thread.
+  uint32_t GetCacheHitCount();
+  uint32_t GetCacheMissCount();
+  double GetCacheStallSeconds();
+
 private:
   friend class MediaCache;
 
@@ -487,8 +498,28 @@ private:
   BlockList         mMetadataBlocks;
   // The list of played-back blocks; the first block is the most recently used
   BlockList         mPlayedBlocks;
+  // Return the rate the cache should assume this stream is being consumed
+  // at: the decoder-reported long-term playback rate, or the recently
+  // measured consumption rate when that is higher (e.g. across a local
+  // bitrate spike in variable-bitrate media). Must be called with the
+  // cache's monitor held.
+  uint32_t GetEffectivePlaybackRate();
+
   // The last reported estimate of the decoder's playback rate
   uint32_t          mPlaybackBytesPerSecond;
+  // Recently measured consumption rate, updated by Read() over windows of
+  // roughly a second of demand (time blocked waiting for data is excluded
+  // so stalls don't mask a bitrate spike). 0 until the first window
+  // completes.
+  uint32_t          mRecentBytesPerSecond;
+  // Measurement state for mRecentBytesPerSecond
+  TimeStamp         mConsumptionWindowStart;
+  TimeDuration      mConsumptionWindowStall;
+  int64_t           mConsumptionWindowBytes;
+  // @see GetCacheHitCount and friends
+  uint32_t          mCacheHitCount;
+  uint32_t          mCacheMissCount;
+  TimeDuration      mCacheStallTime;
   // The number of times this stream has been Pinned without a
   // corresponding Unpin
   uint32_t          mPinCount;
@@ -177,6 +177,18 @@ public:
     mIgnoreAudioOutputFormat = true;
   }
 
+  // Suggest that the reader output video frames no larger than aSize,
+  // downscaling during decode if its decoder supports that. Consumers that
+  // present video at a small size (picture-in-picture style players) can
+  // use this so a 4K stream is not decoded, converted and uploaded at full
+  // resolution only to be shown in a corner. This is a hint: readers are
+  // free to ignore it and callers must cope with full size frames. An
+  // empty size clears the hint.
+  void SetMaxVideoOutputSize(const gfx::IntSize& aSize)
+  {
+    mMaxVideoOutputSize = aSize;
+  }
+
   // Populates aBuffered with the time ranges which are buffered. This function
   // is called on the main, decode, and state machine threads.
   //
@@ -289,6 +301,10 @@ protected:
   // what we support.
   bool mIgnoreAudioOutputFormat;
 
+  // Maximum video output size requested via SetMaxVideoOutputSize(), or
+  // an empty size if the consumer wants full resolution frames.
+  gfx::IntSize mMaxVideoOutputSize;
+
   // The start time of the media, in microseconds. This is the presentation
   // time of the first frame decoded from the media. This is initialized to -1,
   // and then set to a value >= by MediaDecoderStateMachine::SetStartTime(),
@@ -3006,6 +3006,20 @@ void MediaDecoderStateMachine::AdvanceFrame()
     frameStats.NotifyPresentedFrame();
     remainingTime = currentFrame->GetEndTime() - clock_time;
     currentFrame = nullptr;
+
+    // Also hand the next decoded frame to the image container, tagged with
+    // its presentation time. The container queues future frames and flips
+    // to them when the current image is next locked for painting, so the
+    // flip tracks actual presentation instead of waiting for this loop to
+    // wake up again; see ImageContainer::SetCurrentImageAtTime.
+    nsRefPtr<VideoData> nextFrame = VideoQueue().PeekFront();
+    if (nextFrame && !nextFrame->mDuplicate) {
+      int64_t nextDelta = nextFrame->mTime - clock_time;
+      TimeStamp nextTarget =
+        nowTime + TimeDuration::FromMicroseconds(nextDelta / mPlaybackRate);
+      ReentrantMonitorAutoExit exitMon(mDecoder->GetReentrantMonitor());
+      RenderVideoFrame(nextFrame, nextTarget);
+    }
   }
 
   // Cap the current time to the larger of the audio and video end time.
@@ -1224,7 +1224,16 @@ MediaStreamGraphImpl::ProduceDataForStreamsBlockByBlock(uint32_t aStreamIndex,
     for (uint32_t i = aStreamIndex; i < mStreams.Length(); ++i) {
       ProcessedMediaStream* ps = mStreams[i]->AsProcessedStream();
       if (ps) {
-        ps->ProcessInput(t, next, (next == aTo) ? ProcessedMediaStream::ALLOW_FINISH : 0);
+        uint32_t flags = (next == aTo) ? ProcessedMediaStream::ALLOW_FINISH : 0;
+        if (mRealtime) {
+          TimeStamp processingStart = TimeStamp::Now();
+          ps->ProcessInput(t, next, flags);
+          ps->mIterationProcessingCost += TimeStamp::Now() - processingStart;
+        } else {
+          // Offline graphs run as fast as possible; there is no realtime
+          // budget to enforce, so skip the timestamp reads.
+          ps->ProcessInput(t, next, flags);
+        }
       }
     }
     t = next;
@@ -1326,7 +1335,14 @@ MediaStreamGraphImpl::Process(GraphTime aFrom, GraphTime aTo)
           ProduceDataForStreamsBlockByBlock(i, n->SampleRate(), aFrom, aTo);
           doneAllProducing = true;
         } else {
+          TimeStamp processingStart;
+          if (mRealtime) {
+            processingStart = TimeStamp::Now();
+          }
           ps->ProcessInput(aFrom, aTo, ProcessedMediaStream::ALLOW_FINISH);
+          if (mRealtime) {
+            ps->mIterationProcessingCost += TimeStamp::Now() - processingStart;
+          }
           NS_WARN_IF_FALSE(stream->mBuffer.GetEnd() >=
                            GraphTimeToStreamTime(stream, aTo),
                            "Stream did not produce enough data");
@@ -1376,11 +1392,55 @@ MediaStreamGraphImpl::Process(GraphTime aFrom, GraphTime aTo)
     }
   }
 
+  if (mRealtime) {
+    EnforceProcessingBudgets(aFrom, aTo);
+  }
+
   if (!allBlockedForever) {
     EnsureNextIteration();
   }
 }
 
+// A single stream may spend at most this fraction of the wall-clock duration
+// of an iteration in ProcessInput() before we consider it to have overrun its
+// budget. The graph as a whole must complete well within the iteration for
+// realtime playback, so any one stream taking close to half of it is about to
+// glitch every other stream.
+static const double PROCESSING_BUDGET_FRACTION = 0.4;
+// The number of consecutive overruns we tolerate before notifying the stream,
+// so that one-off spikes (paging, lock contention) don't degrade anything.
+static const uint32_t PROCESSING_BUDGET_OVERRUN_LIMIT = 3;
+
+void
+MediaStreamGraphImpl::EnforceProcessingBudgets(GraphTime aFrom, GraphTime aTo)
+{
+  MOZ_ASSERT(mRealtime, "Offline graphs have no realtime budget");
+  TimeDuration budget = TimeDuration::FromSeconds(
+      MediaTimeToSeconds(aTo - aFrom) * PROCESSING_BUDGET_FRACTION);
+  for (uint32_t i = 0; i < mStreams.Length(); ++i) {
+    ProcessedMediaStream* ps = mStreams[i]->AsProcessedStream();
+    if (!ps) {
+      continue;
+    }
+    if (ps->mIterationProcessingCost > budget) {
+      if (++ps->mProcessingBudgetOverruns >= PROCESSING_BUDGET_OVERRUN_LIMIT) {
+        ps->mProcessingBudgetOverruns = 0;
+        STREAM_LOG(PR_LOG_WARNING,
+                   ("MediaStream %p overran its processing budget (%fms > %fms)",
+                    ps, ps->mIterationProcessingCost.ToMilliseconds(),
+                    budget.ToMilliseconds()));
+        AudioNodeStream* ns = ps->AsAudioNodeStream();
+        if (ns) {
+          ns->Engine()->NotifyProcessingOverrun();
+        }
+      }
+    } else {
+      ps->mProcessingBudgetOverruns = 0;
+    }
+    ps->mIterationProcessingCost = TimeDuration();
+  }
+}
+
 bool
 MediaStreamGraphImpl::OneIteration(GraphTime aFrom, GraphTime aTo,
                                    GraphTime aStateFrom, GraphTime aStateEnd)
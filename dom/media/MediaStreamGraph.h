@@ -8,6 +8,7 @@
 
 #include "mozilla/Mutex.h"
 #include "mozilla/LinkedList.h"
+#include "mozilla/TimeStamp.h"
 #include "AudioStream.h"
 #include "nsTArray.h"
 #include "nsIRunnable.h"
@@ -1037,7 +1038,8 @@ private:
 class ProcessedMediaStream : public MediaStream {
 public:
   explicit ProcessedMediaStream(DOMMediaStream* aWrapper)
-    : MediaStream(aWrapper), mAutofinish(false)
+    : MediaStream(aWrapper), mAutofinish(false),
+      mProcessingBudgetOverruns(0)
   {}
 
   // Control API.
@@ -1131,6 +1133,14 @@ protected:
   // The list of all inputs that are currently enabled or waiting to be enabled.
   nsTArray<MediaInputPort*> mInputs;
   bool mAutofinish;
+  // Wall-clock time this stream spent in ProcessInput() during the current
+  // graph iteration. Accumulated while producing data and reset by
+  // MediaStreamGraphImpl::EnforceProcessingBudgets(). Only maintained for
+  // realtime graphs.
+  TimeDuration mIterationProcessingCost;
+  // The number of consecutive iterations in which this stream has exceeded
+  // its share of the graph's realtime processing budget.
+  uint32_t mProcessingBudgetOverruns;
   // After UpdateStreamOrder(), mCycleMarker is either 0 or 1 to indicate
   // whether this stream is in a muted cycle.  During ordering it can contain
   // other marker values - see MediaStreamGraphImpl::UpdateStreamOrder().
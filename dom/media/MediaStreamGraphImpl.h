@@ -299,6 +299,14 @@ public:
                                          TrackRate aSampleRate,
                                          GraphTime aFrom,
                                          GraphTime aTo);
+  /**
+   * Check the processing time each processed stream accumulated while
+   * producing [aFrom, aTo) against its share of the realtime budget for the
+   * interval, and notify streams that overrun their share repeatedly so they
+   * can degrade themselves instead of glitching the whole graph. Called at
+   * the end of Process() for realtime graphs only.
+   */
+  void EnforceProcessingBudgets(GraphTime aFrom, GraphTime aTo);
   /**
    * Returns true if aStream will underrun at aTime for its own playback.
    * aEndBlockingDecisions is when we plan to stop making blocking decisions.
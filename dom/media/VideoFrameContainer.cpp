@@ -44,6 +44,12 @@ void VideoFrameContainer::SetCurrentFrame(const gfxIntSize& aIntrinsicSize,
   TimeStamp lastPaintTime = mImageContainer->GetPaintTime();
   if (!lastPaintTime.IsNull() && !mPaintTarget.IsNull()) {
     mPaintDelay = lastPaintTime - mPaintTarget;
+    // With look-ahead queueing the paint we observe here can belong to a
+    // frame older than the last target we recorded; treat early paints as
+    // on time rather than reporting a negative delay.
+    if (mPaintDelay < TimeDuration()) {
+      mPaintDelay = TimeDuration();
+    }
   }
 
   // When using the OMX decoder, destruction of the current image can indirectly
@@ -56,7 +62,7 @@ void VideoFrameContainer::SetCurrentFrame(const gfxIntSize& aIntrinsicSize,
   kungFuDeathGrip = mImageContainer->LockCurrentImage();
   mImageContainer->UnlockCurrentImage();
 
-  mImageContainer->SetCurrentImage(aImage);
+  mImageContainer->SetCurrentImageAtTime(aImage, aTargetTime);
   gfx::IntSize newFrameSize = mImageContainer->GetCurrentSize();
   if (oldFrameSize != newFrameSize) {
     mImageSizeChanged = true;
@@ -316,6 +316,16 @@ public:
     NS_NOTREACHED("ProduceBlockBeforeInput called on wrong engine\n");
   }
 
+  /**
+   * Called on the graph thread when this engine's stream has repeatedly
+   * exceeded its share of the graph's realtime processing budget. Engines
+   * with a quality/latency knob may override this to degrade themselves
+   * individually rather than glitching every stream in the graph.
+   */
+  virtual void NotifyProcessingOverrun()
+  {
+  }
+
   /**
    * Produce the next block of audio samples, given input samples in the aInput
    * array.  There is one input sample per active port in aInput, in order.
@@ -15,6 +15,7 @@
 #include "mozilla/dom/ScriptSettings.h"
 #include "mozilla/Mutex.h"
 #include "mozilla/PodOperations.h"
+#include <algorithm>
 #include <deque>
 
 namespace mozilla {
@@ -24,6 +25,12 @@ namespace dom {
 // buffers.
 static const float MAX_LATENCY_S = 0.5;
 
+// The maximum number of WEBAUDIO_BLOCK_SIZE blocks we will buffer up before
+// resuming output after an underrun. Each underrun doubles the requirement
+// up to this cap, trading latency for glitch-free output when the main
+// thread can't keep up.
+static const uint32_t MAX_BUFFERING_BLOCKS = 16;
+
 NS_IMPL_ISUPPORTS_INHERITED0(ScriptProcessorNode, AudioNode)
 
 // This class manages a queue of output buffers shared between
@@ -103,7 +110,9 @@ public:
     , mDelaySoFar(STREAM_TIME_MAX)
     , mSampleRate(aSampleRate)
     , mLatency(0.0)
+    , mBufferingTargetBlocks(1)
     , mDroppingBuffers(false)
+    , mBuffering(false)
   {
   }
 
@@ -183,7 +192,9 @@ public:
 
     {
       MutexAutoLock lock(mOutputQueue.Lock());
-      if (mOutputQueue.ReadyToConsume() > 0) {
+      size_t ready = mOutputQueue.ReadyToConsume();
+      if (ready > 0 && (!mBuffering || ready >= mBufferingTargetBlocks)) {
+        mBuffering = false;
         if (mDelaySoFar == STREAM_TIME_MAX) {
           mDelaySoFar = 0;
         }
@@ -192,6 +203,16 @@ public:
         // If we're out of buffers to consume, just output silence
         buffer.SetNull(WEBAUDIO_BLOCK_SIZE);
         if (mDelaySoFar != STREAM_TIME_MAX) {
+          if (!mBuffering && ready == 0) {
+            // We underran after having started playback. Rather than limping
+            // along one block at a time and glitching whenever the main
+            // thread is a little late, hold off until the queue has refilled,
+            // and double the amount of buffering we require each time this
+            // happens.
+            mBuffering = true;
+            mBufferingTargetBlocks =
+              std::min(mBufferingTargetBlocks * 2, MAX_BUFFERING_BLOCKS);
+          }
           // Remember the delay that we just hit
           mDelaySoFar += WEBAUDIO_BLOCK_SIZE;
         }
@@ -201,6 +222,14 @@ public:
     return buffer;
   }
 
+  // graph thread
+  void NotifyProcessingOverrun()
+  {
+    MOZ_ASSERT(!NS_IsMainThread());
+    mBufferingTargetBlocks =
+      std::min(mBufferingTargetBlocks * 2, MAX_BUFFERING_BLOCKS);
+  }
+
   StreamTime DelaySoFar() const
   {
     MOZ_ASSERT(!NS_IsMainThread());
@@ -212,6 +241,8 @@ public:
     MOZ_ASSERT(!NS_IsMainThread());
     mDelaySoFar = STREAM_TIME_MAX;
     mLatency = 0.0f;
+    mBufferingTargetBlocks = 1;
+    mBuffering = false;
     {
       MutexAutoLock lock(mOutputQueue.Lock());
       mOutputQueue.Clear();
@@ -230,11 +261,18 @@ private:
   // This is the latency caused by the buffering. If this grows too high, we
   // will drop buffers until it is acceptable.
   float mLatency;
+  // The number of blocks that must be queued before we resume consuming
+  // after an underrun. Doubled on each underrun, up to MAX_BUFFERING_BLOCKS.
+  // Graph thread only.
+  uint32_t mBufferingTargetBlocks;
   // This is the time at which we last produced a buffer, to detect if the main
   // thread has been blocked.
   TimeStamp mLastEventTime;
   // True if we should be dropping buffers.
   bool mDroppingBuffers;
+  // True while we are waiting for the queue to refill to
+  // mBufferingTargetBlocks after an underrun. Graph thread only.
+  bool mBuffering;
 };
 
 class ScriptProcessorNodeEngine : public AudioNodeEngine
@@ -317,6 +355,11 @@ public:
     }
   }
 
+  virtual void NotifyProcessingOverrun() MOZ_OVERRIDE
+  {
+    mSharedBuffers->NotifyProcessingOverrun();
+  }
+
   virtual size_t SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const MOZ_OVERRIDE
   {
     // Not owned:
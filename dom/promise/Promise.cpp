@@ -38,9 +38,30 @@ using namespace workers;
 NS_IMPL_ISUPPORTS0(PromiseNativeHandler)
 
 // This class processes the promise's callbacks with promise's result.
-class PromiseCallbackTask MOZ_FINAL : public nsRunnable
+// Settled tasks are recycled through the micro-task queue's free list, so
+// a reaction usually costs neither a heap allocation nor a new persistent
+// root registration.
+class PromiseCallbackTask MOZ_FINAL : public MicroTaskJob
 {
 public:
+  static already_AddRefed<PromiseCallbackTask>
+  Create(Promise* aPromise, PromiseCallback* aCallback,
+         const JS::Value& aValue)
+  {
+    MicroTaskJobQueue& queue =
+      CycleCollectedJSRuntime::Get()->GetPromiseMicroTaskQueue();
+    // Only PromiseCallbackTasks are ever put on this free list.
+    nsRefPtr<PromiseCallbackTask> task = dont_AddRef(
+      static_cast<PromiseCallbackTask*>(queue.TakeRecycledJob().take()));
+    if (task) {
+      task->Reinit(aPromise, aCallback, aValue);
+    } else {
+      task = new PromiseCallbackTask(aPromise, aCallback, aValue);
+    }
+    return task.forget();
+  }
+
+protected:
   PromiseCallbackTask(Promise* aPromise,
                       PromiseCallback* aCallback,
                       const JS::Value& aValue)
@@ -60,29 +81,52 @@ public:
     MOZ_COUNT_DTOR(PromiseCallbackTask);
   }
 
-protected:
-  NS_IMETHOD
+  virtual void
   Run() MOZ_OVERRIDE
   {
     NS_ASSERT_OWNINGTHREAD(PromiseCallbackTask);
-    ThreadsafeAutoJSContext cx;
-    JS::Rooted<JSObject*> wrapper(cx, mPromise->GetWrapper());
-    MOZ_ASSERT(wrapper); // It was preserved!
-    JSAutoCompartment ac(cx, wrapper);
-
-    JS::Rooted<JS::Value> value(cx, mValue);
-    if (!MaybeWrapValue(cx, &value)) {
-      NS_WARNING("Failed to wrap value into the right compartment.");
-      JS_ClearPendingException(cx);
-      return NS_OK;
+    {
+      ThreadsafeAutoJSContext cx;
+      JS::Rooted<JSObject*> wrapper(cx, mPromise->GetWrapper());
+      MOZ_ASSERT(wrapper); // It was preserved!
+      JSAutoCompartment ac(cx, wrapper);
+
+      JS::Rooted<JS::Value> value(cx, mValue);
+      if (!MaybeWrapValue(cx, &value)) {
+        NS_WARNING("Failed to wrap value into the right compartment.");
+        JS_ClearPendingException(cx);
+      } else {
+        mCallback->Call(cx, value);
+      }
     }
+    Recycle();
+  }
 
-    mCallback->Call(cx, value);
+private:
+  void
+  Reinit(Promise* aPromise, PromiseCallback* aCallback,
+         const JS::Value& aValue)
+  {
+    NS_ASSERT_OWNINGTHREAD(PromiseCallbackTask);
+    MOZ_ASSERT(aPromise);
+    MOZ_ASSERT(aCallback);
+    MOZ_ASSERT(!mPromise && !mCallback);
+    mPromise = aPromise;
+    mCallback = aCallback;
+    mValue.set(aValue);
+  }
 
-    return NS_OK;
+  // Drops the reaction references and parks this task on the free list.
+  void
+  Recycle()
+  {
+    mPromise = nullptr;
+    mCallback = nullptr;
+    mValue.set(JS::UndefinedValue());
+    CycleCollectedJSRuntime::Get()->GetPromiseMicroTaskQueue().
+      RecycleJob(this);
   }
 
-private:
   nsRefPtr<Promise> mPromise;
   nsRefPtr<PromiseCallback> mCallback;
   JS::PersistentRooted<JS::Value> mValue;
@@ -150,9 +194,11 @@ GetPromise(JSContext* aCx, JS::Handle<JSObject*> aFunc)
 }
 };
 
-// Main thread runnable to resolve thenables.
+// Micro-task job to resolve thenables.
 // Equivalent to the specification's ResolvePromiseViaThenableTask.
-class ThenableResolverTask MOZ_FINAL : public nsRunnable
+// Thenable resolution is rare compared to plain reactions, so these jobs
+// are not recycled.
+class ThenableResolverTask MOZ_FINAL : public MicroTaskJob
 {
 public:
   ThenableResolverTask(Promise* aPromise,
@@ -174,7 +220,7 @@ public:
   }
 
 protected:
-  NS_IMETHOD
+  virtual void
   Run() MOZ_OVERRIDE
   {
     NS_ASSERT_OWNINGTHREAD(ThenableResolverTask);
@@ -188,14 +234,14 @@ protected:
 
     if (!resolveFunc) {
       mPromise->HandleException(cx);
-      return NS_OK;
+      return;
     }
 
     JS::Rooted<JSObject*> rejectFunc(cx,
       mPromise->CreateThenableFunction(cx, mPromise, PromiseCallback::Reject));
     if (!rejectFunc) {
       mPromise->HandleException(cx);
-      return NS_OK;
+      return;
     }
 
     LinkThenableCallables(cx, resolveFunc, rejectFunc);
@@ -229,8 +275,6 @@ protected:
       // the exception. FIXME(nsm): This should be reported to the error
       // console though, for debugging.
     }
-
-    return NS_OK;
   }
 
 private:
@@ -368,20 +412,17 @@ bool
 Promise::PerformMicroTaskCheckpoint()
 {
   CycleCollectedJSRuntime* runtime = CycleCollectedJSRuntime::Get();
-  nsTArray<nsRefPtr<nsIRunnable>>& microtaskQueue =
-    runtime->GetPromiseMicroTaskQueue();
+  MicroTaskJobQueue& microtaskQueue = runtime->GetPromiseMicroTaskQueue();
 
   if (microtaskQueue.IsEmpty()) {
     return false;
   }
 
   do {
-    nsRefPtr<nsIRunnable> runnable = microtaskQueue.ElementAt(0);
-    MOZ_ASSERT(runnable);
-
-    // This function can re-enter, so we remove the element before calling.
-    microtaskQueue.RemoveElementAt(0);
-    runnable->Run();
+    // This function can re-enter, so we pop the job before calling.
+    nsRefPtr<MicroTaskJob> job = microtaskQueue.Pop();
+    MOZ_ASSERT(job);
+    job->Run();
   } while (!microtaskQueue.IsEmpty());
 
   return true;
@@ -987,15 +1028,12 @@ private:
 };
 
 /* static */ void
-Promise::DispatchToMicroTask(nsIRunnable* aRunnable)
+Promise::DispatchToMicroTask(MicroTaskJob* aJob)
 {
-  MOZ_ASSERT(aRunnable);
+  MOZ_ASSERT(aJob);
 
   CycleCollectedJSRuntime* runtime = CycleCollectedJSRuntime::Get();
-  nsTArray<nsRefPtr<nsIRunnable>>& microtaskQueue =
-    runtime->GetPromiseMicroTaskQueue();
-
-  microtaskQueue.AppendElement(aRunnable);
+  runtime->GetPromiseMicroTaskQueue().Push(aJob);
 }
 
 void
@@ -1178,7 +1216,7 @@ Promise::EnqueueCallbackTasks()
 
   for (uint32_t i = 0; i < callbacks.Length(); ++i) {
     nsRefPtr<PromiseCallbackTask> task =
-      new PromiseCallbackTask(this, callbacks[i], mResult);
+      PromiseCallbackTask::Create(this, callbacks[i], mResult);
     DispatchToMicroTask(task);
   }
 }
@@ -25,6 +25,9 @@
 class nsIGlobalObject;
 
 namespace mozilla {
+
+class MicroTaskJob;
+
 namespace dom {
 
 class AnyCallback;
@@ -180,7 +183,7 @@ protected:
 
   // Queue an async microtask to current main or worker thread.
   static void
-  DispatchToMicroTask(nsIRunnable* aRunnable);
+  DispatchToMicroTask(MicroTaskJob* aJob);
 
   // Do JS-wrapping after Promise creation.
   void CreateWrapper(ErrorResult& aRv);
@@ -58,6 +58,7 @@ DOMStorageDBChild::ReleaseIPDLReference()
 DOMStorageDBChild::DOMStorageDBChild(DOMLocalStorageManager* aManager)
   : mManager(aManager)
   , mStatus(NS_OK)
+  , mJournalCheckpointPending(false)
   , mIPCOpen(false)
 {
 }
@@ -88,15 +89,128 @@ DOMStorageDBChild::Init()
 nsresult
 DOMStorageDBChild::Shutdown()
 {
-  // There is nothing to do here, IPC will release automatically and
-  // the actual thread running on the parent process will also stop
-  // automatically in profile-before-change topic observer.
+  // Hand over any tail of the journal; other than that there is nothing to
+  // do here, IPC will release automatically and the actual thread running
+  // on the parent process will also stop automatically in
+  // profile-before-change topic observer.
+  CheckpointJournal();
   return NS_OK;
 }
 
+namespace { // anon
+
+// Runs at the tail of the event loop spin that journaled the first
+// mutation, so a script looping over setItem produces a single IPC
+// message per spin.
+class JournalCheckpointRunnable : public nsRunnable
+{
+public:
+  explicit JournalCheckpointRunnable(DOMStorageDBChild* aChild)
+    : mChild(aChild)
+  {}
+
+private:
+  NS_IMETHOD Run()
+  {
+    mChild->CheckpointJournal();
+    return NS_OK;
+  }
+
+  nsRefPtr<DOMStorageDBChild> mChild;
+};
+
+} // anon
+
+void
+DOMStorageDBChild::ScheduleJournalCheckpoint()
+{
+  if (mJournalCheckpointPending) {
+    return;
+  }
+
+  mJournalCheckpointPending = true;
+  nsRefPtr<JournalCheckpointRunnable> r = new JournalCheckpointRunnable(this);
+  NS_DispatchToCurrentThread(r);
+}
+
+void
+DOMStorageDBChild::CheckpointJournal()
+{
+  mJournalCheckpointPending = false;
+
+  if (!mJournal.Length()) {
+    return;
+  }
+
+  if (mIPCOpen) {
+    SendAsyncJournalCheckpoint(mJournal);
+  }
+
+  mJournal.Clear();
+}
+
+void
+DOMStorageDBChild::JournalMutation(uint32_t aOp, const nsACString& aScope,
+                                   const nsAString& aKey,
+                                   const nsAString& aValue)
+{
+  typedef DOMStorageDBThread::DBOperation DBOperation;
+
+  if (aOp == DBOperation::opClear) {
+    // A clear makes all previously journaled mutations on the scope moot.
+    for (uint32_t i = mJournal.Length(); i > 0; --i) {
+      if (mJournal[i - 1].scope() == aScope &&
+          mJournal[i - 1].op() != DBOperation::opClear) {
+        mJournal.RemoveElementAt(i - 1);
+      }
+    }
+  } else {
+    // Coalesce with the pending mutation of the same scope and key, with
+    // the same type fixups the parent's DB thread does, so the journal
+    // holds at most one entry per key.
+    for (uint32_t i = 0; i < mJournal.Length(); ++i) {
+      StorageJournalEntry& entry = mJournal[i];
+      if (entry.scope() != aScope || entry.key() != aKey ||
+          entry.op() == DBOperation::opClear) {
+        continue;
+      }
+
+      if (entry.op() == DBOperation::opAddItem) {
+        if (aOp == DBOperation::opRemoveItem) {
+          // The key has never been sent to the database, just forget it.
+          mJournal.RemoveElementAt(i);
+          return;
+        }
+        // Keep opAddItem so the key still gets inserted.
+        entry.value() = aValue;
+        return;
+      }
+
+      if (aOp == DBOperation::opAddItem) {
+        // remove/set on a previously existing key must stay an update.
+        entry.op() = DBOperation::opUpdateItem;
+        entry.value() = aValue;
+        return;
+      }
+
+      entry.op() = aOp;
+      entry.value() = aValue;
+      return;
+    }
+  }
+
+  mJournal.AppendElement(StorageJournalEntry(aOp, nsCString(aScope),
+                                             nsString(aKey),
+                                             nsString(aValue)));
+  ScheduleJournalCheckpoint();
+}
+
 void
 DOMStorageDBChild::AsyncPreload(DOMStorageCacheBridge* aCache, bool aPriority)
 {
+  // The preload result must reflect mutations journaled so far.
+  CheckpointJournal();
+
   if (mIPCOpen) {
     // Adding ref to cache for the time of preload.  This ensures a reference to
     // to the cache and that all keys will load into this cache object.
@@ -129,6 +243,9 @@ DOMStorageDBChild::SyncPreload(DOMStorageCacheBridge* aCache, bool aForceSync)
     return;
   }
 
+  // The preload result must reflect mutations journaled so far.
+  CheckpointJournal();
+
   // There is no way to put the child process to a wait state to receive all
   // incoming async responses from the parent, hence we have to do a sync preload
   // instead.  We are smart though, we only demand keys that are left to load in
@@ -153,7 +270,8 @@ DOMStorageDBChild::AsyncAddItem(DOMStorageCacheBridge* aCache,
     return mStatus;
   }
 
-  SendAsyncAddItem(aCache->Scope(), nsString(aKey), nsString(aValue));
+  JournalMutation(DOMStorageDBThread::DBOperation::opAddItem,
+                  aCache->Scope(), aKey, aValue);
   ScopesHavingData().PutEntry(aCache->Scope());
   return NS_OK;
 }
@@ -167,7 +285,8 @@ DOMStorageDBChild::AsyncUpdateItem(DOMStorageCacheBridge* aCache,
     return mStatus;
   }
 
-  SendAsyncUpdateItem(aCache->Scope(), nsString(aKey), nsString(aValue));
+  JournalMutation(DOMStorageDBThread::DBOperation::opUpdateItem,
+                  aCache->Scope(), aKey, aValue);
   ScopesHavingData().PutEntry(aCache->Scope());
   return NS_OK;
 }
@@ -180,7 +299,8 @@ DOMStorageDBChild::AsyncRemoveItem(DOMStorageCacheBridge* aCache,
     return mStatus;
   }
 
-  SendAsyncRemoveItem(aCache->Scope(), nsString(aKey));
+  JournalMutation(DOMStorageDBThread::DBOperation::opRemoveItem,
+                  aCache->Scope(), aKey, EmptyString());
   return NS_OK;
 }
 
@@ -191,11 +311,20 @@ DOMStorageDBChild::AsyncClear(DOMStorageCacheBridge* aCache)
     return mStatus;
   }
 
-  SendAsyncClear(aCache->Scope());
+  JournalMutation(DOMStorageDBThread::DBOperation::opClear,
+                  aCache->Scope(), EmptyString(), EmptyString());
   ScopesHavingData().RemoveEntry(aCache->Scope());
   return NS_OK;
 }
 
+void
+DOMStorageDBChild::AsyncFlush()
+{
+  // Push journaled mutations over first, so the flush covers them.
+  CheckpointJournal();
+  SendAsyncFlush();
+}
+
 bool
 DOMStorageDBChild::ShouldPreloadScope(const nsACString& aScope)
 {
@@ -570,6 +699,47 @@ DOMStorageDBParent::RecvAsyncClear(const nsCString& aScope)
   return true;
 }
 
+bool
+DOMStorageDBParent::RecvAsyncJournalCheckpoint(
+    const InfallibleTArray<StorageJournalEntry>& aEntries)
+{
+  DOMStorageDBBridge* db = DOMStorageCache::StartDatabase();
+  if (!db) {
+    return false;
+  }
+
+  // One checkpoint of the child's write journal; hand the mutations to the
+  // DB thread in order, where they coalesce into the single transaction of
+  // the next flush.
+  nsresult rv = NS_OK;
+  for (uint32_t i = 0; i < aEntries.Length() && NS_SUCCEEDED(rv); ++i) {
+    const StorageJournalEntry& entry = aEntries[i];
+    switch (entry.op()) {
+    case DOMStorageDBThread::DBOperation::opAddItem:
+      rv = db->AsyncAddItem(NewCache(entry.scope()), entry.key(), entry.value());
+      break;
+    case DOMStorageDBThread::DBOperation::opUpdateItem:
+      rv = db->AsyncUpdateItem(NewCache(entry.scope()), entry.key(), entry.value());
+      break;
+    case DOMStorageDBThread::DBOperation::opRemoveItem:
+      rv = db->AsyncRemoveItem(NewCache(entry.scope()), entry.key());
+      break;
+    case DOMStorageDBThread::DBOperation::opClear:
+      rv = db->AsyncClear(NewCache(entry.scope()));
+      break;
+    default:
+      // The child never journals other operation types.
+      return false;
+    }
+  }
+
+  if (NS_FAILED(rv) && mIPCOpen) {
+    mozilla::unused << SendError(rv);
+  }
+
+  return true;
+}
+
 bool
 DOMStorageDBParent::RecvAsyncFlush()
 {
@@ -59,8 +59,12 @@ public:
   virtual void AsyncClearMatchingScope(const nsACString& aScope)
     { /* NO-OP on the child process */ }
 
-  virtual void AsyncFlush()
-    { SendAsyncFlush(); }
+  virtual void AsyncFlush();
+
+  // Sends the write-coalescing journal to the parent as one batch; called
+  // at the tail of the event loop spin that produced the first journaled
+  // mutation and before any operation whose result depends on them.
+  void CheckpointJournal();
 
   virtual bool ShouldPreloadScope(const nsACString& aScope);
   virtual void GetScopesHavingData(InfallibleTArray<nsCString>* aScopes)
@@ -81,6 +85,12 @@ private:
 
   nsTHashtable<nsCStringHashKey>& ScopesHavingData();
 
+  // Puts a mutation to the journal, coalescing it with a pending mutation
+  // of the same scope and key, and makes sure a checkpoint is scheduled.
+  void JournalMutation(uint32_t aOp, const nsACString& aScope,
+                       const nsAString& aKey, const nsAString& aValue);
+  void ScheduleJournalCheckpoint();
+
   ThreadSafeAutoRefCnt mRefCnt;
   NS_DECL_OWNINGTHREAD
 
@@ -97,6 +107,12 @@ private:
   // Status of the remote database
   nsresult mStatus;
 
+  // Mutations not yet sent to the parent, at most one entry per scope+key.
+  InfallibleTArray<StorageJournalEntry> mJournal;
+
+  // True while a checkpoint runnable is on its way through the event queue.
+  bool mJournalCheckpointPending;
+
   bool mIPCOpen;
 };
 
@@ -183,6 +199,7 @@ private:
   bool RecvAsyncUpdateItem(const nsCString& aScope, const nsString& aKey, const nsString& aValue);
   bool RecvAsyncRemoveItem(const nsCString& aScope, const nsString& aKey);
   bool RecvAsyncClear(const nsCString& aScope);
+  bool RecvAsyncJournalCheckpoint(const InfallibleTArray<StorageJournalEntry>& aEntries);
   bool RecvAsyncFlush();
 
   // DOMStorageObserverSink
@@ -6,6 +6,7 @@
 #include "mozilla/ArrayUtils.h"
 
 #include "SVGLength.h"
+#include "nsGkAtoms.h"
 #include "nsSVGElement.h"
 #include "mozilla/dom/SVGSVGElement.h"
 #include "nsTextFormatter.h"
@@ -221,7 +222,7 @@ GetUnitTypeForString(const nsAString& unitStr)
   if (unitStr.IsEmpty())
     return nsIDOMSVGLength::SVG_LENGTHTYPE_NUMBER;
 
-  nsIAtom* unitAtom = NS_GetStaticAtom(unitStr);
+  nsIAtom* unitAtom = nsGkAtoms::GetAtomByString(unitStr);
 
   if (unitAtom) {
     for (uint32_t i = 1 ; i < ArrayLength(unitMap) ; i++) {
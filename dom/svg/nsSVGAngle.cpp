@@ -8,6 +8,7 @@
 #include "nsSVGAngle.h"
 #include "mozilla/dom/SVGMarkerElement.h"
 #include "nsContentUtils.h" // NS_ENSURE_FINITE
+#include "nsGkAtoms.h"
 #include "nsSMILValue.h"
 #include "nsSVGAttrTearoffTable.h"
 #include "nsTextFormatter.h"
@@ -66,7 +67,7 @@ GetUnitTypeForString(const nsAString& unitStr)
   if (unitStr.IsEmpty()) 
     return SVG_ANGLETYPE_UNSPECIFIED;
                    
-  nsIAtom *unitAtom = NS_GetStaticAtom(unitStr);
+  nsIAtom *unitAtom = nsGkAtoms::GetAtomByString(unitStr);
 
   if (unitAtom) {
     for (uint32_t i = 0 ; i < ArrayLength(unitMap) ; i++) {
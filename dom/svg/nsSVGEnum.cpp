@@ -6,6 +6,7 @@
 #include "nsError.h"
 #include "nsSVGAttrTearoffTable.h"
 #include "nsSVGEnum.h"
+#include "nsGkAtoms.h"
 #include "nsIAtom.h"
 #include "nsSVGElement.h"
 #include "nsSMILValue.h"
@@ -140,7 +141,7 @@ nsSVGEnum::SMILEnum::ValueFromString(const nsAString& aStr,
                                      nsSMILValue& aValue,
                                      bool& aPreventCachingOfSandwich) const
 {
-  nsIAtom *valAtom = NS_GetStaticAtom(aStr);
+  nsIAtom *valAtom = nsGkAtoms::GetAtomByString(aStr);
   if (valAtom) {
     nsSVGEnumMapping *mapping = mVal->GetMapping(mSVGElement);
 
@@ -9,6 +9,7 @@
 #include "mozilla/dom/SVGAnimatedLength.h"
 #include "mozilla/dom/SVGSVGElement.h"
 #include "nsContentUtils.h" // NS_ENSURE_FINITE
+#include "nsGkAtoms.h"
 #include "nsIFrame.h"
 #include "nsSMILFloatType.h"
 #include "nsSMILValue.h"
@@ -70,7 +71,7 @@ GetUnitTypeForString(const nsAString& unitStr)
   if (unitStr.IsEmpty()) 
     return nsIDOMSVGLength::SVG_LENGTHTYPE_NUMBER;
                    
-  nsIAtom *unitAtom = NS_GetStaticAtom(unitStr);
+  nsIAtom *unitAtom = nsGkAtoms::GetAtomByString(unitStr);
   if (unitAtom) {
     for (uint32_t i = 0 ; i < ArrayLength(unitMap) ; i++) {
       if (unitMap[i] && *unitMap[i] == unitAtom) {
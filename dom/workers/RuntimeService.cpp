@@ -104,14 +104,17 @@ static_assert(MAX_WORKERS_PER_DOMAIN >= 1,
 // content workers.
 #define MAX_SCRIPT_RUN_TIME_SEC 10
 
-// The number of seconds that idle threads can hang around before being killed.
+// The default number of seconds that idle threads can hang around before
+// being killed.
 #define IDLE_THREAD_TIMEOUT_SEC 30
 
-// The maximum number of threads that can be idle at one time.
+// The default maximum number of threads that can be idle at one time.
 #define MAX_IDLE_THREADS 20
 
 #define PREF_WORKERS_PREFIX "dom.workers."
 #define PREF_WORKERS_MAX_PER_DOMAIN PREF_WORKERS_PREFIX "maxPerDomain"
+#define PREF_WORKERS_IDLE_TIMEOUT PREF_WORKERS_PREFIX "idleThreadTimeoutSecs"
+#define PREF_WORKERS_MAX_IDLE PREF_WORKERS_PREFIX "maxIdleThreads"
 
 #define PREF_MAX_SCRIPT_RUN_TIME_CONTENT "dom.max_script_run_time"
 #define PREF_MAX_SCRIPT_RUN_TIME_CHROME "dom.max_chrome_script_run_time"
@@ -168,6 +171,12 @@ const JS::ContextOptions kRequiredContextOptions =
 
 uint32_t gMaxWorkersPerDomain = MAX_WORKERS_PER_DOMAIN;
 
+// How long threads stay in the idle pool, and how many of them may.  Pages
+// that keep re-spawning short-lived workers can raise these to keep their
+// whole pool warm between bursts.
+uint32_t gIdleThreadTimeoutSec = IDLE_THREAD_TIMEOUT_SEC;
+uint32_t gMaxIdleThreads = MAX_IDLE_THREADS;
+
 // Does not hold an owning reference.
 RuntimeService* gRuntimeService = nullptr;
 
@@ -1818,6 +1827,14 @@ RuntimeService::Init()
                                              MAX_WORKERS_PER_DOMAIN);
   gMaxWorkersPerDomain = std::max(0, maxPerDomain);
 
+  int32_t idleTimeout = Preferences::GetInt(PREF_WORKERS_IDLE_TIMEOUT,
+                                            IDLE_THREAD_TIMEOUT_SEC);
+  gIdleThreadTimeoutSec = std::max(1, idleTimeout);
+
+  int32_t maxIdle = Preferences::GetInt(PREF_WORKERS_MAX_IDLE,
+                                        MAX_IDLE_THREADS);
+  gMaxIdleThreads = std::max(0, maxIdle);
+
   rv = InitOSFileConstants();
   if (NS_FAILED(rv)) {
     return rv;
@@ -2366,10 +2383,8 @@ RuntimeService::NoteIdleThread(WorkerThread* aThread)
   AssertIsOnMainThread();
   MOZ_ASSERT(aThread);
 
-  static TimeDuration timeout =
-    TimeDuration::FromSeconds(IDLE_THREAD_TIMEOUT_SEC);
-
-  TimeStamp expirationTime = TimeStamp::Now() + timeout;
+  TimeStamp expirationTime =
+    TimeStamp::Now() + TimeDuration::FromSeconds(gIdleThreadTimeoutSec);
 
   bool shutdown;
   if (mShuttingDown) {
@@ -2378,7 +2393,7 @@ RuntimeService::NoteIdleThread(WorkerThread* aThread)
   else {
     MutexAutoLock lock(mMutex);
 
-    if (mIdleThreadArray.Length() < MAX_IDLE_THREADS) {
+    if (mIdleThreadArray.Length() < gMaxIdleThreads) {
       IdleThreadInfo* info = mIdleThreadArray.AppendElement();
       info->mThread = aThread;
       info->mExpirationTime = expirationTime;
@@ -2398,7 +2413,7 @@ RuntimeService::NoteIdleThread(WorkerThread* aThread)
   // Schedule timer.
   MOZ_ALWAYS_TRUE(NS_SUCCEEDED(mIdleThreadTimer->InitWithFuncCallback(
                                                  ShutdownIdleThreads, nullptr,
-                                                 IDLE_THREAD_TIMEOUT_SEC * 1000,
+                                                 gIdleThreadTimeoutSec * 1000,
                                                  nsITimer::TYPE_ONE_SHOT)));
 }
 
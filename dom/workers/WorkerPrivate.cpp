@@ -909,6 +909,10 @@ private:
 
 class MessageEventRunnable MOZ_FINAL : public WorkerRunnable
 {
+  // Each runnable owns its serialized message outright. The buffer cannot
+  // be shared between several runnables targeting different workers: the
+  // clone data may carry transferables, and reading it is a one-shot
+  // operation that hands their contents to the reading context.
   JSAutoStructuredCloneBuffer mBuffer;
   nsTArray<nsCOMPtr<nsISupports> > mClonedObjects;
   uint64_t mMessagePortSerial;
@@ -51,6 +51,8 @@
 #include "nsError.h"
 #include "nsIDOMProcessingInstruction.h"
 #include "nsNodeUtils.h"
+#include "nsIPresShell.h"
+#include "nsPresContext.h"
 #include "nsIScriptGlobalObject.h"
 #include "nsIHTMLDocument.h"
 #include "mozAutoDocUpdate.h"
@@ -352,6 +354,31 @@ nsXMLContentSink::OnDocumentCreated(nsIDocument* aResultDocument)
   return NS_OK;
 }
 
+NS_IMETHODIMP
+nsXMLContentSink::OnTransformFlushed(nsIDocument* aResultDocument)
+{
+  NS_ENSURE_ARG(aResultDocument);
+
+  // The transform is still running, so we can't swap in the result document
+  // yet; mDocument stays the source document until OnTransformDone.  But we
+  // can kick off layout of the partial result so the content produced so far
+  // gets displayed.  Content appended by later flushes is notified on
+  // normally by the output handler.
+  nsIContent* rootElement = aResultDocument->GetRootElement();
+  if (!rootElement) {
+    return NS_OK;
+  }
+
+  aResultDocument->SetMayStartLayout(true);
+  nsCOMPtr<nsIPresShell> shell = aResultDocument->GetShell();
+  if (shell && !shell->DidInitialize()) {
+    nsRect r = shell->GetPresContext()->GetVisibleArea();
+    shell->Initialize(r.width, r.height);
+  }
+
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 nsXMLContentSink::OnTransformDone(nsresult aResult,
                                   nsIDocument* aResultDocument)
@@ -398,10 +425,16 @@ nsXMLContentSink::OnTransformDone(nsresult aResult,
   if (rootElement) {
     NS_ASSERTION(mDocument->IndexOf(rootElement) != -1,
                  "rootElement not in doc?");
-    mDocument->BeginUpdate(UPDATE_CONTENT_MODEL);
-    nsNodeUtils::ContentInserted(mDocument, rootElement,
-                                 mDocument->IndexOf(rootElement));
-    mDocument->EndUpdate(UPDATE_CONTENT_MODEL);
+    // If OnTransformFlushed already started layout of the partial result
+    // then the presshell has seen all this content; notifying again would
+    // double-construct frames for the root.
+    nsIPresShell* shell = mDocument->GetShell();
+    if (!shell || !shell->DidInitialize()) {
+      mDocument->BeginUpdate(UPDATE_CONTENT_MODEL);
+      nsNodeUtils::ContentInserted(mDocument, rootElement,
+                                   mDocument->IndexOf(rootElement));
+      mDocument->EndUpdate(UPDATE_CONTENT_MODEL);
+    }
   }
 
   // Start the layout process
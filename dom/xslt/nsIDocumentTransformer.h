@@ -13,17 +13,25 @@ class nsIURI;
 class nsString;
 
 #define NS_ITRANSFORMOBSERVER_IID \
-{ 0x04b2d17c, 0xe98d, 0x45f5, \
-  { 0x9a, 0x67, 0xb7, 0x01, 0x19, 0x59, 0x7d, 0xe7 } }
+{ 0x0aa05fd1, 0x8d27, 0x448b, \
+  { 0x97, 0x13, 0x52, 0x1a, 0xa0, 0x7e, 0x1e, 0x34 } }
 
 class nsITransformObserver : public nsISupports
 {
-public: 
+public:
 
   NS_DECLARE_STATIC_IID_ACCESSOR(NS_ITRANSFORMOBSERVER_IID)
 
   NS_IMETHOD OnDocumentCreated(nsIDocument *aResultDocument) = 0;
 
+  /**
+   * Called when an incrementally executed transform has appended more
+   * content to the result document.  May be called any number of times
+   * between OnDocumentCreated and OnTransformDone; the observer may use
+   * it to display the partial result.
+   */
+  NS_IMETHOD OnTransformFlushed(nsIDocument *aResultDocument) = 0;
+
   NS_IMETHOD OnTransformDone(nsresult aResult,
                              nsIDocument *aResultDocument) = 0;
 
@@ -37,6 +37,7 @@
 #include "nsIXPConnect.h"
 #include "mozilla/dom/DocumentFragment.h"
 #include "mozilla/dom/XSLTProcessorBinding.h"
+#include "mozilla/Preferences.h"
 
 using namespace mozilla::dom;
 
@@ -80,6 +81,29 @@ private:
     nsCOMPtr<nsIDOMDocumentFragment> mFragment;
 };
 
+/**
+ * State of a display transform that is executed in slices.  Keeps the
+ * execution state, its output handler factory and the source node alive
+ * between the events that each run a slice of the transform (see
+ * txMozillaXSLTProcessor::StepIncrementalTransform).
+ */
+class txIncrementalTransform
+{
+public:
+    txIncrementalTransform(txStylesheet* aStylesheet, bool aDisableLoads,
+                           nsIDOMDocument* aSourceDocument,
+                           nsITransformObserver* aObserver)
+        : mEs(aStylesheet, aDisableLoads),
+          mHandlerFactory(&mEs, aSourceDocument, aObserver, false)
+    {
+        mEs.mOutputHandlerFactory = &mHandlerFactory;
+    }
+
+    nsAutoPtr<txXPathNode> mSourceNode;
+    txExecutionState mEs;
+    txToDocHandlerFactory mHandlerFactory;
+};
+
 nsresult
 txToDocHandlerFactory::createHandlerWith(txOutputFormat* aFormat,
                                          txAXMLEventHandler** aHandler)
@@ -556,7 +580,20 @@ public:
 
   NS_IMETHOD Run()
   {
-    mProcessor->TransformToDoc(nullptr, false);
+    bool done = true;
+    if (mProcessor->HasPendingIncrementalTransform()) {
+      mProcessor->StepIncrementalTransform(&done);
+    }
+    else {
+      mProcessor->TransformToDoc(nullptr, false);
+      done = !mProcessor->HasPendingIncrementalTransform();
+    }
+    if (!done) {
+      // Return to the event loop so the partial result can display, then
+      // run the next slice.  Re-dispatching this same event keeps onload
+      // blocked until the destructor runs after the last slice.
+      NS_DispatchToCurrentThread(this);
+    }
     return NS_OK;
   }
 };
@@ -664,6 +701,32 @@ txMozillaXSLTProcessor::TransformToDoc(nsIDOMDocument **aResult,
         sourceDOMDocument = do_QueryInterface(mSource);
     }
 
+    if (!aResult && mObserver &&
+        mozilla::Preferences::GetBool("dom.xslt.incremental", false)) {
+        // Display transform: execute in slices so the first result content
+        // can display while the rest of the transform is still running.
+        mIncrementalTransform =
+            new txIncrementalTransform(mStylesheet, IsLoadDisabled(),
+                                       sourceDOMDocument, mObserver);
+        mIncrementalTransform->mSourceNode = sourceNode;
+
+        nsresult rv =
+            mIncrementalTransform->mEs.init(*mIncrementalTransform->mSourceNode,
+                                            &mVariables);
+        if (NS_FAILED(rv)) {
+            mIncrementalTransform->mEs.end(rv);
+            mIncrementalTransform = nullptr;
+
+            // XXX set up context information, bug 204655
+            reportError(rv, nullptr, nullptr);
+
+            return rv;
+        }
+
+        bool done;
+        return StepIncrementalTransform(&done);
+    }
+
     txExecutionState es(mStylesheet, IsLoadDisabled());
 
     // XXX Need to add error observers
@@ -704,6 +767,53 @@ txMozillaXSLTProcessor::TransformToDoc(nsIDOMDocument **aResult,
     return rv;
 }
 
+nsresult
+txMozillaXSLTProcessor::StepIncrementalTransform(bool* aDone)
+{
+    NS_ASSERTION(mIncrementalTransform, "no incremental transform pending");
+
+    // The number of instructions to execute before returning to the event
+    // loop.  Large enough that the per-slice overhead is in the noise, small
+    // enough that a slice doesn't block the main thread noticeably.
+    const uint32_t kStepsPerSlice = 65536;
+
+    txExecutionState& es = mIncrementalTransform->mEs;
+    nsresult rv = txXSLTProcessor::execute(es, kStepsPerSlice, aDone);
+    if (NS_SUCCEEDED(rv) && !*aDone) {
+        // Tell the observer about the content produced so far; the next
+        // slice runs from the event our caller re-dispatches.
+        txAOutputXMLEventHandler* handler =
+            es.mOutputHandler ? es.mOutputHandler->getAsOutputXMLEventHandler()
+                              : nullptr;
+        if (handler) {
+            nsCOMPtr<nsIDOMDocument> resultDOMDocument;
+            handler->getOutputDocument(getter_AddRefs(resultDOMDocument));
+            nsCOMPtr<nsIDocument> resultDocument =
+                do_QueryInterface(resultDOMDocument);
+            if (resultDocument) {
+                mObserver->OnTransformFlushed(resultDocument);
+            }
+        }
+
+        return NS_OK;
+    }
+
+    nsresult endRv = es.end(rv);
+    if (NS_SUCCEEDED(rv)) {
+        rv = endRv;
+    }
+
+    mIncrementalTransform = nullptr;
+    *aDone = true;
+
+    if (NS_FAILED(rv)) {
+        // XXX set up context information, bug 204655
+        reportError(rv, nullptr, nullptr);
+    }
+
+    return rv;
+}
+
 NS_IMETHODIMP
 txMozillaXSLTProcessor::TransformToFragment(nsIDOMNode *aSource,
                                             nsIDOMDocument *aOutput,
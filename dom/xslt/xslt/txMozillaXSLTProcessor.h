@@ -26,6 +26,7 @@ class nsIXMLContentSink;
 class txStylesheet;
 class txResultRecycler;
 class txIGlobalParameter;
+class txIncrementalTransform;
 
 namespace mozilla {
 namespace dom {
@@ -153,6 +154,18 @@ public:
         return (mFlags & DISABLE_ALL_LOADS) != 0;
     }
 
+    /**
+     * Runs one slice of an incrementally executed display transform and
+     * notifies the observer so the partial result can be shown.  Sets aDone
+     * once the transform has finished (successfully or not).
+     */
+    nsresult StepIncrementalTransform(bool* aDone);
+
+    bool HasPendingIncrementalTransform()
+    {
+        return !!mIncrementalTransform;
+    }
+
     static nsresult Startup();
     static void Shutdown();
 
@@ -182,6 +195,11 @@ private:
     txNamespaceMap mParamNamespaceMap;
     nsRefPtr<txResultRecycler> mRecycler;
 
+    // Set while a display transform is being executed in slices; holds the
+    // execution state that is kept alive between the events running the
+    // slices.
+    nsAutoPtr<txIncrementalTransform> mIncrementalTransform;
+
     uint32_t mFlags;
 };
 
@@ -12,6 +12,7 @@
 #define kTXNameSpaceURI "http://www.mozilla.org/TransforMiix"
 #define kTXWrapper "transformiix:result"
 
+class txAOutputXMLEventHandler;
 class txOutputFormat;
 class nsIDOMDocument;
 
@@ -25,6 +26,15 @@ class txAXMLEventHandler
 public:
     virtual ~txAXMLEventHandler() {}
 
+    /**
+     * Returns this handler as a txAOutputXMLEventHandler if it is one,
+     * nullptr otherwise (for buffering handlers).
+     */
+    virtual txAOutputXMLEventHandler* getAsOutputXMLEventHandler()
+    {
+        return nullptr;
+    }
+
     /**
      * Signals to receive the start of an attribute.
      *
@@ -144,6 +154,11 @@ public:
 class txAOutputXMLEventHandler : public txAXMLEventHandler
 {
 public:
+    virtual txAOutputXMLEventHandler* getAsOutputXMLEventHandler()
+    {
+        return this;
+    }
+
     /**
      * Gets the Mozilla output document
      *
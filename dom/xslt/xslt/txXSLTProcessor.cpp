@@ -52,3 +52,24 @@ txXSLTProcessor::execute(txExecutionState& aEs)
 
     return NS_OK;
 }
+
+/* static */
+nsresult
+txXSLTProcessor::execute(txExecutionState& aEs, uint32_t aMaxSteps,
+                         bool* aDone)
+{
+    nsresult rv = NS_OK;
+    txInstruction* instr;
+    for (uint32_t step = 0; step < aMaxSteps; ++step) {
+        instr = aEs.getNextInstruction();
+        if (!instr) {
+            *aDone = true;
+            return NS_OK;
+        }
+        rv = instr->execute(aEs);
+        NS_ENSURE_SUCCESS(rv, rv);
+    }
+
+    *aDone = false;
+    return NS_OK;
+}
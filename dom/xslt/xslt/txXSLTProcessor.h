@@ -21,8 +21,13 @@ public:
 
     static nsresult execute(txExecutionState& aEs);
 
-    // once we want to have interuption we should probably have functions for
-    // running X number of steps or running until a condition is true.
+    /**
+     * Executes at most aMaxSteps instructions of the transform. Sets aDone
+     * to true once there are no instructions left; until then the caller is
+     * expected to call this again with the same execution state.
+     */
+    static nsresult execute(txExecutionState& aEs, uint32_t aMaxSteps,
+                            bool* aDone);
 };
 
 #endif
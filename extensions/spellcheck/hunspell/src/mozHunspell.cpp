@@ -100,6 +100,18 @@ NS_IMPL_CYCLE_COLLECTION(mozHunspell,
 
 template<> mozilla::Atomic<size_t> mozilla::CountingAllocatorBase<HunspellAllocator>::sAmount(0);
 
+// Upper bound on the number of expanded dictionaries kept alive in
+// mHunspellCache at the same time.
+static const uint32_t kMaxCachedDictionaries = 4;
+
+static PLDHashOperator
+RemoveUnusedDictionaryEntry(const nsACString& aKey, nsAutoPtr<Hunspell>& aValue,
+                            void* aActiveHunspell)
+{
+  return aValue.get() == static_cast<Hunspell*>(aActiveHunspell)
+    ? PL_DHASH_NEXT : PL_DHASH_REMOVE;
+}
+
 mozHunspell::mozHunspell()
   : mHunspell(nullptr)
 {
@@ -121,6 +133,7 @@ mozHunspell::Init()
   if (obs) {
     obs->AddObserver(this, "profile-do-change", true);
     obs->AddObserver(this, "profile-after-change", true);
+    obs->AddObserver(this, "memory-pressure", true);
   }
 
   mozilla::RegisterWeakMemoryReporter(this);
@@ -133,7 +146,7 @@ mozHunspell::~mozHunspell()
   mozilla::UnregisterWeakMemoryReporter(this);
 
   mPersonalDictionary = nullptr;
-  delete mHunspell;
+  // mHunspell is owned by mHunspellCache.
 }
 
 /* attribute wstring dictionary; */
@@ -153,7 +166,7 @@ NS_IMETHODIMP mozHunspell::SetDictionary(const char16_t *aDictionary)
   NS_ENSURE_ARG_POINTER(aDictionary);
 
   if (nsDependentString(aDictionary).IsEmpty()) {
-    delete mHunspell;
+    // Keep the instance cached, the user is likely to come back to it.
     mHunspell = nullptr;
     mDictionary.Truncate();
     mAffixFileName.Truncate();
@@ -195,17 +208,28 @@ NS_IMETHODIMP mozHunspell::SetDictionary(const char16_t *aDictionary)
   dictFileName.SetLength(dotPos);
   dictFileName.AppendLiteral(".dic");
 
-  // SetDictionary can be called multiple times, so we might have a
-  // valid mHunspell instance which needs cleaned up.
-  delete mHunspell;
+  // SetDictionary can be called multiple times; instances stay in
+  // mHunspellCache so that coming back to a language doesn't parse and
+  // expand the whole dictionary again.
+  Hunspell* hunspell = mHunspellCache.Get(affFileName);
+  if (!hunspell) {
+    if (mHunspellCache.Count() >= kMaxCachedDictionaries) {
+      // Keep the cache bounded.  The current instance is about to be
+      // replaced, so it's fine to drop it along with the others.
+      mHunspellCache.Clear();
+    }
+
+    hunspell = new Hunspell(affFileName.get(),
+                            dictFileName.get());
+    if (!hunspell)
+      return NS_ERROR_OUT_OF_MEMORY;
+
+    mHunspellCache.Put(affFileName, hunspell);
+  }
 
   mDictionary = aDictionary;
   mAffixFileName = affFileName;
-
-  mHunspell = new Hunspell(affFileName.get(),
-                         dictFileName.get());
-  if (!mHunspell)
-    return NS_ERROR_OUT_OF_MEMORY;
+  mHunspell = hunspell;
 
   nsDependentCString label(mHunspell->get_dic_encoding());
   nsAutoCString encoding;
@@ -592,9 +616,17 @@ mozHunspell::Observe(nsISupports* aSubj, const char *aTopic,
                     const char16_t *aData)
 {
   NS_ASSERTION(!strcmp(aTopic, "profile-do-change")
-               || !strcmp(aTopic, "profile-after-change"),
+               || !strcmp(aTopic, "profile-after-change")
+               || !strcmp(aTopic, "memory-pressure"),
                "Unexpected observer topic");
 
+  if (!strcmp(aTopic, "memory-pressure")) {
+    // Drop every cached dictionary except the one currently in use;
+    // rebuilding that one would cost more than the memory it frees.
+    mHunspellCache.Enumerate(RemoveUnusedDictionaryEntry, mHunspell);
+    return NS_OK;
+  }
+
   LoadDictionaryList(false);
 
   return NS_OK;
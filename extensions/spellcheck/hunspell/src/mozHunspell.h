@@ -71,6 +71,7 @@
 #include "nsIUnicodeEncoder.h"
 #include "nsIUnicodeDecoder.h"
 #include "nsInterfaceHashtable.h"
+#include "nsClassHashtable.h"
 #include "nsWeakReference.h"
 #include "nsCycleCollectionParticipant.h"
 #include "mozHunspellAllocator.h"
@@ -125,6 +126,13 @@ protected:
   // dynamic dirs used to search for dictionaries
   nsCOMArray<nsIFile> mDynamicDirectories;
 
+  // Already loaded dictionaries, keyed by the path of their .aff file.
+  // Building a Hunspell instance parses and expands the whole dictionary,
+  // which is way too expensive to redo every time the user or a page
+  // switches languages back and forth.  Dropped on memory pressure.
+  nsClassHashtable<nsCStringHashKey, Hunspell> mHunspellCache;
+
+  // Weak pointer to the currently selected entry of mHunspellCache.
   Hunspell  *mHunspell;
 };
 
@@ -91,6 +91,16 @@ using namespace mozilla::dom;
 // since this just controls how often we check the current time.
 #define MISSPELLED_WORD_COUNT_PENALTY 4
 
+// The number of milliseconds we wait after an editor change before checking
+// it. Each further change restarts this timer and merges into the waiting
+// check, so a rapid run of keystrokes is checked once when typing pauses
+// instead of once per keystroke...
+#define INLINESPELL_COALESCE_TIMEOUT 100
+
+// ...but a waiting check is never postponed longer than this, so misspelled
+// words still get underlined during continuous typing.
+#define INLINESPELL_MAX_COALESCE_TIME 1000
+
 // These notifications are broadcast when spell check starts and ends.  STARTED
 // must always be followed by ENDED.
 #define INLINESPELL_STARTED_TOPIC "inlineSpellChecker-spellCheck-started"
@@ -554,6 +564,10 @@ mozInlineSpellChecker::mozInlineSpellChecker() :
 
 mozInlineSpellChecker::~mozInlineSpellChecker()
 {
+  // The coalescing timer holds a raw pointer to us.
+  if (mCoalesceTimer) {
+    mCoalesceTimer->Cancel();
+  }
 }
 
 NS_IMETHODIMP
@@ -618,6 +632,13 @@ nsresult mozInlineSpellChecker::Cleanup(bool aDestroyingFrames)
   // scheduled spell checks are discarded when they finish.
   mDisabledAsyncToken++;
 
+  // Drop any typing check that is still waiting on the coalescing timer.
+  // Its pending count is part of mNumPendingSpellChecks, cleared below.
+  if (mCoalesceTimer) {
+    mCoalesceTimer->Cancel();
+  }
+  mPendingTypingStatus = nullptr;
+
   if (mNumPendingUpdateCurrentDictionary > 0) {
     // Account for pending UpdateCurrentDictionary calls.
     ChangeNumPendingSpellChecks(-mNumPendingUpdateCurrentDictionary, editor);
@@ -886,7 +907,16 @@ mozInlineSpellChecker::SpellCheckAfterEditorChange(
                                   aStartNode, aStartOffset,
                                   aEndNode, aEndOffset);
   NS_ENSURE_SUCCESS(rv, rv);
-  rv = ScheduleSpellCheck(status);
+
+  // Ordinary changes are deferred briefly and merged so that rapid typing
+  // schedules a single check. Deletions need FinishInitOnEvent to compute
+  // the word to un-underline right away, so they are not coalesced.
+  if (status.mOp == mozInlineSpellStatus::eOpChange &&
+      !status.IsFullSpellCheck()) {
+    rv = CoalesceTypingCheck(status);
+  } else {
+    rv = ScheduleSpellCheck(status);
+  }
   NS_ENSURE_SUCCESS(rv, rv);
 
   // remember the current caret position after every change
@@ -1301,6 +1331,10 @@ mozInlineSpellChecker::ScheduleSpellCheck(const mozInlineSpellStatus& aStatus)
     return NS_OK;
   }
 
+  // If a typing check is waiting (see CoalesceTypingCheck), post it first so
+  // checks run in the order their events arrived.
+  FlushPendingTypingCheck();
+
   nsRefPtr<mozInlineSpellResume> resume =
     new mozInlineSpellResume(aStatus, mDisabledAsyncToken);
   NS_ENSURE_TRUE(resume, NS_ERROR_OUT_OF_MEMORY);
@@ -1317,6 +1351,134 @@ mozInlineSpellChecker::ScheduleSpellCheck(const mozInlineSpellStatus& aStatus)
   return rv;
 }
 
+// mozInlineSpellChecker::CoalesceTypingCheck
+//
+//    Called instead of ScheduleSpellCheck for ordinary editor changes. The
+//    status is parked in mPendingTypingStatus and a short one-shot timer is
+//    (re)armed; changes that arrive before it fires widen the parked
+//    status's range rather than scheduling additional checks. This keeps a
+//    rapid run of keystrokes in a large document down to a single re-scan
+//    when typing pauses.
+//
+//    The ranges involved are live nsRanges, so they stay correct as the DOM
+//    changes while the check waits. To keep feedback responsive during
+//    continuous typing, a waiting check is force-flushed once it has been
+//    deferred for INLINESPELL_MAX_COALESCE_TIME.
+
+nsresult
+mozInlineSpellChecker::CoalesceTypingCheck(const mozInlineSpellStatus& aStatus)
+{
+  NS_ASSERTION(aStatus.mOp == mozInlineSpellStatus::eOpChange && aStatus.mRange,
+               "Coalescing a non-change status?");
+
+  if (mFullSpellCheckScheduled) {
+    // Just ignore this; we're going to spell-check everything anyway
+    return NS_OK;
+  }
+
+  if (!mCoalesceTimer) {
+    mCoalesceTimer = do_CreateInstance("@mozilla.org/timer;1");
+    if (!mCoalesceTimer) {
+      // No timer, no coalescing; check the old way.
+      return ScheduleSpellCheck(aStatus);
+    }
+  }
+
+  if (mPendingTypingStatus) {
+    // Widen the parked range to cover this change as well. Each step below
+    // only moves a boundary outward, so the range can never collapse.
+    nsRange* pending = mPendingTypingStatus->mRange;
+    nsRange* incoming = aStatus.mRange;
+    nsresult rv = NS_OK;
+    if (nsContentUtils::ComparePoints(incoming->GetStartParent(),
+                                      incoming->StartOffset(),
+                                      pending->GetStartParent(),
+                                      pending->StartOffset()) < 0) {
+      rv = pending->SetStart(incoming->GetStartParent(),
+                             incoming->StartOffset());
+    }
+    if (NS_SUCCEEDED(rv) &&
+        nsContentUtils::ComparePoints(incoming->GetEndParent(),
+                                      incoming->EndOffset(),
+                                      pending->GetEndParent(),
+                                      pending->EndOffset()) > 0) {
+      rv = pending->SetEnd(incoming->GetEndParent(), incoming->EndOffset());
+    }
+    if (NS_FAILED(rv)) {
+      // One of the ranges is in a bad state and we can't merge. Flush what
+      // we have and schedule the new change on its own.
+      FlushPendingTypingCheck();
+      return ScheduleSpellCheck(aStatus);
+    }
+
+    // Track the latest caret position so the word being typed keeps its
+    // underline suppressed (mNoCheckRange is computed from the anchor).
+    mPendingTypingStatus->mAnchorRange = aStatus.mAnchorRange;
+
+    // The created-range optimization doesn't survive merging; drop it.
+    mPendingTypingStatus->mCreatedRange = nullptr;
+
+    mCoalesceTimer->Cancel();
+    if (TimeStamp::Now() - mCoalesceStart >
+        TimeDuration::FromMilliseconds(INLINESPELL_MAX_COALESCE_TIME)) {
+      // Don't let continuous typing starve the underlines.
+      FlushPendingTypingCheck();
+      return NS_OK;
+    }
+  } else {
+    mPendingTypingStatus = new mozInlineSpellStatus(aStatus);
+    mCoalesceStart = TimeStamp::Now();
+    // The waiting check counts as pending from now until its resume event
+    // runs (or Cleanup drops it), so observers see STARTED right away.
+    ChangeNumPendingSpellChecks(1);
+  }
+
+  nsresult rv = mCoalesceTimer->InitWithFuncCallback(CoalesceTimerCallback,
+                                                     this,
+                                                     INLINESPELL_COALESCE_TIMEOUT,
+                                                     nsITimer::TYPE_ONE_SHOT);
+  if (NS_FAILED(rv)) {
+    // Couldn't arm the timer; don't leave the check stranded.
+    FlushPendingTypingCheck();
+  }
+  return NS_OK;
+}
+
+// mozInlineSpellChecker::FlushPendingTypingCheck
+//
+//    Posts the waiting typing check, if any. Called when the coalescing
+//    timer fires and before any non-coalescible check is scheduled.
+
+void
+mozInlineSpellChecker::FlushPendingTypingCheck()
+{
+  if (mCoalesceTimer)
+    mCoalesceTimer->Cancel();
+  if (!mPendingTypingStatus)
+    return;
+
+  nsAutoPtr<mozInlineSpellStatus> status(mPendingTypingStatus.forget());
+
+  if (mFullSpellCheckScheduled) {
+    // Everything is going to be checked anyway.
+    ChangeNumPendingSpellChecks(-1);
+    return;
+  }
+
+  nsRefPtr<mozInlineSpellResume> resume =
+    new mozInlineSpellResume(*status, mDisabledAsyncToken);
+  if (NS_FAILED(resume->Post())) {
+    // The check was counted as pending when it was deferred.
+    ChangeNumPendingSpellChecks(-1);
+  }
+}
+
+void // static
+mozInlineSpellChecker::CoalesceTimerCallback(nsITimer* aTimer, void* aClosure)
+{
+  static_cast<mozInlineSpellChecker*>(aClosure)->FlushPendingTypingCheck();
+}
+
 // mozInlineSpellChecker::DoSpellCheckSelection
 //
 //    Called to re-check all misspelled words. We iterate over all ranges in
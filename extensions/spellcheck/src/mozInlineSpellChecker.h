@@ -18,6 +18,8 @@
 #include "nsWeakReference.h"
 #include "mozISpellI18NUtil.h"
 #include "nsCycleCollectionParticipant.h"
+#include "nsITimer.h"
+#include "mozilla/TimeStamp.h"
 
 // X.h defines KeyPress
 #ifdef KeyPress
@@ -181,6 +183,18 @@ private:
   // the whole document.
   bool mFullSpellCheckScheduled;
 
+  // A deferred change-driven spell check. While the user is typing, further
+  // changes widen the range held here instead of scheduling one check per
+  // keystroke. See CoalesceTypingCheck.
+  nsAutoPtr<mozInlineSpellStatus> mPendingTypingStatus;
+
+  // One-shot timer that flushes mPendingTypingStatus when typing pauses.
+  nsCOMPtr<nsITimer> mCoalesceTimer;
+
+  // When mPendingTypingStatus was created, so that continuous typing can not
+  // postpone checking forever.
+  mozilla::TimeStamp mCoalesceStart;
+
   // Maintains state during the asynchronous UpdateCurrentDictionary call.
   nsString mPreviousDictionary;
 
@@ -222,6 +236,12 @@ public:
   // another check in the future if the time threshold is reached
   nsresult ScheduleSpellCheck(const mozInlineSpellStatus& aStatus);
 
+  // defer a change-driven check briefly and merge it with further changes
+  // that arrive while it waits, so rapid typing schedules one check
+  nsresult CoalesceTypingCheck(const mozInlineSpellStatus& aStatus);
+  void FlushPendingTypingCheck();
+  static void CoalesceTimerCallback(nsITimer* aTimer, void* aClosure);
+
   nsresult DoSpellCheckSelection(mozInlineSpellWordUtil& aWordUtil,
                                  mozilla::dom::Selection* aSpellCheckSelection,
                                  mozInlineSpellStatus* aStatus);
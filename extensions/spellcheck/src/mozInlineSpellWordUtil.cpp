@@ -179,13 +179,22 @@ mozInlineSpellWordUtil::SetEnd(nsINode* aEndNode, int32_t aEndOffset)
 
   NS_ASSERTION(mRootNode, "Not initialized");
 
-  InvalidateWords();
-
   if (!IsTextNode(aEndNode)) {
     // End at the start of the first text node after aEndNode/aEndOffset.
     aEndNode = FindNextTextNode(aEndNode, aEndOffset, mRootNode);
     aEndOffset = 0;
   }
+
+  // If the soft text we already built covers the new end, keep the existing
+  // tokenization. BuildSoftText always extends to word boundaries, so the
+  // words around any position inside the soft text are complete; we'll just
+  // iterate a few extra words at the tail, which is harmless. This saves a
+  // re-scan of the surrounding text when the caller checks several nearby
+  // ranges in the same event.
+  if (!mSoftTextValid ||
+      MapDOMPositionToSoftTextOffset(NodeOffset(aEndNode, aEndOffset)) < 0) {
+    InvalidateWords();
+  }
   mSoftEnd = NodeOffset(aEndNode, aEndOffset);
   return NS_OK;
 }
@@ -193,8 +202,6 @@ mozInlineSpellWordUtil::SetEnd(nsINode* aEndNode, int32_t aEndOffset)
 nsresult
 mozInlineSpellWordUtil::SetPosition(nsINode* aNode, int32_t aOffset)
 {
-  InvalidateWords();
-
   if (!IsTextNode(aNode)) {
     // Start at the start of the first text node after aNode/aOffset.
     aNode = FindNextTextNode(aNode, aOffset, mRootNode);
@@ -202,11 +209,19 @@ mozInlineSpellWordUtil::SetPosition(nsINode* aNode, int32_t aOffset)
   }
   mSoftBegin = NodeOffset(aNode, aOffset);
 
-  EnsureWords();
-  
-  int32_t textOffset = MapDOMPositionToSoftTextOffset(mSoftBegin);
-  if (textOffset < 0)
-    return NS_OK;
+  // Reuse the existing tokenization when it already covers the new position;
+  // see the comment in SetEnd.
+  int32_t textOffset = -1;
+  if (mSoftTextValid)
+    textOffset = MapDOMPositionToSoftTextOffset(mSoftBegin);
+  if (textOffset < 0) {
+    InvalidateWords();
+    EnsureWords();
+
+    textOffset = MapDOMPositionToSoftTextOffset(mSoftBegin);
+    if (textOffset < 0)
+      return NS_OK;
+  }
   mNextWordIndex = FindRealWordContaining(textOffset, HINT_END, true);
   return NS_OK;
 }
@@ -236,14 +251,17 @@ mozInlineSpellWordUtil::GetRangeForWord(nsIDOMNode* aWordNode,
                                         int32_t aWordOffset,
                                         nsRange** aRange)
 {
-  // Set our soft end and start
+  // Set our soft end and start, unless the soft text we already built covers
+  // this position (then the word around it is already tokenized).
   nsCOMPtr<nsINode> wordNode = do_QueryInterface(aWordNode);
   NodeOffset pt = NodeOffset(wordNode, aWordOffset);
-  
-  InvalidateWords();
-  mSoftBegin = mSoftEnd = pt;
-  EnsureWords();
-  
+
+  if (!mSoftTextValid || MapDOMPositionToSoftTextOffset(pt) < 0) {
+    InvalidateWords();
+    mSoftBegin = mSoftEnd = pt;
+    EnsureWords();
+  }
+
   int32_t offset = MapDOMPositionToSoftTextOffset(pt);
   if (offset < 0)
     return MakeRange(pt, pt, aRange);
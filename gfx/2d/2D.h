@@ -1043,6 +1043,18 @@ protected:
 
 class DrawTargetCapture : public DrawTarget
 {
+public:
+  /**
+   * Returns true if no drawing commands have been recorded since the last
+   * call to PurgeDrawCommands().
+   */
+  virtual bool IsEmpty() const = 0;
+
+  /**
+   * Drops all recorded commands without executing them. The command storage
+   * is retained so that the capture can keep recording without reallocating.
+   */
+  virtual void PurgeDrawCommands() = 0;
 };
 
 class DrawEventRecorder : public RefCounted<DrawEventRecorder>
@@ -1143,6 +1155,45 @@ public:
     CreateWrappingDataSourceSurface(uint8_t *aData, int32_t aStride,
                                     const IntSize &aSize, SurfaceFormat aFormat);
 
+  /**
+   * Multiplies the color channels of 32 bit pixel data by its alpha channel.
+   * Source and destination must be B8G8R8A8 or R8G8B8A8; if the formats
+   * differ, the red and blue channels are swapped along the way. The
+   * conversion may run in place (same data pointer and stride). Uses SIMD
+   * where available. Returns false if the formats or strides are unsupported,
+   * in which case no data is written.
+   */
+  static bool PremultiplyData(uint8_t* aSrcData, int32_t aSrcStride,
+                              SurfaceFormat aSrcFormat,
+                              uint8_t* aDstData, int32_t aDstStride,
+                              SurfaceFormat aDstFormat,
+                              const IntSize &aSize);
+
+  /**
+   * The inverse of PremultiplyData; divides the color channels of
+   * premultiplied 32 bit pixel data by its alpha channel, using a
+   * precomputed reciprocal table. Same formats and in-place rules as
+   * PremultiplyData.
+   */
+  static bool UnpremultiplyData(uint8_t* aSrcData, int32_t aSrcStride,
+                                SurfaceFormat aSrcFormat,
+                                uint8_t* aDstData, int32_t aDstStride,
+                                SurfaceFormat aDstFormat,
+                                const IntSize &aSize);
+
+  /**
+   * Converts a batch of 32 bit pixel data between the B8G8R8A8/X8 and
+   * R8G8B8A8/X8 channel orders, or plainly copies it if source and
+   * destination have the same channel order. May run in place. Uses SIMD
+   * where available. Returns false if the formats or strides are
+   * unsupported, in which case no data is written.
+   */
+  static bool SwizzleData(uint8_t* aSrcData, int32_t aSrcStride,
+                          SurfaceFormat aSrcFormat,
+                          uint8_t* aDstData, int32_t aDstStride,
+                          SurfaceFormat aDstFormat,
+                          const IntSize &aSize);
+
   static TemporaryRef<DrawEventRecorder>
     CreateEventRecorderForFile(const char *aFilename);
 
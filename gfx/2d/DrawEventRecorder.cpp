@@ -50,5 +50,16 @@ DrawEventRecorderFile::Flush()
   mOutputFile.flush();
 }
 
+DrawEventRecorderMemory::DrawEventRecorderMemory()
+  : DrawEventRecorderPrivate(nullptr)
+{
+  mOutputStream = &mMemoryStream;
+}
+
+void
+DrawEventRecorderMemory::Flush()
+{
+}
+
 }
 }
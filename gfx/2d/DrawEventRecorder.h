@@ -10,6 +10,7 @@
 #include "RecordedEvent.h"
 #include <ostream>
 #include <fstream>
+#include <sstream>
 
 #if defined(_MSC_VER)
 #include <hash_set>
@@ -75,6 +76,25 @@ private:
   std::ofstream mOutputFile;
 };
 
+// Records into a growable in-memory stream.  This is the recorder to use
+// when a recording is played back inside the same process, for example by
+// the off-main-thread print pipeline.  Unlike DrawEventRecorderFile no
+// stream header is written, since producer and consumer are the same build;
+// the stream consists solely of recorded events.
+class DrawEventRecorderMemory : public DrawEventRecorderPrivate
+{
+public:
+  MOZ_DECLARE_REFCOUNTED_VIRTUAL_TYPENAME(DrawEventRecorderMemory)
+  DrawEventRecorderMemory();
+
+  // The recorded stream.  Only consume this once every draw target using
+  // this recorder has finished recording (and been destroyed).
+  std::stringstream mMemoryStream;
+
+private:
+  virtual void Flush();
+};
+
 }
 }
 
@@ -12,14 +12,7 @@ namespace gfx {
 
 DrawTargetCaptureImpl::~DrawTargetCaptureImpl()
 {
-  uint8_t* start = &mDrawCommandStorage.front();
-
-  uint8_t* current = start;
-
-  while (current < start + mDrawCommandStorage.size()) {
-    reinterpret_cast<DrawingCommand*>(current + sizeof(uint32_t))->~DrawingCommand();
-    current += *(uint32_t*)current;
-  }
+  PurgeDrawCommands();
 }
 
 bool
@@ -58,6 +51,19 @@ DrawTargetCaptureImpl::DrawSurface(SourceSurface *aSurface,
   AppendCommand(DrawSurfaceCommand)(aSurface, aDest, aSource, aSurfOptions, aOptions);
 }
 
+void
+DrawTargetCaptureImpl::DrawSurfaceWithShadow(SourceSurface *aSurface,
+                                             const Point &aDest,
+                                             const Color &aColor,
+                                             const Point &aOffset,
+                                             Float aSigma,
+                                             CompositionOp aOperator)
+{
+  aSurface->GuaranteePersistance();
+  AppendCommand(DrawSurfaceWithShadowCommand)(aSurface, aDest, aColor,
+                                              aOffset, aSigma, aOperator);
+}
+
 void
 DrawTargetCaptureImpl::DrawFilter(FilterNode *aNode,
                                   const Rect &aSourceRect,
@@ -178,11 +184,45 @@ void
 DrawTargetCaptureImpl::SetTransform(const Matrix& aTransform)
 {
   AppendCommand(SetTransformCommand)(aTransform);
+
+  // Have to update the transform for this DT
+  // because some code paths query the current transform
+  // to render specific things.
+  DrawTarget::SetTransform(aTransform);
+}
+
+bool
+DrawTargetCaptureImpl::IsEmpty() const
+{
+  return mDrawCommandStorage.empty();
+}
+
+void
+DrawTargetCaptureImpl::PurgeDrawCommands()
+{
+  if (mDrawCommandStorage.empty()) {
+    return;
+  }
+
+  uint8_t* start = &mDrawCommandStorage.front();
+
+  uint8_t* current = start;
+
+  while (current < start + mDrawCommandStorage.size()) {
+    reinterpret_cast<DrawingCommand*>(current + sizeof(uint32_t))->~DrawingCommand();
+    current += *(uint32_t*)current;
+  }
+
+  mDrawCommandStorage.clear();
 }
 
 void
 DrawTargetCaptureImpl::ReplayToDrawTarget(DrawTarget* aDT, const Matrix& aTransform)
 {
+  if (mDrawCommandStorage.empty()) {
+    return;
+  }
+
   uint8_t* start = &mDrawCommandStorage.front();
 
   uint8_t* current = start;
@@ -45,7 +45,7 @@ public:
                                      const Color &aColor,
                                      const Point &aOffset,
                                      Float aSigma,
-                                     CompositionOp aOperator) { /* Not implemented */ }
+                                     CompositionOp aOperator);
 
   virtual void ClearRect(const Rect &aRect);
   virtual void MaskSurface(const Pattern &aSource,
@@ -131,6 +131,9 @@ public:
     return mRefDT->CreateFilter(aType);
   }
 
+  virtual bool IsEmpty() const;
+  virtual void PurgeDrawCommands();
+
   void ReplayToDrawTarget(DrawTarget* aDT, const Matrix& aTransform);
 
 protected:
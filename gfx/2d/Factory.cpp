@@ -46,12 +46,15 @@
 #include "DrawTargetTiled.h"
 #include "DrawTargetRecording.h"
 
+#include "FilterProcessing.h"
 #include "SourceSurfaceRawData.h"
 
 #include "DrawEventRecorder.h"
 
 #include "Logging.h"
 
+#include <string.h>             // for memcpy
+
 #include "mozilla/CheckedInt.h"
 
 #if defined(DEBUG) || defined(PR_LOGGING)
@@ -832,6 +835,115 @@ Factory::CreateDataSourceSurfaceWithStride(const IntSize &aSize,
   return nullptr;
 }
 
+static bool
+IsSwizzleableFormat(SurfaceFormat aFormat)
+{
+  switch (aFormat) {
+  case SurfaceFormat::B8G8R8A8:
+  case SurfaceFormat::B8G8R8X8:
+  case SurfaceFormat::R8G8B8A8:
+  case SurfaceFormat::R8G8B8X8:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool
+IsBlueFirstFormat(SurfaceFormat aFormat)
+{
+  return aFormat == SurfaceFormat::B8G8R8A8 ||
+         aFormat == SurfaceFormat::B8G8R8X8;
+}
+
+static bool
+ConversionParamsAreSane(uint8_t* aSrcData, int32_t aSrcStride,
+                        uint8_t* aDstData, int32_t aDstStride,
+                        const IntSize &aSize)
+{
+  return aSrcData && aDstData &&
+         aSize.width >= 0 && aSize.height >= 0 &&
+         aSrcStride >= aSize.width * 4 &&
+         aDstStride >= aSize.width * 4;
+}
+
+bool
+Factory::PremultiplyData(uint8_t* aSrcData, int32_t aSrcStride,
+                         SurfaceFormat aSrcFormat,
+                         uint8_t* aDstData, int32_t aDstStride,
+                         SurfaceFormat aDstFormat,
+                         const IntSize &aSize)
+{
+  if ((aSrcFormat != SurfaceFormat::B8G8R8A8 &&
+       aSrcFormat != SurfaceFormat::R8G8B8A8) ||
+      (aDstFormat != SurfaceFormat::B8G8R8A8 &&
+       aDstFormat != SurfaceFormat::R8G8B8A8) ||
+      !ConversionParamsAreSane(aSrcData, aSrcStride, aDstData, aDstStride, aSize)) {
+    return false;
+  }
+
+  // Both supported formats keep the alpha channel in the last byte of a
+  // pixel, and multiplying the three color channels by it doesn't care
+  // about their order, so a single kernel serves both. If the channel
+  // orders differ, swap red and blue in place afterwards.
+  FilterProcessing::DoPremultiplicationCalculation(
+    aSize, aDstData, aDstStride, aSrcData, aSrcStride);
+  if (IsBlueFirstFormat(aSrcFormat) != IsBlueFirstFormat(aDstFormat)) {
+    FilterProcessing::SwapRAndBChannels(
+      aSize, aDstData, aDstStride, aDstData, aDstStride);
+  }
+  return true;
+}
+
+bool
+Factory::UnpremultiplyData(uint8_t* aSrcData, int32_t aSrcStride,
+                           SurfaceFormat aSrcFormat,
+                           uint8_t* aDstData, int32_t aDstStride,
+                           SurfaceFormat aDstFormat,
+                           const IntSize &aSize)
+{
+  if ((aSrcFormat != SurfaceFormat::B8G8R8A8 &&
+       aSrcFormat != SurfaceFormat::R8G8B8A8) ||
+      (aDstFormat != SurfaceFormat::B8G8R8A8 &&
+       aDstFormat != SurfaceFormat::R8G8B8A8) ||
+      !ConversionParamsAreSane(aSrcData, aSrcStride, aDstData, aDstStride, aSize)) {
+    return false;
+  }
+
+  // See PremultiplyData for why the channel order doesn't matter here.
+  FilterProcessing::DoUnpremultiplicationCalculation(
+    aSize, aDstData, aDstStride, aSrcData, aSrcStride);
+  if (IsBlueFirstFormat(aSrcFormat) != IsBlueFirstFormat(aDstFormat)) {
+    FilterProcessing::SwapRAndBChannels(
+      aSize, aDstData, aDstStride, aDstData, aDstStride);
+  }
+  return true;
+}
+
+bool
+Factory::SwizzleData(uint8_t* aSrcData, int32_t aSrcStride,
+                     SurfaceFormat aSrcFormat,
+                     uint8_t* aDstData, int32_t aDstStride,
+                     SurfaceFormat aDstFormat,
+                     const IntSize &aSize)
+{
+  if (!IsSwizzleableFormat(aSrcFormat) || !IsSwizzleableFormat(aDstFormat) ||
+      !ConversionParamsAreSane(aSrcData, aSrcStride, aDstData, aDstStride, aSize)) {
+    return false;
+  }
+
+  if (IsBlueFirstFormat(aSrcFormat) != IsBlueFirstFormat(aDstFormat)) {
+    FilterProcessing::SwapRAndBChannels(
+      aSize, aDstData, aDstStride, aSrcData, aSrcStride);
+  } else if (aSrcData != aDstData) {
+    for (int32_t y = 0; y < aSize.height; y++) {
+      memcpy(aDstData + y * aDstStride, aSrcData + y * aSrcStride,
+             aSize.width * 4);
+    }
+  }
+  return true;
+}
+
 TemporaryRef<DrawEventRecorder>
 Factory::CreateEventRecorderForFile(const char *aFilename)
 {
@@ -1342,11 +1342,40 @@ Unpremultiply(DataSourceSurface* aSurface)
   return target.forget();
 }
 
+FilterNodeColorMatrixSoftware*
+FilterNodeColorMatrixSoftware::InputColorMatrixNode()
+{
+  int32_t inputIndex = InputIndex(IN_COLOR_MATRIX_IN);
+  if ((uint32_t)inputIndex >= mInputFilters.size() ||
+      !mInputFilters[inputIndex]) {
+    return nullptr;
+  }
+  return mInputFilters[inputIndex]->AsColorMatrixNode();
+}
+
 TemporaryRef<DataSourceSurface>
 FilterNodeColorMatrixSoftware::Render(const IntRect& aRect)
 {
+  // Chains of color matrix nodes with the same alpha mode are fused into a
+  // single application of the composed matrix. This gives the same result
+  // as applying the matrices one after the other - matrix application is
+  // linear, and for premultiplied chains it additionally skips the lossy
+  // premultiply/unpremultiply round trip between the nodes - but saves an
+  // intermediate surface and a full pass over the pixels per fused node.
+  // Consecutive feColorMatrix primitives in SVG filter chains end up as
+  // adjacent nodes here.
+  Matrix5x4 matrix = mMatrix;
+  FilterNodeColorMatrixSoftware* node = this;
+  while (FilterNodeColorMatrixSoftware* inputNode = node->InputColorMatrixNode()) {
+    if (inputNode->mAlphaMode != mAlphaMode) {
+      break;
+    }
+    matrix = inputNode->mMatrix * matrix;
+    node = inputNode;
+  }
+
   RefPtr<DataSourceSurface> input =
-    GetInputDataSourceSurface(IN_COLOR_MATRIX_IN, aRect, NEED_COLOR_CHANNELS);
+    node->GetInputDataSourceSurface(IN_COLOR_MATRIX_IN, aRect, NEED_COLOR_CHANNELS);
   if (!input) {
     return nullptr;
   }
@@ -1356,7 +1385,7 @@ FilterNodeColorMatrixSoftware::Render(const IntRect& aRect)
   }
 
   RefPtr<DataSourceSurface> result =
-    FilterProcessing::ApplyColorMatrix(input, mMatrix);
+    FilterProcessing::ApplyColorMatrix(input, matrix);
 
   if (mAlphaMode == ALPHA_MODE_PREMULTIPLIED) {
     result = Premultiply(result);
@@ -16,6 +16,7 @@ class DataSourceSurface;
 class DrawTarget;
 struct DrawOptions;
 class FilterNodeSoftware;
+class FilterNodeColorMatrixSoftware;
 
 /**
  * Can be attached to FilterNodeSoftware instances using
@@ -54,6 +55,10 @@ public:
 
   virtual const char* GetName() { return "Unknown"; }
 
+  // Poor man's RTTI, used by the render-time fusion of adjacent color
+  // matrix nodes.
+  virtual FilterNodeColorMatrixSoftware* AsColorMatrixNode() { return nullptr; }
+
   virtual void AddInvalidationListener(FilterInvalidationListener* aListener);
   virtual void RemoveInvalidationListener(FilterInvalidationListener* aListener);
 
@@ -285,6 +290,7 @@ public:
   using FilterNodeSoftware::SetAttribute;
   virtual void SetAttribute(uint32_t aIndex, const Matrix5x4 &aMatrix) MOZ_OVERRIDE;
   virtual void SetAttribute(uint32_t aIndex, uint32_t aAlphaMode) MOZ_OVERRIDE;
+  virtual FilterNodeColorMatrixSoftware* AsColorMatrixNode() MOZ_OVERRIDE { return this; }
 
 protected:
   virtual TemporaryRef<DataSourceSurface> Render(const IntRect& aRect) MOZ_OVERRIDE;
@@ -293,6 +299,10 @@ protected:
   virtual void RequestFromInputsForRect(const IntRect &aRect) MOZ_OVERRIDE;
 
 private:
+  // Returns the input filter if it is another color matrix node, so that
+  // Render can fuse adjacent color matrix applications into one.
+  FilterNodeColorMatrixSoftware* InputColorMatrixNode();
+
   Matrix5x4 mMatrix;
   AlphaMode mAlphaMode;
 };
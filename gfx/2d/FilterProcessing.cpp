@@ -182,9 +182,23 @@ FilterProcessing::DoPremultiplicationCalculation(const IntSize& aSize,
                                                  uint8_t* aSourceData, int32_t aSourceStride)
 {
   if (Factory::HasSSE2()) {
-#ifdef USE_SSE2 
-    DoPremultiplicationCalculation_SSE2(
-      aSize, aTargetData, aTargetStride, aSourceData, aSourceStride);
+#ifdef USE_SSE2
+    // The SSE2 kernel processes four pixels per iteration and writes full
+    // 16 byte vectors, so hand it the multiple-of-four part of each row and
+    // finish the remaining columns with the scalar loop. This keeps all
+    // writes inside the rows of tightly packed buffers.
+    int32_t simdWidth = aSize.width & ~3;
+    if (simdWidth) {
+      DoPremultiplicationCalculation_SSE2(
+        IntSize(simdWidth, aSize.height),
+        aTargetData, aTargetStride, aSourceData, aSourceStride);
+    }
+    if (simdWidth != aSize.width) {
+      DoPremultiplicationCalculation_Scalar(
+        IntSize(aSize.width - simdWidth, aSize.height),
+        aTargetData + 4 * simdWidth, aTargetStride,
+        aSourceData + 4 * simdWidth, aSourceStride);
+    }
 #endif
   } else {
     DoPremultiplicationCalculation_Scalar(
@@ -198,9 +212,20 @@ FilterProcessing::DoUnpremultiplicationCalculation(const IntSize& aSize,
                                                    uint8_t* aSourceData, int32_t aSourceStride)
 {
   if (Factory::HasSSE2()) {
-#ifdef USE_SSE2 
-    DoUnpremultiplicationCalculation_SSE2(
-      aSize, aTargetData, aTargetStride, aSourceData, aSourceStride);
+#ifdef USE_SSE2
+    // See DoPremultiplicationCalculation for why rows are split up.
+    int32_t simdWidth = aSize.width & ~3;
+    if (simdWidth) {
+      DoUnpremultiplicationCalculation_SSE2(
+        IntSize(simdWidth, aSize.height),
+        aTargetData, aTargetStride, aSourceData, aSourceStride);
+    }
+    if (simdWidth != aSize.width) {
+      DoUnpremultiplicationCalculation_Scalar(
+        IntSize(aSize.width - simdWidth, aSize.height),
+        aTargetData + 4 * simdWidth, aTargetStride,
+        aSourceData + 4 * simdWidth, aSourceStride);
+    }
 #endif
   } else {
     DoUnpremultiplicationCalculation_Scalar(
@@ -208,6 +233,32 @@ FilterProcessing::DoUnpremultiplicationCalculation(const IntSize& aSize,
   }
 }
 
+void
+FilterProcessing::SwapRAndBChannels(const IntSize& aSize,
+                                    uint8_t* aTargetData, int32_t aTargetStride,
+                                    uint8_t* aSourceData, int32_t aSourceStride)
+{
+  if (Factory::HasSSE2()) {
+#ifdef USE_SSE2
+    // See DoPremultiplicationCalculation for why rows are split up.
+    int32_t simdWidth = aSize.width & ~3;
+    if (simdWidth) {
+      SwapRAndBChannels_SSE2(IntSize(simdWidth, aSize.height),
+                             aTargetData, aTargetStride,
+                             aSourceData, aSourceStride);
+    }
+    if (simdWidth != aSize.width) {
+      SwapRAndBChannels_Scalar(IntSize(aSize.width - simdWidth, aSize.height),
+                               aTargetData + 4 * simdWidth, aTargetStride,
+                               aSourceData + 4 * simdWidth, aSourceStride);
+    }
+#endif
+  } else {
+    SwapRAndBChannels_Scalar(
+      aSize, aTargetData, aTargetStride, aSourceData, aSourceStride);
+  }
+}
+
 TemporaryRef<DataSourceSurface>
 FilterProcessing::RenderTurbulence(const IntSize &aSize, const Point &aOffset, const Size &aBaseFrequency,
                                    int32_t aSeed, int aNumOctaves, TurbulenceType aType, bool aStitch, const Rect &aTileRect)
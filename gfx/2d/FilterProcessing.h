@@ -58,6 +58,12 @@ public:
   static void DoUnpremultiplicationCalculation(const IntSize& aSize,
                                                uint8_t* aTargetData, int32_t aTargetStride,
                                                uint8_t* aSourceData, int32_t aSourceStride);
+  // Swaps the first and third byte of every pixel, converting between
+  // B8G8R8A8-style and R8G8B8A8-style data. Operating in place
+  // (aTargetData == aSourceData) is supported.
+  static void SwapRAndBChannels(const IntSize& aSize,
+                                uint8_t* aTargetData, int32_t aTargetStride,
+                                uint8_t* aSourceData, int32_t aSourceStride);
   static TemporaryRef<DataSourceSurface>
     RenderTurbulence(const IntSize &aSize, const Point &aOffset, const Size &aBaseFrequency,
                      int32_t aSeed, int aNumOctaves, TurbulenceType aType, bool aStitch, const Rect &aTileRect);
@@ -86,6 +92,9 @@ protected:
   static void DoUnpremultiplicationCalculation_Scalar(const IntSize& aSize,
                                                uint8_t* aTargetData, int32_t aTargetStride,
                                                uint8_t* aSourceData, int32_t aSourceStride);
+  static void SwapRAndBChannels_Scalar(const IntSize& aSize,
+                                       uint8_t* aTargetData, int32_t aTargetStride,
+                                       uint8_t* aSourceData, int32_t aSourceStride);
   static TemporaryRef<DataSourceSurface>
     RenderTurbulence_Scalar(const IntSize &aSize, const Point &aOffset, const Size &aBaseFrequency,
                             int32_t aSeed, int aNumOctaves, TurbulenceType aType, bool aStitch, const Rect &aTileRect);
@@ -114,6 +123,9 @@ protected:
   static void DoUnpremultiplicationCalculation_SSE2(const IntSize& aSize,
                                                uint8_t* aTargetData, int32_t aTargetStride,
                                                uint8_t* aSourceData, int32_t aSourceStride);
+  static void SwapRAndBChannels_SSE2(const IntSize& aSize,
+                                     uint8_t* aTargetData, int32_t aTargetStride,
+                                     uint8_t* aSourceData, int32_t aSourceStride);
   static TemporaryRef<DataSourceSurface>
     RenderTurbulence_SSE2(const IntSize &aSize, const Point &aOffset, const Size &aBaseFrequency,
                           int32_t aSeed, int aNumOctaves, TurbulenceType aType, bool aStitch, const Rect &aTileRect);
@@ -95,6 +95,29 @@ FilterProcessing::DoUnpremultiplicationCalculation_SSE2(
   DoUnpremultiplicationCalculation_SIMD<__m128i,__m128i>(aSize, aTargetData, aTargetStride, aSourceData, aSourceStride);
 }
 
+void
+FilterProcessing::SwapRAndBChannels_SSE2(const IntSize& aSize,
+                                         uint8_t* aTargetData, int32_t aTargetStride,
+                                         uint8_t* aSourceData, int32_t aSourceStride)
+{
+  MOZ_ASSERT(aSize.width % 4 == 0,
+             "the caller needs to handle the trailing pixels of each row");
+
+  const __m128i redBlueMask = _mm_set1_epi32(0x00ff00ff);
+  for (int32_t y = 0; y < aSize.height; y++) {
+    for (int32_t x = 0; x < aSize.width; x += 4) {
+      const uint8_t* source = &aSourceData[y * aSourceStride + 4 * x];
+      uint8_t* target = &aTargetData[y * aTargetStride + 4 * x];
+      __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+      __m128i rb = _mm_and_si128(p, redBlueMask);
+      __m128i ag = _mm_andnot_si128(redBlueMask, p);
+      rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(target),
+                       _mm_or_si128(ag, rb));
+    }
+  }
+}
+
 TemporaryRef<DataSourceSurface>
 FilterProcessing::RenderTurbulence_SSE2(const IntSize &aSize, const Point &aOffset, const Size &aBaseFrequency,
                                         int32_t aSeed, int aNumOctaves, TurbulenceType aType, bool aStitch, const Rect &aTileRect)
@@ -226,6 +226,29 @@ FilterProcessing::DoUnpremultiplicationCalculation_Scalar(
   }
 }
 
+void
+FilterProcessing::SwapRAndBChannels_Scalar(const IntSize& aSize,
+                                           uint8_t* aTargetData, int32_t aTargetStride,
+                                           uint8_t* aSourceData, int32_t aSourceStride)
+{
+  for (int32_t y = 0; y < aSize.height; y++) {
+    for (int32_t x = 0; x < aSize.width; x++) {
+      int32_t inputIndex = y * aSourceStride + 4 * x;
+      int32_t targetIndex = y * aTargetStride + 4 * x;
+      // Read all four components before writing, so that operating in place
+      // works.
+      uint8_t c0 = aSourceData[inputIndex];
+      uint8_t c1 = aSourceData[inputIndex + 1];
+      uint8_t c2 = aSourceData[inputIndex + 2];
+      uint8_t c3 = aSourceData[inputIndex + 3];
+      aTargetData[targetIndex] = c2;
+      aTargetData[targetIndex + 1] = c1;
+      aTargetData[targetIndex + 2] = c0;
+      aTargetData[targetIndex + 3] = c3;
+    }
+  }
+}
+
 TemporaryRef<DataSourceSurface>
 FilterProcessing::RenderTurbulence_Scalar(const IntSize &aSize, const Point &aOffset, const Size &aBaseFrequency,
                                           int32_t aSeed, int aNumOctaves, TurbulenceType aType, bool aStitch, const Rect &aTileRect)
@@ -12,6 +12,7 @@
 #include "GLContext.h"
 #include "GLBlitHelper.h"
 #include "GLReadTexImageHelper.h"
+#include "GLUploadPBOPool.h"
 
 #include "gfxCrashReporterUtils.h"
 #include "gfxUtils.h"
@@ -81,6 +82,7 @@ static const char *sExtensionNames[] = {
     "GL_ARB_draw_instanced",
     "GL_ARB_framebuffer_object",
     "GL_ARB_framebuffer_sRGB",
+    "GL_ARB_get_program_binary",
     "GL_ARB_half_float_pixel",
     "GL_ARB_instanced_arrays",
     "GL_ARB_invalidate_subdata",
@@ -146,6 +148,7 @@ static const char *sExtensionNames[] = {
     "GL_OES_depth32",
     "GL_OES_depth_texture",
     "GL_OES_element_index_uint",
+    "GL_OES_get_program_binary",
     "GL_OES_packed_depth_stencil",
     "GL_OES_rgb8_rgba8",
     "GL_OES_standard_derivatives",
@@ -1386,6 +1389,41 @@ GLContext::InitWithPrefix(const char *prefix, bool trygl)
             }
         }
 
+        if (IsExtensionSupported(OES_get_program_binary) ||
+            IsExtensionSupported(ARB_get_program_binary))
+        {
+            SymLoadStruct extSymbols[] = {
+                { (PRFuncPtr*) &mSymbols.fGetProgramBinary, { "GetProgramBinary", "GetProgramBinaryOES", nullptr } },
+                { (PRFuncPtr*) &mSymbols.fProgramBinary,    { "ProgramBinary",    "ProgramBinaryOES",    nullptr } },
+                END_SYMBOLS
+            };
+
+            if (!LoadSymbols(&extSymbols[0], trygl, prefix)) {
+                NS_ERROR("GL supports program binaries without supplying its functions.");
+
+                MarkExtensionUnsupported(OES_get_program_binary);
+                MarkExtensionUnsupported(ARB_get_program_binary);
+                ClearSymbols(extSymbols);
+            }
+        }
+
+        if (IsExtensionSupported(ARB_get_program_binary)) {
+            // ARB_get_program_binary only guarantees a retrievable binary
+            // when PROGRAM_BINARY_RETRIEVABLE_HINT was set before linking;
+            // the OES version has no such function or requirement.
+            SymLoadStruct extSymbols[] = {
+                { (PRFuncPtr*) &mSymbols.fProgramParameteri, { "ProgramParameteri", "ProgramParameteriARB", nullptr } },
+                END_SYMBOLS
+            };
+
+            if (!LoadSymbols(&extSymbols[0], trygl, prefix)) {
+                NS_ERROR("GL supports ARB_get_program_binary without supplying ProgramParameteri.");
+
+                MarkExtensionUnsupported(ARB_get_program_binary);
+                ClearSymbols(extSymbols);
+            }
+        }
+
         if (IsExtensionSupported(NV_fence)) {
             SymLoadStruct extSymbols[] = {
                 { (PRFuncPtr*) &mSymbols.fGenFences,    { "GenFencesNV",    nullptr } },
@@ -2077,6 +2115,7 @@ GLContext::MarkDestroyed()
 
         mBlitHelper = nullptr;
         mReadTexImageHelper = nullptr;
+        mUploadPBOPool = nullptr;
 
         mTexGarbageBin->GLContextTeardown();
     } else {
@@ -2407,6 +2446,16 @@ GLContext::ReadTexImageHelper()
     return mReadTexImageHelper.get();
 }
 
+GLUploadPBOPool*
+GLContext::UploadPBOPool()
+{
+    if (!mUploadPBOPool) {
+        mUploadPBOPool = MakeUnique<GLUploadPBOPool>(this);
+    }
+
+    return mUploadPBOPool.get();
+}
+
 void
 GLContext::FlushIfHeavyGLCallsSinceLastFlush()
 {
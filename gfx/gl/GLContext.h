@@ -73,6 +73,7 @@ namespace mozilla {
         class GLBlitHelper;
         class GLBlitTextureImageHelper;
         class GLReadTexImageHelper;
+        class GLUploadPBOPool;
         struct SurfaceCaps;
     }
 
@@ -373,6 +374,7 @@ public:
         ARB_draw_instanced,
         ARB_framebuffer_object,
         ARB_framebuffer_sRGB,
+        ARB_get_program_binary,
         ARB_half_float_pixel,
         ARB_instanced_arrays,
         ARB_invalidate_subdata,
@@ -438,6 +440,7 @@ public:
         OES_depth32,
         OES_depth_texture,
         OES_element_index_uint,
+        OES_get_program_binary,
         OES_packed_depth_stencil,
         OES_rgb8_rgba8,
         OES_standard_derivatives,
@@ -1377,6 +1380,13 @@ public:
         AFTER_GL_CALL;
     }
 
+    void fGetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, GLvoid* binary) {
+        BEFORE_GL_CALL;
+        ASSERT_SYMBOL_PRESENT(fGetProgramBinary);
+        mSymbols.fGetProgramBinary(program, bufSize, length, binaryFormat, binary);
+        AFTER_GL_CALL;
+    }
+
     void fTexParameteri(GLenum target, GLenum pname, GLint param) {
         BEFORE_GL_CALL;
         mSymbols.fTexParameteri(target, pname, param);
@@ -1519,6 +1529,20 @@ public:
         AFTER_GL_CALL;
     }
 
+    void fProgramBinary(GLuint program, GLenum binaryFormat, const GLvoid* binary, GLsizei length) {
+        BEFORE_GL_CALL;
+        ASSERT_SYMBOL_PRESENT(fProgramBinary);
+        mSymbols.fProgramBinary(program, binaryFormat, binary, length);
+        AFTER_GL_CALL;
+    }
+
+    void fProgramParameteri(GLuint program, GLenum pname, GLint value) {
+        BEFORE_GL_CALL;
+        ASSERT_SYMBOL_PRESENT(fProgramParameteri);
+        mSymbols.fProgramParameteri(program, pname, value);
+        AFTER_GL_CALL;
+    }
+
     void fObjectLabel(GLenum identifier, GLuint name, GLsizei length, const GLchar* label) {
         BEFORE_GL_CALL;
         ASSERT_SYMBOL_PRESENT(fObjectLabel);
@@ -3416,11 +3440,13 @@ protected:
 
     UniquePtr<GLBlitHelper> mBlitHelper;
     UniquePtr<GLReadTexImageHelper> mReadTexImageHelper;
+    UniquePtr<GLUploadPBOPool> mUploadPBOPool;
 
 public:
     GLBlitHelper* BlitHelper();
     GLBlitTextureImageHelper* BlitTextureImageHelper();
     GLReadTexImageHelper* ReadTexImageHelper();
+    GLUploadPBOPool* UploadPBOPool();
 
     // Assumes shares are created by all sharing with the same global context.
     bool SharesWith(const GLContext* other) const {
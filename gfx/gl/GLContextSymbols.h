@@ -543,6 +543,14 @@ struct GLContextSymbols
     typedef void (GLAPIENTRY * PFNGLDRAWRANGEELEMENTS) (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const GLvoid* indices);
     PFNGLDRAWRANGEELEMENTS fDrawRangeElements;
 
+    // get_program_binary
+    typedef void (GLAPIENTRY * PFNGLGETPROGRAMBINARY) (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, GLvoid* binary);
+    PFNGLGETPROGRAMBINARY fGetProgramBinary;
+    typedef void (GLAPIENTRY * PFNGLPROGRAMBINARY) (GLuint program, GLenum binaryFormat, const GLvoid* binary, GLsizei length);
+    PFNGLPROGRAMBINARY fProgramBinary;
+    typedef void (GLAPIENTRY * PFNGLPROGRAMPARAMETERI) (GLuint program, GLenum pname, GLint value);
+    PFNGLPROGRAMPARAMETERI fProgramParameteri;
+
     // NV_fence
     typedef void (GLAPIENTRY * pfnGenFencesT) (GLsizei n, GLuint* fences);
     pfnGenFencesT fGenFences;
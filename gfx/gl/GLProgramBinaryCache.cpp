@@ -0,0 +1,291 @@
+/* -*- Mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; tab-width: 40; -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "GLProgramBinaryCache.h"
+
+#include "GLContext.h"
+#include "gfxPrefs.h"
+#include "mozilla/HashFunctions.h"
+#include "nsAppDirectoryServiceDefs.h"
+#include "nsCOMPtr.h"
+#include "nsDirectoryServiceUtils.h"
+#include "nsIFile.h"
+#include "nsPrintfCString.h"
+#include "nsString.h"
+#include "nsTArray.h"
+#include "nsThreadUtils.h"
+#include "prio.h"
+
+#include <string.h>
+
+namespace mozilla {
+namespace gl {
+
+// Resolved once on the main thread by InitDirectory() and read-only
+// afterwards, so the compositor thread can use it without locking.
+static nsCString* sCacheDirectory = nullptr;
+
+namespace {
+
+// On-disk layout: CacheEntryHeader, the driver ident string, then the raw
+// program binary.  Bump kCacheVersion whenever the layout changes; stale
+// entries are deleted on the first mismatching read.
+static const uint32_t kCacheMagic = 0x474c5042; // 'GLPB'
+static const uint32_t kCacheVersion = 1;
+
+// Program binaries are typically a few tens of KB; anything claiming to be
+// bigger than this is a corrupt entry.
+static const uint32_t kMaxBinaryLength = 16 * 1024 * 1024;
+
+struct CacheEntryHeader
+{
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint32_t mIdentLength;
+    uint32_t mVertexSourceLength;
+    uint32_t mFragmentSourceLength;
+    uint32_t mBinaryFormat;
+    uint32_t mBinaryLength;
+};
+
+void
+AppendGLString(GLContext* aGL, GLenum aName, nsACString& aOut)
+{
+    const GLubyte* str = aGL->fGetString(aName);
+    if (str) {
+        aOut.Append(reinterpret_cast<const char*>(str));
+    }
+    aOut.Append('\n');
+}
+
+// Binaries are opaque driver blobs, so any change to the driver, GPU or GL
+// version invalidates them; fold the identifying strings into the key.
+void
+GetDriverIdent(GLContext* aGL, nsACString& aOut)
+{
+    AppendGLString(aGL, LOCAL_GL_VENDOR, aOut);
+    AppendGLString(aGL, LOCAL_GL_RENDERER, aOut);
+    AppendGLString(aGL, LOCAL_GL_VERSION, aOut);
+}
+
+void
+GetEntryPath(const nsACString& aIdent,
+             const char* aVertexSource,
+             const char* aFragmentSource,
+             nsACString& aOut)
+{
+    uint32_t hash = HashString(PromiseFlatCString(aIdent).get());
+    hash = AddToHash(hash, HashString(aVertexSource));
+    hash = AddToHash(hash, HashString(aFragmentSource));
+
+    // Collisions only cost us a miss: the header's ident and source
+    // lengths are verified on load and the driver checks the blob itself.
+    aOut = nsPrintfCString("%s/%08x.bin", sCacheDirectory->get(), hash);
+}
+
+} // anonymous namespace
+
+/* static */ void
+GLProgramBinaryCache::InitDirectory()
+{
+    MOZ_ASSERT(NS_IsMainThread());
+
+    if (!gfxPrefs::GLProgramBinaryCacheEnabled() || sCacheDirectory) {
+        return;
+    }
+
+    nsCOMPtr<nsIFile> dir;
+    nsresult rv = NS_GetSpecialDirectory(NS_APP_USER_PROFILE_LOCAL_50_DIR,
+                                         getter_AddRefs(dir));
+    if (NS_FAILED(rv)) {
+        // No profile (e.g. a content process); leave the cache disabled.
+        return;
+    }
+
+    rv = dir->AppendNative(NS_LITERAL_CSTRING("shader-cache"));
+    if (NS_FAILED(rv)) {
+        return;
+    }
+
+    rv = dir->Create(nsIFile::DIRECTORY_TYPE, 0700);
+    if (NS_FAILED(rv) && rv != NS_ERROR_FILE_ALREADY_EXISTS) {
+        return;
+    }
+
+    nsAutoCString path;
+    rv = dir->GetNativePath(path);
+    if (NS_FAILED(rv)) {
+        return;
+    }
+
+    sCacheDirectory = new nsCString(path);
+}
+
+/* static */ bool
+GLProgramBinaryCache::CanCache(GLContext* aGL)
+{
+    if (!sCacheDirectory) {
+        return false;
+    }
+
+    if (!aGL->IsExtensionSupported(GLContext::OES_get_program_binary) &&
+        !aGL->IsExtensionSupported(GLContext::ARB_get_program_binary))
+    {
+        return false;
+    }
+
+    // Drivers may expose the extension while supporting no binary format.
+    GLint formats = 0;
+    aGL->fGetIntegerv(LOCAL_GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+/* static */ void
+GLProgramBinaryCache::SetRetrievableHint(GLContext* aGL, GLuint aProgram)
+{
+    if (sCacheDirectory &&
+        aGL->IsExtensionSupported(GLContext::ARB_get_program_binary))
+    {
+        aGL->fProgramParameteri(aProgram,
+                                LOCAL_GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                                LOCAL_GL_TRUE);
+    }
+}
+
+/* static */ bool
+GLProgramBinaryCache::LoadProgram(GLContext* aGL, GLuint aProgram,
+                                  const char* aVertexSource,
+                                  const char* aFragmentSource)
+{
+    if (!CanCache(aGL)) {
+        return false;
+    }
+
+    nsAutoCString ident;
+    GetDriverIdent(aGL, ident);
+
+    nsAutoCString path;
+    GetEntryPath(ident, aVertexSource, aFragmentSource, path);
+
+    PRFileDesc* fd = PR_Open(path.get(), PR_RDONLY, 0);
+    if (!fd) {
+        return false;
+    }
+
+    CacheEntryHeader header;
+    bool ok = PR_Read(fd, &header, sizeof(header)) == int32_t(sizeof(header)) &&
+              header.mMagic == kCacheMagic &&
+              header.mVersion == kCacheVersion &&
+              header.mIdentLength == ident.Length() &&
+              header.mVertexSourceLength == strlen(aVertexSource) &&
+              header.mFragmentSourceLength == strlen(aFragmentSource) &&
+              header.mBinaryLength > 0 &&
+              header.mBinaryLength <= kMaxBinaryLength;
+
+    if (ok) {
+        nsAutoCString storedIdent;
+        storedIdent.SetLength(header.mIdentLength);
+        ok = PR_Read(fd, storedIdent.BeginWriting(), header.mIdentLength) ==
+                 int32_t(header.mIdentLength) &&
+             storedIdent.Equals(ident);
+    }
+
+    FallibleTArray<uint8_t> binary;
+    if (ok) {
+        ok = binary.SetLength(header.mBinaryLength) &&
+             PR_Read(fd, binary.Elements(), header.mBinaryLength) ==
+                 int32_t(header.mBinaryLength);
+    }
+
+    PR_Close(fd);
+
+    if (ok) {
+        aGL->fProgramBinary(aProgram, header.mBinaryFormat,
+                            binary.Elements(), header.mBinaryLength);
+
+        GLint success = 0;
+        aGL->fGetProgramiv(aProgram, LOCAL_GL_LINK_STATUS, &success);
+        ok = success != 0;
+    }
+
+    if (!ok) {
+        // Stale, corrupt, or rejected by the driver; the fresh compile we
+        // fall back to will rewrite the entry.
+        PR_Delete(path.get());
+    }
+
+    return ok;
+}
+
+/* static */ void
+GLProgramBinaryCache::SaveProgram(GLContext* aGL, GLuint aProgram,
+                                  const char* aVertexSource,
+                                  const char* aFragmentSource)
+{
+    if (!CanCache(aGL)) {
+        return;
+    }
+
+    GLint length = 0;
+    aGL->fGetProgramiv(aProgram, LOCAL_GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || uint32_t(length) > kMaxBinaryLength) {
+        return;
+    }
+
+    FallibleTArray<uint8_t> binary;
+    if (!binary.SetLength(length)) {
+        return;
+    }
+
+    GLsizei written = 0;
+    GLenum format = 0;
+    aGL->fGetProgramBinary(aProgram, length, &written, &format,
+                           binary.Elements());
+    if (written <= 0 || written > length) {
+        return;
+    }
+
+    nsAutoCString ident;
+    GetDriverIdent(aGL, ident);
+
+    nsAutoCString path;
+    GetEntryPath(ident, aVertexSource, aFragmentSource, path);
+
+    CacheEntryHeader header;
+    header.mMagic = kCacheMagic;
+    header.mVersion = kCacheVersion;
+    header.mIdentLength = ident.Length();
+    header.mVertexSourceLength = strlen(aVertexSource);
+    header.mFragmentSourceLength = strlen(aFragmentSource);
+    header.mBinaryFormat = format;
+    header.mBinaryLength = written;
+
+    // Write to a temporary name first so a crash mid-write can't leave a
+    // truncated entry behind a valid header.
+    nsPrintfCString tmpPath("%s.tmp", path.get());
+    PRFileDesc* fd = PR_Open(tmpPath.get(),
+                             PR_WRONLY | PR_CREATE_FILE | PR_TRUNCATE, 0600);
+    if (!fd) {
+        return;
+    }
+
+    bool ok = PR_Write(fd, &header, sizeof(header)) == int32_t(sizeof(header)) &&
+              PR_Write(fd, ident.get(), ident.Length()) ==
+                  int32_t(ident.Length()) &&
+              PR_Write(fd, binary.Elements(), written) == written;
+    PR_Close(fd);
+
+    // PR_Rename won't replace an existing file on all platforms.
+    if (ok) {
+        PR_Delete(path.get());
+        ok = PR_Rename(tmpPath.get(), path.get()) == PR_SUCCESS;
+    }
+    if (!ok) {
+        PR_Delete(tmpPath.get());
+    }
+}
+
+}
+}
@@ -0,0 +1,84 @@
+/* -*- Mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; tab-width: 40; -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef GLProgramBinaryCache_h_
+#define GLProgramBinaryCache_h_
+
+#include "GLTypes.h"
+
+namespace mozilla {
+namespace gl {
+
+class GLContext;
+
+/**
+ * A best-effort disk cache of linked GL program binaries, retrieved with
+ * OES_get_program_binary (or its ARB equivalent).
+ *
+ * Compiling and linking the compositor's shaders from source takes several
+ * seconds of startup on some embedded GL drivers.  Drivers that expose
+ * get_program_binary let us pull the compiled program back out after the
+ * first link and replay it on the next startup with a single
+ * glProgramBinary call, skipping the compiler entirely.
+ *
+ * Entries are keyed by a hash of the shader sources together with the
+ * driver's VENDOR/RENDERER/VERSION strings, so a driver or GPU change
+ * simply misses and the entry is rewritten from a fresh compile.  Binaries
+ * are opaque driver blobs and drivers are allowed to reject them at any
+ * time (GL_LINK_STATUS comes back false); callers must always be prepared
+ * to fall back to compiling from source, and rejected entries are deleted.
+ *
+ * Only trusted, in-tree shader sources (the compositor's) should go
+ * through this cache; the key space is not designed for content-supplied
+ * programs.
+ */
+class GLProgramBinaryCache
+{
+public:
+    /**
+     * Resolves and creates the on-disk cache directory.  Must be called on
+     * the main thread (the directory service is not usable from the
+     * compositor thread) before the first Load/Save; if it is never called
+     * or fails, the cache simply stays disabled.
+     */
+    static void InitDirectory();
+
+    /**
+     * True when the cache directory is available and aGL can retrieve
+     * program binaries.  aGL's context must be current.
+     */
+    static bool CanCache(GLContext* aGL);
+
+    /**
+     * On ARB_get_program_binary drivers a binary is only guaranteed to be
+     * retrievable when the program was linked with the retrievable hint
+     * set, so call this between glCreateProgram and glLinkProgram for any
+     * program that will be handed to SaveProgram().  No-op elsewhere.
+     */
+    static void SetRetrievableHint(GLContext* aGL, GLuint aProgram);
+
+    /**
+     * Tries to link aProgram from a cached binary for the given shader
+     * sources.  Returns false on a miss, a stale entry or a driver that
+     * rejects the blob; aProgram is then still an unlinked program object
+     * and the caller should compile from source as usual.
+     */
+    static bool LoadProgram(GLContext* aGL, GLuint aProgram,
+                            const char* aVertexSource,
+                            const char* aFragmentSource);
+
+    /**
+     * Stores the binary of the successfully linked aProgram, replacing any
+     * stale entry for the same sources.  Failures are silently ignored.
+     */
+    static void SaveProgram(GLContext* aGL, GLuint aProgram,
+                            const char* aVertexSource,
+                            const char* aFragmentSource);
+};
+
+}
+}
+
+#endif // GLProgramBinaryCache_h_
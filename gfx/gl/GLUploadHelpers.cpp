@@ -6,6 +6,7 @@
 #include "GLUploadHelpers.h"
 
 #include "GLContext.h"
+#include "GLUploadPBOPool.h"
 #include "mozilla/gfx/2D.h"
 #include "mozilla/gfx/Tools.h"  // For BytesPerPixel
 #include "nsRegion.h"
@@ -225,6 +226,32 @@ TexSubImage2DHelper(GLContext *gl,
                     GLint pixelsize, GLenum format,
                     GLenum type, const GLvoid* pixels)
 {
+    // Try to stage the pixels through a pixel unpack buffer first, so the
+    // driver can complete the upload with an async DMA transfer instead of
+    // copying out of our memory inside fTexSubImage2D.  The staged rows are
+    // tightly packed, so no GL_UNPACK_ROW_LENGTH is needed and this path
+    // works on GLES and desktop GL alike.
+    GLUploadPBOPool* pbos = gl->UploadPBOPool();
+    const GLvoid* pboOffset;
+    if (pbos->BeginUpload(static_cast<const unsigned char*>(pixels),
+                          width, height, stride, pixelsize, &pboOffset)) {
+        gl->fPixelStorei(LOCAL_GL_UNPACK_ALIGNMENT,
+                         std::min(GetAddressAlignment((ptrdiff_t)pboOffset),
+                                  GetAddressAlignment((ptrdiff_t)width * pixelsize)));
+        gl->fTexSubImage2D(target,
+                           level,
+                           xoffset,
+                           yoffset,
+                           width,
+                           height,
+                           format,
+                           type,
+                           pboOffset);
+        pbos->EndUpload();
+        gl->fPixelStorei(LOCAL_GL_UNPACK_ALIGNMENT, 4);
+        return;
+    }
+
     if (gl->IsGLES()) {
         if (stride == width * pixelsize) {
             gl->fPixelStorei(LOCAL_GL_UNPACK_ALIGNMENT,
@@ -0,0 +1,131 @@
+/* -*- Mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; tab-width: 40; -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "GLUploadPBOPool.h"
+
+#include "GLContext.h"
+#include "gfxPrefs.h"
+#include <string.h>
+
+namespace mozilla {
+namespace gl {
+
+GLUploadPBOPool::GLUploadPBOPool(GLContext* aGL)
+    : mGL(aGL)
+    , mSupported(false)
+    , mNextBuffer(0)
+{
+    memset(mBuffers, 0, sizeof(mBuffers));
+
+    // We need MapBufferRange to get a write-only mapping, fence syncs to
+    // know when the GPU has consumed a buffer, and a context version that
+    // accepts the GL_PIXEL_UNPACK_BUFFER binding in the first place.
+    mSupported = gfxPrefs::PBOUploadsEnabled() &&
+                 mGL->IsSupported(GLFeature::map_buffer_range) &&
+                 mGL->IsExtensionSupported(GLContext::ARB_sync) &&
+                 (mGL->IsAtLeast(ContextProfile::OpenGL, 210) ||
+                  mGL->IsAtLeast(ContextProfile::OpenGLES, 300));
+}
+
+GLUploadPBOPool::~GLUploadPBOPool()
+{
+    // Like the other GLContext-owned helpers, we are destroyed from
+    // MarkDestroyed with the context current, so we can tear down our GL
+    // objects directly.
+    for (size_t i = 0; i < kPoolSize; i++) {
+        if (mBuffers[i].mFence) {
+            mGL->fDeleteSync(mBuffers[i].mFence);
+        }
+        if (mBuffers[i].mPBO) {
+            mGL->fDeleteBuffers(1, &mBuffers[i].mPBO);
+        }
+    }
+}
+
+bool
+GLUploadPBOPool::BeginUpload(const unsigned char* aData,
+                             GLsizei aWidth, GLsizei aHeight,
+                             GLsizei aStride, GLint aPixelSize,
+                             const GLvoid** aOutPixels)
+{
+    if (!mSupported) {
+        return false;
+    }
+
+    size_t bytes = size_t(aWidth) * aPixelSize * aHeight;
+    if (bytes < kMinUploadBytes) {
+        return false;
+    }
+
+    Buffer& buffer = mBuffers[mNextBuffer];
+
+    if (!buffer.mPBO) {
+        mGL->fGenBuffers(1, &buffer.mPBO);
+    }
+    mGL->fBindBuffer(LOCAL_GL_PIXEL_UNPACK_BUFFER, buffer.mPBO);
+
+    // Reallocate the buffer's storage if the upload doesn't fit, or orphan
+    // it if the GPU is still reading the previous upload out of it.  Either
+    // way the old storage stays with the pending commands and we get fresh
+    // memory to write into, without waiting on the fence.
+    bool orphan = buffer.mSize < bytes;
+    if (!orphan && buffer.mFence) {
+        GLenum state = mGL->fClientWaitSync(buffer.mFence, 0, 0);
+        orphan = state != LOCAL_GL_ALREADY_SIGNALED &&
+                 state != LOCAL_GL_CONDITION_SATISFIED;
+    }
+    if (buffer.mFence) {
+        mGL->fDeleteSync(buffer.mFence);
+        buffer.mFence = nullptr;
+    }
+    if (orphan) {
+        size_t newSize = std::max(buffer.mSize, bytes);
+        mGL->fBufferData(LOCAL_GL_PIXEL_UNPACK_BUFFER, newSize, nullptr,
+                         LOCAL_GL_STREAM_DRAW);
+        buffer.mSize = newSize;
+    }
+
+    void* mapped = mGL->fMapBufferRange(LOCAL_GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                        LOCAL_GL_MAP_WRITE_BIT |
+                                        LOCAL_GL_MAP_INVALIDATE_BUFFER_BIT |
+                                        LOCAL_GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!mapped) {
+        mGL->fBindBuffer(LOCAL_GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    size_t rowBytes = size_t(aWidth) * aPixelSize;
+    if (aStride == GLsizei(rowBytes)) {
+        memcpy(mapped, aData, bytes);
+    } else {
+        unsigned char* rowDest = static_cast<unsigned char*>(mapped);
+        for (GLsizei h = 0; h < aHeight; h++) {
+            memcpy(rowDest, aData, rowBytes);
+            rowDest += rowBytes;
+            aData += aStride;
+        }
+    }
+
+    mGL->fUnmapBuffer(LOCAL_GL_PIXEL_UNPACK_BUFFER);
+
+    *aOutPixels = nullptr;  // offset 0 into the bound PBO
+    return true;
+}
+
+void
+GLUploadPBOPool::EndUpload()
+{
+    Buffer& buffer = mBuffers[mNextBuffer];
+    MOZ_ASSERT(buffer.mPBO && !buffer.mFence,
+               "EndUpload() without matching BeginUpload()?");
+
+    buffer.mFence = mGL->fFenceSync(LOCAL_GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    mGL->fBindBuffer(LOCAL_GL_PIXEL_UNPACK_BUFFER, 0);
+
+    mNextBuffer = (mNextBuffer + 1) % kPoolSize;
+}
+
+}
+}
@@ -0,0 +1,87 @@
+/* -*- Mode: c++; c-basic-offset: 4; indent-tabs-mode: nil; tab-width: 40; -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef GLUploadPBOPool_h_
+#define GLUploadPBOPool_h_
+
+#include "GLTypes.h"
+
+namespace mozilla {
+namespace gl {
+
+class GLContext;
+
+/**
+ * A small ring of pixel unpack buffer objects (PBOs) used to stream texture
+ * data to the GPU without stalling either side.
+ *
+ * Uploading from a client memory pointer forces the driver to copy the
+ * pixels synchronously inside glTexSubImage2D.  Staging them in a mapped
+ * PBO instead turns the upload call into a cheap command that the driver
+ * completes with an asynchronous DMA transfer.  We cycle through a handful
+ * of buffers and guard each one with a fence sync object so we never map a
+ * buffer the GPU may still be reading from; if the fence for the next
+ * buffer hasn't signaled by the time we wrap around, we orphan the buffer's
+ * storage rather than block.
+ *
+ * Instances are owned by a GLContext (see GLContext::UploadPBOPool()) and
+ * must only be used while that context is current.
+ */
+class GLUploadPBOPool
+{
+public:
+    explicit GLUploadPBOPool(GLContext* aGL);
+    ~GLUploadPBOPool();
+
+    /**
+     * Copies aHeight rows of aWidth*aPixelSize bytes each (read aStride
+     * bytes apart from aData) tightly packed into the next buffer of the
+     * ring and leaves that buffer bound to GL_PIXEL_UNPACK_BUFFER.  On
+     * success, *aOutPixels holds the buffer offset to pass to
+     * fTexSubImage2D in place of a client pointer; the staged rows are
+     * tightly packed, so no GL_UNPACK_ROW_LENGTH is needed.  Call
+     * EndUpload() once the upload call has been issued.
+     *
+     * Returns false, binding nothing, when PBO uploads are unsupported,
+     * when the upload is too small to be worth staging, or when mapping
+     * fails; the caller should then upload from client memory as usual.
+     */
+    bool BeginUpload(const unsigned char* aData,
+                     GLsizei aWidth, GLsizei aHeight,
+                     GLsizei aStride, GLint aPixelSize,
+                     const GLvoid** aOutPixels);
+
+    /**
+     * Inserts the fence guarding the buffer handed out by the last
+     * BeginUpload() and unbinds GL_PIXEL_UNPACK_BUFFER.
+     */
+    void EndUpload();
+
+private:
+    // Deep enough that by the time we reuse a buffer, the GPU has normally
+    // finished consuming the upload it staged a few frames ago.
+    static const size_t kPoolSize = 4;
+
+    // Uploads smaller than this are cheaper to hand straight to
+    // glTexSubImage2D than to stage through a buffer map/unmap cycle.
+    static const size_t kMinUploadBytes = 4096;
+
+    struct Buffer
+    {
+        GLuint mPBO;    // 0 until first used
+        size_t mSize;   // current size of mPBO's storage
+        GLsync mFence;  // guards the last upload out of mPBO, or nullptr
+    };
+
+    GLContext* const mGL;
+    bool mSupported;
+    size_t mNextBuffer;
+    Buffer mBuffers[kPoolSize];
+};
+
+}
+}
+
+#endif // GLUploadPBOPool_h_
@@ -119,6 +119,7 @@ MOZ_BEGIN_ENUM_CLASS(EffectTypes, uint8_t)
   MASK,
   BLEND_MODE,
   COLOR_MATRIX,
+  FILTER,
   MAX_SECONDARY, // sentinel for the count of secondary effect types
   RGB,
   YCBCR,
@@ -69,6 +69,13 @@ EffectColorMatrix::PrintInfo(std::stringstream& aStream, const char* aPrefix)
   AppendToString(aStream, mColorMatrix, " [matrix=", "]");
 }
 
+void
+EffectFilter::PrintInfo(std::stringstream& aStream, const char* aPrefix)
+{
+  aStream << aPrefix;
+  aStream << nsPrintfCString("EffectFilter (0x%p) [blur-sigma=%f]", this, mBlurSigma).get();
+}
+
 void
 EffectVRDistortion::PrintInfo(std::stringstream& aStream, const char* aPrefix)
 {
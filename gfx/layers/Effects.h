@@ -212,6 +212,24 @@ struct EffectComponentAlpha : public TexturedEffect
   TextureSource* mOnWhite;
 };
 
+// Blur the quad as it is composited.  CSS filters that are expressible as a
+// color transform (grayscale, sepia, saturate, ...) should be folded into an
+// EffectColorMatrix instead; this effect only carries the part that needs
+// extra shader passes over an intermediate surface.
+struct EffectFilter : public Effect
+{
+  explicit EffectFilter(float aBlurSigma)
+    : Effect(EffectTypes::FILTER)
+    , mBlurSigma(aBlurSigma)
+  {}
+
+  virtual const char* Name() { return "EffectFilter"; }
+  virtual void PrintInfo(std::stringstream& aStream, const char* aPrefix);
+
+  // Standard deviation of the gaussian blur, in device pixels.
+  float mBlurSigma;
+};
+
 struct EffectSolidColor : public Effect
 {
   explicit EffectSolidColor(const gfx::Color &aColor)
@@ -0,0 +1,86 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "FrameTimeline.h"
+
+#include "GeckoProfiler.h"
+#include "mozilla/layers/CompositorParent.h"  // for IsInCompositorThread
+#ifdef MOZ_ENABLE_PROFILER_SPS
+#include "ProfilerMarkers.h"
+#endif
+
+namespace mozilla {
+namespace layers {
+
+FrameTimeline::Record FrameTimeline::sRing[FrameTimeline::kRingSize];
+size_t FrameTimeline::sNextRecord = 0;
+
+/* static */ FrameTimeline::Record*
+FrameTimeline::FindRecord(uint64_t aLayersId, uint64_t aTransactionId)
+{
+  for (size_t i = 0; i < kRingSize; i++) {
+    Record& record = sRing[i];
+    if (record.mLayersId == aLayersId &&
+        record.mTransactionId == aTransactionId &&
+        !record.mTick.IsNull()) {
+      return &record;
+    }
+  }
+
+  return nullptr;
+}
+
+/* static */ void
+FrameTimeline::NoteTransactionUpdate(uint64_t aLayersId,
+                                     uint64_t aTransactionId,
+                                     const TimeStamp& aTick,
+                                     const TimeStamp& aForward)
+{
+  MOZ_ASSERT(CompositorParent::IsInCompositorThread());
+
+  if (aTick.IsNull()) {
+    // Without the tick timestamp there is nothing to correlate against.
+    return;
+  }
+
+  Record& record = sRing[sNextRecord];
+  sNextRecord = (sNextRecord + 1) % kRingSize;
+
+  record.mLayersId = aLayersId;
+  record.mTransactionId = aTransactionId;
+  record.mTick = aTick;
+  record.mForward = aForward;
+  record.mUpdate = TimeStamp::Now();
+}
+
+/* static */ void
+FrameTimeline::NoteSwap(uint64_t aLayersId, uint64_t aTransactionId)
+{
+  MOZ_ASSERT(CompositorParent::IsInCompositorThread());
+
+  Record* record = FindRecord(aLayersId, aTransactionId);
+  if (!record) {
+    // The record has already been overwritten, or the transaction was
+    // applied before this code started recording.
+    return;
+  }
+
+#ifdef MOZ_ENABLE_PROFILER_SPS
+  if (profiler_is_active()) {
+    FrameTimelinePayload* payload =
+      new FrameTimelinePayload(aLayersId, aTransactionId, record->mTick,
+                               record->mForward, record->mUpdate,
+                               TimeStamp::Now());
+    PROFILER_MARKER_PAYLOAD("FrameTimeline", payload);
+  }
+#endif
+
+  // Free the slot for reuse; late DidComposite notifications for the same
+  // transaction must not produce a second marker.
+  record->mTick = TimeStamp();
+}
+
+} // namespace layers
+} // namespace mozilla
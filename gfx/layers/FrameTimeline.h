@@ -0,0 +1,73 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef GFX_FRAMETIMELINE_H
+#define GFX_FRAMETIMELINE_H
+
+#include <stdint.h>
+#include "mozilla/TimeStamp.h"
+
+namespace mozilla {
+namespace layers {
+
+/**
+ * Records, per layer transaction, the timestamps of the stages a frame goes
+ * through on its way to the screen: the refresh driver tick that started
+ * the paint, the moment the transaction was handed over to IPC, the moment
+ * the shadow layer tree was updated on the compositor, and the composite
+ * that finally presented it.  The transaction id minted by the refresh
+ * driver (see TransactionIdAllocator) serves as the frame timeline id, the
+ * layers id distinguishes transactions coming from different content
+ * processes.
+ *
+ * The records are kept in a fixed size ring buffer, so the overhead is
+ * constant and safe to leave enabled in production.  When the Gecko
+ * Profiler is running, every completed timeline is additionally inserted
+ * into the profile as a "FrameTimeline" marker, making end-to-end frame
+ * latency attribution available in the profiler front-end.
+ *
+ * All methods must be called on the compositor thread.
+ */
+class FrameTimeline
+{
+public:
+  struct Record
+  {
+    uint64_t mLayersId;
+    uint64_t mTransactionId;
+    TimeStamp mTick;     // refresh driver tick that started the paint
+    TimeStamp mForward;  // transaction handed over to IPC on the client
+    TimeStamp mUpdate;   // shadow layer tree updated on the compositor
+  };
+
+  /**
+   * Called when a layer transaction has been applied to the shadow layer
+   * tree.  aTick and aForward are the timestamps the client side threaded
+   * through the transaction; the update timestamp is taken here.
+   */
+  static void NoteTransactionUpdate(uint64_t aLayersId,
+                                    uint64_t aTransactionId,
+                                    const TimeStamp& aTick,
+                                    const TimeStamp& aForward);
+
+  /**
+   * Called when the composite presenting the given transaction finished.
+   * Completes the record and, when the profiler is active, inserts a
+   * "FrameTimeline" marker for it.
+   */
+  static void NoteSwap(uint64_t aLayersId, uint64_t aTransactionId);
+
+private:
+  static Record* FindRecord(uint64_t aLayersId, uint64_t aTransactionId);
+
+  static const size_t kRingSize = 128;
+  static Record sRing[kRingSize];
+  static size_t sNextRecord;
+};
+
+} // namespace layers
+} // namespace mozilla
+
+#endif /* GFX_FRAMETIMELINE_H */
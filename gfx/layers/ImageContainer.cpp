@@ -136,6 +136,7 @@ BufferRecycleBin::GetBuffer(uint32_t aSize)
 
 ImageContainer::ImageContainer(int flag)
 : mReentrantMonitor("ImageContainer.mReentrantMonitor"),
+  mDroppedImageCount(0),
   mPaintCount(0),
   mPreviousImagePainted(false),
   mImageFactory(new ImageFactory()),
@@ -196,6 +197,7 @@ void
 ImageContainer::ClearCurrentImage()
 {
   ReentrantMonitorAutoEnter mon(mReentrantMonitor);
+  mTimedFrames.Clear();
   SetCurrentImageInternal(nullptr);
 }
 
@@ -211,9 +213,77 @@ ImageContainer::SetCurrentImage(Image *aImage)
   if (IsAsync()) {
     ImageBridgeChild::DispatchImageClientUpdate(mImageClient, this);
   }
+  mDroppedImageCount += mTimedFrames.Length();
+  mTimedFrames.Clear();
   SetCurrentImageInternal(aImage);
 }
 
+void
+ImageContainer::SetCurrentImageAtTime(Image *aImage, const TimeStamp& aTargetTime)
+{
+  if (!aImage) {
+    ClearAllImages();
+    return;
+  }
+
+  ReentrantMonitorAutoEnter mon(mReentrantMonitor);
+
+  // Async containers already flip frames on the compositor side, and frames
+  // that are due can be shown right away.
+  if (IsAsync() || aTargetTime.IsNull() || aTargetTime <= TimeStamp::Now()) {
+    if (aImage != mActiveImage) {
+      SetCurrentImage(aImage);
+    }
+    return;
+  }
+
+  // Re-queueing the frame we already have queued just updates its target.
+  if (!mTimedFrames.IsEmpty() &&
+      mTimedFrames[mTimedFrames.Length() - 1].mImage == aImage) {
+    mTimedFrames[mTimedFrames.Length() - 1].mTargetTime = aTargetTime;
+    return;
+  }
+
+  // Drop any queued frames scheduled at or after the new frame's target;
+  // the producer is rescheduling (e.g. after a seek or rate change).
+  while (!mTimedFrames.IsEmpty() &&
+         mTimedFrames[mTimedFrames.Length() - 1].mTargetTime >= aTargetTime) {
+    mTimedFrames.RemoveElementAt(mTimedFrames.Length() - 1);
+    mDroppedImageCount++;
+  }
+
+  TimedFrame* frame = mTimedFrames.AppendElement();
+  frame->mImage = aImage;
+  frame->mTargetTime = aTargetTime;
+}
+
+void
+ImageContainer::AdvanceTimedFramesLocked(const TimeStamp& aNow)
+{
+  mReentrantMonitor.AssertCurrentThreadIn();
+
+  // Find the newest due frame; anything older than it will never be shown.
+  uint32_t due = 0;
+  while (due < mTimedFrames.Length() &&
+         mTimedFrames[due].mTargetTime <= aNow) {
+    due++;
+  }
+  if (due == 0) {
+    return;
+  }
+
+  mDroppedImageCount += due - 1;
+  SetCurrentImageInternal(mTimedFrames[due - 1].mImage);
+  mTimedFrames.RemoveElementsAt(0, due);
+}
+
+uint32_t
+ImageContainer::GetDroppedImageCount()
+{
+  ReentrantMonitorAutoEnter mon(mReentrantMonitor);
+  return mDroppedImageCount;
+}
+
  void
 ImageContainer::ClearAllImages()
 {
@@ -224,6 +294,7 @@ ImageContainer::ClearAllImages()
   }
 
   ReentrantMonitorAutoEnter mon(mReentrantMonitor);
+  mTimedFrames.Clear();
   SetCurrentImageInternal(nullptr);
 }
 
@@ -272,6 +343,8 @@ ImageContainer::LockCurrentImage()
 {
   ReentrantMonitorAutoEnter mon(mReentrantMonitor);
 
+  AdvanceTimedFramesLocked(TimeStamp::Now());
+
   nsRefPtr<Image> retval = mActiveImage;
   return retval.forget();
 }
@@ -281,6 +354,8 @@ ImageContainer::LockCurrentAsSourceSurface(gfx::IntSize *aSize, Image** aCurrent
 {
   ReentrantMonitorAutoEnter mon(mReentrantMonitor);
 
+  AdvanceTimedFramesLocked(TimeStamp::Now());
+
   if (aCurrentImage) {
     NS_IF_ADDREF(mActiveImage);
     *aCurrentImage = mActiveImage.get();
@@ -304,6 +379,8 @@ ImageContainer::GetCurrentAsSourceSurface(gfx::IntSize *aSize)
 {
   ReentrantMonitorAutoEnter mon(mReentrantMonitor);
 
+  AdvanceTimedFramesLocked(TimeStamp::Now());
+
   if (!mActiveImage)
     return nullptr;
   *aSize = mActiveImage->GetSize();
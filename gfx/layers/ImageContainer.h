@@ -332,6 +332,29 @@ public:
    */
   void SetCurrentImage(Image* aImage);
 
+  /**
+   * Queue an Image to become the current image once aTargetTime is reached.
+   * Queued frames are promoted lazily, at the moment the current image is
+   * next locked for painting or compositing, so frame flips follow actual
+   * presentation rather than the media state machine's polling cadence.
+   * A frame that is superseded by a later due frame before ever being
+   * locked is counted as dropped (see GetDroppedImageCount).
+   *
+   * Frames whose target time is already due, and frames handed to async
+   * (ImageBridge) containers, are displayed immediately as with
+   * SetCurrentImage.
+   * Can be called on any thread. This method takes mReentrantMonitor
+   * when accessing thread-shared state.
+   */
+  void SetCurrentImageAtTime(Image* aImage, const TimeStamp& aTargetTime);
+
+  /**
+   * Returns the number of queued frames that were never presented because
+   * a later frame was already due when the current image was next locked.
+   * Can be called on any thread.
+   */
+  uint32_t GetDroppedImageCount();
+
   /**
    * Clear all images. Let ImageClient release all TextureClients.
    */
@@ -535,6 +558,16 @@ private:
 
   void SetCurrentImageInternal(Image* aImage);
 
+  struct TimedFrame {
+    nsRefPtr<Image> mImage;
+    TimeStamp mTargetTime;
+  };
+
+  // Promote the newest due queued frame, if any, to the current image and
+  // count the frames it superseded as dropped. Must be called with
+  // mReentrantMonitor held.
+  void AdvanceTimedFramesLocked(const TimeStamp& aNow);
+
   // This is called to ensure we have an active image, this may not be true
   // when we're storing image information in a RemoteImageData structure.
   // NOTE: If we have remote data mRemoteDataMutex should be locked when
@@ -556,6 +589,12 @@ private:
 
   nsRefPtr<Image> mActiveImage;
 
+  // Frames queued by SetCurrentImageAtTime, oldest target time first.
+  nsTArray<TimedFrame> mTimedFrames;
+
+  // Number of queued frames dropped without ever becoming current.
+  uint32_t mDroppedImageCount;
+
   // Number of contained images that have been painted at least once.  It's up
   // to the ImageContainer implementation to ensure accesses to this are
   // threadsafe.
@@ -278,10 +278,15 @@ YCbCrImageDataSerializer::CopyData(const uint8_t* aYData,
 }
 
 TemporaryRef<DataSourceSurface>
-YCbCrImageDataDeserializer::ToDataSourceSurface()
+YCbCrImageDataDeserializer::ToDataSourceSurface(DataSourceSurface* aRecycled)
 {
-  RefPtr<DataSourceSurface> result =
-    Factory::CreateDataSourceSurface(GetYSize(), gfx::SurfaceFormat::B8G8R8X8);
+  RefPtr<DataSourceSurface> result = aRecycled;
+  if (!result ||
+      result->GetSize() != GetYSize() ||
+      result->GetFormat() != gfx::SurfaceFormat::B8G8R8X8) {
+    result = Factory::CreateDataSourceSurface(GetYSize(),
+                                              gfx::SurfaceFormat::B8G8R8X8);
+  }
   if (NS_WARN_IF(!result)) {
     return nullptr;
   }
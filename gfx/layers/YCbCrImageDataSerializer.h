@@ -177,7 +177,13 @@ public:
    * This is a costly operation, so use it only when YCbCr compositing is
    * not supported.
    */
-  TemporaryRef<gfx::DataSourceSurface> ToDataSourceSurface();
+  /**
+   * Convert the data to a BGRX surface. If aRecycled is non-null and has a
+   * matching size and format it is converted into and returned, avoiding a
+   * surface allocation per frame; otherwise a new surface is allocated.
+   */
+  TemporaryRef<gfx::DataSourceSurface>
+    ToDataSourceSurface(gfx::DataSourceSurface* aRecycled = nullptr);
 };
 
 } // namespace
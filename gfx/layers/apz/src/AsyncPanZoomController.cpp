@@ -249,6 +249,18 @@ using mozilla::gfx::PointTyped;
  * Amount of friction applied during flings.
  *
  *
+ * \li\b apz.fling_prefetch.enabled
+ * If this is true, then while we are skating we place the displayport along
+ * the predicted fling trajectory (taking fling friction into account) rather
+ * than extrapolating the instantaneous velocity linearly. The prediction
+ * horizon adapts to the measured paint durations.
+ *
+ * \li\b apz.fling_prefetch.max_ms
+ * Upper bound on the prefetch prediction horizon, so that one pathologically
+ * slow paint doesn't place the displayport somewhere the fling will never
+ * reach.\n
+ * Units: milliseconds
+ *
  * \li\b apz.fling_repaint_interval
  * Maximum amount of time flinging before sending a viewport change. This will
  * asynchronously repaint the page.\n
@@ -2244,6 +2256,25 @@ RedistributeDisplayPortExcess(CSSSize& aDisplayPortSize,
   }
 }
 
+/**
+ * Predicts how far the content will have scrolled along one axis after
+ * aPredictionTimeMillis, assuming the velocity decays under fling friction
+ * the same way FlingAnimation decays it (see
+ * Axis::FlingApplyFrictionOrCancel). This is the integral of
+ * v0 * (1 - friction)^t over [0, aPredictionTimeMillis].
+ */
+static float
+PredictFlingDisplacement(float aVelocity, float aPredictionTimeMillis)
+{
+  float friction = gfxPrefs::APZFlingFriction();
+  if (friction <= 0.0f || friction >= 1.0f) {
+    // No sensible friction model; fall back to linear extrapolation.
+    return aVelocity * aPredictionTimeMillis;
+  }
+  float decay = logf(1.0f - friction);
+  return aVelocity * (expf(decay * aPredictionTimeMillis) - 1.0f) / decay;
+}
+
 /* static */
 const ScreenMargin AsyncPanZoomController::CalculatePendingDisplayPort(
   const FrameMetrics& aFrameMetrics,
@@ -2266,8 +2297,21 @@ const ScreenMargin AsyncPanZoomController::CalculatePendingDisplayPort(
   // estimated time it takes to paint, to try to minimise checkerboarding.
   float estimatedPaintDurationMillis = (float)(aEstimatedPaintDuration * 1000.0);
   float paintFactor = (gfxPrefs::APZUsePaintDuration() ? estimatedPaintDurationMillis : 50.0f);
-  CSSRect displayPort = CSSRect(scrollOffset + (velocity * paintFactor * gfxPrefs::APZVelocityBias()),
-                                displayPortSize);
+  CSSPoint predictedOffset = velocity * paintFactor * gfxPrefs::APZVelocityBias();
+  if (gfxPrefs::APZFlingPrefetchEnabled() &&
+      velocity.Length() >= gfxPrefs::APZMinSkateSpeed()) {
+    // Look ahead along the predicted fling trajectory instead of
+    // extrapolating the instantaneous velocity linearly; the latter
+    // overshoots where the fling will actually be once friction has had
+    // its say. The prediction horizon scales with how long paints have
+    // been taking, but is capped so a single pathologically slow paint
+    // doesn't put the displayport somewhere the fling will never reach.
+    float predictionTime = std::min(paintFactor * gfxPrefs::APZVelocityBias(),
+                                    gfxPrefs::APZFlingPrefetchMaxMs());
+    predictedOffset = CSSPoint(PredictFlingDisplacement(velocity.x, predictionTime),
+                               PredictFlingDisplacement(velocity.y, predictionTime));
+  }
+  CSSRect displayPort = CSSRect(scrollOffset + predictedOffset, displayPortSize);
 
   // Re-center the displayport based on its expansion over the composition size.
   displayPort.MoveBy((compositionSize.width - displayPort.width)/2.0f,
@@ -291,19 +291,15 @@ AddWrappedRegion(const nsIntRegion& aInput, nsIntRegion& aOutput,
   aOutput.Or(aOutput, tempRegion);
 }
 
-bool
-ContentHostSingleBuffered::UpdateThebes(const ThebesBufferData& aData,
-                                        const nsIntRegion& aUpdated,
-                                        const nsIntRegion& aOldValidRegionBack,
-                                        nsIntRegion* aUpdatedRegionBack)
+// Converts an update region in screen coordinates into the corresponding
+// region in buffer coordinates, wrapping pixels that extend past the
+// bottom/right edges around the buffer's rotation point. Returns false if
+// the update data is invalid.
+static bool
+ConvertToBufferSpace(const ThebesBufferData& aData,
+                     const nsIntRegion& aUpdated,
+                     nsIntRegion& aFinalRegion)
 {
-  aUpdatedRegionBack->SetEmpty();
-
-  if (!mTextureHost) {
-    mInitialised = false;
-    return true; // FIXME should we return false? Returning true for now
-  }              // to preserve existing behavior of NOT causing IPC errors.
-
   // updated is in screen coordinates. Convert it to buffer coordinates.
   nsIntRegion destRegion(aUpdated);
   destRegion.MoveBy(-aData.rect().TopLeft());
@@ -326,16 +322,36 @@ ContentHostSingleBuffered::UpdateThebes(const ThebesBufferData& aData,
   nsIntSize bufferSize = aData.rect().Size();
 
   // Select only the pixels that are still within the buffer.
-  nsIntRegion finalRegion;
-  finalRegion.And(nsIntRect(nsIntPoint(), bufferSize), destRegion);
+  aFinalRegion.And(nsIntRect(nsIntPoint(), bufferSize), destRegion);
 
   // For each of the overlap areas (right, bottom-right, bottom), select those
   // pixels and wrap them around to the opposite edge of the buffer rect.
-  AddWrappedRegion(destRegion, finalRegion, bufferSize, nsIntPoint(aData.rect().width, 0));
-  AddWrappedRegion(destRegion, finalRegion, bufferSize, nsIntPoint(aData.rect().width, aData.rect().height));
-  AddWrappedRegion(destRegion, finalRegion, bufferSize, nsIntPoint(0, aData.rect().height));
+  AddWrappedRegion(destRegion, aFinalRegion, bufferSize, nsIntPoint(aData.rect().width, 0));
+  AddWrappedRegion(destRegion, aFinalRegion, bufferSize, nsIntPoint(aData.rect().width, aData.rect().height));
+  AddWrappedRegion(destRegion, aFinalRegion, bufferSize, nsIntPoint(0, aData.rect().height));
+
+  MOZ_ASSERT(nsIntRect(0, 0, aData.rect().width, aData.rect().height).Contains(aFinalRegion.GetBounds()));
+
+  return true;
+}
+
+bool
+ContentHostSingleBuffered::UpdateThebes(const ThebesBufferData& aData,
+                                        const nsIntRegion& aUpdated,
+                                        const nsIntRegion& aOldValidRegionBack,
+                                        nsIntRegion* aUpdatedRegionBack)
+{
+  aUpdatedRegionBack->SetEmpty();
 
-  MOZ_ASSERT(nsIntRect(0, 0, aData.rect().width, aData.rect().height).Contains(finalRegion.GetBounds()));
+  if (!mTextureHost) {
+    mInitialised = false;
+    return true; // FIXME should we return false? Returning true for now
+  }              // to preserve existing behavior of NOT causing IPC errors.
+
+  nsIntRegion finalRegion;
+  if (!ConvertToBufferSpace(aData, aUpdated, finalRegion)) {
+    return false;
+  }
 
   mTextureHost->Updated(&finalRegion);
   if (mTextureHostOnWhite) {
@@ -362,15 +378,43 @@ ContentHostDoubleBuffered::UpdateThebes(const ThebesBufferData& aData,
     return true;
   }
 
-  // We don't need to calculate an update region because we assume that if we
-  // are using double buffering then we have render-to-texture and thus no
-  // upload to do.
-  mTextureHost->Updated();
-  if (mTextureHostOnWhite) {
-    mTextureHostOnWhite->Updated();
+  // The buffer we were just handed was last presented two transactions ago.
+  // Since then the client copied the previous update from the other buffer
+  // into it and painted this transaction's changes on top, so the pixels
+  // that are stale on the compositor side are the union of this update and
+  // the previous one. That reasoning only holds while the buffer rect and
+  // rotation stay the same across both transactions; when they change, the
+  // mapping of those screen-space regions onto the buffer's pixels changes
+  // too, so fall back to a full upload. Backends with render-to-texture
+  // ignore the region and composite the buffer directly either way.
+  nsIntRegion finalRegion;
+  bool canPartialUpdate =
+    aData.rect().IsEqualEdges(mBufferRect) &&
+    aData.rotation() == mBufferRotation &&
+    mBufferRect.IsEqualEdges(mPreviousBufferRect) &&
+    mBufferRotation == mPreviousBufferRotation;
+  if (canPartialUpdate) {
+    nsIntRegion staleRegion;
+    staleRegion.Or(aUpdated, mPreviousUpdatedRegion);
+    canPartialUpdate = ConvertToBufferSpace(aData, staleRegion, finalRegion);
+  }
+
+  if (canPartialUpdate) {
+    mTextureHost->Updated(&finalRegion);
+    if (mTextureHostOnWhite) {
+      mTextureHostOnWhite->Updated(&finalRegion);
+    }
+  } else {
+    mTextureHost->Updated();
+    if (mTextureHostOnWhite) {
+      mTextureHostOnWhite->Updated();
+    }
   }
   mInitialised = true;
 
+  mPreviousUpdatedRegion = aUpdated;
+  mPreviousBufferRect = mBufferRect;
+  mPreviousBufferRotation = mBufferRotation;
   mBufferRect = aData.rect();
   mBufferRotation = aData.rotation();
 
@@ -180,8 +180,10 @@ protected:
 
 /**
  * Double buffering is implemented by swapping the front and back TextureHosts.
- * We assume that whenever we use double buffering, then we have
- * render-to-texture and thus no texture upload to do.
+ * On backends with render-to-texture the swapped-in buffer can be composited
+ * directly; on upload-based backends we re-upload only the region that has
+ * changed since the incoming buffer was last presented (this update plus the
+ * previous one, because updates alternate between the two buffers).
  */
 class ContentHostDoubleBuffered : public ContentHostTexture
 {
@@ -201,6 +203,13 @@ public:
 
 protected:
   nsIntRegion mValidRegionForNextBackBuffer;
+  // State from the previous UpdateThebes, used to work out which pixels of
+  // the incoming back buffer are stale on the compositor. Partial uploads
+  // are only safe while the buffer rect and rotation stay the same; see
+  // UpdateThebes.
+  nsIntRegion mPreviousUpdatedRegion;
+  nsIntRect mPreviousBufferRect;
+  nsIntPoint mPreviousBufferRotation;
 };
 
 /**
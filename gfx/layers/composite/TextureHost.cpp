@@ -508,10 +508,16 @@ BufferTextureHost::Upload(nsIntRegion *aRegion)
     MOZ_ASSERT(yuvDeserializer.IsValid());
 
     if (!mCompositor->SupportsEffect(EffectTypes::YCBCR)) {
-      RefPtr<gfx::DataSourceSurface> surf = yuvDeserializer.ToDataSourceSurface();
+      // Software conversion fallback. Keep the intermediate RGB surface
+      // alive between frames so a large video doesn't pay for a surface
+      // allocation on every upload.
+      RefPtr<gfx::DataSourceSurface> surf =
+        yuvDeserializer.ToDataSourceSurface(mIntermediateSurface);
       if (NS_WARN_IF(!surf)) {
+        mIntermediateSurface = nullptr;
         return false;
       }
+      mIntermediateSurface = surf;
       if (!mFirstSource) {
         mFirstSource = mCompositor->CreateDataTextureSource(mFlags);
       }
@@ -615,6 +615,9 @@ protected:
 
   RefPtr<Compositor> mCompositor;
   RefPtr<DataTextureSource> mFirstSource;
+  // Reused between uploads when the compositor cannot sample YCbCr and we
+  // have to convert to RGB in software (see Upload).
+  RefPtr<gfx::DataSourceSurface> mIntermediateSurface;
   nsIntRegion mMaybeUpdatedRegion;
   gfx::IntSize mSize;
   // format of the data that is shared with the content process.
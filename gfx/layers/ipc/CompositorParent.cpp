@@ -34,6 +34,7 @@
 #include "mozilla/layers/Compositor.h"  // for Compositor
 #include "mozilla/layers/CompositorOGL.h"  // for CompositorOGL
 #include "mozilla/layers/CompositorTypes.h"
+#include "mozilla/layers/FrameTimeline.h"
 #include "mozilla/layers/LayerManagerComposite.h"
 #include "mozilla/layers/LayersTypes.h"
 #include "mozilla/layers/PLayerTransactionParent.h"
@@ -49,6 +50,7 @@
 #include "nsIWidget.h"                  // for nsIWidget
 #include "nsRect.h"                     // for nsIntRect
 #include "nsTArray.h"                   // for nsTArray
+#include "nsThreadManager.h"            // for nsThreadManager
 #include "nsThreadUtils.h"              // for NS_IsMainThread
 #include "nsXULAppAPI.h"                // for XRE_GetIOMessageLoop
 #ifdef XP_WIN
@@ -194,11 +196,18 @@ static Thread* CompositorThread() {
 static void SetThreadPriority()
 {
   hal::SetCurrentThreadPriority(hal::THREAD_PRIORITY_COMPOSITOR);
+  nsThreadManager::get()->SetCurrentThreadClass(
+    nsThreadManager::THREAD_CLASS_COMPOSITOR);
 }
 
+// How many consecutive vsync notifications may pass without a composite
+// before we stop observing vsync altogether.
+static const uint32_t kIdleVsyncsBeforeUnobserve = 4;
+
 CompositorVsyncObserver::CompositorVsyncObserver(CompositorParent* aCompositorParent, nsIWidget* aWidget)
   : mNeedsComposite(false)
   , mIsObservingVsync(false)
+  , mIdleVsyncCount(0)
   , mCompositorParent(aCompositorParent)
   , mCurrentCompositeTaskMonitor("CurrentCompositeTaskMonitor")
   , mCurrentCompositeTask(nullptr)
@@ -253,6 +262,18 @@ CompositorVsyncObserver::NotifyVsync(TimeStamp aVsyncTimestamp)
   MOZ_ASSERT(!NS_IsMainThread());
 
   MonitorAutoLock lock(mCurrentCompositeTaskMonitor);
+
+  // Keep a running estimate of the vsync interval, guarding against bogus
+  // deltas after a pause in vsync delivery.
+  if (!mLastVsyncTimestamp.IsNull()) {
+    TimeDuration interval = aVsyncTimestamp - mLastVsyncTimestamp;
+    if (interval > TimeDuration::FromMilliseconds(1) &&
+        interval < TimeDuration::FromMilliseconds(100)) {
+      mVsyncInterval = interval;
+    }
+  }
+  mLastVsyncTimestamp = aVsyncTimestamp;
+
   if (mCurrentCompositeTask == nullptr) {
     mCurrentCompositeTask = NewRunnableMethod(this,
                                               &CompositorVsyncObserver::Composite,
@@ -277,14 +298,40 @@ void
 CompositorVsyncObserver::Composite(TimeStamp aVsyncTimestamp)
 {
   MOZ_ASSERT(CompositorParent::IsInCompositorThread());
+  TimeDuration vsyncInterval;
   {
     MonitorAutoLock lock(mCurrentCompositeTaskMonitor);
     mCurrentCompositeTask = nullptr;
+    vsyncInterval = mVsyncInterval;
   }
 
   if (mNeedsComposite && mCompositorParent) {
     mNeedsComposite = false;
+    mIdleVsyncCount = 0;
     mCompositorParent->CompositeCallback(aVsyncTimestamp);
+
+    // If composition reliably takes longer than a vsync interval, strict
+    // alignment drops every other frame and the output beats at half the
+    // vsync rate.  When the next frame has already been requested, start
+    // composing it immediately instead of waiting out the remainder of
+    // this interval.
+    if (mNeedsComposite && vsyncInterval > TimeDuration() &&
+        mCompositorParent &&
+        mCompositorParent->EstimatedCompositeDuration() > vsyncInterval) {
+      MonitorAutoLock lock(mCurrentCompositeTaskMonitor);
+      if (mCurrentCompositeTask == nullptr) {
+        mCurrentCompositeTask = NewRunnableMethod(this,
+                                                  &CompositorVsyncObserver::Composite,
+                                                  TimeStamp::Now());
+        CompositorParent::CompositorLoop()->PostTask(FROM_HERE, mCurrentCompositeTask);
+      }
+    }
+  } else if (mIsObservingVsync &&
+             ++mIdleVsyncCount >= kIdleVsyncsBeforeUnobserve) {
+    // Nothing has needed a composite for a while; stop listening so an
+    // idle compositor isn't woken up on every frame.
+    UnobserveVsync();
+    mIdleVsyncCount = 0;
   }
 
   DispatchTouchEvents(aVsyncTimestamp);
@@ -356,6 +403,7 @@ CompositorParent::CompositorParent(nsIWidget* aWidget,
   : mWidget(aWidget)
   , mCurrentCompositeTask(nullptr)
   , mIsTesting(false)
+  , mCompositeDurationIndex(0)
   , mPendingTransaction(0)
   , mPaused(false)
   , mUseExternalSurfaceSize(aUseExternalSurfaceSize)
@@ -825,6 +873,26 @@ CompositorParent::CompositeCallback(TimeStamp aScheduleTime)
   CompositeToTarget(nullptr);
 }
 
+void
+CompositorParent::RecordCompositeDuration(TimeDuration aDuration)
+{
+  mCompositeDurations[mCompositeDurationIndex] = aDuration;
+  mCompositeDurationIndex =
+    (mCompositeDurationIndex + 1) % kCompositeDurationWindow;
+}
+
+TimeDuration
+CompositorParent::EstimatedCompositeDuration()
+{
+  TimeDuration worst;
+  for (uint32_t i = 0; i < kCompositeDurationWindow; ++i) {
+    if (mCompositeDurations[i] > worst) {
+      worst = mCompositeDurations[i];
+    }
+  }
+  return worst;
+}
+
 // Go down the composite layer tree, setting properties to match their
 // content-side counterparts.
 static void
@@ -937,6 +1005,8 @@ CompositorParent::CompositeToTarget(DrawTarget* aTarget, const nsIntRect* aRect)
     ScheduleComposition();
   }
 
+  RecordCompositeDuration(TimeStamp::Now() - start);
+
   mozilla::Telemetry::AccumulateTimeDelta(mozilla::Telemetry::COMPOSITE_TIME, start);
   profiler_tracing("Paint", "Composite", TRACING_INTERVAL_END);
 }
@@ -1455,6 +1525,7 @@ void
 CompositorParent::DidComposite()
 {
   if (mPendingTransaction) {
+    FrameTimeline::NoteSwap(0, mPendingTransaction);
     unused << SendDidComposite(0, mPendingTransaction);
     mPendingTransaction = 0;
   }
@@ -1657,6 +1728,7 @@ CrossProcessCompositorParent::DidComposite(uint64_t aId)
 {
   LayerTransactionParent *layerTree = sIndirectLayerTrees[aId].mLayerTree;
   if (layerTree && layerTree->GetPendingTransactionId()) {
+    FrameTimeline::NoteSwap(aId, layerTree->GetPendingTransactionId());
     unused << SendDidComposite(aId, layerTree->GetPendingTransactionId());
     layerTree->SetPendingTransactionId(0);
   }
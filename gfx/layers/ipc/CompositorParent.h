@@ -117,6 +117,15 @@ private:
 
   bool mNeedsComposite;
   bool mIsObservingVsync;
+  // Number of consecutive vsync notifications that didn't need a
+  // composite.  Once enough accumulate we stop observing vsync so an
+  // idle compositor doesn't wake up every frame.
+  uint32_t mIdleVsyncCount;
+  // The interval between the last two vsync notifications, used together
+  // with CompositorParent::EstimatedCompositeDuration() to judge whether
+  // composition is keeping up with the vsync rate.
+  TimeStamp mLastVsyncTimestamp;
+  TimeDuration mVsyncInterval;
   nsRefPtr<CompositorParent> mCompositorParent;
   nsRefPtr<CompositorVsyncDispatcher> mCompositorVsyncDispatcher;
 
@@ -358,6 +367,15 @@ protected:
 
   void DidComposite();
 
+  /**
+   * Record how long the last composite took and return a pessimistic
+   * estimate (the worst case over a recent window) of how long the next
+   * one will take.  Used by the vsync observer to judge whether
+   * composition is keeping up with the vsync rate.
+   */
+  void RecordCompositeDuration(TimeDuration aDuration);
+  TimeDuration EstimatedCompositeDuration();
+
   nsRefPtr<LayerManagerComposite> mLayerManager;
   nsRefPtr<Compositor> mCompositor;
   RefPtr<AsyncCompositionManager> mCompositionManager;
@@ -366,6 +384,11 @@ protected:
   TimeStamp mLastCompose;
   TimeStamp mTestTime;
   bool mIsTesting;
+  // Ring buffer of recent composite execution times backing
+  // EstimatedCompositeDuration().
+  static const uint32_t kCompositeDurationWindow = 8;
+  TimeDuration mCompositeDurations[kCompositeDurationWindow];
+  uint32_t mCompositeDurationIndex;
 #ifdef COMPOSITOR_PERFORMANCE_WARNING
   TimeStamp mExpectedComposeStartTime;
 #endif
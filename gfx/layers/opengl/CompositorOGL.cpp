@@ -168,6 +168,8 @@ CompositorOGL::CleanupResources()
     return;
   }
 
+  mFilterTargetPool.Clear();
+
   ctx->fBindFramebuffer(LOCAL_GL_FRAMEBUFFER, 0);
 
   if (mQuadVBO) {
@@ -903,6 +905,15 @@ CompositorOGL::DrawQuad(const Rect& aRect,
     return;
   }
 
+  if (aEffectChain.mSecondaryEffects[EffectTypes::FILTER]) {
+    EffectFilter* filter = static_cast<EffectFilter*>(
+      aEffectChain.mSecondaryEffects[EffectTypes::FILTER].get());
+    if (filter->mBlurSigma > 0.0f) {
+      DrawFilteredQuad(aRect, aClipRect, aEffectChain, aOpacity, aTransform);
+      return;
+    }
+  }
+
   Rect clipRect = aClipRect;
   // aClipRect is in destination coordinate space (after all
   // transforms and offsets have been applied) so if our
@@ -1201,6 +1212,181 @@ CompositorOGL::DrawQuad(const Rect& aRect,
   MakeCurrent();
 }
 
+// How many offscreen surfaces DrawFilteredQuad keeps alive for reuse.  Two
+// are in flight per blurred quad, so this covers two blurred layers of
+// stable size before we start churning FBOs.
+static const uint32_t kFilterTargetPoolSize = 4;
+
+TemporaryRef<CompositingRenderTargetOGL>
+CompositorOGL::AcquireFilterTarget(const gfx::IntRect& aRect)
+{
+  for (uint32_t i = 0; i < mFilterTargetPool.Length(); ++i) {
+    if (mFilterTargetPool[i]->GetRect().IsEqualEdges(aRect)) {
+      RefPtr<CompositingRenderTargetOGL> target = mFilterTargetPool[i];
+      mFilterTargetPool.RemoveElementAt(i);
+      target->ClearOnBind();
+      return target.forget();
+    }
+  }
+  RefPtr<CompositingRenderTarget> created =
+    CreateRenderTarget(aRect, INIT_MODE_CLEAR);
+  RefPtr<CompositingRenderTargetOGL> target =
+    static_cast<CompositingRenderTargetOGL*>(created.get());
+  return target.forget();
+}
+
+void
+CompositorOGL::ReleaseFilterTarget(CompositingRenderTargetOGL* aTarget)
+{
+  if (mFilterTargetPool.Length() >= kFilterTargetPoolSize) {
+    mFilterTargetPool.RemoveElementAt(0);
+  }
+  mFilterTargetPool.AppendElement(aTarget);
+}
+
+void
+CompositorOGL::DrawFilteredQuad(const Rect& aRect,
+                                const Rect& aClipRect,
+                                const EffectChain& aEffectChain,
+                                Float aOpacity,
+                                const gfx::Matrix4x4& aTransform)
+{
+  EffectFilter* filter = static_cast<EffectFilter*>(
+    aEffectChain.mSecondaryEffects[EffectTypes::FILTER].get());
+
+  // Device-space bounds of the quad, inflated so blurred pixels that bleed
+  // past the edges are kept, and clamped to something we can texture.
+  Rect deviceRect = aTransform.TransformBounds(aRect);
+  deviceRect.Inflate(ceilf(filter->mBlurSigma * 3.0f));
+  deviceRect.RoundOut();
+  IntRect surfaceRect;
+  if (!deviceRect.ToIntRect(&surfaceRect)) {
+    return;
+  }
+  int32_t maxTexSize = GetMaxTextureSize();
+  surfaceRect.width = std::min(surfaceRect.width, maxTexSize);
+  surfaceRect.height = std::min(surfaceRect.height, maxTexSize);
+  if (surfaceRect.IsEmpty()) {
+    return;
+  }
+
+  // The chain we render offscreen: everything except the filter itself and
+  // the blend mode, which is applied when the result reaches the target.
+  EffectChain unfiltered(aEffectChain.mLayerRef);
+  unfiltered.mPrimaryEffect = aEffectChain.mPrimaryEffect;
+  unfiltered.mSecondaryEffects[EffectTypes::MASK] =
+    aEffectChain.mSecondaryEffects[EffectTypes::MASK];
+  unfiltered.mSecondaryEffects[EffectTypes::COLOR_MATRIX] =
+    aEffectChain.mSecondaryEffects[EffectTypes::COLOR_MATRIX];
+
+  RefPtr<CompositingRenderTargetOGL> sourceTarget =
+    AcquireFilterTarget(surfaceRect);
+  RefPtr<CompositingRenderTargetOGL> scratchTarget =
+    AcquireFilterTarget(surfaceRect);
+  if (!sourceTarget || !scratchTarget) {
+    // We can't get offscreen surfaces; drawing unblurred beats dropping the
+    // quad altogether.
+    unfiltered.mSecondaryEffects[EffectTypes::BLEND_MODE] =
+      aEffectChain.mSecondaryEffects[EffectTypes::BLEND_MODE];
+    DrawQuad(aRect, aClipRect, unfiltered, aOpacity, aTransform);
+    return;
+  }
+
+  RefPtr<CompositingRenderTargetOGL> previousTarget = mCurrentRenderTarget;
+
+  // Pass 1: render the unfiltered quad into the offscreen surface.  The
+  // surface's origin shifts the quad into surface-local space, the same way
+  // container layers render into intermediate surfaces.
+  SetRenderTarget(sourceTarget);
+  DrawQuad(aRect, Rect(0, 0, surfaceRect.width, surfaceRect.height),
+           unfiltered, 1.0f, aTransform);
+
+  // Pass 2: horizontal blur into the scratch surface.
+  SetRenderTarget(scratchTarget);
+  DrawBlurPass(sourceTarget, Rect(surfaceRect),
+               Rect(0, 0, surfaceRect.width, surfaceRect.height),
+               filter->mBlurSigma / surfaceRect.width, 0.0f,
+               1.0f, gfx::CompositionOp::OP_OVER);
+
+  // Pass 3: vertical blur, composited back to the original target with the
+  // quad's opacity and blend mode.
+  SetRenderTarget(previousTarget);
+  gfx::CompositionOp blendMode = gfx::CompositionOp::OP_OVER;
+  if (aEffectChain.mSecondaryEffects[EffectTypes::BLEND_MODE]) {
+    blendMode = static_cast<EffectBlendMode*>(
+      aEffectChain.mSecondaryEffects[EffectTypes::BLEND_MODE].get())->mBlendMode;
+  }
+  DrawBlurPass(scratchTarget, Rect(surfaceRect), aClipRect,
+               0.0f, filter->mBlurSigma / surfaceRect.height,
+               aOpacity, blendMode);
+
+  ReleaseFilterTarget(sourceTarget);
+  ReleaseFilterTarget(scratchTarget);
+}
+
+void
+CompositorOGL::DrawBlurPass(CompositingRenderTargetOGL* aSource,
+                            const Rect& aRect,
+                            const Rect& aClipRect,
+                            float aTexelSigmaX,
+                            float aTexelSigmaY,
+                            Float aOpacity,
+                            gfx::CompositionOp aBlendMode)
+{
+  Rect clipRect = aClipRect;
+  if (!mTarget && mCurrentRenderTarget->IsWindow()) {
+    clipRect.MoveBy(mRenderOffset.x, mRenderOffset.y);
+  }
+  IntRect intClipRect;
+  clipRect.ToIntRect(&intClipRect);
+  gl()->fScissor(intClipRect.x, FlipY(intClipRect.y + intClipRect.height),
+                 intClipRect.width, intClipRect.height);
+
+  ShaderConfigOGL config;
+  config.SetTextureTarget(mFBOTextureTarget);
+  config.SetBlur(true);
+  config.SetOpacity(aOpacity != 1.f);
+  ShaderProgramOGL* program = GetShaderProgramFor(config);
+  if (!program) {
+    return;
+  }
+  ActivateProgram(program);
+  program->SetProjectionMatrix(mProjMatrix);
+  program->SetLayerTransform(gfx::Matrix4x4());
+  IntPoint offset = mCurrentRenderTarget->GetOrigin();
+  program->SetRenderOffset(offset.x, offset.y);
+  if (aOpacity != 1.f) {
+    program->SetLayerOpacity(aOpacity);
+  }
+
+  aSource->BindTexture(LOCAL_GL_TEXTURE0, mFBOTextureTarget);
+  program->SetTextureUnit(0);
+
+  // As with EffectRenderTarget, apply a flip here to cancel out the one
+  // drawing normally applies when copying between surfaces.
+  Matrix transform;
+  transform.PreTranslate(0.0, 1.0);
+  transform.PreScale(1.0f, -1.0f);
+  program->SetTextureTransform(Matrix4x4::From2D(transform));
+
+  if (config.mFeatures & ENABLE_TEXTURE_RECT) {
+    program->SetTexCoordMultiplier(aRect.width, aRect.height);
+  }
+
+  // The gaussian kernel is sampled at unit-sigma steps, so the radius
+  // uniform is one standard deviation in texture coordinates.
+  program->SetBlurRadius(aTexelSigmaX, aTexelSigmaY);
+  program->SetBlurOffset(0.0f, 0.0f);
+  program->SetBlurAlpha(0.0f);
+
+  bool didSetBlendMode = SetBlendMode(gl(), aBlendMode);
+  BindAndDrawQuad(program, aRect);
+  if (didSetBlendMode) {
+    gl()->fBlendFuncSeparate(LOCAL_GL_ONE, LOCAL_GL_ONE_MINUS_SRC_ALPHA,
+                             LOCAL_GL_ONE, LOCAL_GL_ONE);
+  }
+}
+
 void
 CompositorOGL::EndFrame()
 {
@@ -319,6 +319,39 @@ private:
                         gfx::Float aOpacity,
                         const gfx::Matrix4x4& aTransform);
 
+  /**
+   * DrawQuad for an effect chain carrying an EffectFilter: renders the quad
+   * into a pooled intermediate surface, runs separable blur passes over it
+   * and composites the result back to the current render target.
+   */
+  void DrawFilteredQuad(const gfx::Rect& aRect,
+                        const gfx::Rect& aClipRect,
+                        const EffectChain& aEffectChain,
+                        gfx::Float aOpacity,
+                        const gfx::Matrix4x4& aTransform);
+
+  /**
+   * Draw aSource at aRect on the current render target, blurred along one
+   * axis.  The sigmas are in texture coordinates (device pixels divided by
+   * the corresponding surface dimension); one of them is expected to be zero.
+   */
+  void DrawBlurPass(CompositingRenderTargetOGL* aSource,
+                    const gfx::Rect& aRect,
+                    const gfx::Rect& aClipRect,
+                    float aTexelSigmaX,
+                    float aTexelSigmaY,
+                    gfx::Float aOpacity,
+                    gfx::CompositionOp aBlendMode);
+
+  /**
+   * Offscreen surfaces used by DrawFilteredQuad, recycled across frames so
+   * a blurred layer that keeps its size does not allocate fresh FBOs on
+   * every composite.
+   */
+  TemporaryRef<CompositingRenderTargetOGL>
+  AcquireFilterTarget(const gfx::IntRect& aRect);
+  void ReleaseFilterTarget(CompositingRenderTargetOGL* aTarget);
+
   /** Widget associated with this compositor */
   nsIWidget *mWidget;
   nsIntSize mWidgetSize;
@@ -433,6 +466,8 @@ private:
 
   RefPtr<CompositorTexturePoolOGL> mTexturePool;
 
+  nsTArray<RefPtr<CompositingRenderTargetOGL>> mFilterTargetPool;
+
   ContextStateTrackerOGL mContextStateTracker;
 
   bool mDestroyed;
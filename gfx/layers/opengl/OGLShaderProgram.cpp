@@ -13,6 +13,7 @@
 #include "prenv.h"                      // for PR_GetEnv
 #include "Layers.h"
 #include "GLContext.h"
+#include "GLProgramBinaryCache.h"
 
 struct gfxRGBA;
 
@@ -487,16 +488,29 @@ bool
 ShaderProgramOGL::CreateProgram(const char *aVertexShaderString,
                                 const char *aFragmentShaderString)
 {
+  GLint result = mGL->fCreateProgram();
+
+  // Replaying a cached driver binary skips shader compilation entirely,
+  // which takes seconds per program on some embedded GL compilers.
+  if (gl::GLProgramBinaryCache::LoadProgram(mGL, result,
+                                            aVertexShaderString,
+                                            aFragmentShaderString)) {
+    mProgram = result;
+    return true;
+  }
+
   GLuint vertexShader = CreateShader(LOCAL_GL_VERTEX_SHADER, aVertexShaderString);
   GLuint fragmentShader = CreateShader(LOCAL_GL_FRAGMENT_SHADER, aFragmentShaderString);
 
-  if (!vertexShader || !fragmentShader)
+  if (!vertexShader || !fragmentShader) {
+    mGL->fDeleteProgram(result);
     return false;
+  }
 
-  GLint result = mGL->fCreateProgram();
   mGL->fAttachShader(result, vertexShader);
   mGL->fAttachShader(result, fragmentShader);
 
+  gl::GLProgramBinaryCache::SetRetrievableHint(mGL, result);
   mGL->fLinkProgram(result);
 
   GLint success, len;
@@ -536,6 +550,9 @@ ShaderProgramOGL::CreateProgram(const char *aVertexShaderString,
     return false;
   }
 
+  gl::GLProgramBinaryCache::SaveProgram(mGL, result, aVertexShaderString,
+                                        aFragmentShaderString);
+
   mProgram = result;
   return true;
 }
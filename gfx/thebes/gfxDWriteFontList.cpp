@@ -515,6 +515,12 @@ gfxDWriteFontEntry::ReadCMAP(FontInfoData *aFontInfoData)
         return NS_OK;
     }
 
+    gfxPlatformFontList *pfl = gfxPlatformFontList::PlatformFontList();
+    uint32_t cachedFlags;
+    if (pfl->GetCachedFontCmap(this, &cachedFlags)) {
+        return NS_OK;
+    }
+
     nsRefPtr<gfxCharacterMap> charmap;
     nsresult rv;
     bool symbolFont;
@@ -552,8 +558,8 @@ gfxDWriteFontEntry::ReadCMAP(FontInfoData *aFontInfoData)
             charmap->clear(0x25b6);
             charmap->clear(0x25c0);
         }
-        gfxPlatformFontList *pfl = gfxPlatformFontList::PlatformFontList();
         mCharacterMap = pfl->FindCharMap(charmap);
+        pfl->CacheFontCmap(this, 0);
     } else {
         // if error occurred, initialize to null cmap
         mCharacterMap = new gfxCharacterMap();
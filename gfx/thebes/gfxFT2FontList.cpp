@@ -465,6 +465,12 @@ FT2FontEntry::ReadCMAP(FontInfoData *aFontInfoData)
         return NS_OK;
     }
 
+    gfxPlatformFontList* pfl = gfxPlatformFontList::PlatformFontList();
+    uint32_t cachedFlags;
+    if (pfl->GetCachedFontCmap(this, &cachedFlags)) {
+        return NS_OK;
+    }
+
     nsRefPtr<gfxCharacterMap> charmap = new gfxCharacterMap();
 
     AutoFallibleTArray<uint8_t,16384> buffer;
@@ -511,8 +517,8 @@ FT2FontEntry::ReadCMAP(FontInfoData *aFontInfoData)
 
     mHasCmapTable = NS_SUCCEEDED(rv);
     if (mHasCmapTable) {
-        gfxPlatformFontList *pfl = gfxPlatformFontList::PlatformFontList();
         mCharacterMap = pfl->FindCharMap(charmap);
+        pfl->CacheFontCmap(this, 0);
     } else {
         // if error occurred, initialize to null cmap
         mCharacterMap = new gfxCharacterMap();
@@ -167,7 +167,7 @@ gfxFontCache::Shutdown()
 }
 
 gfxFontCache::gfxFontCache()
-    : nsExpirationTracker<gfxFont,3>(FONT_TIMEOUT_SECONDS * 1000)
+    : nsIntrusiveExpirationTracker<gfxFont,3>(FONT_TIMEOUT_SECONDS * 1000)
 {
     nsCOMPtr<nsIObserverService> obs = GetObserverService();
     if (obs) {
@@ -823,6 +823,22 @@ gfxFont::AgeCacheEntry(CacheHashEntry *aEntry, void *aUserData)
     return PL_DHASH_NEXT;
 }
 
+/*static*/
+PLDHashOperator
+gfxFont::DiscardUnusedCacheEntry(CacheHashEntry *aEntry, void *aUserData)
+{
+    if (!aEntry->mShapedWord) {
+        NS_ASSERTION(aEntry->mShapedWord, "cache entry has no gfxShapedWord!");
+        return PL_DHASH_REMOVE;
+    }
+    // Words with a zero age have been looked up since the last aging pass;
+    // they are the working set that it pays to keep shaped.
+    if (aEntry->mShapedWord->GetAge() > 0) {
+        return PL_DHASH_REMOVE;
+    }
+    return PL_DHASH_NEXT;
+}
+
 static void
 CollectLookupsByFeature(hb_face_t *aFace, hb_tag_t aTableTag,
                         uint32_t aFeatureIndex, hb_set_t *aLookups)
@@ -2327,12 +2343,20 @@ gfxFont::GetShapedWord(gfxContext *aContext,
                        uint32_t    aFlags,
                        gfxTextPerfMetrics *aTextPerf GFX_MAYBE_UNUSED)
 {
-    // if the cache is getting too big, flush it and start over
+    // If the cache is getting too big, drop the words that haven't been
+    // looked up since the last aging pass, so that the recently-used
+    // working set keeps its shaping across reflows. Only if that doesn't
+    // get us back under the limit (i.e. everything is recent) do we flush
+    // the lot.
     uint32_t wordCacheMaxEntries =
         gfxPlatform::GetPlatform()->WordCacheMaxEntries();
     if (mWordCache->Count() > wordCacheMaxEntries) {
-        NS_WARNING("flushing shaped-word cache");
-        ClearCachedWords();
+        NS_WARNING("trimming shaped-word cache");
+        mWordCache->EnumerateEntries(DiscardUnusedCacheEntry, nullptr);
+        if (mWordCache->Count() > wordCacheMaxEntries) {
+            NS_WARNING("flushing shaped-word cache");
+            ClearCachedWords();
+        }
     }
 
     // if there's a cached entry for this word, just return it
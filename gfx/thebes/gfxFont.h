@@ -262,7 +262,8 @@ struct FontCacheSizes {
     size_t mShapedWords; // memory used by the per-font shapedWord caches
 };
 
-class gfxFontCache MOZ_FINAL : public nsExpirationTracker<gfxFont,3> {
+class gfxFontCache MOZ_FINAL
+    : public nsIntrusiveExpirationTracker<gfxFont,3> {
 public:
     enum {
         FONT_TIMEOUT_SECONDS = 10,
@@ -1219,6 +1220,9 @@ public:
     uint32_t IncrementAge() {
         return ++mAgeCounter;
     }
+    uint32_t GetAge() const {
+        return mAgeCounter;
+    }
 
     // Helper used when hashing a word for the shaped-word caches
     static uint32_t HashMix(uint32_t aHash, char16_t aCh)
@@ -1273,7 +1277,7 @@ class GlyphBufferAzure;
 struct TextRunDrawParams;
 struct FontDrawParams;
 
-class gfxFont {
+class gfxFont : public mozilla::LinkedListElement<gfxFont> {
 
     friend class gfxHarfBuzzShaper;
     friend class gfxGraphiteShaper;
@@ -1998,6 +2002,8 @@ protected:
     nsAutoPtr<nsTHashtable<CacheHashEntry> > mWordCache;
 
     static PLDHashOperator AgeCacheEntry(CacheHashEntry *aEntry, void *aUserData);
+    static PLDHashOperator DiscardUnusedCacheEntry(CacheHashEntry *aEntry,
+                                                   void *aUserData);
     static const uint32_t  kShapedWordCacheMaxAge = 3;
 
     bool                       mIsValid;
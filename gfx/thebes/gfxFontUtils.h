@@ -265,7 +265,69 @@ public:
     void reset() {
         uint32_t i;
         for (i = 0; i < mBlocks.Length(); i++)
-            mBlocks[i] = nullptr;    
+            mBlocks[i] = nullptr;
+    }
+
+    // append a compact serialized copy of the bitset to aOutput: a count of
+    // present blocks followed by (block index, block bits) pairs. The data
+    // is host-endian; it is only meant to be read back on the same machine
+    // (e.g. by the persistent cmap cache).
+    void Serialize(nsTArray<uint8_t>& aOutput) const {
+        uint32_t presentBlocks = 0;
+        for (uint32_t i = 0; i < mBlocks.Length(); ++i) {
+            if (mBlocks[i]) {
+                presentBlocks++;
+            }
+        }
+        aOutput.AppendElements(reinterpret_cast<const uint8_t*>(&presentBlocks),
+                               sizeof(presentBlocks));
+        for (uint32_t i = 0; i < mBlocks.Length(); ++i) {
+            if (!mBlocks[i]) {
+                continue;
+            }
+            aOutput.AppendElements(reinterpret_cast<const uint8_t*>(&i),
+                                   sizeof(i));
+            aOutput.AppendElements(mBlocks[i]->mBits, BLOCK_SIZE);
+        }
+    }
+
+    // initialize the bitset from data written by Serialize(); returns false
+    // and leaves the bitset empty if the data is malformed
+    bool Deserialize(const uint8_t* aData, uint32_t aLength) {
+        NS_ASSERTION(mBlocks.IsEmpty(), "bitset should be empty");
+        if (aLength < sizeof(uint32_t)) {
+            return false;
+        }
+        uint32_t presentBlocks;
+        memcpy(&presentBlocks, aData, sizeof(presentBlocks));
+        const uint32_t entrySize = sizeof(uint32_t) + BLOCK_SIZE;
+        if ((aLength - sizeof(uint32_t)) / entrySize < presentBlocks) {
+            return false;
+        }
+        const uint8_t* data = aData + sizeof(uint32_t);
+        for (uint32_t n = 0; n < presentBlocks; ++n) {
+            uint32_t blockIndex;
+            memcpy(&blockIndex, data, sizeof(blockIndex));
+            data += sizeof(blockIndex);
+            // reject indices beyond the Unicode range
+            if (blockIndex >= 0x110000 / BLOCK_SIZE_BITS) {
+                mBlocks.Clear();
+                return false;
+            }
+            if (blockIndex >= mBlocks.Length()) {
+                nsAutoPtr<Block> *blocks =
+                    mBlocks.AppendElements(blockIndex + 1 - mBlocks.Length());
+                if (MOZ_UNLIKELY(!blocks)) { // OOM
+                    mBlocks.Clear();
+                    return false;
+                }
+            }
+            Block *block = new Block;
+            memcpy(block->mBits, data, BLOCK_SIZE);
+            data += BLOCK_SIZE;
+            mBlocks[blockIndex] = block;
+        }
+        return true;
     }
 
     // set this bitset to the union of its current contents and another
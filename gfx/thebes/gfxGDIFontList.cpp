@@ -142,6 +142,9 @@ GDIFontEntry::GDIFontEntry(const nsAString& aFaceName,
     InitLogFont(aFaceName, aFontType);
 }
 
+// flag we persist alongside the cmap in the font cmap cache
+static const uint32_t kCmapCacheFlagSymbolFont = 1 << 0;
+
 nsresult
 GDIFontEntry::ReadCMAP(FontInfoData *aFontInfoData)
 {
@@ -160,6 +163,13 @@ GDIFontEntry::ReadCMAP(FontInfoData *aFontInfoData)
         return NS_ERROR_FAILURE;
     }
 
+    gfxPlatformFontList *pfl = gfxPlatformFontList::PlatformFontList();
+    uint32_t cachedFlags;
+    if (pfl->GetCachedFontCmap(this, &cachedFlags)) {
+        mSymbolFont = (cachedFlags & kCmapCacheFlagSymbolFont) != 0;
+        return NS_OK;
+    }
+
     nsRefPtr<gfxCharacterMap> charmap;
     nsresult rv;
     bool unicodeFont = false, symbolFont = false;
@@ -185,8 +195,9 @@ GDIFontEntry::ReadCMAP(FontInfoData *aFontInfoData)
 
     mHasCmapTable = NS_SUCCEEDED(rv);
     if (mHasCmapTable) {
-        gfxPlatformFontList *pfl = gfxPlatformFontList::PlatformFontList();
         mCharacterMap = pfl->FindCharMap(charmap);
+        pfl->CacheFontCmap(this,
+                           mSymbolFont ? kCmapCacheFlagSymbolFont : 0);
     } else {
         // if error occurred, initialize to null cmap
         mCharacterMap = new gfxCharacterMap();
@@ -154,6 +154,9 @@ static NSString* GetNSStringForString(const nsAString& aSrc)
 // cmap-masking on other platforms to avoid using fonts that won't shape
 // properly.
 
+// flag we persist alongside the cmap in the font cmap cache
+static const uint32_t kCmapCacheFlagRequiresAAT = 1 << 0;
+
 nsresult
 MacOSFontEntry::ReadCMAP(FontInfoData *aFontInfoData)
 {
@@ -162,6 +165,13 @@ MacOSFontEntry::ReadCMAP(FontInfoData *aFontInfoData)
         return NS_OK;
     }
 
+    gfxPlatformFontList* pfl = gfxPlatformFontList::PlatformFontList();
+    uint32_t cachedFlags;
+    if (pfl->GetCachedFontCmap(this, &cachedFlags)) {
+        mRequiresAAT = (cachedFlags & kCmapCacheFlagRequiresAAT) != 0;
+        return NS_OK;
+    }
+
     nsRefPtr<gfxCharacterMap> charmap;
     nsresult rv;
     bool symbolFont;
@@ -231,8 +241,9 @@ MacOSFontEntry::ReadCMAP(FontInfoData *aFontInfoData)
 
     mHasCmapTable = NS_SUCCEEDED(rv);
     if (mHasCmapTable) {
-        gfxPlatformFontList *pfl = gfxPlatformFontList::PlatformFontList();
         mCharacterMap = pfl->FindCharMap(charmap);
+        pfl->CacheFontCmap(this,
+                           mRequiresAAT ? kCmapCacheFlagRequiresAAT : 0);
     } else {
         // if error occurred, initialize to null cmap
         mCharacterMap = new gfxCharacterMap();
@@ -74,6 +74,7 @@
 #include "nsCRT.h"
 #include "GLContext.h"
 #include "GLContextProvider.h"
+#include "GLProgramBinaryCache.h"
 #include "mozilla/gfx/Logging.h"
 
 #ifdef MOZ_WIDGET_ANDROID
@@ -482,6 +483,10 @@ gfxPlatform::Init()
     mozilla::gl::GLContext::StaticInit();
 #endif
 
+    // Resolve the shader cache directory while we are still on the main
+    // thread; the compositor reads and writes entries from its own thread.
+    mozilla::gl::GLProgramBinaryCache::InitDirectory();
+
     InitLayersIPC();
 
     nsresult rv;
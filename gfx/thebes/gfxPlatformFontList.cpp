@@ -20,6 +20,8 @@
 #include "mozilla/Telemetry.h"
 #include "mozilla/TimeStamp.h"
 #include "mozilla/gfx/2D.h"
+#include "mozilla/scache/StartupCache.h"
+#include "nsXULAppAPI.h"
 
 using namespace mozilla;
 
@@ -167,6 +169,8 @@ gfxPlatformFontList::MemoryReporter::CollectReports(
 gfxPlatformFontList::gfxPlatformFontList(bool aNeedFullnamePostscriptNames)
     : mFontFamilies(64), mOtherFamilyNames(16),
       mPrefFonts(8), mBadUnderlineFamilyNames(8), mSharedCmaps(8),
+      mCmapCacheInitialized(false), mCmapCacheDirty(false),
+      mCmapCacheWritten(false),
       mStartIndex(0), mIncrement(1), mNumFamilies(0)
 {
     mOtherFamilyNamesInitialized = false;
@@ -190,6 +194,8 @@ gfxPlatformFontList::gfxPlatformFontList(bool aNeedFullnamePostscriptNames)
 
 gfxPlatformFontList::~gfxPlatformFontList()
 {
+    // catch any cmaps recorded since the font info loader finished
+    WriteCmapCache();
     mSharedCmaps.Clear();
     NS_ASSERTION(gFontListPrefObserver, "There is no font list pref observer");
     Preferences::RemoveObservers(gFontListPrefObserver, kObservedPrefs);
@@ -895,6 +901,194 @@ gfxPlatformFontList::RemoveCmap(const gfxCharacterMap* aCharMap)
     }
 }
 
+#define CMAP_CACHE_KEY "font.cmap.cache"
+
+// Bump this when the serialized format or any of the post-processing done
+// by the ReadCMAP implementations (e.g. complex-script masking) changes,
+// so that stale snapshots are discarded.
+static const uint32_t kCmapCacheVersion = 1;
+
+static void
+AppendUint32(nsTArray<uint8_t>& aOutput, uint32_t aValue)
+{
+    aOutput.AppendElements(reinterpret_cast<const uint8_t*>(&aValue),
+                           sizeof(aValue));
+}
+
+static bool
+ReadUint32(const uint8_t*& aData, const uint8_t* aEnd, uint32_t* aValue)
+{
+    if (aEnd - aData < ptrdiff_t(sizeof(uint32_t))) {
+        return false;
+    }
+    memcpy(aValue, aData, sizeof(uint32_t));
+    aData += sizeof(uint32_t);
+    return true;
+}
+
+void
+gfxPlatformFontList::EnsureCmapCacheInitialized()
+{
+    if (mCmapCacheInitialized) {
+        return;
+    }
+    mCmapCacheInitialized = true;
+
+    scache::StartupCache* cache = scache::StartupCache::GetSingleton();
+    if (!cache) {
+        return;
+    }
+
+    uint32_t size;
+    char* buf;
+    if (NS_FAILED(cache->GetBuffer(CMAP_CACHE_KEY, &buf, &size))) {
+        return;
+    }
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(buf);
+    const uint8_t* end = data + size;
+    uint32_t version, familyCount, entryCount;
+    if (!ReadUint32(data, end, &version) ||
+        !ReadUint32(data, end, &familyCount) ||
+        !ReadUint32(data, end, &entryCount) ||
+        version != kCmapCacheVersion ||
+        // Cheap invalidation check: if fonts have been installed or removed
+        // since the snapshot was written, throw it away and rebuild. This
+        // does not catch a font file replaced in place under the same face
+        // name; such fonts keep their old cmap until the family count
+        // changes or the startup cache is invalidated.
+        familyCount != uint32_t(mFontFamilies.Count())) {
+        free(buf);
+        return;
+    }
+
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        uint32_t keyLen, uvsOffset, flags, dataLen;
+        if (!ReadUint32(data, end, &keyLen) ||
+            end - data < ptrdiff_t(keyLen)) {
+            break;
+        }
+        NS_ConvertUTF8toUTF16 key(reinterpret_cast<const char*>(data), keyLen);
+        data += keyLen;
+        if (!ReadUint32(data, end, &uvsOffset) ||
+            !ReadUint32(data, end, &flags) ||
+            !ReadUint32(data, end, &dataLen) ||
+            end - data < ptrdiff_t(dataLen)) {
+            break;
+        }
+        CmapCacheEntry* entry = new CmapCacheEntry();
+        entry->mUVSOffset = uvsOffset;
+        entry->mFlags = flags;
+        entry->mCmapData.AppendElements(data, dataLen);
+        data += dataLen;
+        mCmapCache.Put(key, entry);
+    }
+
+    free(buf);
+}
+
+bool
+gfxPlatformFontList::GetCachedFontCmap(gfxFontEntry* aFontEntry,
+                                       uint32_t* aFlags)
+{
+    EnsureCmapCacheInitialized();
+
+    CmapCacheEntry* entry = mCmapCache.Get(aFontEntry->Name());
+    if (!entry) {
+        return false;
+    }
+
+    nsRefPtr<gfxCharacterMap> charmap = new gfxCharacterMap();
+    if (!charmap->Deserialize(entry->mCmapData.Elements(),
+                              entry->mCmapData.Length())) {
+        // bad data; drop the entry and reparse the font
+        mCmapCache.Remove(aFontEntry->Name());
+        return false;
+    }
+
+    aFontEntry->mUVSOffset = entry->mUVSOffset;
+    aFontEntry->mHasCmapTable = true;
+    aFontEntry->mCharacterMap = FindCharMap(charmap);
+    *aFlags = entry->mFlags;
+
+#ifdef PR_LOGGING
+    LOG_FONTLIST(("(fontlist-cmapcache) hit for (%s)\n",
+                  NS_ConvertUTF16toUTF8(aFontEntry->Name()).get()));
+#endif
+
+    return true;
+}
+
+void
+gfxPlatformFontList::CacheFontCmap(gfxFontEntry* aFontEntry, uint32_t aFlags)
+{
+    EnsureCmapCacheInitialized();
+
+    if (XRE_GetProcessType() != GeckoProcessType_Default ||
+        !aFontEntry->mCharacterMap) {
+        // only the chrome process writes the startup cache
+        return;
+    }
+
+    if (mCmapCache.Get(aFontEntry->Name())) {
+        return;
+    }
+
+    CmapCacheEntry* entry = new CmapCacheEntry();
+    entry->mUVSOffset = aFontEntry->mUVSOffset;
+    entry->mFlags = aFlags;
+    aFontEntry->mCharacterMap->Serialize(entry->mCmapData);
+    mCmapCache.Put(aFontEntry->Name(), entry);
+    mCmapCacheDirty = true;
+}
+
+/*static*/ PLDHashOperator
+gfxPlatformFontList::WriteCmapCacheEntry(const nsAString& aKey,
+                                         CmapCacheEntry* aEntry,
+                                         void* aUserArg)
+{
+    nsTArray<uint8_t>* buf = static_cast<nsTArray<uint8_t>*>(aUserArg);
+    NS_ConvertUTF16toUTF8 key(aKey);
+    AppendUint32(*buf, key.Length());
+    buf->AppendElements(reinterpret_cast<const uint8_t*>(key.get()),
+                        key.Length());
+    AppendUint32(*buf, aEntry->mUVSOffset);
+    AppendUint32(*buf, aEntry->mFlags);
+    AppendUint32(*buf, aEntry->mCmapData.Length());
+    buf->AppendElements(aEntry->mCmapData);
+    return PL_DHASH_NEXT;
+}
+
+void
+gfxPlatformFontList::WriteCmapCache()
+{
+    if (!mCmapCacheDirty || mCmapCacheWritten) {
+        return;
+    }
+    mCmapCacheDirty = false;
+    mCmapCacheWritten = true;
+
+    scache::StartupCache* cache = scache::StartupCache::GetSingleton();
+    if (!cache) {
+        return;
+    }
+
+    nsTArray<uint8_t> buf;
+    AppendUint32(buf, kCmapCacheVersion);
+    AppendUint32(buf, mFontFamilies.Count());
+    AppendUint32(buf, mCmapCache.Count());
+    mCmapCache.EnumerateRead(WriteCmapCacheEntry, &buf);
+
+    cache->PutBuffer(CMAP_CACHE_KEY,
+                     reinterpret_cast<const char*>(buf.Elements()),
+                     buf.Length());
+
+#ifdef PR_LOGGING
+    LOG_FONTLIST(("(fontlist-cmapcache) wrote %d cmaps (%d bytes)\n",
+                  mCmapCache.Count(), int(buf.Length())));
+#endif
+}
+
 static PLDHashOperator AppendFamilyToList(nsStringHashKey::KeyType aKey,
                                           nsRefPtr<gfxFontFamily>& aFamilyEntry,
                                           void *aUserArg)
@@ -1066,6 +1260,10 @@ gfxPlatformFontList::CleanupLoader()
     }
 #endif
 
+    // the loader has read every family's cmaps, so this is the natural
+    // point to persist them for the next startup
+    WriteCmapCache();
+
     gfxFontInfoLoader::CleanupLoader();
 }
 
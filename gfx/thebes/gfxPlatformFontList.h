@@ -6,6 +6,7 @@
 #ifndef GFXPLATFORMFONTLIST_H_
 #define GFXPLATFORMFONTLIST_H_
 
+#include "nsClassHashtable.h"
 #include "nsDataHashtable.h"
 #include "nsRefPtrHashtable.h"
 #include "nsTHashtable.h"
@@ -182,6 +183,17 @@ public:
     // remove the cmap from the shared cmap set
     void RemoveCmap(const gfxCharacterMap *aCharMap);
 
+    // look up aFontEntry's character map in the persistent cmap cache;
+    // on a hit, initializes the entry's cmap fields and returns in aFlags
+    // any flags the platform recorded with CacheFontCmap
+    bool GetCachedFontCmap(gfxFontEntry *aFontEntry, uint32_t *aFlags);
+
+    // record a freshly parsed character map in the persistent cmap cache
+    // so later startups can skip reading the font. aFlags is opaque to the
+    // cache; platforms use it to persist entry state computed alongside the
+    // cmap (e.g. symbol-font or AAT-layout flags)
+    void CacheFontCmap(gfxFontEntry *aFontEntry, uint32_t aFlags);
+
     // keep track of userfont sets to notify when global fontlist changes occur
     void AddUserFontSet(gfxUserFontSet *aUserFontSet) {
         mUserFontSetList.PutEntry(aUserFontSet);
@@ -287,6 +299,28 @@ protected:
     // for font list changes that affect all documents
     void ForceGlobalReflow();
 
+    // a character map as stored in the persistent cmap cache: the
+    // serialized gfxSparseBitSet plus the other ReadCMAP outputs
+    struct CmapCacheEntry {
+        CmapCacheEntry() : mUVSOffset(0), mFlags(0) {}
+        uint32_t mUVSOffset;
+        uint32_t mFlags;
+        nsTArray<uint8_t> mCmapData;
+    };
+
+    // load the persistent cmap cache from the startup cache, if present
+    // and still valid for the current font list
+    void EnsureCmapCacheInitialized();
+
+    // write the cmap cache back to the startup cache if new entries have
+    // been recorded since it was loaded
+    void WriteCmapCache();
+
+    static PLDHashOperator
+        WriteCmapCacheEntry(const nsAString& aKey,
+                            CmapCacheEntry* aEntry,
+                            void* aUserArg);
+
     // used by memory reporter to accumulate sizes of family names in the hash
     static size_t
     SizeOfFamilyNameEntryExcludingThis(const nsAString&               aKey,
@@ -344,6 +378,15 @@ protected:
     // contains weak ptrs to cmaps shared by font entry objects
     nsTHashtable<CharMapHashKey> mSharedCmaps;
 
+    // font entry name ==> character map data, persisted via the startup
+    // cache so that later startups can skip parsing cmap tables
+    nsClassHashtable<nsStringHashKey, CmapCacheEntry> mCmapCache;
+    bool mCmapCacheInitialized;
+    bool mCmapCacheDirty;
+    // the startup cache does not allow replacing an entry, so write at most
+    // once per session
+    bool mCmapCacheWritten;
+
     // data used as part of the font cmap loading process
     nsTArray<nsRefPtr<gfxFontFamily> > mFontFamiliesToLoad;
     uint32_t mStartIndex;
@@ -83,6 +83,12 @@ METHODDEF(void) my_error_exit (j_common_ptr cinfo);
 // Normal JFIF markers can't have more bytes than this.
 #define MAX_JPEG_MARKER_LENGTH  (((uint32_t)1 << 16) - 1)
 
+// Once this many progressive output passes have been displayed, later
+// refinement scans make no perceptible difference, so we stop rendering
+// intermediate passes and produce the remaining refinements in a single
+// pass once the whole image has arrived.
+#define MAX_DISPLAYED_PROGRESSIVE_PASSES 4
+
 
 nsJPEGDecoder::nsJPEGDecoder(RasterImage& aImage,
                              Decoder::DecodeStyle aDecodeStyle)
@@ -104,6 +110,9 @@ nsJPEGDecoder::nsJPEGDecoder(RasterImage& aImage,
   mBackBuffer = nullptr;
   mBackBufferLen = mBackBufferSize = mBackBufferUnreadLen = 0;
 
+  mLastDisplayedScan = 0;
+  mDisplayedPassCount = 0;
+
   mInProfile = nullptr;
   mTransform = nullptr;
 
@@ -238,8 +247,11 @@ nsJPEGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount,
         return; // I/O suspension
       }
 
-      int sampleSize = mImage.GetRequestedSampleSize();
-      if (sampleSize > 0) {
+      // Downscale during decode via libjpeg's IDCT scaling if a smaller
+      // surface was negotiated.
+      int sampleSize = GetDecodeDownscale(nsIntSize(mInfo.image_width,
+                                                    mInfo.image_height));
+      if (sampleSize > 1) {
         mInfo.scale_num = 1;
         mInfo.scale_denom = sampleSize;
       }
@@ -474,12 +486,29 @@ nsJPEGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount,
               (status != JPEG_REACHED_EOI))
             scan--;
 
+          // Every output pass re-runs upsampling and color conversion for
+          // the whole image, which dominates decode cost on progressive
+          // JPEGs. Unless this is the final pass, don't re-render a scan
+          // we've already displayed just because more refinement bits for
+          // it arrived, and once enough passes have been shown that further
+          // refinements aren't visible, defer the rest to a single pass
+          // when the image is complete.
+          if ((status != JPEG_REACHED_EOI) &&
+              ((scan <= mLastDisplayedScan) ||
+               (mDisplayedPassCount >= MAX_DISPLAYED_PROGRESSIVE_PASSES))) {
+            PR_LOG(GetJPEGDecoderAccountingLog(), PR_LOG_DEBUG,
+                   ("} (deferring output pass for scan %d - PROGRESSIVE)",
+                    scan));
+            return; // wait for more data
+          }
+
           if (!jpeg_start_output(&mInfo, scan)) {
             PR_LOG(GetJPEGDecoderAccountingLog(), PR_LOG_DEBUG,
                    ("} (I/O suspension after jpeg_start_output() -"
                     " PROGRESSIVE)"));
             return; // I/O suspension
           }
+          mLastDisplayedScan = scan;
         }
 
         if (mInfo.output_scanline == 0xffffff) {
@@ -507,6 +536,7 @@ nsJPEGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount,
                     " PROGRESSIVE)"));
             return; // I/O suspension
           }
+          mDisplayedPassCount++;
 
           if (jpeg_input_complete(&mInfo) &&
               (mInfo.input_scan_number == mInfo.output_scan_number))
@@ -91,6 +91,9 @@ public:
 
   bool mReading;
 
+  int mLastDisplayedScan;         // Highest scan we've run an output pass for
+  uint32_t mDisplayedPassCount;   // Number of completed output passes so far
+
   const Decoder::DecodeStyle mDecodeStyle;
 
   uint32_t mCMSMode;
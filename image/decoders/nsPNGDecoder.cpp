@@ -52,6 +52,10 @@ GetPNGDecoderAccountingLog()
 #define WIDTH_OFFSET 16
 #define HEIGHT_OFFSET (WIDTH_OFFSET + 4)
 #define BYTES_NEEDED_FOR_DIMENSIONS (HEIGHT_OFFSET + 4)
+// The IHDR interlace byte follows the bit depth, color type, compression
+// method and filter method bytes.
+#define INTERLACE_OFFSET (BYTES_NEEDED_FOR_DIMENSIONS + 4)
+#define BYTES_NEEDED_FOR_INTERLACE (INTERLACE_OFFSET + 1)
 
 nsPNGDecoder::AnimFrameInfo::AnimFrameInfo()
  : mDispose(FrameBlender::kDisposeKeep)
@@ -112,7 +116,13 @@ nsPNGDecoder::nsPNGDecoder(RasterImage& aImage)
    mPNG(nullptr), mInfo(nullptr),
    mCMSLine(nullptr), interlacebuf(nullptr),
    mInProfile(nullptr), mTransform(nullptr),
-   mHeaderBytesRead(0), mCMSMode(0),
+   mHeaderBytesRead(0),
+   mSizeInterlaceByte(0), mSizeDownscale(0),
+   mChunkHeaderRead(0), mChunkSkipRemaining(0),
+   mCMSMode(0),
+   mDownscale(1), mDownscaleSrcRow(nullptr),
+   mDownscaleAccum(nullptr),
+   mDownscaleRowsAccumulated(0), mDownscaleOutputRow(0),
    mChannels(0), mFrameIsHidden(false),
    mDisablePremultipliedAlpha(false),
    mNumFrames(0)
@@ -130,6 +140,12 @@ nsPNGDecoder::~nsPNGDecoder()
   if (interlacebuf) {
     nsMemory::Free(interlacebuf);
   }
+  if (mDownscaleSrcRow) {
+    nsMemory::Free(mDownscaleSrcRow);
+  }
+  if (mDownscaleAccum) {
+    nsMemory::Free(mDownscaleAccum);
+  }
   if (mInProfile) {
     qcms_profile_release(mInProfile);
 
@@ -329,15 +345,15 @@ nsPNGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount,
   if (IsSizeDecode()) {
 
     // Are we done?
-    if (mHeaderBytesRead == BYTES_NEEDED_FOR_DIMENSIONS) {
+    if (HasSize()) {
       return;
     }
 
-    // Scan the header for the width and height bytes
+    // Scan the header for the width, height and interlace bytes
     uint32_t pos = 0;
     const uint8_t* bptr = (uint8_t*)aBuffer;
 
-    while (pos < aCount && mHeaderBytesRead < BYTES_NEEDED_FOR_DIMENSIONS) {
+    while (pos < aCount && mHeaderBytesRead < BYTES_NEEDED_FOR_INTERLACE) {
       // Verify the signature bytes
       if (mHeaderBytesRead < sizeof(pngSignatureBytes)) {
         if (bptr[pos] != nsPNGDecoder::pngSignatureBytes[mHeaderBytesRead]) {
@@ -351,12 +367,21 @@ nsPNGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount,
           (mHeaderBytesRead < BYTES_NEEDED_FOR_DIMENSIONS)) {
         mSizeBytes[mHeaderBytesRead - WIDTH_OFFSET] = bptr[pos];
       }
+      if (mHeaderBytesRead == INTERLACE_OFFSET) {
+        mSizeInterlaceByte = bptr[pos];
+      }
       pos ++;
       mHeaderBytesRead ++;
     }
 
-    // If we're done now, verify the data and set up the container
-    if (mHeaderBytesRead == BYTES_NEEDED_FOR_DIMENSIONS) {
+    if (mHeaderBytesRead < BYTES_NEEDED_FOR_INTERLACE) {
+      return;
+    }
+
+    // Verify the data and compute the size we will post. The size we post
+    // here must match what info_callback posts on the full decode, so the
+    // downscale negotiation has to be mirrored exactly.
+    if (mSizeDownscale == 0) {
 
       // Grab the width and height, accounting for endianness (thanks libpng!)
       uint32_t width = png_get_uint_32(mSizeBytes);
@@ -368,8 +393,55 @@ nsPNGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount,
         return;
       }
 
-      // Post our size to the superclass
-      PostSize(width, height);
+      mSizeIntrinsic = nsIntSize(width, height);
+      mSizeDownscale = 1;
+      if (mSizeInterlaceByte == PNG_INTERLACE_NONE) {
+        mSizeDownscale = std::min(GetDecodeDownscale(mSizeIntrinsic), 4096);
+      }
+
+      if (mSizeDownscale == 1) {
+        // Common case: no downscale applies, so the full size is final.
+        PostSize(width, height);
+        return;
+      }
+
+      // A downscale is pending, but it only applies if the image isn't
+      // animated, so scan the chunks between IHDR and IDAT for acTL.
+      // Start by skipping the IHDR CRC.
+      mChunkSkipRemaining = 4;
+    }
+
+    while (pos < aCount) {
+      if (mChunkSkipRemaining > 0) {
+        uint32_t skip = std::min(mChunkSkipRemaining, aCount - pos);
+        pos += skip;
+        mChunkSkipRemaining -= skip;
+        continue;
+      }
+
+      mChunkHeader[mChunkHeaderRead++] = bptr[pos++];
+      if (mChunkHeaderRead < sizeof(mChunkHeader)) {
+        continue;
+      }
+      mChunkHeaderRead = 0;
+
+      uint32_t chunkLength = png_get_uint_32(mChunkHeader);
+      const uint8_t* chunkType = mChunkHeader + 4;
+
+#ifdef PNG_APNG_SUPPORTED
+      if (!memcmp(chunkType, "acTL", 4)) {
+        // Animated images keep their full size; see info_callback.
+        mSizeDownscale = 1;
+      }
+#endif
+      if (mSizeDownscale == 1 || !memcmp(chunkType, "IDAT", 4)) {
+        PostSize((mSizeIntrinsic.width + mSizeDownscale - 1) / mSizeDownscale,
+                 (mSizeIntrinsic.height + mSizeDownscale - 1) / mSizeDownscale);
+        return;
+      }
+
+      // Skip this chunk's data and CRC.
+      mChunkSkipRemaining = chunkLength + 4;
     }
 
   // Otherwise, we're doing a standard decode
@@ -543,8 +615,28 @@ nsPNGDecoder::info_callback(png_structp png_ptr, png_infop info_ptr)
     png_longjmp(decoder->mPNG, 1);
   }
 
+  // Negotiate downscale-during-decode. Interlaced and animated images still
+  // decode at full size: Adam7 passes and APNG subframes don't lend
+  // themselves to streaming box-filter accumulation.
+  bool isAnimated = false;
+#ifdef PNG_APNG_SUPPORTED
+  isAnimated = png_get_valid(png_ptr, info_ptr, PNG_INFO_acTL);
+#endif
+  int32_t downscale = 1;
+  if (interlace_type != PNG_INTERLACE_ADAM7 && !isAnimated) {
+    downscale = decoder->GetDecodeDownscale(nsIntSize(width, height));
+    // Keep the per-channel accumulators (downscale^2 samples of up to 255
+    // each) comfortably within 32 bits.
+    downscale = std::min(downscale, 4096);
+  }
+  decoder->mDownscale = downscale;
+  decoder->mSourceSize = nsIntSize(width, height);
+
+  png_uint_32 targetWidth = (width + downscale - 1) / downscale;
+  png_uint_32 targetHeight = (height + downscale - 1) / downscale;
+
   // Post our size to the superclass
-  decoder->PostSize(width, height);
+  decoder->PostSize(targetWidth, targetHeight);
   if (decoder->HasError()) {
     // Setting the size led to an error.
     png_longjmp(decoder->mPNG, 1);
@@ -657,7 +749,7 @@ nsPNGDecoder::info_callback(png_structp png_ptr, png_infop info_ptr)
     decoder->mFrameIsHidden = true;
   } else {
 #endif
-    decoder->CreateFrame(0, 0, width, height, decoder->format);
+    decoder->CreateFrame(0, 0, targetWidth, targetHeight, decoder->format);
 #ifdef PNG_APNG_SUPPORTED
   }
 #endif
@@ -681,6 +773,16 @@ nsPNGDecoder::info_callback(png_structp png_ptr, png_infop info_ptr)
     }
   }
 
+  if (downscale > 1) {
+    decoder->mDownscaleSrcRow =
+      (uint32_t*)moz_malloc(width * sizeof(uint32_t));
+    decoder->mDownscaleAccum =
+      (uint32_t*)moz_calloc(targetWidth * 4, sizeof(uint32_t));
+    if (!decoder->mDownscaleSrcRow || !decoder->mDownscaleAccum) {
+      png_longjmp(decoder->mPNG, 5); // NS_ERROR_OUT_OF_MEMORY
+    }
+  }
+
   if (decoder->NeedsNewFrame()) {
     // We know that we need a new frame, so pause input so the decoder
     // infrastructure can give it to us.
@@ -727,13 +829,19 @@ nsPNGDecoder::row_callback(png_structp png_ptr, png_bytep new_row,
     return;
   }
 
-  if (row_num >= (png_uint_32) decoder->mFrameRect.height) {
+  bool downscaling = decoder->mDownscale > 1;
+  if (row_num >= (png_uint_32) (downscaling ? decoder->mSourceSize.height
+                                            : decoder->mFrameRect.height)) {
     return;
   }
 
   if (new_row) {
-    int32_t width = decoder->mFrameRect.width;
-    uint32_t iwidth = decoder->mFrameRect.width;
+    // When downscaling, we convert the full source row and fold it into the
+    // box-filter accumulators below; otherwise we write straight into the
+    // image data.
+    int32_t width = downscaling ? decoder->mSourceSize.width
+                                : decoder->mFrameRect.width;
+    uint32_t iwidth = width;
 
     png_bytep line = new_row;
     if (decoder->interlacebuf) {
@@ -742,7 +850,9 @@ nsPNGDecoder::row_callback(png_structp png_ptr, png_bytep new_row,
     }
 
     uint32_t bpr = width * sizeof(uint32_t);
-    uint32_t* cptr32 = (uint32_t*)(decoder->mImageData + (row_num*bpr));
+    uint32_t* cptr32 = downscaling
+      ? decoder->mDownscaleSrcRow
+      : (uint32_t*)(decoder->mImageData + (row_num*bpr));
     bool rowHasNoAlpha = true;
 
     if (decoder->mTransform) {
@@ -817,6 +927,12 @@ nsPNGDecoder::row_callback(png_structp png_ptr, png_bytep new_row,
       decoder->mFrameHasNoAlpha = false;
     }
 
+    if (downscaling) {
+      // Invalidation is posted when an output row is emitted.
+      decoder->AccumulateScaledRow(row_num);
+      return;
+    }
+
     if (decoder->mNumFrames <= 1) {
       // Only do incremental image display for the first frame
       // XXXbholley - this check should be handled in the superclass
@@ -826,6 +942,52 @@ nsPNGDecoder::row_callback(png_structp png_ptr, png_bytep new_row,
   }
 }
 
+void
+nsPNGDecoder::AccumulateScaledRow(png_uint_32 aSourceRow)
+{
+  int32_t scaledWidth = mFrameRect.width;
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(mDownscaleSrcRow);
+
+  for (int32_t x = 0; x < mSourceSize.width; ++x) {
+    uint32_t* accum = mDownscaleAccum + 4 * (x / mDownscale);
+    accum[0] += src[4 * x];
+    accum[1] += src[4 * x + 1];
+    accum[2] += src[4 * x + 2];
+    accum[3] += src[4 * x + 3];
+  }
+  mDownscaleRowsAccumulated++;
+
+  bool lastRow = aSourceRow == png_uint_32(mSourceSize.height - 1);
+  if (mDownscaleRowsAccumulated < mDownscale && !lastRow) {
+    return;
+  }
+
+  // Emit one output row: average each channel over the number of source
+  // pixels that landed in its box. The pixels are already in their final
+  // (premultiplied) form, so a straight mean is the right box filter. Edge
+  // boxes may be smaller than mDownscale in either dimension.
+  uint8_t* out = mImageData + mDownscaleOutputRow * scaledWidth *
+                 sizeof(uint32_t);
+  for (int32_t col = 0; col < scaledWidth; ++col) {
+    int32_t boxWidth =
+      std::min(mDownscale, mSourceSize.width - col * mDownscale);
+    uint32_t samples = uint32_t(boxWidth) * mDownscaleRowsAccumulated;
+    uint32_t* accum = mDownscaleAccum + 4 * col;
+    out[4 * col] = accum[0] / samples;
+    out[4 * col + 1] = accum[1] / samples;
+    out[4 * col + 2] = accum[2] / samples;
+    out[4 * col + 3] = accum[3] / samples;
+    accum[0] = accum[1] = accum[2] = accum[3] = 0;
+  }
+
+  if (mNumFrames <= 1) {
+    PostInvalidation(nsIntRect(0, mDownscaleOutputRow, scaledWidth, 1));
+  }
+
+  mDownscaleRowsAccumulated = 0;
+  mDownscaleOutputRow++;
+}
+
 #ifdef PNG_APNG_SUPPORTED
 // got the header of a new frame that's coming
 void
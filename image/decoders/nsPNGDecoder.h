@@ -37,6 +37,11 @@ public:
                    gfx::SurfaceFormat format);
   void EndImageFrame();
 
+  // Folds one converted source row (in mDownscaleSrcRow) into the box-filter
+  // accumulators, emitting an output row once enough source rows have been
+  // seen. Only called when mDownscale > 1.
+  void AccumulateScaledRow(png_uint_32 aSourceRow);
+
   // Check if PNG is valid ICO (32bpp RGBA)
   // http://blogs.msdn.com/b/oldnewthing/archive/2010/10/22/10079192.aspx
   bool IsValidICO() const
@@ -83,9 +88,28 @@ public:
   uint8_t mSizeBytes[8]; // Space for width and height, both 4 bytes
   uint32_t mHeaderBytesRead;
 
+  // For size decodes when a downscale is requested: the posted size depends
+  // on the interlace method and on whether the image is animated, so we
+  // scan the chunks between IHDR and IDAT for acTL. See WriteInternal.
+  uint8_t mSizeInterlaceByte;
+  int32_t mSizeDownscale;        // pending sample size; 0 = not yet computed
+  nsIntSize mSizeIntrinsic;
+  uint8_t mChunkHeader[8];       // length and type of the next chunk
+  uint32_t mChunkHeaderRead;
+  uint32_t mChunkSkipRemaining;  // data+CRC bytes left in the current chunk
+
   // whether CMS or premultiplied alpha are forced off
   uint32_t mCMSMode;
 
+  // Downscale-during-decode state. Only used for non-interlaced,
+  // non-animated images; see info_callback.
+  int32_t mDownscale;          // sample size; 1 means decode at full size
+  nsIntSize mSourceSize;       // pre-downscale image size
+  uint32_t* mDownscaleSrcRow;  // one converted source row of pixels
+  uint32_t* mDownscaleAccum;   // per-channel sums for one output row
+  int32_t mDownscaleRowsAccumulated;
+  int32_t mDownscaleOutputRow;
+
   uint8_t mChannels;
   bool mFrameHasNoAlpha;
   bool mFrameIsHidden;
@@ -12,6 +12,7 @@
 #include "nsCOMPtr.h"
 #include "nsIObserverService.h"
 #include "nsIThreadPool.h"
+#include "nsThreadManager.h"
 #include "nsXPCOMCIDInternal.h"
 #include "prsystem.h"
 
@@ -111,12 +112,18 @@ private:
 class DecodeWorker : public nsRunnable
 {
 public:
-  explicit DecodeWorker(RasterImage* aImage)
-    : mImage(aImage)
+  DecodeWorker()
   { }
 
   NS_IMETHOD Run() MOZ_OVERRIDE
   {
+    // Each queued image gets one worker dispatched for it, but workers
+    // pick the most important queued image rather than the one they were
+    // dispatched for, so visible images are decoded first.
+    if (!DecodePool::Singleton()->PopDecodeRequest(mImage)) {
+      return NS_OK;
+    }
+
     ReentrantMonitorAutoEnter lock(mImage->mDecodingMonitor);
 
     // If we were interrupted, we shouldn't do any work.
@@ -180,7 +187,7 @@ public:
 protected:
   virtual ~DecodeWorker()
   {
-    if (gfxPrefs::ImageMTDecodingEnabled()) {
+    if (mImage && gfxPrefs::ImageMTDecodingEnabled()) {
       // Dispatch mImage to main thread to prevent mImage from being destructed by decode thread.
       nsCOMPtr<nsIThread> mainThread = do_GetMainThread();
       NS_WARN_IF_FALSE(mainThread, "Couldn't get the main thread!");
@@ -198,14 +205,12 @@ private:
   nsRefPtr<RasterImage> mImage;
 };
 
-#ifdef MOZ_NUWA_PROCESS
-
 class RIDThreadPoolListener MOZ_FINAL : public nsIThreadPoolListener
 {
 public:
   NS_DECL_THREADSAFE_ISUPPORTS
   NS_DECL_NSITHREADPOOLLISTENER
-  
+
   RIDThreadPoolListener() { }
 
 private:
@@ -217,9 +222,15 @@ NS_IMPL_ISUPPORTS(RIDThreadPoolListener, nsIThreadPoolListener)
 NS_IMETHODIMP
 RIDThreadPoolListener::OnThreadCreated()
 {
+#ifdef MOZ_NUWA_PROCESS
     if (IsNuwaProcess()) {
         NuwaMarkCurrentThread(static_cast<void(*)(void*)>(nullptr), nullptr);
     }
+#endif
+    // Decoding is throughput work; platform policy may confine it to the
+    // cores set aside for bulk background tasks.
+    nsThreadManager::get()->SetCurrentThreadClass(
+      nsThreadManager::THREAD_CLASS_BACKGROUND_BULK);
     return NS_OK;
 }
 
@@ -229,8 +240,6 @@ RIDThreadPoolListener::OnThreadShuttingDown()
     return NS_OK;
 }
 
-#endif // MOZ_NUWA_PROCESS
-
 
 ///////////////////////////////////////////////////////////////////////////////
 // DecodePool implementation.
@@ -277,11 +286,7 @@ DecodePool::DecodePool()
       mThreadPool->SetThreadLimit(limit);
       mThreadPool->SetIdleThreadLimit(limit);
 
-#ifdef MOZ_NUWA_PROCESS
-      if (IsNuwaProcess()) {
-        mThreadPool->SetListener(new RIDThreadPoolListener());
-      }
-#endif
+      mThreadPool->SetListener(new RIDThreadPoolListener());
 
       nsCOMPtr<nsIObserverService> obsSvc = services::GetObserverService();
       if (obsSvc) {
@@ -333,9 +338,17 @@ DecodePool::RequestDecode(RasterImage* aImage)
     }
 
     aImage->mDecodeStatus = DecodeStatus::PENDING;
-    nsCOMPtr<nsIRunnable> worker = new DecodeWorker(aImage);
+    nsCOMPtr<nsIRunnable> worker = new DecodeWorker();
 
     MutexAutoLock threadPoolLock(mThreadPoolMutex);
+    // Workers pull the most important queued image, so queue by
+    // visibility: images locked by the frame visibility tracker go ahead
+    // of offscreen ones.
+    if (aImage->IsUnlocked()) {
+      mLowPriorityQueue.AppendElement(aImage);
+    } else {
+      mHighPriorityQueue.AppendElement(aImage);
+    }
     if (!gfxPrefs::ImageMTDecodingEnabled() || !mThreadPool) {
       NS_DispatchToMainThread(worker);
     } else {
@@ -344,6 +357,32 @@ DecodePool::RequestDecode(RasterImage* aImage)
   }
 }
 
+bool
+DecodePool::PopDecodeRequest(nsRefPtr<RasterImage>& aImageOut)
+{
+  MutexAutoLock threadPoolLock(mThreadPoolMutex);
+  nsTArray<nsRefPtr<RasterImage>>* queue = &mHighPriorityQueue;
+  if (queue->IsEmpty()) {
+    queue = &mLowPriorityQueue;
+    if (queue->IsEmpty()) {
+      return false;
+    }
+  }
+  // Serve the image layout scored highest; ties go to arrival order.
+  // The queues are short, so a linear scan beats keeping them sorted as
+  // scores change underneath us.
+  uint32_t best = 0;
+  for (uint32_t i = 1; i < queue->Length(); ++i) {
+    if (queue->ElementAt(i)->mDecodePriority >
+        queue->ElementAt(best)->mDecodePriority) {
+      best = i;
+    }
+  }
+  aImageOut.swap(queue->ElementAt(best));
+  queue->RemoveElementAt(best);
+  return true;
+}
+
 void
 DecodePool::DecodeABitOf(RasterImage* aImage, DecodeStrategy aStrategy)
 {
@@ -13,9 +13,11 @@
 #include "mozilla/Mutex.h"
 #include "mozilla/StaticPtr.h"
 #include <mozilla/TypedEnum.h>
+#include "nsAutoPtr.h"
 #include "nsCOMPtr.h"
 #include "nsIEventTarget.h"
 #include "nsIObserver.h"
+#include "nsTArray.h"
 
 class nsIThreadPool;
 
@@ -88,6 +90,16 @@ public:
    */
   void RequestDecode(RasterImage* aImage);
 
+  /**
+   * Hand out the next image waiting to be decoded.  Locked images - the
+   * ones the frame visibility tracker considers visible - are served
+   * before unlocked (offscreen) ones; within each group the image with
+   * the highest layout-assigned decode priority wins (see
+   * imgIContainer::SetDecodePriority).  Returns false if nothing is
+   * queued.
+   */
+  bool PopDecodeRequest(nsRefPtr<RasterImage>& aImageOut);
+
   /**
    * Decode aImage for a short amount of time, and post the remainder to the
    * queue.
@@ -138,11 +150,18 @@ private:
 
   static StaticRefPtr<DecodePool> sSingleton;
 
-  // mThreadPoolMutex protects mThreadPool. For all RasterImages R,
-  // R::mDecodingMonitor must be acquired before mThreadPoolMutex
-  // if both are acquired; the other order may cause deadlock.
+  // mThreadPoolMutex protects mThreadPool and the decode queues. For all
+  // RasterImages R, R::mDecodingMonitor must be acquired before
+  // mThreadPoolMutex if both are acquired; the other order may cause
+  // deadlock.
   Mutex                     mThreadPoolMutex;
   nsCOMPtr<nsIThreadPool>   mThreadPool;
+
+  // Images waiting for a decode worker, split by visibility so that
+  // offscreen decodes can't starve visible ones.  Workers pull from
+  // these via PopDecodeRequest().
+  nsTArray<nsRefPtr<RasterImage>> mHighPriorityQueue;
+  nsTArray<nsRefPtr<RasterImage>> mLowPriorityQueue;
 };
 
 } // namespace image
@@ -11,6 +11,8 @@
 #include "nsServiceManagerUtils.h"
 #include "nsComponentManagerUtils.h"
 
+#include <algorithm>
+
 namespace mozilla {
 namespace image {
 
@@ -32,6 +34,7 @@ Decoder::Decoder(RasterImage &aImage)
   , mSizeDecode(false)
   , mInFrame(false)
   , mIsAnimated(false)
+  , mSharedDecoder(false)
 { }
 
 Decoder::~Decoder()
@@ -79,6 +82,7 @@ Decoder::InitSharedDecoder(uint8_t* aImageData, uint32_t aImageDataLength,
   mColormap = aColormap;
   mColormapSize = aColormapSize;
   mCurrentFrame = Move(aFrameRef);
+  mSharedDecoder = true;
 
   // We have all the frame data, so we've started the frame.
   if (!IsSizeDecode()) {
@@ -303,6 +307,30 @@ Decoder::PostSize(int32_t aWidth,
   mProgress |= FLAG_SIZE_AVAILABLE;
 }
 
+int
+Decoder::GetDecodeDownscale(const nsIntSize& aIntrinsicSize) const
+{
+  // Decoders embedded in another decoder (e.g. the PNG inside an ICO) don't
+  // own size negotiation; the parent decoder already picked a size.
+  if (mSharedDecoder) {
+    return 1;
+  }
+
+  int sampleSize = mImage.GetRequestedSampleSize();
+
+  // A requested resolution caps the decoded size: pick the largest integer
+  // factor that still leaves both dimensions at least as big as the request.
+  nsIntSize resolution = mImage.GetRequestedResolution();
+  if (resolution.width > 0 && resolution.height > 0 &&
+      aIntrinsicSize.width > 0 && aIntrinsicSize.height > 0) {
+    int factor = std::min(aIntrinsicSize.width / resolution.width,
+                          aIntrinsicSize.height / resolution.height);
+    sampleSize = std::max(sampleSize, factor);
+  }
+
+  return std::max(sampleSize, 1);
+}
+
 void
 Decoder::PostHasTransparency()
 {
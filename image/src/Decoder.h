@@ -220,6 +220,15 @@ protected:
                 int32_t aHeight,
                 Orientation aOrientation = Orientation());
 
+  // Downscale-during-decode negotiation. Given the intrinsic size a decoder
+  // found in the image header, returns the integer factor by which the
+  // decoder should shrink the surface it produces, combining an explicit
+  // -moz-samplesize media fragment with any requested resolution. Decoders
+  // that can decode directly to a smaller surface (e.g. via IDCT scaling or
+  // box-filter accumulation) should call this before posting their size and
+  // post the downscaled dimensions instead. Returns 1 for full size.
+  int GetDecodeDownscale(const nsIntSize& aIntrinsicSize) const;
+
   // Called by decoders if they determine that the image has transparency.
   //
   // This should be fired as early as possible to allow observers to do things
@@ -318,6 +327,7 @@ private:
   bool mSizeDecode;
   bool mInFrame;
   bool mIsAnimated;
+  bool mSharedDecoder;
 };
 
 } // namespace image
@@ -268,6 +268,10 @@ DynamicImage::StartDecoding()
   return NS_OK;
 }
 
+NS_IMETHODIMP_(void)
+DynamicImage::SetDecodePriority(uint32_t aPriority)
+{ }
+
 bool
 DynamicImage::IsDecoded()
 {
@@ -7,6 +7,7 @@
 
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/Move.h"
+#include "gfxPrefs.h"
 #include "MainThreadUtils.h"
 
 #include "pixman.h"
@@ -102,6 +103,11 @@ FrameBlender::RemoveFrame(uint32_t aFrameNum)
 {
   MOZ_ASSERT(aFrameNum < GetNumFrames(), "Deleting invalid frame!");
   mFrames.RemoveElementAt(aFrameNum);
+
+  // Frame indices shift, so cached composites no longer match.
+  if (mAnim) {
+    mAnim->compositeCache.Clear();
+  }
 }
 
 void
@@ -109,6 +115,10 @@ FrameBlender::ClearFrames()
 {
   mFrames.Clear();
   mFrames.Compact();
+
+  if (mAnim) {
+    mAnim->compositeCache.Clear();
+  }
 }
 
 void
@@ -221,6 +231,35 @@ FrameBlender::DoBlend(nsIntRect* aDirtyRect,
     return true;
   }
 
+  // Optimization:
+  //   If we cached this frame's composite on an earlier loop, a single copy
+  //   replaces all of the disposal and blending work below and leaves the
+  //   incremental compositing state exactly as the full path would.
+  if (imgFrame* cached = LookupCompositeCache(aNextFrameIndex)) {
+    if (!mAnim->compositingFrame) {
+      nsRefPtr<imgFrame> newFrame = new imgFrame;
+      nsresult rv = newFrame->InitForDecoder(mSize, SurfaceFormat::B8G8R8A8);
+      if (NS_FAILED(rv)) {
+        return false;
+      }
+      mAnim->compositingFrame = newFrame->RawAccessRef();
+    }
+
+    CopyFrameImage(cached->GetRawData(), cached->GetRect(),
+                   mAnim->compositingFrame->GetRawData(),
+                   mAnim->compositingFrame->GetRect());
+    mAnim->compositingFrame->SetRawTimeout(cached->GetRawTimeout());
+
+    nsresult rv =
+      mAnim->compositingFrame->ImageUpdated(mAnim->compositingFrame->GetRect());
+    if (NS_FAILED(rv)) {
+      return false;
+    }
+
+    mAnim->lastCompositedFrameIndex = int32_t(aNextFrameIndex);
+    return true;
+  }
+
   bool needToBlankComposite = false;
 
   // Create the Compositing Frame
@@ -397,9 +436,72 @@ FrameBlender::DoBlend(nsIntRect* aDirtyRect,
 
   mAnim->lastCompositedFrameIndex = int32_t(aNextFrameIndex);
 
+  // Remember this composite for later loops. Frames that restore the previous
+  // frame when disposed are excluded: reusing their composite would skip the
+  // save into compositingPrevFrame above.
+  if (nextFrameDisposalMethod != FrameBlender::kDisposeRestorePrevious) {
+    MaybeCacheComposite(aNextFrameIndex);
+  }
+
   return true;
 }
 
+uint32_t
+FrameBlender::CompositeCacheCapacity() const
+{
+  uint64_t frameBytes = uint64_t(mSize.width) * mSize.height * 4;
+  if (frameBytes == 0) {
+    return 0;
+  }
+  uint64_t budget =
+    uint64_t(gfxPrefs::ImageMemAnimatedCompositeCacheKB()) * 1024;
+  return uint32_t(std::min<uint64_t>(budget / frameBytes, UINT32_MAX));
+}
+
+imgFrame*
+FrameBlender::LookupCompositeCache(uint32_t aFrameNum)
+{
+  for (uint32_t i = 0; i < mAnim->compositeCache.Length(); ++i) {
+    if (mAnim->compositeCache[i].frameIndex == int32_t(aFrameNum)) {
+      return mAnim->compositeCache[i].frame.get();
+    }
+  }
+  return nullptr;
+}
+
+void
+FrameBlender::MaybeCacheComposite(uint32_t aFrameNum)
+{
+  if (mAnim->compositeCache.Length() >= CompositeCacheCapacity() ||
+      LookupCompositeCache(aFrameNum)) {
+    return;
+  }
+
+  nsRefPtr<imgFrame> newFrame = new imgFrame;
+  if (NS_FAILED(newFrame->InitForDecoder(mSize, SurfaceFormat::B8G8R8A8))) {
+    return;
+  }
+  RawAccessFrameRef copy = newFrame->RawAccessRef();
+  if (!copy) {
+    return;
+  }
+
+  if (!CopyFrameImage(mAnim->compositingFrame->GetRawData(),
+                      mAnim->compositingFrame->GetRect(),
+                      copy->GetRawData(),
+                      copy->GetRect())) {
+    return;
+  }
+  copy->SetRawTimeout(mAnim->compositingFrame->GetRawTimeout());
+  if (NS_FAILED(copy->ImageUpdated(copy->GetRect()))) {
+    return;
+  }
+
+  Anim::CachedComposite* entry = mAnim->compositeCache.AppendElement();
+  entry->frameIndex = int32_t(aFrameNum);
+  entry->frame = Move(copy);
+}
+
 //******************************************************************************
 // Fill aFrame with black. Does also clears the mask.
 void
@@ -580,6 +682,10 @@ FrameBlender::SizeOfDecoded(gfxMemoryLocation aLocation,
       n += mAnim->compositingPrevFrame
                 ->SizeOfExcludingThis(aLocation, aMallocSizeOf);
     }
+    for (uint32_t i = 0; i < mAnim->compositeCache.Length(); ++i) {
+      n += mAnim->compositeCache[i].frame
+                ->SizeOfExcludingThis(aLocation, aMallocSizeOf);
+    }
   }
 
   return n;
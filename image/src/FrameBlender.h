@@ -131,9 +131,37 @@ private:
      */
     RawAccessFrameRef compositingPrevFrame;
 
+    //! A fully composited frame retained across animation loops.
+    struct CachedComposite
+    {
+      int32_t frameIndex;
+      RawAccessFrameRef frame;
+    };
+
+    /** Composited frames cached from earlier loops.
+     *
+     * Once a frame's composite has been cached, later loops reuse it with a
+     * single copy instead of re-running disposal and blending. The number of
+     * entries is bounded by CompositeCacheCapacity(), so the memory used per
+     * animation is predictable regardless of frame count.
+     */
+    nsTArray<CachedComposite> compositeCache;
+
     Anim() : lastCompositedFrameIndex(-1) { }
   };
 
+  //! The maximum number of composited frames the cache may hold, derived
+  //! from the image.mem.animated.composite_cache_kb budget and the frame size.
+  uint32_t CompositeCacheCapacity() const;
+
+  //! Returns the cached composite for @aFrameNum, or nullptr if none.
+  imgFrame* LookupCompositeCache(uint32_t aFrameNum);
+
+  //! Copies the current compositing frame into the cache for @aFrameNum if
+  //! it isn't cached already and the cache has room. Failure just means the
+  //! frame gets re-composited on the next loop, so this returns nothing.
+  void MaybeCacheComposite(uint32_t aFrameNum);
+
   /** Clears an area of <aFrame> with transparent black.
    *
    * @param aFrameData Target Frame data
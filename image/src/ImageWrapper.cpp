@@ -236,6 +236,12 @@ ImageWrapper::StartDecoding()
   return mInnerImage->StartDecoding();
 }
 
+NS_IMETHODIMP_(void)
+ImageWrapper::SetDecodePriority(uint32_t aPriority)
+{
+  mInnerImage->SetDecodePriority(aPriority);
+}
+
 bool
 ImageWrapper::IsDecoded()
 {
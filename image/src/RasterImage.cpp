@@ -288,6 +288,7 @@ RasterImage::RasterImage(ProgressTracker* aProgressTracker,
   mFrameDecodeFlags(DECODE_FLAGS_DEFAULT),
   mLockCount(0),
   mDecodeCount(0),
+  mDecodePriority(0),
   mRequestedSampleSize(0),
 #ifdef DEBUG
   mFramesNotified(0),
@@ -1945,6 +1946,13 @@ RasterImage::StartDecoding()
     SYNCHRONOUS_NOTIFY : SYNCHRONOUS_NOTIFY_AND_SOME_DECODE);
 }
 
+/* [notxpcom] void setDecodePriority(in uint32_t aPriority); */
+NS_IMETHODIMP_(void)
+RasterImage::SetDecodePriority(uint32_t aPriority)
+{
+  mDecodePriority = aPriority;
+}
+
 bool
 RasterImage::IsDecoded()
 {
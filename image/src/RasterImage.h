@@ -28,6 +28,7 @@
 #include "DecodePool.h"
 #include "Orientation.h"
 #include "nsIObserver.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/ReentrantMonitor.h"
@@ -371,6 +372,11 @@ private: // data
   // This is currently only used for statistics
   int32_t                        mDecodeCount;
 
+  // Layout's hint about how soon this image is likely to be needed; the
+  // decode pool serves higher values first.  Written on the main thread
+  // and read from decode workers, hence atomic.
+  Atomic<uint32_t>               mDecodePriority;
+
   // If the image contains multiple resolutions, a hint as to which one should be used
   nsIntSize                  mRequestedResolution;
 
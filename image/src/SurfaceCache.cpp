@@ -14,9 +14,11 @@
 #include "mozilla/Attributes.h"  // for MOZ_THIS_IN_INITIALIZER_LIST
 #include "mozilla/DebugOnly.h"
 #include "mozilla/Likely.h"
+#include "mozilla/LinkedList.h"
 #include "mozilla/Move.h"
 #include "mozilla/RefPtr.h"
 #include "mozilla/StaticPtr.h"
+#include "mozilla/TimeStamp.h"
 #include "nsIMemoryReporter.h"
 #include "gfx2DGlue.h"
 #include "gfxPattern.h"  // Workaround for flaw in bug 921753 part 2.
@@ -115,7 +117,7 @@ private:
  * A CachedSurface associates a surface with a key that uniquely identifies that
  * surface.
  */
-class CachedSurface
+class CachedSurface : public LinkedListElement<CachedSurface>
 {
   ~CachedSurface() {}
 public:
@@ -128,6 +130,7 @@ public:
                 const Lifetime     aLifetime)
     : mSurface(aSurface)
     , mCost(aCost)
+    , mRetentionLeases(0)
     , mImageKey(aImageKey)
     , mSurfaceKey(aSurfaceKey)
     , mLifetime(aLifetime)
@@ -161,6 +164,20 @@ public:
   nsExpirationState* GetExpirationState() { return &mExpirationState; }
   Lifetime GetLifetime() const { return mLifetime; }
 
+  // Expiration hysteresis. Each lease lets this surface survive one extra
+  // expiration sweep if its image was visible recently; the leases are
+  // replenished whenever the surface is actually used.
+  void SetRetentionLeases(uint32_t aLeases) { mRetentionLeases = aLeases; }
+
+  bool ConsumeRetentionLease()
+  {
+    if (mRetentionLeases == 0) {
+      return false;
+    }
+    mRetentionLeases--;
+    return true;
+  }
+
   // A helper type used by SurfaceCacheImpl::SizeOfSurfacesSum.
   struct SizeOfSurfacesSum
   {
@@ -195,6 +212,7 @@ private:
   nsRefPtr<imgFrame> mSurface;
   DrawableFrameRef   mDrawableRef;
   const Cost         mCost;
+  uint32_t           mRetentionLeases;
   const ImageKey     mImageKey;
   const SurfaceKey   mSurfaceKey;
   const Lifetime     mLifetime;
@@ -251,11 +269,29 @@ public:
     mSurfaces.EnumerateRead(aFunction, aData);
   }
 
-  void SetLocked(bool aLocked) { mLocked = aLocked; }
+  void SetLocked(bool aLocked)
+  {
+    if (mLocked && !aLocked) {
+      // The image visibility machinery in PresShell locks images whose frames
+      // are in (or near) the displayport, so an unlock is our signal that the
+      // image just left the viewport. Remember when that happened so that its
+      // surfaces can be retained a while longer in case it scrolls back in.
+      mLastVisibleTime = TimeStamp::Now();
+    }
+    mLocked = aLocked;
+  }
   bool IsLocked() const { return mLocked; }
 
+  bool WasVisibleWithin(const TimeDuration& aWindow) const
+  {
+    return mLocked ||
+           (!mLastVisibleTime.IsNull() &&
+            TimeStamp::Now() - mLastVisibleTime < aWindow);
+  }
+
 private:
   SurfaceTable mSurfaces;
+  TimeStamp    mLastVisibleTime;
   bool         mLocked;
 };
 
@@ -273,10 +309,15 @@ public:
 
   SurfaceCacheImpl(uint32_t aSurfaceCacheExpirationTimeMS,
                    uint32_t aSurfaceCacheDiscardFactor,
-                   uint32_t aSurfaceCacheSize)
+                   uint32_t aSurfaceCacheSize,
+                   uint32_t aSurfaceCacheRetentionTimeMS,
+                   uint32_t aSurfaceCacheRetentionLeases)
     : mExpirationTracker(MOZ_THIS_IN_INITIALIZER_LIST(),
                          aSurfaceCacheExpirationTimeMS)
     , mMemoryPressureObserver(new MemoryPressureObserver)
+    , mRetentionTime(
+        TimeDuration::FromMilliseconds(aSurfaceCacheRetentionTimeMS))
+    , mRetentionLeases(aSurfaceCacheRetentionLeases)
     , mDiscardFactor(aSurfaceCacheDiscardFactor)
     , mMaxCost(aSurfaceCacheSize)
     , mAvailableCost(aSurfaceCacheSize)
@@ -345,6 +386,7 @@ public:
 
     // Insert.
     MOZ_ASSERT(aCost <= mAvailableCost, "Inserting despite too large a cost");
+    surface->SetRetentionLeases(mRetentionLeases);
     cache->Insert(aSurfaceKey, surface);
     StartTracking(surface);
 
@@ -445,9 +487,28 @@ public:
       mExpirationTracker.MarkUsed(surface);
     }
 
+    // The surface is demonstrably useful again, so replenish its leases.
+    surface->SetRetentionLeases(mRetentionLeases);
+
     return ref;
   }
 
+  void SurfaceExpired(CachedSurface* aSurface)
+  {
+    // Surfaces belonging to images that were visible recently get a bounded
+    // number of extra expiration periods before they're really discarded.
+    // This smooths out the redecode storms that otherwise happen when the
+    // user scrolls or tabs back to content full of images that just expired.
+    nsRefPtr<ImageSurfaceCache> cache = GetImageCache(aSurface->GetImageKey());
+    if (cache && cache->WasVisibleWithin(mRetentionTime) &&
+        aSurface->ConsumeRetentionLease()) {
+      mExpirationTracker.MarkUsed(aSurface);
+      return;
+    }
+
+    Remove(aSurface);
+  }
+
   void RemoveSurface(const ImageKey    aImageKey,
                      const SurfaceKey& aSurfaceKey)
   {
@@ -663,10 +724,10 @@ private:
     return aCost <= mMaxCost - mLockedCost;
   }
 
-  struct SurfaceTracker : public nsExpirationTracker<CachedSurface, 2>
+  struct SurfaceTracker : public nsIntrusiveExpirationTracker<CachedSurface, 2>
   {
     SurfaceTracker(SurfaceCacheImpl* aCache, uint32_t aSurfaceCacheExpirationTimeMS)
-      : nsExpirationTracker<CachedSurface, 2>(aSurfaceCacheExpirationTimeMS)
+      : nsIntrusiveExpirationTracker<CachedSurface, 2>(aSurfaceCacheExpirationTimeMS)
       , mCache(aCache)
     { }
 
@@ -674,7 +735,7 @@ private:
     virtual void NotifyExpired(CachedSurface* aSurface) MOZ_OVERRIDE
     {
       if (mCache) {
-        mCache->Remove(aSurface);
+        mCache->SurfaceExpired(aSurface);
       }
     }
 
@@ -705,6 +766,8 @@ private:
   nsRefPtrHashtable<nsPtrHashKey<Image>, ImageSurfaceCache> mImageCaches;
   SurfaceTracker                                            mExpirationTracker;
   nsRefPtr<MemoryPressureObserver>                          mMemoryPressureObserver;
+  const TimeDuration                                        mRetentionTime;
+  const uint32_t                                            mRetentionLeases;
   const uint32_t                                            mDiscardFactor;
   const Cost                                                mMaxCost;
   Cost                                                      mAvailableCost;
@@ -752,6 +815,15 @@ SurfaceCache::Initialize()
   uint32_t surfaceCacheSizeFactor =
     max(gfxPrefs::ImageMemSurfaceCacheSizeFactor(), 1u);
 
+  // How long after an image leaves the viewport its surfaces are still
+  // considered likely to be needed again, and how many extra expiration
+  // periods such surfaces get before they're really discarded. Setting the
+  // lease count to zero disables the retention policy entirely.
+  uint32_t surfaceCacheRetentionTimeMS =
+    gfxPrefs::ImageMemSurfaceCacheRetentionTimeMS();
+  uint32_t surfaceCacheRetentionLeases =
+    gfxPrefs::ImageMemSurfaceCacheRetentionLeases();
+
   // Compute the size of the surface cache.
   uint64_t memorySize = PR_GetPhysicalMemorySize();
   if (memorySize == 0) {
@@ -768,7 +840,9 @@ SurfaceCache::Initialize()
   // actually allocate any storage for surfaces at this time.
   sInstance = new SurfaceCacheImpl(surfaceCacheExpirationTimeMS,
                                    surfaceCacheDiscardFactor,
-                                   finalSurfaceCacheSizeBytes);
+                                   finalSurfaceCacheSizeBytes,
+                                   surfaceCacheRetentionTimeMS,
+                                   surfaceCacheRetentionLeases);
   sInstance->InitMemoryReporter();
 }
 
@@ -911,6 +911,12 @@ VectorImage::StartDecoding()
   return NS_OK;
 }
 
+NS_IMETHODIMP_(void)
+VectorImage::SetDecodePriority(uint32_t aPriority)
+{
+  // SVG images don't go through the decode pool.
+}
+
 bool
 VectorImage::IsDecoded()
 {
@@ -154,7 +154,7 @@ ChildProcessHost::ListenerHook::ListenerHook(ChildProcessHost* host)
 }
 
 void ChildProcessHost::ListenerHook::OnMessageReceived(
-    const IPC::Message& msg) {
+    IPC::Message&& msg) {
 
   bool msg_is_ok = true;
   bool handled = false;
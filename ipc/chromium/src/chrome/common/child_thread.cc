@@ -75,11 +75,11 @@ void ChildThread::RemoveRoute(int32_t routing_id) {
   router_.RemoveRoute(routing_id);
 }
 
-void ChildThread::OnMessageReceived(const IPC::Message& msg) {
+void ChildThread::OnMessageReceived(IPC::Message&& msg) {
   if (msg.routing_id() == MSG_ROUTING_CONTROL) {
     OnControlMessageReceived(msg);
   } else {
-    router_.OnMessageReceived(msg);
+    router_.OnMessageReceived(mozilla::Move(msg));
   }
 }
 
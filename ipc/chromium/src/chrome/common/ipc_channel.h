@@ -22,8 +22,9 @@ class Channel : public Message::Sender {
    public:
     virtual ~Listener() {}
 
-    // Called when a message is received.
-    virtual void OnMessageReceived(const Message& message) = 0;
+    // Called when a message is received.  The message is handed over to the
+    // listener, which may move its payload out instead of copying it.
+    virtual void OnMessageReceived(Message&& message) = 0;
 
     // Called when the channel is connected and we have received the internal
     // Hello message from the peer.
@@ -42,7 +42,7 @@ bool ChannelProxy::Context::TryFilters(const Message& message) {
 }
 
 // Called on the IPC::Channel thread
-void ChannelProxy::Context::OnMessageReceived(const Message& message) {
+void ChannelProxy::Context::OnMessageReceived(Message&& message) {
   // First give a chance to the filters to process this message.
   if (!TryFilters(message))
     OnMessageReceivedNoFilter(message);
@@ -159,7 +159,9 @@ void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
   OnDispatchConnected();
 
 
-  listener_->OnMessageReceived(message);
+  // The runnable owns its copy of the message, but dispatch methods take
+  // the message by const reference, so hand the listener its own copy.
+  listener_->OnMessageReceived(Message(message));
 
 }
 
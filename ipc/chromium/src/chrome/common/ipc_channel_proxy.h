@@ -152,7 +152,7 @@ class ChannelProxy : public Message::Sender {
     virtual ~Context() {}
 
     // IPC::Channel::Listener methods:
-    virtual void OnMessageReceived(const Message& message);
+    virtual void OnMessageReceived(Message&& message);
     virtual void OnChannelConnected(int32_t peer_pid);
     virtual void OnChannelError();
 
@@ -4,6 +4,8 @@
 
 #include "chrome/common/message_router.h"
 
+#include "mozilla/Move.h"
+
 void MessageRouter::OnControlMessageReceived(const IPC::Message& msg) {
   NOTREACHED() <<
       "should override in subclass if you care about control messages";
@@ -24,19 +26,19 @@ void MessageRouter::RemoveRoute(int32_t routing_id) {
   routes_.Remove(routing_id);
 }
 
-void MessageRouter::OnMessageReceived(const IPC::Message& msg) {
+void MessageRouter::OnMessageReceived(IPC::Message&& msg) {
   if (msg.routing_id() == MSG_ROUTING_CONTROL) {
     OnControlMessageReceived(msg);
   } else {
-    RouteMessage(msg);
+    RouteMessage(mozilla::Move(msg));
   }
 }
 
-bool MessageRouter::RouteMessage(const IPC::Message& msg) {
+bool MessageRouter::RouteMessage(IPC::Message&& msg) {
   IPC::Channel::Listener* listener = routes_.Lookup(msg.routing_id());
   if (!listener)
     return false;
 
-  listener->OnMessageReceived(msg);
+  listener->OnMessageReceived(mozilla::Move(msg));
   return true;
 }
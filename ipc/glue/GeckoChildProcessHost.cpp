@@ -47,6 +47,7 @@
 #include "nsNativeCharsetUtils.h"
 
 using mozilla::MonitorAutoLock;
+using mozilla::Move;
 using mozilla::ipc::GeckoChildProcessHost;
 
 #ifdef ANDROID
@@ -927,11 +928,11 @@ GeckoChildProcessHost::OnChannelConnected(int32_t peer_pid)
 }
 
 void
-GeckoChildProcessHost::OnMessageReceived(const IPC::Message& aMsg)
+GeckoChildProcessHost::OnMessageReceived(IPC::Message&& aMsg)
 {
   // We never process messages ourself, just save them up for the next
   // listener.
-  mQueue.push(aMsg);
+  mQueue.push(Move(aMsg));
 }
 
 void
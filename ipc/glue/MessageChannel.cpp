@@ -311,6 +311,8 @@ MessageChannel::MessageChannel(MessageListener *aListener)
     mIsSyncWaitingOnNonMainThread = false;
 #endif
 
+    mDequeueTaskPending = false;
+
     mDequeueOneTask = new RefCountedTask(NewRunnableMethod(
                                                  this,
                                                  &MessageChannel::OnMaybeDequeueOne));
@@ -603,7 +605,7 @@ public:
 };
 
 void
-MessageChannel::OnMessageReceivedFromLink(const Message& aMsg)
+MessageChannel::OnMessageReceivedFromLink(Message&& aMsg)
 {
     AssertLinkThread();
     mMonitor->AssertCurrentThreadOwns();
@@ -637,7 +639,7 @@ MessageChannel::OnMessageReceivedFromLink(const Message& aMsg)
             return;
         }
 
-        mRecvd = new Message(aMsg);
+        mRecvd = new Message(Move(aMsg));
         NotifyWorkerThread();
         return;
     }
@@ -688,7 +690,7 @@ MessageChannel::OnMessageReceivedFromLink(const Message& aMsg)
     // blocked. This is okay, since we always check for pending events before
     // blocking again.
 
-    mPending.push_back(aMsg);
+    mPending.push_back(Move(aMsg));
 
     if (shouldWakeUp) {
         NotifyWorkerThread();
@@ -699,7 +701,7 @@ MessageChannel::OnMessageReceivedFromLink(const Message& aMsg)
         if (!compress) {
             // If we compressed away the previous message, we'll re-use
             // its pending task.
-            mWorkerLoop->PostTask(FROM_HERE, new DequeueTask(mDequeueOneTask));
+            EnqueueDequeueTask();
         }
     }
 }
@@ -1062,6 +1064,18 @@ MessageChannel::DequeueOne(Message *recvd)
     return true;
 }
 
+void
+MessageChannel::EnqueueDequeueTask()
+{
+    mMonitor->AssertCurrentThreadOwns();
+
+    if (mDequeueTaskPending)
+        return;
+
+    mDequeueTaskPending = true;
+    mWorkerLoop->PostTask(FROM_HERE, new DequeueTask(mDequeueOneTask));
+}
+
 bool
 MessageChannel::OnMaybeDequeueOne()
 {
@@ -1071,9 +1085,16 @@ MessageChannel::OnMaybeDequeueOne()
     Message recvd;
 
     MonitorAutoLock lock(*mMonitor);
+    mDequeueTaskPending = false;
     if (!DequeueOne(&recvd))
         return false;
 
+    // Reschedule ourselves from the worker side while messages remain, so
+    // the I/O thread only needs to post a single wakeup for a whole burst
+    // of incoming messages.
+    if (!mPending.empty() || !mDeferred.empty())
+        EnqueueDequeueTask();
+
     if (IsOnCxxStack() && recvd.is_interrupt() && recvd.is_reply()) {
         // We probably just received a reply in a nested loop for an
         // Interrupt call sent before entering that loop.
@@ -1334,16 +1355,13 @@ MessageChannel::EnqueuePendingMessages()
 
     MaybeUndeferIncall();
 
-    for (size_t i = 0; i < mDeferred.size(); ++i) {
-        mWorkerLoop->PostTask(FROM_HERE, new DequeueTask(mDequeueOneTask));
-    }
-
     // XXX performance tuning knob: could process all or k pending
     // messages here, rather than enqueuing for later processing
 
-    for (size_t i = 0; i < mPending.size(); ++i) {
-        mWorkerLoop->PostTask(FROM_HERE, new DequeueTask(mDequeueOneTask));
-    }
+    // OnMaybeDequeueOne reschedules itself while messages remain, so one
+    // pending task drains any number of deferred and pending messages.
+    if (!mDeferred.empty() || !mPending.empty())
+        EnqueueDequeueTask();
 }
 
 static inline bool
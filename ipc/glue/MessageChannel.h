@@ -224,6 +224,12 @@ class MessageChannel : HasResultCodes
     bool OnMaybeDequeueOne();
     bool DequeueOne(Message *recvd);
 
+    // Post a DequeueTask to the worker loop unless one is already pending.
+    // OnMaybeDequeueOne reschedules itself while messages remain queued, so
+    // a burst of incoming async messages costs a single cross-thread wakeup
+    // instead of one per message.
+    void EnqueueDequeueTask();
+
     // Dispatches an incoming message to its appropriate handler.
     void DispatchMessage(const Message &aMsg);
 
@@ -357,7 +363,7 @@ class MessageChannel : HasResultCodes
     void SynchronouslyClose();
 
     bool ShouldDeferMessage(const Message& aMsg);
-    void OnMessageReceivedFromLink(const Message& aMsg);
+    void OnMessageReceivedFromLink(Message&& aMsg);
     void OnChannelErrorFromLink();
 
   private:
@@ -437,6 +443,10 @@ class MessageChannel : HasResultCodes
     // A task encapsulating dequeuing one pending message.
     nsRefPtr<RefCountedTask> mDequeueOneTask;
 
+    // Protected by mMonitor. True while a DequeueTask is posted to the
+    // worker loop and has not run yet; used to coalesce wakeups.
+    bool mDequeueTaskPending;
+
     // Timeout periods are broken up in two to prevent system suspension from
     // triggering an abort. This method (called by WaitForEvent with a 'did
     // timeout' flag) decides if we should wait again for half of mTimeoutMs
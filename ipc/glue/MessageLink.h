@@ -155,7 +155,7 @@ class ProcessLink
     // These methods acquire the monitor and forward to the
     // similarly named methods in AsyncChannel below
     // (OnMessageReceivedFromLink(), etc)
-    virtual void OnMessageReceived(const Message& msg) MOZ_OVERRIDE;
+    virtual void OnMessageReceived(Message&& msg) MOZ_OVERRIDE;
     virtual void OnChannelConnected(int32_t peer_pid) MOZ_OVERRIDE;
     virtual void OnChannelError() MOZ_OVERRIDE;
 
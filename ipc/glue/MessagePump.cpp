@@ -151,9 +151,13 @@ if (did_work && delayed_work_time_.is_null()
 void
 MessagePump::ScheduleWork()
 {
-  // Make sure the event loop wakes up.
+  // Make sure the event loop wakes up.  IPC work (including PBrowser input
+  // events bound for TabChild) only reaches the XPCOM event queue through
+  // this runnable, so dispatch it into the input lane: that lets user input
+  // delivered over IPC run ahead of a backlog of normal-priority runnables
+  // such as timer callbacks.
   if (mThread) {
-    mThread->Dispatch(mDoWorkEvent, NS_DISPATCH_NORMAL);
+    mThread->Dispatch(mDoWorkEvent, NS_DISPATCH_INPUT_PRIORITY);
   }
   else {
     // Some things (like xpcshell) don't use the app shell and so Run hasn't
@@ -431,33 +435,33 @@ void MessagePumpForNonMainUIThreads::DoRunLoop()
 
   ti->SetObserver(nullptr);
 }
-
-NS_IMETHODIMP
-MessagePumpForNonMainUIThreads::OnDispatchedEvent(nsIThreadInternal *thread)
-{
-  // If our thread is sleeping in DoRunLoop's call to WaitForWork() and an
-  // event posts to the nsIThread event queue - break our thread out of
-  // chromium's WaitForWork.
-  if (GetInWait()) {
-    ScheduleWork();
-  }
-  return NS_OK;
-}
-
-NS_IMETHODIMP
-MessagePumpForNonMainUIThreads::OnProcessNextEvent(nsIThreadInternal *thread,
-                                                   bool mayWait,
-                                                   uint32_t recursionDepth)
-{
-  return NS_OK;
-}
-
-NS_IMETHODIMP
-MessagePumpForNonMainUIThreads::AfterProcessNextEvent(nsIThreadInternal *thread,
-                                                      uint32_t recursionDepth,
-                                                      bool eventWasProcessed)
-{
-  return NS_OK;
-}
+
+NS_IMETHODIMP
+MessagePumpForNonMainUIThreads::OnDispatchedEvent(nsIThreadInternal *thread)
+{
+  // If our thread is sleeping in DoRunLoop's call to WaitForWork() and an
+  // event posts to the nsIThread event queue - break our thread out of
+  // chromium's WaitForWork.
+  if (GetInWait()) {
+    ScheduleWork();
+  }
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+MessagePumpForNonMainUIThreads::OnProcessNextEvent(nsIThreadInternal *thread,
+                                                   bool mayWait,
+                                                   uint32_t recursionDepth)
+{
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+MessagePumpForNonMainUIThreads::AfterProcessNextEvent(nsIThreadInternal *thread,
+                                                      uint32_t recursionDepth,
+                                                      bool eventWasProcessed)
+{
+  return NS_OK;
+}
 
 #endif // XP_WIN
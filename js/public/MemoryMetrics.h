@@ -548,6 +548,7 @@ struct CompartmentStats
       : FOR_EACH_SIZE(ZERO_SIZE)
         classInfo(),
         extra(),
+        cpuTicks(0),
         allClasses(nullptr),
         notableClasses(),
         isTotals(true)
@@ -557,6 +558,7 @@ struct CompartmentStats
       : FOR_EACH_SIZE(COPY_OTHER_SIZE)
         classInfo(mozilla::Move(other.classInfo)),
         extra(other.extra),
+        cpuTicks(other.cpuTicks),
         allClasses(other.allClasses),
         notableClasses(mozilla::Move(other.notableClasses)),
         isTotals(other.isTotals)
@@ -578,6 +580,7 @@ struct CompartmentStats
         MOZ_ASSERT(isTotals);
         FOR_EACH_SIZE(ADD_OTHER_SIZE)
         classInfo.add(other.classInfo);
+        cpuTicks += other.cpuTicks;
     }
 
     size_t sizeOfLiveGCThings() const {
@@ -600,6 +603,7 @@ struct CompartmentStats
     FOR_EACH_SIZE(DECL_SIZE)
     ClassInfo   classInfo;
     void        *extra;     // This field can be used by embedders.
+    uint64_t    cpuTicks;   // Execution ticks attributed to the compartment.
 
     typedef js::HashMap<const char*, ClassInfo,
                         js::CStringHashPolicy,
@@ -132,7 +132,23 @@ function ArrayEvery(callbackfn/*, thisArg*/) {
 
     /* Steps 6-7. */
     /* Steps a (implicit), and d. */
-    for (var k = 0; k < len; k++) {
+    var k = 0;
+    // Fast path for packed receivers: no hole can be observed, so the
+    // per-element 'in' test is elided. The callback may delete elements or
+    // shrink the array, so revalidate after every invocation and resume in
+    // the generic loop if the fast path no longer applies.
+    if (IsPackedArray(O)) {
+        for (; k < len; k++) {
+            /* Step c. */
+            if (!callFunction(callbackfn, T, O[k], k, O))
+                return false;
+            if (!IsPackedArray(O) || O.length < len) {
+                k++;
+                break;
+            }
+        }
+    }
+    for (; k < len; k++) {
         /* Step b */
         if (k in O) {
             /* Step c. */
@@ -173,7 +189,20 @@ function ArraySome(callbackfn/*, thisArg*/) {
 
     /* Steps 6-7. */
     /* Steps a (implicit), and d. */
-    for (var k = 0; k < len; k++) {
+    var k = 0;
+    // Fast path for packed receivers; see ArrayEvery.
+    if (IsPackedArray(O)) {
+        for (; k < len; k++) {
+            /* Step c. */
+            if (callFunction(callbackfn, T, O[k], k, O))
+                return true;
+            if (!IsPackedArray(O) || O.length < len) {
+                k++;
+                break;
+            }
+        }
+    }
+    for (; k < len; k++) {
         /* Step b */
         if (k in O) {
             /* Step c. */
@@ -214,7 +243,19 @@ function ArrayForEach(callbackfn/*, thisArg*/) {
 
     /* Steps 6-7. */
     /* Steps a (implicit), and d. */
-    for (var k = 0; k < len; k++) {
+    var k = 0;
+    // Fast path for packed receivers; see ArrayEvery.
+    if (IsPackedArray(O)) {
+        for (; k < len; k++) {
+            /* Step c. */
+            callFunction(callbackfn, T, O[k], k, O);
+            if (!IsPackedArray(O) || O.length < len) {
+                k++;
+                break;
+            }
+        }
+    }
+    for (; k < len; k++) {
         /* Step b */
         if (k in O) {
             /* Step c. */
@@ -248,7 +289,21 @@ function ArrayMap(callbackfn/*, thisArg*/) {
 
     /* Step 7-8. */
     /* Step a (implicit), and d. */
-    for (var k = 0; k < len; k++) {
+    var k = 0;
+    // Fast path for packed receivers; see ArrayEvery.
+    if (IsPackedArray(O)) {
+        for (; k < len; k++) {
+            /* Step c.i-iii. */
+            var mappedValue = callFunction(callbackfn, T, O[k], k, O);
+            // UnsafePutElements doesn't invoke setters, so we can use it here.
+            UnsafePutElements(A, k, mappedValue);
+            if (!IsPackedArray(O) || O.length < len) {
+                k++;
+                break;
+            }
+        }
+    }
+    for (; k < len; k++) {
         /* Step b */
         if (k in O) {
             /* Step c.i-iii. */
@@ -145,10 +145,15 @@ MaybeCheckEvalFreeVariables(ExclusiveContext *cxArg, HandleScript evalCaller, Ha
 static inline bool
 CanLazilyParse(ExclusiveContext *cx, const ReadOnlyCompileOptions &options)
 {
+    // Scripts compiled with a lazy source (sourceIsLazy) keep no source data
+    // in memory, but their source is marked retrievable and delazification
+    // reloads it through the runtime's source hook. That makes lazy function
+    // parsing safe for them as long as a hook is installed; without one the
+    // function bodies would be unrecoverable, so fall back to a full parse.
     return options.canLazilyParse &&
         options.compileAndGo &&
         !cx->compartment()->options().discardSource() &&
-        !options.sourceIsLazy;
+        (!options.sourceIsLazy || cx->runtime()->sourceHook);
 }
 
 static void
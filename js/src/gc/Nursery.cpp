@@ -507,7 +507,11 @@ struct TenureCount
 // of potential collisions.
 struct Nursery::TenureCountCache
 {
-    TenureCount entries[16];
+    // A direct-mapped cache: each type only ever counts in its own slot, and
+    // a type whose slot is occupied by another type is not counted at all.
+    // Event-driven workloads allocate from many types at once, so keep the
+    // table large enough that hot types rarely shadow each other.
+    TenureCount entries[64];
 
     TenureCountCache() { PodZero(this); }
 
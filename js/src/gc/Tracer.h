@@ -27,7 +27,16 @@ struct TypeObject;
 }
 
 static const size_t NON_INCREMENTAL_MARK_STACK_BASE_CAPACITY = 4096;
-static const size_t INCREMENTAL_MARK_STACK_BASE_CAPACITY = 32768;
+
+/*
+ * Incremental GCs keep the mark stack alive across slices, and overflowing it
+ * is expensive: overflowed entries degrade into per-arena delayed marking,
+ * which rescans whole arenas inside later slices (see markDelayedChildren).
+ * Multi-hundred-MB heaps overflow a small stack routinely, so start the
+ * incremental stack much larger; reset() releases any growth beyond this
+ * once the GC finishes.
+ */
+static const size_t INCREMENTAL_MARK_STACK_BASE_CAPACITY = 131072;
 
 /*
  * When the native stack is low, the GC does not call JS_TraceChildren to mark
@@ -85,6 +85,9 @@ struct RegExpCode
     }
 };
 
+bool
+IsNativeRegExpEnabled(JSContext *cx);
+
 RegExpCode
 CompilePattern(JSContext *cx, RegExpShared *shared, RegExpCompileData *data,
                HandleLinearString sample,  bool is_global, bool ignore_case,
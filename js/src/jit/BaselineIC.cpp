@@ -9,6 +9,7 @@
 #include "mozilla/DebugOnly.h"
 #include "mozilla/TemplateLib.h"
 
+#include "jsfriendapi.h"
 #include "jslibmath.h"
 #include "jstypes.h"
 
@@ -1689,6 +1690,34 @@ DoCallNativeGetter(JSContext *cx, HandleFunction callee, HandleObject obj,
                    MutableHandleValue result)
 {
     MOZ_ASSERT(callee->isNative());
+
+    // WebIDL binding getters carry JitInfo describing the specialized getter
+    // that the generic native eventually dispatches to. The stub that brought
+    // us here already guarded on the receiver's shape, so when the receiver is
+    // a DOM instance object matching the getter's prototype we can call the
+    // specialized getter directly, skipping the generic binding wrapper's
+    // per-call unwrapping and proto checks. This is the same call Ion emits
+    // for MGetDOMProperty.
+    const JSJitInfo *jitInfo = callee->jitInfo();
+    if (jitInfo && jitInfo->type() == JSJitInfo::Getter &&
+        obj->getClass()->isDOMClass() && obj->isNative())
+    {
+        const DOMCallbacks *callbacks = GetDOMCallbacks(cx->runtime());
+        if (callbacks &&
+            callbacks->instanceClassMatchesProto(obj->getClass(), jitInfo->protoID,
+                                                 jitInfo->depth))
+        {
+            // DOM instance objects keep their C++ object in their first slot;
+            // see LoadDOMPrivate in CodeGenerator.cpp.
+            void *priv = obj->as<NativeObject>().getSlot(0).toPrivate();
+            RootedValue v(cx, UndefinedValue());
+            if (!jitInfo->getter(cx, obj, priv, JSJitGetterCallArgs(&v)))
+                return false;
+            result.set(v);
+            return true;
+        }
+    }
+
     JSNative natfun = callee->native();
 
     JS::AutoValueArray<2> vp(cx);
@@ -4586,9 +4586,12 @@ IonBuilder::makeInliningDecision(JSObject *targetArg, CallInfo &callInfo)
 
         // Callee must have been called a few times to have somewhat stable
         // type information, except for definite properties analysis,
-        // as the caller has not run yet.
+        // as the caller has not run yet.  A profile hint imported from a
+        // previous session counts as evidence of hotness too, so known-hot
+        // callees don't get vetoed while their counters re-warm.
         if (targetScript->getWarmUpCount() < optimizationInfo().inliningWarmUpThreshold() &&
             !targetScript->baselineScript()->ionCompiledOrInlined() &&
+            !targetScript->profiledHot() &&
             info().executionMode() != DefinitePropertiesAnalysis)
         {
             JitSpew(JitSpew_Inlining, "Cannot inline %s:%u: callee is insufficiently hot.",
@@ -8,6 +8,7 @@
 
 #include "mozilla/TemplateLib.h"
 
+#include "jsprf.h"
 #include "jsproxy.h"
 #include "jstypes.h"
 
@@ -429,6 +430,28 @@ IonCache::linkAndAttachStub(JSContext *cx, MacroAssembler &masm, StubAttacher &a
     writePerfSpewerJitCodeProfile(code, "IonCache");
 #endif
 
+    // Note each stub the cache accumulates as an event in the profile when
+    // the profiler is active, so that shape-polymorphic and megamorphic
+    // sites show up in profiles from release builds.
+    if (pc_ && cx->runtime()->spsProfiler.enabled()) {
+        const char *filename = script_->filename();
+        if (filename == nullptr)
+            filename = "<unknown>";
+
+        size_t len = strlen(filename) + strlen(attachKind) +
+                     strlen(CacheName(kind())) + 60;
+        char *buf = js_pod_malloc<char>(len);
+        if (buf) {
+            JS_snprintf(buf, len, "Ion IC %s %s stub %u %s:%u/%u",
+                        CacheName(kind()), attachKind,
+                        unsigned(stubCount_) + 1, filename,
+                        unsigned(script_->lineno()),
+                        unsigned(script_->pcToOffset(pc_)));
+            cx->runtime()->spsProfiler.markEvent(buf);
+            js_free(buf);
+        }
+    }
+
     attachStub(masm, attacher, code);
 
     // Add entry to native => bytecode mapping for this stub if needed.
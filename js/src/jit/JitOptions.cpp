@@ -129,6 +129,10 @@ JitOptions::JitOptions()
     // invalidating the script.
     SET_DEFAULT(osrPcMismatchesBeforeRecompile, 6000);
 
+    // How many times a regexp is executed in the bytecode interpreter
+    // before it is compiled to native code.
+    SET_DEFAULT(regexpWarmUpThreshold, 10);
+
     // The bytecode length limit for small function.
     //
     // The default for this was arrived at empirically via benchmarking.
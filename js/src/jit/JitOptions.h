@@ -53,6 +53,7 @@ struct JitOptions
     uint32_t frequentBailoutThreshold;
     uint32_t maxStackArgs;
     uint32_t osrPcMismatchesBeforeRecompile;
+    uint32_t regexpWarmUpThreshold;
     uint32_t smallFunctionMaxBytecodeLength_;
     uint32_t compilerWarmUpThresholdPar;
 
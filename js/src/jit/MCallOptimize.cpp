@@ -168,6 +168,8 @@ IonBuilder::inlineNativeCall(CallInfo &callInfo, JSFunction *target)
         return inlineUnsafePutElements(callInfo);
     if (native == intrinsic_NewDenseArray)
         return inlineNewDenseArray(callInfo);
+    if (native == intrinsic_IsPackedArray)
+        return inlineIsPackedArray(callInfo);
 
     // Slot intrinsics.
     if (native == intrinsic_UnsafeSetReservedSlot)
@@ -1891,6 +1893,61 @@ IonBuilder::inlineNewDenseArrayForParallelExecution(CallInfo &callInfo)
     return InliningStatus_Inlined;
 }
 
+IonBuilder::InliningStatus
+IonBuilder::inlineIsPackedArray(CallInfo &callInfo)
+{
+    if (callInfo.constructing() || callInfo.argc() != 1)
+        return InliningStatus_NotInlined;
+
+    if (getInlineReturnType() != MIRType_Boolean)
+        return InliningStatus_NotInlined;
+    if (callInfo.getArg(0)->type() != MIRType_Object)
+        return InliningStatus_NotInlined;
+
+    MDefinition *array = callInfo.getArg(0);
+
+    types::TemporaryTypeSet *arrayTypes = array->resultTypeSet();
+    if (!arrayTypes)
+        return InliningStatus_NotInlined;
+
+    const Class *clasp = arrayTypes->getKnownClass();
+    if (!clasp)
+        return InliningStatus_NotInlined;
+
+    if (clasp != &ArrayObject::class_) {
+        pushConstant(BooleanValue(false));
+        callInfo.setImplicitlyUsedUnchecked();
+        return InliningStatus_Inlined;
+    }
+
+    // Don't inline if the array may be non-packed: the runtime check gives
+    // the exact answer in that case. The constraint added here invalidates
+    // the script if the flag is set later, so in the common case the packed
+    // flag is compiled away and only the length test below remains.
+    if (arrayTypes->hasObjectFlags(constraints(), types::OBJECT_FLAG_NON_PACKED))
+        return InliningStatus_NotInlined;
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    // The remaining dynamic part of the packed check: no trailing holes,
+    // i.e. the initialized length covers the whole array.
+    MElements *elements = MElements::New(alloc(), array);
+    current->add(elements);
+
+    MInitializedLength *initLength = MInitializedLength::New(alloc(), elements);
+    current->add(initLength);
+
+    MArrayLength *length = MArrayLength::New(alloc(), elements);
+    current->add(length);
+
+    MCompare *isPacked = MCompare::New(alloc(), initLength, length, JSOP_EQ);
+    isPacked->setCompareType(MCompare::Compare_Int32);
+    current->add(isPacked);
+    current->push(isPacked);
+
+    return InliningStatus_Inlined;
+}
+
 IonBuilder::InliningStatus
 IonBuilder::inlineHasClass(CallInfo &callInfo,
                            const Class *clasp1, const Class *clasp2,
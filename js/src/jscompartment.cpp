@@ -37,6 +37,37 @@ using namespace js::jit;
 
 using mozilla::DebugOnly;
 
+#if defined(_WIN32)
+#include <intrin.h>
+/* static */ uint64_t
+JSCompartment::nowTicks()
+{
+    return __rdtsc();
+}
+#elif defined(__i386__)
+/* static */ uint64_t
+JSCompartment::nowTicks()
+{
+    uint64_t x;
+    __asm__ volatile (".byte 0x0f, 0x31" : "=A" (x));
+    return x;
+}
+#elif defined(__x86_64__)
+/* static */ uint64_t
+JSCompartment::nowTicks()
+{
+    unsigned hi, lo;
+    __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)lo) | (((uint64_t)hi) << 32);
+}
+#else
+/* static */ uint64_t
+JSCompartment::nowTicks()
+{
+    return uint64_t(PRMJ_Now());
+}
+#endif
+
 JSCompartment::JSCompartment(Zone *zone, const JS::CompartmentOptions &options = JS::CompartmentOptions())
   : options_(options),
     zone_(zone),
@@ -51,7 +82,9 @@ JSCompartment::JSCompartment(Zone *zone, const JS::CompartmentOptions &options =
 #endif
     global_(nullptr),
     enterCompartmentDepth(0),
+    startTicks(0),
     totalTime(0),
+    totalExecutionTicks(0),
     data(nullptr),
     objectMetadataCallback(nullptr),
     lastAnimationTime(0),
@@ -168,13 +168,28 @@ struct JSCompartment
 
     unsigned                     enterCompartmentDepth;
     int64_t                      startInterval;
+    uint64_t                     startTicks;
+
+    // Read the cheapest monotonic-ish counter the platform has (the
+    // timestamp counter where available, microseconds elsewhere).
+    static uint64_t nowTicks();
 
   public:
     int64_t                      totalTime;
+
+    // Ticks attributed to code running with this compartment entered,
+    // inclusive of nested compartments, accumulated while
+    // JSRuntime::compartmentClockEnabled is set. Stamped only at the
+    // outermost enter/leave so the per-call overhead is a depth check.
+    uint64_t                     totalExecutionTicks;
+
     void enter() {
         if (addonId && !enterCompartmentDepth) {
             startInterval = PRMJ_Now();
         }
+        if (!enterCompartmentDepth && runtime_->compartmentClockEnabled) {
+            startTicks = nowTicks();
+        }
         enterCompartmentDepth++;
     }
     void leave() {
@@ -182,6 +197,9 @@ struct JSCompartment
         if (addonId && !enterCompartmentDepth) {
             totalTime += (PRMJ_Now() - startInterval);
         }
+        if (!enterCompartmentDepth && runtime_->compartmentClockEnabled) {
+            totalExecutionTicks += nowTicks() - startTicks;
+        }
     }
     bool hasBeenEntered() { return !!enterCompartmentDepth; }
 
@@ -22,6 +22,7 @@
 #include "prmjtime.h"
 
 #include "builtin/TestingFunctions.h"
+#include "jit/BaselineJIT.h"
 #include "proxy/DeadObjectProxy.h"
 #include "vm/ArgumentsObject.h"
 #include "vm/WrapperObject.h"
@@ -342,6 +343,72 @@ js::GetCompartmentZone(JSCompartment *comp)
     return comp->zone();
 }
 
+JS_FRIEND_API(void)
+js::SetCompartmentClockEnabled(JSRuntime *rt, bool enabled)
+{
+    rt->compartmentClockEnabled = enabled;
+}
+
+JS_FRIEND_API(uint64_t)
+js::GetCompartmentExecutionTicks(JSCompartment *comp)
+{
+    return comp->totalExecutionTicks;
+}
+
+namespace {
+
+struct ScriptProfileHintClosure
+{
+    js::ScriptProfileHintVisitor visitor;
+    void *data;
+};
+
+} /* anonymous namespace */
+
+static void
+ExportScriptProfileHintsCallback(JSRuntime *rt, void *data, JSScript *script)
+{
+    // Only scripts that reached Ion, either by compiling or by being
+    // inlined into another compilation, are worth remembering; anything
+    // colder will re-warm quickly enough next session.
+    bool hot = script->hasIonScript();
+    if (!hot && script->hasBaselineScript())
+        hot = script->baselineScript()->ionCompiledOrInlined();
+    if (!hot)
+        return;
+
+    ScriptProfileHintClosure *closure =
+        static_cast<ScriptProfileHintClosure *>(data);
+    closure->visitor(script->profileHash(), script->getWarmUpCount(),
+                     closure->data);
+}
+
+JS_FRIEND_API(void)
+js::ExportScriptProfileHints(JSRuntime *rt, ScriptProfileHintVisitor visitor,
+                             void *data)
+{
+    ScriptProfileHintClosure closure = { visitor, data };
+    IterateScripts(rt, nullptr, &closure, ExportScriptProfileHintsCallback);
+}
+
+JS_FRIEND_API(bool)
+js::ImportScriptProfileHint(JSRuntime *rt, uint32_t scriptHash,
+                            uint32_t warmUpCount)
+{
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(rt));
+
+    if (!rt->scriptProfileHints) {
+        rt->scriptProfileHints = js_new<ScriptProfileHintMap>();
+        if (!rt->scriptProfileHints || !rt->scriptProfileHints->init()) {
+            js_delete(rt->scriptProfileHints);
+            rt->scriptProfileHints = nullptr;
+            return false;
+        }
+    }
+
+    return rt->scriptProfileHints->put(scriptHash, warmUpCount);
+}
+
 JS_FRIEND_API(bool)
 js::IsSystemCompartment(JSCompartment *comp)
 {
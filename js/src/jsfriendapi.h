@@ -442,6 +442,37 @@ SetAssertOnScriptEntryHook(JSRuntime *rt, AssertOnScriptEntryHook hook);
 extern JS_FRIEND_API(JS::Zone *)
 GetCompartmentZone(JSCompartment *comp);
 
+/*
+ * Control whether compartments accumulate execution ticks at their outermost
+ * enter/leave, and read a compartment's accumulated total. The counter is
+ * cumulative and monotonic; consumers wanting rates should sample it at
+ * their own cadence and diff.
+ */
+extern JS_FRIEND_API(void)
+SetCompartmentClockEnabled(JSRuntime *rt, bool enabled);
+
+extern JS_FRIEND_API(uint64_t)
+GetCompartmentExecutionTicks(JSCompartment *comp);
+
+/*
+ * A channel for persisting script profile data across sessions.  At
+ * shutdown, ExportScriptProfileHints visits every live script that ran
+ * hot (was Ion-compiled or inlined), reporting a session-stable hash of
+ * the script's origin and its warm-up count; the embedder can write
+ * these out however it likes.  On the next start it feeds them back with
+ * ImportScriptProfileHint, before the scripts in question are compiled,
+ * and newly created scripts whose hash matches a hint are marked as hot
+ * so Ion's inlining heuristics don't wait for fresh warm-up counters.
+ */
+typedef void
+(* ScriptProfileHintVisitor)(uint32_t scriptHash, uint32_t warmUpCount, void *data);
+
+extern JS_FRIEND_API(void)
+ExportScriptProfileHints(JSRuntime *rt, ScriptProfileHintVisitor visitor, void *data);
+
+extern JS_FRIEND_API(bool)
+ImportScriptProfileHint(JSRuntime *rt, uint32_t scriptHash, uint32_t warmUpCount);
+
 typedef bool
 (* PreserveWrapperCallback)(JSContext *cx, JSObject *obj);
 
@@ -1450,7 +1450,19 @@ JSFunction::createScriptForLazilyInterpretedFunction(JSContext *cx, HandleFuncti
             return true;
         }
 
-        MOZ_ASSERT(lazy->source()->hasSourceData());
+        // If the function was compiled with a lazy source, the source data
+        // was never kept in memory; reload it through the source hook before
+        // compiling the function body.
+        if (!lazy->source()->hasSourceData()) {
+            bool loaded;
+            if (!JSScript::loadSource(cx, lazy->source(), &loaded))
+                return false;
+            if (!loaded) {
+                JS_ReportErrorNumber(cx, js_GetErrorMessage, nullptr,
+                                     JSMSG_CANT_LOAD_LAZY_SOURCE);
+                return false;
+            }
+        }
 
         // Parse and compile the script from source.
         UncompressedSourceCache::AutoHoldEntry holder;
@@ -2673,6 +2673,7 @@ GCRuntime::updatePointersToRelocatedCells()
     // TODO: Should possibly just call purgeRuntime() here.
     rt->newObjectCache.purge();
     rt->nativeIterCache.purge();
+    rt->megamorphicCache.purge();
 
     // Call callbacks to get the rest of the system to fixup other untraced pointers.
     callWeakPointerCallbacks();
@@ -3817,6 +3818,7 @@ GCRuntime::purgeRuntime()
     rt->scopeCoordinateNameCache.purge();
     rt->newObjectCache.purge();
     rt->nativeIterCache.purge();
+    rt->megamorphicCache.purge();
     rt->uncompressedSourceCache.purge();
     rt->evalCache.clear();
 
@@ -11,6 +11,7 @@
 #include "jsscriptinlines.h"
 
 #include "mozilla/DebugOnly.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/MathAlgorithms.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/PodOperations.h"
@@ -2656,9 +2657,26 @@ JSScript::fullyInitFromEmitter(ExclusiveContext *cx, HandleScript script, Byteco
         }
     }
 
+    // If the embedder imported profile hints from a previous session, and
+    // this script ran hot back then, remember that so Ion's inlining
+    // heuristics don't have to wait for fresh warm-up counters.  The hint
+    // table is only written on the main thread, before compilation starts,
+    // so it is safe to read from off-thread parses.
+    if (ScriptProfileHintMap *hints = cx->scriptProfileHints()) {
+        if (hints->has(script->profileHash()))
+            script->profiledHot_ = true;
+    }
+
     return true;
 }
 
+uint32_t
+JSScript::profileHash() const
+{
+    uint32_t hash = filename() ? mozilla::HashString(filename()) : 0;
+    return mozilla::AddToHash(hash, lineno(), length());
+}
+
 size_t
 JSScript::computedSizeOfData() const
 {
@@ -3134,6 +3152,7 @@ js::CloneScript(JSContext *cx, HandleObject enclosingScope, HandleFunction fun,
 
     /* Copy over hints. */
     dst->shouldInline_ = src->shouldInline();
+    dst->profiledHot_ = src->profiledHot();
     dst->shouldCloneAtCallsite_ = src->shouldCloneAtCallsite();
     dst->isCallsiteClone_ = src->isCallsiteClone();
 
@@ -356,6 +356,16 @@ typedef HashMap<JSScript *,
                 DefaultHasher<JSScript *>,
                 SystemAllocPolicy> ScriptCountsMap;
 
+/*
+ * Profile hints imported from a previous session, keyed by
+ * JSScript::profileHash() and holding the warm-up count the script had
+ * reached when it was exported.  See js::ImportScriptProfileHint.
+ */
+typedef HashMap<uint32_t,
+                uint32_t,
+                DefaultHasher<uint32_t>,
+                SystemAllocPolicy> ScriptProfileHintMap;
+
 class DebugScript
 {
     friend class ::JSScript;
@@ -979,6 +989,8 @@ class JSScript : public js::gc::TenuredCell
     bool shouldCloneAtCallsite_:1;
     bool isCallsiteClone_:1; /* is a callsite clone; has a link to the original function */
     bool shouldInline_:1;    /* hint to inline when possible */
+    bool profiledHot_:1;     /* ran hot in a previous session, per an
+                                imported profile hint */
 
     // IonMonkey compilation hints.
     bool failedBoundsCheck_:1; /* script has had hoisted bounds checks fail */
@@ -1212,6 +1224,18 @@ class JSScript : public js::gc::TenuredCell
     void setShouldCloneAtCallsite() { shouldCloneAtCallsite_ = true; }
     void setShouldInline() { shouldInline_ = true; }
 
+    bool profiledHot() const {
+        return profiledHot_;
+    }
+    void setProfiledHot() { profiledHot_ = true; }
+
+    /*
+     * A hash of the script's origin (filename, line and length) that is
+     * stable across sessions, used to key profile hints persisted by the
+     * embedder.
+     */
+    uint32_t profileHash() const;
+
     bool isCallsiteClone() const {
         return isCallsiteClone_;
     }
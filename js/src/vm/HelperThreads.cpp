@@ -702,6 +702,29 @@ GlobalHelperThreadState::pendingIonCompileHasSufficientPriority()
     return false;
 }
 
+static bool
+IonBuilderIsHotUpgrade(jit::IonBuilder *first)
+{
+    // A compilation upgrades hot code when it replaces an IonScript the
+    // program is running right now, or when the script has accumulated
+    // warm-up counts well past the threshold that triggered the compile,
+    // i.e. it keeps running in baseline code while we sit on the compile.
+    JSScript *script = first->script();
+    if (script->hasIonScript())
+        return true;
+    return script->getWarmUpCount() >
+           2 * first->optimizationInfo().compilerWarmUpThreshold(script);
+}
+
+bool
+GlobalHelperThreadState::pendingIonCompileIsHotUpgrade()
+{
+    MOZ_ASSERT(isLocked());
+
+    jit::IonBuilder *builder = highestPriorityPendingIonCompile();
+    return builder && IonBuilderIsHotUpgrade(builder);
+}
+
 bool
 GlobalHelperThreadState::canStartParseTask()
 {
@@ -1363,13 +1386,20 @@ HelperThread::threadLoop()
             HelperThreadState().wait(GlobalHelperThreadState::PRODUCER);
         }
 
-        // Dispatch tasks, prioritizing AsmJS work.
+        // Dispatch tasks, prioritizing AsmJS work. Off thread parses beat Ion
+        // compilations of cold code, since the main thread may block on the
+        // parse while cold code is not running yet. The order is reversed for
+        // compilations which upgrade code that is already running hot.
         if (HelperThreadState().canStartAsmJSCompile())
             handleAsmJSWorkload();
-        else if (ionCompile)
+        else if (ionCompile &&
+                 (!HelperThreadState().canStartParseTask() ||
+                  HelperThreadState().pendingIonCompileIsHotUpgrade()))
             handleIonWorkload();
         else if (HelperThreadState().canStartParseTask())
             handleParseWorkload();
+        else if (ionCompile)
+            handleIonWorkload();
         else if (HelperThreadState().canStartCompressionTask())
             handleCompressionWorkload();
         else if (HelperThreadState().canStartGCHelperTask())
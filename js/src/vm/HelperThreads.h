@@ -93,7 +93,12 @@ class GlobalHelperThreadState
 
   public:
     size_t maxIonCompilationThreads() const {
-        return 1;
+        // Scale the number of concurrent Ion compilations with the machine
+        // size. Capping at one serializes compilation on many-core machines
+        // where the queue grows while most cores sit idle.
+        if (cpuCount < 4)
+            return 1;
+        return cpuCount / 4;
     }
     size_t maxAsmJSCompilationThreads() const {
         if (cpuCount < 2)
@@ -198,6 +203,10 @@ class GlobalHelperThreadState
     // over time, even if the helper thread state lock is held throughout.
     bool pendingIonCompileHasSufficientPriority();
 
+    // Whether the best pending Ion compilation upgrades code that is already
+    // running, in which case it takes precedence over off thread parsing.
+    bool pendingIonCompileIsHotUpgrade();
+
     jit::IonBuilder *highestPriorityPendingIonCompile(bool remove = false);
     HelperThread *lowestPriorityUnpausedIonCompileAtThreshold();
     HelperThread *highestPriorityPausedIonCompile();
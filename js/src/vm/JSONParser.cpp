@@ -56,6 +56,13 @@ JSONParserBase::trace(JSTracer *trc)
             }
         }
     }
+
+    for (size_t i = 0; i < lastObjectIds.length(); i++)
+        gc::MarkIdRoot(trc, &lastObjectIds[i], "JSONParser memoized property id");
+    if (lastObjectType)
+        gc::MarkTypeObjectRoot(trc, &lastObjectType, "JSONParser memoized type");
+    if (lastObjectShape)
+        gc::MarkShapeRoot(trc, &lastObjectShape, "JSONParser memoized shape");
 }
 
 template <typename CharT>
@@ -577,9 +584,116 @@ JSONParser<CharT>::advanceAfterProperty()
     return token(Error);
 }
 
+/*
+ * A conservative classification of a JSON value for deciding whether it is
+ * covered by the property type sets of a memoized object layout. Distinguishes
+ * the same primitive cases the object type table tracks.
+ */
+static inline JSValueType
+CoarseValueType(const Value &v)
+{
+    return v.isDouble() ? JSVAL_TYPE_DOUBLE : v.extractNonDoubleType();
+}
+
+JSObject *
+JSONParserBase::createMemoizedObject(PropertyVector &properties)
+{
+    if (properties.empty() || properties.length() != lastObjectIds.length())
+        return nullptr;
+
+    for (size_t i = 0; i < properties.length(); i++) {
+        if (properties[i].id != lastObjectIds[i])
+            return nullptr;
+
+        /*
+         * The memoized type's property type sets only cover the values of the
+         * object the layout was memoized from. Object-valued properties are
+         * tracked per type object, and a widened primitive needs an update,
+         * so either one means taking the table path. The only exception is an
+         * int32 where a double was seen: the double type already subsumes it.
+         */
+        JSValueType type = CoarseValueType(properties[i].value);
+        if (type == JSVAL_TYPE_OBJECT)
+            return nullptr;
+        if (type != lastObjectValueTypes[i] &&
+            !(type == JSVAL_TYPE_INT32 &&
+              lastObjectValueTypes[i] == JSVAL_TYPE_DOUBLE))
+        {
+            return nullptr;
+        }
+    }
+
+    gc::AllocKind allocKind = gc::GetGCObjectKind(properties.length());
+    RootedPlainObject obj(cx, NewBuiltinClassInstance<PlainObject>(cx, allocKind));
+    if (!obj) {
+        cx->clearPendingException();
+        return nullptr;
+    }
+
+    RootedShape shape(cx, lastObjectShape);
+    if (!NativeObject::setLastProperty(cx, obj, shape)) {
+        cx->clearPendingException();
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < properties.length(); i++)
+        obj->setSlot(i, properties[i].value);
+
+    obj->setType(lastObjectType);
+    return obj;
+}
+
+void
+JSONParserBase::memoizeObjectLayout(JSObject *obj, PropertyVector &properties)
+{
+    lastObjectIds.clear();
+    lastObjectValueTypes.clear();
+    lastObjectType = nullptr;
+    lastObjectShape = nullptr;
+
+    /*
+     * Only memoize layouts that made it into the object type table; a
+     * singleton object's type carries no property type information that a
+     * reused type could rely on.
+     */
+    if (obj->hasSingletonType() || properties.empty())
+        return;
+
+    if (!lastObjectIds.reserve(properties.length()) ||
+        !lastObjectValueTypes.reserve(properties.length()))
+    {
+        cx->clearPendingException();
+        lastObjectIds.clear();
+        lastObjectValueTypes.clear();
+        return;
+    }
+
+    for (size_t i = 0; i < properties.length(); i++) {
+        JSValueType type = CoarseValueType(properties[i].value);
+        if (type == JSVAL_TYPE_OBJECT) {
+            lastObjectIds.clear();
+            lastObjectValueTypes.clear();
+            return;
+        }
+        lastObjectIds.infallibleAppend(properties[i].id);
+        lastObjectValueTypes.infallibleAppend(type);
+    }
+
+    lastObjectType = obj->type();
+    lastObjectShape = obj->lastProperty();
+}
+
 JSObject *
 JSONParserBase::createFinishedObject(PropertyVector &properties)
 {
+    /*
+     * Fast path: if this object has the same layout as the last one we
+     * finished (the common case when parsing a large array of homogeneous
+     * records), reuse its type and shape directly and just write the slots.
+     */
+    if (JSObject *obj = createMemoizedObject(properties))
+        return obj;
+
     /*
      * Look for an existing cached type and shape for objects with this set of
      * properties.
@@ -587,8 +701,10 @@ JSONParserBase::createFinishedObject(PropertyVector &properties)
     {
         JSObject *obj = cx->compartment()->types.newTypedObject(cx, properties.begin(),
                                                                 properties.length());
-        if (obj)
+        if (obj) {
+            memoizeObjectLayout(obj, properties);
             return obj;
+        }
     }
 
     /*
@@ -617,6 +733,7 @@ JSONParserBase::createFinishedObject(PropertyVector &properties)
      */
     cx->compartment()->types.fixObjectType(cx, obj);
 
+    memoizeObjectLayout(obj, properties);
     return obj;
 }
 
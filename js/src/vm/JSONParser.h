@@ -17,6 +17,12 @@
 
 namespace js {
 
+class Shape;
+
+namespace types {
+struct TypeObject;
+}
+
 // JSONParser base class. JSONParser is templatized to work on either Latin1
 // or TwoByte input strings, JSONParserBase holds all state and methods that
 // can be shared between the two encodings.
@@ -103,6 +109,17 @@ class MOZ_STACK_CLASS JSONParserBase : private JS::AutoGCRooter
     Vector<ElementVector*, 5> freeElements;
     Vector<PropertyVector*, 5> freeProperties;
 
+    // Layout memo for the common case of a large array of objects that all
+    // have the same structure: the property ids, coarse value type tags, type
+    // and shape of the most recent object created through the compartment's
+    // object type table. A subsequent object whose properties match can be
+    // allocated directly with the memoized type and shape, skipping the table
+    // lookup and per-property type updates.
+    Vector<jsid, 8> lastObjectIds;
+    Vector<uint8_t, 8> lastObjectValueTypes;
+    types::TypeObject *lastObjectType;
+    Shape *lastObjectShape;
+
 #ifdef DEBUG
     Token lastToken;
 #endif
@@ -113,7 +130,11 @@ class MOZ_STACK_CLASS JSONParserBase : private JS::AutoGCRooter
         errorHandling(errorHandling),
         stack(cx),
         freeElements(cx),
-        freeProperties(cx)
+        freeProperties(cx),
+        lastObjectIds(cx),
+        lastObjectValueTypes(cx),
+        lastObjectType(nullptr),
+        lastObjectShape(nullptr)
 #ifdef DEBUG
       , lastToken(Error)
 #endif
@@ -174,6 +195,8 @@ class MOZ_STACK_CLASS JSONParserBase : private JS::AutoGCRooter
     void trace(JSTracer *trc);
 
     JSObject *createFinishedObject(PropertyVector &properties);
+    JSObject *createMemoizedObject(PropertyVector &properties);
+    void memoizeObjectLayout(JSObject *obj, PropertyVector &properties);
 
     JSONParserBase(const JSONParserBase &other) MOZ_DELETE;
     void operator=(const JSONParserBase &other) MOZ_DELETE;
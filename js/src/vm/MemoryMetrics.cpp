@@ -329,6 +329,8 @@ StatsCompartmentCallback(JSRuntime *rt, void *data, JSCompartment *compartment)
 
     compartment->compartmentStats = &cStats;
 
+    cStats.cpuTicks = compartment->totalExecutionTicks;
+
     // Measure the compartment object itself, and things hanging off it.
     compartment->addSizeOfIncludingThis(rtStats->mallocSizeOf_,
                                         &cStats.typeInferenceAllocationSiteTables,
@@ -1761,6 +1761,22 @@ GetPropertyHelperInline(JSContext *cx,
                         typename MaybeRooted<jsid, allowGC>::HandleType id,
                         typename MaybeRooted<Value, allowGC>::MutableHandleType vp)
 {
+    /*
+     * Megamorphic access sites funnel into this path, so before walking the
+     * prototype chain consult the runtime's cache of prior walks.  A hit is
+     * validated purely by the receiver's and the holder's shapes; see the
+     * invariants documented on MegamorphicCache.
+     */
+    MegamorphicCache::Entry *cacheEntry = nullptr;
+    if (JSID_IS_ATOM(id)) {
+        if (cx->runtime()->megamorphicCache.lookup(obj->lastProperty(), id, &cacheEntry) &&
+            cacheEntry->holder->lastProperty() == cacheEntry->holderShape)
+        {
+            vp.set(cacheEntry->holder->getSlot(cacheEntry->slot));
+            return true;
+        }
+    }
+
     /* This call site is hot -- use the always-inlined variant of LookupNativeProperty(). */
     typename MaybeRooted<JSObject*, allowGC>::RootType obj2(cx);
     typename MaybeRooted<Shape*, allowGC>::RootType shape(cx);
@@ -1862,6 +1878,38 @@ GetPropertyHelperInline(JSContext *cx,
         return true;
     }
 
+    /*
+     * Remember plain data properties for future megamorphic gets.  Only
+     * chains whose proto links cannot change without a shape change are
+     * cacheable, and nursery holders are skipped since minor GC does not
+     * purge the cache.
+     */
+    if (cacheEntry && shape->hasSlot() && shape->hasDefaultGetter() &&
+        !IsInsideNursery(nobj2))
+    {
+        bool cacheable = true;
+        JSObject *cur = obj;
+        while (cur != nobj2) {
+            // Every link must be native: PurgeProtoChain and SetClassAndProto
+            // stop reshaping at the first non-native object, so a shadowing
+            // define past such a link would not change any shape we key on.
+            if (!cur->isNative() || cur->hasUncacheableProto()) {
+                cacheable = false;
+                break;
+            }
+            TaggedProto proto = cur->getTaggedProto();
+            if (!proto.isObject()) {
+                cacheable = false;
+                break;
+            }
+            cur = proto.toObject();
+        }
+        if (cacheable) {
+            cx->runtime()->megamorphicCache.fill(cacheEntry, obj->lastProperty(), id,
+                                                 nobj2, nobj2->lastProperty(), shape->slot());
+        }
+    }
+
     /* This call site is hot -- use the always-inlined variant of NativeGet(). */
     if (!NativeGetInline<allowGC>(cx, obj, receiver, nobj2, shape, vp))
         return false;
@@ -13,6 +13,7 @@
 
 #include "frontend/TokenStream.h"
 #include "irregexp/RegExpParser.h"
+#include "jit/JitOptions.h"
 #include "vm/MatchPairs.h"
 #include "vm/RegExpStatics.h"
 #include "vm/StringBuffer.h"
@@ -427,7 +428,8 @@ RegExpObject::toString(JSContext *cx) const
 /* RegExpShared */
 
 RegExpShared::RegExpShared(JSAtom *source, RegExpFlag flags)
-  : source(source), flags(flags), parenCount(0), canStringMatch(false), marked_(false)
+  : source(source), flags(flags), parenCount(0), canStringMatch(false), marked_(false),
+    warmUpCount(0)
 {}
 
 RegExpShared::~RegExpShared()
@@ -547,9 +549,28 @@ RegExpShared::execute(JSContext *cx, HandleLinearString input, size_t start,
 
     CompilationMode mode = matches ? Normal : MatchOnly;
 
+    /*
+     * Cold regexps are compiled to compact bytecode and run in the
+     * interpreter; the much more expensive native compilation is deferred
+     * until the regexp has executed enough times to look hot. Short-lived
+     * regexps thus never pay for Irregexp's code generation.
+     */
+    ForceByteCodeEnum force = DontForceByteCode;
+    if (warmUpCount < jit::js_JitOptions.regexpWarmUpThreshold) {
+        warmUpCount++;
+        force = ForceByteCode;
+    }
+
     /* Compile the code at point-of-use. */
-    if (!compileIfNecessary(cx, input, mode, DontForceByteCode))
+    if (force == DontForceByteCode && irregexp::IsNativeRegExpEnabled(cx) &&
+        !compilation(mode, input->hasLatin1Chars()).jitCode)
+    {
+        /* Tier up: compile native code even if bytecode already exists. */
+        if (!compile(cx, input, mode, DontForceByteCode))
+            return RegExpRunStatus_Error;
+    } else if (!compileIfNecessary(cx, input, mode, force)) {
         return RegExpRunStatus_Error;
+    }
 
     /*
      * Ensure sufficient memory for output vector.
@@ -138,6 +138,13 @@ class RegExpShared
     bool               canStringMatch;
     bool               marked_;
 
+    /*
+     * Executions of this regexp so far. Cold regexps run in the bytecode
+     * interpreter; once this count reaches the warm-up threshold, execute()
+     * tiers up to native code.
+     */
+    uint32_t           warmUpCount;
+
     RegExpCompilation  compilationArray[4];
 
     static int CompilationIndex(CompilationMode mode, bool latin1) {
@@ -181,6 +181,8 @@ JSRuntime::JSRuntime(JSRuntime *parentRuntime)
 #endif
     spsProfiler(thisFromCtor()),
     profilingScripts(false),
+    compartmentClockEnabled(false),
+    scriptProfileHints(nullptr),
     suppressProfilerSampling(false),
     hadOutOfMemory(false),
     haveCreatedContext(false),
@@ -436,6 +438,7 @@ JSRuntime::~JSRuntime()
     js_delete(execAlloc_);  /* Delete after jitRuntime_. */
 
     js_delete(ionPcScriptCache);
+    js_delete(scriptProfileHints);
 
     gc.storeBuffer.disable();
     gc.nursery.disable();
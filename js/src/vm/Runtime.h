@@ -220,6 +220,95 @@ class NativeIterCache
     }
 };
 
+class NativeObject;
+class Shape;
+
+/*
+ * Cache for speeding up megamorphic property gets on native objects.
+ *
+ * Once an access site has seen too many shapes the jits give up on inline
+ * caches and call into the VM lookup path, which walks the receiver's
+ * prototype chain on every get.  This cache memoizes the result of those
+ * walks: a fixed-size, direct-mapped table from (receiver shape, id) to the
+ * object holding the property and the slot it lives in, validated purely by
+ * shape pointers.
+ *
+ * The validation leans on the same invariants the jit ICs rely on: adding a
+ * property that shadows one on the prototype chain regenerates the shape of
+ * the object that held it (NativeObject::shadowingShapeChange), and changing
+ * an object's prototype either regenerates its shape or marks the object as
+ * having an uncacheable proto, which also regenerates the shape
+ * (JSObject::setUncacheableProto).  Entries are only filled when every
+ * object from the receiver up to the holder is native with a cacheable
+ * proto, and only for plain data properties, so if the receiver's and the
+ * holder's shapes are unchanged at lookup time the cached slot is still
+ * correct.
+ *
+ * The table is purged at GC, so the raw pointers in it are never traced.
+ * Nursery-allocated holders must not be cached: a minor GC moves them
+ * without purging this cache.
+ */
+class MegamorphicCache
+{
+  public:
+    struct Entry
+    {
+        /* Receiver shape and property key the entry was filled for. */
+        Shape *shape;
+        jsid id;
+
+        /* Object on the receiver's prototype chain holding the property. */
+        NativeObject *holder;
+
+        /* Shape of holder when the entry was filled. */
+        Shape *holderShape;
+
+        /* Fixed or dynamic slot of the property on holder. */
+        uint32_t slot;
+    };
+
+  private:
+    static const size_t SIZE = size_t(1) << 9;
+
+    Entry entries_[SIZE];
+
+    static size_t getIndex(Shape *shape, jsid id) {
+        uintptr_t hash = uintptr_t(shape) ^ (uintptr_t(shape) >> 13) ^ JSID_BITS(id);
+        return size_t(hash) % SIZE;
+    }
+
+  public:
+    MegamorphicCache() {
+        purge();
+    }
+
+    void purge() {
+        mozilla::PodArrayZero(entries_);
+    }
+
+    /*
+     * Look up the entry for (shape, id) and return whether it matches.  On a
+     * hit the caller must still check that the holder's current shape equals
+     * entry->holderShape before using entry->slot.  On a miss *entryp is the
+     * entry to pass to fill().
+     */
+    bool lookup(Shape *shape, jsid id, Entry **entryp) {
+        Entry *entry = &entries_[getIndex(shape, id)];
+        *entryp = entry;
+        return entry->shape == shape && entry->id == id;
+    }
+
+    void fill(Entry *entry, Shape *shape, jsid id, NativeObject *holder,
+              Shape *holderShape, uint32_t slot)
+    {
+        entry->shape = shape;
+        entry->id = id;
+        entry->holder = holder;
+        entry->holderShape = holderShape;
+        entry->slot = slot;
+    }
+};
+
 /*
  * Cache for speeding up repetitive creation of objects in the VM.
  * When an object is created which matches the criteria in the 'key' section
@@ -1029,6 +1118,22 @@ struct JSRuntime : public JS::shadow::Runtime,
     /* If true, new scripts must be created with PC counter information. */
     bool                profilingScripts;
 
+    /*
+     * If true, compartments accumulate execution ticks at their outermost
+     * enter/leave (JSCompartment::totalExecutionTicks), so embedders can
+     * attribute CPU to compartments without running a profiler.
+     */
+    bool                compartmentClockEnabled;
+
+    /*
+     * Profile hints imported by the embedder from a previous session,
+     * keyed by JSScript::profileHash(), or null if none were imported.
+     * Written only on the main thread before any script in question is
+     * compiled; read when scripts are created.  See
+     * js::ImportScriptProfileHint.
+     */
+    js::ScriptProfileHintMap *scriptProfileHints;
+
     /* Whether sampling should be enabled or not. */
   private:
     bool                suppressProfilerSampling;
@@ -1138,6 +1243,7 @@ struct JSRuntime : public JS::shadow::Runtime,
     js::ScopeCoordinateNameCache scopeCoordinateNameCache;
     js::NewObjectCache  newObjectCache;
     js::NativeIterCache nativeIterCache;
+    js::MegamorphicCache megamorphicCache;
     js::UncompressedSourceCache uncompressedSourceCache;
     js::EvalCache       evalCache;
     js::LazyScriptCache lazyScriptCache;
@@ -26,10 +26,17 @@
 #include "vm/NativeObject-inl.h"
 #include "vm/Runtime-inl.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define JS_SHAPE_TABLE_SSE2 1
+# include <emmintrin.h>
+#endif
+
 using namespace js;
 using namespace js::gc;
 
 using mozilla::CeilingLog2Size;
+using mozilla::CountTrailingZeroes32;
 using mozilla::DebugOnly;
 using mozilla::PodZero;
 using mozilla::RotateLeft;
@@ -46,11 +53,18 @@ ShapeTable::init(ThreadSafeContext *cx, Shape *lastProp)
 
     /*
      * Use rt->calloc for memory accounting and overpressure handling
-     * without OOM reporting. See ShapeTable::change.
+     * without OOM reporting. See ShapeTable::change. Zeroed control bytes
+     * are CTRL_FREE, so both arrays start out all-free.
      */
     entries = cx->pod_calloc<Shape *>(JS_BIT(sizeLog2));
     if (!entries)
         return false;
+    ctrl = cx->pod_calloc<uint8_t>(JS_BIT(sizeLog2));
+    if (!ctrl) {
+        js_free(entries);
+        entries = nullptr;
+        return false;
+    }
 
     hashShift = HASH_BITS - sizeLog2;
     for (Shape::Range<NoGC> r(lastProp); !r.empty(); r.popFront()) {
@@ -63,7 +77,7 @@ ShapeTable::init(ThreadSafeContext *cx, Shape *lastProp)
          * (nearest to lastProp) must win. See bug 600067.
          */
         if (!SHAPE_FETCH(spp))
-            SHAPE_STORE_PRESERVING_COLLISION(spp, &shape);
+            putEntry(spp, &shape);
     }
     return true;
 }
@@ -164,83 +178,72 @@ Shape::hashify(ThreadSafeContext *cx, Shape *shape)
 }
 
 /*
- * Double hashing needs the second hash code to be relatively prime to table
- * size, so we simply make hash2 odd.
+ * Return a bitmask with bit i set iff the i-th control byte of the group
+ * equals |byte|. Control bytes are probed an aligned GROUP_SIZE at a time;
+ * on x86 a single SSE2 byte comparison covers the whole group.
  */
-#define HASH1(hash0,shift)      ((hash0) >> (shift))
-#define HASH2(hash0,log2,shift) ((((hash0) << (log2)) >> (shift)) | 1)
+static MOZ_ALWAYS_INLINE uint32_t
+MatchShapeTableGroup(const uint8_t *group, uint8_t byte)
+{
+#ifdef JS_SHAPE_TABLE_SSE2
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    __m128i match = _mm_set1_epi8(char(byte));
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, match)));
+#else
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < ShapeTable::GROUP_SIZE; i++) {
+        if (group[i] == byte)
+            bits |= uint32_t(1) << i;
+    }
+    return bits;
+#endif
+}
 
 Shape **
 ShapeTable::search(jsid id, bool adding)
 {
-    js::HashNumber hash0, hash1, hash2;
-    int sizeLog2;
-    Shape *stored, *shape, **spp, **firstRemoved;
-    uint32_t sizeMask;
-
     MOZ_ASSERT(entries);
     MOZ_ASSERT(!JSID_IS_EMPTY(id));
 
-    /* Compute the primary hash address. */
-    hash0 = HashId(id);
-    hash1 = HASH1(hash0, hashShift);
-    spp = entries + hash1;
+    HashNumber hash0 = HashId(id);
+    uint8_t h2 = hash2(hash0);
 
-    /* Miss: return space for a new entry. */
-    stored = *spp;
-    if (SHAPE_IS_FREE(stored))
-        return spp;
-
-    /* Hit: return entry. */
-    shape = SHAPE_CLEAR_COLLISION(stored);
-    if (shape && shape->propidRaw() == id)
-        return spp;
-
-    /* Collision: double hash. */
-    sizeLog2 = HASH_BITS - hashShift;
-    hash2 = HASH2(hash0, sizeLog2, hashShift);
-    sizeMask = JS_BITMASK(sizeLog2);
-
-#ifdef DEBUG
-    uintptr_t collision_flag = SHAPE_COLLISION;
-#endif
+    uint32_t groupMask = (capacity() >> GROUP_SIZE_LOG2) - 1;
+    uint32_t group = (hash0 >> hashShift) & groupMask;
 
     /* Save the first removed entry pointer so we can recycle it if adding. */
-    if (SHAPE_IS_REMOVED(stored)) {
-        firstRemoved = spp;
-    } else {
-        firstRemoved = nullptr;
-        if (adding && !SHAPE_HAD_COLLISION(stored))
-            SHAPE_FLAG_COLLISION(spp, shape);
-#ifdef DEBUG
-        collision_flag &= uintptr_t(*spp) & SHAPE_COLLISION;
-#endif
-    }
+    Shape **firstRemoved = nullptr;
 
-    for (;;) {
-        hash1 -= hash2;
-        hash1 &= sizeMask;
-        spp = entries + hash1;
-
-        stored = *spp;
-        if (SHAPE_IS_FREE(stored))
-            return (adding && firstRemoved) ? firstRemoved : spp;
-
-        shape = SHAPE_CLEAR_COLLISION(stored);
-        if (shape && shape->propidRaw() == id) {
-            MOZ_ASSERT(collision_flag);
-            return spp;
+    /*
+     * Probe group by group with triangular increments 1, 2, 3, ...; for a
+     * power-of-two group count this visits every group exactly once, and
+     * needsToGrow() keeps at least a quarter of the slots free, so some
+     * group always contains a free slot and terminates the loop.
+     */
+    for (uint32_t step = 0; ; group = (group + ++step) & groupMask) {
+        const uint8_t *groupCtrl = ctrl + (group << GROUP_SIZE_LOG2);
+        Shape **groupEntries = entries + (group << GROUP_SIZE_LOG2);
+
+        /* Hit: a full slot whose hash fragment and propid both match. */
+        uint32_t matches = MatchShapeTableGroup(groupCtrl, h2);
+        while (matches) {
+            uint32_t i = CountTrailingZeroes32(matches);
+            if (groupEntries[i]->propidRaw() == id)
+                return &groupEntries[i];
+            matches &= matches - 1;
         }
 
-        if (SHAPE_IS_REMOVED(stored)) {
-            if (!firstRemoved)
-                firstRemoved = spp;
-        } else {
-            if (adding && !SHAPE_HAD_COLLISION(stored))
-                SHAPE_FLAG_COLLISION(spp, shape);
-#ifdef DEBUG
-            collision_flag &= uintptr_t(*spp) & SHAPE_COLLISION;
-#endif
+        /* Miss: a free slot ends the probe sequence for this id. */
+        uint32_t free = MatchShapeTableGroup(groupCtrl, CTRL_FREE);
+        if (free)
+            return (adding && firstRemoved)
+                   ? firstRemoved
+                   : &groupEntries[CountTrailingZeroes32(free)];
+
+        if (adding && !firstRemoved) {
+            uint32_t removed = MatchShapeTableGroup(groupCtrl, CTRL_REMOVED);
+            if (removed)
+                firstRemoved = &groupEntries[CountTrailingZeroes32(removed)];
         }
     }
 
@@ -248,16 +251,45 @@ ShapeTable::search(jsid id, bool adding)
     return nullptr;
 }
 
+void
+ShapeTable::putEntry(Shape **spp, Shape *shape)
+{
+    size_t index = spp - entries;
+    MOZ_ASSERT(index < capacity());
+    MOZ_ASSERT(SHAPE_IS_FREE(*spp));
+
+    if (ctrl[index] == CTRL_REMOVED) {
+        MOZ_ASSERT(removedCount > 0);
+        --removedCount;
+    }
+    ctrl[index] = hash2(HashId(shape->propid()));
+    *spp = shape;
+}
+
+void
+ShapeTable::removeEntry(Shape **spp)
+{
+    size_t index = spp - entries;
+    MOZ_ASSERT(index < capacity());
+    MOZ_ASSERT(!SHAPE_IS_FREE(*spp));
+
+    *spp = nullptr;
+    ctrl[index] = CTRL_REMOVED;
+    ++removedCount;
+    --entryCount;
+}
+
 #ifdef JSGC_COMPACTING
 void
 ShapeTable::fixupAfterMovingGC()
 {
-    int log2 = HASH_BITS - hashShift;
-    uint32_t size = JS_BIT(log2);
+    uint32_t size = capacity();
     for (HashNumber i = 0; i < size; i++) {
-        Shape *shape = SHAPE_FETCH(&entries[i]);
+        Shape *shape = entries[i];
+
+        /* Moving a shape leaves its propid alone, so ctrl needs no update. */
         if (shape && IsForwarded(shape))
-            SHAPE_STORE_PRESERVING_COLLISION(&entries[i], Forwarded(shape));
+            entries[i] = Forwarded(shape);
     }
 }
 #endif
@@ -277,27 +309,35 @@ ShapeTable::change(int log2Delta, ThreadSafeContext *cx)
     Shape **newTable = cx->pod_calloc<Shape *>(newsize);
     if (!newTable)
         return false;
+    uint8_t *newCtrl = cx->pod_calloc<uint8_t>(newsize);
+    if (!newCtrl) {
+        js_free(newTable);
+        return false;
+    }
 
-    /* Now that we have newTable allocated, update members. */
+    /* Now that we have the new arrays allocated, update members. */
     hashShift = HASH_BITS - newlog2;
     removedCount = 0;
     Shape **oldTable = entries;
+    uint8_t *oldCtrl = ctrl;
     entries = newTable;
+    ctrl = newCtrl;
 
     /* Copy only live entries, leaving removed and free ones behind. */
     for (Shape **oldspp = oldTable; oldsize != 0; oldspp++) {
-        Shape *shape = SHAPE_FETCH(oldspp);
+        Shape *shape = *oldspp;
         MOZ_ASSERT(cx->isThreadLocal(shape));
         if (shape) {
             Shape **spp = search(shape->propid(), true);
             MOZ_ASSERT(SHAPE_IS_FREE(*spp));
-            *spp = shape;
+            putEntry(spp, shape);
         }
         oldsize--;
     }
 
-    /* Finally, free the old entries storage. */
+    /* Finally, free the old storage. */
     js_free(oldTable);
+    js_free(oldCtrl);
     return true;
 }
 
@@ -626,7 +666,7 @@ NativeObject::addPropertyInternal(typename ExecutionModeTraits<mode>::ExclusiveC
 
         if (table) {
             /* Store the tree node pointer in the table entry for id. */
-            SHAPE_STORE_PRESERVING_COLLISION(spp, static_cast<Shape *>(shape));
+            table->putEntry(spp, static_cast<Shape *>(shape));
             ++table->entryCount;
 
             /* Pass the table along to the new last property, namely shape. */
@@ -804,7 +844,7 @@ NativeObject::putProperty(typename ExecutionModeTraits<mode>::ExclusiveContextTy
     }
 
     /* Property exists: search must have returned a valid *spp. */
-    MOZ_ASSERT_IF(spp, !SHAPE_IS_REMOVED(*spp));
+    MOZ_ASSERT_IF(spp, !SHAPE_IS_FREE(*spp));
 
     if (!CheckCanChangeAttrs(cx, obj, shape, &attrs))
         return nullptr;
@@ -1077,25 +1117,18 @@ NativeObject::removeProperty(ExclusiveContext *cx, jsid id_)
     if (self->inDictionaryMode()) {
         ShapeTable &table = self->lastProperty()->table();
 
-        if (SHAPE_HAD_COLLISION(*spp)) {
-            *spp = SHAPE_REMOVED;
-            ++table.removedCount;
-            --table.entryCount;
-        } else {
-            *spp = nullptr;
-            --table.entryCount;
+        table.removeEntry(spp);
 
 #ifdef DEBUG
-            /*
-             * Check the consistency of the table but limit the number of
-             * checks not to alter significantly the complexity of the
-             * delete in debug builds, see bug 534493.
-             */
-            Shape *aprop = self->lastProperty();
-            for (int n = 50; --n >= 0 && aprop->parent; aprop = aprop->parent)
-                MOZ_ASSERT_IF(aprop != shape, self->contains(cx, aprop));
+        /*
+         * Check the consistency of the table but limit the number of
+         * checks not to alter significantly the complexity of the
+         * delete in debug builds, see bug 534493.
+         */
+        Shape *aprop = self->lastProperty();
+        for (int n = 50; --n >= 0 && aprop->parent; aprop = aprop->parent)
+            MOZ_ASSERT_IF(aprop != shape, self->contains(cx, aprop));
 #endif
-        }
 
         {
             /* Remove shape from its non-circular doubly linked list. */
@@ -1231,8 +1264,9 @@ NativeObject::replaceWithNewEquivalentShape(ThreadSafeContext *cx, Shape *oldSha
     if (newShape == self->lastProperty())
         oldShape->handoffTableTo(newShape);
 
+    /* Same propid, so the slot's control byte is already correct. */
     if (spp)
-        SHAPE_STORE_PRESERVING_COLLISION(spp, newShape);
+        *spp = newShape;
     return newShape;
 }
 
@@ -128,16 +128,29 @@ static const uint32_t SHAPE_INVALID_SLOT = JS_BIT(24) - 1;
 static const uint32_t SHAPE_MAXIMUM_SLOT = JS_BIT(24) - 2;
 
 /*
- * Shapes use multiplicative hashing, but specialized to
- * minimize footprint.
+ * Shapes use an open-addressed table probed a group at a time: a byte of
+ * control metadata per slot holds either a free/removed sentinel or seven
+ * bits of the entry's hash, so a probe scans GROUP_SIZE slots with at most
+ * one cache line of metadata (and a single SSE2 comparison on x86) before
+ * it ever touches a Shape.
  */
 struct ShapeTable {
     static const uint32_t HASH_BITS     = mozilla::tl::BitSize<HashNumber>::value;
     static const uint32_t MIN_ENTRIES   = 11;
 
-    // This value is low because it's common for a ShapeTable to be created
-    // with an entryCount of zero.
-    static const uint32_t MIN_SIZE_LOG2 = 2;
+    /* Number of slots examined per probe step; one metadata group. */
+    static const uint32_t GROUP_SIZE_LOG2 = 4;
+    static const uint32_t GROUP_SIZE      = JS_BIT(GROUP_SIZE_LOG2);
+
+    /*
+     * Control byte values. Full slots hold hash2() of the entry, which is
+     * always in [1, 0x7f], so both sentinels are distinguishable.
+     */
+    static const uint8_t CTRL_FREE    = 0x00;
+    static const uint8_t CTRL_REMOVED = 0x80;
+
+    /* The table is probed in aligned groups, so it holds at least one. */
+    static const uint32_t MIN_SIZE_LOG2 = GROUP_SIZE_LOG2;
     static const uint32_t MIN_SIZE      = JS_BIT(MIN_SIZE_LOG2);
 
     int             hashShift;          /* multiplicative hash shift */
@@ -148,6 +161,7 @@ struct ShapeTable {
                                            freelist in owning dictionary-mode
                                            object */
     js::Shape       **entries;          /* table of ptrs to shared tree nodes */
+    uint8_t         *ctrl;              /* control byte per entry slot */
 
     explicit ShapeTable(uint32_t nentries)
       : hashShift(HASH_BITS - MIN_SIZE_LOG2),
@@ -155,11 +169,12 @@ struct ShapeTable {
         removedCount(0),
         freelist(SHAPE_INVALID_SLOT)
     {
-        /* NB: entries is set by init, which must be called. */
+        /* NB: entries and ctrl are set by init, which must be called. */
     }
 
     ~ShapeTable() {
         js_free(entries);
+        js_free(ctrl);
     }
 
     /* By definition, hashShift = HASH_BITS - log2(capacity). */
@@ -167,10 +182,10 @@ struct ShapeTable {
 
     /*
      * This counts the ShapeTable object itself (which must be
-     * heap-allocated) and its |entries| array.
+     * heap-allocated) and its |entries| and |ctrl| arrays.
      */
     size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
-        return mallocSizeOf(this) + mallocSizeOf(entries);
+        return mallocSizeOf(this) + mallocSizeOf(entries) + mallocSizeOf(ctrl);
     }
 
     /* Whether we need to grow.  We want to do this if the load factor is >= 0.75 */
@@ -195,10 +210,26 @@ struct ShapeTable {
     bool            change(int log2Delta, ThreadSafeContext *cx);
     Shape           **search(jsid id, bool adding);
 
+    /*
+     * Store a new entry in the slot returned by search(id, true), keeping
+     * the control metadata in sync. The caller maintains entryCount.
+     */
+    void            putEntry(Shape **spp, Shape *shape);
+
+    /* Remove the live entry in |spp|; maintains both counts. */
+    void            removeEntry(Shape **spp);
+
 #ifdef JSGC_COMPACTING
     /* Update entries whose shapes have been moved */
     void            fixupAfterMovingGC();
 #endif
+
+  private:
+    /* Seven hash bits stored in the control byte, never 0. */
+    static uint8_t hash2(HashNumber hash0) {
+        uint8_t h = hash0 & 0x7f;
+        return h ? h : 0x7f;
+    }
 };
 
 /*
@@ -1287,11 +1318,10 @@ struct StackShape
 
 } /* namespace js */
 
-/* js::Shape pointer tag bit indicating a collision. */
-#define SHAPE_COLLISION                 (uintptr_t(1))
-#define SHAPE_REMOVED                   ((js::Shape *) SHAPE_COLLISION)
-
-/* Functions to get and set shape pointer values and collision flags. */
+/*
+ * Functions to read shape table slots. Removed and free slots both hold
+ * nullptr; the table's control bytes tell them apart.
+ */
 
 inline bool
 SHAPE_IS_FREE(js::Shape *shape)
@@ -1299,47 +1329,10 @@ SHAPE_IS_FREE(js::Shape *shape)
     return shape == nullptr;
 }
 
-inline bool
-SHAPE_IS_REMOVED(js::Shape *shape)
-{
-    return shape == SHAPE_REMOVED;
-}
-
-inline bool
-SHAPE_IS_LIVE(js::Shape *shape)
-{
-    return shape > SHAPE_REMOVED;
-}
-
-inline void
-SHAPE_FLAG_COLLISION(js::Shape **spp, js::Shape *shape)
-{
-    *spp = reinterpret_cast<js::Shape*>(uintptr_t(shape) | SHAPE_COLLISION);
-}
-
-inline bool
-SHAPE_HAD_COLLISION(js::Shape *shape)
-{
-    return uintptr_t(shape) & SHAPE_COLLISION;
-}
-
-inline js::Shape *
-SHAPE_CLEAR_COLLISION(js::Shape *shape)
-{
-    return reinterpret_cast<js::Shape*>(uintptr_t(shape) & ~SHAPE_COLLISION);
-}
-
 inline js::Shape *
 SHAPE_FETCH(js::Shape **spp)
 {
-    return SHAPE_CLEAR_COLLISION(*spp);
-}
-
-inline void
-SHAPE_STORE_PRESERVING_COLLISION(js::Shape **spp, js::Shape *shape)
-{
-    *spp = reinterpret_cast<js::Shape*>(uintptr_t(shape) |
-                                        uintptr_t(SHAPE_HAD_COLLISION(*spp)));
+    return *spp;
 }
 
 namespace js {
@@ -718,6 +718,11 @@ mozJSComponentLoader::ObjectForLocation(ComponentLoaderInfo &aInfo,
         // source isn't supported in that configuration. That's ok though,
         // because we only do mReuseLoaderGlobal on b2g, where we invoke
         // setDiscardSource(true) on the entire global.
+        //
+        // Lazy source doesn't cost us lazy parsing: function bodies are
+        // syntax-parsed only, and delazification (and re-delazification after
+        // a GC relazifies a cold function) reloads the source through the
+        // source hook, which reads it back out of omni.ja or the file.
         CompileOptions options(cx);
         options.setNoScriptRval(mReuseLoaderGlobal ? false : true)
                .setVersion(JSVERSION_LATEST)
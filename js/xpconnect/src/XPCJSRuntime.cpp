@@ -1529,6 +1529,14 @@ ReloadPrefsCallback(const char *pref, void *data)
                                                  "baselinejit.unsafe_eager_compilation");
     bool useIonEager = Preferences::GetBool(JS_OPTIONS_DOT_STR "ion.unsafe_eager_compilation");
 
+    // Optional tunable warm-up thresholds, so deployments that run the same
+    // hot code every session can shorten the tiering delay without going
+    // fully eager.  -1 (the default when unset) keeps the engine defaults.
+    int32_t baselineThreshold =
+        Preferences::GetInt(JS_OPTIONS_DOT_STR "baselinejit.threshold", -1);
+    int32_t ionThreshold =
+        Preferences::GetInt(JS_OPTIONS_DOT_STR "ion.threshold", -1);
+
     sDiscardSystemSource = Preferences::GetBool(JS_OPTIONS_DOT_STR "discardSystemSource");
 
     bool werror = Preferences::GetBool(JS_OPTIONS_DOT_STR "werror");
@@ -1547,10 +1555,12 @@ ReloadPrefsCallback(const char *pref, void *data)
 
     JS_SetParallelParsingEnabled(rt, parallelParsing);
     JS_SetOffthreadIonCompilationEnabled(rt, offthreadIonCompilation);
+    js::SetCompartmentClockEnabled(rt,
+        Preferences::GetBool(JS_OPTIONS_DOT_STR "compartment_cpu_accounting"));
     JS_SetGlobalJitCompilerOption(rt, JSJITCOMPILER_BASELINE_WARMUP_TRIGGER,
-                                  useBaselineEager ? 0 : -1);
+                                  useBaselineEager ? 0 : baselineThreshold);
     JS_SetGlobalJitCompilerOption(rt, JSJITCOMPILER_ION_WARMUP_TRIGGER,
-                                  useIonEager ? 0 : -1);
+                                  useIonEager ? 0 : ionThreshold);
 }
 
 XPCJSRuntime::~XPCJSRuntime()
@@ -2299,6 +2309,24 @@ ReportCompartmentStats(const JS::CompartmentStats &cStats,
             "be worth showing individually.");
     }
 
+    if (cStats.cpuTicks > 0) {
+        // CPU accounting isn't a byte measurement, so it must not live under
+        // the "explicit" tree; re-root the compartment path instead.
+        nsCString cpuPath(NS_LITERAL_CSTRING("compartment-cpu/"));
+        NS_NAMED_LITERAL_CSTRING(explicitPrefix, "explicit/");
+        if (StringBeginsWith(cJSPathPrefix, explicitPrefix)) {
+            cpuPath.Append(Substring(cJSPathPrefix, explicitPrefix.Length()));
+        } else {
+            cpuPath.Append(cJSPathPrefix);
+        }
+        cpuPath.AppendLiteral("cpu-ticks");
+        REPORT(cpuPath, KIND_OTHER, UNITS_COUNT_CUMULATIVE, cStats.cpuTicks,
+            "Execution ticks attributed to code running with this compartment "
+            "entered, inclusive of nested compartments. Only accumulated while "
+            "javascript.options.compartment_cpu_accounting is enabled; "
+            "consumers should sample and diff to compute rates.");
+    }
+
     if (gcTotalOut)
         *gcTotalOut += gcTotal;
 
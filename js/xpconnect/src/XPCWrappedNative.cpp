@@ -1604,6 +1604,7 @@ class MOZ_STACK_CLASS CallMethodHelper
     nsresult mInvokeResult;
     nsIInterfaceInfo* const mIFaceInfo;
     const nsXPTMethodInfo* mMethodInfo;
+    const XPCCallDescriptor* mDesc;
     nsISupports* const mCallee;
     const uint16_t mVTableIndex;
     HandleId mIdxValueId;
@@ -1668,6 +1669,7 @@ public:
         , mInvokeResult(NS_ERROR_UNEXPECTED)
         , mIFaceInfo(ccx.GetInterface()->GetInterfaceInfo())
         , mMethodInfo(nullptr)
+        , mDesc(nullptr)
         , mCallee(ccx.GetTearOff()->GetNative())
         , mVTableIndex(ccx.GetMethodIndex())
         , mIdxValueId(ccx.GetRuntime()->GetStringID(XPCJSRuntime::IDX_VALUE))
@@ -1679,6 +1681,8 @@ public:
     {
         // Success checked later.
         mIFaceInfo->GetMethodInfo(mVTableIndex, &mMethodInfo);
+        if (mMethodInfo && mVTableIndex != 0)
+            mDesc = ccx.GetInterface()->GetCallDescriptor(mVTableIndex);
     }
 
     ~CallMethodHelper();
@@ -1714,7 +1718,7 @@ CallMethodHelper::Call()
         return QueryInterfaceFastPath();
     }
 
-    if (!mMethodInfo) {
+    if (!mMethodInfo || !mDesc) {
         Throw(NS_ERROR_XPC_CANT_GET_METHOD_INFO, mCallContext);
         return false;
     }
@@ -1763,17 +1767,16 @@ CallMethodHelper::~CallMethodHelper()
                 // Clean up the array contents if necessary.
                 if (dp->DoesValNeedCleanup()) {
                     // We need some basic information to properly destroy the array.
+                    const XPCCallDescriptor::ParamDesc& pd = mDesc->Param(i);
                     uint32_t array_count = 0;
-                    nsXPTType datum_type;
-                    if (!GetArraySizeFromParam(i, &array_count) ||
-                        !NS_SUCCEEDED(mIFaceInfo->GetTypeForParam(mVTableIndex,
-                                                                  &paramInfo,
-                                                                  1, &datum_type))) {
+                    if (!pd.mHasDatumType ||
+                        !GetArraySizeFromParam(i, &array_count)) {
                         // XXXbholley - I'm not convinced that the above calls will
                         // ever fail.
                         NS_ERROR("failed to get array information, we'll leak here");
                         continue;
                     }
+                    nsXPTType datum_type = pd.mDatumType;
 
                     // Loop over the array contents. For each one, we create a
                     // dummy 'val' and pass it to the cleanup helper.
@@ -1801,16 +1804,14 @@ bool
 CallMethodHelper::GetArraySizeFromParam(uint8_t paramIndex,
                                         uint32_t* result) const
 {
-    nsresult rv;
-    const nsXPTParamInfo& paramInfo = mMethodInfo->GetParam(paramIndex);
+    const XPCCallDescriptor::ParamDesc& pd = mDesc->Param(paramIndex);
 
     // TODO fixup the various exceptions that are thrown
 
-    rv = mIFaceInfo->GetSizeIsArgNumberForParam(mVTableIndex, &paramInfo, 0, &paramIndex);
-    if (NS_FAILED(rv))
+    if (!pd.mHasSizeArg)
         return Throw(NS_ERROR_XPC_CANT_GET_ARRAY_INFO, mCallContext);
 
-    *result = GetDispatchParam(paramIndex)->val.u32;
+    *result = GetDispatchParam(pd.mSizeArgIndex)->val.u32;
 
     return true;
 }
@@ -1820,27 +1821,24 @@ CallMethodHelper::GetInterfaceTypeFromParam(uint8_t paramIndex,
                                             const nsXPTType& datum_type,
                                             nsID* result) const
 {
-    nsresult rv;
-    const nsXPTParamInfo& paramInfo = mMethodInfo->GetParam(paramIndex);
+    const XPCCallDescriptor::ParamDesc& pd = mDesc->Param(paramIndex);
     uint8_t tag = datum_type.TagPart();
 
     // TODO fixup the various exceptions that are thrown
 
     if (tag == nsXPTType::T_INTERFACE) {
-        rv = mIFaceInfo->GetIIDForParamNoAlloc(mVTableIndex, &paramInfo, result);
-        if (NS_FAILED(rv))
+        if (!pd.mHasIID)
             return ThrowBadParam(NS_ERROR_XPC_CANT_GET_PARAM_IFACE_INFO,
                                  paramIndex, mCallContext);
+        *result = pd.mIID;
     } else if (tag == nsXPTType::T_INTERFACE_IS) {
-        rv = mIFaceInfo->GetInterfaceIsArgNumberForParam(mVTableIndex, &paramInfo,
-                                                         &paramIndex);
-        if (NS_FAILED(rv))
+        if (!pd.mHasIfaceIsArg)
             return Throw(NS_ERROR_XPC_CANT_GET_ARRAY_INFO, mCallContext);
 
-        nsID* p = (nsID*) GetDispatchParam(paramIndex)->val.p;
+        nsID* p = (nsID*) GetDispatchParam(pd.mIfaceIsArgIndex)->val.p;
         if (!p)
             return ThrowBadParam(NS_ERROR_XPC_CANT_GET_PARAM_IFACE_INFO,
-                                 paramIndex, mCallContext);
+                                 pd.mIfaceIsArgIndex, mCallContext);
         *result = *p;
     }
     return true;
@@ -1896,11 +1894,12 @@ CallMethodHelper::GatherAndConvertResults()
                 type.TagPart() == nsXPTType::T_PWSTRING_SIZE_IS;
 
         if (isArray) {
-            if (NS_FAILED(mIFaceInfo->GetTypeForParam(mVTableIndex, &paramInfo, 1,
-                                                      &datum_type))) {
+            const XPCCallDescriptor::ParamDesc& pd = mDesc->Param(i);
+            if (!pd.mHasDatumType) {
                 Throw(NS_ERROR_XPC_CANT_GET_ARRAY_INFO, mCallContext);
                 return false;
             }
+            datum_type = pd.mDatumType;
         } else
             datum_type = type;
 
@@ -2008,42 +2007,20 @@ CallMethodHelper::QueryInterfaceFastPath()
 bool
 CallMethodHelper::InitializeDispatchParams()
 {
-    const uint8_t wantsOptArgc = mMethodInfo->WantsOptArgc() ? 1 : 0;
-    const uint8_t wantsJSContext = mMethodInfo->WantsContext() ? 1 : 0;
-    const uint8_t paramCount = mMethodInfo->GetParamCount();
-    uint8_t requiredArgs = paramCount;
-    uint8_t hasRetval = 0;
-
-    // XXX ASSUMES that retval is last arg. The xpidl compiler ensures this.
-    if (paramCount && mMethodInfo->GetParam(paramCount-1).IsRetval()) {
-        hasRetval = 1;
-        requiredArgs--;
-    }
-
-    if (mArgc < requiredArgs || wantsOptArgc) {
-        if (wantsOptArgc)
-            mOptArgcIndex = requiredArgs;
-
-        // skip over any optional arguments
-        while (requiredArgs && mMethodInfo->GetParam(requiredArgs-1).IsOptional())
-            requiredArgs--;
-
-        if (mArgc < requiredArgs) {
-            Throw(NS_ERROR_XPC_NOT_ENOUGH_ARGS, mCallContext);
-            return false;
-        }
+    // The argument layout was computed once, when the descriptor was
+    // compiled; all that's left to do per call is the arity check.
+    const uint8_t wantsOptArgc = mDesc->WantsOptArgc() ? 1 : 0;
+    const uint8_t wantsJSContext = mDesc->WantsJSContext() ? 1 : 0;
+    const uint8_t paramCount = mDesc->ParamCount();
+    const uint8_t requiredArgs = mDesc->RequiredArgs();
+
+    if (mArgc < requiredArgs) {
+        Throw(NS_ERROR_XPC_NOT_ENOUGH_ARGS, mCallContext);
+        return false;
     }
 
-    if (wantsJSContext) {
-        if (wantsOptArgc)
-            // Need to bump mOptArgcIndex up one here.
-            mJSContextIndex = mOptArgcIndex++;
-        else if (mMethodInfo->IsSetter() || mMethodInfo->IsGetter())
-            // For attributes, we always put the JSContext* first.
-            mJSContextIndex = 0;
-        else
-            mJSContextIndex = paramCount - hasRetval;
-    }
+    mJSContextIndex = mDesc->JSContextIndex();
+    mOptArgcIndex = mDesc->OptArgcIndex();
 
     // iterate through the params to clear flags (for safe cleanup later)
     for (uint8_t i = 0; i < paramCount + wantsJSContext + wantsOptArgc; i++) {
@@ -2166,11 +2143,14 @@ CallMethodHelper::ConvertIndependentParam(uint8_t i)
     }
 
     nsID param_iid;
-    if (type_tag == nsXPTType::T_INTERFACE &&
-        NS_FAILED(mIFaceInfo->GetIIDForParamNoAlloc(mVTableIndex, &paramInfo,
-                                                    &param_iid))) {
-        ThrowBadParam(NS_ERROR_XPC_CANT_GET_PARAM_IFACE_INFO, i, mCallContext);
-        return false;
+    if (type_tag == nsXPTType::T_INTERFACE) {
+        const XPCCallDescriptor::ParamDesc& pd = mDesc->Param(i);
+        if (!pd.mHasIID) {
+            ThrowBadParam(NS_ERROR_XPC_CANT_GET_PARAM_IFACE_INFO, i,
+                          mCallContext);
+            return false;
+        }
+        param_iid = pd.mIID;
     }
 
     nsresult err;
@@ -2216,11 +2196,12 @@ CallMethodHelper::ConvertDependentParam(uint8_t i)
     dp->type = type;
 
     if (isArray) {
-        if (NS_FAILED(mIFaceInfo->GetTypeForParam(mVTableIndex, &paramInfo, 1,
-                                                  &datum_type))) {
+        const XPCCallDescriptor::ParamDesc& pd = mDesc->Param(i);
+        if (!pd.mHasDatumType) {
             Throw(NS_ERROR_XPC_CANT_GET_ARRAY_INFO, mCallContext);
             return false;
         }
+        datum_type = pd.mDatumType;
         MOZ_ASSERT(datum_type.TagPart() != nsXPTType::T_JSVAL,
                    "Arrays of JSVals not currently supported - see bug 693337.");
     } else {
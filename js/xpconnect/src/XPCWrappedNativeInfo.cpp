@@ -17,6 +17,122 @@ using namespace mozilla;
 
 /***************************************************************************/
 
+// XPCCallDescriptor
+
+// static
+XPCCallDescriptor*
+XPCCallDescriptor::Compile(nsIInterfaceInfo* aInfo, uint16_t aVTableIndex,
+                           const nsXPTMethodInfo* aMethodInfo)
+{
+    const uint8_t paramCount = aMethodInfo->GetParamCount();
+
+    // Use placement new to create an object with the right amount of space
+    // to hold the param descriptors.
+    int size = sizeof(XPCCallDescriptor);
+    if (paramCount > 1)
+        size += (paramCount - 1) * sizeof(ParamDesc);
+    XPCCallDescriptor* desc = new(new char[size]) XPCCallDescriptor();
+
+    desc->mParamCount = paramCount;
+
+    uint8_t requiredArgs = paramCount;
+    desc->mHasRetval = false;
+    // XXX ASSUMES that retval is last arg. The xpidl compiler ensures this.
+    if (paramCount && aMethodInfo->GetParam(paramCount-1).IsRetval()) {
+        desc->mHasRetval = true;
+        requiredArgs--;
+    }
+
+    const bool wantsOptArgc = aMethodInfo->WantsOptArgc();
+    const bool wantsJSContext = aMethodInfo->WantsContext();
+
+    desc->mOptArgcIndex = UINT8_MAX;
+    desc->mJSContextIndex = UINT8_MAX;
+    if (wantsOptArgc)
+        desc->mOptArgcIndex = requiredArgs;
+
+    if (wantsJSContext) {
+        if (wantsOptArgc)
+            // Need to bump mOptArgcIndex up one here.
+            desc->mJSContextIndex = desc->mOptArgcIndex++;
+        else if (aMethodInfo->IsSetter() || aMethodInfo->IsGetter())
+            // For attributes, we always put the JSContext* first.
+            desc->mJSContextIndex = 0;
+        else
+            desc->mJSContextIndex = requiredArgs;
+    }
+
+    // Trailing optional arguments may be omitted by the caller.
+    while (requiredArgs && aMethodInfo->GetParam(requiredArgs-1).IsOptional())
+        requiredArgs--;
+    desc->mRequiredArgs = requiredArgs;
+
+    // Resolve the per-param typelib queries that CallMethodHelper would
+    // otherwise repeat on every call. Failures are recorded rather than
+    // reported; the call path throws when it actually needs the answer,
+    // just as it did when it made these queries itself.
+    for (uint8_t i = 0; i < paramCount; i++) {
+        const nsXPTParamInfo& paramInfo = aMethodInfo->GetParam(i);
+        const nsXPTType& type = paramInfo.GetType();
+        ParamDesc& pd = desc->mParams[i];
+
+        pd.mHasIID = false;
+        pd.mHasSizeArg = false;
+        pd.mHasIfaceIsArg = false;
+
+        nsXPTType datum_type = type;
+        pd.mHasDatumType = true;
+        if (type.IsArray() &&
+            NS_FAILED(aInfo->GetTypeForParam(aVTableIndex, &paramInfo, 1,
+                                             &datum_type))) {
+            pd.mHasDatumType = false;
+        }
+        pd.mDatumType = datum_type;
+
+        if (type.IsArray() ||
+            type.TagPart() == nsXPTType::T_PSTRING_SIZE_IS ||
+            type.TagPart() == nsXPTType::T_PWSTRING_SIZE_IS) {
+            uint8_t argnum;
+            if (NS_SUCCEEDED(aInfo->GetSizeIsArgNumberForParam(aVTableIndex,
+                                                               &paramInfo, 0,
+                                                               &argnum))) {
+                pd.mSizeArgIndex = argnum;
+                pd.mHasSizeArg = true;
+            }
+        }
+
+        if (pd.mHasDatumType) {
+            uint8_t tag = datum_type.TagPart();
+            if (tag == nsXPTType::T_INTERFACE) {
+                if (NS_SUCCEEDED(aInfo->GetIIDForParamNoAlloc(aVTableIndex,
+                                                              &paramInfo,
+                                                              &pd.mIID))) {
+                    pd.mHasIID = true;
+                }
+            } else if (tag == nsXPTType::T_INTERFACE_IS) {
+                uint8_t argnum;
+                if (NS_SUCCEEDED(aInfo->GetInterfaceIsArgNumberForParam(
+                                     aVTableIndex, &paramInfo, &argnum))) {
+                    pd.mIfaceIsArgIndex = argnum;
+                    pd.mHasIfaceIsArg = true;
+                }
+            }
+        }
+    }
+
+    return desc;
+}
+
+// static
+void
+XPCCallDescriptor::DestroyInstance(XPCCallDescriptor* aDesc)
+{
+    aDesc->~XPCCallDescriptor();
+    delete [] (char*) aDesc;
+}
+
+/***************************************************************************/
+
 // XPCNativeMember
 
 // static
@@ -356,6 +472,44 @@ XPCNativeInterface::NewInstance(nsIInterfaceInfo* aInfo)
     return obj;
 }
 
+XPCNativeInterface::~XPCNativeInterface()
+{
+    if (mCallDescriptors) {
+        for (uint16_t i = 0; i < mCallDescriptorCount; i++) {
+            if (mCallDescriptors[i])
+                XPCCallDescriptor::DestroyInstance(mCallDescriptors[i]);
+        }
+        delete [] mCallDescriptors;
+    }
+    MOZ_COUNT_DTOR(XPCNativeInterface);
+}
+
+const XPCCallDescriptor*
+XPCNativeInterface::GetCallDescriptor(uint16_t aVTableIndex)
+{
+    if (!mCallDescriptors) {
+        uint16_t methodCount;
+        if (NS_FAILED(mInfo->GetMethodCount(&methodCount)))
+            return nullptr;
+        mCallDescriptors = new XPCCallDescriptor*[methodCount];
+        memset(mCallDescriptors, 0, methodCount * sizeof(XPCCallDescriptor*));
+        mCallDescriptorCount = methodCount;
+    }
+
+    if (aVTableIndex >= mCallDescriptorCount)
+        return nullptr;
+
+    if (!mCallDescriptors[aVTableIndex]) {
+        const nsXPTMethodInfo* methodInfo;
+        if (NS_FAILED(mInfo->GetMethodInfo(aVTableIndex, &methodInfo)))
+            return nullptr;
+        mCallDescriptors[aVTableIndex] =
+            XPCCallDescriptor::Compile(mInfo, aVTableIndex, methodInfo);
+    }
+
+    return mCallDescriptors[aVTableIndex];
+}
+
 // static
 void
 XPCNativeInterface::DestroyInstance(XPCNativeInterface* inst)
@@ -367,7 +521,15 @@ XPCNativeInterface::DestroyInstance(XPCNativeInterface* inst)
 size_t
 XPCNativeInterface::SizeOfIncludingThis(MallocSizeOf mallocSizeOf)
 {
-    return mallocSizeOf(this);
+    size_t n = mallocSizeOf(this);
+    if (mCallDescriptors) {
+        n += mallocSizeOf(mCallDescriptors);
+        for (uint16_t i = 0; i < mCallDescriptorCount; i++) {
+            if (mCallDescriptors[i])
+                n += mallocSizeOf(mCallDescriptors[i]);
+        }
+    }
+    return n;
 }
 
 void
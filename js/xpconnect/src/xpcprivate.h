@@ -1316,6 +1316,71 @@ private:
     uint16_t mFlags;
 };
 
+/***************************************************************************/
+// XPCCallDescriptor is the "compiled" call shape of one vtable method. The
+// first call through XPCWrappedNative::CallMethod for a given (interface,
+// method) pair resolves the argument layout and the per-param typelib
+// queries (retval position, optional argument count, size_is/iid_is
+// argument numbers, interface IIDs, array element types) and records them
+// here, so that repeat calls skip the nsXPTMethodInfo interpretation.
+// Descriptors are built lazily, one per vtable slot, and owned by the
+// XPCNativeInterface.
+
+// Tight. No virtual methods. Allocated as a variable-sized block.
+
+class XPCCallDescriptor
+{
+public:
+    struct ParamDesc
+    {
+        // For arrays this is the element type, for everything else it is
+        // just the declared param type.
+        nsXPTType mDatumType;
+        // Resolved IID for T_INTERFACE params (valid if mHasIID).
+        nsID      mIID;
+        // Param index of the size_is() argument (valid if mHasSizeArg).
+        uint8_t   mSizeArgIndex;
+        // Param index of the iid_is() argument (valid if mHasIfaceIsArg).
+        uint8_t   mIfaceIsArgIndex;
+        bool      mHasDatumType;
+        bool      mHasIID;
+        bool      mHasSizeArg;
+        bool      mHasIfaceIsArg;
+    };
+
+    static XPCCallDescriptor* Compile(nsIInterfaceInfo* aInfo,
+                                      uint16_t aVTableIndex,
+                                      const nsXPTMethodInfo* aMethodInfo);
+    static void DestroyInstance(XPCCallDescriptor* aDesc);
+
+    uint8_t ParamCount()     const {return mParamCount;}
+    // The number of arguments the caller must pass, i.e. the param count
+    // less the retval and any trailing optional arguments.
+    uint8_t RequiredArgs()   const {return mRequiredArgs;}
+    bool    HasRetval()      const {return mHasRetval;}
+    bool    WantsJSContext() const {return mJSContextIndex != UINT8_MAX;}
+    bool    WantsOptArgc()   const {return mOptArgcIndex != UINT8_MAX;}
+    uint8_t JSContextIndex() const {return mJSContextIndex;}
+    uint8_t OptArgcIndex()   const {return mOptArgcIndex;}
+
+    const ParamDesc& Param(uint8_t i) const
+        {MOZ_ASSERT(i < mParamCount, "bad index"); return mParams[i];}
+
+private:
+    XPCCallDescriptor() {}
+    XPCCallDescriptor(const XPCCallDescriptor& r) MOZ_DELETE;
+    XPCCallDescriptor& operator=(const XPCCallDescriptor& r) MOZ_DELETE;
+
+    void* operator new(size_t, void* p) CPP_THROW_NEW {return p;}
+
+    uint8_t   mParamCount;
+    uint8_t   mRequiredArgs;
+    bool      mHasRetval;
+    uint8_t   mJSContextIndex;
+    uint8_t   mOptArgcIndex;
+    ParamDesc mParams[1]; // always last - object sized for array
+};
+
 /***************************************************************************/
 // XPCNativeInterface represents a single idl declared interface. This is
 // primarily the set of XPCNativeMembers.
@@ -1347,6 +1412,10 @@ class XPCNativeInterface
         return &mMembers[i];
     }
 
+    // Returns the lazily compiled call descriptor for the given vtable
+    // index, or null if no method info is available for it.
+    const XPCCallDescriptor* GetCallDescriptor(uint16_t aVTableIndex);
+
     void DebugDump(int16_t depth);
 
 #define XPC_NATIVE_IFACE_MARK_FLAG ((uint16_t)JS_BIT(15)) // only high bit of 16 is set
@@ -1376,13 +1445,12 @@ class XPCNativeInterface
 
     XPCNativeInterface();   // not implemented
     XPCNativeInterface(nsIInterfaceInfo* aInfo, jsid aName)
-      : mInfo(aInfo), mName(aName), mMemberCount(0), mMarked(0)
+      : mInfo(aInfo), mName(aName), mCallDescriptors(nullptr),
+        mCallDescriptorCount(0), mMemberCount(0), mMarked(0)
     {
         MOZ_COUNT_CTOR(XPCNativeInterface);
     }
-    ~XPCNativeInterface() {
-        MOZ_COUNT_DTOR(XPCNativeInterface);
-    }
+    ~XPCNativeInterface();
 
     void* operator new(size_t, void* p) CPP_THROW_NEW {return p;}
 
@@ -1392,6 +1460,10 @@ class XPCNativeInterface
 private:
     nsCOMPtr<nsIInterfaceInfo> mInfo;
     jsid                       mName;
+    // Lazily built array of compiled call descriptors, indexed by vtable
+    // index. Entries are compiled on the first call of their method.
+    XPCCallDescriptor**        mCallDescriptors;
+    uint16_t                   mCallDescriptorCount;
     uint16_t                   mMemberCount : 15;
     uint16_t                   mMarked : 1;
     XPCNativeMember            mMembers[1]; // always last - object sized for array
@@ -26,6 +26,7 @@
 #include "mozilla/LookAndFeel.h"
 #include "nsDocShell.h"
 #include "nsImageFrame.h"
+#include "nsThreadUtils.h"
 #include "mozilla/dom/ProfileTimelineMarkerBinding.h"
 
 #include "GeckoProfiler.h"
@@ -119,6 +120,19 @@ FrameLayerBuilder::DisplayItemData::EndUpdate(nsAutoPtr<nsDisplayItemGeometry> a
   EndUpdate();
 }
 
+void
+FrameLayerBuilder::DisplayItemData::EndUpdateUnchanged()
+{
+  MOZ_ASSERT(mItem);
+
+  // The item was found to be unchanged, so the geometry and clip retained
+  // from the previous paint are still accurate.
+  mFrameListChanges.Clear();
+
+  mItem = nullptr;
+  EndUpdate();
+}
+
 void
 FrameLayerBuilder::DisplayItemData::BeginUpdate(Layer* aLayer, LayerState aState,
                                                 uint32_t aContainerLayerGeneration,
@@ -241,6 +255,25 @@ static inline MaskLayerImageCache* GetMaskLayerImageCache()
   return gMaskLayerImageCache;
 }
 
+// Set while a sweep of gMaskLayerImageCache is queued on the main thread's
+// event loop, so that a transaction (and the inactive-layer transactions
+// nested inside it) schedules at most one sweep.
+static bool gMaskLayerImageCacheSweepPending = false;
+
+class MaskLayerImageCacheSweeper MOZ_FINAL : public nsRunnable
+{
+public:
+  NS_IMETHOD Run() MOZ_OVERRIDE
+  {
+    gMaskLayerImageCacheSweepPending = false;
+    // The cache may have been torn down by Shutdown() while we were queued.
+    if (gMaskLayerImageCache) {
+      gMaskLayerImageCache->Sweep();
+    }
+    return NS_OK;
+  }
+};
+
 /**
  * We keep a stack of these to represent the PaintedLayers that are
  * currently available to have display items added to.
@@ -1277,7 +1310,19 @@ FrameLayerBuilder::StoreOptimizedLayerForFrame(nsDisplayItem* aItem, Layer* aLay
 void
 FrameLayerBuilder::DidEndTransaction()
 {
-  GetMaskLayerImageCache()->Sweep();
+  // Sweeping the mask image cache is bookkeeping that doesn't affect the
+  // frame we just built, so don't do it on the refresh driver tick; let it
+  // run from the event loop once the tick (and any script it unblocks) has
+  // had its turn.
+  if (gMaskLayerImageCacheSweepPending) {
+    return;
+  }
+  nsCOMPtr<nsIRunnable> sweeper = new MaskLayerImageCacheSweeper();
+  if (NS_SUCCEEDED(NS_DispatchToCurrentThread(sweeper))) {
+    gMaskLayerImageCacheSweepPending = true;
+  } else {
+    GetMaskLayerImageCache()->Sweep();
+  }
 }
 
 void
@@ -3132,14 +3177,36 @@ FrameLayerBuilder::ComputeGeometryChangeForItem(DisplayItemData* aData)
 
   PaintedLayerItemsEntry* entry = mPaintedLayerItems.GetEntry(paintedLayer);
 
-  nsAutoPtr<nsDisplayItemGeometry> geometry(item->AllocateGeometry(mDisplayListBuilder));
-
   PaintedDisplayItemLayerUserData* layerData =
     static_cast<PaintedDisplayItemLayerUserData*>(aData->mLayer->GetUserData(&gPaintedDisplayItemLayerUserData));
   nsPoint shift = layerData->mAnimatedGeometryRootOrigin - layerData->mLastAnimatedGeometryRootOrigin;
 
   const DisplayItemClip& clip = item->GetClip();
 
+  // Fast path for the common case where nothing about the item changed:
+  // diff the item against its retained geometry before allocating a fresh
+  // copy.  When the diff comes back empty the old geometry is still
+  // accurate, so we keep it and skip the allocation and region arithmetic
+  // below entirely.
+  {
+    nsRect invalidRect;
+    if (aData->mGeometry && !aData->mIsInvalid &&
+        !item->IsInvalid(invalidRect) &&
+        shift == nsPoint() && aData->mClip == clip &&
+        entry && entry->mCommonClipCount == entry->mLastCommonClipCount &&
+        aData->GetFrameListChanges().IsEmpty()) {
+      nsRegion unchanged;
+      item->ComputeInvalidationRegion(mDisplayListBuilder, aData->mGeometry,
+                                      &unchanged);
+      if (unchanged.IsEmpty()) {
+        aData->EndUpdateUnchanged();
+        return;
+      }
+    }
+  }
+
+  nsAutoPtr<nsDisplayItemGeometry> geometry(item->AllocateGeometry(mDisplayListBuilder));
+
   // If the frame is marked as invalidated, and didn't specify a rect to invalidate  then we want to
   // invalidate both the old and new bounds, otherwise we only want to invalidate the changed areas.
   // If we do get an invalid rect, then we want to add this on top of the change areas.
@@ -451,6 +451,11 @@ public:
      *
      */
     void EndUpdate(nsAutoPtr<nsDisplayItemGeometry> aGeometry);
+    /**
+     * Like EndUpdate(aGeometry), but keeps the geometry retained from the
+     * previous paint.  Only valid when the item was found to be unchanged.
+     */
+    void EndUpdateUnchanged();
     void EndUpdate();
 
     LayerManagerData* mParent;
@@ -6,6 +6,7 @@
 #include "FramePropertyTable.h"
 
 #include "mozilla/MemoryReporting.h"
+#include "nsIFrame.h"
 
 namespace mozilla {
 
@@ -16,13 +17,15 @@ FramePropertyTable::Set(nsIFrame* aFrame, const FramePropertyDescriptor* aProper
   NS_ASSERTION(aFrame, "Null frame?");
   NS_ASSERTION(aProperty, "Null property?");
 
+  aFrame->AddStateBits(NS_FRAME_MAY_HAVE_PROPERTIES);
+
   if (mLastFrame != aFrame || !mLastEntry) {
     mLastFrame = aFrame;
     mLastEntry = mEntries.PutEntry(aFrame);
   }
   Entry* entry = mLastEntry;
 
-  if (!entry->mProp.IsArray()) {
+  if (!entry->mProp.IsMap()) {
     if (!entry->mProp.mProperty) {
       // Empty entry, so we can just store our property in the empty slot
       entry->mProp.mProperty = aProperty;
@@ -36,26 +39,26 @@ FramePropertyTable::Set(nsIFrame* aFrame, const FramePropertyDescriptor* aProper
       return;
     }
 
-    // We need to expand the single current entry to an array
+    // We need to expand the single current entry to a map
     PropertyValue current = entry->mProp;
     entry->mProp.mProperty = nullptr;
-    static_assert(sizeof(nsTArray<PropertyValue>) <= sizeof(void *),
-                  "Property array must fit entirely within entry->mProp.mValue");
-    new (&entry->mProp.mValue) nsTArray<PropertyValue>(4);
-    entry->mProp.ToArray()->AppendElement(current);
-  }
-
-  nsTArray<PropertyValue>* array = entry->mProp.ToArray();
-  nsTArray<PropertyValue>::index_type index =
-    array->IndexOf(aProperty, 0, PropertyComparator());
-  if (index != nsTArray<PropertyValue>::NoIndex) {
-    PropertyValue* pv = &array->ElementAt(index);
-    pv->DestroyValueFor(aFrame);
-    pv->mValue = aValue;
+    static_assert(sizeof(PropertyMap) <= sizeof(void *),
+                  "Property map must fit entirely within entry->mProp.mValue");
+    PropertyMap* map = new (&entry->mProp.mValue) PropertyMap();
+    map->SetCapacity(4);
+    map->Put(current.mProperty, current.mValue);
+  }
+
+  PropertyMap* map = entry->mProp.ToMap();
+  void** existing = map->Lookup(aProperty);
+  if (existing) {
+    PropertyValue pv(aProperty, *existing);
+    pv.DestroyValueFor(aFrame);
+    *existing = aValue;
     return;
   }
 
-  array->AppendElement(PropertyValue(aProperty, aValue));
+  map->Put(aProperty, aValue);
 }
 
 void*
@@ -70,6 +73,11 @@ FramePropertyTable::Get(const nsIFrame* aFrame,
     *aFoundResult = false;
   }
 
+  if (!(aFrame->GetStateBits() & NS_FRAME_MAY_HAVE_PROPERTIES)) {
+    // Nothing was ever stored for this frame; skip the table probe.
+    return nullptr;
+  }
+
   if (mLastFrame != aFrame) {
     mLastFrame = const_cast<nsIFrame*>(aFrame);
     mLastEntry = mEntries.GetEntry(mLastFrame);
@@ -84,22 +92,20 @@ FramePropertyTable::Get(const nsIFrame* aFrame,
     }
     return entry->mProp.mValue;
   }
-  if (!entry->mProp.IsArray()) {
+  if (!entry->mProp.IsMap()) {
     // There's just one property and it's not the one we want, bail
     return nullptr;
   }
 
-  nsTArray<PropertyValue>* array = entry->mProp.ToArray();
-  nsTArray<PropertyValue>::index_type index =
-    array->IndexOf(aProperty, 0, PropertyComparator());
-  if (index == nsTArray<PropertyValue>::NoIndex)
+  void** value = entry->mProp.ToMap()->Lookup(aProperty);
+  if (!value)
     return nullptr;
 
   if (aFoundResult) {
     *aFoundResult = true;
   }
 
-  return array->ElementAt(index).mValue;
+  return *value;
 }
 
 void*
@@ -113,6 +119,11 @@ FramePropertyTable::Remove(nsIFrame* aFrame, const FramePropertyDescriptor* aPro
     *aFoundResult = false;
   }
 
+  if (!(aFrame->GetStateBits() & NS_FRAME_MAY_HAVE_PROPERTIES)) {
+    // Nothing was ever stored for this frame; skip the table probe.
+    return nullptr;
+  }
+
   if (mLastFrame != aFrame) {
     mLastFrame = aFrame;
     mLastEntry = mEntries.GetEntry(aFrame);
@@ -126,20 +137,20 @@ FramePropertyTable::Remove(nsIFrame* aFrame, const FramePropertyDescriptor* aPro
     void* value = entry->mProp.mValue;
     mEntries.RawRemoveEntry(entry);
     mLastEntry = nullptr;
+    aFrame->RemoveStateBits(NS_FRAME_MAY_HAVE_PROPERTIES);
     if (aFoundResult) {
       *aFoundResult = true;
     }
     return value;
   }
-  if (!entry->mProp.IsArray()) {
+  if (!entry->mProp.IsMap()) {
     // There's just one property and it's not the one we want, bail
     return nullptr;
   }
 
-  nsTArray<PropertyValue>* array = entry->mProp.ToArray();
-  nsTArray<PropertyValue>::index_type index =
-    array->IndexOf(aProperty, 0, PropertyComparator());
-  if (index == nsTArray<PropertyValue>::NoIndex) {
+  PropertyMap* map = entry->mProp.ToMap();
+  void* result;
+  if (!map->Remove(aProperty, &result)) {
     // No such property, bail
     return nullptr;
   }
@@ -148,18 +159,12 @@ FramePropertyTable::Remove(nsIFrame* aFrame, const FramePropertyDescriptor* aPro
     *aFoundResult = true;
   }
 
-  void* result = array->ElementAt(index).mValue;
-
-  uint32_t last = array->Length() - 1;
-  array->ElementAt(index) = array->ElementAt(last);
-  array->RemoveElementAt(last);
-
-  if (last == 1) {
-    PropertyValue pv = array->ElementAt(0);
-    array->~nsTArray<PropertyValue>();
+  if (map->Count() == 1) {
+    PropertyValue pv(map->KeyAt(0), map->DataAt(0));
+    map->~PropertyMap();
     entry->mProp = pv;
   }
-  
+
   return result;
 }
 
@@ -180,16 +185,17 @@ FramePropertyTable::Delete(nsIFrame* aFrame, const FramePropertyDescriptor* aPro
 /* static */ void
 FramePropertyTable::DeleteAllForEntry(Entry* aEntry)
 {
-  if (!aEntry->mProp.IsArray()) {
+  if (!aEntry->mProp.IsMap()) {
     aEntry->mProp.DestroyValueFor(aEntry->GetKey());
     return;
   }
 
-  nsTArray<PropertyValue>* array = aEntry->mProp.ToArray();
-  for (uint32_t i = 0; i < array->Length(); ++i) {
-    array->ElementAt(i).DestroyValueFor(aEntry->GetKey());
+  PropertyMap* map = aEntry->mProp.ToMap();
+  for (uint32_t i = 0; i < map->Count(); ++i) {
+    PropertyValue pv(map->KeyAt(i), map->DataAt(i));
+    pv.DestroyValueFor(aEntry->GetKey());
   }
-  array->~nsTArray<PropertyValue>();
+  map->~PropertyMap();
 }
 
 void
@@ -197,10 +203,16 @@ FramePropertyTable::DeleteAllFor(nsIFrame* aFrame)
 {
   NS_ASSERTION(aFrame, "Null frame?");
 
+  if (!(aFrame->GetStateBits() & NS_FRAME_MAY_HAVE_PROPERTIES)) {
+    return;
+  }
+
   Entry* entry = mEntries.GetEntry(aFrame);
   if (!entry)
     return;
 
+  aFrame->RemoveStateBits(NS_FRAME_MAY_HAVE_PROPERTIES);
+
   if (mLastFrame == aFrame) {
     // Flush cache. We assume DeleteAllForEntry will be called before
     // a frame is destroyed.
@@ -7,8 +7,8 @@
 #define FRAMEPROPERTYTABLE_H_
 
 #include "mozilla/MemoryReporting.h"
-#include "nsTArray.h"
 #include "nsTHashtable.h"
+#include "nsTSmallSortedMap.h"
 #include "nsHashKeys.h"
 
 class nsIFrame;
@@ -75,7 +75,7 @@ public:
 
   /**
    * Set a property value on a frame. This requires one hashtable
-   * lookup (using the frame as the key) and a linear search through
+   * lookup (using the frame as the key) and a binary search through
    * the properties of that frame. Any existing value for the property
    * is destroyed.
    */
@@ -83,9 +83,11 @@ public:
            void* aValue);
   /**
    * Get a property value for a frame. This requires one hashtable
-   * lookup (using the frame as the key) and a linear search through
+   * lookup (using the frame as the key) and a binary search through
    * the properties of that frame. If the frame has no such property,
-   * returns null.
+   * returns null.  Frames that have never had a property stored
+   * (NS_FRAME_MAY_HAVE_PROPERTIES not set) skip the hashtable lookup
+   * entirely.
    * @param aFoundResult if non-null, receives a value 'true' iff
    * the frame has a value for the property. This lets callers
    * disambiguate a null result, which can mean 'no such property' or
@@ -95,7 +97,7 @@ public:
             bool* aFoundResult = nullptr);
   /**
    * Remove a property value for a frame. This requires one hashtable
-   * lookup (using the frame as the key) and a linear search through
+   * lookup (using the frame as the key) and a binary search through
    * the properties of that frame. The old property value is returned
    * (and not destroyed). If the frame has no such property,
    * returns null.
@@ -108,7 +110,7 @@ public:
                bool* aFoundResult = nullptr);
   /**
    * Remove and destroy a property value for a frame. This requires one
-   * hashtable lookup (using the frame as the key) and a linear search
+   * hashtable lookup (using the frame as the key) and a binary search
    * through the properties of that frame. If the frame has no such
    * property, nothing happens.
    */
@@ -126,20 +128,27 @@ public:
   size_t SizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf) const;
 
 protected:
+  /**
+   * Flat map used when a frame has more than one property. Descriptors
+   * are compared as pointers, so the entries are sorted by descriptor
+   * address.
+   */
+  typedef nsTSmallSortedMap<const FramePropertyDescriptor*, void*> PropertyMap;
+
   /**
    * Stores a property descriptor/value pair. It can also be used to
-   * store an nsTArray of PropertyValues.
+   * store a PropertyMap of descriptor/value pairs.
    */
   struct PropertyValue {
     PropertyValue() : mProperty(nullptr), mValue(nullptr) {}
     PropertyValue(const FramePropertyDescriptor* aProperty, void* aValue)
       : mProperty(aProperty), mValue(aValue) {}
 
-    bool IsArray() { return !mProperty && mValue; }
-    nsTArray<PropertyValue>* ToArray()
+    bool IsMap() { return !mProperty && mValue; }
+    PropertyMap* ToMap()
     {
-      NS_ASSERTION(IsArray(), "Must be array");
-      return reinterpret_cast<nsTArray<PropertyValue>*>(&mValue);
+      NS_ASSERTION(IsMap(), "Must be map");
+      return reinterpret_cast<PropertyMap*>(&mValue);
     }
 
     void DestroyValueFor(nsIFrame* aFrame) {
@@ -154,12 +163,11 @@ protected:
       size_t n = 0;
       // We don't need to measure mProperty because it always points to static
       // memory.  As for mValue:  if it's a single value we can't measure it,
-      // because the type is opaque;  if it's an array, we measure the array
+      // because the type is opaque;  if it's a map, we measure the map
       // storage, but we can't measure the individual values, again because
       // their types are opaque.
-      if (IsArray()) {
-        nsTArray<PropertyValue>* array = ToArray();
-        n += array->SizeOfExcludingThis(aMallocSizeOf);
+      if (IsMap()) {
+        n += ToMap()->SizeOfExcludingThis(aMallocSizeOf);
       }
       return n;
     }
@@ -168,23 +176,6 @@ protected:
     void* mValue;
   };
 
-  /**
-   * Used with an array of PropertyValues to allow lookups that compare
-   * only on the FramePropertyDescriptor.
-   */
-  class PropertyComparator {
-  public:
-    bool Equals(const PropertyValue& a, const PropertyValue& b) const {
-      return a.mProperty == b.mProperty;
-    }
-    bool Equals(const FramePropertyDescriptor* a, const PropertyValue& b) const {
-      return a == b.mProperty;
-    }
-    bool Equals(const PropertyValue& a, const FramePropertyDescriptor* b) const {
-      return a.mProperty == b;
-    }
-  };
-
   /**
    * Our hashtable entry. The key is an nsIFrame*, the value is a
    * PropertyValue representing one or more property/value pairs.
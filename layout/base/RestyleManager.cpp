@@ -17,6 +17,8 @@
 #include "GeckoProfiler.h"
 #include "nsStyleChangeList.h"
 #include "nsRuleProcessorData.h"
+#include "nsCSSRuleProcessor.h"
+#include "ChildIterator.h"
 #include "nsStyleUtil.h"
 #include "nsCSSFrameConstructor.h"
 #include "nsSVGEffects.h"
@@ -1085,12 +1087,21 @@ RestyleManager::AttributeWillChange(Element* aElement,
                                     nsIAtom* aAttribute,
                                     int32_t aModType)
 {
+  RestyleHintData rsdata;
   nsRestyleHint rshint =
     mPresContext->StyleSet()->HasAttributeDependentStyle(mPresContext,
                                                          aElement,
                                                          aAttribute,
                                                          aModType,
-                                                         false);
+                                                         false,
+                                                         rsdata);
+  if (rshint & eRestyle_SomeDescendants) {
+    rshint = nsRestyleHint(rshint & ~eRestyle_SomeDescendants);
+    if (!(rshint & eRestyle_Subtree)) {
+      PostRestyleEventForDescendantsMatching(aElement,
+                                             rsdata.mSelectorsForDescendants);
+    }
+  }
   PostRestyleEvent(aElement, rshint, NS_STYLE_HINT_NONE);
 }
 
@@ -1173,16 +1184,73 @@ RestyleManager::AttributeChanged(Element* aElement,
 
   // See if we can optimize away the style re-resolution -- must be called after
   // the frame's AttributeChanged() in case it does something that affects the style
+  RestyleHintData rsdata;
   nsRestyleHint rshint =
     mPresContext->StyleSet()->HasAttributeDependentStyle(mPresContext,
                                                          aElement,
                                                          aAttribute,
                                                          aModType,
-                                                         true);
+                                                         true,
+                                                         rsdata);
+  if (rshint & eRestyle_SomeDescendants) {
+    rshint = nsRestyleHint(rshint & ~eRestyle_SomeDescendants);
+    if (!(rshint & eRestyle_Subtree)) {
+      PostRestyleEventForDescendantsMatching(aElement,
+                                             rsdata.mSelectorsForDescendants);
+    }
+  }
 
   PostRestyleEvent(aElement, rshint, hint);
 }
 
+void
+RestyleManager::PostRestyleEventForDescendantsMatching(
+    Element* aElement,
+    const nsTArray<nsCSSSelector*>& aSelectors)
+{
+  if (aSelectors.IsEmpty()) {
+    return;
+  }
+
+  // Match each descendant against the subjects of the selectors that gave
+  // us eRestyle_SomeDescendants.  This can restyle more elements than
+  // strictly necessary (the subject is only the rightmost part of the
+  // selector), but never fewer: any descendant whose matching of the full
+  // selector can have changed must at least match its subject.  Since we
+  // get called both before and after the attribute change, we catch both
+  // elements that stop matching and elements that start matching.
+  TreeMatchContext treeMatchContext(false,
+                                    nsRuleWalker::eLinksVisitedOrUnvisited,
+                                    mPresContext->Document());
+  PostRestyleEventForDescendantsMatchingInternal(aElement, aSelectors,
+                                                 treeMatchContext);
+}
+
+void
+RestyleManager::PostRestyleEventForDescendantsMatchingInternal(
+    Element* aElement,
+    const nsTArray<nsCSSSelector*>& aSelectors,
+    TreeMatchContext& aTreeMatchContext)
+{
+  dom::AllChildrenIterator iter(aElement, nsIContent::eAllChildren);
+  for (nsIContent* child = iter.GetNextChild(); child;
+       child = iter.GetNextChild()) {
+    if (!child->IsElement()) {
+      continue;
+    }
+    Element* element = child->AsElement();
+    for (size_t i = 0; i < aSelectors.Length(); i++) {
+      if (nsCSSRuleProcessor::RestrictedSelectorMatches(element, aSelectors[i],
+                                                        aTreeMatchContext)) {
+        PostRestyleEvent(element, eRestyle_Self, NS_STYLE_HINT_NONE);
+        break;
+      }
+    }
+    PostRestyleEventForDescendantsMatchingInternal(element, aSelectors,
+                                                   aTreeMatchContext);
+  }
+}
+
 /* static */ uint64_t
 RestyleManager::GetMaxAnimationGenerationForFrame(nsIFrame* aFrame)
 {
@@ -4019,7 +4087,7 @@ RestyleManager::RestyleHintToString(nsRestyleHint aHint)
                           "CSSAnimations", "SVGAttrAnimations", "StyleAttribute",
                           "ChangeAnimationPhase",
                           "ChangeAnimationPhaseDescendants",
-                          "Force", "ForceDescendants" };
+                          "Force", "ForceDescendants", "SomeDescendants" };
   uint32_t hint = aHint & ((1 << ArrayLength(names)) - 1);
   uint32_t rest = aHint & ~((1 << ArrayLength(names)) - 1);
   for (uint32_t i = 0; i < ArrayLength(names); i++) {
@@ -389,6 +389,22 @@ private:
                               bool aForAnimation);
   void PostRestyleEventInternal(bool aForLazyConstruction);
 
+  /**
+   * Expands an eRestyle_SomeDescendants hint by posting an eRestyle_Self
+   * event for each descendant of aElement in the flattened tree that
+   * matches one of the selectors in aSelectors.  This restyles only the
+   * elements whose selector matching can have changed, rather than
+   * rerunning selector matching on the whole subtree.
+   */
+  void PostRestyleEventForDescendantsMatching(
+      Element* aElement,
+      const nsTArray<nsCSSSelector*>& aSelectors);
+
+  void PostRestyleEventForDescendantsMatchingInternal(
+      Element* aElement,
+      const nsTArray<nsCSSSelector*>& aSelectors,
+      TreeMatchContext& aTreeMatchContext);
+
 public:
   /**
    * Asynchronously clear style data from the root frame downwards and ensure
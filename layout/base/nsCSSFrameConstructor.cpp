@@ -9622,17 +9622,20 @@ nsCSSFrameConstructor::CreateNeededAnonFlexOrGridItems(
       FCDATA_DECL(FCDATA_SKIP_FRAMESET | FCDATA_USE_CHILD_ITEMS,
                   NS_NewBlockFormattingContext);
 
+    FrameConstructionItemArena* arena = iter.List()->Arena();
     FrameConstructionItem* newItem =
-      new FrameConstructionItem(&sBlockFormattingContextFCData,
-                                // Use the content of our parent frame
-                                parentContent,
-                                // Lie about the tag; it doesn't matter anyway
-                                pseudoType,
-                                iter.item().mNameSpaceID,
-                                // no pending binding
-                                nullptr,
-                                wrapperStyle,
-                                true, nullptr);
+      new (arena) FrameConstructionItem(arena,
+                                        &sBlockFormattingContextFCData,
+                                        // Use the content of our parent frame
+                                        parentContent,
+                                        // Lie about the tag; it doesn't
+                                        // matter anyway
+                                        pseudoType,
+                                        iter.item().mNameSpaceID,
+                                        // no pending binding
+                                        nullptr,
+                                        wrapperStyle,
+                                        true, nullptr);
 
     newItem->mIsAllInline = newItem->mHasInlineEnds =
       newItem->mStyleContext->StyleDisplay()->IsInlineOutsideStyle();
@@ -10119,20 +10122,23 @@ nsCSSFrameConstructor::WrapItemsInPseudoParent(nsIContent* aParentContent,
 
   already_AddRefed<nsStyleContext> wrapperStyle =
     mPresShell->StyleSet()->ResolveAnonymousBoxStyle(pseudoType, aParentStyle);
+  FrameConstructionItemArena* arena = aIter.List()->Arena();
   FrameConstructionItem* newItem =
-    new FrameConstructionItem(&pseudoData.mFCData,
-                              // Use the content of our parent frame
-                              aParentContent,
-                              // Lie about the tag; it doesn't matter anyway
-                              pseudoType,
-                              // The namespace does matter, however; it needs
-                              // to match that of our first child item to
-                              // match the old behavior
-                              aIter.item().mNameSpaceID,
-                              // no pending binding
-                              nullptr,
-                              wrapperStyle,
-                              true, nullptr);
+    new (arena) FrameConstructionItem(arena,
+                                      &pseudoData.mFCData,
+                                      // Use the content of our parent frame
+                                      aParentContent,
+                                      // Lie about the tag; it doesn't matter
+                                      // anyway
+                                      pseudoType,
+                                      // The namespace does matter, however;
+                                      // it needs to match that of our first
+                                      // child item to match the old behavior
+                                      aIter.item().mNameSpaceID,
+                                      // no pending binding
+                                      nullptr,
+                                      wrapperStyle,
+                                      true, nullptr);
 
   // Here we're cheating a tad... technically, table-internal items should be
   // inline if aParentFrame is inline, but they'll get wrapped in an
@@ -10181,18 +10187,20 @@ void nsCSSFrameConstructor::CreateNeededPseudoSiblings(
   already_AddRefed<nsStyleContext> pseudoStyle = mPresShell->StyleSet()->
     ResolveAnonymousBoxStyle(*pseudoData.mPseudoType,
                              aParentFrame->StyleContext());
+  FrameConstructionItemArena* arena = iter.List()->Arena();
   FrameConstructionItem* newItem =
-    new FrameConstructionItem(&pseudoData.mFCData,
-                              // Use the content of the parent frame
-                              aParentFrame->GetContent(),
-                              // Tag type
-                              *pseudoData.mPseudoType,
-                              // Use the namespace of the rtc frame
-                              iter.item().mNameSpaceID,
-                              // no pending binding
-                              nullptr,
-                              pseudoStyle,
-                              true, nullptr);
+    new (arena) FrameConstructionItem(arena,
+                                      &pseudoData.mFCData,
+                                      // Use the content of the parent frame
+                                      aParentFrame->GetContent(),
+                                      // Tag type
+                                      *pseudoData.mPseudoType,
+                                      // Use the namespace of the rtc frame
+                                      iter.item().mNameSpaceID,
+                                      // no pending binding
+                                      nullptr,
+                                      pseudoStyle,
+                                      true, nullptr);
   newItem->mIsAllInline = true;
   newItem->mChildItems.SetParentHasNoXBLChildren(true);
   iter.InsertItem(newItem);
@@ -12454,6 +12462,6 @@ Iterator::DeleteItemsTo(const Iterator& aEnd)
     Next();
     PR_REMOVE_LINK(item);
     mList.AdjustCountsForItem(item, -1);
-    delete item;
+    item->Delete();
   } while (*this != aEnd);
 }
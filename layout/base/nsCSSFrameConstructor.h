@@ -12,6 +12,7 @@
 #define nsCSSFrameConstructor_h___
 
 #include "mozilla/Attributes.h"
+#include "mozilla/Likely.h"
 
 #include "nsCOMPtr.h"
 #include "nsILayoutHistoryState.h"
@@ -21,6 +22,7 @@
 #include "nsIAnonymousContentCreator.h"
 #include "nsFrameManager.h"
 #include "nsIDocument.h"
+#include "plarena.h"
 #include "ScrollbarStyles.h"
 
 struct nsFrameItems;
@@ -769,6 +771,40 @@ private:
                   uint32_t aDataLength);
 
   /* A class representing a list of FrameConstructionItems */
+  /* An arena that FrameConstructionItems are allocated from, to avoid a
+     malloc/free pair per content node while constructing frames.  Each item
+     holds a reference to the arena it came from, so item memory stays valid
+     even when items are moved between lists that use different arenas; the
+     memory is reclaimed in one shot when the last reference goes away. */
+  class FrameConstructionItemArena MOZ_FINAL {
+  public:
+    FrameConstructionItemArena()
+    {
+      PL_INIT_ARENA_POOL(&mPool, "FrameConstructionItemArena", 4096);
+    }
+
+    // Infallible, like the 'new' it replaces.
+    void* Allocate(size_t aSize)
+    {
+      void* mem;
+      PL_ARENA_ALLOCATE(mem, &mPool, aSize);
+      if (MOZ_UNLIKELY(!mem)) {
+        NS_ABORT_OOM(aSize);
+      }
+      return mem;
+    }
+
+    NS_INLINE_DECL_REFCOUNTING(FrameConstructionItemArena)
+
+  private:
+    ~FrameConstructionItemArena()
+    {
+      PL_FinishArenaPool(&mPool);
+    }
+
+    PLArenaPool mPool;
+  };
+
   class FrameConstructionItemList {
   public:
     FrameConstructionItemList() :
@@ -789,7 +825,7 @@ private:
       PRCList* cur = PR_NEXT_LINK(&mItems);
       while (cur != &mItems) {
         PRCList* next = PR_NEXT_LINK(cur);
-        delete ToItem(cur);
+        ToItem(cur)->Delete();
         cur = next;
       }
 
@@ -828,10 +864,29 @@ private:
       return mDesiredParentCounts[aDesiredParentType] == mItemCount;
     }
 
+    // Returns the arena that items appended to this list should be
+    // allocated from, creating it lazily so that empty lists stay cheap.
+    FrameConstructionItemArena* Arena()
+    {
+      if (!mArena) {
+        mArena = new FrameConstructionItemArena();
+      }
+      return mArena;
+    }
+
+    // Used to share an item's arena with its mChildItems, so that child
+    // items are carved out of the same memory as their parent.
+    void SetArena(FrameConstructionItemArena* aArena)
+    {
+      NS_ASSERTION(IsEmpty() && !mArena, "Should only be done on a new list");
+      mArena = aArena;
+    }
+
     // aSuppressWhiteSpaceOptimizations is true if optimizations that
     // skip constructing whitespace frames for this item or items
     // around it cannot be performed.
-    // Also, the return value is always non-null, thanks to infallible 'new'.
+    // Also, the return value is always non-null, thanks to the infallible
+    // arena allocation.
     FrameConstructionItem* AppendItem(const FrameConstructionData* aFCData,
                                       nsIContent* aContent,
                                       nsIAtom* aTag,
@@ -842,10 +897,11 @@ private:
                                       nsTArray<nsIAnonymousContentCreator::ContentInfo>* aAnonChildren)
     {
       FrameConstructionItem* item =
-        new FrameConstructionItem(aFCData, aContent, aTag, aNameSpaceID,
-                                  aPendingBinding, aStyleContext,
-                                  aSuppressWhiteSpaceOptimizations,
-                                  aAnonChildren);
+        new (Arena()) FrameConstructionItem(Arena(), aFCData, aContent, aTag,
+                                            aNameSpaceID, aPendingBinding,
+                                            aStyleContext,
+                                            aSuppressWhiteSpaceOptimizations,
+                                            aAnonChildren);
       PR_APPEND_LINK(item, &mItems);
       ++mItemCount;
       ++mDesiredParentCounts[item->DesiredParentType()];
@@ -1023,6 +1079,11 @@ private:
     bool mTriedConstructingFrames;
 
     nsTArray<UndisplayedItem> mUndisplayedItems;
+
+    // The arena that items appended to this list are allocated from, created
+    // lazily by Arena().  The items themselves also hold references, so this
+    // only needs to live as long as the list is appending.
+    nsRefPtr<FrameConstructionItemArena> mArena;
   };
 
   typedef FrameConstructionItemList::Iterator FCItemIterator;
@@ -1032,9 +1093,17 @@ private:
    * frame other than the parent frame and whatever would be stored in the
    * frame constructor state. */
   struct FrameConstructionItem : public PRCList {
+    // Items are carved out of a FrameConstructionItemArena rather than
+    // the heap; they must be destroyed with Delete(), not |delete|.
+    void* operator new(size_t aSize, FrameConstructionItemArena* aArena)
+    {
+      return aArena->Allocate(aSize);
+    }
+
     // No need to PR_INIT_CLIST in the constructor because the only
     // place that creates us immediately appends us.
-    FrameConstructionItem(const FrameConstructionData* aFCData,
+    FrameConstructionItem(FrameConstructionItemArena* aArena,
+                          const FrameConstructionData* aFCData,
                           nsIContent* aContent,
                           nsIAtom* aTag,
                           int32_t aNameSpaceID,
@@ -1042,6 +1111,7 @@ private:
                           already_AddRefed<nsStyleContext>& aStyleContext,
                           bool aSuppressWhiteSpaceOptimizations,
                           nsTArray<nsIAnonymousContentCreator::ContentInfo>* aAnonChildren) :
+      mArena(aArena),
       mFCData(aFCData), mContent(aContent), mTag(aTag),
       mPendingBinding(aPendingBinding), mStyleContext(aStyleContext),
       mNameSpaceID(aNameSpaceID),
@@ -1052,6 +1122,9 @@ private:
       mHasInlineEnds(false), mIsPopup(false),
       mIsLineParticipant(false), mIsForSVGAElement(false)
     {
+      // Child items share our arena, so that subtrees of items end up in
+      // contiguous memory.
+      mChildItems.SetArena(aArena);
       if (aAnonChildren) {
         NS_ASSERTION(!(mFCData->mBits & FCDATA_FUNC_IS_FULL_CTOR) ||
                      mFCData->mFullConstructor ==
@@ -1071,6 +1144,16 @@ private:
       }
     }
 
+    // Destroy this item.  The arena reclaims our memory when its last
+    // reference dies, so all we need to do here is run the destructor; the
+    // local reference keeps the arena alive across it in case we hold the
+    // last reference ourselves.
+    void Delete()
+    {
+      nsRefPtr<FrameConstructionItemArena> arena = mArena;
+      this->~FrameConstructionItem();
+    }
+
     ParentType DesiredParentType() {
       return FCDATA_DESIRED_PARENT_TYPE(mFCData->mBits);
     }
@@ -1088,6 +1171,10 @@ private:
       return mIsBlock || (mFCData->mBits & FCDATA_IS_LINE_BREAK);
     }
 
+    // The arena we were allocated from.  Declared first so that it is
+    // destroyed last; it must outlive everything else in this item.
+    nsRefPtr<FrameConstructionItemArena> mArena;
+
     // Child frame construction items.
     FrameConstructionItemList mChildItems;
 
@@ -1163,6 +1250,10 @@ private:
     bool mIsForSVGAElement:1;
 
   private:
+    // Not implemented; use Delete() instead so the arena stays alive while
+    // the destructor runs.
+    void operator delete(void* aPtr) MOZ_DELETE;
+
     FrameConstructionItem(const FrameConstructionItem& aOther) MOZ_DELETE; /* not implemented */
   };
 
@@ -9,6 +9,7 @@
 #define nsChangeHint_h___
 
 #include "nsDebug.h"
+#include "nsTArray.h"
 #include "mozilla/Types.h"
 
 // Defines for various style related constants
@@ -360,8 +361,35 @@ enum nsRestyleHint {
   // eRestyle_Subtree, which makes us rerun selector matching on all
   // descendants rather than just continuing the restyling process.
   eRestyle_ForceDescendants = (1<<10),
+
+  // Rerun selector matching on descendants of the element that match
+  // a given selector.  The selectors are stored in the
+  // mSelectorsForDescendants array of the RestyleHintData returned
+  // alongside the hint, and identify the subjects of the selectors
+  // whose matching may have changed.  (Irrelevant if eRestyle_Subtree
+  // is also set, since that implies a superset of the work.)
+  eRestyle_SomeDescendants = (1<<11),
 };
 
+class nsCSSSelector;
+
+namespace mozilla {
+
+/**
+ * Additional data produced along with an nsRestyleHint to control the
+ * restyle process.
+ */
+struct RestyleHintData
+{
+  // When eRestyle_SomeDescendants is part of the restyle hint, this array
+  // contains the selectors whose subjects identify the descendants that
+  // need to be restyled.  The pointers are into the rule cascade data and
+  // are valid only until the next rule cascade rebuild.
+  nsTArray<nsCSSSelector*> mSelectorsForDescendants;
+};
+
+} // namespace mozilla
+
 // The functions below need an integral type to cast to to avoid
 // infinite recursion.
 typedef decltype(nsRestyleHint(0) + nsRestyleHint(0)) nsRestyleHint_size_t;
@@ -587,7 +587,7 @@ nsDisplayListBuilder::nsDisplayListBuilder(nsIFrame* aReferenceFrame,
       mContainsPluginItem(false),
       mAncestorHasTouchEventHandler(false),
       mAncestorHasScrollEventHandler(false),
-      mHaveScrollableDisplayPort(false)
+      mScrollableDisplayPortCount(0)
 {
   MOZ_COUNT_CTOR(nsDisplayListBuilder);
   PL_InitArenaPool(&mPool, "displayListArena", 1024,
@@ -621,6 +621,12 @@ static void MarkFrameForDisplay(nsIFrame* aFrame, nsIFrame* aStopAtFrame) {
   }
 }
 
+bool nsDisplayListBuilder::ScrollableDisplayPortBudgetExhausted() const
+{
+  int32_t budget = gfxPrefs::APZSubframeDisplayPortBudget();
+  return budget >= 0 && mScrollableDisplayPortCount >= uint32_t(budget);
+}
+
 void nsDisplayListBuilder::SetContainsBlendMode(uint8_t aBlendMode)
 {
   MOZ_ASSERT(aBlendMode != NS_STYLE_BLEND_NORMAL);
@@ -1263,8 +1269,8 @@ nsDisplayListBuilder::AddToWillChangeBudget(nsIFrame* aFrame, const nsSize& aRec
 
   // There's significant overhead for each layer created from Gecko
   // (IPC+Shared Objects) and from the backend (like an OpenGL texture).
-  // Therefore we set a minimum cost threshold of a 64x64 area.
-  int minBudgetCost = 64 * 64;
+  // Therefore we set a minimum cost threshold, a 64x64 area by default.
+  int minBudgetCost = int(gfxPrefs::WillChangeMinLayerCost());
 
   budget.mBudget +=
     std::max(minBudgetCost,
@@ -1276,7 +1282,7 @@ nsDisplayListBuilder::AddToWillChangeBudget(nsIFrame* aFrame, const nsSize& aRec
 
 bool
 nsDisplayListBuilder::IsInWillChangeBudget(nsIFrame* aFrame) const {
-  uint32_t multiplier = 3;
+  uint32_t multiplier = std::max(1u, gfxPrefs::WillChangeBudgetMultiplier());
 
   mWillChangeBudgetCalculated = true;
 
@@ -1880,16 +1886,47 @@ static bool IsContentLEQ(nsDisplayItem* aItem1, nsDisplayItem* aItem2,
   return nsLayoutUtils::CompareTreePosition(content1, content2, commonAncestor) <= 0;
 }
 
-static bool IsZOrderLEQ(nsDisplayItem* aItem1, nsDisplayItem* aItem2,
-                        void* aClosure) {
+struct ZOrderEntry {
+  nsDisplayItem* mItem;
+  int32_t mZIndex;
+};
+
+static bool IsZOrderEntryLess(const ZOrderEntry& aLeft,
+                              const ZOrderEntry& aRight) {
   // Note that we can't just take the difference of the two
   // z-indices here, because that might overflow a 32-bit int.
-  return aItem1->ZIndex() <= aItem2->ZIndex();
+  return aLeft.mZIndex < aRight.mZIndex;
 }
 
 void nsDisplayList::SortByZOrder(nsDisplayListBuilder* aBuilder,
                                  nsIContent* aCommonAncestor) {
-  Sort(aBuilder, IsZOrderLEQ, aCommonAncestor);
+  // ZIndex() walks style data, so letting the generic sort call it in
+  // the comparator makes large lists pay n log n style lookups per
+  // paint.  Decorate each item with its z-index once, stable-sort the
+  // decorated array (which preserves content order for equal z-indices,
+  // like the merge sort did), and relink.
+  nsAutoTArray<ZOrderEntry, 64> entries;
+  bool sorted = true;
+
+  for (nsDisplayItem* item = RemoveBottom(); item; item = RemoveBottom()) {
+    ZOrderEntry* entry = entries.AppendElement();
+    entry->mItem = item;
+    entry->mZIndex = item->ZIndex();
+    if (sorted && entries.Length() > 1 &&
+        entries[entries.Length() - 2].mZIndex > entry->mZIndex) {
+      sorted = false;
+    }
+  }
+
+  if (!sorted) {
+    std::stable_sort(entries.Elements(),
+                     entries.Elements() + entries.Length(),
+                     IsZOrderEntryLess);
+  }
+
+  for (uint32_t i = 0; i < entries.Length(); ++i) {
+    AppendToTop(entries[i].mItem);
+  }
 }
 
 void nsDisplayList::SortByContentOrder(nsDisplayListBuilder* aBuilder,
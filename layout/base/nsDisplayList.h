@@ -357,8 +357,14 @@ public:
     mAncestorHasScrollEventHandler = aValue;
   }
 
-  bool HaveScrollableDisplayPort() const { return mHaveScrollableDisplayPort; }
-  void SetHaveScrollableDisplayPort() { mHaveScrollableDisplayPort = true; }
+  /**
+   * Display ports for async-scrollable scroll frames are handed out against
+   * a budget shared across the scroll tree (apz.subframe.displayport_budget)
+   * so that deeply nested scroll panes don't each retain a displayport's
+   * worth of layers. A negative budget means unlimited.
+   */
+  bool ScrollableDisplayPortBudgetExhausted() const;
+  void NoteScrollableDisplayPort() { ++mScrollableDisplayPortCount; }
 
   bool SetIsCompositingCheap(bool aCompositingCheap) { 
     bool temp = mIsCompositingCheap; 
@@ -877,10 +883,10 @@ private:
   bool                           mContainsPluginItem;
   bool                           mAncestorHasTouchEventHandler;
   bool                           mAncestorHasScrollEventHandler;
-  // True when the first async-scrollable scroll frame for which we build a
-  // display list has a display port. An async-scrollable scroll frame is one
-  // which WantsAsyncScroll().
-  bool                           mHaveScrollableDisplayPort;
+  // Number of async-scrollable scroll frames for which we have given out a
+  // display port while building this display list. An async-scrollable
+  // scroll frame is one which WantsAsyncScroll().
+  uint32_t                       mScrollableDisplayPortCount;
 };
 
 class nsDisplayItem;
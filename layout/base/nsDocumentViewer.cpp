@@ -2296,21 +2296,17 @@ nsDocumentViewer::CreateStyleSet(nsIDocument* aDocument,
       styleSet->PrependStyleSheet(nsStyleSet::eAgentSheet, sheet);
     }
 
-    // Make sure to clone the quirk sheet so that it can be usefully
-    // enabled/disabled as needed.
-    nsRefPtr<CSSStyleSheet> quirkClone;
-    CSSStyleSheet* quirkSheet;
-    if (!nsLayoutStylesheetCache::UASheet() ||
-        !(quirkSheet = nsLayoutStylesheetCache::QuirkSheet()) ||
-        !(quirkClone = quirkSheet->Clone(nullptr, nullptr, nullptr, nullptr)) ||
-        !sheet) {
+    // The quirk sheet is shared between documents; whether its rules apply
+    // is decided per rule cascade, based on the document's compatibility
+    // mode, so there's no need to clone it or toggle it here.
+    CSSStyleSheet* quirkSheet = nsLayoutStylesheetCache::QuirkSheet();
+    if (!nsLayoutStylesheetCache::UASheet() || !quirkSheet || !sheet) {
       delete styleSet;
       return NS_ERROR_OUT_OF_MEMORY;
     }
     // quirk.css needs to come after the regular UA sheet (or more precisely,
     // after the html.css and so forth that the UA sheet imports).
-    styleSet->PrependStyleSheet(nsStyleSet::eAgentSheet, quirkClone);
-    styleSet->SetQuirkStyleSheet(quirkClone);
+    styleSet->PrependStyleSheet(nsStyleSet::eAgentSheet, quirkSheet);
 
     if (aDocument->LoadsFullXULStyleSheetUpFront()) {
       // nsXULElement::BindToTree loads xul.css on-demand if we don't load it
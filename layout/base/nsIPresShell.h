@@ -1236,6 +1236,21 @@ public:
 
   virtual nsresult SetIsActive(bool aIsActive) = 0;
 
+  /**
+   * Release presentation memory that can be regenerated on demand, such as
+   * unused rule nodes in the style set. Called when the containing tab has
+   * been hidden for a while.
+   */
+  virtual void CompactMemory() = 0;
+
+  /**
+   * Kick off asynchronous redecode of the images on the visible list, so
+   * that an imminent tab switch does not pay decode latency at first paint.
+   * The counterpart of the discard that happens once a tab has been hidden
+   * for a while.
+   */
+  virtual void WarmUpVisibleImages() = 0;
+
   bool IsActive()
   {
     return mIsActive;
@@ -135,6 +135,7 @@ typedef FrameMetrics::ViewID ViewID;
 /* static */ bool nsLayoutUtils::sInvalidationDebuggingIsEnabled;
 /* static */ bool nsLayoutUtils::sCSSVariablesEnabled;
 /* static */ bool nsLayoutUtils::sInterruptibleReflowEnabled;
+/* static */ int32_t nsLayoutUtils::sInterruptibleReflowSliceMs;
 
 static ViewID sScrollIdCounter = FrameMetrics::START_SCROLL_ID;
 
@@ -2874,14 +2875,15 @@ nsLayoutUtils::GetOrMaybeCreateDisplayPort(nsDisplayListBuilder& aBuilder,
 
   bool haveDisplayPort = GetDisplayPort(content, aOutDisplayport);
 
-  // We perform an optimization where we ensure that at least one
-  // async-scrollable frame (i.e. one that WantsAsyncScroll()) has a displayport.
-  // If that's not the case yet, and we are async-scrollable, we will get a
-  // displayport.
+  // We ensure that async-scrollable frames (i.e. ones that WantAsyncScroll())
+  // get displayports so that APZ can scroll them without bouncing off the
+  // main thread, up to a shared budget across the scroll tree
+  // (apz.subframe.displayport_budget) to bound the layer memory that nested
+  // scroll panes can retain.
   // Note: we only do this in processes where we do subframe scrolling to
   //       begin with (i.e., not in the parent process on B2G).
   if (aBuilder.IsPaintingToWindow() && WantSubAPZC() &&
-      !aBuilder.HaveScrollableDisplayPort() &&
+      !aBuilder.ScrollableDisplayPortBudgetExhausted() &&
       scrollableFrame->WantAsyncScroll()) {
 
     // If we don't already have a displayport, calculate and set one.
@@ -2891,8 +2893,8 @@ nsLayoutUtils::GetOrMaybeCreateDisplayPort(nsDisplayListBuilder& aBuilder,
       NS_ASSERTION(haveDisplayPort, "should have a displayport after having just set it");
     }
 
-    // Record that the we now have a scrollable display port.
-    aBuilder.SetHaveScrollableDisplayPort();
+    // Charge this displayport against the shared budget.
+    aBuilder.NoteScrollableDisplayPort();
   }
 
   return haveDisplayPort;
@@ -6839,6 +6841,9 @@ nsLayoutUtils::Initialize()
                                "layout.css.variables.enabled");
   Preferences::AddBoolVarCache(&sInterruptibleReflowEnabled,
                                "layout.interruptible-reflow.enabled");
+  Preferences::AddIntVarCache(&sInterruptibleReflowSliceMs,
+                              "layout.interruptible-reflow.time-slice-ms",
+                              100);
 
   Preferences::RegisterCallback(GridEnabledPrefChangeCallback,
                                 GRID_ENABLED_PREF_NAME);
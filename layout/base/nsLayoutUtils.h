@@ -2174,6 +2174,16 @@ public:
     return sInterruptibleReflowEnabled;
   }
 
+  /**
+   * The longest time slice, in milliseconds, an interruptible reflow may
+   * consume before it yields even when no input event is pending yet.
+   * Zero disables time-based yielding.
+   */
+  static int32_t InterruptibleReflowSliceMs()
+  {
+    return sInterruptibleReflowSliceMs;
+  }
+
   /**
    * Unions the overflow areas of the children of aFrame with aOverflowAreas.
    * aSkipChildLists specifies any child lists that should be skipped.
@@ -2544,6 +2554,7 @@ private:
   static bool sInvalidationDebuggingIsEnabled;
   static bool sCSSVariablesEnabled;
   static bool sInterruptibleReflowEnabled;
+  static int32_t sInterruptibleReflowSliceMs;
 
   /**
    * Helper function for LogTestDataForPaint().
@@ -7,37 +7,140 @@
 
 /* arena allocation for the frame tree and closely-related objects */
 
-// Even on 32-bit systems, we allocate objects from the frame arena
-// that require 8-byte alignment.  The cast to uintptr_t is needed
-// because plarena isn't as careful about mask construction as it
-// ought to be.
-#define ALIGN_SHIFT 3
-#define PL_ARENA_CONST_ALIGN_MASK ((uintptr_t(1) << ALIGN_SHIFT) - 1)
-#include "plarena.h"
-// plarena.h needs to be included first to make it use the above
-// PL_ARENA_CONST_ALIGN_MASK in this file.
-
 #include "nsPresArena.h"
 
+#include <stdlib.h>
 #include "mozilla/Poison.h"
 #include "nsDebug.h"
 #include "nsArenaMemoryStats.h"
 #include "nsPrintfCString.h"
 
-// Size to use for PLArena block allocations.
+// Even on 32-bit systems, we allocate objects from the frame arena
+// that require 8-byte alignment.
+#define ALIGN_SHIFT 3
+static const size_t ALIGN_MASK = (size_t(1) << ALIGN_SHIFT) - 1;
+
+static size_t
+AlignUp(size_t aSize)
+{
+  return (aSize + ALIGN_MASK) & ~ALIGN_MASK;
+}
+
+// Size to use for page allocations.  Objects too big for this get a
+// page of their own.
 static const size_t ARENA_PAGE_SIZE = 8192;
 
+// Pages are carved into objects of a single size class, bump-style, from
+// DataOffset() up to mSize.  Freed objects link through their first word
+// onto the page's own free list; once mLive drops to zero the whole page
+// can go back to malloc, which is what keeps a long session of dynamic
+// DOM churn from retaining the arena's high-water mark forever.
+struct nsPresArena::Page
+{
+  void* mFreeHead;    // intrusive LIFO of freed objects on this page
+  uint32_t mSize;     // malloc'd size of this page, in bytes
+  uint32_t mLive;     // objects carved out and not yet freed
+  uint32_t mBump;     // offset of the first never-carved byte
+  bool mPartial;      // true while on the free list's mPartialPages
+
+  static uint32_t DataOffset()
+  {
+    return uint32_t(AlignUp(sizeof(Page)));
+  }
+};
+
 nsPresArena::nsPresArena()
 {
-  PL_INIT_ARENA_POOL(&mPool, "PresArena", ARENA_PAGE_SIZE);
 }
 
 nsPresArena::~nsPresArena()
 {
-#if defined(MOZ_HAVE_MEM_CHECKS)
-  mFreeLists.EnumerateEntries(UnpoisonFreeList, nullptr);
-#endif
-  PL_FinishArenaPool(&mPool);
+  mFreeLists.EnumerateEntries(FreePagesEnumerator, nullptr);
+}
+
+/* static */ PLDHashOperator
+nsPresArena::FreePagesEnumerator(FreeList* aEntry, void*)
+{
+  for (uint32_t i = 0; i < aEntry->mPages.Length(); ++i) {
+    Page* page = aEntry->mPages[i];
+    // Freed objects on the page were marked inaccessible; the allocator is
+    // entitled to touch the memory it gets back.
+    MOZ_MAKE_MEM_UNDEFINED(page, page->mSize);
+    free(page);
+  }
+  aEntry->mPages.Clear();
+  aEntry->mPartialPages.Clear();
+  aEntry->mCurrentPage = nullptr;
+  return PL_DHASH_NEXT;
+}
+
+nsPresArena::Page*
+nsPresArena::NewPage(FreeList* aList)
+{
+  size_t size = ARENA_PAGE_SIZE;
+  size_t minSize = Page::DataOffset() + aList->mEntrySize;
+  if (size < minSize) {
+    size = minSize;
+  }
+
+  Page* page = static_cast<Page*>(moz_xmalloc(size));
+  page->mFreeHead = nullptr;
+  page->mSize = uint32_t(size);
+  page->mLive = 0;
+  page->mBump = Page::DataOffset();
+  page->mPartial = false;
+
+  // Keep mPages address-sorted so Free() can find an object's page with a
+  // binary search.
+  size_t lo = 0, hi = aList->mPages.Length();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (aList->mPages[mid] < page) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  aList->mPages.InsertElementAt(lo, page);
+  aList->mCurrentPage = page;
+  return page;
+}
+
+/* static */ nsPresArena::Page*
+nsPresArena::FindPage(FreeList* aList, void* aPtr)
+{
+  const nsTArray<Page*>& pages = aList->mPages;
+  size_t lo = 0, hi = pages.Length();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (reinterpret_cast<char*>(pages[mid]) <= static_cast<char*>(aPtr)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == 0) {
+    return nullptr;
+  }
+  Page* page = pages[lo - 1];
+  if (static_cast<char*>(aPtr) >= reinterpret_cast<char*>(page) + page->mSize) {
+    return nullptr;
+  }
+  return page;
+}
+
+/* static */ void
+nsPresArena::ReclaimPage(FreeList* aList, Page* aPage)
+{
+  // Every object carved from this page is back on the page's free list, so
+  // the memory can be returned to malloc.  Take the page's objects out of
+  // the size class's allocation count.
+  aList->mEntriesAllocated -=
+    (aPage->mBump - Page::DataOffset()) / aList->mEntrySize;
+  aList->mPages.RemoveElement(aPage);
+  aList->mPartialPages.RemoveElement(aPage);
+  MOZ_MAKE_MEM_UNDEFINED(aPage, aPage->mSize);
+  free(aPage);
 }
 
 void*
@@ -46,31 +149,39 @@ nsPresArena::Allocate(uint32_t aCode, size_t aSize)
   NS_ABORT_IF_FALSE(aSize > 0, "PresArena cannot allocate zero bytes");
 
   // We only hand out aligned sizes
-  aSize = PL_ARENA_ALIGN(&mPool, aSize);
+  aSize = AlignUp(aSize);
 
   // If there is no free-list entry for this type already, we have
   // to create one now, to record its size.
   FreeList* list = mFreeLists.PutEntry(aCode);
 
-  nsTArray<void*>::index_type len = list->mEntries.Length();
   if (list->mEntrySize == 0) {
-    NS_ABORT_IF_FALSE(len == 0, "list with entries but no recorded size");
+    NS_ABORT_IF_FALSE(list->mPages.IsEmpty(),
+                      "list with pages but no recorded size");
     list->mEntrySize = aSize;
   } else {
     NS_ABORT_IF_FALSE(list->mEntrySize == aSize,
                       "different sizes for same object type code");
   }
 
-  void* result;
-  if (len > 0) {
-    // LIFO behavior for best cache utilization
-    result = list->mEntries.ElementAt(len - 1);
-    list->mEntries.RemoveElementAt(len - 1);
+  // Recycle from a partially free page if there is one.
+  if (!list->mPartialPages.IsEmpty()) {
+    Page* page = list->mPartialPages.LastElement();
+    void* result = page->mFreeHead;
+    MOZ_MAKE_MEM_DEFINED(result, sizeof(void*));
+    page->mFreeHead = *static_cast<void**>(result);
+    page->mLive++;
+    if (!page->mFreeHead) {
+      page->mPartial = false;
+      list->mPartialPages.RemoveElementAt(list->mPartialPages.Length() - 1);
+    }
 #if defined(DEBUG)
     {
       MOZ_MAKE_MEM_DEFINED(result, list->mEntrySize);
-      char* p = reinterpret_cast<char*>(result);
-      char* limit = p + list->mEntrySize;
+      // The first word of a freed object holds its free-list link, so the
+      // poison check starts past it.
+      char* p = reinterpret_cast<char*>(result) + sizeof(void*);
+      char* limit = reinterpret_cast<char*>(result) + list->mEntrySize;
       for (; p < limit; p += sizeof(uintptr_t)) {
         uintptr_t val = *reinterpret_cast<uintptr_t*>(p);
         NS_ABORT_IF_FALSE(val == mozPoisonValue(),
@@ -89,58 +200,74 @@ nsPresArena::Allocate(uint32_t aCode, size_t aSize)
     return result;
   }
 
-  // Allocate a new chunk from the arena
-  list->mEntriesEverAllocated++;
-  PL_ARENA_ALLOCATE(result, &mPool, aSize);
-  if (!result) {
-    NS_ABORT_OOM(aSize);
+  // Carve from the newest page's unused tail, starting a new page if it is
+  // full (or if there are no pages yet).
+  Page* page = list->mCurrentPage;
+  if (!page || page->mBump + list->mEntrySize > page->mSize) {
+    page = NewPage(list);
   }
+
+  void* result = reinterpret_cast<char*>(page) + page->mBump;
+  page->mBump += uint32_t(list->mEntrySize);
+  page->mLive++;
+  list->mEntriesAllocated++;
   return result;
 }
 
 void
 nsPresArena::Free(uint32_t aCode, void* aPtr)
 {
-  // Try to recycle this entry.
   FreeList* list = mFreeLists.GetEntry(aCode);
   NS_ABORT_IF_FALSE(list, "no free list for pres arena object");
   NS_ABORT_IF_FALSE(list->mEntrySize > 0, "PresArena cannot free zero bytes");
 
+  Page* page = FindPage(list, aPtr);
+  NS_ABORT_IF_FALSE(page, "freeing object not allocated by this arena");
+  NS_ABORT_IF_FALSE(page->mLive > 0, "freeing object twice?");
+
   mozWritePoison(aPtr, list->mEntrySize);
 
+  // Thread the object onto its own page's free list; the link lives in the
+  // object's first word, over the poison.
+  *static_cast<void**>(aPtr) = page->mFreeHead;
+  page->mFreeHead = aPtr;
+  page->mLive--;
   MOZ_MAKE_MEM_NOACCESS(aPtr, list->mEntrySize);
-  list->mEntries.AppendElement(aPtr);
+
+  if (!page->mPartial) {
+    page->mPartial = true;
+    list->mPartialPages.AppendElement(page);
+  }
+
+  // If the page is now entirely free, give it back to malloc.  The current
+  // (bump) page is kept as a buffer against a single object being allocated
+  // and freed in a tight loop re-creating a page each time.
+  if (page->mLive == 0 && page != list->mCurrentPage) {
+    ReclaimPage(list, page);
+  }
 }
 
 struct EnumerateData {
   nsArenaMemoryStats* stats;
+  mozilla::MallocSizeOf mallocSizeOf;
   size_t total;
+  size_t pagesSize;
 };
 
-#if defined(MOZ_HAVE_MEM_CHECKS)
-/* static */ PLDHashOperator
-nsPresArena::UnpoisonFreeList(FreeList* aEntry, void*)
-{
-  nsTArray<void*>::index_type len;
-  while ((len = aEntry->mEntries.Length())) {
-    void* result = aEntry->mEntries.ElementAt(len - 1);
-    aEntry->mEntries.RemoveElementAt(len - 1);
-    MOZ_MAKE_MEM_UNDEFINED(result, aEntry->mEntrySize);
-  }
-  return PL_DHASH_NEXT;
-}
-#endif
-
 /* static */ PLDHashOperator
 nsPresArena::FreeListEnumerator(FreeList* aEntry, void* aData)
 {
   EnumerateData* data = static_cast<EnumerateData*>(aData);
-  // Note that we're not measuring the size of the entries on the free
-  // list here.  The free list knows how many objects we've allocated
-  // ever (which includes any objects that may be on the FreeList's
-  // |mEntries| at this point) and we're using that to determine the
-  // total size of objects allocated with a given ID.
-  size_t totalSize = aEntry->mEntrySize * aEntry->mEntriesEverAllocated;
+
+  for (uint32_t i = 0; i < aEntry->mPages.Length(); ++i) {
+    data->pagesSize += data->mallocSizeOf(aEntry->mPages[i]);
+  }
+
+  // Note that we're not distinguishing live objects from freed objects
+  // still backed by their page here.  The free list knows how many objects
+  // its pages are currently carved into and we're using that to determine
+  // the total size of objects allocated with a given ID.
+  size_t totalSize = aEntry->mEntrySize * aEntry->mEntriesAllocated;
   size_t* p;
 
   switch (NS_PTR_TO_INT32(aEntry->mKey)) {
@@ -177,17 +304,17 @@ nsPresArena::AddSizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf,
   // space taken up by the different kinds of objects in the arena,
   // but we don't have pointers to those objects.  And even if we did,
   // we wouldn't be able to use aMallocSizeOf on them, since they were
-  // allocated out of malloc'd chunks of memory.  So we compute the
-  // size of the arena as known by malloc and we add up the sizes of
+  // allocated out of malloc'd pages of memory.  So we compute the
+  // size of the pages as known by malloc and we add up the sizes of
   // all the objects that we care about.  Subtracting these two
   // quantities gives us a catch-all "other" number, which includes
-  // slop in the arena itself as well as the size of objects that
+  // slop and page headers as well as the size of objects that
   // we've not measured explicitly.
 
-  size_t mallocSize = PL_SizeOfArenaPoolExcludingPool(&mPool, aMallocSizeOf);
-  mallocSize += mFreeLists.SizeOfExcludingThis(aMallocSizeOf);
-
-  EnumerateData data = { aArenaStats, 0 };
+  EnumerateData data = { aArenaStats, aMallocSizeOf, 0, 0 };
   mFreeLists.EnumerateEntries(FreeListEnumerator, &data);
+
+  size_t mallocSize = data.pagesSize +
+                      mFreeLists.SizeOfExcludingThis(aMallocSizeOf);
   aArenaStats->mOther += mallocSize - data.total;
 }
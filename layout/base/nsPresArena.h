@@ -10,14 +10,14 @@
 #ifndef nsPresArena_h___
 #define nsPresArena_h___
 
-#include "mozilla/MemoryChecking.h" // Note: Do not remove this, needed for MOZ_HAVE_MEM_CHECKS below
+#include "mozilla/MemoryChecking.h" // Note: Do not remove this, needed for the
+                                    // MOZ_MAKE_MEM_* macros in nsPresArena.cpp
 #include "mozilla/MemoryReporting.h"
 #include <stdint.h>
 #include "nscore.h"
 #include "nsQueryFrame.h"
 #include "nsTArray.h"
 #include "nsTHashtable.h"
-#include "plarena.h"
 
 struct nsArenaMemoryStats;
 
@@ -108,21 +108,33 @@ private:
   void* Allocate(uint32_t aCode, size_t aSize);
   void Free(uint32_t aCode, void* aPtr);
 
+  // A Page is a malloc'd block carved into objects of a single size class.
+  // Each page counts how many of its objects are live and keeps its own
+  // free-slot list, so a page whose objects have all been freed can be
+  // returned to malloc instead of its memory lingering on a free list for
+  // the lifetime of the shell.  See nsPresArena.cpp for the layout.
+  struct Page;
+
   // All keys to this hash table fit in 32 bits (see below) so we do not
   // bother actually hashing them.
   class FreeList : public PLDHashEntryHdr
   {
   public:
     typedef uint32_t KeyType;
-    nsTArray<void *> mEntries;
+    nsTArray<Page*> mPages;        // every page, sorted by address
+    nsTArray<Page*> mPartialPages; // pages with at least one free slot
+    Page* mCurrentPage;            // newest page; the only one with virgin
+                                   // space left to carve
     size_t mEntrySize;
-    size_t mEntriesEverAllocated;
+    // Objects currently backed by this size class's pages, live or on a
+    // page's free list.  Decremented when a page is reclaimed.
+    size_t mEntriesAllocated;
 
     typedef const void* KeyTypePointer;
     KeyTypePointer mKey;
 
     explicit FreeList(KeyTypePointer aKey)
-    : mEntrySize(0), mEntriesEverAllocated(0), mKey(aKey) {}
+    : mCurrentPage(nullptr), mEntrySize(0), mEntriesAllocated(0), mKey(aKey) {}
     // Default copy constructor and destructor are ok.
 
     bool KeyEquals(KeyTypePointer const aKey) const
@@ -135,18 +147,22 @@ private:
     { return NS_PTR_TO_INT32(aKey); }
 
     size_t SizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf) const
-    { return mEntries.SizeOfExcludingThis(aMallocSizeOf); }
+    {
+      return mPages.SizeOfExcludingThis(aMallocSizeOf) +
+             mPartialPages.SizeOfExcludingThis(aMallocSizeOf);
+    }
 
     enum { ALLOW_MEMMOVE = false };
   };
 
-#if defined(MOZ_HAVE_MEM_CHECKS)
-  static PLDHashOperator UnpoisonFreeList(FreeList* aEntry, void*);
-#endif
+  Page* NewPage(FreeList* aList);
+  static Page* FindPage(FreeList* aList, void* aPtr);
+  static void ReclaimPage(FreeList* aList, Page* aPage);
+
+  static PLDHashOperator FreePagesEnumerator(FreeList* aEntry, void*);
   static PLDHashOperator FreeListEnumerator(FreeList* aEntry, void* aData);
 
   nsTHashtable<FreeList> mFreeLists;
-  PLArenaPool mPool;
 };
 
 #endif
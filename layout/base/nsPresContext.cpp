@@ -1319,12 +1319,10 @@ nsPresContext::GetDisplayRootPresContext()
 void
 nsPresContext::CompatibilityModeChanged()
 {
-  if (!mShell)
-    return;
-
-  // enable/disable the QuirkSheet
-  mShell->StyleSet()->
-    EnableQuirkStyleSheet(CompatibilityMode() == eCompatibility_NavQuirks);
+  // Nothing to do: rule cascades are selected against the compatibility
+  // mode at the time they are used (nsCSSRuleProcessor::GetRuleCascade),
+  // so the quirk sheet's rules start or stop applying without any eager
+  // work here.
 }
 
 // Helper function for setting Anim Mode on image
@@ -2680,12 +2678,26 @@ nsPresContext::CheckForInterrupt(nsIFrame* aFrame)
   }
   mInterruptChecksToSkip = sInterruptChecksToSkip;
 
+  TimeDuration elapsed = TimeStamp::Now() - mReflowStartTime;
+
   // Don't interrupt if it's been less than sInterruptTimeout since we started
   // the reflow.
   mHasPendingInterrupt =
-    TimeStamp::Now() - mReflowStartTime > sInterruptTimeout &&
+    elapsed > sInterruptTimeout &&
     HavePendingInputEvent() &&
     !IsChrome();
+
+  // Even with no input event queued yet, yield once the reflow has used up
+  // its whole time slice.  Completed dirty roots stay valid, the interrupted
+  // subtree is checkpointed through FrameNeedsToContinueReflow, and the shell
+  // resumes from the next tick, so worst-case input latency is bounded by the
+  // slice length rather than by the total reflow size.
+  int32_t sliceMs = nsLayoutUtils::InterruptibleReflowSliceMs();
+  if (!mHasPendingInterrupt && sliceMs > 0 && !IsChrome() &&
+      elapsed > TimeDuration::FromMilliseconds(sliceMs)) {
+    mHasPendingInterrupt = true;
+  }
+
   if (mHasPendingInterrupt) {
 #ifdef NOISY_INTERRUPTIBLE_REFLOW
     printf("*** DETECTED pending interrupt (time=%lld)\n", PR_Now());
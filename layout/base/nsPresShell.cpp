@@ -20,6 +20,7 @@
 
 #include "prlog.h"
 
+#include "mozilla/ArenaScope.h"
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/CSSStyleSheet.h"
 #include "mozilla/EventDispatcher.h"
@@ -165,6 +166,7 @@
 #include "mozilla/Telemetry.h"
 #include "nsCanvasFrame.h"
 #include "nsIImageLoadingContent.h"
+#include "imgIRequest.h"
 #include "nsIScreen.h"
 #include "nsIScreenManager.h"
 #include "nsPlaceholderFrame.h"
@@ -9192,6 +9194,8 @@ PresShell::DoReflow(nsIFrame* target, bool aInterruptible)
     return true;
   }
 
+  Telemetry::IncrementPerfCounter(Telemetry::PERF_COUNTER_REFLOWS);
+
   gfxTextPerfMetrics* tp = mPresContext->GetTextPerfMetrics();
   TimeStamp timeStart;
   if (tp) {
@@ -9225,6 +9229,12 @@ PresShell::DoReflow(nsIFrame* target, bool aInterruptible)
     mReflowContinueTimer = nullptr;
   }
 
+  // Transient arena allocations made anywhere in this reflow (table
+  // intrinsic inline-size computation, XUL box layout, ...) share this
+  // scope, so the nested ArenaScopes those callers open become pointer
+  // bumps into our blocks instead of creating arenas of their own.
+  ArenaScope arenaScope;
+
   nsIFrame* rootFrame = mFrameConstructor->GetRootFrame();
 
   nsRenderingContext rcx(CreateReferenceRenderingContext());
@@ -10938,6 +10948,42 @@ PresShell::SetIsActive(bool aIsActive)
   return rv;
 }
 
+void
+PresShell::CompactMemory()
+{
+  if (mIsDestroying || mIsReflowing) {
+    return;
+  }
+
+  // Unused rule nodes normally linger until enough style contexts have been
+  // destroyed; sweep them now so their arena pages go back to the heap.
+  mStyleSet->TrimRuleTrees();
+}
+
+static PLDHashOperator
+RequestDecodeEnumerator(nsRefPtrHashKey<nsIImageLoadingContent>* aEntry,
+                        void* userArg)
+{
+  nsCOMPtr<imgIRequest> request;
+  aEntry->GetKey()->GetRequest(nsIImageLoadingContent::CURRENT_REQUEST,
+                               getter_AddRefs(request));
+  if (request) {
+    // Decoding runs on the image decode pool; this only queues the work.
+    request->RequestDecode();
+  }
+  return PL_DHASH_NEXT;
+}
+
+void
+PresShell::WarmUpVisibleImages()
+{
+  if (mIsDestroying) {
+    return;
+  }
+
+  mVisibleImages.EnumerateEntries(RequestDecodeEnumerator, nullptr);
+}
+
 /*
  * Determines the current image locking state. Called when one of the
  * dependent factors changes.
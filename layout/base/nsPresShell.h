@@ -337,6 +337,10 @@ public:
 
   virtual nsresult SetIsActive(bool aIsActive) MOZ_OVERRIDE;
 
+  virtual void CompactMemory() MOZ_OVERRIDE;
+
+  virtual void WarmUpVisibleImages() MOZ_OVERRIDE;
+
   virtual bool GetIsViewportOverridden() MOZ_OVERRIDE { return mViewportOverridden; }
 
   virtual bool IsLayoutFlushObserver() MOZ_OVERRIDE
@@ -67,6 +67,9 @@ static PRLogModuleInfo *gLog = nullptr;
 
 #define DEFAULT_FRAME_RATE 60
 #define DEFAULT_THROTTLED_FRAME_RATE 1
+// Number of over-budget ticks (decayed by ticks that stay within the frame
+// budget) after which throttleable work degrades to every other tick.
+#define SUSTAINED_OVERRUN_TICKS 5
 // after 10 minutes, stop firing off inactive timers
 #define DEFAULT_INACTIVE_TIMER_DISABLE_SECONDS 600
 
@@ -136,6 +139,25 @@ public:
   TimeStamp MostRecentRefresh() const { return mLastFireTime; }
   int64_t MostRecentRefreshEpochTime() const { return mLastFireEpoch; }
 
+  /*
+   * Returns a deadline for main-thread work that wants to stay out of the
+   * way of the next tick.  Returns aDefault if no tick is expected soon
+   * (the timer has no attached drivers, or hasn't fired yet) or if the
+   * next expected tick time has already passed.
+   */
+  TimeStamp GetIdleDeadlineHint(TimeStamp aDefault)
+  {
+    if (mRefreshDrivers.IsEmpty() || mLastFireTime.IsNull()) {
+      return aDefault;
+    }
+
+    TimeStamp deadline = mLastFireTime + mRateDuration;
+    if (deadline <= TimeStamp::Now()) {
+      return aDefault;
+    }
+    return deadline < aDefault ? deadline : aDefault;
+  }
+
 protected:
   virtual void StartTimer() = 0;
   virtual void StopTimer() = 0;
@@ -618,6 +640,17 @@ nsRefreshDriver::DefaultInterval()
   return NSToIntRound(1000.0 / DEFAULT_FRAME_RATE);
 }
 
+/* static */ mozilla::TimeStamp
+nsRefreshDriver::GetIdleDeadlineHint(mozilla::TimeStamp aDefault)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!sRegularRateTimer) {
+    return aDefault;
+  }
+  return sRegularRateTimer->GetIdleDeadlineHint(aDefault);
+}
+
 // Compute the interval to use for the refresh driver timer, in milliseconds.
 // outIsDefault indicates that rate was not explicitly set by the user
 // so we might choose other, more appropriate rates (e.g. vsync, etc)
@@ -704,7 +737,9 @@ nsRefreshDriver::nsRefreshDriver(nsPresContext* aPresContext)
     mRequestedHighPrecision(false),
     mInRefresh(false),
     mWaitingForTransaction(false),
-    mSkippedPaints(false)
+    mSkippedPaints(false),
+    mBudgetOverrunTicks(0),
+    mSkippedThrottleableLastTick(false)
 {
   mMostRecentRefreshEpochTime = JS_Now();
   mMostRecentRefresh = TimeStamp::Now();
@@ -1182,6 +1217,15 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
   AutoRestore<TimeStamp> restoreTickStart(mTickStart);
   mTickStart = TimeStamp::Now();
 
+  // Under sustained budget overrun, run throttleable work (image animations
+  // and frame request callbacks) only every other tick, so that the
+  // compositor-critical observers and flushes below degrade as little as
+  // possible.
+  bool skipThrottleable =
+    mBudgetOverrunTicks >= SUSTAINED_OVERRUN_TICKS &&
+    !mSkippedThrottleableLastTick;
+  mSkippedThrottleableLastTick = skipThrottleable;
+
   /*
    * The timer holds a reference to |this| while calling |Notify|.
    * However, implementations of |WillRefresh| are permitted to destroy
@@ -1189,6 +1233,8 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
    * null.  If this happens, we must stop notifying observers.
    */
   for (uint32_t i = 0; i < ArrayLength(mObservers); ++i) {
+    TimeStamp tierStart = TimeStamp::Now();
+
     ObserverArray::EndLimitedIterator etor(mObservers[i]);
     while (etor.HasMore()) {
       nsRefPtr<nsARefreshObserver> obs = etor.GetNext();
@@ -1203,46 +1249,50 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
     if (i == 0) {
       // This is the Flush_Style case.
 
-      // Grab all of our frame request callbacks up front.
-      nsTArray<DocumentFrameCallbacks>
-        frameRequestCallbacks(mFrameRequestCallbackDocs.Length());
-      for (uint32_t i = 0; i < mFrameRequestCallbackDocs.Length(); ++i) {
-        frameRequestCallbacks.AppendElement(mFrameRequestCallbackDocs[i]);
-        mFrameRequestCallbackDocs[i]->
-          TakeFrameRequestCallbacks(frameRequestCallbacks.LastElement().mCallbacks);
-      }
-      // OK, now reset mFrameRequestCallbackDocs so they can be
-      // readded as needed.
-      mFrameRequestCallbackDocs.Clear();
-
-      profiler_tracing("Paint", "Scripts", TRACING_INTERVAL_START);
-      int64_t eventTime = aNowEpoch / PR_USEC_PER_MSEC;
-      for (uint32_t i = 0; i < frameRequestCallbacks.Length(); ++i) {
-        const DocumentFrameCallbacks& docCallbacks = frameRequestCallbacks[i];
-        // XXXbz Bug 863140: GetInnerWindow can return the outer
-        // window in some cases.
-        nsPIDOMWindow* innerWindow = docCallbacks.mDocument->GetInnerWindow();
-        DOMHighResTimeStamp timeStamp = 0;
-        if (innerWindow && innerWindow->IsInnerWindow()) {
-          nsPerformance* perf = innerWindow->GetPerformance();
-          if (perf) {
-            timeStamp = perf->GetDOMTiming()->TimeStampToDOMHighRes(aNowTime);
-          }
-          // else window is partially torn down already
+      // When degraded, leave mFrameRequestCallbackDocs alone so the
+      // callbacks run on the next tick instead.
+      if (!skipThrottleable) {
+        // Grab all of our frame request callbacks up front.
+        nsTArray<DocumentFrameCallbacks>
+          frameRequestCallbacks(mFrameRequestCallbackDocs.Length());
+        for (uint32_t i = 0; i < mFrameRequestCallbackDocs.Length(); ++i) {
+          frameRequestCallbacks.AppendElement(mFrameRequestCallbackDocs[i]);
+          mFrameRequestCallbackDocs[i]->
+            TakeFrameRequestCallbacks(frameRequestCallbacks.LastElement().mCallbacks);
         }
-        for (uint32_t j = 0; j < docCallbacks.mCallbacks.Length(); ++j) {
-          const nsIDocument::FrameRequestCallbackHolder& holder =
-            docCallbacks.mCallbacks[j];
-          nsAutoMicroTask mt;
-          if (holder.HasWebIDLCallback()) {
-            ErrorResult ignored;
-            holder.GetWebIDLCallback()->Call(timeStamp, ignored);
-          } else {
-            holder.GetXPCOMCallback()->Sample(eventTime);
+        // OK, now reset mFrameRequestCallbackDocs so they can be
+        // readded as needed.
+        mFrameRequestCallbackDocs.Clear();
+
+        profiler_tracing("Paint", "Scripts", TRACING_INTERVAL_START);
+        int64_t eventTime = aNowEpoch / PR_USEC_PER_MSEC;
+        for (uint32_t i = 0; i < frameRequestCallbacks.Length(); ++i) {
+          const DocumentFrameCallbacks& docCallbacks = frameRequestCallbacks[i];
+          // XXXbz Bug 863140: GetInnerWindow can return the outer
+          // window in some cases.
+          nsPIDOMWindow* innerWindow = docCallbacks.mDocument->GetInnerWindow();
+          DOMHighResTimeStamp timeStamp = 0;
+          if (innerWindow && innerWindow->IsInnerWindow()) {
+            nsPerformance* perf = innerWindow->GetPerformance();
+            if (perf) {
+              timeStamp = perf->GetDOMTiming()->TimeStampToDOMHighRes(aNowTime);
+            }
+            // else window is partially torn down already
+          }
+          for (uint32_t j = 0; j < docCallbacks.mCallbacks.Length(); ++j) {
+            const nsIDocument::FrameRequestCallbackHolder& holder =
+              docCallbacks.mCallbacks[j];
+            nsAutoMicroTask mt;
+            if (holder.HasWebIDLCallback()) {
+              ErrorResult ignored;
+              holder.GetWebIDLCallback()->Call(timeStamp, ignored);
+            } else {
+              holder.GetXPCOMCallback()->Sample(eventTime);
+            }
           }
         }
+        profiler_tracing("Paint", "Scripts", TRACING_INTERVAL_END);
       }
-      profiler_tracing("Paint", "Scripts", TRACING_INTERVAL_END);
 
       if (mPresContext && mPresContext->GetPresShell()) {
         bool tracingStyleFlush = false;
@@ -1335,29 +1385,44 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
         }
       }
     }
+
+    if (i == 0) {
+      mozilla::Telemetry::AccumulateTimeDelta(
+        mozilla::Telemetry::REFRESH_DRIVER_STYLE_FLUSH_TICK, tierStart);
+    } else if (i == 1) {
+      mozilla::Telemetry::AccumulateTimeDelta(
+        mozilla::Telemetry::REFRESH_DRIVER_LAYOUT_FLUSH_TICK, tierStart);
+    }
   }
 
   /*
    * Perform notification to imgIRequests subscribed to listen
-   * for refresh events.
+   * for refresh events.  Image animations are throttleable; when degraded
+   * they are notified only every other tick.
    */
+  if (!skipThrottleable) {
+    TimeStamp imageStart = TimeStamp::Now();
 
-  ImageRequestParameters parms = {aNowTime, previousRefresh, &mRequests};
+    ImageRequestParameters parms = {aNowTime, previousRefresh, &mRequests};
 
-  mStartTable.EnumerateRead(nsRefreshDriver::StartTableRefresh, &parms);
+    mStartTable.EnumerateRead(nsRefreshDriver::StartTableRefresh, &parms);
 
-  if (mRequests.Count()) {
-    // RequestRefresh may run scripts, so it's not safe to directly call it
-    // while using a hashtable enumerator to enumerate mRequests in case
-    // script modifies the hashtable. Instead, we build a (local) array of
-    // images to refresh, and then we refresh each image in that array.
-    nsCOMArray<imgIContainer> imagesToRefresh(mRequests.Count());
-    mRequests.EnumerateEntries(nsRefreshDriver::ImageRequestEnumerator,
-                               &imagesToRefresh);
+    if (mRequests.Count()) {
+      // RequestRefresh may run scripts, so it's not safe to directly call it
+      // while using a hashtable enumerator to enumerate mRequests in case
+      // script modifies the hashtable. Instead, we build a (local) array of
+      // images to refresh, and then we refresh each image in that array.
+      nsCOMArray<imgIContainer> imagesToRefresh(mRequests.Count());
+      mRequests.EnumerateEntries(nsRefreshDriver::ImageRequestEnumerator,
+                                 &imagesToRefresh);
 
-    for (uint32_t i = 0; i < imagesToRefresh.Length(); i++) {
-      imagesToRefresh[i]->RequestRefresh(aNowTime);
+      for (uint32_t i = 0; i < imagesToRefresh.Length(); i++) {
+        imagesToRefresh[i]->RequestRefresh(aNowTime);
+      }
     }
+
+    mozilla::Telemetry::AccumulateTimeDelta(
+      mozilla::Telemetry::REFRESH_DRIVER_IMAGE_REQUEST_TICK, imageStart);
   }
 
   for (uint32_t i = 0; i < mPresShellsToInvalidateIfHidden.Length(); i++) {
@@ -1403,6 +1468,18 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
 
   mozilla::Telemetry::AccumulateTimeDelta(mozilla::Telemetry::REFRESH_DRIVER_TICK, mTickStart);
 
+  // Track sustained overrun of the frame budget.  The counter decays on
+  // in-budget ticks instead of resetting, so degradation doesn't oscillate
+  // off as soon as the cheaper degraded ticks come in under budget.
+  if ((TimeStamp::Now() - mTickStart).ToMilliseconds() >
+      GetRefreshTimerInterval()) {
+    if (mBudgetOverrunTicks < 2 * SUSTAINED_OVERRUN_TICKS) {
+      mBudgetOverrunTicks++;
+    }
+  } else if (mBudgetOverrunTicks > 0) {
+    mBudgetOverrunTicks--;
+  }
+
   for (uint32_t i = 0; i < mPostRefreshObservers.Length(); ++i) {
     mPostRefreshObservers[i]->DidRefresh();
   }
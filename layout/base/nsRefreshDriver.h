@@ -269,6 +269,14 @@ public:
    */
   static int32_t DefaultInterval();
 
+  /**
+   * Returns a deadline by which main-thread work (such as a cycle
+   * collector slice) should aim to finish so it doesn't delay the next
+   * tick of the regular-rate timer.  Returns aDefault if no tick is
+   * expected soon or the next expected tick time has already passed.
+   */
+  static mozilla::TimeStamp GetIdleDeadlineHint(mozilla::TimeStamp aDefault);
+
   bool IsInRefresh() { return mInRefresh; }
 
   // mozilla::layers::TransactionIdAllocator
@@ -358,6 +366,16 @@ private:
   // of waiting until the next interval.
   bool mSkippedPaints;
 
+  // Count of recent ticks that overran the frame budget, decayed by ticks
+  // that stayed within it.  While this is at least the sustained-overrun
+  // threshold, throttleable work (image animations and frame request
+  // callbacks) runs only every other tick; compositor-critical observers
+  // and flushes always run.
+  uint32_t mBudgetOverrunTicks;
+  // Whether throttleable work was skipped on the previous tick, so
+  // degradation alternates instead of starving that work entirely.
+  bool mSkippedThrottleableLastTick;
+
   int64_t mMostRecentRefreshEpochTime;
   mozilla::TimeStamp mMostRecentRefresh;
   mozilla::TimeStamp mMostRecentTick;
@@ -175,6 +175,12 @@ FRAME_STATE_BIT(Generic, 32, NS_FRAME_IS_PUSHED_FLOAT)
 // This bit acts as a loop flag for recursive paint server drawing.
 FRAME_STATE_BIT(Generic, 33, NS_FRAME_DRAWING_AS_PAINTSERVER)
 
+// Set if a property has ever been stored for this frame in the pres
+// context's FramePropertyTable.  If it's not set, property lookups can
+// skip the hashtable probe entirely.  It stays set until the frame's
+// property table entry goes away, even if all properties are removed.
+FRAME_STATE_BIT(Generic, 34, NS_FRAME_MAY_HAVE_PROPERTIES)
+
 // Frame is a display root and the retained layer tree needs to be updated
 // at the next paint via display list construction.
 // Only meaningful for display roots, so we don't really need a global state
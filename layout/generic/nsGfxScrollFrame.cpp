@@ -794,6 +794,62 @@ GetBrowserRoot(nsIContent* aContent)
   return nullptr;
 }
 
+/**
+ * Decide whether a scroll frame may act as a reflow root (see
+ * NS_FRAME_REFLOW_ROOT).  PresShell::DoReflow reflows such a target in
+ * place at its current size and does not propagate anything to its
+ * ancestors, so this must only return true when the frame's size and
+ * position are fully determined by its own style and nothing it reports
+ * (overflow areas, abs-pos children) can extend beyond its bounds.
+ */
+static bool
+ScrollFrameCanBeReflowRoot(const nsIFrame* aFrame)
+{
+  // Our size must come purely from our own style, independent of our
+  // contents.  Coord min/max values are fine; they just clamp the fixed
+  // width/height to another fixed value.
+  const nsStylePosition* pos = aFrame->StylePosition();
+  if (pos->mWidth.GetUnit() != eStyleUnit_Coord ||
+      pos->mHeight.GetUnit() != eStyleUnit_Coord ||
+      (pos->mMinWidth.GetUnit() != eStyleUnit_Coord &&
+       pos->mMinWidth.GetUnit() != eStyleUnit_Auto) ||
+      (pos->mMinHeight.GetUnit() != eStyleUnit_Coord &&
+       pos->mMinHeight.GetUnit() != eStyleUnit_Auto) ||
+      (pos->mMaxWidth.GetUnit() != eStyleUnit_Coord &&
+       pos->mMaxWidth.GetUnit() != eStyleUnit_None) ||
+      (pos->mMaxHeight.GetUnit() != eStyleUnit_Coord &&
+       pos->mMaxHeight.GetUnit() != eStyleUnit_None)) {
+    return false;
+  }
+
+  // Reflow roots are reflowed with zero computed margin; auto or percent
+  // margins would also make our position depend on our container.
+  nsMargin margin;
+  if (!aFrame->StyleMargin()->GetMargin(margin) ||
+      margin != nsMargin(0, 0, 0, 0)) {
+    return false;
+  }
+
+  // Nothing may stick out of a non-root reflow root, since DoReflow won't
+  // update our ancestors' overflow areas.  Scrolling already contains our
+  // in-flow contents, but outlines, shadows, transforms and abs-pos
+  // children can all produce overflow of their own.
+  if (aFrame->StyleOutline()->GetOutlineStyle() != NS_STYLE_BORDER_STYLE_NONE ||
+      aFrame->StyleBorder()->mBoxShadow ||
+      aFrame->IsTransformed() ||
+      aFrame->HasAbsolutelyPositionedChildren()) {
+    return false;
+  }
+
+  // Restrict to block-level frames inside a block container: a line
+  // participant's placement depends on its baseline, and flex containers
+  // size and align items in ways the fixed width/height check above does
+  // not capture.
+  return aFrame->StyleDisplay()->mDisplay == NS_STYLE_DISPLAY_BLOCK &&
+         aFrame->GetParent() &&
+         aFrame->GetParent()->GetType() == nsGkAtoms::blockFrame;
+}
+
 void
 nsHTMLScrollFrame::Reflow(nsPresContext*           aPresContext,
                           nsHTMLReflowMetrics&     aDesiredSize,
@@ -911,6 +967,21 @@ nsHTMLScrollFrame::Reflow(nsPresContext*           aPresContext,
     mHelper.PostScrolledAreaEvent();
   }
 
+  // Promote fixed-size scroll frames to reflow roots, so that reflows
+  // triggered by content changes inside them stay contained in the
+  // subtree instead of walking the whole frame tree.  The bit is
+  // re-evaluated on every reflow since a style change may have made us
+  // ineligible.  Native anonymous scroll frames are skipped: text
+  // controls manage the bit on theirs themselves.
+  if (!mContent->IsInNativeAnonymousSubtree()) {
+    if (!mHelper.mIsRoot && !aPresContext->IsPaginated() &&
+        ScrollFrameCanBeReflowRoot(this)) {
+      AddStateBits(NS_FRAME_REFLOW_ROOT);
+    } else {
+      RemoveStateBits(NS_FRAME_REFLOW_ROOT);
+    }
+  }
+
   aStatus = NS_FRAME_COMPLETE;
   NS_FRAME_SET_TRUNCATION(aStatus, aReflowState, aDesiredSize);
   mHelper.PostOverflowEvent();
@@ -2850,6 +2921,17 @@ ScrollFrameHelper::BuildDisplayList(nsDisplayListBuilder*   aBuilder,
   bool createLayersForScrollbars = mIsRoot &&
     mOuter->PresContext()->IsRootContentDocument();
 
+  // Also create layers for the scrollbars of any scroll frame that APZ can
+  // scroll asynchronously, i.e. one with a display port. The compositor
+  // adjusts scrollbar layers directly from the async scroll offset
+  // (AsyncCompositionManager::ApplyAsyncTransformToScrollbar), so a
+  // layerized scrollbar stays glued to the async scroll position even when
+  // the main thread is too busy to repaint the thumb.
+  if (!createLayersForScrollbars && aBuilder->IsPaintingToWindow() &&
+      nsLayoutUtils::GetDisplayPort(mOuter->GetContent())) {
+    createLayersForScrollbars = true;
+  }
+
   if (aBuilder->GetIgnoreScrollFrame() == mOuter || IsIgnoringViewportClipping()) {
     // Root scrollframes have FrameMetrics and clipping on their container
     // layers, so don't apply clipping again.
@@ -599,9 +599,15 @@ nsImageFrame::OnSizeAvailable(imgIRequest* aRequest, imgIContainer* aImage)
     // This is valid and for the current request, so update our stored image
     // container, orienting according to our style.
     mImage = nsLayoutUtils::OrientImage(aImage, StyleVisibility()->mImageOrientation);
-    
+
     intrinsicSizeChanged = UpdateIntrinsicSize(mImage);
     intrinsicSizeChanged = UpdateIntrinsicRatio(mImage) || intrinsicSizeChanged;
+
+    if (mState & IMAGE_GOTINITIALREFLOW) {
+      // Layout has already placed us, so feed our position to the decode
+      // pool right away; the decode is usually still queued at this point.
+      UpdateImageDecodePriority();
+    }
   } else {
     // We no longer have a valid image, so release our stored image container.
     mImage = nullptr;
@@ -1005,10 +1011,46 @@ nsImageFrame::ReflowFinished()
   mReflowCallbackPosted = false;
 
   nsLayoutUtils::UpdateImageVisibilityForFrame(this);
+  UpdateImageDecodePriority();
 
   return false;
 }
 
+void
+nsImageFrame::UpdateImageDecodePriority()
+{
+  if (!mImage) {
+    return;
+  }
+
+  nsIFrame* rootFrame = PresContext()->PresShell()->GetRootFrame();
+  if (!rootFrame) {
+    return;
+  }
+
+  nsRect rect = GetRect();
+  rect.MoveTo(GetOffsetTo(rootFrame));
+  nsRect visibleArea = PresContext()->GetVisibleArea();
+
+  // Score by (visibility, area, distance below the fold): images
+  // intersecting the viewport outrank everything else, then bigger
+  // images beat smaller ones, and among similar sizes the ones fewer
+  // screenfuls down win.
+  uint32_t priority = rect.Intersects(visibleArea) ? (1u << 31) : 0;
+
+  int32_t width = nsPresContext::AppUnitsToIntCSSPixels(rect.width);
+  int32_t height = nsPresContext::AppUnitsToIntCSSPixels(rect.height);
+  uint32_t area = uint32_t(std::max(width, 0)) * uint32_t(std::max(height, 0));
+  priority |= std::min(area, 0x3FFFFFu) << 8;
+
+  if (visibleArea.height > 0) {
+    uint32_t screensDown = uint32_t(std::max(rect.y, 0) / visibleArea.height);
+    priority |= 0xFF - std::min(screensDown, 0xFFu);
+  }
+
+  mImage->SetDecodePriority(priority);
+}
+
 void
 nsImageFrame::ReflowCallbackCanceled()
 {
@@ -243,6 +243,13 @@ private:
   void GetDocumentCharacterSet(nsACString& aCharset) const;
   bool ShouldDisplaySelection();
 
+  /**
+   * Tell imagelib how soon this image is likely to be needed, based on
+   * where layout placed our frame, so the decode pool serves
+   * above-the-fold images first.
+   */
+  void UpdateImageDecodePriority();
+
   /**
    * Recalculate mIntrinsicSize from the image.
    *
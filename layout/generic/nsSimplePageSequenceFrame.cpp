@@ -24,6 +24,14 @@
 #include "nsICanvasRenderingContextInternal.h"
 #include "nsIDateTimeFormat.h"
 #include "nsServiceManagerUtils.h"
+#include "nsThreadUtils.h"
+#include "nsITimer.h"
+#include "mozilla/Atomics.h"
+#include "mozilla/Preferences.h"
+#include "mozilla/gfx/2D.h"
+#include "mozilla/gfx/DrawEventRecorder.h"
+#include "mozilla/gfx/PathHelpers.h"
+#include "mozilla/layout/PrintTranslator.h"
 #include <algorithm>
 
 // DateTime Includes
@@ -56,6 +64,56 @@ GetLayoutPrintingLog()
 #define PR_PL(_p1)
 #endif
 
+// Replays one recorded page into the real print draw target on the print
+// replay thread.  The page sequence frame polls IsDone() from
+// PrePrintNextPage and calls EndPage on the device context once the replay
+// has finished, so the device context is never touched off the main thread.
+class nsPrintPageReplayTask MOZ_FINAL : public nsRunnable
+{
+public:
+  nsPrintPageReplayTask(gfx::DrawEventRecorderMemory* aRecording,
+                        gfx::DrawTarget* aPrintTarget,
+                        nsITimerCallback* aCallback)
+    : mRecording(aRecording)
+    , mPrintTarget(aPrintTarget)
+    , mCallback(aCallback)
+    , mDone(false)
+    , mSucceeded(false)
+  {
+  }
+
+  NS_IMETHOD Run() MOZ_OVERRIDE
+  {
+    {
+      mozilla::layout::PrintTranslator translator(mPrintTarget);
+      mSucceeded = translator.TranslateRecording(mRecording->mMemoryStream);
+      mPrintTarget->Flush();
+    }
+    mDone = true;
+
+    // Poke the page print timer so the main thread notices the finished
+    // page right away rather than on the next watchdog tick.
+    if (mCallback) {
+      nsCOMPtr<nsIRunnable> notify =
+        NS_NewRunnableMethodWithArg<nsITimer*>(mCallback,
+                                               &nsITimerCallback::Notify,
+                                               nullptr);
+      NS_DispatchToMainThread(notify);
+    }
+    return NS_OK;
+  }
+
+  bool IsDone() const { return mDone; }
+  bool Succeeded() const { return mSucceeded; }
+
+private:
+  nsRefPtr<gfx::DrawEventRecorderMemory> mRecording;
+  mozilla::RefPtr<gfx::DrawTarget> mPrintTarget;
+  nsCOMPtr<nsITimerCallback> mCallback;
+  mozilla::Atomic<bool> mDone;
+  mozilla::Atomic<bool> mSucceeded;
+};
+
 nsSimplePageSequenceFrame*
 NS_NewSimplePageSequenceFrame(nsIPresShell* aPresShell, nsStyleContext* aContext)
 {
@@ -94,6 +152,16 @@ nsSimplePageSequenceFrame::~nsSimplePageSequenceFrame()
 {
   delete mPageData;
   ResetPrintCanvasList();
+
+  if (mPrintReplayThread) {
+    // An in-flight replay holds its own references to everything it needs,
+    // but the thread should not outlive the print session.  Spinning the
+    // event loop under a frame destructor is not safe, so hand the
+    // shutdown off to the main event loop.
+    nsCOMPtr<nsIRunnable> shutdown =
+      NS_NewRunnableMethod(mPrintReplayThread, &nsIThread::Shutdown);
+    NS_DispatchToMainThread(shutdown);
+  }
 }
 
 NS_QUERYFRAME_HEAD(nsSimplePageSequenceFrame)
@@ -588,6 +656,27 @@ nsSimplePageSequenceFrame::GetCurrentPageFrame()
 NS_IMETHODIMP
 nsSimplePageSequenceFrame::PrePrintNextPage(nsITimerCallback* aCallback, bool* aDone)
 {
+  mPagePrintCallback = aCallback;
+
+  // A previously recorded page may still be rasterizing on the print
+  // replay thread.  The device context is strictly serial, so the next
+  // page cannot begin until that page has been replayed and ended; report
+  // not-done so the page print timer polls us again.
+  if (mPendingPageReplay) {
+    if (!mPendingPageReplay->IsDone()) {
+      *aDone = false;
+      return NS_OK;
+    }
+    bool replayed = mPendingPageReplay->Succeeded();
+    mPendingPageReplay = nullptr;
+    PR_PL(("***************** End Page (replay complete) *****************\n"));
+    nsresult rv = PresContext()->DeviceContext()->EndPage();
+    if (!replayed || NS_FAILED(rv)) {
+      *aDone = true;
+      return NS_FAILED(rv) ? rv : NS_ERROR_FAILURE;
+    }
+  }
+
   nsIFrame* currentPage = GetCurrentPageFrame();
   if (!currentPage) {
     *aDone = true;
@@ -684,6 +773,91 @@ nsSimplePageSequenceFrame::ResetPrintCanvasList()
   return NS_OK;
 } 
 
+bool
+nsSimplePageSequenceFrame::TryOffloadPageRasterization(nsDeviceContext* aDC,
+                                                       nsIFrame* aPage)
+{
+  if (!Preferences::GetBool("print.rasterize_off_main_thread", false)) {
+    return false;
+  }
+
+  // Pages with mozPrintCallback canvases have already rendered against the
+  // real device surface in PrePrintNextPage, and the print engine ends the
+  // document right after the last page, so only offload interior pages of a
+  // plain sequential print run, where the next PrePrintNextPage call is
+  // guaranteed to happen and can wait for the replay to finish.
+  bool printEvenPages = true;
+  bool printOddPages = true;
+  mPageData->mPrintSettings->GetPrintOptions(nsIPrintSettings::kPrintEvenPages,
+                                             &printEvenPages);
+  mPageData->mPrintSettings->GetPrintOptions(nsIPrintSettings::kPrintOddPages,
+                                             &printOddPages);
+  if (mDoingPageRange || !printEvenPages || !printOddPages ||
+      mPageNum >= mTotalPages || mCurrentCanvasList.Length() != 0) {
+    return false;
+  }
+
+  if (!mPrintReplayThread &&
+      NS_FAILED(NS_NewNamedThread("PrintReplay",
+                                  getter_AddRefs(mPrintReplayThread)))) {
+    return false;
+  }
+
+  nsRefPtr<gfxContext> deviceCtx = aDC->CreateRenderingContext();
+  RefPtr<gfx::DrawTarget> printTarget = deviceCtx->GetDrawTarget();
+  if (!printTarget) {
+    return false;
+  }
+
+  // Record the page into an in-memory stream.  The recording draw target
+  // forwards to a draw target similar to the print target; for the vector
+  // print backends that similar target just buffers commands, so the
+  // forwarded drawing stays cheap and the expensive rasterization happens
+  // on the replay thread.
+  RefPtr<gfx::DrawTarget> similar =
+    printTarget->CreateSimilarDrawTarget(printTarget->GetSize(),
+                                         printTarget->GetFormat());
+  if (!similar) {
+    return false;
+  }
+
+  nsRefPtr<gfx::DrawEventRecorderMemory> recorder =
+    new gfx::DrawEventRecorderMemory();
+  {
+    RefPtr<gfx::DrawTarget> recordDT =
+      gfx::Factory::CreateRecordingDrawTarget(recorder, similar);
+    if (!recordDT) {
+      return false;
+    }
+    // Match the device rendering context setup: printing disables pixel
+    // snapping and pre-scales by the printing scale.
+    recordDT->AddUserData(&gfx::sDisablePixelSnapping, (void*)0x1, nullptr);
+
+    nsRefPtr<gfxContext> ctx = new gfxContext(recordDT);
+    ctx->SetMatrix(deviceCtx->CurrentMatrix());
+
+    nsRenderingContext renderingContext(ctx);
+    nsRect drawingRect(nsPoint(0, 0), aPage->GetSize());
+    nsRegion drawingRegion(drawingRect);
+    nsLayoutUtils::PaintFrame(&renderingContext, aPage,
+                              drawingRegion, NS_RGBA(0,0,0,0),
+                              nsLayoutUtils::PAINT_SYNC_DECODE_IMAGES);
+  }
+
+  // The recording draw target is gone, so the stream is complete.  Drop our
+  // references to the print target before the replay thread starts using
+  // it: Moz2D reference counts are not thread-safe, so the task must be the
+  // only thing touching them while it runs.  EndPage is deferred until
+  // PrePrintNextPage observes the finished replay.
+  nsRefPtr<nsPrintPageReplayTask> task =
+    new nsPrintPageReplayTask(recorder, printTarget, mPagePrintCallback);
+  deviceCtx = nullptr;
+  printTarget = nullptr;
+  mPendingPageReplay = task;
+  mPrintReplayThread->Dispatch(task, NS_DISPATCH_NORMAL);
+  return true;
+}
+
 NS_IMETHODIMP
 nsSimplePageSequenceFrame::PrintNextPage()
 {
@@ -750,13 +924,17 @@ nsSimplePageSequenceFrame::PrintNextPage()
 
       PR_PL(("SeqFr::PrintNextPage -> %p PageNo: %d", pf, mPageNum));
 
-      nsRenderingContext renderingContext(dc->CreateRenderingContext());
+      bool offloaded = mSelectionHeight < 0 &&
+                       TryOffloadPageRasterization(dc, currentPage);
+      if (!offloaded) {
+        nsRenderingContext renderingContext(dc->CreateRenderingContext());
 
-      nsRect drawingRect(nsPoint(0, 0), currentPage->GetSize());
-      nsRegion drawingRegion(drawingRect);
-      nsLayoutUtils::PaintFrame(&renderingContext, currentPage,
-                                drawingRegion, NS_RGBA(0,0,0,0),
-                                nsLayoutUtils::PAINT_SYNC_DECODE_IMAGES);
+        nsRect drawingRect(nsPoint(0, 0), currentPage->GetSize());
+        nsRegion drawingRegion(drawingRect);
+        nsLayoutUtils::PaintFrame(&renderingContext, currentPage,
+                                  drawingRegion, NS_RGBA(0,0,0,0),
+                                  nsLayoutUtils::PAINT_SYNC_DECODE_IMAGES);
+      }
 
       if (mSelectionHeight >= 0 && selectionY < mSelectionHeight) {
         selectionY += height;
@@ -781,9 +959,14 @@ nsSimplePageSequenceFrame::DoPageEnd()
 {
   nsresult rv = NS_OK;
   if (PresContext()->IsRootPaginatedDocument() && mPrintThisPage) {
-    PR_PL(("***************** End Page (DoPageEnd) *****************\n"));
-    rv = PresContext()->DeviceContext()->EndPage();
-    NS_ENSURE_SUCCESS(rv, rv);
+    if (mPendingPageReplay) {
+      // The page is still rasterizing on the print replay thread;
+      // PrePrintNextPage calls EndPage once the replay has finished.
+    } else {
+      PR_PL(("***************** End Page (DoPageEnd) *****************\n"));
+      rv = PresContext()->DeviceContext()->EndPage();
+      NS_ENSURE_SUCCESS(rv, rv);
+    }
   }
 
   ResetPrintCanvasList();
@@ -12,6 +12,9 @@
 #include "nsIPrintOptions.h"
 
 class nsIDateTimeFormat;
+class nsIThread;
+class nsDeviceContext;
+class nsPrintPageReplayTask;
 
 namespace mozilla {
 namespace dom {
@@ -139,6 +142,12 @@ protected:
   void DetermineWhetherToPrintPage();
   nsIFrame* GetCurrentPageFrame();
 
+  // Record the current page's drawing commands and hand them to the print
+  // replay thread for rasterization, so painting the page does not block
+  // the main thread.  Returns false if the page cannot be offloaded (the
+  // caller then paints synchronously as before).
+  bool TryOffloadPageRasterization(nsDeviceContext* aDC, nsIFrame* aPage);
+
   nsMargin mMargin;
 
   // I18N date formatter service which we'll want to cache locally.
@@ -169,6 +178,19 @@ protected:
   bool mCalledBeginPage;
 
   bool mCurrentCanvasListSetup;
+
+  // Off-main-thread page rasterization (see TryOffloadPageRasterization):
+  // the thread that replays recorded pages into the print target, and the
+  // replay currently in flight, if any.  While a replay is in flight the
+  // device context's EndPage is deferred until PrePrintNextPage sees the
+  // replay complete; the device context itself is only ever used on the
+  // main thread.
+  nsCOMPtr<nsIThread> mPrintReplayThread;
+  nsRefPtr<nsPrintPageReplayTask> mPendingPageReplay;
+
+  // The page print timer for the current page, used to poke the print
+  // engine promptly when an offloaded page finishes rasterizing.
+  nsCOMPtr<nsITimerCallback> mPagePrintCallback;
 };
 
 #endif /* nsSimplePageSequenceFrame_h___ */
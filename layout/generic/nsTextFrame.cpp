@@ -6608,13 +6608,98 @@ nsTextFrame::SetSelectedRange(uint32_t aStart, uint32_t aEnd, bool aSelected,
                                                    NS_FRAME_IS_DIRTY);
       }
     }
-    // Selection might change anything. Invalidate the overflow area.
-    f->InvalidateFrame();
+    // Selection might change anything. Invalidate the overflow area of
+    // the affected characters; while dragging a selection this limits
+    // repainting to the characters the endpoints moved across instead of
+    // repainting every touched frame in full.
+    f->InvalidateSelectedRange(aStart, aEnd);
 
     f = static_cast<nsTextFrame*>(f->GetNextContinuation());
   }
 }
 
+void
+nsTextFrame::InvalidateSelectedRange(uint32_t aStart, uint32_t aEnd)
+{
+  int32_t start = std::max(int32_t(aStart), GetContentOffset());
+  int32_t end = std::min(int32_t(aEnd), GetContentEnd());
+  if (start <= GetContentOffset() && end >= GetContentEnd()) {
+    // The whole frame is affected; this is the common case for frames in
+    // the middle of a selected range.
+    InvalidateFrame();
+    return;
+  }
+  if ((GetStateBits() & NS_FRAME_IS_BIDI) || (mState & NS_FRAME_IS_DIRTY)) {
+    // Content order doesn't map monotonically to visual order, or we
+    // can't measure yet.
+    InvalidateFrame();
+    return;
+  }
+
+  gfxSkipCharsIterator iter = EnsureTextRun(nsTextFrame::eInflated);
+  if (!mTextRun || mTextRun->IsRightToLeft() || mTextRun->IsVertical()) {
+    InvalidateFrame();
+    return;
+  }
+
+  PropertyProvider properties(this, iter, nsTextFrame::eInflated);
+  // Measure untrimmed, as GetPointFromOffset does, so a selection ending
+  // in trailing whitespace is covered.
+  properties.InitializeForDisplay(false);
+
+  int32_t trimmedOffset = properties.GetStart().GetOriginalOffset();
+  int32_t trimmedEnd = trimmedOffset + properties.GetOriginalLength();
+
+  nscoord startEdge = 0;
+  if (start > GetContentOffset()) {
+    int32_t offset = std::min(std::max(start, trimmedOffset), trimmedEnd);
+    iter.SetOriginalOffset(offset);
+    if (offset < trimmedEnd &&
+        !iter.IsOriginalCharSkipped() &&
+        !mTextRun->IsClusterStart(iter.GetSkippedOffset())) {
+      // Round down so a partially-covered cluster is fully invalidated.
+      FindClusterStart(mTextRun, trimmedOffset, &iter);
+    }
+    gfxFloat advance =
+      mTextRun->GetAdvanceWidth(properties.GetStart().GetSkippedOffset(),
+                                GetSkippedDistance(properties.GetStart(), iter),
+                                &properties);
+    startEdge = NSToCoordFloorClamped(advance);
+  }
+
+  nscoord endEdge = GetSize().width;
+  if (end < GetContentEnd()) {
+    int32_t offset = std::min(std::max(end, trimmedOffset), trimmedEnd);
+    iter.SetOriginalOffset(offset);
+    if (offset < trimmedEnd &&
+        !iter.IsOriginalCharSkipped() &&
+        !mTextRun->IsClusterStart(iter.GetSkippedOffset())) {
+      // Round up so a partially-covered cluster is fully invalidated.
+      FindClusterEnd(mTextRun, trimmedEnd, &iter);
+      iter.AdvanceOriginal(1);
+    }
+    gfxFloat advance =
+      mTextRun->GetAdvanceWidth(properties.GetStart().GetSkippedOffset(),
+                                GetSkippedDistance(properties.GetStart(), iter),
+                                &properties);
+    endEdge = NSToCoordCeilClamped(advance);
+  }
+
+  // Pad the inline edges by however far the frame's ink overflow extends
+  // past the frame box, so overhanging glyphs and shadows of the affected
+  // characters are covered too; use the full overflow extent in the block
+  // direction.
+  nsRect overflow = GetVisualOverflowRect();
+  nscoord left = startEdge + std::min(overflow.x, 0);
+  nscoord right = endEdge +
+    std::max(overflow.XMost() - GetSize().width, 0);
+  if (left >= right) {
+    return;
+  }
+  InvalidateFrameWithRect(nsRect(left, overflow.y,
+                                 right - left, overflow.height));
+}
+
 nsresult
 nsTextFrame::GetPointFromOffset(int32_t inOffset,
                                 nsPoint* outPoint)
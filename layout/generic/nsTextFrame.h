@@ -143,6 +143,15 @@ public:
   void SetSelectedRange(uint32_t aStart, uint32_t aEnd, bool aSelected,
                         SelectionType aType);
 
+  /**
+   * Invalidate the part of this frame covered by the given character
+   * range, padded by the frame's ink overflow in the inline direction so
+   * overhanging glyphs and shadows of the affected characters are covered.
+   * Falls back to InvalidateFrame() when the range covers the whole frame
+   * or can't be mapped to a rect cheaply (bidi, vertical runs).
+   */
+  void InvalidateSelectedRange(uint32_t aStart, uint32_t aEnd);
+
   virtual FrameSearchResult PeekOffsetNoAmount(bool aForward, int32_t* aOffset) MOZ_OVERRIDE;
   virtual FrameSearchResult PeekOffsetCharacter(bool aForward, int32_t* aOffset,
                                      bool aRespectClusters = true) MOZ_OVERRIDE;
@@ -0,0 +1,44 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "PrintTranslator.h"
+
+#include "mozilla/gfx/RecordingTypes.h"
+#include "nsAutoPtr.h"
+
+namespace mozilla {
+namespace layout {
+
+using namespace mozilla::gfx;
+
+PrintTranslator::PrintTranslator(DrawTarget* aBaseDT)
+  : mBaseDT(aBaseDT)
+{
+}
+
+bool
+PrintTranslator::TranslateRecording(std::istream& aRecording)
+{
+  int32_t eventType;
+  ReadElement(aRecording, eventType);
+  while (aRecording.good()) {
+    nsAutoPtr<RecordedEvent> recordedEvent(
+      RecordedEvent::LoadEventFromStream(aRecording,
+        static_cast<RecordedEvent::EventType>(eventType)));
+
+    // Make sure that the whole event was read from the stream successfully.
+    if (!recordedEvent || !aRecording.good()) {
+      return false;
+    }
+
+    recordedEvent->PlayEvent(this);
+    ReadElement(aRecording, eventType);
+  }
+
+  return true;
+}
+
+} // namespace layout
+} // namespace mozilla
@@ -0,0 +1,193 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_layout_PrintTranslator_h
+#define mozilla_layout_PrintTranslator_h
+
+#include <istream>
+
+#include "mozilla/gfx/2D.h"
+#include "mozilla/gfx/RecordedEvent.h"
+#include "nsRefPtrHashtable.h"
+
+namespace mozilla {
+namespace layout {
+
+using gfx::Translator;
+using gfx::ReferencePtr;
+using gfx::DrawTarget;
+using gfx::Path;
+using gfx::SourceSurface;
+using gfx::FilterNode;
+using gfx::GradientStops;
+using gfx::ScaledFont;
+using gfx::FontType;
+using gfx::BackendType;
+
+/**
+ * Plays a Moz2D recording of one printed page back into the real print
+ * draw target.  The recorded events reference resources by the pointer
+ * values they had while recording; each resource is recreated against the
+ * print target when its creation event is replayed and tracked in the
+ * tables below.
+ */
+class PrintTranslator MOZ_FINAL : public Translator
+{
+public:
+  explicit PrintTranslator(DrawTarget* aBaseDT);
+
+  /**
+   * Play back a full page recording.  Returns false if the recording was
+   * malformed.
+   */
+  bool TranslateRecording(std::istream& aRecording);
+
+  DrawTarget* LookupDrawTarget(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    DrawTarget* result = mDrawTargets.GetWeak(aRefPtr);
+    MOZ_ASSERT(result);
+    return result;
+  }
+
+  Path* LookupPath(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    Path* result = mPaths.GetWeak(aRefPtr);
+    MOZ_ASSERT(result);
+    return result;
+  }
+
+  SourceSurface* LookupSourceSurface(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    SourceSurface* result = mSourceSurfaces.GetWeak(aRefPtr);
+    MOZ_ASSERT(result);
+    return result;
+  }
+
+  FilterNode* LookupFilterNode(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    FilterNode* result = mFilterNodes.GetWeak(aRefPtr);
+    MOZ_ASSERT(result);
+    return result;
+  }
+
+  GradientStops* LookupGradientStops(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    GradientStops* result = mGradientStops.GetWeak(aRefPtr);
+    MOZ_ASSERT(result);
+    return result;
+  }
+
+  ScaledFont* LookupScaledFont(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    ScaledFont* result = mScaledFonts.GetWeak(aRefPtr);
+    MOZ_ASSERT(result);
+    return result;
+  }
+
+  void AddDrawTarget(ReferencePtr aRefPtr, DrawTarget* aDT) MOZ_OVERRIDE
+  {
+    // The first draw target created in a recording is the recording draw
+    // target for the page itself.  Map it to the real print target so the
+    // replayed commands end up on paper; the similar draw target that
+    // RecordedDrawTargetCreation made for us is simply discarded.
+    if (mDrawTargets.Count() == 0) {
+      mDrawTargets.Put(aRefPtr, mBaseDT);
+      return;
+    }
+    mDrawTargets.Put(aRefPtr, aDT);
+  }
+
+  void RemoveDrawTarget(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    mDrawTargets.Remove(aRefPtr);
+  }
+
+  void AddPath(ReferencePtr aRefPtr, Path* aPath) MOZ_OVERRIDE
+  {
+    mPaths.Put(aRefPtr, aPath);
+  }
+
+  void RemovePath(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    mPaths.Remove(aRefPtr);
+  }
+
+  void AddSourceSurface(ReferencePtr aRefPtr, SourceSurface* aSurface) MOZ_OVERRIDE
+  {
+    mSourceSurfaces.Put(aRefPtr, aSurface);
+  }
+
+  void RemoveSourceSurface(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    mSourceSurfaces.Remove(aRefPtr);
+  }
+
+  void AddFilterNode(ReferencePtr aRefPtr, FilterNode* aFilter) MOZ_OVERRIDE
+  {
+    mFilterNodes.Put(aRefPtr, aFilter);
+  }
+
+  void RemoveFilterNode(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    mFilterNodes.Remove(aRefPtr);
+  }
+
+  void AddGradientStops(ReferencePtr aRefPtr, GradientStops* aStops) MOZ_OVERRIDE
+  {
+    mGradientStops.Put(aRefPtr, aStops);
+  }
+
+  void RemoveGradientStops(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    mGradientStops.Remove(aRefPtr);
+  }
+
+  void AddScaledFont(ReferencePtr aRefPtr, ScaledFont* aScaledFont) MOZ_OVERRIDE
+  {
+    mScaledFonts.Put(aRefPtr, aScaledFont);
+  }
+
+  void RemoveScaledFont(ReferencePtr aRefPtr) MOZ_OVERRIDE
+  {
+    mScaledFonts.Remove(aRefPtr);
+  }
+
+  DrawTarget* GetReferenceDrawTarget() MOZ_OVERRIDE
+  {
+    return mBaseDT;
+  }
+
+  FontType GetDesiredFontType() MOZ_OVERRIDE
+  {
+    switch (mBaseDT->GetBackendType()) {
+      case BackendType::DIRECT2D:
+      case BackendType::DIRECT2D1_1:
+        return FontType::DWRITE;
+      case BackendType::COREGRAPHICS:
+      case BackendType::COREGRAPHICS_ACCELERATED:
+        return FontType::COREGRAPHICS;
+      case BackendType::SKIA:
+        return FontType::SKIA;
+      case BackendType::CAIRO:
+      default:
+        return FontType::CAIRO;
+    }
+  }
+
+private:
+  mozilla::RefPtr<DrawTarget> mBaseDT;
+
+  nsRefPtrHashtable<nsPtrHashKey<void>, DrawTarget> mDrawTargets;
+  nsRefPtrHashtable<nsPtrHashKey<void>, Path> mPaths;
+  nsRefPtrHashtable<nsPtrHashKey<void>, SourceSurface> mSourceSurfaces;
+  nsRefPtrHashtable<nsPtrHashKey<void>, FilterNode> mFilterNodes;
+  nsRefPtrHashtable<nsPtrHashKey<void>, GradientStops> mGradientStops;
+  nsRefPtrHashtable<nsPtrHashKey<void>, ScaledFont> mScaledFonts;
+};
+
+} // namespace layout
+} // namespace mozilla
+
+#endif // mozilla_layout_PrintTranslator_h
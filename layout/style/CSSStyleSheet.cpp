@@ -982,6 +982,7 @@ CSSStyleSheet::CSSStyleSheet(CORSMode aCORSMode, ReferrerPolicy aReferrerPolicy)
     mOwningNode(nullptr),
     mDisabled(false),
     mDirty(false),
+    mQuirksModeOnly(false),
     mScopeElement(nullptr),
     mRuleProcessors(nullptr)
 {
@@ -1000,6 +1001,7 @@ CSSStyleSheet::CSSStyleSheet(const CSSStyleSheet& aCopy,
     mOwningNode(aOwningNodeToUse),
     mDisabled(aCopy.mDisabled),
     mDirty(aCopy.mDirty),
+    mQuirksModeOnly(aCopy.mQuirksModeOnly),
     mScopeElement(nullptr),
     mInner(aCopy.mInner),
     mRuleProcessors(nullptr)
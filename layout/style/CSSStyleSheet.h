@@ -145,6 +145,13 @@ public:
   virtual nsIDocument* GetOwningDocument() const MOZ_OVERRIDE;  // may be null
   virtual void SetOwningDocument(nsIDocument* aDocument) MOZ_OVERRIDE;
 
+  // Mark this sheet as applying only in quirks mode documents.  Used for
+  // the UA quirk sheet, which is shared across documents and therefore
+  // cannot be enabled and disabled per document; nsCSSRuleProcessor
+  // instead skips it when building a standards mode rule cascade.
+  void SetQuirksModeOnly() { mQuirksModeOnly = true; }
+  bool QuirksModeOnly() const { return mQuirksModeOnly; }
+
   // Find the ID of the owner inner window.
   uint64_t FindOwningWindowInnerID() const;
 #ifdef DEBUG
@@ -361,7 +368,8 @@ protected:
   nsIDocument*          mDocument; // weak ref; parents maintain this for their children
   nsINode*              mOwningNode; // weak ref
   bool                  mDisabled;
-  bool                  mDirty; // has been modified 
+  bool                  mDirty; // has been modified
+  bool                  mQuirksModeOnly; // rules apply only in quirks mode
   nsRefPtr<dom::Element> mScopeElement;
 
   CSSStyleSheetInner*   mInner;
@@ -65,6 +65,27 @@ static bool gSupportVisitedPseudo = true;
 
 static nsTArray< nsCOMPtr<nsIAtom> >* sSystemMetrics = 0;
 
+// An entry in the cache of rule processors shared between documents,
+// keyed by (sheet identity list, sheet type).  See GetSharedRuleProcessor.
+struct SharedRuleProcessorEntry
+{
+  // Weak pointers, used only as an identity key; the processor holds
+  // strong references to the same sheets, so they stay alive at least
+  // as long as the entry does.
+  nsTArray<CSSStyleSheet*> mSheets;
+  uint8_t mSheetType;
+  nsRefPtr<nsCSSRuleProcessor> mProcessor;
+};
+
+// Most recently used first.  Lazily created; cleared at shutdown.
+static nsTArray<SharedRuleProcessorEntry>* gSharedRuleProcessors = nullptr;
+
+// The number of distinct (sheet list, type) combinations is small in
+// practice -- one or two per process plus a few unusual document types --
+// but cap the cache so that it can't grow without bound if we're ever
+// handed per-document sheets that will never match again.
+#define MAX_SHARED_RULE_PROCESSORS 16
+
 #ifdef XP_WIN
 uint8_t nsCSSRuleProcessor::sWinThemeId = LookAndFeel::eWindowsTheme_Generic;
 #endif
@@ -487,6 +508,9 @@ protected:
   EnumData* mEnumList;
   int32_t   mEnumListSize;
 
+  static void SiftDownEnumData(EnumData* aList, int32_t aCount,
+                               int32_t aIndex);
+
   bool mQuirksMode;
 
   inline EnumData ToEnumData(const RuleValueList& arr) {
@@ -770,6 +794,28 @@ void RuleHash::EnumerateAllRules(Element* aElement, ElementDependentRuleProcesso
       filter->AssertHasAllAncestors(aElement);
     }
 #endif
+    // When many lists are active (typically class-heavy content), the
+    // linear scan for the lowest rule index below costs O(lists) per
+    // rule.  Arrange the lists in a binary min-heap on their current
+    // rule index first, so that each step costs O(log lists) while
+    // still walking the rules in cascade order.
+    if (valueCount > MIN_ENUM_LIST_SIZE) {
+      for (int32_t index = valueCount / 2 - 1; index >= 0; --index) {
+        SiftDownEnumData(mEnumList, valueCount, index);
+      }
+      while (valueCount > 1) {
+        const RuleValue *cur = mEnumList[0].mCurValue;
+        ContentEnumFunc(*cur, cur->mSelector, aData, aNodeContext, filter);
+        cur++;
+        if (cur == mEnumList[0].mEnd) {
+          mEnumList[0] = mEnumList[--valueCount];
+        } else {
+          mEnumList[0].mCurValue = cur;
+        }
+        SiftDownEnumData(mEnumList, valueCount, 0);
+      }
+    }
+
     // Merge the lists while there are still multiple lists to merge.
     while (valueCount > 1) {
       int32_t valueIndex = 0;
@@ -800,6 +846,29 @@ void RuleHash::EnumerateAllRules(Element* aElement, ElementDependentRuleProcesso
   }
 }
 
+/* static */ void
+RuleHash::SiftDownEnumData(EnumData* aList, int32_t aCount, int32_t aIndex)
+{
+  EnumData data = aList[aIndex];
+  int32_t index = aIndex;
+  for (;;) {
+    int32_t child = 2 * index + 1;
+    if (child >= aCount) {
+      break;
+    }
+    if (child + 1 < aCount &&
+        aList[child + 1].mCurValue->mIndex < aList[child].mCurValue->mIndex) {
+      ++child;
+    }
+    if (aList[child].mCurValue->mIndex >= data.mCurValue->mIndex) {
+      break;
+    }
+    aList[index] = aList[child];
+    index = child;
+  }
+  aList[index] = data;
+}
+
 static size_t
 SizeOfRuleHashTableEntry(PLDHashEntryHdr* aHdr, MallocSizeOf aMallocSizeOf, void *)
 {
@@ -854,7 +923,7 @@ struct AtomSelectorEntry : public PLDHashEntryHdr {
   nsIAtom *mAtom;
   // Auto length 2, because a decent fraction of these arrays ends up
   // with 2 elements, and each entry is cheap.
-  nsAutoTArray<nsCSSSelector*, 2> mSelectors;
+  nsAutoTArray<nsCSSRuleProcessor::SelectorPair, 2> mSelectors;
 };
 
 static void
@@ -977,8 +1046,8 @@ struct RuleCascadeData {
   EventStates              mSelectorDocumentStates;
   PLDHashTable             mClassSelectors;
   PLDHashTable             mIdSelectors;
-  nsTArray<nsCSSSelector*> mPossiblyNegatedClassSelectors;
-  nsTArray<nsCSSSelector*> mPossiblyNegatedIDSelectors;
+  nsTArray<nsCSSRuleProcessor::SelectorPair> mPossiblyNegatedClassSelectors;
+  nsTArray<nsCSSRuleProcessor::SelectorPair> mPossiblyNegatedIDSelectors;
   PLDHashTable             mAttributeSelectors;
   PLDHashTable             mAnonBoxRules;
 #ifdef MOZ_XUL
@@ -996,7 +1065,8 @@ struct RuleCascadeData {
 
   // Looks up or creates the appropriate list in |mAttributeSelectors|.
   // Returns null only on allocation failure.
-  nsTArray<nsCSSSelector*>* AttributeListFor(nsIAtom* aAttribute);
+  nsTArray<nsCSSRuleProcessor::SelectorPair>*
+    AttributeListFor(nsIAtom* aAttribute);
 
   nsMediaQueryResultCacheKey mCacheKey;
   RuleCascadeData*  mNext; // for a different medium
@@ -1069,7 +1139,7 @@ RuleCascadeData::SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const
   return n;
 }
 
-nsTArray<nsCSSSelector*>*
+nsTArray<nsCSSRuleProcessor::SelectorPair>*
 RuleCascadeData::AttributeListFor(nsIAtom* aAttribute)
 {
   AtomSelectorEntry *entry =
@@ -1313,9 +1383,125 @@ nsCSSRuleProcessor::FreeSystemMetrics()
 /* static */ void
 nsCSSRuleProcessor::Shutdown()
 {
+  delete gSharedRuleProcessors;
+  gSharedRuleProcessors = nullptr;
   FreeSystemMetrics();
 }
 
+static bool RuleListIsShareable(css::GroupRule* aRule);
+
+static bool
+RuleIsShareable(css::Rule* aRule)
+{
+  switch (aRule->GetType()) {
+    case css::Rule::DOCUMENT_RULE:
+      // @-moz-document results depend on the document's URL, which isn't
+      // captured by the rule cascade's media query cache key, so a
+      // cascade built from this rule can't be used for other documents.
+      return false;
+    case css::Rule::MEDIA_RULE:
+    case css::Rule::SUPPORTS_RULE:
+      return RuleListIsShareable(static_cast<css::GroupRule*>(aRule));
+    default:
+      return true;
+  }
+}
+
+static bool
+RuleListIsShareable(css::GroupRule* aRule)
+{
+  for (int32_t i = 0, count = aRule->StyleRuleCount(); i < count; ++i) {
+    if (!RuleIsShareable(aRule->GetStyleRuleAt(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* static */ bool
+nsCSSRuleProcessor::SheetIsShareable(CSSStyleSheet* aSheet)
+{
+  if (!aSheet->IsComplete() || !aSheet->mInner) {
+    return false;
+  }
+
+  for (CSSStyleSheet* child = aSheet->mInner->mFirstChild; child;
+       child = child->mNext) {
+    if (!SheetIsShareable(child)) {
+      return false;
+    }
+  }
+
+  const nsCOMArray<css::Rule>& rules = aSheet->mInner->mOrderedRules;
+  for (int32_t i = 0, count = rules.Count(); i < count; ++i) {
+    if (!RuleIsShareable(rules.ObjectAt(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* static */ already_AddRefed<nsCSSRuleProcessor>
+nsCSSRuleProcessor::GetSharedRuleProcessor(const sheet_array_type& aSheets,
+                                           uint8_t aSheetType)
+{
+  MOZ_ASSERT(aSheetType == nsStyleSet::eAgentSheet ||
+             aSheetType == nsStyleSet::eUserSheet,
+             "only the agent and user levels have cross-document sheets");
+
+  if (!gSharedRuleProcessors) {
+    gSharedRuleProcessors = new nsTArray<SharedRuleProcessorEntry>();
+  }
+
+  for (uint32_t i = 0, len = gSharedRuleProcessors->Length(); i < len; ++i) {
+    SharedRuleProcessorEntry& entry = (*gSharedRuleProcessors)[i];
+    if (entry.mSheetType != aSheetType ||
+        entry.mSheets.Length() != aSheets.Length()) {
+      continue;
+    }
+    bool match = true;
+    for (uint32_t j = 0, count = aSheets.Length(); j < count; ++j) {
+      if (entry.mSheets[j] != aSheets[j]) {
+        match = false;
+        break;
+      }
+    }
+    if (match) {
+      nsRefPtr<nsCSSRuleProcessor> shared = entry.mProcessor;
+      // Keep the cache in most recently used order, so that if we ever
+      // have to evict we discard the entry least likely to match again.
+      if (i != 0) {
+        SharedRuleProcessorEntry moved = entry;
+        gSharedRuleProcessors->RemoveElementAt(i);
+        gSharedRuleProcessors->InsertElementAt(0, moved);
+      }
+      return shared.forget();
+    }
+  }
+
+  for (sheet_array_type::size_type i = 0; i < aSheets.Length(); ++i) {
+    if (!SheetIsShareable(aSheets[i])) {
+      return nullptr;
+    }
+  }
+
+  nsRefPtr<nsCSSRuleProcessor> processor =
+    new nsCSSRuleProcessor(aSheets, aSheetType, nullptr, nullptr);
+
+  if (gSharedRuleProcessors->Length() >= MAX_SHARED_RULE_PROCESSORS) {
+    gSharedRuleProcessors->RemoveElementAt(gSharedRuleProcessors->Length() - 1);
+  }
+  SharedRuleProcessorEntry* entry = gSharedRuleProcessors->InsertElementAt(0);
+  entry->mSheets.SetCapacity(aSheets.Length());
+  for (sheet_array_type::size_type i = 0; i < aSheets.Length(); ++i) {
+    entry->mSheets.AppendElement(aSheets[i]);
+  }
+  entry->mSheetType = aSheetType;
+  entry->mProcessor = processor;
+
+  return processor.forget();
+}
+
 /* static */ bool
 nsCSSRuleProcessor::HasSystemMetric(nsIAtom* aMetric)
 {
@@ -2793,8 +2979,42 @@ struct AttributeEnumData {
 };
 
 
+// Restyle hint for a selector containing the changed attribute, given the
+// combinator attaching it to the rest of the selector.  For descendant and
+// child combinators we can return eRestyle_SomeDescendants instead of
+// eRestyle_Subtree when we know the subject of the whole selector, since
+// only descendants matching that subject can change their matching state.
+static inline nsRestyleHint
+RestyleHintForSelectorWithAttributeChange(nsRestyleHint aCurrentHint,
+                                          nsCSSSelector* aSelector,
+                                          nsCSSSelector* aRightmostSelector)
+{
+  char16_t oper = aSelector->mOperator;
+
+  if (oper == char16_t('+') || oper == char16_t('~')) {
+    return eRestyle_LaterSiblings;
+  }
+
+  if (oper == char16_t(' ') || oper == char16_t('>')) {
+    // No point in recording selectors when we already know we must
+    // restyle the whole subtree.
+    if (aRightmostSelector && !(aCurrentHint & eRestyle_Subtree)) {
+      return eRestyle_SomeDescendants;
+    }
+    return eRestyle_Subtree;
+  }
+
+  if (oper != char16_t(0)) {
+    return eRestyle_Subtree;
+  }
+
+  return eRestyle_Self;
+}
+
 static void
-AttributeEnumFunc(nsCSSSelector* aSelector, AttributeEnumData* aData)
+AttributeEnumFunc(nsCSSSelector* aSelector,
+                  nsCSSSelector* aRightmostSelector,
+                  AttributeEnumData* aData)
 {
   AttributeRuleProcessorData *data = aData->data;
 
@@ -2805,28 +3025,41 @@ AttributeEnumFunc(nsCSSSelector* aSelector, AttributeEnumData* aData)
     return;
   }
 
-  nsRestyleHint possibleChange = RestyleHintForOp(aSelector->mOperator);
+  nsRestyleHint possibleChange =
+    RestyleHintForSelectorWithAttributeChange(aData->change,
+                                              aSelector, aRightmostSelector);
 
-  // If enumData->change already includes all the bits of possibleChange, don't
-  // bother calling SelectorMatches, since even if it returns false
-  // enumData->change won't change.
+  // If enumData->change already includes all the bits of possibleChange,
+  // don't bother calling SelectorMatches, since even if it returns false
+  // enumData->change won't change.  eRestyle_SomeDescendants is an
+  // exception: each match can contribute a new selector to
+  // mSelectorsForDescendants.
   NodeMatchContext nodeContext(EventStates(), false);
-  if ((possibleChange & ~(aData->change)) &&
+  if (((possibleChange & ~(aData->change)) ||
+       (possibleChange & eRestyle_SomeDescendants)) &&
       SelectorMatches(data->mElement, aSelector, nodeContext,
                       data->mTreeMatchContext, SelectorMatchesFlags::UNKNOWN) &&
       SelectorMatchesTree(data->mElement, aSelector->mNext,
                           data->mTreeMatchContext, false)) {
     aData->change = nsRestyleHint(aData->change | possibleChange);
+    if (possibleChange & eRestyle_SomeDescendants) {
+      nsTArray<nsCSSSelector*>& selectors =
+        data->mRestyleHintData.mSelectorsForDescendants;
+      if (!selectors.Contains(aRightmostSelector)) {
+        selectors.AppendElement(aRightmostSelector);
+      }
+    }
   }
 }
 
 static MOZ_ALWAYS_INLINE void
-EnumerateSelectors(nsTArray<nsCSSSelector*>& aSelectors, AttributeEnumData* aData)
+EnumerateSelectors(nsTArray<nsCSSRuleProcessor::SelectorPair>& aSelectors,
+                   AttributeEnumData* aData)
 {
-  nsCSSSelector **iter = aSelectors.Elements(),
-                **end = iter + aSelectors.Length();
+  nsCSSRuleProcessor::SelectorPair *iter = aSelectors.Elements(),
+                                   *end = iter + aSelectors.Length();
   for (; iter != end; ++iter) {
-    AttributeEnumFunc(*iter, aData);
+    AttributeEnumFunc(iter->mSelector, iter->mRightmostSelector, aData);
   }
 }
 
@@ -3104,7 +3337,10 @@ AddSelector(RuleCascadeData* aCascade,
             // The part between combinators at the top level of the selector
             nsCSSSelector* aSelectorInTopLevel,
             // The part we should look through (might be in :not or :-moz-any())
-            nsCSSSelector* aSelectorPart)
+            nsCSSSelector* aSelectorPart,
+            // The subject of the whole selector, or null if it is a
+            // pseudo-element selector
+            nsCSSSelector* aRightmostSelector)
 {
   // It's worth noting that this loop over negations isn't quite
   // optimal for two reasons.  One, we could add something to one of
@@ -3129,12 +3365,13 @@ AddSelector(RuleCascadeData* aCascade,
           break;
         }
         case nsCSSPseudoClasses::ePseudoClass_mozTableBorderNonzero: {
-          nsTArray<nsCSSSelector*> *array =
+          nsTArray<nsCSSRuleProcessor::SelectorPair> *array =
             aCascade->AttributeListFor(nsGkAtoms::border);
           if (!array) {
             return false;
           }
-          array->AppendElement(aSelectorInTopLevel);
+          array->AppendElement(nsCSSRuleProcessor::SelectorPair(
+                                 aSelectorInTopLevel, aRightmostSelector));
           break;
         }
         default: {
@@ -3160,11 +3397,15 @@ AddSelector(RuleCascadeData* aCascade,
                                                                curID->mAtom,
                                                                PL_DHASH_ADD));
         if (entry) {
-          entry->mSelectors.AppendElement(aSelectorInTopLevel);
+          entry->mSelectors.AppendElement(
+            nsCSSRuleProcessor::SelectorPair(aSelectorInTopLevel,
+                                             aRightmostSelector));
         }
       }
     } else if (negation->mIDList) {
-      aCascade->mPossiblyNegatedIDSelectors.AppendElement(aSelectorInTopLevel);
+      aCascade->mPossiblyNegatedIDSelectors.AppendElement(
+        nsCSSRuleProcessor::SelectorPair(aSelectorInTopLevel,
+                                         aRightmostSelector));
     }
 
     // Build mClassSelectors
@@ -3176,28 +3417,34 @@ AddSelector(RuleCascadeData* aCascade,
                                                                curClass->mAtom,
                                                                PL_DHASH_ADD));
         if (entry) {
-          entry->mSelectors.AppendElement(aSelectorInTopLevel);
+          entry->mSelectors.AppendElement(
+            nsCSSRuleProcessor::SelectorPair(aSelectorInTopLevel,
+                                             aRightmostSelector));
         }
       }
     } else if (negation->mClassList) {
-      aCascade->mPossiblyNegatedClassSelectors.AppendElement(aSelectorInTopLevel);
+      aCascade->mPossiblyNegatedClassSelectors.AppendElement(
+        nsCSSRuleProcessor::SelectorPair(aSelectorInTopLevel,
+                                         aRightmostSelector));
     }
 
     // Build mAttributeSelectors.
     for (nsAttrSelector *attr = negation->mAttrList; attr;
          attr = attr->mNext) {
-      nsTArray<nsCSSSelector*> *array =
+      nsTArray<nsCSSRuleProcessor::SelectorPair> *array =
         aCascade->AttributeListFor(attr->mCasedAttr);
       if (!array) {
         return false;
       }
-      array->AppendElement(aSelectorInTopLevel);
+      array->AppendElement(nsCSSRuleProcessor::SelectorPair(
+                             aSelectorInTopLevel, aRightmostSelector));
       if (attr->mLowercaseAttr != attr->mCasedAttr) {
         array = aCascade->AttributeListFor(attr->mLowercaseAttr);
         if (!array) {
           return false;
         }
-        array->AppendElement(aSelectorInTopLevel);
+        array->AppendElement(nsCSSRuleProcessor::SelectorPair(
+                               aSelectorInTopLevel, aRightmostSelector));
       }
     }
 
@@ -3207,7 +3454,8 @@ AddSelector(RuleCascadeData* aCascade,
       if (pseudoClass->mType == nsCSSPseudoClasses::ePseudoClass_any) {
         for (nsCSSSelectorList *l = pseudoClass->u.mSelectors; l; l = l->mNext) {
           nsCSSSelector *s = l->mSelectors;
-          if (!AddSelector(aCascade, aSelectorInTopLevel, s)) {
+          if (!AddSelector(aCascade, aSelectorInTopLevel, s,
+                           aRightmostSelector)) {
             return false;
           }
         }
@@ -3288,7 +3536,9 @@ AddRule(RuleSelectorPair* aRuleInfo, RuleCascadeData* aCascade)
         continue;
       }
     }
-    if (!AddSelector(cascade, selector, selector)) {
+    if (!AddSelector(cascade, selector, selector,
+                     aRuleInfo->mSelector->IsPseudoElement() ?
+                       nullptr : aRuleInfo->mSelector)) {
       return false;
     }
   }
@@ -3501,6 +3751,13 @@ CascadeRuleEnumFunc(css::Rule* aRule, void* aData)
 /* static */ bool
 nsCSSRuleProcessor::CascadeSheet(CSSStyleSheet* aSheet, CascadeEnumData* aData)
 {
+  if (aSheet->QuirksModeOnly() &&
+      aData->mPresContext->CompatibilityMode() != eCompatibility_NavQuirks) {
+    // The quirk sheet is shared between documents instead of being
+    // enabled and disabled per document, so skip it when building a
+    // standards mode cascade.
+    return true;
+  }
   if (aSheet->IsApplicable() &&
       aSheet->UseForPresentation(aData->mPresContext, aData->mCacheKey) &&
       aSheet->mInner) {
@@ -3556,12 +3813,17 @@ nsCSSRuleProcessor::GetRuleCascade(nsPresContext* aPresContext)
 
   // If anything changes about the presentation context, we will be
   // notified.  Otherwise, our cache is valid if mLastPresContext
-  // matches aPresContext.  (The only rule processors used for multiple
-  // pres contexts are for XBL.  These rule processors are probably less
-  // likely to have @media rules, and thus the cache is pretty likely to
-  // hit instantly even when we're switching between pres contexts.)
-
-  if (!mRuleCascades || aPresContext != mLastPresContext) {
+  // matches aPresContext.  (Rule processors used for multiple pres
+  // contexts -- XBL, and the shared agent and user level processors --
+  // are probably less likely to have @media rules, and thus the cache
+  // is pretty likely to hit instantly even when we're switching between
+  // pres contexts.)  The compatibility mode can change on a pres
+  // context without notification (see CompatibilityModeChanged), so
+  // check it explicitly.
+
+  if (!mRuleCascades || aPresContext != mLastPresContext ||
+      mRuleCascades->mQuirksMode !=
+        (eCompatibility_NavQuirks == aPresContext->CompatibilityMode())) {
     RefreshRuleCascade(aPresContext);
   }
   mLastPresContext = aPresContext;
@@ -3572,15 +3834,20 @@ nsCSSRuleProcessor::GetRuleCascade(nsPresContext* aPresContext)
 void
 nsCSSRuleProcessor::RefreshRuleCascade(nsPresContext* aPresContext)
 {
-  // Having RuleCascadeData objects be per-medium (over all variation
-  // caused by media queries, handled through mCacheKey) works for now
-  // since nsCSSRuleProcessor objects are per-document.  (For a given
-  // set of stylesheets they can vary based on medium (@media) or
-  // document (@-moz-document).)
+  // RuleCascadeData objects are per-medium (over all variation caused
+  // by media queries, handled through mCacheKey) and per-compatibility-
+  // mode.  That covers everything a cascade can vary on for the shared
+  // agent and user level processors, since sheets that use
+  // @-moz-document (whose results are per-document) are never given a
+  // shared processor; see SheetIsShareable.
+
+  bool quirksMode =
+    eCompatibility_NavQuirks == aPresContext->CompatibilityMode();
 
   for (RuleCascadeData **cascadep = &mRuleCascades, *cascade;
        (cascade = *cascadep); cascadep = &cascade->mNext) {
-    if (cascade->mCacheKey.Matches(aPresContext)) {
+    if (cascade->mQuirksMode == quirksMode &&
+        cascade->mCacheKey.Matches(aPresContext)) {
       // Ensure that the current one is always mRuleCascades.
       *cascadep = cascade->mNext;
       cascade->mNext = mRuleCascades;
@@ -3597,8 +3864,7 @@ nsCSSRuleProcessor::RefreshRuleCascade(nsPresContext* aPresContext)
 
   if (mSheets.Length() != 0) {
     nsAutoPtr<RuleCascadeData> newCascade(
-      new RuleCascadeData(aPresContext->Medium(),
-                          eCompatibility_NavQuirks == aPresContext->CompatibilityMode()));
+      new RuleCascadeData(aPresContext->Medium(), quirksMode));
     if (newCascade) {
       CascadeEnumData data(aPresContext, newCascade->mFontFaceRules,
                            newCascade->mKeyframesRules,
@@ -3687,6 +3953,20 @@ nsCSSRuleProcessor::SelectorListMatches(Element* aElement,
   return false;
 }
 
+/* static */ bool
+nsCSSRuleProcessor::RestrictedSelectorMatches(Element* aElement,
+                                              nsCSSSelector* aSelector,
+                                              TreeMatchContext& aTreeMatchContext)
+{
+  MOZ_ASSERT(!aSelector->IsPseudoElement(),
+             "should not have a pseudo-element selector as the subject "
+             "of an eRestyle_SomeDescendants hint");
+
+  NodeMatchContext nodeContext(EventStates(), false);
+  return SelectorMatches(aElement, aSelector, nodeContext, aTreeMatchContext,
+                         SelectorMatchesFlags::NONE);
+}
+
 // TreeMatchContext and AncestorFilter out of line methods
 void
 TreeMatchContext::InitAncestors(Element *aElement)
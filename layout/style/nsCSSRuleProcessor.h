@@ -70,6 +70,21 @@ public:
   static void FreeSystemMetrics();
   static bool HasSystemMetric(nsIAtom* aMetric);
 
+  /**
+   * Returns a rule processor that can be shared between documents whose
+   * style sets contain the given sheets, creating and caching one if
+   * needed.  This is only useful for the agent and user sheet levels,
+   * where the sheets themselves are shared objects, so that documents
+   * with identical sheet lists can share one set of rule cascades
+   * instead of each computing their own.  Returns null if one of the
+   * sheets is not safe to share (e.g. because it uses @-moz-document,
+   * whose results are per-document and not captured by the rule
+   * cascade's cache key).
+   */
+  static already_AddRefed<nsCSSRuleProcessor>
+    GetSharedRuleProcessor(const sheet_array_type& aSheets,
+                           uint8_t aSheetType);
+
   /*
    * Returns true if the given aElement matches one of the
    * selectors in aSelectorList.  Note that this method will assume
@@ -103,6 +118,17 @@ public:
    */
   static bool IsLink(mozilla::dom::Element* aElement);
 
+  /*
+   * Returns true if the given aElement matches aSelector, where aSelector
+   * must be a single compound selector with no combinators or
+   * pseudo-elements; its mNext (if any) is ignored.  Used to test
+   * elements against the subject selectors recorded for an
+   * eRestyle_SomeDescendants hint.
+   */
+  static bool RestrictedSelectorMatches(mozilla::dom::Element* aElement,
+                                        nsCSSSelector* aSelector,
+                                        TreeMatchContext& aTreeMatchContext);
+
   // nsIStyleRuleProcessor
   virtual void RulesMatching(ElementRuleProcessorData* aData) MOZ_OVERRIDE;
 
@@ -159,13 +185,6 @@ public:
    */
   mozilla::dom::Element* GetScopeElement() const { return mScopeElement; }
 
-#ifdef DEBUG
-  void AssertQuirksChangeOK() {
-    NS_ASSERTION(!mRuleCascades, "can't toggle quirks style sheet without "
-                                 "clearing rule cascades");
-  }
-#endif
-
 #ifdef XP_WIN
   // Cached theme identifier for the moz-windows-theme media query.
   static uint8_t GetWindowsThemeIdentifier();
@@ -184,6 +203,23 @@ public:
     nsCSSSelector* mSelector;
   };
 
+  // A selector we record in the rule cascade's attribute/ID/class maps,
+  // together with the subject (rightmost) selector of the selector it
+  // was found in.  mRightmostSelector is null when the subject is a
+  // pseudo-element selector, in which case descendant restyles cannot be
+  // restricted and eRestyle_Subtree must be used.
+  struct SelectorPair {
+    SelectorPair(nsCSSSelector* aSelector, nsCSSSelector* aRightmostSelector)
+      : mSelector(aSelector),
+        mRightmostSelector(aRightmostSelector)
+    {
+      MOZ_ASSERT(aSelector);
+    }
+
+    nsCSSSelector* mSelector;
+    nsCSSSelector* mRightmostSelector;
+  };
+
 protected:
   virtual ~nsCSSRuleProcessor();
 
@@ -191,6 +227,10 @@ private:
   static bool CascadeSheet(mozilla::CSSStyleSheet* aSheet,
                            CascadeEnumData* aData);
 
+  // Returns true if aSheet (and, recursively, the sheets it imports)
+  // can be used by a rule processor shared between documents.
+  static bool SheetIsShareable(mozilla::CSSStyleSheet* aSheet);
+
   RuleCascadeData* GetRuleCascade(nsPresContext* aPresContext);
   void RefreshRuleCascade(nsPresContext* aPresContext);
 
@@ -12,8 +12,14 @@
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/css/ErrorReporter.h"
 #include "mozilla/Likely.h"
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/SSE.h"
 #include <algorithm>
 
+#ifdef MOZILLA_PRESUME_SSE2
+#include <emmintrin.h>
+#endif
+
 /* Character class tables and related helper functions. */
 
 static const uint8_t IS_HEX_DIGIT  = 0x01;
@@ -209,6 +215,180 @@ HexDigitValue(int32_t ch)
   }
 }
 
+#ifdef MOZILLA_PRESUME_SSE2
+
+/**
+ * Vectorized helpers for the run-scanning loops below.  Each counts how
+ * many of the first |aLength| code units of |aText| provably belong to
+ * a fixed character class, examining eight code units per step.  They
+ * may undercount — each stops at its first partial vector — and the
+ * scalar loops at the call sites pick up exactly where they leave off,
+ * so the helpers only ever need to be a subset of the real class.
+ */
+
+/**
+ * Given the result of _mm_movemask_epi8 on a vector of eight 16-bit
+ * lane-wide booleans, return how many of the leading lanes are true.
+ */
+static inline uint32_t
+CountLeadingLanes(uint32_t aMask)
+{
+  return mozilla::CountTrailingZeroes32(~aMask & 0x1FFFF) / 2;
+}
+
+/**
+ * Count leading code units in the IS_IDCHAR open class, i.e.
+ * [0-9A-Za-z_-] and everything at or above U+0080.
+ */
+static uint32_t
+CountIdentChars(const char16_t* aText, uint32_t aLength)
+{
+  const __m128i kHighBits = _mm_set1_epi16(int16_t(0xFF80));
+  const __m128i kLowerBit = _mm_set1_epi16(0x0020);
+  const __m128i kBelowA   = _mm_set1_epi16('a' - 1);
+  const __m128i kAboveZ   = _mm_set1_epi16('z' + 1);
+  const __m128i kBelow0   = _mm_set1_epi16('0' - 1);
+  const __m128i kAbove9   = _mm_set1_epi16('9' + 1);
+  const __m128i kDash     = _mm_set1_epi16('-');
+  const __m128i kUnder    = _mm_set1_epi16('_');
+  const __m128i kZero     = _mm_setzero_si128();
+
+  uint32_t count = 0;
+  while (aLength - count >= 8) {
+    __m128i c =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aText + count));
+    __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(c, kHighBits), kZero);
+    __m128i lower = _mm_or_si128(c, kLowerBit);
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi16(lower, kBelowA),
+                                   _mm_cmplt_epi16(lower, kAboveZ));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi16(c, kBelow0),
+                                  _mm_cmplt_epi16(c, kAbove9));
+    __m128i inClass = _mm_or_si128(_mm_or_si128(letter, digit),
+                                   _mm_or_si128(_mm_cmpeq_epi16(c, kDash),
+                                                _mm_cmpeq_epi16(c, kUnder)));
+    // Everything at or above U+0080 is in the open class.
+    inClass = _mm_or_si128(inClass,
+                           _mm_andnot_si128(ascii,
+                                            _mm_cmpeq_epi16(kZero, kZero)));
+    uint32_t mask = _mm_movemask_epi8(inClass);
+    if (mask != 0xFFFF) {
+      return count + CountLeadingLanes(mask);
+    }
+    count += 8;
+  }
+  return count;
+}
+
+/**
+ * Count leading code units in the IS_STRING open class: everything
+ * except NUL, LF, FF, CR, both quote characters, and backslash.
+ */
+static uint32_t
+CountStringChars(const char16_t* aText, uint32_t aLength)
+{
+  const __m128i kZero  = _mm_setzero_si128();
+  const __m128i kLF    = _mm_set1_epi16('\n');
+  const __m128i kFF    = _mm_set1_epi16('\f');
+  const __m128i kCR    = _mm_set1_epi16('\r');
+  const __m128i kDQ    = _mm_set1_epi16('"');
+  const __m128i kSQ    = _mm_set1_epi16('\'');
+  const __m128i kBS    = _mm_set1_epi16('\\');
+
+  uint32_t count = 0;
+  while (aLength - count >= 8) {
+    __m128i c =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aText + count));
+    __m128i stop = _mm_or_si128(_mm_cmpeq_epi16(c, kZero),
+                                _mm_cmpeq_epi16(c, kBS));
+    stop = _mm_or_si128(stop, _mm_or_si128(_mm_cmpeq_epi16(c, kLF),
+                                           _mm_cmpeq_epi16(c, kFF)));
+    stop = _mm_or_si128(stop, _mm_or_si128(_mm_cmpeq_epi16(c, kCR),
+                                           _mm_cmpeq_epi16(c, kDQ)));
+    stop = _mm_or_si128(stop, _mm_cmpeq_epi16(c, kSQ));
+    uint32_t mask = _mm_movemask_epi8(stop);
+    if (mask != 0) {
+      return count + CountLeadingLanes(~mask & 0xFFFF);
+    }
+    count += 8;
+  }
+  return count;
+}
+
+/**
+ * Count leading code units in the IS_URL_CHAR open class: printable
+ * ASCII except the quotes, parentheses and backslash, plus everything
+ * at or above U+0080.
+ */
+static uint32_t
+CountURLChars(const char16_t* aText, uint32_t aLength)
+{
+  const __m128i kHighBits = _mm_set1_epi16(int16_t(0xFF80));
+  const __m128i kBelowBang  = _mm_set1_epi16('!' - 1);
+  const __m128i kAboveTilde = _mm_set1_epi16('~' + 1);
+  const __m128i kDQ    = _mm_set1_epi16('"');
+  const __m128i kSQ    = _mm_set1_epi16('\'');
+  const __m128i kLP    = _mm_set1_epi16('(');
+  const __m128i kRP    = _mm_set1_epi16(')');
+  const __m128i kBS    = _mm_set1_epi16('\\');
+  const __m128i kZero  = _mm_setzero_si128();
+
+  uint32_t count = 0;
+  while (aLength - count >= 8) {
+    __m128i c =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aText + count));
+    __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(c, kHighBits), kZero);
+    __m128i printable = _mm_and_si128(_mm_cmpgt_epi16(c, kBelowBang),
+                                      _mm_cmplt_epi16(c, kAboveTilde));
+    __m128i stop = _mm_or_si128(_mm_cmpeq_epi16(c, kDQ),
+                                _mm_cmpeq_epi16(c, kSQ));
+    stop = _mm_or_si128(stop, _mm_or_si128(_mm_cmpeq_epi16(c, kLP),
+                                           _mm_cmpeq_epi16(c, kRP)));
+    stop = _mm_or_si128(stop, _mm_cmpeq_epi16(c, kBS));
+    __m128i inClass = _mm_andnot_si128(stop, printable);
+    inClass = _mm_or_si128(inClass,
+                           _mm_andnot_si128(ascii,
+                                            _mm_cmpeq_epi16(kZero, kZero)));
+    uint32_t mask = _mm_movemask_epi8(inClass);
+    if (mask != 0xFFFF) {
+      return count + CountLeadingLanes(mask);
+    }
+    count += 8;
+  }
+  return count;
+}
+
+/**
+ * Count leading code units that are ordinary comment payload, i.e.
+ * anything but '*' and the vertical whitespace characters that need
+ * line accounting.
+ */
+static uint32_t
+CountPlainCommentChars(const char16_t* aText, uint32_t aLength)
+{
+  const __m128i kStar = _mm_set1_epi16('*');
+  const __m128i kLF   = _mm_set1_epi16('\n');
+  const __m128i kFF   = _mm_set1_epi16('\f');
+  const __m128i kCR   = _mm_set1_epi16('\r');
+
+  uint32_t count = 0;
+  while (aLength - count >= 8) {
+    __m128i c =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aText + count));
+    __m128i stop = _mm_or_si128(_mm_cmpeq_epi16(c, kStar),
+                                _mm_cmpeq_epi16(c, kLF));
+    stop = _mm_or_si128(stop, _mm_or_si128(_mm_cmpeq_epi16(c, kFF),
+                                           _mm_cmpeq_epi16(c, kCR)));
+    uint32_t mask = _mm_movemask_epi8(stop);
+    if (mask != 0) {
+      return count + CountLeadingLanes(~mask & 0xFFFF);
+    }
+    count += 8;
+  }
+  return count;
+}
+
+#endif /* MOZILLA_PRESUME_SSE2 */
+
 /**
  * If 'ch' can be the first character of a two-character match operator
  * token, return the token type code for that token, otherwise return
@@ -550,6 +730,14 @@ nsCSSScanner::SkipComment()
   MOZ_ASSERT(Peek() == '/' && Peek(1) == '*', "should not have been called");
   Advance(2);
   for (;;) {
+#ifdef MOZILLA_PRESUME_SSE2
+    // Burn through runs of ordinary comment payload eight code units at
+    // a time; the per-character logic below only has to look at '*',
+    // vertical whitespace, and EOF.
+    if (mOffset < mCount) {
+      Advance(CountPlainCommentChars(mBuffer + mOffset, mCount - mOffset));
+    }
+#endif
     int32_t ch = Peek();
     if (ch < 0) {
       mReporter->ReportUnexpectedEOF("PECommentEOF");
@@ -691,6 +879,17 @@ nsCSSScanner::GatherText(uint8_t aClass, nsString& aText)
   for (;;) {
     // Consume runs of unescaped characters in one go.
     uint32_t n = mOffset;
+#ifdef MOZILLA_PRESUME_SSE2
+    // The vectorized helpers may stop short of the end of the run; the
+    // scalar loop below finishes it off.
+    if (aClass == IS_IDCHAR) {
+      n += CountIdentChars(mBuffer + n, mCount - n);
+    } else if (aClass == IS_STRING) {
+      n += CountStringChars(mBuffer + n, mCount - n);
+    } else {
+      n += CountURLChars(mBuffer + n, mCount - n);
+    }
+#endif
     while (n < mCount && IsOpenCharClass(mBuffer[n], aClass)) {
       n++;
     }
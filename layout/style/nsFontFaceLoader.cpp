@@ -23,6 +23,8 @@
 
 #include "mozilla/gfx/2D.h"
 
+#include <algorithm>
+
 using namespace mozilla;
 
 #ifdef PR_LOGGING
@@ -70,6 +72,7 @@ nsFontFaceLoader::StartedLoading(nsIStreamLoader* aStreamLoader)
 {
   int32_t loadTimeout =
     Preferences::GetInt("gfx.downloadable_fonts.fallback_delay", 3000);
+  mStartTime = mozilla::TimeStamp::Now();
   if (loadTimeout > 0) {
     mLoadTimer = do_CreateInstance("@mozilla.org/timer;1");
     if (mLoadTimer) {
@@ -97,8 +100,12 @@ nsFontFaceLoader::LoadTimerCallback(nsITimer* aTimer, void* aClosure)
   gfxUserFontEntry* ufe = loader->mUserFontEntry.get();
   bool updateUserFontSet = true;
 
-  // If the entry is loading, check whether it's >75% done; if so,
-  // we allow another timeout period before showing a fallback font.
+  // If the entry is loading, use the throughput observed so far to predict
+  // when the remaining data will arrive.  If that's soon, allow one brief
+  // extension sized to the prediction rather than swapping in a fallback
+  // font just before the real glyphs become usable.  A download that has
+  // stalled, or that is so slow the prediction exceeds another timeout
+  // period, falls back right away.
   if (ufe->mFontDataLoadingState == gfxUserFontEntry::LOADING_STARTED) {
     int64_t contentLength;
     uint32_t numBytesRead;
@@ -106,20 +113,28 @@ nsFontFaceLoader::LoadTimerCallback(nsITimer* aTimer, void* aClosure)
         contentLength > 0 &&
         contentLength < UINT32_MAX &&
         NS_SUCCEEDED(loader->mStreamLoader->GetNumBytesRead(&numBytesRead)) &&
-        numBytesRead > 3 * (uint32_t(contentLength) >> 2))
+        numBytesRead > 0 &&
+        numBytesRead < uint32_t(contentLength))
     {
-      // More than 3/4 the data has been downloaded, so allow 50% extra
-      // time and hope the remainder will arrive before the additional
-      // time expires.
-      ufe->mFontDataLoadingState = gfxUserFontEntry::LOADING_ALMOST_DONE;
       uint32_t delay;
       loader->mLoadTimer->GetDelay(&delay);
-      loader->mLoadTimer->InitWithFuncCallback(LoadTimerCallback,
-                                               static_cast<void*>(loader),
-                                               delay >> 1,
-                                               nsITimer::TYPE_ONE_SHOT);
-      updateUserFontSet = false;
-      LOG(("fontdownloader (%p) 75%% done, resetting timer\n", loader));
+      double elapsedMs =
+        (mozilla::TimeStamp::Now() - loader->mStartTime).ToMilliseconds();
+      double predictedRemainingMs = elapsedMs *
+        double(uint32_t(contentLength) - numBytesRead) / double(numBytesRead);
+      if (predictedRemainingMs <= double(delay)) {
+        ufe->mFontDataLoadingState = gfxUserFontEntry::LOADING_ALMOST_DONE;
+        uint32_t extension = uint32_t(
+          std::min(std::max(predictedRemainingMs * 1.25, 50.0),
+                   double(delay)));
+        loader->mLoadTimer->InitWithFuncCallback(LoadTimerCallback,
+                                                 static_cast<void*>(loader),
+                                                 extension,
+                                                 nsITimer::TYPE_ONE_SHOT);
+        updateUserFontSet = false;
+        LOG(("fontdownloader (%p) predicted %f ms remaining, "
+             "resetting timer\n", loader, predictedRemainingMs));
+      }
     }
   }
 
@@ -10,6 +10,7 @@
 #define nsFontFaceLoader_h_
 
 #include "mozilla/Attributes.h"
+#include "mozilla/TimeStamp.h"
 #include "nsCOMPtr.h"
 #include "nsIStreamLoader.h"
 #include "nsIChannel.h"
@@ -59,6 +60,7 @@ private:
   nsRefPtr<mozilla::dom::FontFaceSet> mFontFaceSet;
   nsCOMPtr<nsIChannel>    mChannel;
   nsCOMPtr<nsITimer>      mLoadTimer;
+  mozilla::TimeStamp      mStartTime;
 
   nsIStreamLoader*        mStreamLoader;
 };
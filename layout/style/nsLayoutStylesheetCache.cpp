@@ -262,6 +262,12 @@ nsLayoutStylesheetCache::nsLayoutStylesheetCache()
                mMinimalXULSheet, true);
   LoadSheetURL("resource://gre-resources/quirk.css",
                mQuirkSheet, true);
+  if (mQuirkSheet) {
+    // The quirk sheet is shared across documents rather than cloned and
+    // toggled per document; nsCSSRuleProcessor skips it when building a
+    // standards mode rule cascade.
+    mQuirkSheet->SetQuirksModeOnly();
+  }
   LoadSheetURL("resource://gre/res/svg.css",
                mSVGSheet, true);
   LoadSheetURL("chrome://global/content/xul.css",
@@ -576,18 +576,23 @@ struct MOZ_STACK_CLASS AttributeRuleProcessorData :
                              nsIAtom* aAttribute,
                              int32_t aModType,
                              bool aAttrHasChanged,
-                             TreeMatchContext& aTreeMatchContext)
+                             TreeMatchContext& aTreeMatchContext,
+                             mozilla::RestyleHintData& aRestyleHintData)
     : ElementDependentRuleProcessorData(aPresContext, aElement, nullptr,
                                         aTreeMatchContext),
       mAttribute(aAttribute),
       mModType(aModType),
-      mAttrHasChanged(aAttrHasChanged)
+      mAttrHasChanged(aAttrHasChanged),
+      mRestyleHintData(aRestyleHintData)
   {
     NS_PRECONDITION(!aTreeMatchContext.mForStyling, "Not styling here!");
   }
   nsIAtom* mAttribute; // |HasAttributeDependentStyle| for which attribute?
   int32_t mModType;    // The type of modification (see nsIDOMMutationEvent).
   bool mAttrHasChanged; // Whether the attribute has already changed.
+  // Out-parameter for additional restyle data, such as the selectors
+  // accompanying an eRestyle_SomeDescendants hint.
+  mozilla::RestyleHintData& mRestyleHintData;
 };
 
 #endif /* !defined(nsRuleProcessorData_h_) */
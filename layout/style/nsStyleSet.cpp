@@ -260,16 +260,6 @@ nsStyleSet::EndReconstruct()
   GCRuleTrees();
 }
 
-void
-nsStyleSet::SetQuirkStyleSheet(nsIStyleSheet* aQuirkStyleSheet)
-{
-  NS_ASSERTION(aQuirkStyleSheet, "Must have quirk sheet if this is called");
-  NS_ASSERTION(!mQuirkStyleSheet, "Multiple calls to SetQuirkStyleSheet?");
-  NS_ASSERTION(mSheets[eAgentSheet].IndexOf(aQuirkStyleSheet) != -1,
-               "Quirk style sheet not one of our agent sheets?");
-  mQuirkStyleSheet = aQuirkStyleSheet;
-}
-
 typedef nsDataHashtable<nsPtrHashKey<nsINode>, uint32_t> ScopeDepthCache;
 
 // Returns the depth of a style scope element, with 1 being the depth of
@@ -478,10 +468,22 @@ nsStyleSet::GatherRuleProcessors(sheetType aType)
           NS_ASSERTION(cssSheet, "not a CSS sheet");
           cssSheets.AppendElement(cssSheet);
         }
-        mRuleProcessors[aType] =
-          new nsCSSRuleProcessor(cssSheets, uint8_t(aType), nullptr,
-                                 static_cast<nsCSSRuleProcessor*>(
-                                   oldRuleProcessor.get()));
+        if (aType == eAgentSheet || aType == eUserSheet) {
+          // The sheets at these levels are shared between documents, so
+          // documents with the same sheet list can share one rule
+          // processor (and its rule cascades) instead of each computing
+          // their own.
+          nsRefPtr<nsCSSRuleProcessor> shared =
+            nsCSSRuleProcessor::GetSharedRuleProcessor(cssSheets,
+                                                       uint8_t(aType));
+          mRuleProcessors[aType] = shared;
+        }
+        if (!mRuleProcessors[aType]) {
+          mRuleProcessors[aType] =
+            new nsCSSRuleProcessor(cssSheets, uint8_t(aType), nullptr,
+                                   static_cast<nsCSSRuleProcessor*>(
+                                     oldRuleProcessor.get()));
+        }
       } break;
 
       default:
@@ -680,35 +682,6 @@ nsStyleSet::EndUpdate()
   return NS_OK;
 }
 
-void
-nsStyleSet::EnableQuirkStyleSheet(bool aEnable)
-{
-  if (!mQuirkStyleSheet) {
-    // SVG-as-an-image doesn't load this sheet
-    return;
-  }
-#ifdef DEBUG
-  bool oldEnabled;
-  {
-    nsCOMPtr<nsIDOMCSSStyleSheet> domSheet =
-      do_QueryInterface(mQuirkStyleSheet);
-    domSheet->GetDisabled(&oldEnabled);
-    oldEnabled = !oldEnabled;
-  }
-#endif
-  mQuirkStyleSheet->SetEnabled(aEnable);
-#ifdef DEBUG
-  // This should always be OK, since SetEnabled should call
-  // ClearRuleCascades.
-  // Note that we can hit this codepath multiple times when document.open()
-  // (potentially implied) happens multiple times.
-  if (mRuleProcessors[eAgentSheet] && aEnable != oldEnabled) {
-    static_cast<nsCSSRuleProcessor*>(static_cast<nsIStyleRuleProcessor*>(
-      mRuleProcessors[eAgentSheet]))->AssertQuirksChangeOK();
-  }
-#endif
-}
-
 template<class T>
 static bool
 EnumRulesMatching(nsIStyleRuleProcessor* aProcessor, void* aData)
@@ -2086,6 +2059,15 @@ nsStyleSet::NotifyStyleContextDestroyed(nsPresContext* aPresContext,
   }
 }
 
+void
+nsStyleSet::TrimRuleTrees()
+{
+  if (mInShutdown || mInReconstruct)
+    return;
+
+  GCRuleTrees();
+}
+
 void
 nsStyleSet::GCRuleTrees()
 {
@@ -2340,9 +2322,11 @@ nsStyleSet::HasStateDependentStyle(nsPresContext* aPresContext,
 struct MOZ_STACK_CLASS AttributeData : public AttributeRuleProcessorData {
   AttributeData(nsPresContext* aPresContext,
                 Element* aElement, nsIAtom* aAttribute, int32_t aModType,
-                bool aAttrHasChanged, TreeMatchContext& aTreeMatchContext)
+                bool aAttrHasChanged, TreeMatchContext& aTreeMatchContext,
+                RestyleHintData& aRestyleHintData)
     : AttributeRuleProcessorData(aPresContext, aElement, aAttribute, aModType,
-                                 aAttrHasChanged, aTreeMatchContext),
+                                 aAttrHasChanged, aTreeMatchContext,
+                                 aRestyleHintData),
       mHint(nsRestyleHint(0))
   {}
   nsRestyleHint   mHint;
@@ -2363,13 +2347,15 @@ nsStyleSet::HasAttributeDependentStyle(nsPresContext* aPresContext,
                                        Element*       aElement,
                                        nsIAtom*       aAttribute,
                                        int32_t        aModType,
-                                       bool           aAttrHasChanged)
+                                       bool           aAttrHasChanged,
+                                       RestyleHintData& aRestyleHintDataResult)
 {
   TreeMatchContext treeContext(false, nsRuleWalker::eLinksVisitedOrUnvisited,
                                aElement->OwnerDoc());
   InitStyleScopes(treeContext, aElement);
   AttributeData data(aPresContext, aElement, aAttribute,
-                     aModType, aAttrHasChanged, treeContext);
+                     aModType, aAttrHasChanged, treeContext,
+                     aRestyleHintDataResult);
   WalkRuleProcessors(SheetHasAttributeStyle, &data, false);
   return data.mHint;
 }
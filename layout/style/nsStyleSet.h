@@ -93,9 +93,6 @@ class nsStyleSet
 
   nsRuleNode* GetRuleTree() { return mRuleTree; }
 
-  // enable / disable the Quirk style sheet
-  void EnableQuirkStyleSheet(bool aEnable);
-
   // get a style context for a non-pseudo frame.
   already_AddRefed<nsStyleContext>
   ResolveStyleFor(mozilla::dom::Element* aElement,
@@ -227,6 +224,10 @@ class nsStyleSet
   void NotifyStyleContextDestroyed(nsPresContext* aPresContext,
                                    nsStyleContext* aStyleContext);
 
+  // Eagerly sweep unused rule nodes instead of waiting for the
+  // destruction-count threshold, e.g. when compacting a hidden tab.
+  void TrimRuleTrees();
+
   // Get a new style context that lives in a different parent
   // The new context will be the same as the old if the new parent is the
   // same as the old parent.
@@ -259,12 +260,17 @@ class nsStyleSet
                                        mozilla::dom::Element* aPseudoElement,
                                        mozilla::EventStates aStateMask);
 
-  // Test if style is dependent on the presence of an attribute.
-  nsRestyleHint HasAttributeDependentStyle(nsPresContext* aPresContext,
-                                           mozilla::dom::Element* aElement,
-                                           nsIAtom*       aAttribute,
-                                           int32_t        aModType,
-                                           bool           aAttrHasChanged);
+  // Test if style is dependent on the presence of an attribute.  Any
+  // selectors returned in aRestyleHintDataResult (for an
+  // eRestyle_SomeDescendants hint) are only valid until the next rule
+  // cascade rebuild.
+  nsRestyleHint HasAttributeDependentStyle(
+      nsPresContext* aPresContext,
+      mozilla::dom::Element* aElement,
+      nsIAtom*       aAttribute,
+      int32_t        aModType,
+      bool           aAttrHasChanged,
+      mozilla::RestyleHintData& aRestyleHintDataResult);
 
   /*
    * Do any processing that needs to happen as a result of a change in
@@ -340,11 +346,6 @@ class nsStyleSet
     return mInReconstruct;
   }
 
-  // Let the style set know that a particular sheet is the quirks sheet.  This
-  // sheet must already have been added to the UA sheets.  The pointer must not
-  // be null.  This should only be called once for a given style set.
-  void SetQuirkStyleSheet(nsIStyleSheet* aQuirkStyleSheet);
-
   // Return whether the rule tree has cached data such that we need to
   // do dynamic change handling for changes that change the results of
   // media queries or require rebuilding all style data.
@@ -469,9 +470,6 @@ class nsStyleSet
   // Rule processors for HTML5 scoped style sheets, one per scope.
   nsTArray<nsCOMPtr<nsIStyleRuleProcessor> > mScopedDocSheetRuleProcessors;
 
-  // cached instance for enabling/disabling
-  nsCOMPtr<nsIStyleSheet> mQuirkStyleSheet;
-
   nsRefPtr<nsBindingManager> mBindingManager;
 
   nsRuleNode* mRuleTree; // This is the root of our rule tree.  It is a
@@ -274,7 +274,7 @@ BasicTableLayoutStrategy::ComputeColumnIntrinsicISizes(nsRenderingContext* aRend
     nsTableFrame *tableFrame = mTableFrame;
     nsTableCellMap *cellMap = tableFrame->GetCellMap();
 
-    mozilla::AutoStackArena arena;
+    mozilla::ArenaScope arena;
     SpanningCellSorter spanningCells;
 
     // Loop over the columns to consider the columns and cells *without*
@@ -64,7 +64,7 @@ SpanningCellSorter::AddCell(int32_t aColSpan, int32_t aRow, int32_t aCol)
     NS_ASSERTION(mState == ADDING, "cannot call AddCell after GetNext");
     NS_ASSERTION(aColSpan >= ARRAY_BASE, "cannot add cells with colspan<2");
 
-    Item *i = (Item*) mozilla::AutoStackArena::Allocate(sizeof(Item));
+    Item *i = (Item*) mozilla::ArenaScope::Allocate(sizeof(Item));
     NS_ENSURE_TRUE(i != nullptr, false);
 
     i->row = aRow;
@@ -13,7 +13,7 @@
 
 #include "pldhash.h"
 #include "nsDebug.h"
-#include "StackArena.h"
+#include "mozilla/ArenaScope.h"
 
 class nsIPresShell;
 
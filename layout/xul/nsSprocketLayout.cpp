@@ -18,7 +18,7 @@
 #include "nsIPresShell.h"
 #include "nsContainerFrame.h"
 #include "nsBoxFrame.h"
-#include "StackArena.h"
+#include "mozilla/ArenaScope.h"
 #include "mozilla/Likely.h"
 #include <algorithm>
 
@@ -183,7 +183,7 @@ nsSprocketLayout::Layout(nsIFrame* aBox, nsBoxLayoutState& aState)
   }
 
   nsBoxLayoutState::AutoReflowDepth depth(aState);
-  mozilla::AutoStackArena arena;
+  mozilla::ArenaScope arena;
 
   // ----- figure out our size ----------
   const nsSize originalSize = aBox->GetSize();
@@ -1621,7 +1621,7 @@ nsBoxSize::nsBoxSize()
 void* 
 nsBoxSize::operator new(size_t sz, nsBoxLayoutState& aState) CPP_THROW_NEW
 {
-  return mozilla::AutoStackArena::Allocate(sz);
+  return mozilla::ArenaScope::Allocate(sz);
 }
 
 
@@ -1634,7 +1634,7 @@ nsBoxSize::operator delete(void* aPtr, size_t sz)
 void* 
 nsComputedBoxSize::operator new(size_t sz, nsBoxLayoutState& aState) CPP_THROW_NEW
 {
-   return mozilla::AutoStackArena::Allocate(sz);
+   return mozilla::ArenaScope::Allocate(sz);
 }
 
 void 
@@ -93,6 +93,26 @@ CancelImageRequest(const nsAString& aKey,
   return PL_DHASH_NEXT;
 }
 
+// Cap on the number of cell texts we'll cache; pathological trees shouldn't
+// pin arbitrary amounts of text.
+static const uint32_t kMaxCellTextCacheEntries = 1024;
+
+struct CellTextRowRange
+{
+  int32_t mStart, mEnd;
+};
+
+// Enumeration function that removes cached cell text entries for rows in
+// the given inclusive range.
+static PLDHashOperator
+RemoveCellTextForRow(const uint64_t& aKey, nsString& aText, void* aData)
+{
+  CellTextRowRange* range = static_cast<CellTextRowRange*>(aData);
+  int32_t row = int32_t(aKey >> 32);
+  return row >= range->mStart && row <= range->mEnd ? PL_DHASH_REMOVE
+                                                    : PL_DHASH_NEXT;
+}
+
 //
 // NS_NewTreeFrame
 //
@@ -632,11 +652,48 @@ nsTreeBodyFrame::Invalidate()
   if (mUpdateBatchNest)
     return NS_OK;
 
+  // The view is telling us anything may have changed.
+  InvalidateCachedCellTexts();
+
   InvalidateFrame();
 
   return NS_OK;
 }
 
+void
+nsTreeBodyFrame::GetCachedCellText(int32_t aRowIndex, nsTreeColumn* aColumn,
+                                   nsAutoString& aText)
+{
+  uint64_t key = (uint64_t(uint32_t(aRowIndex)) << 32) |
+                 uint32_t(aColumn->GetIndex());
+  nsString cached;
+  if (mCellTextCache.Get(key, &cached)) {
+    aText = cached;
+    return;
+  }
+
+  mView->GetCellText(aRowIndex, aColumn, aText);
+  // We're going to paint this text so we need to ensure bidi is enabled if
+  // necessary
+  CheckTextForBidi(aText);
+
+  if (mCellTextCache.Count() >= kMaxCellTextCacheEntries)
+    mCellTextCache.Clear();
+  mCellTextCache.Put(key, nsString(aText));
+}
+
+void
+nsTreeBodyFrame::InvalidateCachedCellTexts(int32_t aStartRow, int32_t aEndRow)
+{
+  if (aStartRow < 0) {
+    mCellTextCache.Clear();
+    return;
+  }
+
+  CellTextRowRange range = { aStartRow, aEndRow };
+  mCellTextCache.Enumerate(RemoveCellTextForRow, &range);
+}
+
 nsresult
 nsTreeBodyFrame::InvalidateColumn(nsITreeColumn* aCol)
 {
@@ -647,6 +704,9 @@ nsTreeBodyFrame::InvalidateColumn(nsITreeColumn* aCol)
   if (!col)
     return NS_ERROR_INVALID_ARG;
 
+  // The column may have cached text for any row, visible or not.
+  InvalidateCachedCellTexts();
+
 #ifdef ACCESSIBILITY
   if (nsIPresShell::IsAccessibilityActive())
     FireInvalidateEvent(-1, -1, aCol, aCol);
@@ -669,6 +729,9 @@ nsTreeBodyFrame::InvalidateRow(int32_t aIndex)
   if (mUpdateBatchNest)
     return NS_OK;
 
+  // Drop the row's cached cell texts even if it is scrolled out of view.
+  InvalidateCachedCellTexts(aIndex, aIndex);
+
 #ifdef ACCESSIBILITY
   if (nsIPresShell::IsAccessibilityActive())
     FireInvalidateEvent(aIndex, aIndex, nullptr, nullptr);
@@ -690,6 +753,8 @@ nsTreeBodyFrame::InvalidateCell(int32_t aIndex, nsITreeColumn* aCol)
   if (mUpdateBatchNest)
     return NS_OK;
 
+  InvalidateCachedCellTexts(aIndex, aIndex);
+
 #ifdef ACCESSIBILITY
   if (nsIPresShell::IsAccessibilityActive())
     FireInvalidateEvent(aIndex, aIndex, aCol, aCol);
@@ -723,6 +788,10 @@ nsTreeBodyFrame::InvalidateRange(int32_t aStart, int32_t aEnd)
   if (aStart == aEnd)
     return InvalidateRow(aStart);
 
+  // Drop cached cell texts for the whole range, including any part of it
+  // that is scrolled out of view.
+  InvalidateCachedCellTexts(aStart, aEnd);
+
   int32_t last = LastVisibleRow();
   if (aStart > aEnd || aEnd < mTopRowIndex || aStart > last)
     return NS_OK;
@@ -760,6 +829,8 @@ nsTreeBodyFrame::InvalidateColumnRange(int32_t aStart, int32_t aEnd, nsITreeColu
   if (aStart == aEnd)
     return InvalidateCell(aStart, col);
 
+  InvalidateCachedCellTexts(aStart, aEnd);
+
   int32_t last = LastVisibleRow();
   if (aStart > aEnd || aEnd < mTopRowIndex || aStart > last)
     return NS_OK;
@@ -1231,12 +1302,9 @@ nsTreeBodyFrame::GetCoordsForCellItem(int32_t aRow, nsITreeColumn* aCol, const n
     if (!isRTL)
       cellX += imageSize.width;
     
-    // Cell Text 
+    // Cell Text
     nsAutoString cellText;
-    mView->GetCellText(aRow, currCol, cellText);
-    // We're going to measure this text so we need to ensure bidi is enabled if
-    // necessary
-    CheckTextForBidi(cellText);
+    GetCachedCellText(aRow, currCol, cellText);
 
     // Create a scratch rect to represent the text rectangle, with the current 
     // X and Y coords, and a guess at the width and height. The width is the 
@@ -1836,6 +1904,10 @@ nsTreeBodyFrame::RowCountChanged(int32_t aIndex, int32_t aCount)
   if (mUpdateBatchNest)
     return NS_OK;
 
+  // Rows at or below the change got renumbered, so cached cell texts keyed
+  // by row index are stale.
+  InvalidateCachedCellTexts();
+
   mRowCount += aCount;
 #ifdef DEBUG
   int32_t rowCount = mRowCount;
@@ -3562,12 +3634,11 @@ nsTreeBodyFrame::PaintText(int32_t              aRowIndex,
 
   bool isRTL = StyleVisibility()->mDirection == NS_STYLE_DIRECTION_RTL;
 
-  // Now obtain the text for our cell.
+  // Now obtain the text for our cell.  This consults the cell text cache,
+  // so scroll repaints don't have to go back to the view (which may be
+  // implemented in script) for rows that merely moved.
   nsAutoString text;
-  mView->GetCellText(aRowIndex, aColumn, text);
-  // We're going to paint this text so we need to ensure bidi is enabled if
-  // necessary
-  CheckTextForBidi(text);
+  GetCachedCellText(aRowIndex, aColumn, text);
 
   if (text.Length() == 0)
     return; // Don't paint an empty string. XXX What about background/borders? Still paint?
@@ -4129,7 +4200,10 @@ nsTreeBodyFrame::ScrollInternal(const ScrollParts& aParts, int32_t aRow)
     return NS_OK;
   }
   mTopRowIndex = aRow;
-  Invalidate();
+  // Only the rows' positions changed; the cell text cache is keyed by
+  // absolute row index, so bypass Invalidate() to keep it warm.
+  if (!mUpdateBatchNest)
+    InvalidateFrame();
   PostScrollEvent();
   return NS_OK;
 }
@@ -4152,7 +4226,9 @@ nsTreeBodyFrame::ScrollHorzInternal(const ScrollParts& aParts, int32_t aPosition
 
   mHorzPosition = aPosition;
 
-  Invalidate();
+  // As above, a horizontal scroll doesn't change any cell text.
+  if (!mUpdateBatchNest)
+    InvalidateFrame();
 
   // Update the column scroll view
   nsWeakFrame weakFrame(this);
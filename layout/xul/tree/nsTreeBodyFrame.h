@@ -300,6 +300,15 @@ protected:
                          nsFontMetrics& aFontMetrics,
                          nsRect& aTextRect);
 
+  // Fetch the text for a cell from the view, consulting and filling the
+  // cell text cache.  The returned text has already been checked for bidi.
+  void GetCachedCellText(int32_t aRowIndex, nsTreeColumn* aColumn,
+                         nsAutoString& aText);
+
+  // Drop cached cell texts for the given inclusive row range, or for the
+  // whole tree when no range is given.
+  void InvalidateCachedCellTexts(int32_t aStartRow = -1, int32_t aEndRow = -1);
+
   // A helper used when hit testing.
   nsIAtom* GetItemWithinCellAt(nscoord aX, const nsRect& aCellRect,
                                int32_t aRowIndex, nsTreeColumn* aColumn);
@@ -573,6 +582,14 @@ protected: // Data Members
   // It maps directly to an imgIRequest.
   nsDataHashtable<nsStringHashKey, nsTreeImageCacheEntry> mImageCache;
 
+  // A cache of cell text fetched from the view, keyed by absolute row index
+  // and column index.  Asking the view for cell text can cross into script,
+  // so repainting every visible cell on each scroll step is expensive.
+  // Since scrolling doesn't renumber rows, entries stay valid across scroll
+  // steps and only newly exposed rows need a view round trip.  The cache is
+  // dropped whenever the view reports a change.
+  nsDataHashtable<nsUint64HashKey, nsString> mCellTextCache;
+
   // A scratch array used when looking up cached style contexts.
   AtomArray mScratchArray;
 
@@ -574,6 +574,7 @@
 #define png_have_hwcap                            MOZ_PNG_have_hwcap
 #define png_init_filter_functions                 MOZ_PNG_init_filt_func
 #define png_init_filter_functions_neon            MOZ_PNG_init_filt_func_neon
+#define png_init_filter_functions_sse2            MOZ_PNG_init_filt_func_sse2
 #define png_init_filter_heuristics                MOZ_PNG_init_filt_heur
 #define png_init_palette_transformations          MOZ_PNG_init_palette_transf
 #define png_init_rgb_transformations              MOZ_PNG_init_rgb_transf
@@ -588,13 +589,19 @@
 #define png_read_filter_row_avg                   MOZ_PNG_read_filt_row_a
 #define png_read_filter_row_avg3_neon             MOZ_PNG_read_filt_row_a3_neon
 #define png_read_filter_row_avg4_neon             MOZ_PNG_read_filt_row_a4_neon
+#define png_read_filter_row_avg3_sse2             MOZ_PNG_read_filt_row_a3_sse2
+#define png_read_filter_row_avg4_sse2             MOZ_PNG_read_filt_row_a4_sse2
 #define png_read_filter_row_paeth_1byte_pixel     MOZ_PNG_read_filt_row_p_1b_px
 #define png_read_filter_row_paeth_multibyte_pixel MOZ_PNG_read_filt_row_p_mb_px
 #define png_read_filter_row_paeth3_neon           MOZ_PNG_read_filt_row_p3_neon
 #define png_read_filter_row_paeth4_neon           MOZ_PNG_read_filt_row_p4_neon
+#define png_read_filter_row_paeth3_sse2           MOZ_PNG_read_filt_row_p3_sse2
+#define png_read_filter_row_paeth4_sse2           MOZ_PNG_read_filt_row_p4_sse2
 #define png_read_filter_row_sub                   MOZ_PNG_read_filt_row_s
 #define png_read_filter_row_sub3_neon             MOZ_PNG_read_filt_row_s3_neon
 #define png_read_filter_row_sub4_neon             MOZ_PNG_read_filt_row_s4_neon
+#define png_read_filter_row_sub3_sse2             MOZ_PNG_read_filt_row_s3_sse2
+#define png_read_filter_row_sub4_sse2             MOZ_PNG_read_filt_row_s4_sse2
 #define png_read_filter_row_up                    MOZ_PNG_read_filt_row_up
 #define png_read_filter_row_up_neon               MOZ_PNG_read_filt_row_up_neon
 #define png_reciprocal                            MOZ_PNG_reciprocal
@@ -55,8 +55,12 @@ MALLOC_DECL(malloc_good_size, size_t, size_t)
 #  endif
 #  if MALLOC_FUNCS & MALLOC_FUNCS_JEMALLOC
 MALLOC_DECL(jemalloc_stats, void, jemalloc_stats_t *)
+MALLOC_DECL(jemalloc_partition_stats, void, jemalloc_partition_t,
+            jemalloc_partition_stats_t *)
 MALLOC_DECL(jemalloc_purge_freed_pages, void, void)
 MALLOC_DECL(jemalloc_free_dirty_pages, void, void)
+MALLOC_DECL(moz_arena_malloc, void *, jemalloc_partition_t, size_t)
+MALLOC_DECL(moz_arena_calloc, void *, jemalloc_partition_t, size_t, size_t)
 #  endif
 #endif /* MALLOC_DECL */
 
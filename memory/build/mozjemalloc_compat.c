@@ -13,9 +13,14 @@
 #include "mozilla/Types.h"
 
 #include <stdbool.h>
+#include <string.h>
 
 #if defined(MOZ_NATIVE_JEMALLOC)
 
+MOZ_IMPORT_API void *
+je_(malloc)(size_t size);
+MOZ_IMPORT_API void *
+je_(calloc)(size_t num, size_t size);
 MOZ_IMPORT_API int
 je_(mallctl)(const char*, void*, size_t*, void*, size_t);
 MOZ_IMPORT_API int
@@ -168,6 +173,28 @@ jemalloc_stats_impl(jemalloc_stats_t *stats)
   stats->waste -= stats->bin_unused;
 }
 
+MOZ_JEMALLOC_API void
+jemalloc_partition_stats_impl(jemalloc_partition_t partition,
+                              jemalloc_partition_stats_t *pstats)
+{
+  /* jemalloc3 builds don't implement partitioned arenas; all counters
+   * stay zero. */
+  memset(pstats, 0, sizeof(*pstats));
+}
+
+MOZ_JEMALLOC_API void *
+moz_arena_malloc_impl(jemalloc_partition_t partition, size_t size)
+{
+  /* No partitioned arenas with jemalloc3; fall back to the shared ones. */
+  return je_(malloc)(size);
+}
+
+MOZ_JEMALLOC_API void *
+moz_arena_calloc_impl(jemalloc_partition_t partition, size_t num, size_t size)
+{
+  return je_(calloc)(num, size);
+}
+
 MOZ_JEMALLOC_API void
 jemalloc_purge_freed_pages_impl()
 {
@@ -10,8 +10,11 @@
  * necessary:
  *   - malloc_good_size (used to be called je_malloc_usable_in_advance)
  *   - jemalloc_stats
+ *   - jemalloc_partition_stats
  *   - jemalloc_purge_freed_pages
  *   - jemalloc_free_dirty_pages
+ *   - moz_arena_malloc
+ *   - moz_arena_calloc
  */
 
 #ifndef MOZ_MEMORY
@@ -51,6 +54,31 @@ static inline size_t _malloc_good_size(size_t size) {
 
 MOZ_JEMALLOC_API void jemalloc_stats(jemalloc_stats_t *stats);
 
+/*
+ * Allocate memory from the dedicated arena for the given partition, so that
+ * allocations with similar lifetimes and owners (image buffers, DOM data,
+ * networking buffers) don't interleave with unrelated allocations and
+ * fragment the shared arenas.  The returned memory is released with plain
+ * free(); realloc() also works, but may move the allocation to a shared
+ * arena, so callers that reallocate frequently should do so through
+ * moz_arena_malloc/memcpy/free instead.
+ *
+ * With jemalloc3 these fall back to the shared arenas; the partition is then
+ * only advisory.
+ */
+MOZ_JEMALLOC_API void *moz_arena_malloc(jemalloc_partition_t partition,
+                                        size_t size);
+MOZ_JEMALLOC_API void *moz_arena_calloc(jemalloc_partition_t partition,
+                                        size_t num, size_t size);
+
+/*
+ * Fill *pstats with the memory statistics of the given partition's arena.
+ * All counters are zero when the partition hasn't allocated anything yet, or
+ * when partitioned arenas aren't implemented (jemalloc3).
+ */
+MOZ_JEMALLOC_API void jemalloc_partition_stats(jemalloc_partition_t partition,
+                                               jemalloc_partition_stats_t *pstats);
+
 /*
  * On some operating systems (Mac), we use madvise(MADV_FREE) to hand pages
  * back to the operating system.  On Mac, the operating system doesn't take
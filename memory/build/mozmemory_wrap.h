@@ -213,7 +213,10 @@
 
 /* Jemalloc specific function */
 #define jemalloc_stats_impl              mozmem_jemalloc_impl(jemalloc_stats)
+#define jemalloc_partition_stats_impl    mozmem_jemalloc_impl(jemalloc_partition_stats)
 #define jemalloc_purge_freed_pages_impl  mozmem_jemalloc_impl(jemalloc_purge_freed_pages)
 #define jemalloc_free_dirty_pages_impl   mozmem_jemalloc_impl(jemalloc_free_dirty_pages)
+#define moz_arena_malloc_impl            mozmem_jemalloc_impl(moz_arena_malloc)
+#define moz_arena_calloc_impl            mozmem_jemalloc_impl(moz_arena_calloc)
 
 #endif /* mozmemory_wrap_h */
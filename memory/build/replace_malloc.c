@@ -254,6 +254,38 @@ jemalloc_stats_impl(jemalloc_stats_t *stats)
     replace_jemalloc_stats(stats);
 }
 
+void
+jemalloc_partition_stats_impl(jemalloc_partition_t partition,
+                              jemalloc_partition_stats_t *pstats)
+{
+  if (MOZ_UNLIKELY(!replace_malloc_initialized))
+    init();
+  if (MOZ_LIKELY(!replace_jemalloc_partition_stats))
+    je_jemalloc_partition_stats(partition, pstats);
+  else
+    replace_jemalloc_partition_stats(partition, pstats);
+}
+
+void*
+moz_arena_malloc_impl(jemalloc_partition_t partition, size_t size)
+{
+  if (MOZ_UNLIKELY(!replace_malloc_initialized))
+    init();
+  if (MOZ_LIKELY(!replace_moz_arena_malloc))
+    return je_moz_arena_malloc(partition, size);
+  return replace_moz_arena_malloc(partition, size);
+}
+
+void*
+moz_arena_calloc_impl(jemalloc_partition_t partition, size_t num, size_t size)
+{
+  if (MOZ_UNLIKELY(!replace_malloc_initialized))
+    init();
+  if (MOZ_LIKELY(!replace_moz_arena_calloc))
+    return je_moz_arena_calloc(partition, num, size);
+  return replace_moz_arena_calloc(partition, num, size);
+}
+
 void
 jemalloc_purge_freed_pages_impl()
 {
@@ -1284,6 +1284,14 @@ static malloc_spinlock_t arenas_lock; /* Protects arenas initialization. */
 static pthread_mutex_t arenas_lock; /* Protects arenas initialization. */
 #endif
 
+/*
+ * Dedicated arenas backing the moz_arena_malloc() partitions.  These are
+ * never returned by choose_arena(), so only allocations made through the
+ * partition entry points land in them.  Created lazily on first use;
+ * initialization is protected by arenas_lock.
+ */
+static arena_t		*partition_arenas[JEMALLOC_PARTITION_COUNT];
+
 #ifndef NO_TLS
 /*
  * Map of pthread_self() --> arenas[???], used for selecting an arena to use
@@ -1432,6 +1440,7 @@ static bool	arena_ralloc_large(void *ptr, size_t size, size_t oldsize);
 static void	*arena_ralloc(void *ptr, size_t size, size_t oldsize);
 static bool	arena_new(arena_t *arena);
 static arena_t	*arenas_extend(unsigned ind);
+static arena_t	*partition_arena_get(jemalloc_partition_t partition);
 static void	*huge_malloc(size_t size, bool zero);
 static void	*huge_palloc(size_t size, size_t alignment, bool zero);
 static void	*huge_ralloc(void *ptr, size_t size, size_t oldsize);
@@ -4309,6 +4318,19 @@ icalloc(size_t size)
 		return (huge_malloc(size, true));
 }
 
+static inline void *
+ipartalloc(jemalloc_partition_t partition, size_t size, bool zero)
+{
+
+	assert(size != 0);
+
+	if (size <= arena_maxclass) {
+		return (arena_malloc(partition_arena_get(partition), size,
+		    zero));
+	} else
+		return (huge_malloc(size, zero));
+}
+
 /* Only handles large allocations that require more than page alignment. */
 static void *
 arena_palloc(arena_t *arena, size_t alignment, size_t size, size_t alloc_size)
@@ -5042,6 +5064,46 @@ arenas_extend(unsigned ind)
 	return (arenas[0]);
 }
 
+/*
+ * Return the dedicated arena for the given partition, creating it on first
+ * use.  Unlike arenas_extend(), the new arena is not inserted into the
+ * arenas array, so choose_arena() never hands it out for ordinary
+ * allocations.
+ */
+static arena_t *
+partition_arena_get(jemalloc_partition_t partition)
+{
+	arena_t *ret;
+
+	assert(partition < JEMALLOC_PARTITION_COUNT);
+
+	malloc_spin_lock(&arenas_lock);
+	ret = partition_arenas[partition];
+	if (ret == NULL) {
+		/* Allocate enough space for trailing bins. */
+		ret = (arena_t *)base_alloc(sizeof(arena_t)
+		    + (sizeof(arena_bin_t) * (ntbins + nqbins + nsbins - 1)));
+		if (ret != NULL && arena_new(ret) == false)
+			partition_arenas[partition] = ret;
+		else {
+			/*
+			 * OOM.  Punt by using arenas[0], as arenas_extend()
+			 * does; the partition loses its isolation but the
+			 * allocation still succeeds.
+			 */
+			_malloc_message(_getprogname(),
+			    ": (malloc) Error initializing partition arena\n",
+			    "", "");
+			if (opt_abort)
+				abort();
+			ret = arenas[0];
+		}
+	}
+	malloc_spin_unlock(&arenas_lock);
+
+	return (ret);
+}
+
 /*
  * End arena.
  */
@@ -6469,6 +6531,113 @@ free_impl(void *ptr)
  * Begin non-standard functions.
  */
 
+/*
+ * Partitioned variants of malloc(3) and calloc(3).  The returned memory is
+ * served from the partition's dedicated arena, so it does not share runs or
+ * chunks with ordinary allocations; free(3) and realloc(3) work on it as
+ * usual, since the owning arena is recovered from the chunk header.
+ */
+MOZ_JEMALLOC_API void *
+moz_arena_malloc_impl(jemalloc_partition_t partition, size_t size)
+{
+	void *ret;
+
+	DARWIN_ONLY(return (szone->malloc)(szone, size));
+
+	if (malloc_init() || partition >= JEMALLOC_PARTITION_COUNT) {
+		ret = NULL;
+		goto RETURN;
+	}
+
+	if (size == 0) {
+#ifdef MALLOC_SYSV
+		if (opt_sysv == false)
+#endif
+			size = 1;
+#ifdef MALLOC_SYSV
+		else {
+			ret = NULL;
+			goto RETURN;
+		}
+#endif
+	}
+
+	ret = ipartalloc(partition, size, false);
+
+RETURN:
+	if (ret == NULL) {
+#ifdef MALLOC_XMALLOC
+		if (opt_xmalloc) {
+			_malloc_message(_getprogname(),
+			    ": (malloc) Error in moz_arena_malloc(): "
+			    "out of memory\n", "", "");
+			abort();
+		}
+#endif
+		errno = ENOMEM;
+	}
+
+	UTRACE(0, size, ret);
+	return (ret);
+}
+
+MOZ_JEMALLOC_API void *
+moz_arena_calloc_impl(jemalloc_partition_t partition, size_t num, size_t size)
+{
+	void *ret;
+	size_t num_size;
+
+	DARWIN_ONLY(return (szone->calloc)(szone, num, size));
+
+	if (malloc_init() || partition >= JEMALLOC_PARTITION_COUNT) {
+		num_size = 0;
+		ret = NULL;
+		goto RETURN;
+	}
+
+	num_size = num * size;
+	if (num_size == 0) {
+#ifdef MALLOC_SYSV
+		if ((opt_sysv == false) && ((num == 0) || (size == 0)))
+#endif
+			num_size = 1;
+#ifdef MALLOC_SYSV
+		else {
+			ret = NULL;
+			goto RETURN;
+		}
+#endif
+	/*
+	 * Try to avoid division here.  We know that it isn't possible to
+	 * overflow during multiplication if neither operand uses any of the
+	 * most significant half of the bits in a size_t.
+	 */
+	} else if (((num | size) & (SIZE_T_MAX << (sizeof(size_t) << 2)))
+	    && (num_size / size != num)) {
+		/* size_t overflow. */
+		ret = NULL;
+		goto RETURN;
+	}
+
+	ret = ipartalloc(partition, num_size, true);
+
+RETURN:
+	if (ret == NULL) {
+#ifdef MALLOC_XMALLOC
+		if (opt_xmalloc) {
+			_malloc_message(_getprogname(),
+			    ": (malloc) Error in moz_arena_calloc(): "
+			    "out of memory\n", "", "");
+			abort();
+		}
+#endif
+		errno = ENOMEM;
+	}
+
+	UTRACE(0, num_size, ret);
+	return (ret);
+}
+
 /* This was added by Mozilla for use by SQLite. */
 #if defined(MOZ_MEMORY_DARWIN) && !defined(MOZ_REPLACE_MALLOC)
 static
@@ -6614,9 +6783,11 @@ jemalloc_stats_impl(jemalloc_stats_t *stats)
 	assert(base_mapped >= base_committed);
 	malloc_mutex_unlock(&base_mtx);
 
-	/* Iterate over arenas. */
-	for (i = 0; i < narenas; i++) {
-		arena_t *arena = arenas[i];
+	/* Iterate over arenas, including the partition arenas, which are not
+	 * part of the arenas array. */
+	for (i = 0; i < narenas + JEMALLOC_PARTITION_COUNT; i++) {
+		arena_t *arena = (i < narenas) ? arenas[i] :
+		    partition_arenas[i - narenas];
 		size_t arena_mapped, arena_allocated, arena_committed, arena_dirty, j,
 		    arena_unused, arena_headers;
 		arena_run_t* run;
@@ -6689,6 +6860,37 @@ jemalloc_stats_impl(jemalloc_stats_t *stats)
 				stats->page_cache + stats->bookkeeping);
 }
 
+MOZ_JEMALLOC_API void
+jemalloc_partition_stats_impl(jemalloc_partition_t partition,
+    jemalloc_partition_stats_t *pstats)
+{
+	arena_t *arena;
+
+	assert(pstats != NULL);
+
+	memset(pstats, 0, sizeof(*pstats));
+
+	if (malloc_initialized == false ||
+	    partition >= JEMALLOC_PARTITION_COUNT)
+		return;
+
+	malloc_spin_lock(&arenas_lock);
+	arena = partition_arenas[partition];
+	malloc_spin_unlock(&arenas_lock);
+
+	/* All counters stay zero until the first partition allocation. */
+	if (arena == NULL)
+		return;
+
+	malloc_spin_lock(&arena->lock);
+	pstats->mapped = arena->stats.mapped;
+	pstats->committed = arena->stats.committed << pagesize_2pow;
+	pstats->allocated = arena->stats.allocated_small +
+	    arena->stats.allocated_large;
+	pstats->page_cache = arena->ndirty << pagesize_2pow;
+	malloc_spin_unlock(&arena->lock);
+}
+
 #ifdef MALLOC_DOUBLE_PURGE
 
 /* Explicitly remove all of this chunk's MADV_FREE'd pages from memory. */
@@ -6742,8 +6944,9 @@ MOZ_JEMALLOC_API void
 jemalloc_purge_freed_pages_impl()
 {
 	size_t i;
-	for (i = 0; i < narenas; i++) {
-		arena_t *arena = arenas[i];
+	for (i = 0; i < narenas + JEMALLOC_PARTITION_COUNT; i++) {
+		arena_t *arena = (i < narenas) ? arenas[i] :
+		    partition_arenas[i - narenas];
 		if (arena != NULL)
 			hard_purge_arena(arena);
 	}
@@ -6821,8 +7024,9 @@ MOZ_JEMALLOC_API void
 jemalloc_free_dirty_pages_impl(void)
 {
 	size_t i;
-	for (i = 0; i < narenas; i++) {
-		arena_t *arena = arenas[i];
+	for (i = 0; i < narenas + JEMALLOC_PARTITION_COUNT; i++) {
+		arena_t *arena = (i < narenas) ? arenas[i] :
+		    partition_arenas[i - narenas];
 
 		if (arena != NULL) {
 			malloc_spin_lock(&arena->lock);
@@ -6855,6 +7059,10 @@ _malloc_prefork(void)
 		if (arenas[i] != NULL)
 			malloc_spin_lock(&arenas[i]->lock);
 	}
+	for (i = 0; i < JEMALLOC_PARTITION_COUNT; i++) {
+		if (partition_arenas[i] != NULL)
+			malloc_spin_lock(&partition_arenas[i]->lock);
+	}
 
 	malloc_mutex_lock(&base_mtx);
 
@@ -6872,6 +7080,10 @@ _malloc_postfork(void)
 
 	malloc_mutex_unlock(&base_mtx);
 
+	for (i = 0; i < JEMALLOC_PARTITION_COUNT; i++) {
+		if (partition_arenas[i] != NULL)
+			malloc_spin_unlock(&partition_arenas[i]->lock);
+	}
 	for (i = 0; i < narenas; i++) {
 		if (arenas[i] != NULL)
 			malloc_spin_unlock(&arenas[i]->lock);
@@ -84,6 +84,31 @@ typedef struct {
 	size_t bin_unused; /* Bytes committed to a bin but currently unused. */
 } jemalloc_stats_t;
 
+/*
+ * Allocation partitions served by dedicated arenas, so that allocations from
+ * different subsystems do not interleave within the same runs and chunks.
+ * See moz_arena_malloc() in mozmemory.h.
+ */
+typedef enum {
+	JEMALLOC_PARTITION_GFX = 0,	/* Image and graphics buffers. */
+	JEMALLOC_PARTITION_DOM,		/* DOM nodes and strings. */
+	JEMALLOC_PARTITION_NECKO,	/* Networking buffers and caches. */
+	JEMALLOC_PARTITION_COUNT
+} jemalloc_partition_t;
+
+/*
+ * Per-partition memory statistics, filled in by jemalloc_partition_stats().
+ * All counters are zero until the partition's arena has been created by a
+ * first allocation.  Fragmentation for a partition is
+ * committed - allocated - page_cache.
+ */
+typedef struct {
+	size_t	mapped;		/* Bytes mapped for this partition's arena. */
+	size_t	committed;	/* Committed bytes (allocated plus dirty). */
+	size_t	allocated;	/* Bytes in use by the application. */
+	size_t	page_cache;	/* Committed, unused pages kept as a cache. */
+} jemalloc_partition_stats_t;
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
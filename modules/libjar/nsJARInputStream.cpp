@@ -228,8 +228,46 @@ MOZ_WIN_MEM_TRY_CATCH(rv = NS_ERROR_FAILURE)
 NS_IMETHODIMP
 nsJARInputStream::ReadSegments(nsWriteSegmentFun writer, void * closure, uint32_t count, uint32_t *_retval)
 {
-    // don't have a buffer to read from, so this better not be called!
-    return NS_ERROR_NOT_IMPLEMENTED;
+    NS_ENSURE_ARG_POINTER(_retval);
+
+    *_retval = 0;
+
+    if (mMode != MODE_COPY) {
+        // Inflation and directory listings need a buffer to write into.
+        return NS_ERROR_NOT_IMPLEMENTED;
+    }
+
+    // STORED items live uncompressed in the archive's mapping, so hand the
+    // writer segments that point straight at the mmapped data.  The pages
+    // behind them come from the OS page cache and are shared with every
+    // other process that has the same archive mapped.
+    nsresult rv = NS_OK;
+MOZ_WIN_MEM_TRY_BEGIN
+    if (mFd) {
+        uint32_t remaining = std::min(count, mOutSize - uint32_t(mZs.total_out));
+        while (remaining) {
+            uint32_t written = 0;
+            rv = writer(this, closure,
+                        reinterpret_cast<const char*>(mZs.next_in) + mZs.total_out,
+                        *_retval, remaining, &written);
+            if (NS_FAILED(rv)) {
+                // Errors returned by the writer end the read but are not
+                // stream failures, per nsIInputStream.
+                rv = NS_OK;
+                break;
+            }
+            NS_ASSERTION(written <= remaining, "writer wrote too much");
+            mZs.total_out += written;
+            *_retval += written;
+            remaining -= written;
+        }
+    }
+    // be aggressive about releasing the file!
+    if (mZs.total_out >= mOutSize) {
+        mFd = nullptr;
+    }
+MOZ_WIN_MEM_TRY_CATCH(rv = NS_ERROR_FAILURE)
+    return rv;
 }
 
 NS_IMETHODIMP
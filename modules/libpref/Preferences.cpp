@@ -182,6 +182,14 @@ struct CacheData {
 };
 
 static nsTArray<nsAutoPtr<CacheData> >* gCacheData = nullptr;
+
+// Serializing the whole pref table is done once per content process spawn,
+// and between spawns the table rarely changes.  Keep the last snapshot and
+// its generation; nsCString members share their buffers on copy, so handing
+// out the cached array is a cheap copy-on-write clone instead of a full
+// re-enumeration with fresh string allocations.
+static InfallibleTArray<dom::PrefSetting>* gPrefArraySnapshot = nullptr;
+static uint32_t gPrefArraySnapshotGeneration = 0;
 static nsRefPtrHashtable<ValueObserverHashKey,
                          ValueObserver>* gObserverTable = nullptr;
 
@@ -487,6 +495,9 @@ Preferences::~Preferences()
   delete gCacheData;
   gCacheData = nullptr;
 
+  delete gPrefArraySnapshot;
+  gPrefArraySnapshot = nullptr;
+
   NS_RELEASE(sRootBranch);
   NS_RELEASE(sDefaultRootBranch);
 
@@ -745,8 +756,20 @@ Preferences::GetPreference(PrefSetting* aPref)
 void
 Preferences::GetPreferences(InfallibleTArray<PrefSetting>* aPrefs)
 {
+  if (gPrefArraySnapshot &&
+      gPrefArraySnapshotGeneration == gPrefTableGeneration) {
+    *aPrefs = *gPrefArraySnapshot;
+    return;
+  }
+
   aPrefs->SetCapacity(gHashTable.Capacity());
   PL_DHashTableEnumerate(&gHashTable, pref_GetPrefs, aPrefs);
+
+  if (!gPrefArraySnapshot) {
+    gPrefArraySnapshot = new InfallibleTArray<dom::PrefSetting>();
+  }
+  *gPrefArraySnapshot = *aPrefs;
+  gPrefArraySnapshotGeneration = gPrefTableGeneration;
 }
 
 NS_IMETHODIMP
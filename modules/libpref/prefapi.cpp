@@ -68,6 +68,7 @@ matchPrefEntry(PLDHashTable*, const PLDHashEntryHdr* entry,
 PLDHashTable        gHashTable;
 static PLArenaPool  gPrefNameArena;
 bool                gDirty = false;
+uint32_t            gPrefTableGeneration = 0;
 
 static struct CallbackNode* gCallbacks = nullptr;
 static bool         gIsAnyPrefLocked = false;
@@ -189,6 +190,7 @@ void PREF_CleanupPrefs()
         PL_DHashTableFinish(&gHashTable);
         gHashTable.ops = nullptr;
         PL_FinishArenaPool(&gPrefNameArena);
+        gPrefTableGeneration++;
     }
 }
 
@@ -598,6 +600,7 @@ PREF_DeleteBranch(const char *branch_name)
     PL_DHashTableEnumerate(&gHashTable, pref_DeleteItem,
                            (void*) branch_dot.get());
     gDirty = true;
+    gPrefTableGeneration++;
     return NS_OK;
 }
 
@@ -617,6 +620,10 @@ PREF_ClearUserPref(const char *pref_name)
             PL_DHashTableOperate(&gHashTable, pref_name, PL_DHASH_REMOVE);
         }
 
+        // Bump the generation before running callbacks: the removal above
+        // may have shrunk the table, and callbacks can do lookups that
+        // must not trust pref_HashTableLookup's cached entry.
+        gPrefTableGeneration++;
         pref_DoCallback(pref_name);
         gDirty = true;
     }
@@ -657,6 +664,7 @@ PREF_ClearAllUserPrefs()
     PL_DHashTableEnumerate(&gHashTable, pref_ClearUserPref, nullptr);
 
     gDirty = true;
+    gPrefTableGeneration++;
     return NS_OK;
 }
 
@@ -674,6 +682,7 @@ nsresult PREF_LockPref(const char *key, bool lockit)
         {
             pref->flags |= PREF_LOCKED;
             gIsAnyPrefLocked = true;
+            gPrefTableGeneration++;
             pref_DoCallback(key);
         }
     }
@@ -682,6 +691,7 @@ nsresult PREF_LockPref(const char *key, bool lockit)
         if (PREF_IS_LOCKED(pref))
         {
             pref->flags &= ~PREF_LOCKED;
+            gPrefTableGeneration++;
             pref_DoCallback(key);
         }
     }
@@ -733,12 +743,33 @@ PrefHashEntry* pref_HashTableLookup(const void *key)
     MOZ_ASSERT(NS_IsMainThread());
 #endif
 
+    // One-entry lookup cache.  Hot callers (nsHttp, layout) ask for the
+    // same few prefs over and over, so checking the last hit with a single
+    // strcmp usually saves the key hash and the table probe.  Entries move
+    // whenever the entry store is grown or compressed, which the table
+    // tracks in its own generation counter; note that even a PL_DHASH_ADD
+    // of an already existing key may compress the table.  In addition,
+    // gPrefTableGeneration invalidates the cache when an entry is removed
+    // or cleared in place, which leaves the entry store untouched.
+    static PrefHashEntry* gLastEntry = nullptr;
+    static uint32_t gLastGeneration = 0;
+    static uint32_t gLastTableGeneration = 0;
+
+    if (gLastEntry && gLastGeneration == gPrefTableGeneration &&
+        gLastTableGeneration == gHashTable.Generation() &&
+        matchPrefEntry(nullptr, gLastEntry, key)) {
+        return gLastEntry;
+    }
+
     PrefHashEntry* result =
         static_cast<PrefHashEntry*>(PL_DHashTableOperate(&gHashTable, key, PL_DHASH_LOOKUP));
 
     if (PL_DHASH_ENTRY_IS_FREE(result))
         return nullptr;
 
+    gLastEntry = result;
+    gLastGeneration = gPrefTableGeneration;
+    gLastTableGeneration = gHashTable.Generation();
     return result;
 }
 
@@ -764,6 +795,7 @@ nsresult pref_HashPref(const char *key, PrefValue value, PrefType type, uint32_t
         pref->key = ArenaStrDup(key, &gPrefNameArena);
         memset(&pref->defaultPref, 0, sizeof(pref->defaultPref));
         memset(&pref->userPref, 0, sizeof(pref->userPref));
+        gPrefTableGeneration++;
     }
     else if ((pref->flags & PREF_HAS_DEFAULT) && PREF_TYPE(pref) != type)
     {
@@ -781,6 +813,7 @@ nsresult pref_HashPref(const char *key, PrefValue value, PrefType type, uint32_t
             {
                 pref_SetValue(&pref->defaultPref, &pref->flags, value, type);
                 pref->flags |= PREF_HAS_DEFAULT;
+                gPrefTableGeneration++;
                 if (!PREF_HAS_USER_VALUE(pref))
                     valueChanged = true;
             }
@@ -800,6 +833,7 @@ nsresult pref_HashPref(const char *key, PrefValue value, PrefType type, uint32_t
             {
                 /* XXX should we free a user-set string value if there is one? */
                 pref->flags &= ~PREF_USERSET;
+                gPrefTableGeneration++;
                 if (!PREF_IS_LOCKED(pref)) {
                     gDirty = true;
                     valueChanged = true;
@@ -812,6 +846,7 @@ nsresult pref_HashPref(const char *key, PrefValue value, PrefType type, uint32_t
         {
             pref_SetValue(&pref->userPref, &pref->flags, value, type);
             pref->flags |= PREF_USERSET;
+            gPrefTableGeneration++;
             if (!PREF_IS_LOCKED(pref)) {
                 gDirty = true;
                 valueChanged = true;
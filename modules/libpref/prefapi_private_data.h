@@ -12,6 +12,9 @@
 
 extern PLDHashTable			gHashTable;
 extern bool                 gDirty;
+// Bumped on every mutation of the pref table (values, flags, entries), so
+// consumers can cache derived data and cheaply detect staleness.
+extern uint32_t             gPrefTableGeneration;
 
 namespace mozilla {
 namespace dom {
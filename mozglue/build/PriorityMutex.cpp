@@ -0,0 +1,270 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "PriorityMutex.h"
+
+#include "mozilla/Assertions.h"
+#include "mozilla/Atomics.h"
+#include "mozilla/DebugOnly.h"
+#include "mozilla/MathAlgorithms.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(XP_WIN)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#if defined(XP_DARWIN)
+#include <mach/mach_time.h>
+#endif
+
+namespace mozilla {
+
+namespace detail {
+
+// Wait times are binned by log2 microseconds; 32 buckets reaches past half
+// an hour, well beyond anything we would still call a lock wait.
+static const size_t kWaitHistogramBuckets = 32;
+
+// One of these per instrumented lock, linked into a global list so they can
+// all be dumped at exit.  Never freed: the dump runs from atexit and a lock
+// may be destroyed before that.
+struct LockContentionStats
+{
+  const char* mName;
+  LockContentionStats* mNext;
+  uint64_t mAcquisitions;
+  uint64_t mContentions;
+  uint64_t mTotalWaitUs;
+  uint64_t mMaxWaitUs;
+  uint64_t mWaitHistogram[kWaitHistogramBuckets];
+};
+
+static Atomic<LockContentionStats*> sLockStatsList;
+
+static void
+DumpLockContentionStats()
+{
+  for (LockContentionStats* stats = sLockStatsList; stats;
+       stats = stats->mNext) {
+    if (!stats->mContentions) {
+      continue;
+    }
+    fprintf(stderr,
+            "lock contention: %s: acquisitions=%llu contended=%llu "
+            "total-wait=%lluus max-wait=%lluus\n",
+            stats->mName,
+            (unsigned long long)stats->mAcquisitions,
+            (unsigned long long)stats->mContentions,
+            (unsigned long long)stats->mTotalWaitUs,
+            (unsigned long long)stats->mMaxWaitUs);
+    fprintf(stderr, "lock contention: %s: wait histogram (<=us:count)",
+            stats->mName);
+    for (size_t i = 0; i < kWaitHistogramBuckets; ++i) {
+      if (stats->mWaitHistogram[i]) {
+        fprintf(stderr, " %llu:%llu",
+                (unsigned long long)(uint64_t(1) << i),
+                (unsigned long long)stats->mWaitHistogram[i]);
+      }
+    }
+    fprintf(stderr, "\n");
+  }
+}
+
+static LockContentionStats*
+RegisterLockStats(const char* aName)
+{
+  LockContentionStats* stats =
+    static_cast<LockContentionStats*>(calloc(1, sizeof(LockContentionStats)));
+  if (!stats) {
+    return nullptr;
+  }
+  stats->mName = aName;
+
+  LockContentionStats* head;
+  do {
+    head = sLockStatsList;
+    stats->mNext = head;
+  } while (!sLockStatsList.compareExchange(head, stats));
+
+  if (!head) {
+    // First instrumented lock in the process; arrange for the dump.
+    atexit(DumpLockContentionStats);
+  }
+  return stats;
+}
+
+// Called with the mutex held, so updates to one lock's stats never race.
+static void
+RecordContention(LockContentionStats* aStats, uint64_t aWaitUs)
+{
+  aStats->mAcquisitions++;
+  aStats->mContentions++;
+  aStats->mTotalWaitUs += aWaitUs;
+  if (aWaitUs > aStats->mMaxWaitUs) {
+    aStats->mMaxWaitUs = aWaitUs;
+  }
+  size_t bucket = aWaitUs ? CeilingLog2(aWaitUs) : 0;
+  if (bucket >= kWaitHistogramBuckets) {
+    bucket = kWaitHistogramBuckets - 1;
+  }
+  aStats->mWaitHistogram[bucket]++;
+}
+
+} // namespace detail
+
+static bool
+ContentionLoggingEnabled()
+{
+  // Benign race; every thread computes the same answer.
+  static int sEnabled = -1;
+  if (sEnabled < 0) {
+    const char* env = getenv("MOZ_LOCK_CONTENTION_LOG");
+    sEnabled = (env && *env) ? 1 : 0;
+  }
+  return sEnabled == 1;
+}
+
+// A monotonic clock in microseconds.  mozilla::TimeStamp lives above
+// mozglue, so we go to the OS directly.
+static uint64_t
+NowMicroseconds()
+{
+#if defined(XP_WIN)
+  static LARGE_INTEGER sFrequency = { { 0, 0 } };
+  if (!sFrequency.QuadPart) {
+    QueryPerformanceFrequency(&sFrequency);
+  }
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  return uint64_t(now.QuadPart) * 1000000 / uint64_t(sFrequency.QuadPart);
+#elif defined(XP_DARWIN)
+  static mach_timebase_info_data_t sTimebase = { 0, 0 };
+  if (!sTimebase.denom) {
+    mach_timebase_info(&sTimebase);
+  }
+  return mach_absolute_time() * sTimebase.numer / sTimebase.denom / 1000;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000 + uint64_t(ts.tv_nsec) / 1000;
+#endif
+}
+
+#if defined(XP_WIN)
+static CRITICAL_SECTION*
+NativeHandle(void* aStorage)
+{
+  return reinterpret_cast<CRITICAL_SECTION*>(aStorage);
+}
+#else
+static pthread_mutex_t*
+NativeHandle(void* aStorage)
+{
+  return reinterpret_cast<pthread_mutex_t*>(aStorage);
+}
+#endif
+
+PriorityInheritingMutex::PriorityInheritingMutex(const char* aName)
+  : mName(aName)
+  , mStats(nullptr)
+{
+#if defined(XP_WIN)
+  static_assert(sizeof(CRITICAL_SECTION) <= sizeof(mStorage),
+                "mStorage too small for a CRITICAL_SECTION");
+  // Critical sections do not inherit priority, but the NT scheduler applies
+  // an anti-inversion boost to lock owners, which is the closest this
+  // platform offers.
+  InitializeCriticalSection(NativeHandle(mStorage));
+#else
+  static_assert(sizeof(pthread_mutex_t) <= sizeof(mStorage),
+                "mStorage too small for a pthread_mutex_t");
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+#if defined(_POSIX_THREAD_PRIO_INHERIT) && _POSIX_THREAD_PRIO_INHERIT > 0
+  // Best effort; a kernel that refuses just leaves us with a plain mutex.
+  pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+#endif
+  DebugOnly<int> rv = pthread_mutex_init(NativeHandle(mStorage), &attr);
+  MOZ_ASSERT(rv == 0, "pthread_mutex_init failed");
+  pthread_mutexattr_destroy(&attr);
+#endif
+
+  if (ContentionLoggingEnabled()) {
+    mStats = detail::RegisterLockStats(aName);
+  }
+}
+
+PriorityInheritingMutex::~PriorityInheritingMutex()
+{
+#if defined(XP_WIN)
+  DeleteCriticalSection(NativeHandle(mStorage));
+#else
+  DebugOnly<int> rv = pthread_mutex_destroy(NativeHandle(mStorage));
+  MOZ_ASSERT(rv == 0, "destroying a locked mutex");
+#endif
+  // mStats stays on the global list so the exit dump can report it.
+}
+
+void
+PriorityInheritingMutex::Lock()
+{
+  if (MOZ_LIKELY(!mStats)) {
+#if defined(XP_WIN)
+    EnterCriticalSection(NativeHandle(mStorage));
+#else
+    pthread_mutex_lock(NativeHandle(mStorage));
+#endif
+    return;
+  }
+
+#if defined(XP_WIN)
+  if (TryEnterCriticalSection(NativeHandle(mStorage))) {
+#else
+  if (pthread_mutex_trylock(NativeHandle(mStorage)) == 0) {
+#endif
+    mStats->mAcquisitions++;
+    return;
+  }
+
+  uint64_t start = NowMicroseconds();
+#if defined(XP_WIN)
+  EnterCriticalSection(NativeHandle(mStorage));
+#else
+  pthread_mutex_lock(NativeHandle(mStorage));
+#endif
+  detail::RecordContention(mStats, NowMicroseconds() - start);
+}
+
+void
+PriorityInheritingMutex::Unlock()
+{
+#if defined(XP_WIN)
+  LeaveCriticalSection(NativeHandle(mStorage));
+#else
+  pthread_mutex_unlock(NativeHandle(mStorage));
+#endif
+}
+
+bool
+PriorityInheritingMutex::TryLock()
+{
+#if defined(XP_WIN)
+  bool acquired = !!TryEnterCriticalSection(NativeHandle(mStorage));
+#else
+  bool acquired = pthread_mutex_trylock(NativeHandle(mStorage)) == 0;
+#endif
+  if (acquired && mStats) {
+    mStats->mAcquisitions++;
+  }
+  return acquired;
+}
+
+} // namespace mozilla
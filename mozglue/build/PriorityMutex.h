@@ -0,0 +1,60 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_PriorityMutex_h
+#define mozilla_PriorityMutex_h
+
+#include "mozilla/Attributes.h"
+#include "mozilla/Types.h"
+
+#include <stdint.h>
+
+namespace mozilla {
+
+namespace detail {
+struct LockContentionStats;
+}
+
+/**
+ * A mutex that does not go through NSPR and that, where the OS supports it,
+ * participates in priority inheritance (PTHREAD_PRIO_INHERIT).  A realtime
+ * thread blocking on one of these boosts the owning thread instead of
+ * waiting behind every runnable of intermediate priority, which is what
+ * makes a PR_Lock held by a low-priority thread glitch the audio callback.
+ *
+ * When the MOZ_LOCK_CONTENTION_LOG environment variable is set, every
+ * contended Lock() records its wait time in a per-lock log2 histogram that
+ * is printed to stderr at process exit.
+ *
+ * This is a leaf lock: it is not reentrant and is not hooked into NSPR's
+ * deadlock detector, so do not acquire other locks while holding one.
+ */
+class PriorityInheritingMutex
+{
+public:
+  MFBT_API explicit PriorityInheritingMutex(const char* aName);
+  MFBT_API ~PriorityInheritingMutex();
+
+  MFBT_API void Lock();
+  MFBT_API void Unlock();
+  MFBT_API bool TryLock();
+
+private:
+  PriorityInheritingMutex(const PriorityInheritingMutex&) MOZ_DELETE;
+  void operator=(const PriorityInheritingMutex&) MOZ_DELETE;
+
+  // Enough storage for the native lock on every platform we build for
+  // (pthread_mutex_t or CRITICAL_SECTION), so that this header does not
+  // have to pull in pthread.h or windows.h.
+  void* mStorage[8];
+
+  const char* mName;
+  detail::LockContentionStats* mStats;
+};
+
+} // namespace mozilla
+
+#endif // mozilla_PriorityMutex_h
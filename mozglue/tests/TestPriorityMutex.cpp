@@ -0,0 +1,30 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/PriorityMutex.h"
+
+#include <stdio.h>
+
+int
+main()
+{
+  mozilla::PriorityInheritingMutex lock("TestPriorityMutex");
+
+  for (int i = 0; i < 1000; ++i) {
+    lock.Lock();
+    lock.Unlock();
+  }
+
+  if (!lock.TryLock()) {
+    fprintf(stderr, "TEST-FAIL | TestPriorityMutex | "
+                    "TryLock on an uncontended mutex failed\n");
+    return 1;
+  }
+  lock.Unlock();
+
+  printf("TEST-PASS | TestPriorityMutex | all tests passed\n");
+  return 0;
+}
@@ -7,7 +7,11 @@
 
 #include "Predictor.h"
 
+#include "LoadContextInfo.h"
 #include "nsAppDirectoryServiceDefs.h"
+#include "nsICacheEntryOpenCallback.h"
+#include "nsICacheStorage.h"
+#include "nsICacheStorageService.h"
 #include "nsICancelable.h"
 #include "nsIChannel.h"
 #include "nsIDNSListener.h"
@@ -20,9 +24,12 @@
 #include "nsIObserverService.h"
 #include "nsIPrefBranch.h"
 #include "nsIPrefService.h"
+#include "nsIPrincipal.h"
+#include "nsIScriptSecurityManager.h"
 #include "nsISpeculativeConnect.h"
 #include "nsITimer.h"
 #include "nsIURI.h"
+#include "nsIURIClassifier.h"
 #include "nsNetUtil.h"
 #include "nsServiceManagerUtils.h"
 #include "nsTArray.h"
@@ -98,9 +105,15 @@ const int PRECONNECT_MIN_DEFAULT = 90;
 const char PREDICTOR_PRERESOLVE_MIN_PREF[] =
   "network.predictor.preresolve-min-confidence";
 const int PRERESOLVE_MIN_DEFAULT = 60;
+const char PREDICTOR_PREOPEN_MIN_PREF[] =
+  "network.predictor.preopen-min-confidence";
+const int PREOPEN_MIN_DEFAULT = 60;
 const char PREDICTOR_REDIRECT_LIKELY_PREF[] =
   "network.predictor.redirect-likely-confidence";
 const int REDIRECT_LIKELY_DEFAULT = 75;
+const char PREDICTOR_MAX_PRECONNECTS_PREF[] =
+  "network.predictor.max-preconnects-per-origin";
+const int PREDICTOR_MAX_PRECONNECTS_DEFAULT = 3;
 
 const char PREDICTOR_MAX_QUEUE_SIZE_PREF[] = "network.predictor.max-queue-size";
 const uint32_t PREDICTOR_MAX_QUEUE_SIZE_DEFAULT = 50;
@@ -185,7 +198,9 @@ Predictor::Predictor()
   ,mSubresourceDegradationMax(PREDICTOR_SUB_DELTA_MAX_DEFAULT)
   ,mPreconnectMinConfidence(PRECONNECT_MIN_DEFAULT)
   ,mPreresolveMinConfidence(PRERESOLVE_MIN_DEFAULT)
+  ,mPreopenMinConfidence(PREOPEN_MIN_DEFAULT)
   ,mRedirectLikelyConfidence(REDIRECT_LIKELY_DEFAULT)
+  ,mMaxPreconnectsPerOrigin(PREDICTOR_MAX_PRECONNECTS_DEFAULT)
   ,mMaxQueueSize(PREDICTOR_MAX_QUEUE_SIZE_DEFAULT)
   ,mStatements(mDB)
   ,mLastStartupTime(0)
@@ -278,9 +293,15 @@ Predictor::InstallObserver()
   Preferences::AddIntVarCache(&mPreresolveMinConfidence,
                               PREDICTOR_PRERESOLVE_MIN_PREF,
                               PRERESOLVE_MIN_DEFAULT);
+  Preferences::AddIntVarCache(&mPreopenMinConfidence,
+                              PREDICTOR_PREOPEN_MIN_PREF,
+                              PREOPEN_MIN_DEFAULT);
   Preferences::AddIntVarCache(&mRedirectLikelyConfidence,
                               PREDICTOR_REDIRECT_LIKELY_PREF,
                               REDIRECT_LIKELY_DEFAULT);
+  Preferences::AddIntVarCache(&mMaxPreconnectsPerOrigin,
+                              PREDICTOR_MAX_PRECONNECTS_PREF,
+                              PREDICTOR_MAX_PRECONNECTS_DEFAULT);
 
   Preferences::AddIntVarCache(&mMaxQueueSize, PREDICTOR_MAX_QUEUE_SIZE_PREF,
                               PREDICTOR_MAX_QUEUE_SIZE_DEFAULT);
@@ -384,7 +405,14 @@ NS_IMETHODIMP
 Predictor::GetParallelSpeculativeConnectLimit(
     uint32_t *parallelSpeculativeConnectLimit)
 {
-  *parallelSpeculativeConnectLimit = 6;
+  // Don't let the connection manager clip a high-confidence origin's warm
+  // connection budget.
+  uint32_t limit = 6;
+  if (mMaxPreconnectsPerOrigin > 0 &&
+      uint32_t(mMaxPreconnectsPerOrigin) > limit) {
+    limit = uint32_t(mMaxPreconnectsPerOrigin);
+  }
+  *parallelSpeculativeConnectLimit = limit;
   return NS_OK;
 }
 
@@ -1008,6 +1036,107 @@ private:
   TimeStamp mEnqueueTime;
 };
 
+// Listener for the cache entry pre-opens we fire off. We never actually want
+// the entry - the point of the open is its side effect of pulling the entry's
+// metadata off the disk and into the cache service's memory structures, so
+// that when the real channel opens the entry a moment later it doesn't have
+// to wait on cache I/O.
+class PredictorCacheOpenListener MOZ_FINAL : public nsICacheEntryOpenCallback
+{
+public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+
+  PredictorCacheOpenListener()
+  { }
+
+  NS_IMETHOD OnCacheEntryCheck(nsICacheEntry *entry,
+                               nsIApplicationCache *appCache,
+                               uint32_t *result) MOZ_OVERRIDE
+  {
+    // By the time we're called, the entry's metadata has already been
+    // deserialized, which is all we were after.
+    *result = nsICacheEntryOpenCallback::ENTRY_NOT_WANTED;
+    return NS_OK;
+  }
+
+  NS_IMETHOD OnCacheEntryAvailable(nsICacheEntry *entry, bool isNew,
+                                   nsIApplicationCache *appCache,
+                                   nsresult result) MOZ_OVERRIDE
+  {
+    return NS_OK;
+  }
+
+private:
+  ~PredictorCacheOpenListener()
+  { }
+};
+
+NS_IMPL_ISUPPORTS(PredictorCacheOpenListener, nsICacheEntryOpenCallback);
+
+// Kicks off a throwaway read-only open of the cache entry for a URI we expect
+// to be loaded soon, so the entry is warm by the time the real channel asks
+// for it. OPEN_SECRETLY keeps us from perturbing the entry's "last used"
+// bookkeeping (and from writing anything) on what is, after all, only a guess.
+void
+Predictor::PreopenCacheEntry(nsIURI *targetURI)
+{
+  MOZ_ASSERT(NS_IsMainThread(), "Pre-opening cache entry off main thread");
+
+  if (!mDiskCacheStorage) {
+    nsCOMPtr<nsICacheStorageService> cacheStorageService =
+      do_GetService("@mozilla.org/netwerk/cache-storage-service;1");
+    if (!cacheStorageService) {
+      return;
+    }
+
+    nsRefPtr<LoadContextInfo> lci = GetLoadContextInfo();
+    nsresult rv = cacheStorageService->DiskCacheStorage(
+        lci, false, getter_AddRefs(mDiskCacheStorage));
+    if (NS_FAILED(rv)) {
+      return;
+    }
+  }
+
+  nsRefPtr<PredictorCacheOpenListener> listener =
+    new PredictorCacheOpenListener();
+  mDiskCacheStorage->AsyncOpenURI(targetURI, EmptyCString(),
+                                  nsICacheStorage::OPEN_READONLY |
+                                  nsICacheStorage::OPEN_SECRETLY,
+                                  listener);
+}
+
+// Ask the URL classifier to warm up for a URI we expect to load soon, so
+// the classification at channel-open time finds its caches primed instead
+// of waiting on the classifier thread (and possibly a gethash request).
+// Purely advisory; all failures are ignored.
+static void
+SpeculativelyClassify(nsIURI *targetURI)
+{
+  MOZ_ASSERT(NS_IsMainThread(), "Classifying speculatively off main thread");
+
+  nsresult rv;
+  nsCOMPtr<nsIURIClassifier> uriClassifier =
+    do_GetService(NS_URICLASSIFIERSERVICE_CONTRACTID, &rv);
+  if (NS_FAILED(rv)) {
+    return;
+  }
+
+  nsCOMPtr<nsIScriptSecurityManager> securityManager =
+    do_GetService(NS_SCRIPTSECURITYMANAGER_CONTRACTID, &rv);
+  if (NS_FAILED(rv)) {
+    return;
+  }
+
+  nsCOMPtr<nsIPrincipal> principal;
+  rv = securityManager->GetNoAppCodebasePrincipal(targetURI,
+                                                  getter_AddRefs(principal));
+  if (NS_FAILED(rv)) {
+    return;
+  }
+
+  uriClassifier->SpeculativeClassify(principal, false);
+}
+
 // Predicting for a link is easy, and doesn't require the round-trip to the
 // predictor thread and back to the main thread, since we don't have to hit the
 // db for that.
@@ -1032,6 +1161,8 @@ Predictor::PredictForLink(nsIURI *targetURI, nsIURI *sourceURI,
   }
 
   mSpeculativeService->SpeculativeConnect(targetURI, nullptr);
+  PreopenCacheEntry(targetURI);
+  SpeculativelyClassify(targetURI);
   if (verifier) {
     verifier->OnPredictPreconnect(targetURI);
   }
@@ -1048,9 +1179,11 @@ public:
     ,mPredictStartTime(predictStartTime)
   { }
 
-  void AddPreconnect(const nsACString &uri)
+  void AddPreconnect(const nsACString &uri, uint32_t connectionCount = 1)
   {
-    mPreconnects.AppendElement(uri);
+    Preconnect *preconnect = mPreconnects.AppendElement();
+    preconnect->mUri = uri;
+    preconnect->mConnectionCount = connectionCount;
   }
 
   void AddPreresolve(const nsACString &uri)
@@ -1058,9 +1191,15 @@ public:
     mPreresolves.AppendElement(uri);
   }
 
+  void AddCachePreopen(const nsACString &uri)
+  {
+    mCachePreopens.AppendElement(uri);
+  }
+
   bool HasWork() const
   {
-    return !(mPreconnects.IsEmpty() && mPreresolves.IsEmpty());
+    return !(mPreconnects.IsEmpty() && mPreresolves.IsEmpty() &&
+             mCachePreopens.IsEmpty());
   }
 
   NS_IMETHOD Run() MOZ_OVERRIDE
@@ -1075,7 +1214,7 @@ public:
     len = mPreconnects.Length();
     for (i = 0; i < len; ++i) {
       nsCOMPtr<nsIURI> uri;
-      nsresult rv = NS_NewURI(getter_AddRefs(uri), mPreconnects[i]);
+      nsresult rv = NS_NewURI(getter_AddRefs(uri), mPreconnects[i].mUri);
       if (NS_FAILED(rv)) {
         continue;
       }
@@ -1083,7 +1222,13 @@ public:
       Telemetry::AutoCounter<Telemetry::PREDICTOR_TOTAL_PRECONNECTS> totalPreconnects;
       ++totalPredictions;
       ++totalPreconnects;
-      gPredictor->mSpeculativeService->SpeculativeConnect(uri, gPredictor);
+      // Warm up as many connections as this origin's confidence earned it;
+      // the connection manager parks each one (handshake completed) in its
+      // idle pool until the real requests claim them.
+      for (uint32_t j = 0; j < mPreconnects[i].mConnectionCount; ++j) {
+        gPredictor->mSpeculativeService->SpeculativeConnect(uri, gPredictor);
+      }
+      SpeculativelyClassify(uri);
       if (mVerifier) {
         mVerifier->OnPredictPreconnect(uri);
       }
@@ -1115,15 +1260,37 @@ public:
       }
     }
 
+    len = mCachePreopens.Length();
+    for (i = 0; i < len; ++i) {
+      nsCOMPtr<nsIURI> uri;
+      nsresult rv = NS_NewURI(getter_AddRefs(uri), mCachePreopens[i]);
+      if (NS_FAILED(rv)) {
+        continue;
+      }
+
+      // No verifier callback for these - the verifier interface only knows
+      // about preconnects and DNS lookups, and the pre-open is pure warmup
+      // with no observable network effect.
+      gPredictor->PreopenCacheEntry(uri);
+    }
+
     mPreconnects.Clear();
     mPreresolves.Clear();
+    mCachePreopens.Clear();
 
     return NS_OK;
   }
 
 private:
-  nsTArray<nsCString> mPreconnects;
+  struct Preconnect
+  {
+    nsCString mUri;
+    uint32_t mConnectionCount;
+  };
+
+  nsTArray<Preconnect> mPreconnects;
   nsTArray<nsCString> mPreresolves;
+  nsTArray<nsCString> mCachePreopens;
   PredictorVerifierHandle mVerifier;
   TimeStamp mPredictStartTime;
 };
@@ -1214,6 +1381,32 @@ Predictor::CalculateConfidence(int baseConfidence, PRTime lastHit,
   return confidence;
 }
 
+// This determines how many warm connections a predicted origin is worth.  A
+// subresource that barely clears the preconnect bar gets one connection;
+// origins we hit nearly every load ramp up linearly to the per-origin cap, so
+// the first few requests all skip the connect+TLS round trips instead of just
+// the very first one.
+uint32_t
+Predictor::CalculatePreconnectBudget(int confidence)
+{
+  int32_t maxPreconnects = mMaxPreconnectsPerOrigin;
+  if (maxPreconnects <= 1) {
+    return 1;
+  }
+
+  int span = 100 - mPreconnectMinConfidence;
+  if (span <= 0 || confidence >= 100) {
+    return uint32_t(maxPreconnects);
+  }
+
+  int extra = ((confidence - mPreconnectMinConfidence) *
+               (maxPreconnects - 1)) / span;
+  if (extra < 0) {
+    extra = 0;
+  }
+  return uint32_t(1 + extra);
+}
+
 // (Maybe) adds a predictive action to the prediction runner, based on our
 // calculated confidence for the subresource in question.
 void
@@ -1221,10 +1414,16 @@ Predictor::SetupPrediction(int confidence, const nsACString &uri,
                            PredictionRunner *runner)
 {
     if (confidence >= mPreconnectMinConfidence) {
-      runner->AddPreconnect(uri);
+      runner->AddPreconnect(uri, CalculatePreconnectBudget(confidence));
     } else if (confidence >= mPreresolveMinConfidence) {
       runner->AddPreresolve(uri);
     }
+
+    // Independent of any network action, warm up the cache entry for
+    // subresources we're reasonably sure will be requested.
+    if (confidence >= mPreopenMinConfidence) {
+      runner->AddCachePreopen(uri);
+    }
 }
 
 // This gets the data about the top-level load from our database, either from
@@ -18,6 +18,7 @@
 #include "mozilla/storage/StatementCache.h"
 #include "mozilla/TimeStamp.h"
 
+class nsICacheStorage;
 class nsIDNSService;
 class nsINetworkPredictorVerifier;
 class nsIThread;
@@ -77,6 +78,7 @@ private:
   void PredictForLink(nsIURI *targetURI,
                       nsIURI *sourceURI,
                       nsINetworkPredictorVerifier *verifier);
+  void PreopenCacheEntry(nsIURI *targetURI);
   void PredictForPageload(const UriInfo &dest,
                           PredictorVerifierHandle &verifier,
                           int stackCount,
@@ -113,6 +115,7 @@ private:
                           PRTime lastHit,
                           PRTime lastPossible,
                           int globalDegradation);
+  uint32_t CalculatePreconnectBudget(int confidence);
   void SetupPrediction(int confidence,
                        const nsACString &uri,
                        PredictionRunner *runner);
@@ -199,7 +202,11 @@ private:
 
   int mPreconnectMinConfidence;
   int mPreresolveMinConfidence;
+  int mPreopenMinConfidence;
   int mRedirectLikelyConfidence;
+  // Cap on the number of speculative connections a single predicted origin
+  // may warm up; see CalculatePreconnectBudget.
+  int32_t mMaxPreconnectsPerOrigin;
 
   int32_t mMaxQueueSize;
 
@@ -207,6 +214,10 @@ private:
 
   nsCOMPtr<nsISpeculativeConnect> mSpeculativeService;
 
+  // Lazily-created handle on the default disk cache storage, used to warm up
+  // cache entries we expect the user to need soon. See PreopenCacheEntry.
+  nsCOMPtr<nsICacheStorage> mDiskCacheStorage;
+
   nsCOMPtr<nsIFile> mDBFile;
   nsCOMPtr<mozIStorageService> mStorageService;
   nsCOMPtr<mozIStorageConnection> mDB;
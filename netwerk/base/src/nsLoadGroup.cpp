@@ -945,11 +945,21 @@ nsLoadGroup::TelemetryReportChannel(nsITimedChannel *aTimedChannel,
     if (NS_FAILED(rv))
         return;
 
+    TimeStamp dispatchStart;
+    rv = aTimedChannel->GetDispatchStart(&dispatchStart);
+    if (NS_FAILED(rv))
+        return;
+
     TimeStamp requestStart;
     rv = aTimedChannel->GetRequestStart(&requestStart);
     if (NS_FAILED(rv))
         return;
 
+    TimeStamp requestEnd;
+    rv = aTimedChannel->GetRequestEnd(&requestEnd);
+    if (NS_FAILED(rv))
+        return;
+
     TimeStamp responseStart;
     rv = aTimedChannel->GetResponseStart(&responseStart);
     if (NS_FAILED(rv))
@@ -979,6 +989,17 @@ nsLoadGroup::TelemetryReportChannel(nsITimedChannel *aTimedChannel,
             connectStart, connectEnd);                                         \
     }                                                                          \
                                                                                \
+    if (!dispatchStart.IsNull()) {                                             \
+        Telemetry::AccumulateTimeDelta(                                        \
+            Telemetry::HTTP_##prefix##_OPEN_TO_DISPATCH,                       \
+            asyncOpen, dispatchStart);                                         \
+    }                                                                          \
+                                                                               \
+    if (!requestEnd.IsNull() && !responseStart.IsNull()) {                     \
+        Telemetry::AccumulateTimeDelta(                                        \
+            Telemetry::HTTP_##prefix##_LAST_SENT_TO_FIRST_RECEIVED,            \
+            requestEnd, responseStart);                                        \
+    }                                                                          \
                                                                                \
     if (!requestStart.IsNull() && !responseEnd.IsNull()) {                     \
         Telemetry::AccumulateTimeDelta(                                        \
@@ -1107,6 +1128,8 @@ public:
     nsLoadGroupConnectionInfo();
 private:
     Atomic<uint32_t>       mBlockingTransactionCount;
+    // Updated on the socket thread, read from the main thread.
+    Atomic<uint64_t>       mTransferredBytes;
     nsAutoPtr<mozilla::net::SpdyPushCache> mSpdyCache;
 };
 
@@ -1114,6 +1137,7 @@ NS_IMPL_ISUPPORTS(nsLoadGroupConnectionInfo, nsILoadGroupConnectionInfo)
 
 nsLoadGroupConnectionInfo::nsLoadGroupConnectionInfo()
     : mBlockingTransactionCount(0)
+    , mTransferredBytes(0)
 {
 }
 
@@ -1141,6 +1165,21 @@ nsLoadGroupConnectionInfo::RemoveBlockingTransaction(uint32_t *_retval)
     return NS_OK;
 }
 
+NS_IMETHODIMP
+nsLoadGroupConnectionInfo::GetTransferredBytes(uint64_t *aTransferredBytes)
+{
+    NS_ENSURE_ARG_POINTER(aTransferredBytes);
+    *aTransferredBytes = mTransferredBytes;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+nsLoadGroupConnectionInfo::AddTransferredBytes(uint64_t aBytes)
+{
+    mTransferredBytes += aBytes;
+    return NS_OK;
+}
+
 /* [noscript] attribute SpdyPushCachePtr spdyPushCache; */
 NS_IMETHODIMP
 nsLoadGroupConnectionInfo::GetSpdyPushCache(mozilla::net::SpdyPushCache **aSpdyPushCache)
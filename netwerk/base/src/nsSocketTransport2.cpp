@@ -914,6 +914,8 @@ nsSocketTransport::InitWithConnectedSocket(PRFileDesc *fd, const NetAddr *addr)
     memcpy(&mNetAddr, addr, sizeof(NetAddr));
 
     mPollFlags = (PR_POLL_READ | PR_POLL_WRITE | PR_POLL_EXCEPT);
+    // a direct write is fine here: the transport is not attached yet, and
+    // attaching invalidates the service's cached poll timeout.
     mPollTimeout = mTimeouts[TIMEOUT_READ_WRITE];
     mState = STATE_TRANSFERRING;
     mNetAddrIsSet = true;
@@ -987,6 +989,18 @@ nsSocketTransport::SendStatus(nsresult status)
         sink->OnTransportStatus(this, status, progress, UINT64_MAX);
 }
 
+void
+nsSocketTransport::SetPollTimeout(uint16_t timeoutS)
+{
+    MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread, "wrong thread");
+
+    if (mPollTimeout == timeoutS)
+        return;
+
+    mPollTimeout = timeoutS;
+    mSocketTransportService->PollTimeoutChanged();
+}
+
 nsresult
 nsSocketTransport::ResolveHost()
 {
@@ -1348,7 +1362,7 @@ nsSocketTransport::InitiateSocket()
 
     SOCKET_LOG(("  advancing to STATE_CONNECTING\n"));
     mState = STATE_CONNECTING;
-    mPollTimeout = mTimeouts[TIMEOUT_CONNECT];
+    SetPollTimeout(mTimeouts[TIMEOUT_CONNECT]);
     SendStatus(NS_NET_STATUS_CONNECTING_TO);
 
 #if defined(PR_LOGGING)
@@ -1598,7 +1612,7 @@ nsSocketTransport::OnSocketConnected()
     SOCKET_LOG(("  advancing to STATE_TRANSFERRING\n"));
 
     mPollFlags = (PR_POLL_READ | PR_POLL_WRITE | PR_POLL_EXCEPT);
-    mPollTimeout = mTimeouts[TIMEOUT_READ_WRITE];
+    SetPollTimeout(mTimeouts[TIMEOUT_READ_WRITE]);
     mState = STATE_TRANSFERRING;
 
     // Set the mNetAddrIsSet flag only when state has reached TRANSFERRING
@@ -1785,8 +1799,8 @@ nsSocketTransport::OnSocketEvent(uint32_t type, nsresult status, nsISupports *pa
         break;
     case MSG_TIMEOUT_CHANGED:
         SOCKET_LOG(("  MSG_TIMEOUT_CHANGED\n"));
-        mPollTimeout = mTimeouts[(mState == STATE_TRANSFERRING)
-          ? TIMEOUT_READ_WRITE : TIMEOUT_CONNECT];
+        SetPollTimeout(mTimeouts[(mState == STATE_TRANSFERRING)
+          ? TIMEOUT_READ_WRITE : TIMEOUT_CONNECT]);
         break;
     default:
         SOCKET_LOG(("  unhandled event!\n"));
@@ -1832,7 +1846,7 @@ nsSocketTransport::OnSocketReady(PRFileDesc *fd, int16_t outFlags)
             mInput.OnSocketReady(NS_OK);
         }
         // Update poll timeout in case it was changed
-        mPollTimeout = mTimeouts[TIMEOUT_READ_WRITE];
+        SetPollTimeout(mTimeouts[TIMEOUT_READ_WRITE]);
     }
     else if (mState == STATE_CONNECTING) {
         PRStatus status = PR_ConnectContinue(fd, outFlags);
@@ -1854,7 +1868,7 @@ nsSocketTransport::OnSocketReady(PRFileDesc *fd, int16_t outFlags)
                 // Set up the select flags for connect...
                 mPollFlags = (PR_POLL_EXCEPT | PR_POLL_WRITE);
                 // Update poll timeout in case it was changed
-                mPollTimeout = mTimeouts[TIMEOUT_CONNECT];
+                SetPollTimeout(mTimeouts[TIMEOUT_CONNECT]);
             }
             //
             // The SOCKS proxy rejected our request. Find out why.
@@ -310,6 +310,9 @@ private:
     // socket methods (these can only be called on the socket thread):
 
     void     SendStatus(nsresult status);
+    // assigns mPollTimeout and lets the socket transport service know that
+    // its cached minimum poll timeout may no longer be valid.
+    void     SetPollTimeout(uint16_t timeoutS);
     nsresult ResolveHost();
     nsresult BuildSocket(PRFileDesc *&, bool &, bool &); 
     nsresult InitiateSocket();
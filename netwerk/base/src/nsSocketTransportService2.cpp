@@ -62,6 +62,8 @@ nsSocketTransportService::nsSocketTransportService()
     , mIdleCount(0)
     , mSentBytesCount(0)
     , mReceivedBytesCount(0)
+    , mMinTimeUntilTimeout(0)
+    , mMinTimeUntilTimeoutValid(false)
     , mSendBufferSize(0)
     , mKeepaliveIdleTimeS(600)
     , mKeepaliveRetryIntervalS(1)
@@ -240,6 +242,9 @@ nsSocketTransportService::AddToPollList(SocketContext *sock)
     mPollList[newSocketIndex + 1].in_flags = sock->mHandler->mPollFlags;
     mPollList[newSocketIndex + 1].out_flags = 0;
 
+    // the new socket's timeout may expire ahead of the cached bound.
+    mMinTimeUntilTimeoutValid = false;
+
     SOCKET_LOG(("  active=%u idle=%u\n", mActiveCount, mIdleCount));
     return NS_OK;
 }
@@ -358,25 +363,31 @@ nsSocketTransportService::PollTimeout()
     if (mActiveCount == 0)
         return NS_SOCKET_POLL_TIMEOUT;
 
-    // compute minimum time before any socket timeout expires.
-    uint32_t minR = UINT16_MAX;
-    for (uint32_t i=0; i<mActiveCount; ++i) {
-        const SocketContext &s = mActiveList[i];
-        // mPollTimeout could be less than mElapsedTime if setTimeout
-        // was called with a value smaller than mElapsedTime.
-        uint32_t r = (s.mElapsedTime < s.mHandler->mPollTimeout)
-          ? s.mHandler->mPollTimeout - s.mElapsedTime
-          : 0;
-        if (r < minR)
-            minR = r;
+    // compute minimum time before any socket timeout expires.  the cached
+    // value is a valid lower bound between rescans, so the active list only
+    // has to be walked after something could have moved a deadline closer.
+    if (!mMinTimeUntilTimeoutValid) {
+        uint32_t minR = UINT16_MAX;
+        for (uint32_t i=0; i<mActiveCount; ++i) {
+            const SocketContext &s = mActiveList[i];
+            // mPollTimeout could be less than mElapsedTime if setTimeout
+            // was called with a value smaller than mElapsedTime.
+            uint32_t r = (s.mElapsedTime < s.mHandler->mPollTimeout)
+              ? s.mHandler->mPollTimeout - s.mElapsedTime
+              : 0;
+            if (r < minR)
+                minR = r;
+        }
+        mMinTimeUntilTimeout = minR;
+        mMinTimeUntilTimeoutValid = true;
     }
     // nsASocketHandler defines UINT16_MAX as do not timeout
-    if (minR == UINT16_MAX) {
+    if (mMinTimeUntilTimeout == UINT16_MAX) {
         SOCKET_LOG(("poll timeout: none\n"));
         return NS_SOCKET_POLL_TIMEOUT;
     }
-    SOCKET_LOG(("poll timeout: %lu\n", minR));
-    return PR_SecondsToInterval(minR);
+    SOCKET_LOG(("poll timeout: %lu\n", mMinTimeUntilTimeout));
+    return PR_SecondsToInterval(mMinTimeUntilTimeout);
 }
 
 int32_t
@@ -400,6 +411,10 @@ nsSocketTransportService::Poll(bool wait, uint32_t *interval)
         else
             pollList = nullptr;
         pollTimeout = PR_MillisecondsToInterval(25);
+        // PollTimeout() was not consulted, so assume a timeout may already
+        // be due and make the next walk do full bookkeeping.
+        mMinTimeUntilTimeout = 0;
+        mMinTimeUntilTimeoutValid = false;
     }
 
     if (!wait)
@@ -417,6 +432,19 @@ nsSocketTransportService::Poll(bool wait, uint32_t *interval)
          PR_IntervalToMilliseconds(passedInterval))); 
 
     *interval = PR_IntervalToSeconds(passedInterval);
+
+    // Age the cached timeout bound by the time spent blocked in poll; once
+    // it is used up the next PollTimeout() call must rescan for the new
+    // earliest deadline.
+    if (mMinTimeUntilTimeoutValid && *interval &&
+        mMinTimeUntilTimeout != UINT16_MAX) {
+        if (*interval < mMinTimeUntilTimeout) {
+            mMinTimeUntilTimeout -= *interval;
+        } else {
+            mMinTimeUntilTimeout = 0;
+            mMinTimeUntilTimeoutValid = false;
+        }
+    }
     return rv;
 }
 
@@ -873,10 +901,25 @@ nsSocketTransportService::DoPollIteration(bool wait)
         //
         // service "active" sockets...
         //
+        // Once every socket the poll reported ready has been serviced, the
+        // rest of the walk can only be doing timeout bookkeeping.  If the
+        // poll did not block (so no elapsed time to account) and the
+        // earliest possible socket timeout has not been reached, stop
+        // walking early; with a large active list and a high event rate
+        // this is most of the iterations.
+        //
+        uint32_t readyCount = (n > 0) ? uint32_t(n) : 0;
+        if (readyCount && mPollList[0].fd && mPollList[0].out_flags != 0)
+            --readyCount;
+        bool canSkipRemainder = (pollInterval == 0 && mMinTimeUntilTimeout > 0);
         for (i=0; i<int32_t(mActiveCount); ++i) {
+            if (readyCount == 0 && canSkipRemainder)
+                break;
             PRPollDesc &desc = mPollList[i+1];
             SocketContext &s = mActiveList[i];
             if (n > 0 && desc.out_flags != 0) {
+                if (readyCount)
+                    --readyCount;
                 s.mElapsedTime = 0;
                 s.mHandler->OnSocketReady(desc.fd, desc.out_flags);
             }
@@ -893,9 +936,12 @@ nsSocketTransportService::DoPollIteration(bool wait)
                     s.mElapsedTime = UINT16_MAX;
                 else
                     s.mElapsedTime += uint16_t(pollInterval);
-                // check for timeout expiration 
+                // check for timeout expiration
                 if (s.mElapsedTime >= s.mHandler->mPollTimeout) {
                     s.mElapsedTime = 0;
+                    // the socket's deadline has been pushed back out, so the
+                    // cached bound no longer reflects the earliest one.
+                    mMinTimeUntilTimeoutValid = false;
                     s.mHandler->OnSocketReady(desc.fd, -1);
                 }
             }
@@ -101,6 +101,11 @@ public:
 
     // Returns true if keepalives are enabled in prefs.
     bool IsKeepaliveEnabled() { return mKeepaliveEnabledPref; }
+
+    // Called on the socket thread when a handler has changed its
+    // mPollTimeout, so the cached minimum time until the next socket timeout
+    // may no longer bound the earliest expiration from below.
+    void PollTimeoutChanged() { mMinTimeUntilTimeoutValid = false; }
 protected:
 
     virtual ~nsSocketTransportService();
@@ -199,6 +204,23 @@ private:
                                              // interval indicates the poll
                                              // duration in seconds.
 
+    // Seconds until the earliest active socket timeout can expire, as
+    // computed by PollTimeout() ahead of the last poll.  UINT16_MAX means no
+    // active socket has a timeout enabled; 0 means a timeout may already be
+    // due (or that PollTimeout() was not consulted for the last poll).  Used
+    // by DoPollIteration to stop walking the active list early once all
+    // sockets the poll reported ready have been serviced.
+    uint32_t mMinTimeUntilTimeout;
+
+    // Whether mMinTimeUntilTimeout still bounds the earliest possible socket
+    // timeout from below.  The bound stays valid across poll iterations
+    // (aged by the time spent blocked in poll) until a socket joins the
+    // active list, a handler changes its poll timeout, or a timeout fires,
+    // so PollTimeout() only rescans the active list when one of those
+    // happened.  With thousands of mostly idle sockets this turns the
+    // per-wakeup timeout bookkeeping from O(n) into O(1).
+    bool mMinTimeUntilTimeoutValid;
+
     //-------------------------------------------------------------------------
     // pending socket queue - see NotifyWhenCanAttachSocket
     //-------------------------------------------------------------------------
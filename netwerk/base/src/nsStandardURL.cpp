@@ -1144,6 +1144,13 @@ nsStandardURL::SetSpec(const nsACString &input)
     if (!spec || !*spec)
         return NS_ERROR_MALFORMED_URI;
 
+    // Callers frequently set a spec matching the current one (e.g. when
+    // rebuilding a channel's URI from its own spec).  mSpec is already the
+    // normalized form and parsing is deterministic, so a byte-identical
+    // input cannot change any state; skip the re-parse.
+    if (mScheme.mLen >= 0 && mSpec.Equals(flat))
+        return NS_OK;
+
     // Make a backup of the curent URL
     nsStandardURL prevURL(false,false);
     prevURL.CopyMembers(this, eHonorRef);
@@ -1741,6 +1748,15 @@ nsStandardURL::EqualsInternal(nsIURI *unknownOther,
         return NS_OK;
     }
 
+    // Identical specs always mean identical URIs.  This is the common case
+    // for a URI compared against its own clone, and clones share the spec's
+    // string buffer, so check for pointer identity before comparing the
+    // characters.
+    if (mSpec.get() == other->mSpec.get() || mSpec.Equals(other->mSpec)) {
+        *result = true;
+        return NS_OK;
+    }
+
     // Next check parts of a URI that, if different, automatically make the
     // URIs different
     if (!SegmentIs(mScheme, other->mSpec.get(), other->mScheme) ||
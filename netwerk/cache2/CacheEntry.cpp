@@ -164,6 +164,7 @@ CacheEntry::CacheEntry(const nsACString& aStorageID,
                        bool aUseDisk)
 : mFrecency(0)
 , mSortingExpirationTime(uint32_t(-1))
+, mRetentionClass(nsICacheStorage::RETAIN_NORMAL)
 , mLock("CacheEntry")
 , mFileStatus(NS_ERROR_NOT_INITIALIZED)
 , mURI(aURI)
@@ -445,6 +446,20 @@ NS_IMETHODIMP CacheEntry::OnFileReady(nsresult aResult, bool aIsNew)
     // mFrecency is held in a double to increase computance precision.
     // It is ok to persist frecency only as a uint32 with some math involved.
     mFrecency = INT2FRECENCY(frecency);
+
+    mFile->GetRetentionClass(&mRetentionClass);
+  }
+
+  if (NS_SUCCEEDED(mFileStatus)) {
+    // Apply any retention class configured in bulk for this URL's prefix.
+    // This way also entries cached before the configuration happened pick
+    // the class up on their next use.
+    uint32_t retentionClass;
+    if (mService->RetentionClassForURI(mURI, &retentionClass) &&
+        retentionClass != mRetentionClass) {
+      mRetentionClass = retentionClass;
+      mFile->SetRetentionClass(retentionClass);
+    }
   }
 
   InvokeCallbacks();
@@ -1208,6 +1223,26 @@ NS_IMETHODIMP CacheEntry::SetSecurityInfo(nsISupports *aSecurityInfo)
   return NS_OK;
 }
 
+NS_IMETHODIMP CacheEntry::GetRetentionClass(uint32_t *aRetentionClass)
+{
+  *aRetentionClass = mRetentionClass;
+  return NS_OK;
+}
+NS_IMETHODIMP CacheEntry::SetRetentionClass(uint32_t aRetentionClass)
+{
+  if (aRetentionClass > nsICacheStorage::RETAIN_PINNED) {
+    return NS_ERROR_INVALID_ARG;
+  }
+
+  NS_ENSURE_SUCCESS(mFileStatus, NS_ERROR_NOT_AVAILABLE);
+
+  nsresult rv = mFile->SetRetentionClass(aRetentionClass);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  mRetentionClass = aRetentionClass;
+  return NS_OK;
+}
+
 NS_IMETHODIMP CacheEntry::GetStorageDataSize(uint32_t *aStorageDataSize)
 {
   NS_ENSURE_ARG(aStorageDataSize);
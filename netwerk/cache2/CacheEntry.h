@@ -80,6 +80,8 @@ public:
   // TODO make these inline
   double GetFrecency() const;
   uint32_t GetExpirationTime() const;
+  // No need for thread safety over mRetentionClass, see mFrecency.
+  uint32_t GetRetentionClass() const { return mRetentionClass; }
   uint32_t UseCount() const { return mUseCount; }
 
   bool IsRegistered() const;
@@ -115,6 +117,10 @@ public:
   double mFrecency;
   uint32_t mSortingExpirationTime;
 
+  // One of the nsICacheStorage::RETAIN_* constants, mirrored from the entry
+  // file when it's ready.  Influences the eviction order of the entry.
+  uint32_t mRetentionClass;
+
   // Memory reporting
   size_t SizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
   size_t SizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
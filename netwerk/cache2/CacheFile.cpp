@@ -8,12 +8,15 @@
 #include "CacheFileChunk.h"
 #include "CacheFileInputStream.h"
 #include "CacheFileOutputStream.h"
+#include "CacheFileUtils.h"
 #include "nsThreadUtils.h"
+#include "nsPrintfCString.h"
 #include "mozilla/DebugOnly.h"
 #include <algorithm>
 #include "nsComponentManagerUtils.h"
 #include "nsProxyRelease.h"
 #include "mozilla/Telemetry.h"
+#include "plstr.h"
 
 // When CACHE_CHUNKS is defined we always cache unused chunks in mCacheChunks.
 // When it is not defined, we always release the chunks ASAP, i.e. we cache
@@ -188,6 +191,7 @@ CacheFile::CacheFile()
   , mDataIsDirty(false)
   , mWritingMetadata(false)
   , mPreloadWithoutInputStreams(true)
+  , mCompressChunks(-1)
   , mPreloadChunkCount(0)
   , mStatus(NS_OK)
   , mDataSize(-1)
@@ -353,8 +357,10 @@ CacheFile::OnChunkWritten(nsresult aResult, CacheFileChunk *aChunk)
   }
 
   if (NS_SUCCEEDED(aResult) && !aChunk->IsDirty()) {
-    // update hash value in metadata
+    // update hash value and on-disk info in metadata
     mMetadata->SetHash(aChunk->Index(), aChunk->Hash());
+    mMetadata->SetChunkDiskInfo(aChunk->Index(), aChunk->DiskCodec(),
+                                aChunk->DiskSize());
   }
 
   // notify listeners if there is any
@@ -908,7 +914,8 @@ CacheFile::SetExpirationTime(uint32_t aExpirationTime)
   PostWriteTimer();
 
   if (mHandle && !mHandle->IsDoomed())
-    CacheFileIOManager::UpdateIndexEntry(mHandle, nullptr, &aExpirationTime);
+    CacheFileIOManager::UpdateIndexEntry(mHandle, nullptr, &aExpirationTime,
+                                         nullptr);
 
   return mMetadata->SetExpirationTime(aExpirationTime);
 }
@@ -933,7 +940,8 @@ CacheFile::SetFrecency(uint32_t aFrecency)
   PostWriteTimer();
 
   if (mHandle && !mHandle->IsDoomed())
-    CacheFileIOManager::UpdateIndexEntry(mHandle, &aFrecency, nullptr);
+    CacheFileIOManager::UpdateIndexEntry(mHandle, &aFrecency, nullptr,
+                                         nullptr);
 
   return mMetadata->SetFrecency(aFrecency);
 }
@@ -948,6 +956,37 @@ CacheFile::GetFrecency(uint32_t *_retval)
   return mMetadata->GetFrecency(_retval);
 }
 
+nsresult
+CacheFile::SetRetentionClass(uint32_t aRetentionClass)
+{
+  CacheFileAutoLock lock(this);
+  MOZ_ASSERT(mMetadata);
+  NS_ENSURE_TRUE(mMetadata, NS_ERROR_UNEXPECTED);
+
+  PostWriteTimer();
+
+  if (mHandle && !mHandle->IsDoomed())
+    CacheFileIOManager::UpdateIndexEntry(mHandle, nullptr, nullptr,
+                                         &aRetentionClass);
+
+  // The retention class is kept as a metadata element so that neither the
+  // metadata nor the index on-disk format has to change.
+  return mMetadata->SetElement(CacheFileUtils::kRetentionClassKey,
+                               nsPrintfCString("%u", aRetentionClass).get());
+}
+
+nsresult
+CacheFile::GetRetentionClass(uint32_t *_retval)
+{
+  CacheFileAutoLock lock(this);
+  MOZ_ASSERT(mMetadata);
+  NS_ENSURE_TRUE(mMetadata, NS_ERROR_UNEXPECTED);
+
+  *_retval = CacheFileUtils::ParseRetentionClass(
+    mMetadata->GetElement(CacheFileUtils::kRetentionClassKey));
+  return NS_OK;
+}
+
 nsresult
 CacheFile::GetLastModified(uint32_t *_retval)
 {
@@ -1132,6 +1171,8 @@ CacheFile::GetChunkLocked(uint32_t aIndex, ECallerType aCaller,
     // Read the chunk from the disk
     rv = chunk->Read(mHandle, std::min(static_cast<uint32_t>(mDataSize - off),
                      static_cast<uint32_t>(kChunkSize)),
+                     mMetadata->GetChunkDiskSize(aIndex),
+                     mMetadata->GetChunkCodec(aIndex),
                      mMetadata->GetHash(aIndex), this);
     if (NS_WARN_IF(NS_FAILED(rv))) {
       RemoveChunkInternal(chunk, false);
@@ -1339,6 +1380,60 @@ CacheFile::MustKeepCachedChunk(uint32_t aIndex)
   return false;
 }
 
+namespace { // anon
+
+// Returns true when the given Content-Type header value identifies a
+// response that typically compresses well, i.e. textual data. Binary formats
+// (images, audio, video, archives) are usually compressed already and
+// attempting to compress their chunks would only waste CPU cycles.
+bool
+IsCompressibleContentType(const char *aContentType)
+{
+  // Limit the search to the header line, the value is terminated by CRLF.
+  uint32_t len = strcspn(aContentType, "\r\n");
+
+  while (len && *aContentType == ' ') {
+    aContentType++;
+    len--;
+  }
+
+  return (len >= 5 && PL_strncasecmp(aContentType, "text/", 5) == 0) ||
+         PL_strncasestr(aContentType, "javascript", len) ||
+         PL_strncasestr(aContentType, "json", len) ||
+         PL_strncasestr(aContentType, "xml", len) ||
+         PL_strncasestr(aContentType, "svg", len);
+}
+
+} // anon
+
+uint8_t
+CacheFile::ChunkCompressionCodec()
+{
+  AssertOwnsLock();
+
+  if (mCompressChunks == -1) {
+    if (mMemoryOnly || !CacheObserver::CompressionLevel()) {
+      mCompressChunks = 0;
+    } else {
+      // Decide according to the content type of the cached response. The
+      // response head is stored by nsHttpChannel before any data is written,
+      // but don't latch the decision while it is missing (e.g. a non-HTTP
+      // consumer) so that chunks written after it appears can still be
+      // compressed.
+      const char *head = mMetadata->GetElement("response-head");
+      if (!head) {
+        return CHUNK_COMPRESSION_NONE;
+      }
+
+      const char *contentType = PL_strcasestr(head, "Content-Type:");
+      mCompressChunks =
+        (contentType && IsCompressibleContentType(contentType + 13)) ? 1 : 0;
+    }
+  }
+
+  return mCompressChunks ? CHUNK_COMPRESSION_LZ4 : CHUNK_COMPRESSION_NONE;
+}
+
 nsresult
 CacheFile::DeactivateChunk(CacheFileChunk *aChunk)
 {
@@ -1971,7 +2066,11 @@ CacheFile::InitIndexEntry()
   uint32_t frecency;
   mMetadata->GetFrecency(&frecency);
 
-  rv = CacheFileIOManager::UpdateIndexEntry(mHandle, &frecency, &expTime);
+  uint32_t retentionClass = CacheFileUtils::ParseRetentionClass(
+    mMetadata->GetElement(CacheFileUtils::kRetentionClassKey));
+
+  rv = CacheFileIOManager::UpdateIndexEntry(mHandle, &frecency, &expTime,
+                                            &retentionClass);
   NS_ENSURE_SUCCESS(rv, rv);
 
   return NS_OK;
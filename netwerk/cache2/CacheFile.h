@@ -92,6 +92,8 @@ public:
   nsresult GetExpirationTime(uint32_t *_retval);
   nsresult SetFrecency(uint32_t aFrecency);
   nsresult GetFrecency(uint32_t *_retval);
+  nsresult SetRetentionClass(uint32_t aRetentionClass);
+  nsresult GetRetentionClass(uint32_t *_retval);
   nsresult GetLastModified(uint32_t *_retval);
   nsresult GetLastFetched(uint32_t *_retval);
   nsresult GetFetchCount(uint32_t *_retval);
@@ -142,6 +144,10 @@ private:
   bool     ShouldCacheChunk(uint32_t aIndex);
   bool     MustKeepCachedChunk(uint32_t aIndex);
 
+  // Returns the codec that should be used for newly written chunks, based on
+  // the content type of the cached response. See ChunkCompressionCodec enum.
+  uint8_t  ChunkCompressionCodec();
+
   nsresult DeactivateChunk(CacheFileChunk *aChunk);
   void     RemoveChunkInternal(CacheFileChunk *aChunk, bool aCacheChunk);
 
@@ -199,6 +205,8 @@ private:
   bool           mDataIsDirty;
   bool           mWritingMetadata;
   bool           mPreloadWithoutInputStreams;
+  int8_t         mCompressChunks; // -1 = not decided yet, 0 = don't compress,
+                                  // 1 = compress; see ChunkCompressionCodec()
   uint32_t       mPreloadChunkCount;
   nsresult       mStatus;
   int64_t        mDataSize;
@@ -7,6 +7,7 @@
 
 #include "CacheFile.h"
 #include "nsThreadUtils.h"
+#include "mozilla/Compression.h"
 
 namespace mozilla {
 namespace net {
@@ -120,6 +121,10 @@ CacheFileChunk::CacheFileChunk(CacheFile *aFile, uint32_t aIndex,
   , mRWBuf(nullptr)
   , mRWBufSize(0)
   , mReadHash(0)
+  , mDiskSize(0)
+  , mCodec(CHUNK_COMPRESSION_NONE)
+  , mWriteHash(0)
+  , mHasWriteHash(false)
   , mFile(aFile)
 {
   LOG(("CacheFileChunk::CacheFileChunk() [this=%p, index=%u, initByWriter=%d]",
@@ -166,13 +171,15 @@ CacheFileChunk::InitNew()
 
 nsresult
 CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
+                     uint32_t aDiskSize, uint8_t aCodec,
                      CacheHash::Hash16_t aHash,
                      CacheFileChunkListener *aCallback)
 {
   mFile->AssertOwnsLock();
 
-  LOG(("CacheFileChunk::Read() [this=%p, handle=%p, len=%d, listener=%p]",
-       this, aHandle, aLen, aCallback));
+  LOG(("CacheFileChunk::Read() [this=%p, handle=%p, len=%d, diskSize=%d, "
+       "codec=%d, listener=%p]", this, aHandle, aLen, aDiskSize, aCodec,
+       aCallback));
 
   MOZ_ASSERT(mState == INITIAL);
   MOZ_ASSERT(NS_SUCCEEDED(mStatus));
@@ -184,10 +191,23 @@ CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
 
   mState = READING;
 
-  if (CanAllocate(aLen)) {
-    mRWBuf = static_cast<char *>(moz_malloc(aLen));
+  if (aCodec == CHUNK_COMPRESSION_NONE) {
+    // Uncompressed chunks occupy exactly their data size on the disk.
+    aDiskSize = aLen;
+  } else if (aCodec != CHUNK_COMPRESSION_LZ4 ||
+             aDiskSize == 0 || aDiskSize >= aLen) {
+    // Unknown codec or nonsensical disk size, the metadata is corrupted.
+    // A compressed chunk is always strictly smaller than the raw data.
+    LOG(("CacheFileChunk::Read() - Invalid chunk disk info! [this=%p, "
+         "codec=%d, diskSize=%d, len=%d]", this, aCodec, aDiskSize, aLen));
+    SetError(NS_ERROR_FILE_CORRUPTED);
+    return mStatus;
+  }
+
+  if (CanAllocate(aDiskSize)) {
+    mRWBuf = static_cast<char *>(moz_malloc(aDiskSize));
     if (mRWBuf) {
-      mRWBufSize = aLen;
+      mRWBufSize = aDiskSize;
       ChunkAllocationChanged();
     }
   }
@@ -200,7 +220,7 @@ CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
 
   DoMemoryReport(MemorySize());
 
-  rv = CacheFileIOManager::Read(aHandle, mIndex * kChunkSize, mRWBuf, aLen,
+  rv = CacheFileIOManager::Read(aHandle, mIndex * kChunkSize, mRWBuf, aDiskSize,
                                 this);
   if (NS_WARN_IF(NS_FAILED(rv))) {
     rv = mIndex ? NS_ERROR_FILE_CORRUPTED : NS_ERROR_FILE_NOT_FOUND;
@@ -209,6 +229,8 @@ CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
     mListener = aCallback;
     mDataSize = aLen;
     mReadHash = aHash;
+    mDiskSize = aDiskSize;
+    mCodec = aCodec;
   }
 
   return rv;
@@ -232,13 +254,50 @@ CacheFileChunk::Write(CacheFileHandle *aHandle,
   nsresult rv;
 
   mState = WRITING;
-  mRWBuf = mBuf;
-  mRWBufSize = mBufSize;
-  mBuf = nullptr;
-  mBufSize = 0;
+  mDiskSize = mDataSize;
+  mCodec = CHUNK_COMPRESSION_NONE;
+  mHasWriteHash = false;
+
+  // Try to compress the chunk when the entry's content looks compressible.
+  // The compressed representation goes to mRWBuf while mBuf keeps the raw
+  // data for readers; if compression doesn't pay off we write the raw buffer
+  // as before. We require at least 1/16 saving so that a barely compressible
+  // chunk doesn't cost a decompression on every read.
+  if (mDataSize >= kMinBufSize &&
+      mFile->ChunkCompressionCodec() == CHUNK_COMPRESSION_LZ4 &&
+      CanAllocate(mDataSize)) {
+    char *compBuf = static_cast<char *>(moz_malloc(mDataSize));
+    if (compBuf) {
+      size_t compSize = Compression::LZ4::compressLimitedOutput(
+                          mBuf, mDataSize, compBuf,
+                          mDataSize - mDataSize / 16);
+      if (compSize) {
+        LOG(("CacheFileChunk::Write() - Writing compressed chunk [this=%p, "
+             "dataSize=%d, diskSize=%u]", this, mDataSize,
+             static_cast<uint32_t>(compSize)));
+
+        mRWBuf = compBuf;
+        mRWBufSize = mDataSize;
+        mDiskSize = compSize;
+        mCodec = CHUNK_COMPRESSION_LZ4;
+        mWriteHash = CacheHash::Hash16(mRWBuf, mDiskSize);
+        mHasWriteHash = true;
+        ChunkAllocationChanged();
+      } else {
+        free(compBuf);
+      }
+    }
+  }
+
+  if (mCodec == CHUNK_COMPRESSION_NONE) {
+    mRWBuf = mBuf;
+    mRWBufSize = mBufSize;
+    mBuf = nullptr;
+    mBufSize = 0;
+  }
 
   rv = CacheFileIOManager::Write(aHandle, mIndex * kChunkSize, mRWBuf,
-                                 mDataSize, false, this);
+                                 mDiskSize, false, this);
   if (NS_WARN_IF(NS_FAILED(rv))) {
     SetError(rv);
   } else {
@@ -354,6 +413,13 @@ CacheFileChunk::Hash()
   MOZ_ASSERT(!mListener);
   MOZ_ASSERT(IsReady());
 
+  // A chunk written compressed must report the hash of the bytes that are
+  // actually on the disk. Write() computes it since the compressed buffer is
+  // released when the write finishes.
+  if (mHasWriteHash) {
+    return mWriteHash;
+  }
+
   return CacheHash::Hash16(mDataSize ? BufForReading() : nullptr, mDataSize);
 }
 
@@ -364,6 +430,20 @@ CacheFileChunk::DataSize()
   return mDataSize;
 }
 
+uint32_t
+CacheFileChunk::DiskSize()
+{
+  mFile->AssertOwnsLock();
+  return mDiskSize;
+}
+
+uint8_t
+CacheFileChunk::DiskCodec()
+{
+  mFile->AssertOwnsLock();
+  return mCodec;
+}
+
 void
 CacheFileChunk::UpdateDataSize(uint32_t aOffset, uint32_t aLen, bool aEOF)
 {
@@ -381,6 +461,7 @@ CacheFileChunk::UpdateDataSize(uint32_t aOffset, uint32_t aLen, bool aEOF)
        this, aOffset, aLen, aEOF));
 
   mIsDirty = true;
+  mHasWriteHash = false; // the on-disk representation is outdated now
 
   int64_t fileSize = kChunkSize * mIndex + aOffset + aLen;
   bool notify = false;
@@ -482,6 +563,8 @@ CacheFileChunk::OnDataRead(CacheFileHandle *aHandle, char *aBuf,
     MOZ_ASSERT(mListener);
 
     if (NS_SUCCEEDED(aResult)) {
+      // The hash in the metadata covers the on-disk representation, i.e. the
+      // compressed bytes when the chunk was written compressed.
       CacheHash::Hash16_t hash = CacheHash::Hash16(mRWBuf, mRWBufSize);
       if (hash != mReadHash) {
         LOG(("CacheFileChunk::OnDataRead() - Hash mismatch! Hash of the data is"
@@ -489,72 +572,102 @@ CacheFileChunk::OnDataRead(CacheFileHandle *aHandle, char *aBuf,
              hash, mReadHash, this, mIndex));
         aResult = NS_ERROR_FILE_CORRUPTED;
       }
-      else {
-        if (!mBuf) {
-          // Just swap the buffers if we don't have mBuf yet
-          MOZ_ASSERT(mDataSize == mRWBufSize);
+    }
+
+    if (NS_SUCCEEDED(aResult) && mCodec != CHUNK_COMPRESSION_NONE) {
+      // Inflate the chunk back to its raw form before merging it with any new
+      // data and publishing it to the streams.
+      char *rawBuf = nullptr;
+      if (CanAllocate(mDataSize)) {
+        rawBuf = static_cast<char *>(moz_malloc(mDataSize));
+      }
+      if (!rawBuf) {
+        aResult = NS_ERROR_OUT_OF_MEMORY;
+      } else {
+        size_t rawSize = 0;
+        if (!Compression::LZ4::decompress(mRWBuf, mRWBufSize, rawBuf,
+                                          mDataSize, &rawSize) ||
+            rawSize != mDataSize) {
+          LOG(("CacheFileChunk::OnDataRead() - Failed to decompress chunk! "
+               "[this=%p, idx=%d, diskSize=%d, dataSize=%d]",
+               this, mIndex, mRWBufSize, mDataSize));
+          free(rawBuf);
+          aResult = NS_ERROR_FILE_CORRUPTED;
+        } else {
+          free(mRWBuf);
+          mRWBuf = rawBuf;
+          mRWBufSize = mDataSize;
+          mCodec = CHUNK_COMPRESSION_NONE;
+          ChunkAllocationChanged();
+        }
+      }
+    }
+
+    if (NS_SUCCEEDED(aResult)) {
+      if (!mBuf) {
+        // Just swap the buffers if we don't have mBuf yet
+        MOZ_ASSERT(mDataSize == mRWBufSize);
+        mBuf = mRWBuf;
+        mBufSize = mRWBufSize;
+        mRWBuf = nullptr;
+        mRWBufSize = 0;
+      } else {
+        LOG(("CacheFileChunk::OnDataRead() - Merging buffers. [this=%p]",
+             this));
+
+        // Merge data with write buffer
+        if (mRWBufSize >= mBufSize) {
+          // The new data will fit into the buffer that contains data read
+          // from the disk. Simply copy the valid pieces.
+          mValidityMap.Log();
+          for (uint32_t i = 0; i < mValidityMap.Length(); i++) {
+            if (mValidityMap[i].Offset() + mValidityMap[i].Len() > mBufSize) {
+              MOZ_CRASH("Unexpected error in validity map!");
+            }
+            memcpy(mRWBuf + mValidityMap[i].Offset(),
+                   mBuf + mValidityMap[i].Offset(), mValidityMap[i].Len());
+          }
+          mValidityMap.Clear();
+
+          free(mBuf);
           mBuf = mRWBuf;
           mBufSize = mRWBufSize;
           mRWBuf = nullptr;
           mRWBufSize = 0;
+          ChunkAllocationChanged();
         } else {
-          LOG(("CacheFileChunk::OnDataRead() - Merging buffers. [this=%p]",
-               this));
-
-          // Merge data with write buffer
-          if (mRWBufSize >= mBufSize) {
-            // The new data will fit into the buffer that contains data read
-            // from the disk. Simply copy the valid pieces.
-            mValidityMap.Log();
-            for (uint32_t i = 0; i < mValidityMap.Length(); i++) {
-              if (mValidityMap[i].Offset() + mValidityMap[i].Len() > mBufSize) {
+          // Buffer holding the new data is larger. Use it as the destination
+          // buffer to avoid reallocating mRWBuf. We need to copy those pieces
+          // from mRWBuf which are not valid in mBuf.
+          uint32_t invalidOffset = 0;
+          uint32_t invalidLength;
+          mValidityMap.Log();
+          for (uint32_t i = 0; i < mValidityMap.Length(); i++) {
+            MOZ_ASSERT(invalidOffset <= mValidityMap[i].Offset());
+            invalidLength = mValidityMap[i].Offset() - invalidOffset;
+            if (invalidLength > 0) {
+              if (invalidOffset + invalidLength > mRWBufSize) {
                 MOZ_CRASH("Unexpected error in validity map!");
               }
-              memcpy(mRWBuf + mValidityMap[i].Offset(),
-                     mBuf + mValidityMap[i].Offset(), mValidityMap[i].Len());
-            }
-            mValidityMap.Clear();
-
-            free(mBuf);
-            mBuf = mRWBuf;
-            mBufSize = mRWBufSize;
-            mRWBuf = nullptr;
-            mRWBufSize = 0;
-            ChunkAllocationChanged();
-          } else {
-            // Buffer holding the new data is larger. Use it as the destination
-            // buffer to avoid reallocating mRWBuf. We need to copy those pieces
-            // from mRWBuf which are not valid in mBuf.
-            uint32_t invalidOffset = 0;
-            uint32_t invalidLength;
-            mValidityMap.Log();
-            for (uint32_t i = 0; i < mValidityMap.Length(); i++) {
-              MOZ_ASSERT(invalidOffset <= mValidityMap[i].Offset());
-              invalidLength = mValidityMap[i].Offset() - invalidOffset;
-              if (invalidLength > 0) {
-                if (invalidOffset + invalidLength > mRWBufSize) {
-                  MOZ_CRASH("Unexpected error in validity map!");
-                }
-                memcpy(mBuf + invalidOffset, mRWBuf + invalidOffset,
-                       invalidLength);
-              }
-              invalidOffset = mValidityMap[i].Offset() + mValidityMap[i].Len();
-            }
-            if (invalidOffset < mRWBufSize) {
-              invalidLength = mRWBufSize - invalidOffset;
               memcpy(mBuf + invalidOffset, mRWBuf + invalidOffset,
                      invalidLength);
             }
-            mValidityMap.Clear();
-
-            free(mRWBuf);
-            mRWBuf = nullptr;
-            mRWBufSize = 0;
-            ChunkAllocationChanged();
+            invalidOffset = mValidityMap[i].Offset() + mValidityMap[i].Len();
+          }
+          if (invalidOffset < mRWBufSize) {
+            invalidLength = mRWBufSize - invalidOffset;
+            memcpy(mBuf + invalidOffset, mRWBuf + invalidOffset,
+                   invalidLength);
           }
+          mValidityMap.Clear();
 
-          DoMemoryReport(MemorySize());
+          free(mRWBuf);
+          mRWBuf = nullptr;
+          mRWBufSize = 0;
+          ChunkAllocationChanged();
         }
+
+        DoMemoryReport(MemorySize());
       }
     }
 
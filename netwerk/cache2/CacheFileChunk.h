@@ -18,6 +18,17 @@ namespace net {
 #define kChunkSize        (256 * 1024)
 #define kEmptyChunkHash   0x1826
 
+// On-disk representation of a chunk. The codec is stored per chunk in the
+// metadata (see CacheFileMetadata::SetChunkDiskInfo) so that a new codec can
+// be introduced without invalidating entries written with an older one.
+// A chunk is stored compressed only when the compressed representation is
+// smaller than the raw data, so the chunk always fits its kChunkSize slot
+// and random access stays O(1).
+enum ChunkCompressionCodec {
+  CHUNK_COMPRESSION_NONE = 0,
+  CHUNK_COMPRESSION_LZ4  = 1
+};
+
 class CacheFileChunk;
 class CacheFile;
 
@@ -74,6 +85,7 @@ public:
 
   void     InitNew();
   nsresult Read(CacheFileHandle *aHandle, uint32_t aLen,
+                uint32_t aDiskSize, uint8_t aCodec,
                 CacheHash::Hash16_t aHash,
                 CacheFileChunkListener *aCallback);
   nsresult Write(CacheFileHandle *aHandle, CacheFileChunkListener *aCallback);
@@ -84,6 +96,8 @@ public:
   uint32_t            Index();
   CacheHash::Hash16_t Hash();
   uint32_t            DataSize();
+  uint32_t            DiskSize();
+  uint8_t             DiskCodec();
   void                UpdateDataSize(uint32_t aOffset, uint32_t aLen,
                                      bool aEOF);
 
@@ -150,6 +164,17 @@ private:
   uint32_t            mRWBufSize;
   CacheHash::Hash16_t mReadHash;
 
+  // On-disk representation of the chunk (see ChunkCompressionCodec). Set by
+  // Read() from the metadata and by Write() when the chunk is compressed.
+  uint32_t            mDiskSize;
+  uint8_t             mCodec;
+
+  // Hash of the bytes written to the disk by the last Write(). It is needed
+  // when the chunk was written compressed since the compressed buffer is
+  // released once the write finishes, so Hash() cannot recompute it.
+  CacheHash::Hash16_t mWriteHash;
+  bool                mHasWriteHash;
+
   nsRefPtr<CacheFile>              mFile; // is null if chunk is cached to
                                           // prevent reference cycles
   nsCOMPtr<CacheFileChunkListener> mListener;
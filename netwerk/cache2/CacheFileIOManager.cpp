@@ -969,7 +969,8 @@ public:
     // parsing the entry file, but we must set the filesize here since nobody is
     // going to set it if there is no write to the file.
     uint32_t sizeInK = mHandle->FileSizeInK();
-    CacheIndex::UpdateEntry(mHandle->Hash(), nullptr, nullptr, &sizeInK);
+    CacheIndex::UpdateEntry(mHandle->Hash(), nullptr, nullptr, nullptr,
+                            &sizeInK);
 
     return NS_OK;
   }
@@ -984,10 +985,12 @@ protected:
 class UpdateIndexEntryEvent : public nsRunnable {
 public:
   UpdateIndexEntryEvent(CacheFileHandle *aHandle, const uint32_t *aFrecency,
-                        const uint32_t *aExpirationTime)
+                        const uint32_t *aExpirationTime,
+                        const uint32_t *aRetentionClass)
     : mHandle(aHandle)
     , mHasFrecency(false)
     , mHasExpirationTime(false)
+    , mHasRetentionClass(false)
   {
     MOZ_COUNT_CTOR(UpdateIndexEntryEvent);
     if (aFrecency) {
@@ -998,6 +1001,10 @@ public:
       mHasExpirationTime = true;
       mExpirationTime = *aExpirationTime;
     }
+    if (aRetentionClass) {
+      mHasRetentionClass = true;
+      mRetentionClass = *aRetentionClass;
+    }
   }
 
 protected:
@@ -1016,6 +1023,7 @@ public:
     CacheIndex::UpdateEntry(mHandle->Hash(),
                             mHasFrecency ? &mFrecency : nullptr,
                             mHasExpirationTime ? &mExpirationTime : nullptr,
+                            mHasRetentionClass ? &mRetentionClass : nullptr,
                             nullptr);
     return NS_OK;
   }
@@ -1024,8 +1032,10 @@ protected:
   nsRefPtr<CacheFileHandle> mHandle;
   bool                      mHasFrecency;
   bool                      mHasExpirationTime;
+  bool                      mHasRetentionClass;
   uint32_t                  mFrecency;
   uint32_t                  mExpirationTime;
+  uint32_t                  mRetentionClass;
 };
 
 class MetadataWriteScheduleEvent : public nsRunnable
@@ -1942,7 +1952,8 @@ CacheFileIOManager::WriteInternal(CacheFileHandle *aHandle, int64_t aOffset,
 
     if (!aHandle->IsDoomed() && !aHandle->IsSpecialFile()) {
       uint32_t size = aHandle->FileSizeInK();
-      CacheIndex::UpdateEntry(aHandle->Hash(), nullptr, nullptr, &size);
+      CacheIndex::UpdateEntry(aHandle->Hash(), nullptr, nullptr, nullptr,
+                              &size);
       EvictIfOverLimitInternal();
     }
   }
@@ -2653,7 +2664,8 @@ CacheFileIOManager::OverLimitEvictionInternal()
       // failing on one entry forever.
       uint32_t frecency = 0;
       uint32_t expTime = nsICacheEntry::NO_EXPIRATION_TIME;
-      rv = CacheIndex::UpdateEntry(&hash, &frecency, &expTime, nullptr);
+      rv = CacheIndex::UpdateEntry(&hash, &frecency, &expTime, nullptr,
+                                   nullptr);
       NS_ENSURE_SUCCESS(rv, rv);
 
       consecutiveFailures++;
@@ -3278,12 +3290,14 @@ CacheFileIOManager::InitIndexEntry(CacheFileHandle *aHandle,
 nsresult
 CacheFileIOManager::UpdateIndexEntry(CacheFileHandle *aHandle,
                                      const uint32_t  *aFrecency,
-                                     const uint32_t  *aExpirationTime)
+                                     const uint32_t  *aExpirationTime,
+                                     const uint32_t  *aRetentionClass)
 {
   LOG(("CacheFileIOManager::UpdateIndexEntry() [handle=%p, frecency=%s, "
-       "expirationTime=%s]", aHandle,
+       "expirationTime=%s, retentionClass=%s]", aHandle,
        aFrecency ? nsPrintfCString("%u", *aFrecency).get() : "",
-       aExpirationTime ? nsPrintfCString("%u", *aExpirationTime).get() : ""));
+       aExpirationTime ? nsPrintfCString("%u", *aExpirationTime).get() : "",
+       aRetentionClass ? nsPrintfCString("%u", *aRetentionClass).get() : ""));
 
   nsresult rv;
   nsRefPtr<CacheFileIOManager> ioMan = gInstance;
@@ -3297,7 +3311,8 @@ CacheFileIOManager::UpdateIndexEntry(CacheFileHandle *aHandle,
   }
 
   nsRefPtr<UpdateIndexEntryEvent> ev =
-    new UpdateIndexEntryEvent(aHandle, aFrecency, aExpirationTime);
+    new UpdateIndexEntryEvent(aHandle, aFrecency, aExpirationTime,
+                              aRetentionClass);
   rv = ioMan->mIOThread->Dispatch(ev, CacheIOThread::WRITE);
   NS_ENSURE_SUCCESS(rv, rv);
 
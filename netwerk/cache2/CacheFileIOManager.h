@@ -269,7 +269,8 @@ public:
                                  bool             aInBrowser);
   static nsresult UpdateIndexEntry(CacheFileHandle *aHandle,
                                    const uint32_t  *aFrecency,
-                                   const uint32_t  *aExpirationTime);
+                                   const uint32_t  *aExpirationTime,
+                                   const uint32_t  *aRetentionClass);
 
   static nsresult UpdateIndexEntry();
 
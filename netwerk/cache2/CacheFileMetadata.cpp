@@ -25,7 +25,7 @@ namespace net {
 #define kMinMetadataRead 1024  // TODO find optimal value from telemetry
 #define kAlignSize       4096
 
-#define kCacheEntryVersion 1
+#define kCacheEntryVersion 2
 
 #define NOW_SECONDS() (uint32_t(PR_Now() / PR_USEC_PER_SEC))
 
@@ -35,6 +35,7 @@ CacheFileMetadata::CacheFileMetadata(CacheFileHandle *aHandle, const nsACString
   : CacheMemoryConsumer(NORMAL)
   , mHandle(aHandle)
   , mHashArray(nullptr)
+  , mChunkInfoArray(nullptr)
   , mHashArraySize(0)
   , mHashCount(0)
   , mOffset(-1)
@@ -65,6 +66,7 @@ CacheFileMetadata::CacheFileMetadata(bool aMemoryOnly, const nsACString &aKey)
   : CacheMemoryConsumer(aMemoryOnly ? MEMORY_ONLY : NORMAL)
   , mHandle(nullptr)
   , mHashArray(nullptr)
+  , mChunkInfoArray(nullptr)
   , mHashArraySize(0)
   , mHashCount(0)
   , mOffset(0)
@@ -96,6 +98,7 @@ CacheFileMetadata::CacheFileMetadata()
   : CacheMemoryConsumer(DONT_REPORT /* This is a helper class */)
   , mHandle(nullptr)
   , mHashArray(nullptr)
+  , mChunkInfoArray(nullptr)
   , mHashArraySize(0)
   , mHashCount(0)
   , mOffset(0)
@@ -124,6 +127,8 @@ CacheFileMetadata::~CacheFileMetadata()
   if (mHashArray) {
     free(mHashArray);
     mHashArray = nullptr;
+    free(mChunkInfoArray);
+    mChunkInfoArray = nullptr;
     mHashArraySize = 0;
   }
 
@@ -238,12 +243,15 @@ CacheFileMetadata::WriteMetadata(uint32_t aOffset,
 
   mWriteBuf = static_cast<char *>(moz_xmalloc(sizeof(uint32_t) +
                 mHashCount * sizeof(CacheHash::Hash16_t) +
+                mHashCount * sizeof(uint32_t) +
                 sizeof(CacheFileMetadataHeader) + mKey.Length() + 1 +
                 mElementsSize + sizeof(uint32_t)));
 
   char *p = mWriteBuf + sizeof(uint32_t);
   memcpy(p, mHashArray, mHashCount * sizeof(CacheHash::Hash16_t));
   p += mHashCount * sizeof(CacheHash::Hash16_t);
+  memcpy(p, mChunkInfoArray, mHashCount * sizeof(uint32_t));
+  p += mHashCount * sizeof(uint32_t);
   mMetaHdr.WriteToBuf(p);
   p += sizeof(CacheFileMetadataHeader);
   memcpy(p, mKey.get(), mKey.Length());
@@ -487,8 +495,18 @@ CacheFileMetadata::SetHash(uint32_t aIndex, CacheHash::Hash16_t aHash)
         mHashArraySize *= 2;
       mHashArray = static_cast<CacheHash::Hash16_t *>(
                      moz_xrealloc(mHashArray, mHashArraySize));
+      // The chunk info array grows in lockstep with the hash array.
+      mChunkInfoArray = static_cast<uint32_t *>(
+                          moz_xrealloc(mChunkInfoArray,
+                                       (mHashArraySize /
+                                        sizeof(CacheHash::Hash16_t)) *
+                                       sizeof(uint32_t)));
     }
 
+    // Uncompressed until SetChunkDiskInfo() says otherwise. This is correct
+    // for chunks that are never written via CacheFileChunk, e.g. the zero
+    // filled gaps created by CacheFile::Truncate().
+    mChunkInfoArray[aIndex] = 0;
     mHashCount++;
   }
 
@@ -499,6 +517,42 @@ CacheFileMetadata::SetHash(uint32_t aIndex, CacheHash::Hash16_t aHash)
   return NS_OK;
 }
 
+uint8_t
+CacheFileMetadata::GetChunkCodec(uint32_t aIndex)
+{
+  MOZ_ASSERT(aIndex < mHashCount);
+  return NetworkEndian::readUint32(&mChunkInfoArray[aIndex]) >> 24;
+}
+
+uint32_t
+CacheFileMetadata::GetChunkDiskSize(uint32_t aIndex)
+{
+  MOZ_ASSERT(aIndex < mHashCount);
+  return NetworkEndian::readUint32(&mChunkInfoArray[aIndex]) & 0x00ffffff;
+}
+
+nsresult
+CacheFileMetadata::SetChunkDiskInfo(uint32_t aIndex, uint8_t aCodec,
+                                    uint32_t aDiskSize)
+{
+  LOG(("CacheFileMetadata::SetChunkDiskInfo() [this=%p, idx=%d, codec=%d, "
+       "diskSize=%d]", this, aIndex, aCodec, aDiskSize));
+
+  MOZ_ASSERT(aIndex < mHashCount, "SetHash() must be called first");
+  MOZ_ASSERT(!(aDiskSize & 0xff000000), "Chunk disk size overflows 24 bits");
+
+  if (aIndex >= mHashCount) {
+    return NS_ERROR_INVALID_ARG;
+  }
+
+  MarkDirty();
+
+  NetworkEndian::writeUint32(&mChunkInfoArray[aIndex],
+                             (uint32_t(aCodec) << 24) | aDiskSize);
+
+  return NS_OK;
+}
+
 nsresult
 CacheFileMetadata::SetExpirationTime(uint32_t aExpirationTime)
 {
@@ -752,13 +806,15 @@ CacheFileMetadata::ParseMetadata(uint32_t aMetaOffset, uint32_t aBufOffset,
   if (aMetaOffset % kChunkSize)
     hashCount++;
   uint32_t hashesLen = hashCount * sizeof(CacheHash::Hash16_t);
-  uint32_t hdrOffset = hashesOffset + hashesLen;
+  uint32_t chunkInfoOffset = hashesOffset + hashesLen;
+  uint32_t chunkInfoLen = hashCount * sizeof(uint32_t);
+  uint32_t hdrOffset = chunkInfoOffset + chunkInfoLen;
   uint32_t keyOffset = hdrOffset + sizeof(CacheFileMetadataHeader);
 
   LOG(("CacheFileMetadata::ParseMetadata() [this=%p]\n  metaposOffset=%d\n  "
-       "hashesOffset=%d\n  hashCount=%d\n  hashesLen=%d\n  hdfOffset=%d\n  "
-       "keyOffset=%d\n", this, metaposOffset, hashesOffset, hashCount,
-       hashesLen,hdrOffset, keyOffset));
+       "hashesOffset=%d\n  hashCount=%d\n  hashesLen=%d\n  chunkInfoOffset=%d\n"
+       "  hdfOffset=%d\n  keyOffset=%d\n", this, metaposOffset, hashesOffset,
+       hashCount, hashesLen, chunkInfoOffset, hdrOffset, keyOffset));
 
   if (keyOffset > metaposOffset) {
     LOG(("CacheFileMetadata::ParseMetadata() - Wrong keyOffset! [this=%p]",
@@ -838,6 +894,8 @@ CacheFileMetadata::ParseMetadata(uint32_t aMetaOffset, uint32_t aBufOffset,
     mHashArray = static_cast<CacheHash::Hash16_t *>(
                    moz_xmalloc(mHashArraySize));
     memcpy(mHashArray, mBuf + hashesOffset, mHashArraySize);
+    mChunkInfoArray = static_cast<uint32_t *>(moz_xmalloc(chunkInfoLen));
+    memcpy(mChunkInfoArray, mBuf + chunkInfoOffset, chunkInfoLen);
   }
 
 
@@ -915,6 +973,7 @@ CacheFileMetadata::SizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
   // mHandle reported via CacheFileIOManager.
   n += mKey.SizeOfExcludingThisIfUnshared(mallocSizeOf);
   n += mallocSizeOf(mHashArray);
+  n += mallocSizeOf(mChunkInfoArray);
   n += mallocSizeOf(mBuf);
   n += mallocSizeOf(mWriteBuf);
   // mListener is usually the owning CacheFile.
@@ -136,6 +136,11 @@ public:
   CacheHash::Hash16_t GetHash(uint32_t aIndex);
   nsresult            SetHash(uint32_t aIndex, CacheHash::Hash16_t aHash);
 
+  uint8_t  GetChunkCodec(uint32_t aIndex);
+  uint32_t GetChunkDiskSize(uint32_t aIndex);
+  nsresult SetChunkDiskInfo(uint32_t aIndex, uint8_t aCodec,
+                            uint32_t aDiskSize);
+
   nsresult SetExpirationTime(uint32_t aExpirationTime);
   nsresult GetExpirationTime(uint32_t *_retval);
   nsresult SetFrecency(uint32_t aFrecency);
@@ -151,7 +156,7 @@ public:
   uint32_t ElementsSize() { return mElementsSize; }
   void     MarkDirty(bool aUpdateLastModified = true);
   bool     IsDirty() { return mIsDirty; }
-  uint32_t MemoryUsage() { return sizeof(CacheFileMetadata) + mHashArraySize + mBufSize; }
+  uint32_t MemoryUsage() { return sizeof(CacheFileMetadata) + mHashArraySize + mHashArraySize * 2 + mBufSize; }
 
   NS_IMETHOD OnFileOpened(CacheFileHandle *aHandle, nsresult aResult);
   NS_IMETHOD OnDataWritten(CacheFileHandle *aHandle, const char *aBuf,
@@ -177,6 +182,10 @@ private:
   nsRefPtr<CacheFileHandle>           mHandle;
   nsCString                           mKey;
   CacheHash::Hash16_t                *mHashArray;
+  // On-disk info for every chunk, stored right after the hash array. Each
+  // entry packs the compression codec in the top byte and the number of
+  // bytes the chunk occupies on the disk in the lower three bytes.
+  uint32_t                           *mChunkInfoArray;
   uint32_t                            mHashArraySize;
   uint32_t                            mHashCount;
   int64_t                             mOffset;
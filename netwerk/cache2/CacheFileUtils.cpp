@@ -5,10 +5,12 @@
 #include "CacheLog.h"
 #include "CacheFileUtils.h"
 #include "LoadContextInfo.h"
+#include "nsICacheStorage.h"
 #include "nsCOMPtr.h"
 #include "nsAutoPtr.h"
 #include "nsString.h"
 #include <algorithm>
+#include <stdlib.h>
 
 
 namespace mozilla {
@@ -286,6 +288,23 @@ KeyMatchesLoadContextInfo(const nsACString &aKey, nsILoadContextInfo *aInfo,
   return NS_OK;
 }
 
+const char *kRetentionClassKey = "retention-class";
+
+uint32_t
+ParseRetentionClass(const char *aValue)
+{
+  if (!aValue) {
+    return nsICacheStorage::RETAIN_NORMAL;
+  }
+
+  uint32_t retentionClass = strtoul(aValue, nullptr, 10);
+  if (retentionClass > nsICacheStorage::RETAIN_PINNED) {
+    return nsICacheStorage::RETAIN_NORMAL;
+  }
+
+  return retentionClass;
+}
+
 ValidityPair::ValidityPair(uint32_t aOffset, uint32_t aLen)
   : mOffset(aOffset), mLen(aLen)
 {}
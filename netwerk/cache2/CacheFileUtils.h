@@ -33,6 +33,15 @@ KeyMatchesLoadContextInfo(const nsACString &aKey,
                           nsILoadContextInfo *aInfo,
                           bool *_retval);
 
+// Key of the metadata element under which the retention class of an entry
+// is persisted.
+extern const char *kRetentionClassKey;
+
+// Parses the value of the retention class metadata element.  Returns
+// nsICacheStorage::RETAIN_NORMAL when aValue is null or invalid.
+uint32_t
+ParseRetentionClass(const char *aValue);
+
 class ValidityPair {
 public:
   ValidityPair(uint32_t aOffset, uint32_t aLen);
@@ -7,6 +7,7 @@
 #include "CacheLog.h"
 #include "CacheFileIOManager.h"
 #include "CacheFileMetadata.h"
+#include "CacheFileUtils.h"
 #include "CacheIndexIterator.h"
 #include "CacheIndexContextIterator.h"
 #include "nsThreadUtils.h"
@@ -25,12 +26,26 @@
 #define kMinUnwrittenChanges   300
 #define kMinDumpInterval       20000 // in milliseconds
 #define kMaxBufSize            16384
+// Cap on the read buffer used when loading the index from disk.  Reading
+// in kMaxBufSize chunks costs one trip through the IO thread's event
+// queue per chunk, which dominates cold startup with large indexes.
+#define kMaxReadBufSize        (4 * 1024 * 1024)
 #define kIndexVersion          0x00000001
 #define kUpdateIndexStartDelay 50000 // in milliseconds
 
+// Records are buffered in memory and handed to the IO thread in batches of
+// at least this size (group commit), so a burst of metadata changes costs a
+// single sequential append.
+#define kWalFlushThreshold     4096
+// A log record is the serialized entry followed by a hash of it, so replay
+// can detect a torn tail after a crash.
+#define kWalRecordSize         (sizeof(CacheIndexRecord) + \
+                                sizeof(CacheHash::Hash32_t))
+
 const char kIndexName[]     = "index";
 const char kTempIndexName[] = "index.tmp";
 const char kJournalName[]   = "index.log";
+const char kWalName[]       = "index.wal";
 
 namespace mozilla {
 namespace net {
@@ -256,6 +271,11 @@ CacheIndex::CacheIndex()
   , mRWBufSize(0)
   , mRWBufPos(0)
   , mJournalReadSuccessfully(false)
+  , mWalBuf(nullptr)
+  , mWalBufSize(0)
+  , mWalBufPos(0)
+  , mWalFileOffset(0)
+  , mWalWriteFailed(false)
 {
   LOG(("CacheIndex::CacheIndex [this=%p]", this));
   MOZ_COUNT_CTOR(CacheIndex);
@@ -268,6 +288,11 @@ CacheIndex::~CacheIndex()
   MOZ_COUNT_DTOR(CacheIndex);
 
   ReleaseBuffer();
+
+  if (mWalBuf) {
+    free(mWalBuf);
+    mWalBuf = nullptr;
+  }
 }
 
 void
@@ -597,6 +622,7 @@ CacheIndex::AddEntry(const SHA1Sum::Hash *aHash)
     index->mIndexNeedsUpdate = true;
   }
 
+  index->WriteEntryToWal(aHash);
   index->StartUpdatingIndexIfNeeded();
   index->WriteIndexToDiskIfNeeded();
 
@@ -703,6 +729,7 @@ CacheIndex::EnsureEntryExists(const SHA1Sum::Hash *aHash)
     }
   }
 
+  index->WriteEntryToWal(aHash);
   index->StartUpdatingIndexIfNeeded();
   index->WriteIndexToDiskIfNeeded();
 
@@ -816,6 +843,7 @@ CacheIndex::InitEntry(const SHA1Sum::Hash *aHash,
     }
   }
 
+  index->WriteEntryToWal(aHash);
   index->StartUpdatingIndexIfNeeded();
   index->WriteIndexToDiskIfNeeded();
 
@@ -911,6 +939,7 @@ CacheIndex::RemoveEntry(const SHA1Sum::Hash *aHash)
     }
   }
 
+  index->WriteEntryToWal(aHash);
   index->StartUpdatingIndexIfNeeded();
   index->WriteIndexToDiskIfNeeded();
 
@@ -922,12 +951,15 @@ nsresult
 CacheIndex::UpdateEntry(const SHA1Sum::Hash *aHash,
                         const uint32_t      *aFrecency,
                         const uint32_t      *aExpirationTime,
+                        const uint32_t      *aRetentionClass,
                         const uint32_t      *aSize)
 {
   LOG(("CacheIndex::UpdateEntry() [hash=%08x%08x%08x%08x%08x, "
-       "frecency=%s, expirationTime=%s, size=%s]", LOGSHA1(aHash),
+       "frecency=%s, expirationTime=%s, retentionClass=%s, size=%s]",
+       LOGSHA1(aHash),
        aFrecency ? nsPrintfCString("%u", *aFrecency).get() : "",
        aExpirationTime ? nsPrintfCString("%u", *aExpirationTime).get() : "",
+       aRetentionClass ? nsPrintfCString("%u", *aRetentionClass).get() : "",
        aSize ? nsPrintfCString("%u", *aSize).get() : ""));
 
   nsRefPtr<CacheIndex> index = gInstance;
@@ -958,7 +990,8 @@ CacheIndex::UpdateEntry(const SHA1Sum::Hash *aHash,
       MOZ_ASSERT(index->mPendingUpdates.Count() == 0);
       MOZ_ASSERT(entry);
 
-      if (!HasEntryChanged(entry, aFrecency, aExpirationTime, aSize)) {
+      if (!HasEntryChanged(entry, aFrecency, aExpirationTime, aRetentionClass,
+                           aSize)) {
         return NS_OK;
       }
 
@@ -974,6 +1007,10 @@ CacheIndex::UpdateEntry(const SHA1Sum::Hash *aHash,
         entry->SetExpirationTime(*aExpirationTime);
       }
 
+      if (aRetentionClass) {
+        entry->SetRetentionClass(*aRetentionClass);
+      }
+
       if (aSize) {
         entry->SetFileSize(*aSize);
       }
@@ -1010,12 +1047,17 @@ CacheIndex::UpdateEntry(const SHA1Sum::Hash *aHash,
         updated->SetExpirationTime(*aExpirationTime);
       }
 
+      if (aRetentionClass) {
+        updated->SetRetentionClass(*aRetentionClass);
+      }
+
       if (aSize) {
         updated->SetFileSize(*aSize);
       }
     }
   }
 
+  index->WriteEntryToWal(aHash);
   index->WriteIndexToDiskIfNeeded();
 
   return NS_OK;
@@ -1095,6 +1137,9 @@ CacheIndex::RemoveAll()
     index->mFrecencyArray.Clear();
     index->mExpirationArray.Clear();
     index->mIndex.Clear();
+
+    // All logged records refer to entries that no longer exist.
+    index->ResetWal();
   }
 
   if (file) {
@@ -1202,6 +1247,12 @@ CacheIndex::GetEntryForEviction(SHA1Sum::Hash *aHash, uint32_t *aCnt)
   // find the first expired, non-forced valid entry
   for (i = 0; i < index->mExpirationArray.Length(); i++) {
     if (index->mExpirationArray[i]->mExpirationTime < now) {
+      // Pinned entries are never evicted, not even when expired.
+      if (CacheIndexEntry::GetRetentionClass(index->mExpirationArray[i]) ==
+          nsICacheStorage::RETAIN_PINNED) {
+        continue;
+      }
+
       memcpy(&hash, &index->mExpirationArray[i]->mHash, sizeof(SHA1Sum::Hash));
 
       if (!IsForcedValidEntry(&hash)) {
@@ -1231,6 +1282,13 @@ CacheIndex::GetEntryForEviction(SHA1Sum::Hash *aHash, uint32_t *aCnt)
 
     // find first non-forced valid entry with the lowest frecency
     for (j = 0; j < index->mFrecencyArray.Length(); j++) {
+      // The array is sorted with pinned entries at the end, so there is
+      // nothing more to evict once we reach them.
+      if (CacheIndexEntry::GetRetentionClass(index->mFrecencyArray[j]) ==
+          nsICacheStorage::RETAIN_PINNED) {
+        break;
+      }
+
       memcpy(&hash, &index->mFrecencyArray[j]->mHash, sizeof(SHA1Sum::Hash));
 
       if (!IsForcedValidEntry(&hash)) {
@@ -1479,6 +1537,7 @@ bool
 CacheIndex::HasEntryChanged(CacheIndexEntry *aEntry,
                             const uint32_t  *aFrecency,
                             const uint32_t  *aExpirationTime,
+                            const uint32_t  *aRetentionClass,
                             const uint32_t  *aSize)
 {
   if (aFrecency && *aFrecency != aEntry->GetFrecency()) {
@@ -1489,6 +1548,10 @@ CacheIndex::HasEntryChanged(CacheIndexEntry *aEntry,
     return true;
   }
 
+  if (aRetentionClass && *aRetentionClass != aEntry->GetRetentionClass()) {
+    return true;
+  }
+
   if (aSize &&
       (*aSize & CacheIndexEntry::kFileSizeMask) != aEntry->GetFileSize()) {
     return true;
@@ -1741,6 +1804,16 @@ CacheIndex::FinishWrite(bool aSucceeded)
   ProcessPendingOperations();
   mIndexStats.Log();
 
+  if (aSucceeded) {
+    // The dump is a checkpoint - the WAL's records are now part of the index
+    // file, so truncate it. Entries merged from mPendingUpdates above are not
+    // covered by the dump and must be re-logged.
+    ResetWal();
+    if (!mWalWriteFailed) {
+      mIndex.EnumerateEntries(&CacheIndex::AppendDirtyEntryToWal, this);
+    }
+  }
+
   if (mState == WRITING) {
     ChangeState(READY);
     mLastDumpTime = TimeStamp::NowLoRes();
@@ -1803,6 +1876,136 @@ CacheIndex::ApplyIndexChanges(CacheIndexEntry *aEntry, void* aClosure)
   return PL_DHASH_NEXT;
 }
 
+void
+CacheIndex::WriteEntryToWal(const SHA1Sum::Hash *aHash)
+{
+  AssertOwnsLock();
+
+  if (mState != READY || mShuttingDown || mWalWriteFailed) {
+    // During reading, writing, updating and building the log would not
+    // describe changes relative to the index file on disk, and after a
+    // failed append the log is already incomplete; in both cases an unclean
+    // shutdown falls back to updating the index from the directory.
+    return;
+  }
+
+  CacheIndexEntry *entry = mIndex.GetEntry(*aHash);
+  if (!entry || !(entry->IsDirty() || entry->IsRemoved())) {
+    return;
+  }
+
+  AppendEntryToWal(entry);
+}
+
+void
+CacheIndex::AppendEntryToWal(CacheIndexEntry *aEntry)
+{
+  AssertOwnsLock();
+
+  if (!mWalBuf) {
+    mWalBufSize = 2 * kWalFlushThreshold;
+    mWalBuf = static_cast<char *>(moz_xmalloc(mWalBufSize));
+  } else if (mWalBufPos + kWalRecordSize > mWalBufSize) {
+    mWalBufSize *= 2;
+    mWalBuf = static_cast<char *>(moz_xrealloc(mWalBuf, mWalBufSize));
+  }
+
+  // WriteToBuf() clears the dirty and fresh flags in the serialized copy,
+  // the same representation the journal uses.
+  aEntry->WriteToBuf(mWalBuf + mWalBufPos);
+  CacheHash::Hash32_t hash = CacheHash::Hash(mWalBuf + mWalBufPos,
+                                             sizeof(CacheIndexRecord));
+  NetworkEndian::writeUint32(mWalBuf + mWalBufPos + sizeof(CacheIndexRecord),
+                             hash);
+  mWalBufPos += kWalRecordSize;
+
+  if (mWalBufPos >= kWalFlushThreshold) {
+    FlushWalBuffer();
+  }
+}
+
+void
+CacheIndex::FlushWalBuffer()
+{
+  LOG(("CacheIndex::FlushWalBuffer() [bufpos=%u]", mWalBufPos));
+
+  AssertOwnsLock();
+
+  if (!mWalHandle) {
+    if (!mWalFileOpener) {
+      // Open the log file lazily; CREATE truncates any stale log from a
+      // previous session. The buffered records are flushed from
+      // OnFileOpenedInternal() once the handle exists.
+      mWalFileOpener = new FileOpenHelper(this);
+      nsresult rv = CacheFileIOManager::OpenFile(
+        NS_LITERAL_CSTRING(kWalName),
+        CacheFileIOManager::SPECIAL_FILE | CacheFileIOManager::CREATE,
+        mWalFileOpener);
+      if (NS_FAILED(rv)) {
+        LOG(("CacheIndex::FlushWalBuffer() - Cannot open WAL file "
+             "[rv=0x%08x]", rv));
+        mWalFileOpener = nullptr;
+        mWalWriteFailed = true;
+      }
+    }
+    return;
+  }
+
+  // Fire and forget; with a null listener CacheFileIOManager frees the
+  // buffer once the write is done. Writes are dispatched in order, so the
+  // records land sequentially after any previous append.
+  nsresult rv = CacheFileIOManager::Write(mWalHandle, mWalFileOffset, mWalBuf,
+                                          mWalBufPos, false, nullptr);
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::FlushWalBuffer() - CacheFileIOManager::Write() failed "
+         "synchronously [rv=0x%08x]", rv));
+    mWalWriteFailed = true;
+  } else {
+    mWalFileOffset += mWalBufPos;
+  }
+
+  // The buffer is owned by the IO manager now (even in the failure case).
+  mWalBuf = nullptr;
+  mWalBufSize = 0;
+  mWalBufPos = 0;
+}
+
+void
+CacheIndex::ResetWal()
+{
+  AssertOwnsLock();
+
+  mWalBufPos = 0;
+
+  if (mWalHandle && mWalFileOffset) {
+    nsresult rv = CacheFileIOManager::TruncateSeekSetEOF(mWalHandle, 0, 0,
+                                                         nullptr);
+    if (NS_FAILED(rv)) {
+      LOG(("CacheIndex::ResetWal() - TruncateSeekSetEOF() failed "
+           "synchronously [rv=0x%08x]", rv));
+      mWalWriteFailed = true;
+    }
+    mWalFileOffset = 0;
+  }
+}
+
+// static
+PLDHashOperator
+CacheIndex::AppendDirtyEntryToWal(CacheIndexEntry *aEntry, void* aClosure)
+{
+  CacheIndex *index = static_cast<CacheIndex *>(aClosure);
+
+  if (index->mWalWriteFailed) {
+    return PL_DHASH_STOP;
+  }
+
+  if (aEntry->IsDirty() || aEntry->IsRemoved()) {
+    index->AppendEntryToWal(aEntry);
+  }
+
+  return PL_DHASH_NEXT;
+}
+
 nsresult
 CacheIndex::GetFile(const nsACString &aName, nsIFile **_retval)
 {
@@ -1855,6 +2058,7 @@ CacheIndex::RemoveIndexFromDisk()
   RemoveFile(NS_LITERAL_CSTRING(kIndexName));
   RemoveFile(NS_LITERAL_CSTRING(kTempIndexName));
   RemoveFile(NS_LITERAL_CSTRING(kJournalName));
+  RemoveFile(NS_LITERAL_CSTRING(kWalName));
 }
 
 class WriteLogHelper
@@ -1970,6 +2174,10 @@ CacheIndex::WriteLogToDisk()
   MOZ_ASSERT(mState == SHUTDOWN);
 
   RemoveFile(NS_LITERAL_CSTRING(kTempIndexName));
+  // The journal written below covers everything the WAL holds, and a WAL
+  // found at startup means an unclean shutdown, so it must not survive a
+  // clean one.
+  RemoveFile(NS_LITERAL_CSTRING(kWalName));
 
   nsCOMPtr<nsIFile> indexFile;
   rv = GetFile(NS_LITERAL_CSTRING(kIndexName), getter_AddRefs(indexFile));
@@ -2078,6 +2286,17 @@ CacheIndex::ReadIndexFromDisk()
          "failed [rv=0x%08x, file=%s]", rv, kTempIndexName));
     FinishRead(false);
   }
+
+  mWalReadOpener = new FileOpenHelper(this);
+  rv = CacheFileIOManager::OpenFile(NS_LITERAL_CSTRING(kWalName),
+                                    CacheFileIOManager::SPECIAL_FILE |
+                                    CacheFileIOManager::OPEN,
+                                    mWalReadOpener);
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::ReadIndexFromDisk() - CacheFileIOManager::OpenFile() "
+         "failed [rv=0x%08x, file=%s]", rv, kWalName));
+    FinishRead(false);
+  }
 }
 
 void
@@ -2223,6 +2442,12 @@ CacheIndex::ParseRecords()
 
     if (mJournalHandle) {
       StartReadingJournal();
+    } else if (mWalReadHandle) {
+      // The journal is missing after an unclean shutdown, but the index file
+      // we've just read is the last complete dump and the WAL describes the
+      // changes made since then, so replay it instead of walking the cache
+      // directory.
+      StartReadingWal();
     } else {
       FinishRead(false);
     }
@@ -2359,6 +2584,123 @@ CacheIndex::ParseJournal()
   }
 }
 
+void
+CacheIndex::StartReadingWal()
+{
+  LOG(("CacheIndex::StartReadingWal()"));
+
+  nsresult rv;
+
+  AssertOwnsLock();
+
+  MOZ_ASSERT(mWalReadHandle);
+  MOZ_ASSERT(mIndexOnDiskIsValid);
+  MOZ_ASSERT(mTmpJournal.Count() == 0);
+  MOZ_ASSERT(mWalReadHandle->FileSize() >= 0);
+
+  if (mWalReadHandle->FileSize() == 0) {
+    // The previous session crashed before it flushed anything. The index
+    // file alone is the correct state.
+    mJournalReadSuccessfully = true;
+    FinishRead(true);
+    return;
+  }
+
+  mSkipEntries = 0;
+
+  mRWBufPos = std::min(mRWBufSize,
+                       static_cast<uint32_t>(mWalReadHandle->FileSize()));
+
+  rv = CacheFileIOManager::Read(mWalReadHandle, 0, mRWBuf, mRWBufPos, this);
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::StartReadingWal() - CacheFileIOManager::Read() failed "
+         "synchronously [rv=0x%08x]", rv));
+    FinishRead(false);
+  }
+}
+
+void
+CacheIndex::ParseWal()
+{
+  LOG(("CacheIndex::ParseWal()"));
+
+  nsresult rv;
+
+  AssertOwnsLock();
+
+  // A trailing partial record is a torn tail from the crash and is ignored.
+  uint32_t entryCnt = mWalReadHandle->FileSize() / kWalRecordSize;
+
+  uint32_t pos = 0;
+
+  while (pos + kWalRecordSize <= mRWBufPos && mSkipEntries != entryCnt) {
+    CacheHash::Hash32_t expectedHash = CacheHash::Hash(
+      mRWBuf + pos, sizeof(CacheIndexRecord));
+    if (expectedHash !=
+        NetworkEndian::readUint32(mRWBuf + pos + sizeof(CacheIndexRecord))) {
+      // The record was being written when we crashed. Records are appended
+      // in order, so everything before it is intact and everything after it
+      // was lost anyway; replay just the valid prefix.
+      LOG(("CacheIndex::ParseWal() - Found torn record, replaying %u of %u "
+           "records", mSkipEntries, entryCnt));
+      mJournalReadSuccessfully = true;
+      FinishRead(true);
+      return;
+    }
+
+    CacheIndexRecord *rec = reinterpret_cast<CacheIndexRecord *>(mRWBuf + pos);
+    CacheIndexEntry tmpEntry(&rec->mHash);
+    tmpEntry.ReadFromBuf(mRWBuf + pos);
+
+    // An entry that was logged repeatedly is simply overwritten; the last
+    // record holds its final state.
+    CacheIndexEntry *entry = mTmpJournal.PutEntry(*tmpEntry.Hash());
+    *entry = tmpEntry;
+
+    if (entry->IsDirty() || entry->IsFresh()) {
+      LOG(("CacheIndex::ParseWal() - Invalid entry found in WAL, ignoring "
+           "whole WAL [dirty=%d, fresh=%d]", entry->IsDirty(),
+           entry->IsFresh()));
+      FinishRead(false);
+      return;
+    }
+
+    pos += kWalRecordSize;
+    mSkipEntries++;
+  }
+
+  if (mSkipEntries == entryCnt) {
+    mJournalReadSuccessfully = true;
+    FinishRead(true);
+    return;
+  }
+
+  if (pos != mRWBufPos) {
+    memmove(mRWBuf, mRWBuf + pos, mRWBufPos - pos);
+    mRWBufPos -= pos;
+    pos = 0;
+  }
+
+  int64_t fileOffset = mSkipEntries * kWalRecordSize + mRWBufPos;
+
+  MOZ_ASSERT(fileOffset < mWalReadHandle->FileSize());
+
+  pos = mRWBufPos;
+  uint32_t toRead = std::min(mRWBufSize - pos,
+                             static_cast<uint32_t>(
+                               mWalReadHandle->FileSize() - fileOffset));
+  mRWBufPos = pos + toRead;
+
+  rv = CacheFileIOManager::Read(mWalReadHandle, fileOffset, mRWBuf + pos,
+                                toRead, this);
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::ParseWal() - CacheFileIOManager::Read() failed "
+         "synchronously [rv=0x%08x]", rv));
+    FinishRead(false);
+    return;
+  }
+}
+
 void
 CacheIndex::MergeJournal()
 {
@@ -2453,6 +2795,7 @@ CacheIndex::FinishRead(bool aSucceeded)
   if (mState == SHUTDOWN) {
     RemoveFile(NS_LITERAL_CSTRING(kTempIndexName));
     RemoveFile(NS_LITERAL_CSTRING(kJournalName));
+    RemoveFile(NS_LITERAL_CSTRING(kWalName));
   } else {
     if (mIndexHandle && !mIndexOnDiskIsValid) {
       CacheFileIOManager::DoomFile(mIndexHandle, nullptr);
@@ -2461,6 +2804,12 @@ CacheIndex::FinishRead(bool aSucceeded)
     if (mJournalHandle) {
       CacheFileIOManager::DoomFile(mJournalHandle, nullptr);
     }
+
+    if (mWalReadHandle) {
+      // Whether replayed or not, the WAL's records are obsolete now; this
+      // session starts its own log.
+      CacheFileIOManager::DoomFile(mWalReadHandle, nullptr);
+    }
   }
 
   if (mIndexFileOpener) {
@@ -2475,9 +2824,14 @@ CacheIndex::FinishRead(bool aSucceeded)
     mTmpFileOpener->Cancel();
     mTmpFileOpener = nullptr;
   }
+  if (mWalReadOpener) {
+    mWalReadOpener->Cancel();
+    mWalReadOpener = nullptr;
+  }
 
   mIndexHandle = nullptr;
   mJournalHandle = nullptr;
+  mWalReadHandle = nullptr;
   mRWHash = nullptr;
   ReleaseBuffer();
 
@@ -2508,6 +2862,10 @@ CacheIndex::FinishRead(bool aSucceeded)
   ProcessPendingOperations();
   mIndexStats.Log();
 
+  // Entries merged from the journal or WAL are dirty, i.e. not part of the
+  // index file on disk, so they must go into this session's log.
+  mIndex.EnumerateEntries(&CacheIndex::AppendDirtyEntryToWal, this);
+
   ChangeState(READY);
   mLastDumpTime = TimeStamp::NowLoRes(); // Do not dump new index immediately
 }
@@ -2641,6 +2999,9 @@ CacheIndex::InitEntryFromDiskData(CacheIndexEntry *aEntry,
   aMetaData->GetFrecency(&frecency);
   aEntry->SetFrecency(frecency);
 
+  aEntry->SetRetentionClass(CacheFileUtils::ParseRetentionClass(
+    aMetaData->GetElement(CacheFileUtils::kRetentionClassKey)));
+
   aEntry->SetFileSize(static_cast<uint32_t>(
                         std::min(static_cast<int64_t>(PR_UINT32_MAX),
                                  (aFileSize + 0x3FF) >> 10)));
@@ -3184,7 +3545,15 @@ CacheIndex::AllocBuffer()
       }
       break;
     case READING:
-      mRWBufSize = kMaxBufSize;
+      // Size the buffer to the index file (within sane bounds) so that
+      // an index covering hundreds of thousands of entries is pulled in
+      // with a handful of reads instead of hundreds of small ones.  The
+      // per-buffer checksum update and record validation in
+      // ParseRecords() are unaffected by the buffer size.
+      mRWBufSize = static_cast<uint32_t>(
+        std::min<int64_t>(std::max<int64_t>(mIndexHandle->FileSize(),
+                                            kMaxBufSize),
+                          kMaxReadBufSize));
       break;
     default:
       MOZ_ASSERT(false, "Unexpected state!");
@@ -3212,9 +3581,15 @@ class FrecencyComparator
 {
 public:
   bool Equals(CacheIndexRecord* a, CacheIndexRecord* b) const {
-    return a->mFrecency == b->mFrecency;
+    return RetentionRank(a) == RetentionRank(b) &&
+           a->mFrecency == b->mFrecency;
   }
   bool LessThan(CacheIndexRecord* a, CacheIndexRecord* b) const {
+    // Entries of a less retained class are evicted sooner, regardless of
+    // their frecency.
+    if (RetentionRank(a) != RetentionRank(b)) {
+      return RetentionRank(a) < RetentionRank(b);
+    }
     // Place entries with frecency 0 at the end of the array.
     if (a->mFrecency == 0) {
       return false;
@@ -3224,6 +3599,12 @@ public:
     }
     return a->mFrecency < b->mFrecency;
   }
+
+private:
+  static uint32_t RetentionRank(CacheIndexRecord* aRec) {
+    return CacheIndexEntry::RetentionRank(
+      CacheIndexEntry::GetRetentionClass(aRec));
+  }
 };
 
 class ExpirationComparator
@@ -3371,6 +3752,25 @@ CacheIndex::OnFileOpenedInternal(FileOpenHelper *aOpener,
     return NS_OK;
   }
 
+  if (aOpener == mWalFileOpener) {
+    // The WAL file is opened lazily from FlushWalBuffer() and the open may
+    // finish in any state.
+    mWalFileOpener = nullptr;
+
+    if (NS_FAILED(aResult)) {
+      LOG(("CacheIndex::OnFileOpenedInternal() - Can't open WAL file "
+           "[rv=0x%08x]", aResult));
+      mWalWriteFailed = true;
+    } else {
+      mWalHandle = aHandle;
+      mWalFileOffset = 0;
+      if (mWalBufPos >= kWalFlushThreshold) {
+        FlushWalBuffer();
+      }
+    }
+    return NS_OK;
+  }
+
   switch (mState) {
     case WRITING:
       MOZ_ASSERT(aOpener == mIndexFileOpener);
@@ -3407,11 +3807,15 @@ CacheIndex::OnFileOpenedInternal(FileOpenHelper *aOpener,
       } else if (aOpener == mTmpFileOpener) {
         mTmpFileOpener = nullptr;
         mTmpHandle = aHandle;
+      } else if (aOpener == mWalReadOpener) {
+        mWalReadOpener = nullptr;
+        mWalReadHandle = aHandle;
       } else {
         MOZ_ASSERT(false, "Unexpected state!");
       }
 
-      if (mIndexFileOpener || mJournalFileOpener || mTmpFileOpener) {
+      if (mIndexFileOpener || mJournalFileOpener || mTmpFileOpener ||
+          mWalReadOpener) {
         // Some opener still didn't finish
         break;
       }
@@ -3433,6 +3837,13 @@ CacheIndex::OnFileOpenedInternal(FileOpenHelper *aOpener,
       }
 
       if (mJournalHandle) {
+        // Shutdown was clean, so the journal supersedes whatever the WAL
+        // holds; the stale WAL must not be replayed next time.
+        if (mWalReadHandle) {
+          CacheFileIOManager::DoomFile(mWalReadHandle, nullptr);
+          mWalReadHandle = nullptr;
+        }
+
         // Rename journal to make sure we update index on next start in case
         // firefox crashes
         rv = CacheFileIOManager::RenameFile(
@@ -3529,13 +3940,16 @@ CacheIndex::OnDataRead(CacheFileHandle *aHandle, char *aBuf, nsresult aResult)
 
   switch (mState) {
     case READING:
-      MOZ_ASSERT(mIndexHandle == aHandle || mJournalHandle == aHandle);
+      MOZ_ASSERT(mIndexHandle == aHandle || mJournalHandle == aHandle ||
+                 mWalReadHandle == aHandle);
 
       if (NS_FAILED(aResult)) {
         FinishRead(false);
       } else {
         if (!mIndexOnDiskIsValid) {
           ParseRecords();
+        } else if (mWalReadHandle == aHandle) {
+          ParseWal();
         } else {
           ParseJournal();
         }
@@ -10,6 +10,7 @@
 #include "nsIRunnable.h"
 #include "CacheHashUtils.h"
 #include "nsICacheStorageService.h"
+#include "nsICacheStorage.h"
 #include "nsICacheEntry.h"
 #include "nsILoadContextInfo.h"
 #include "nsTHashtable.h"
@@ -68,7 +69,7 @@ struct CacheIndexRecord {
    *    0001 0000 0000 0000 0000 0000 0000 0000 : removed
    *    0000 1000 0000 0000 0000 0000 0000 0000 : dirty
    *    0000 0100 0000 0000 0000 0000 0000 0000 : fresh
-   *    0000 0011 0000 0000 0000 0000 0000 0000 : reserved
+   *    0000 0011 0000 0000 0000 0000 0000 0000 : retention class
    *    0000 0000 1111 1111 1111 1111 1111 1111 : file size (in kB)
    */
   uint32_t      mFlags;
@@ -184,6 +185,36 @@ public:
   bool IsFresh() const { return !!(mRec->mFlags & kFreshMask); }
   void MarkFresh() { mRec->mFlags |= kFreshMask; }
 
+  // Order in which the retention classes are considered for eviction; lower
+  // ranks are evicted sooner.  Scratch entries go first, then normal, then
+  // high-retention ones; pinned entries are never evicted at all.
+  static uint32_t RetentionRank(uint32_t aRetentionClass)
+  {
+    switch (aRetentionClass) {
+      case nsICacheStorage::RETAIN_SCRATCH:
+        return 0;
+      case nsICacheStorage::RETAIN_NORMAL:
+        return 1;
+      case nsICacheStorage::RETAIN_HIGH:
+        return 2;
+      default:
+        return 3; // RETAIN_PINNED
+    }
+  }
+
+  // The retention class is one of the nsICacheStorage::RETAIN_* constants.
+  void     SetRetentionClass(uint32_t aRetentionClass)
+  {
+    MOZ_ASSERT(aRetentionClass <= (kRetentionClassMask >> kRetentionClassShift));
+    mRec->mFlags &= ~kRetentionClassMask;
+    mRec->mFlags |= aRetentionClass << kRetentionClassShift;
+  }
+  uint32_t GetRetentionClass() const { return GetRetentionClass(mRec); }
+  static uint32_t GetRetentionClass(CacheIndexRecord *aRec)
+  {
+    return (aRec->mFlags & kRetentionClassMask) >> kRetentionClassShift;
+  }
+
   void     SetFrecency(uint32_t aFrecency) { mRec->mFrecency = aFrecency; }
   uint32_t GetFrecency() const { return mRec->mFrecency; }
 
@@ -249,10 +280,10 @@ public:
   void Log() const {
     LOG(("CacheIndexEntry::Log() [this=%p, hash=%08x%08x%08x%08x%08x, fresh=%u,"
          " initialized=%u, removed=%u, dirty=%u, anonymous=%u, inBrowser=%u, "
-         "appId=%u, frecency=%u, expirationTime=%u, size=%u]",
+         "appId=%u, frecency=%u, expirationTime=%u, retention=%u, size=%u]",
          this, LOGSHA1(mRec->mHash), IsFresh(), IsInitialized(), IsRemoved(),
          IsDirty(), Anonymous(), InBrowser(), AppId(), GetFrecency(),
-         GetExpirationTime(), GetFileSize()));
+         GetExpirationTime(), GetRetentionClass(), GetFileSize()));
   }
 
   static bool RecordMatchesLoadContextInfo(CacheIndexRecord *aRec,
@@ -301,7 +332,9 @@ private:
   // this entry during update or build process.
   static const uint32_t kFreshMask       = 0x04000000;
 
-  static const uint32_t kReservedMask    = 0x03000000;
+  // Retention class of the entry, see nsICacheStorage::RETAIN_*.
+  static const uint32_t kRetentionClassMask  = 0x03000000;
+  static const uint32_t kRetentionClassShift = 24;
 
   // FileSize in kilobytes
   static const uint32_t kFileSizeMask    = 0x00FFFFFF;
@@ -622,6 +655,7 @@ public:
   static nsresult UpdateEntry(const SHA1Sum::Hash *aHash,
                               const uint32_t      *aFrecency,
                               const uint32_t      *aExpirationTime,
+                              const uint32_t      *aRetentionClass,
                               const uint32_t      *aSize);
 
   // Remove all entries from the index. Called when clearing the whole cache.
@@ -716,6 +750,7 @@ private:
   static bool HasEntryChanged(CacheIndexEntry *aEntry,
                               const uint32_t  *aFrecency,
                               const uint32_t  *aExpirationTime,
+                              const uint32_t  *aRetentionClass,
                               const uint32_t  *aSize);
 
   // Merge all pending operations from mPendingUpdates into mIndex.
@@ -742,6 +777,34 @@ private:
   // Finalizes writing process.
   void FinishWrite(bool aSucceeded);
 
+  // Following methods maintain a write-ahead log of the metadata changes made
+  // while the index is in READY state. Records are buffered in memory and
+  // flushed to the log in batches (group commit), so steady-state metadata
+  // mutations cost a fraction of a write per change and never an fsync. Every
+  // successful index dump acts as a checkpoint that truncates the log. After
+  // an unclean shutdown the dirty index file is still the last complete dump,
+  // so replaying the log on top of it brings the index up to date without
+  // walking the entries directory. Changes that were still buffered when the
+  // crash happened are lost, but such entries are fixed lazily when their
+  // cache files are opened, exactly like entries that changed after the last
+  // dump are today.
+  //
+  // Appends the entry for aHash to the log buffer if the index is in READY
+  // state and the entry is dirty or removed.
+  void WriteEntryToWal(const SHA1Sum::Hash *aHash);
+  // Serializes a single record (entry data followed by a hash of it) into the
+  // log buffer and flushes the buffer once it exceeds the flush threshold.
+  void AppendEntryToWal(CacheIndexEntry *aEntry);
+  // Hands the buffered records to CacheFileIOManager. The log file is created
+  // lazily on the first flush.
+  void FlushWalBuffer();
+  // Starts a new checkpoint: drops buffered records and truncates the log.
+  void ResetWal();
+  // Re-logs entries that are still dirty after a checkpoint, i.e. changes
+  // that were merged from mPendingUpdates and are not part of the dump.
+  static PLDHashOperator AppendDirtyEntryToWal(CacheIndexEntry *aEntry,
+                                               void* aClosure);
+
   static PLDHashOperator CopyRecordsToRWBuf(CacheIndexEntry *aEntry,
                                             void* aClosure);
   static PLDHashOperator ApplyIndexChanges(CacheIndexEntry *aEntry,
@@ -777,7 +840,8 @@ private:
   // index, journal, tmpfile
   // M      *        *       - index is missing    -> BUILD
   // I      *        *       - index is invalid    -> BUILD
-  // D      *        *       - index is dirty      -> UPDATE
+  // D      *        *       - index is dirty      -> replay the write-ahead
+  //                           log if it is present and valid, else UPDATE
   // C      M        *       - index is dirty      -> UPDATE
   // C      I        *       - unexpected state    -> UPDATE
   // C      V        E       - unexpected state    -> UPDATE
@@ -809,6 +873,13 @@ private:
   void StartReadingJournal();
   // Parses data read from journal file.
   void ParseJournal();
+  // Starts reading data from the write-ahead log. Used when there is no
+  // journal file, i.e. after an unclean shutdown.
+  void StartReadingWal();
+  // Parses data read from the write-ahead log. Unlike the journal, the log
+  // is validated per record, so a torn tail only cuts the replay short
+  // instead of invalidating the whole file.
+  void ParseWal();
   // Merges entries from journal into mIndex.
   void MergeJournal();
   // In debug build this method checks that we have no fresh entry in mIndex
@@ -999,6 +1070,24 @@ private:
   nsRefPtr<FileOpenHelper>  mJournalFileOpener;
   nsRefPtr<FileOpenHelper>  mTmpFileOpener;
 
+  // Write-ahead log of metadata changes made in READY state; see the comment
+  // at WriteEntryToWal(). mWalHandle/mWalFileOpener belong to the writing
+  // side, mWalReadHandle/mWalReadOpener are used only while reading the index
+  // at startup.
+  nsRefPtr<CacheFileHandle> mWalHandle;
+  nsRefPtr<FileOpenHelper>  mWalFileOpener;
+  nsRefPtr<CacheFileHandle> mWalReadHandle;
+  nsRefPtr<FileOpenHelper>  mWalReadOpener;
+  // Buffered records that were not handed to CacheFileIOManager yet.
+  char                     *mWalBuf;
+  uint32_t                  mWalBufSize;
+  uint32_t                  mWalBufPos;
+  // Offset in the log file where the next flush will be written.
+  int64_t                   mWalFileOffset;
+  // Set when creating or writing the log fails; disables the log for the
+  // rest of the session.
+  bool                      mWalWriteFailed;
+
   // Directory enumerator used when building and updating index.
   nsCOMPtr<nsIDirectoryEnumerator> mDirEnumerator;
 
@@ -17,6 +17,7 @@
 #include "nsCacheService.h"
 #include "nsDeleteDir.h"
 
+#include "nsICacheStorage.h"
 #include "nsICacheStorageVisitor.h"
 #include "nsIObserverService.h"
 #include "nsIFile.h"
@@ -796,6 +797,64 @@ NS_IMETHODIMP CacheStorageService::PurgeFromMemory(uint32_t aWhat)
   return Dispatch(event);
 }
 
+NS_IMETHODIMP CacheStorageService::SetRetentionClassForPrefix(const nsACString & aUrlPrefix,
+                                                              uint32_t aRetentionClass)
+{
+  LOG(("CacheStorageService::SetRetentionClassForPrefix [prefix=%s, class=%u]",
+       PromiseFlatCString(aUrlPrefix).get(), aRetentionClass));
+
+  if (aUrlPrefix.IsEmpty() || aRetentionClass > nsICacheStorage::RETAIN_PINNED) {
+    return NS_ERROR_INVALID_ARG;
+  }
+
+  mozilla::MutexAutoLock lock(mLock);
+
+  NS_ENSURE_FALSE(mShutdown, NS_ERROR_NOT_INITIALIZED);
+
+  for (uint32_t i = 0; i < mRetentionClassPrefixes.Length(); ++i) {
+    if (mRetentionClassPrefixes[i].mPrefix == aUrlPrefix) {
+      mRetentionClassPrefixes[i].mClass = aRetentionClass;
+      return NS_OK;
+    }
+  }
+
+  RetentionClassPrefix* prefix = mRetentionClassPrefixes.AppendElement();
+  prefix->mPrefix = aUrlPrefix;
+  prefix->mClass = aRetentionClass;
+  return NS_OK;
+}
+
+bool
+CacheStorageService::RetentionClassForURI(nsIURI* aURI, uint32_t *aRetentionClass)
+{
+  if (!aURI) {
+    return false;
+  }
+
+  nsAutoCString spec;
+  if (NS_FAILED(aURI->GetAsciiSpec(spec))) {
+    return false;
+  }
+
+  mozilla::MutexAutoLock lock(mLock);
+
+  // The longest matching prefix wins so that a broad prefix can e.g. mark
+  // a whole site as scratch while a narrower one pins its app-shell part.
+  bool found = false;
+  uint32_t longestMatch = 0;
+  for (uint32_t i = 0; i < mRetentionClassPrefixes.Length(); ++i) {
+    RetentionClassPrefix const &prefix = mRetentionClassPrefixes[i];
+    if (prefix.mPrefix.Length() >= longestMatch &&
+        StringBeginsWith(spec, prefix.mPrefix)) {
+      *aRetentionClass = prefix.mClass;
+      longestMatch = prefix.mPrefix.Length();
+      found = true;
+    }
+  }
+
+  return found;
+}
+
 NS_IMETHODIMP CacheStorageService::AsyncGetDiskConsumption(
   nsICacheStorageConsumptionObserver* aObserver)
 {
@@ -844,11 +903,23 @@ class FrecencyComparator
 {
 public:
   bool Equals(CacheEntry* a, CacheEntry* b) const {
-    return a->GetFrecency() == b->GetFrecency();
+    return RetentionRank(a) == RetentionRank(b) &&
+           a->GetFrecency() == b->GetFrecency();
   }
   bool LessThan(CacheEntry* a, CacheEntry* b) const {
+    // Entries of a less retained class are purged sooner, regardless of
+    // their frecency.
+    if (RetentionRank(a) != RetentionRank(b)) {
+      return RetentionRank(a) < RetentionRank(b);
+    }
+
     return a->GetFrecency() < b->GetFrecency();
   }
+
+private:
+  static uint32_t RetentionRank(CacheEntry* aEntry) {
+    return CacheIndexEntry::RetentionRank(aEntry->GetRetentionClass());
+  }
 };
 
 class ExpirationComparator
@@ -1292,6 +1363,12 @@ CacheStorageService::MemoryPool::PurgeByFrecency(bool &aFrecencyNeedsSort, uint3
 
     nsRefPtr<CacheEntry> entry = mFrecencyArray[i];
 
+    // The array is sorted with pinned entries at the end, so there is
+    // nothing more to purge once we reach them.
+    if (entry->GetRetentionClass() == nsICacheStorage::RETAIN_PINNED) {
+      break;
+    }
+
     if (entry->Purge(aWhat)) {
       LOG(("  abandoned (%d), entry=%p, frecency=%1.10f",
         aWhat, entry.get(), entry->GetFrecency()));
@@ -108,6 +108,11 @@ public:
   // Invokes OnEntryInfo for the given aEntry, synchronously.
   static void GetCacheEntryInfo(CacheEntry* aEntry, EntryInfoCallback *aVisitor);
 
+  // Returns true and the retention class registered via
+  // setRetentionClassForPrefix for the longest prefix the spec of aURI
+  // starts with.  Returns false when no prefix matches.
+  bool RetentionClassForURI(nsIURI* aURI, uint32_t *aRetentionClass);
+
   // Memory reporting
   size_t SizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
   size_t SizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
@@ -291,6 +296,15 @@ private:
 
   bool mShutdown;
 
+  // Maps URL prefixes to retention classes as registered via
+  // setRetentionClassForPrefix.  Protected by mLock.
+  struct RetentionClassPrefix
+  {
+    nsCString mPrefix;
+    uint32_t mClass;
+  };
+  nsTArray<RetentionClassPrefix> mRetentionClassPrefixes;
+
   // Accessible only on the service thread
   class MemoryPool
   {
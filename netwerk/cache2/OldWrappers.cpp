@@ -378,6 +378,18 @@ NS_IMETHODIMP _OldCacheEntryWrapper::ForceValidFor(uint32_t aSecondsToTheFuture)
   return NS_ERROR_NOT_IMPLEMENTED;
 }
 
+NS_IMETHODIMP _OldCacheEntryWrapper::GetRetentionClass(uint32_t *aRetentionClass)
+{
+  // The old backend doesn't implement retention classes
+  *aRetentionClass = nsICacheStorage::RETAIN_NORMAL;
+  return NS_OK;
+}
+
+NS_IMETHODIMP _OldCacheEntryWrapper::SetRetentionClass(uint32_t aRetentionClass)
+{
+  return NS_ERROR_NOT_IMPLEMENTED;
+}
+
 NS_IMPL_ISUPPORTS(_OldCacheEntryWrapper, nsICacheEntry)
 
 NS_IMETHODIMP _OldCacheEntryWrapper::AsyncDoom(nsICacheEntryDoomCallback* listener)
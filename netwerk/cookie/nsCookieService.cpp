@@ -648,6 +648,7 @@ DBState::SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const
     amount += hostArray[i].SizeOfExcludingThis(aMallocSizeOf);
   }
   amount += readSet.SizeOfExcludingThis(aMallocSizeOf);
+  amount += domainSet.SizeOfExcludingThis(aMallocSizeOf);
 
   return amount;
 }
@@ -2141,6 +2142,12 @@ nsCookieService::Read()
     getter_AddRefs(mDefaultDBState->syncConn));
   NS_ENSURE_SUCCESS(rv, RESULT_RETRY);
 
+  // Load the set of base domains that actually have cookies, using a single
+  // scan of the moz_basedomain index. This lets EnsureReadDomain() answer
+  // lookups for cookieless domains without any synchronous reads while the
+  // async read is in flight.
+  ReadDomainSet();
+
   // Init our readSet hash and execute the statements. Note that, after this
   // point, we cannot fail without altering the cleanup code in InitDBStates()
   // to handle closing of the now-asynchronous connection.
@@ -2159,6 +2166,43 @@ nsCookieService::Read()
   return RESULT_OK;
 }
 
+// Read the set of (baseDomain, appId, inBrowserElement) keys that have
+// cookies in the database. This only scans the moz_basedomain index, so it's
+// O(domains) rather than O(cookies) and doesn't touch the table itself.
+void
+nsCookieService::ReadDomainSet()
+{
+  NS_ASSERTION(mDefaultDBState->syncConn, "should have a sync db connection");
+
+  nsCOMPtr<mozIStorageStatement> stmt;
+  nsresult rv = mDefaultDBState->syncConn->CreateStatement(NS_LITERAL_CSTRING(
+    "SELECT DISTINCT baseDomain, appId, inBrowserElement "
+    "FROM moz_cookies "
+    "WHERE baseDomain NOTNULL"), getter_AddRefs(stmt));
+  if (NS_FAILED(rv)) {
+    // Not fatal; EnsureReadDomain() will just fall back to synchronous reads.
+    COOKIE_LOGSTRING(PR_LOG_DEBUG,
+      ("ReadDomainSet(): creating statement failed with rv 0x%x", rv));
+    return;
+  }
+
+  nsCString baseDomain;
+  bool hasResult;
+  while (NS_SUCCEEDED(stmt->ExecuteStep(&hasResult)) && hasResult) {
+    stmt->GetUTF8String(0, baseDomain);
+    uint32_t appId = static_cast<uint32_t>(stmt->AsInt32(1));
+    bool inBrowserElement = 0 != stmt->AsInt32(2);
+    mDefaultDBState->domainSet.PutEntry(
+      nsCookieKey(baseDomain, appId, inBrowserElement));
+  }
+
+  mDefaultDBState->domainSetLoaded = true;
+
+  COOKIE_LOGSTRING(PR_LOG_DEBUG,
+    ("ReadDomainSet(): %d domains have cookies",
+     mDefaultDBState->domainSet.Count()));
+}
+
 // Extract data from a single result row and create an nsCookie.
 // This is templated since 'T' is different for sync vs async results.
 template<class T> nsCookie*
@@ -2222,6 +2266,8 @@ nsCookieService::AsyncReadComplete()
   mDefaultDBState->syncConn = nullptr;
   mDefaultDBState->hostArray.Clear();
   mDefaultDBState->readSet.Clear();
+  mDefaultDBState->domainSet.Clear();
+  mDefaultDBState->domainSetLoaded = false;
 
   COOKIE_LOGSTRING(PR_LOG_DEBUG, ("Read(): %ld cookies read",
                                   mDefaultDBState->cookieCount));
@@ -2252,8 +2298,11 @@ nsCookieService::CancelAsyncRead(bool aPurgeReadSet)
 
   // Only clear the 'readSet' table if we no longer need to know what set of
   // data is already accounted for.
-  if (aPurgeReadSet)
+  if (aPurgeReadSet) {
     mDefaultDBState->readSet.Clear();
+    mDefaultDBState->domainSet.Clear();
+    mDefaultDBState->domainSetLoaded = false;
+  }
 }
 
 void
@@ -2270,6 +2319,15 @@ nsCookieService::EnsureReadDomain(const nsCookieKey &aKey)
   if (MOZ_LIKELY(mDefaultDBState->readSet.GetEntry(aKey)))
     return;
 
+  // Fast path 3: the domain index says this domain has no cookies at all, so
+  // there's nothing to read. Add it to the read set so we take fast path 2
+  // next time and the merge in AsyncReadComplete() stays correct.
+  if (mDefaultDBState->domainSetLoaded &&
+      !mDefaultDBState->domainSet.GetEntry(aKey)) {
+    mDefaultDBState->readSet.PutEntry(aKey);
+    return;
+  }
+
   // Read in the data synchronously.
   // see IDX_NAME, etc. for parameter indexes
   nsresult rv;
@@ -2435,6 +2493,8 @@ nsCookieService::EnsureReadComplete()
 
   mDefaultDBState->syncConn = nullptr;
   mDefaultDBState->readSet.Clear();
+  mDefaultDBState->domainSet.Clear();
+  mDefaultDBState->domainSetLoaded = false;
 
   COOKIE_LOGSTRING(PR_LOG_DEBUG,
     ("EnsureReadComplete(): %ld cookies read", array.Length()));
@@ -158,6 +158,7 @@ struct CookieDomainTuple
 struct DBState MOZ_FINAL
 {
   DBState() : cookieCount(0), cookieOldestTime(INT64_MAX), corruptFlag(OK)
+    , domainSetLoaded(false)
   {
   }
 
@@ -204,6 +205,13 @@ public:
   // in flight. This is used to keep track of which data in hostArray is stale
   // when the time comes to merge.
   nsTHashtable<nsCookieKey>        readSet;
+  // A hashset of all (baseDomain, appId, inBrowserElement) keys present in
+  // the database, loaded with a single scan of the moz_basedomain index when
+  // the connection is opened. While the async read is in flight, this lets
+  // EnsureReadDomain() answer lookups for domains that have no cookies at
+  // all -- the common case -- without any synchronous database I/O.
+  nsTHashtable<nsCookieKey>        domainSet;
+  bool                             domainSetLoaded;
 
   // DB completion handlers.
   nsCOMPtr<mozIStorageStatementCallback>  insertListener;
@@ -284,6 +292,7 @@ class nsCookieService MOZ_FINAL : public nsICookieService
     template<class T> nsCookie*   GetCookieFromRow(T &aRow);
     void                          AsyncReadComplete();
     void                          CancelAsyncRead(bool aPurgeReadSet);
+    void                          ReadDomainSet();
     void                          EnsureReadDomain(const nsCookieKey &aKey);
     void                          EnsureReadComplete();
     nsresult                      NormalizeHost(nsCString &aHost);
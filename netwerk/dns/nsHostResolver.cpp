@@ -995,13 +995,22 @@ nsHostResolver::ConditionallyCreateThread(nsHostRecord *rec)
         NS_ADDREF_THIS(); // owning reference passed to thread
 
         mThreadCount++;
-        PRThread *thr = PR_CreateThread(PR_SYSTEM_THREAD,
-                                        ThreadFunc,
-                                        this,
-                                        PR_PRIORITY_NORMAL,
-                                        PR_GLOBAL_THREAD,
-                                        PR_UNJOINABLE_THREAD,
-                                        0);
+
+        // Thread creation is expensive (libc runs res_init() for new
+        // threads); don't make unrelated lookups - cache hits included -
+        // wait on it.  The counters above already reserve our slot, so
+        // dropping the lock here is safe.
+        PRThread *thr;
+        {
+            MutexAutoUnlock unlock(mLock);
+            thr = PR_CreateThread(PR_SYSTEM_THREAD,
+                                  ThreadFunc,
+                                  this,
+                                  PR_PRIORITY_NORMAL,
+                                  PR_GLOBAL_THREAD,
+                                  PR_UNJOINABLE_THREAD,
+                                  0);
+        }
         if (!thr) {
             mThreadCount--;
             NS_RELEASE_THIS();
@@ -25,7 +25,7 @@ class nsHostResolver;
 class nsHostRecord;
 class nsResolveHostCallback;
 
-#define MAX_RESOLVER_THREADS_FOR_ANY_PRIORITY  3
+#define MAX_RESOLVER_THREADS_FOR_ANY_PRIORITY  8
 #define MAX_RESOLVER_THREADS_FOR_HIGH_PRIORITY 5
 #define MAX_NON_PRIORITY_REQUESTS 150
 
@@ -152,11 +152,13 @@ struct ParamTraits<mozilla::net::ResourceTimingStruct>
 {
   static void Write(Message* aMsg, const mozilla::net::ResourceTimingStruct& aParam)
   {
+    WriteParam(aMsg, aParam.dispatchStart);
     WriteParam(aMsg, aParam.domainLookupStart);
     WriteParam(aMsg, aParam.domainLookupEnd);
     WriteParam(aMsg, aParam.connectStart);
     WriteParam(aMsg, aParam.connectEnd);
     WriteParam(aMsg, aParam.requestStart);
+    WriteParam(aMsg, aParam.requestEnd);
     WriteParam(aMsg, aParam.responseStart);
     WriteParam(aMsg, aParam.responseEnd);
 
@@ -167,11 +169,13 @@ struct ParamTraits<mozilla::net::ResourceTimingStruct>
 
   static bool Read(const Message* aMsg, void** aIter, mozilla::net::ResourceTimingStruct* aResult)
   {
-    return ReadParam(aMsg, aIter, &aResult->domainLookupStart) &&
+    return ReadParam(aMsg, aIter, &aResult->dispatchStart) &&
+           ReadParam(aMsg, aIter, &aResult->domainLookupStart) &&
            ReadParam(aMsg, aIter, &aResult->domainLookupEnd) &&
            ReadParam(aMsg, aIter, &aResult->connectStart) &&
            ReadParam(aMsg, aIter, &aResult->connectEnd) &&
            ReadParam(aMsg, aIter, &aResult->requestStart) &&
+           ReadParam(aMsg, aIter, &aResult->requestEnd) &&
            ReadParam(aMsg, aIter, &aResult->responseStart) &&
            ReadParam(aMsg, aIter, &aResult->responseEnd) &&
            ReadParam(aMsg, aIter, &aResult->fetchStart) &&
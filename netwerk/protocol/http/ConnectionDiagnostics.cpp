@@ -216,6 +216,11 @@ Http2Session::PrintDiagnostics(nsCString &log)
 
   log.AppendPrintf("     Queued Stream Size = %d\n", mQueuedStreams.GetSize());
 
+  log.AppendPrintf("     data bytes by priority group: leader %llu other %llu "
+                   "background %llu speculative %llu follower %llu\n",
+                   mGroupReadBytes[0], mGroupReadBytes[1], mGroupReadBytes[2],
+                   mGroupReadBytes[3], mGroupReadBytes[4]);
+
   PRIntervalTime now = PR_IntervalNow();
   log.AppendPrintf("     Ping Threshold = %ums\n",
                    PR_IntervalToMilliseconds(mPingThreshold));
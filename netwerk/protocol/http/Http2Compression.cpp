@@ -532,7 +532,7 @@ Http2Decompressor::DecodeHuffmanCharacter(HuffmanIncomingTable *table,
   uint8_t idx = ExtractByte(bitsLeft, bytesConsumed);
   HuffmanIncomingEntry *entry = &(table->mEntries[idx]);
 
-  if (entry->mPtr) {
+  while (entry->mPtr) {
     if (bytesConsumed >= mDataLen) {
       if (!bitsLeft || (bytesConsumed > mDataLen)) {
         // TODO - does this get me into trouble in the new world?
@@ -546,7 +546,8 @@ Http2Decompressor::DecodeHuffmanCharacter(HuffmanIncomingTable *table,
     }
 
     // We're sorry, Mario, but your princess is in another castle
-    return DecodeHuffmanCharacter(entry->mPtr, c, bytesConsumed, bitsLeft);
+    idx = ExtractByte(bitsLeft, bytesConsumed);
+    entry = &(entry->mPtr->mEntries[idx]);
   }
 
   if (entry->mValue == 256) {
@@ -583,6 +584,12 @@ Http2Decompressor::CopyHuffmanStringFromInput(uint32_t bytes, nsACString &val)
   nsresult rv;
   uint8_t c;
 
+  // The shortest code in the table is 5 bits, so the decoded string can't
+  // be longer than 8/5 of the input. Reserving that up front keeps large
+  // values (cookies are the usual offender) from reallocating and copying
+  // the buffer repeatedly as we append one character at a time.
+  buf.SetCapacity((bytes * 8) / 5 + 1);
+
   while (bytesRead < bytes) {
     uint32_t bytesConsumed = 0;
     rv = DecodeHuffmanCharacter(&HuffmanIncomingRoot, c, bytesConsumed,
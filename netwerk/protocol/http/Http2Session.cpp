@@ -115,6 +115,7 @@ Http2Session::Http2Session(nsISocketTransport *aSocketTransport, uint32_t versio
 
   mInputFrameBuffer = new char[mInputFrameBufferSize];
   mOutputQueueBuffer = new char[mOutputQueueSize];
+  memset(mGroupReadBytes, 0, sizeof(mGroupReadBytes));
   mDecompressBuffer.SetCapacity(kDefaultBufferSize);
   mDecompressor.SetCompressor(&mCompressor);
 
@@ -918,6 +919,38 @@ Http2Session::CreatePriorityNode(uint32_t streamID, uint32_t dependsOn, uint8_t
   LogIO(this, nullptr, "Priority dep node", packet, kFrameHeaderBytes + 5);
 }
 
+void
+Http2Session::ReprioritizeTransaction(nsAHttpTransaction *aTrans,
+                                      uint32_t classOfService)
+{
+  MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread);
+
+  if (!UseH2Deps()) {
+    return;
+  }
+
+  Http2Stream *stream = mStreamTransactionHash.Get(aTrans);
+  if (!stream || !stream->StreamID() ||
+      stream->RecvdFin() || stream->RecvdReset() || stream->SentReset()) {
+    return;
+  }
+
+  uint32_t oldDependency = stream->PriorityDependency();
+  stream->UpdatePriorityDependency();
+  if (stream->PriorityDependency() == oldDependency) {
+    return;
+  }
+
+  LOG3(("Http2Session::ReprioritizeTransaction %p stream 0x%X cos 0x%X "
+        "group 0x%X -> 0x%X\n", this, stream->StreamID(), classOfService,
+        oldDependency, stream->PriorityDependency()));
+
+  EnsureOutputBuffer(kFrameHeaderBytes + 5);
+  CreatePriorityNode(stream->StreamID(), stream->PriorityDependency(),
+                     stream->PriorityWeight(), "reprioritized");
+  FlushOutputQueue();
+}
+
 // perform a bunch of integrity checks on the stream.
 // returns true if passed, false (plus LOG and ABORT) if failed.
 bool
@@ -2380,6 +2413,13 @@ Http2Session::ReadyToProcessDataFrame(enum internalStateType newState)
 
   if (mInputFrameDataStream) {
     mInputFrameDataStream->SetRecvdData(true);
+
+    // Charge the frame against the stream's priority group so per-session
+    // bandwidth allocation shows up in connection diagnostics.
+    uint32_t group = mInputFrameDataStream->PriorityDependency();
+    if (group >= kLeaderGroupID && group <= kFollowerGroupID) {
+      mGroupReadBytes[(group - kLeaderGroupID) / 2] += mInputFrameDataSize;
+    }
   }
 
   return NS_OK;
@@ -48,6 +48,12 @@ public:
   bool CanReuse() { return !mShouldGoAway && !mClosed; }
   bool RoomForMoreStreams();
 
+  // Move an already dispatched stream to the dependency group matching its
+  // transaction's updated class of service, restating the dependency to the
+  // server with a PRIORITY frame.
+  void ReprioritizeTransaction(nsAHttpTransaction *trans,
+                               uint32_t classOfService) MOZ_OVERRIDE;
+
   // When the connection is active this is called up to once every 1 second
   // return the interval (in seconds) that the connection next wants to
   // have this invoked. It might happen sooner depending on the needs of
@@ -335,6 +341,13 @@ private:
   nsDeque                                             mReadyForRead;
   nsTArray<Http2PushedStream *>                       mPushedStreams;
 
+  // Counts of DATA bytes received per priority dependency group (leader,
+  // other, background, speculative, follower - in group ID order) so the
+  // session's bandwidth allocation can be inspected via about:networking
+  // diagnostics.
+  const static uint32_t kPriorityGroupCount = 5;
+  uint64_t mGroupReadBytes[kPriorityGroupCount];
+
   // Compression contexts for header transport.
   // HTTP/2 compresses only HTTP headers and does not reset the context in between
   // frames. Even data that is not associated with a stream (e.g invalid
@@ -2390,6 +2390,12 @@ HttpBaseChannel::TimingAllowCheck(nsIPrincipal *aOrigin, bool *_retval)
   return NS_OK;
 }
 
+NS_IMETHODIMP
+HttpBaseChannel::GetDispatchStart(TimeStamp* _retval) {
+  *_retval = mTransactionTimings.dispatchStart;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 HttpBaseChannel::GetDomainLookupStart(TimeStamp* _retval) {
   *_retval = mTransactionTimings.domainLookupStart;
@@ -2420,6 +2426,12 @@ HttpBaseChannel::GetRequestStart(TimeStamp* _retval) {
   return NS_OK;
 }
 
+NS_IMETHODIMP
+HttpBaseChannel::GetRequestEnd(TimeStamp* _retval) {
+  *_retval = mTransactionTimings.requestEnd;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 HttpBaseChannel::GetResponseStart(TimeStamp* _retval) {
   *_retval = mTransactionTimings.responseStart;
@@ -2474,11 +2486,13 @@ HttpBaseChannel::Get##name##Time(PRTime* _retval) {            \
 
 IMPL_TIMING_ATTR(ChannelCreation)
 IMPL_TIMING_ATTR(AsyncOpen)
+IMPL_TIMING_ATTR(DispatchStart)
 IMPL_TIMING_ATTR(DomainLookupStart)
 IMPL_TIMING_ATTR(DomainLookupEnd)
 IMPL_TIMING_ATTR(ConnectStart)
 IMPL_TIMING_ATTR(ConnectEnd)
 IMPL_TIMING_ATTR(RequestStart)
+IMPL_TIMING_ATTR(RequestEnd)
 IMPL_TIMING_ATTR(ResponseStart)
 IMPL_TIMING_ATTR(ResponseEnd)
 IMPL_TIMING_ATTR(CacheReadStart)
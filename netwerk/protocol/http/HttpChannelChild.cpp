@@ -610,11 +610,13 @@ HttpChannelChild::OnStopRequest(const nsresult& channelStatus,
     return;
   }
 
+  mTransactionTimings.dispatchStart = timing.dispatchStart;
   mTransactionTimings.domainLookupStart = timing.domainLookupStart;
   mTransactionTimings.domainLookupEnd = timing.domainLookupEnd;
   mTransactionTimings.connectStart = timing.connectStart;
   mTransactionTimings.connectEnd = timing.connectEnd;
   mTransactionTimings.requestStart = timing.requestStart;
+  mTransactionTimings.requestEnd = timing.requestEnd;
   mTransactionTimings.responseStart = timing.responseStart;
   mTransactionTimings.responseEnd = timing.responseEnd;
   mAsyncOpenTime = timing.fetchStart;
@@ -11,11 +11,16 @@
 namespace mozilla { namespace net {
 
 struct TimingStruct {
+  // Set when the transaction leaves the connection manager's pending
+  // queue and is activated on a connection.
+  TimeStamp dispatchStart;
   TimeStamp domainLookupStart;
   TimeStamp domainLookupEnd;
   TimeStamp connectStart;
   TimeStamp connectEnd;
   TimeStamp requestStart;
+  // Set when the last byte of the request has been handed to the socket.
+  TimeStamp requestEnd;
   TimeStamp responseStart;
   TimeStamp responseEnd;
 };
@@ -70,6 +70,16 @@ public:
         // by default do nothing - only multiplexed protocols need to overload
         return;
     }
+
+    // called by the connection manager when a transaction's class of service
+    // changes after it has been dispatched, so the connection can move it in
+    // its scheduling structures. Only multiplexed protocols with a priority
+    // tree (i.e. http/2) need to overload this.
+    virtual void ReprioritizeTransaction(nsAHttpTransaction *trans,
+                                         uint32_t classOfService)
+    {
+        return;
+    }
     //
     // called by the connection manager to close a transaction being processed
     // by this connection.
@@ -9,6 +9,7 @@
 
 #include "nsHttp.h"
 #include "pldhash.h"
+#include "mozilla/ArrayUtils.h"
 #include "mozilla/Mutex.h"
 #include "mozilla/HashFunctions.h"
 #include "nsCRT.h"
@@ -46,6 +47,52 @@ static struct PLDHashTable  sAtomTable;
 static struct HttpHeapAtom *sHeapAtoms = nullptr;
 static Mutex               *sLock = nullptr;
 
+// Lock-free lookup table for the known atoms: an open-addressed table that
+// is filled once in CreateAtomTable and immutable afterwards, so it can be
+// probed from any thread without taking sLock.  Sized to a power of two
+// greater than twice NUM_HTTP_ATOMS, which keeps probe sequences short and
+// guarantees an empty slot terminates every probe.
+static const PLDHashNumber kKnownAtomTableSize = 256;
+static const char          *sKnownAtoms[kKnownAtomTableSize];
+
+// The bulk of response header values on the wire are drawn from a tiny set
+// ("gzip", "chunked", "keep-alive", ...).  These are instantiated once at
+// startup so every header array can share one heap buffer per value instead
+// of making a fresh copy; see nsHttp::GetSharedHeaderValue.
+static const char *const kCommonHeaderValues[] = {
+    "*",
+    "0",
+    "Accept-Encoding",
+    "DENY",
+    "GET",
+    "GET, POST",
+    "SAMEORIGIN",
+    "application/javascript",
+    "application/json",
+    "application/json; charset=utf-8",
+    "bytes",
+    "chunked",
+    "close",
+    "deflate",
+    "gzip",
+    "image/gif",
+    "image/jpeg",
+    "image/png",
+    "keep-alive",
+    "max-age=0",
+    "no-cache",
+    "no-store",
+    "nosniff",
+    "text/css",
+    "text/html",
+    "text/html; charset=UTF-8",
+    "text/html; charset=utf-8",
+    "text/javascript",
+    "text/plain",
+    "timeout=5, max=100"
+};
+static nsCString *sSharedHeaderValues = nullptr;
+
 HttpHeapAtom *
 NewHeapAtom(const char *value) {
     int len = strlen(value);
@@ -123,6 +170,9 @@ nsHttp::CreateAtomTable()
         nullptr
     };
 
+    static_assert(NUM_HTTP_ATOMS * 2 < kKnownAtomTableSize,
+                  "known atom table must stay less than half full");
+
     for (int i = 0; atoms[i]; ++i) {
         PLDHashEntryStub *stub = reinterpret_cast<PLDHashEntryStub *>
                                                  (PL_DHashTableOperate(&sAtomTable, atoms[i], PL_DHASH_ADD));
@@ -131,8 +181,20 @@ nsHttp::CreateAtomTable()
 
         MOZ_ASSERT(!stub->key, "duplicate static atom");
         stub->key = atoms[i];
+
+        // Mirror the known atoms into the immutable probe table so that
+        // ResolveAtom can find them without taking the lock.
+        PLDHashNumber slot = StringHash(&sAtomTable, atoms[i]) &
+                             (kKnownAtomTableSize - 1);
+        while (sKnownAtoms[slot])
+            slot = (slot + 1) & (kKnownAtomTableSize - 1);
+        sKnownAtoms[slot] = atoms[i];
     }
 
+    sSharedHeaderValues = new nsCString[ArrayLength(kCommonHeaderValues)];
+    for (size_t i = 0; i < ArrayLength(kCommonHeaderValues); ++i)
+        sSharedHeaderValues[i].Assign(kCommonHeaderValues[i]);
+
     return NS_OK;
 }
 
@@ -150,6 +212,11 @@ nsHttp::DestroyAtomTable()
         sHeapAtoms = next;
     }
 
+    memset(sKnownAtoms, 0, sizeof(sKnownAtoms));
+
+    delete [] sSharedHeaderValues;
+    sSharedHeaderValues = nullptr;
+
     if (sLock) {
         delete sLock;
         sLock = nullptr;
@@ -171,6 +238,18 @@ nsHttp::ResolveAtom(const char *str)
     if (!str || !sAtomTable.ops)
         return atom;
 
+    // Common case: a known header.  The probe table is immutable once
+    // CreateAtomTable has run, so this does not need the lock.
+    PLDHashNumber slot = StringHash(&sAtomTable, str) &
+                         (kKnownAtomTableSize - 1);
+    while (sKnownAtoms[slot]) {
+        if (!PL_strcasecmp(sKnownAtoms[slot], str)) {
+            atom._val = sKnownAtoms[slot];
+            return atom;
+        }
+        slot = (slot + 1) & (kKnownAtomTableSize - 1);
+    }
+
     MutexAutoLock lock(*sLock);
 
     PLDHashEntryStub *stub = reinterpret_cast<PLDHashEntryStub *>
@@ -193,6 +272,27 @@ nsHttp::ResolveAtom(const char *str)
     return atom;
 }
 
+// this function may be called from multiple threads; the table it probes is
+// immutable after CreateAtomTable and the shared strings use atomically
+// refcounted buffers.
+const nsCString *
+nsHttp::GetSharedHeaderValue(const nsACString &value)
+{
+    if (!sSharedHeaderValues || value.IsEmpty())
+        return nullptr;
+
+    const uint32_t length = value.Length();
+    const char first = value.First();
+    for (size_t i = 0; i < ArrayLength(kCommonHeaderValues); ++i) {
+        const nsCString &shared = sSharedHeaderValues[i];
+        if (shared.Length() == length && shared.First() == first &&
+            shared.Equals(value)) {
+            return &shared;
+        }
+    }
+    return nullptr;
+}
+
 //
 // From section 2.2 of RFC 2616, a token is defined as:
 //
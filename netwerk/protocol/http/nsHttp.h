@@ -88,6 +88,11 @@ typedef uint8_t nsHttpVersion;
 // This flag indicates the transaction should accept associated pushes
 #define NS_HTTP_ONPUSH_LISTENER      (1<<9)
 
+// a transaction with this flag carries background (not user-visible)
+// traffic and yields dispatch to foreground transactions of the same
+// priority when connections are scarce
+#define NS_HTTP_LOAD_BACKGROUND      (1<<10)
+
 //-----------------------------------------------------------------------------
 // some default values
 //-----------------------------------------------------------------------------
@@ -130,6 +135,12 @@ struct nsHttp
         return ResolveAtom(PromiseFlatCString(s).get());
     }
 
+    // Returns a long-lived string equal to |value| if it is one of the
+    // common header values seen on the wire ("gzip", "chunked", ...), else
+    // null.  Assigning from the returned string shares its buffer, so the
+    // many identical values in a header-heavy workload are stored once.
+    static const nsCString *GetSharedHeaderValue(const nsACString &value);
+
     // returns true if the specified token [start,end) is valid per RFC 2616
     // section 2.2
     static bool IsValidToken(const char *start, const char *end);
@@ -39,6 +39,7 @@
 #include "GeckoProfiler.h"
 #include "nsIConsoleService.h"
 #include "mozilla/Attributes.h"
+#include "mozilla/TraceLog.h"
 #include "mozilla/VisualEventTracer.h"
 #include "nsISSLSocketControl.h"
 #include "sslt.h"
@@ -4708,6 +4709,7 @@ NS_IMETHODIMP
 nsHttpChannel::AsyncOpen(nsIStreamListener *listener, nsISupports *context)
 {
     MOZ_EVENT_TRACER_WAIT(this, "net::http::channel");
+    MOZ_TRACELOG1(eTraceLog_HttpChannelAsyncOpen, uintptr_t(this));
 
     LOG(("nsHttpChannel::AsyncOpen [this=%p]\n", this));
 
@@ -4921,6 +4923,14 @@ nsHttpChannel::BeginConnect()
         }
     }
 
+    // Pass the background signal on to the connection manager so bulk
+    // traffic can be kept from starving foreground requests of the same
+    // priority.
+    if ((mLoadFlags & LOAD_BACKGROUND) ||
+        (mClassOfService & nsIClassOfService::Background)) {
+        mCaps |= NS_HTTP_LOAD_BACKGROUND;
+    }
+
     // Force-Reload should reset the persistent connection pool for this host
     if (mLoadFlags & LOAD_FRESH_CONNECTION) {
         // just the initial document resets the whole pool
@@ -4989,10 +4999,20 @@ nsHttpChannel::SetPriority(int32_t value)
 //-----------------------------------------------------------------------------
 // HttpChannel::nsIClassOfService
 //-----------------------------------------------------------------------------
+void
+nsHttpChannel::OnClassOfServiceUpdated()
+{
+    if (mTransaction) {
+        gHttpHandler->UpdateClassOfServiceOnTransaction(mTransaction,
+                                                        mClassOfService);
+    }
+}
+
 NS_IMETHODIMP
 nsHttpChannel::SetClassFlags(uint32_t inFlags)
 {
     mClassOfService = inFlags;
+    OnClassOfServiceUpdated();
     return NS_OK;
 }
 
@@ -5000,6 +5020,7 @@ NS_IMETHODIMP
 nsHttpChannel::AddClassFlags(uint32_t inFlags)
 {
     mClassOfService |= inFlags;
+    OnClassOfServiceUpdated();
     return NS_OK;
 }
 
@@ -5007,6 +5028,7 @@ NS_IMETHODIMP
 nsHttpChannel::ClearClassFlags(uint32_t inFlags)
 {
     mClassOfService &= ~inFlags;
+    OnClassOfServiceUpdated();
     return NS_OK;
 }
 
@@ -5250,6 +5272,8 @@ nsHttpChannel::OnStartRequest(nsIRequest *request, nsISupports *ctxt)
 
     LOG(("nsHttpChannel::OnStartRequest [this=%p request=%p status=%x]\n",
         this, request, mStatus));
+    MOZ_TRACELOG2(eTraceLog_HttpChannelOnStartRequest, uintptr_t(this),
+                  uint32_t(mStatus));
 
     // Make sure things are what we expect them to be...
     MOZ_ASSERT(request == mCachePump || request == mTransactionPump,
@@ -5352,6 +5376,8 @@ nsHttpChannel::OnStopRequest(nsIRequest *request, nsISupports *ctxt, nsresult st
 
     LOG(("nsHttpChannel::OnStopRequest [this=%p request=%p status=%x]\n",
         this, request, status));
+    MOZ_TRACELOG2(eTraceLog_HttpChannelOnStopRequest, uintptr_t(this),
+                  uint32_t(status));
 
     if (mTimingEnabled && request == mCachePump) {
         mCacheReadEnd = TimeStamp::Now();
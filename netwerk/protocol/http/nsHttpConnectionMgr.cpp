@@ -21,6 +21,9 @@
 #include "nsCOMPtr.h"
 #include "nsNetUtil.h"
 #include "mozilla/net/DNS.h"
+#include "nsICancelable.h"
+#include "nsIDNSListener.h"
+#include "nsIDNSService.h"
 #include "nsISocketTransport.h"
 #include "nsISSLSocketControl.h"
 #include "mozilla/Telemetry.h"
@@ -38,6 +41,8 @@
 // defined by the socket transport service while active
 extern PRThread *gSocketThread;
 
+static NS_DEFINE_CID(kDNSServiceCID, NS_DNSSERVICE_CID);
+
 namespace mozilla {
 namespace net {
 
@@ -45,6 +50,55 @@ namespace net {
 
 NS_IMPL_ISUPPORTS(nsHttpConnectionMgr, nsIObserver)
 
+namespace {
+
+// Listener for the prune-time speculative resolves below.  The lookup result
+// itself is not interesting, only the cache refresh it triggers.
+class DnsRefreshListener MOZ_FINAL : public nsIDNSListener
+{
+    ~DnsRefreshListener() {}
+public:
+    NS_DECL_THREADSAFE_ISUPPORTS
+
+    NS_IMETHOD OnLookupComplete(nsICancelable *request, nsIDNSRecord *rec,
+                                nsresult status) MOZ_OVERRIDE
+    {
+        return NS_OK;
+    }
+};
+
+NS_IMPL_ISUPPORTS(DnsRefreshListener, nsIDNSListener)
+
+// When we keep a connection to an origin alive past its DNS entry's
+// lifetime, refresh the entry while the answer can still be served from
+// cache: a speculative resolve is just a hash lookup when the entry is
+// fresh, and starts a TTL-driven renewal once the entry enters its grace
+// period.  That way the next transaction to this origin never pays
+// resolution latency for a host we are demonstrably still talking to.
+static void
+RefreshDnsForConnectedOrigin(nsHttpConnectionInfo *ci)
+{
+    MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread);
+
+    // Proxied connections do not resolve the origin locally.
+    if (ci->UsingProxy())
+        return;
+
+    nsresult rv;
+    nsCOMPtr<nsIDNSService> dns = do_GetService(kDNSServiceCID, &rv);
+    if (NS_FAILED(rv))
+        return;
+
+    nsCOMPtr<nsIDNSListener> listener = new DnsRefreshListener();
+    nsCOMPtr<nsICancelable> tmpOutstanding;
+    dns->AsyncResolve(ci->GetHost(),
+                      nsIDNSService::RESOLVE_SPECULATE |
+                      nsIDNSService::RESOLVE_PRIORITY_LOW,
+                      listener, nullptr, getter_AddRefs(tmpOutstanding));
+}
+
+} // anon namespace
+
 static void
 InsertTransactionSorted(nsTArray<nsHttpTransaction*> &pendingQ, nsHttpTransaction *trans)
 {
@@ -312,6 +366,22 @@ nsHttpConnectionMgr::RescheduleTransaction(nsHttpTransaction *trans, int32_t pri
     return rv;
 }
 
+nsresult
+nsHttpConnectionMgr::UpdateClassOfServiceOnTransaction(nsHttpTransaction *trans,
+                                                       uint32_t classOfService)
+{
+    LOG(("nsHttpConnectionMgr::UpdateClassOfServiceOnTransaction "
+         "[trans=%p classOfService=0x%X]\n", trans, classOfService));
+
+    NS_ADDREF(trans);
+    nsresult rv =
+        PostEvent(&nsHttpConnectionMgr::OnMsgUpdateClassOfServiceOnTransaction,
+                  static_cast<int32_t>(classOfService), trans);
+    if (NS_FAILED(rv))
+        NS_RELEASE(trans);
+    return rv;
+}
+
 nsresult
 nsHttpConnectionMgr::CancelTransaction(nsHttpTransaction *trans, nsresult reason)
 {
@@ -1001,6 +1071,11 @@ nsHttpConnectionMgr::PruneDeadConnectionsCB(const nsACString &key,
         }
     }
 
+    // Keep the DNS cache entry for this origin fresh while we hold reusable
+    // connections to it.
+    if (!ent->mIdleConns.IsEmpty() || !ent->mActiveConns.IsEmpty())
+        RefreshDnsForConnectedOrigin(ent->mConnInfo);
+
     // If time to next expire found is shorter than time to next wake-up, we need to
     // change the time for next wake-up.
     if (timeToNextExpire != UINT32_MAX) {
@@ -1155,6 +1230,10 @@ nsHttpConnectionMgr::ProcessPendingQForEntry(nsConnectionEntry *ent, bool consid
 
     ProcessSpdyPendingQ(ent);
 
+    // Give every load group a fair shot at dispatch within each priority
+    // band, and keep background bulk traffic behind foreground requests.
+    FairlyOrderPendingQ(ent->mPendingQ);
+
     nsHttpTransaction *trans;
     nsresult rv;
     bool dispatchedSuccessfully = false;
@@ -1205,6 +1284,78 @@ nsHttpConnectionMgr::ProcessPendingQForEntry(nsConnectionEntry *ent, bool consid
     return dispatchedSuccessfully;
 }
 
+// Reorder the pending queue in place so that, within each band of equal
+// priority, foreground transactions precede background ones and the rest
+// of the order round-robins across load groups.  This keeps a burst of
+// queued transactions from a single load group (e.g. a background tab's
+// bulk download) from monopolizing dispatch while another tab's requests
+// of the same priority sit behind it.
+void
+nsHttpConnectionMgr::FairlyOrderPendingQ(nsTArray<nsHttpTransaction*> &pendingQ)
+{
+    MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread);
+
+    if (pendingQ.Length() < 2)
+        return;
+
+    nsTArray<nsHttpTransaction*> ordered;
+    ordered.SetCapacity(pendingQ.Length());
+
+    // The queue is kept priority sorted by InsertTransactionSorted(), so
+    // equal priorities form contiguous bands.
+    uint32_t bandStart = 0;
+    while (bandStart < pendingQ.Length()) {
+        int32_t priority = pendingQ[bandStart]->Priority();
+        uint32_t bandEnd = bandStart + 1;
+        while (bandEnd < pendingQ.Length() &&
+               pendingQ[bandEnd]->Priority() == priority) {
+            ++bandEnd;
+        }
+
+        // pass 0 takes foreground transactions, pass 1 background ones
+        for (uint32_t pass = 0; pass < 2; ++pass) {
+            // Bucket the band's transactions by load group, preserving
+            // their relative order.
+            nsTArray<nsILoadGroupConnectionInfo*> groups;
+            nsTArray<nsTArray<nsHttpTransaction*> > buckets;
+            for (uint32_t i = bandStart; i < bandEnd; ++i) {
+                nsHttpTransaction *trans = pendingQ[i];
+                bool background =
+                    (trans->Caps() & NS_HTTP_LOAD_BACKGROUND) != 0;
+                if (background != (pass == 1))
+                    continue;
+                nsILoadGroupConnectionInfo *ci =
+                    trans->LoadGroupConnectionInfo();
+                size_t index = groups.IndexOf(ci);
+                if (index == groups.NoIndex) {
+                    index = groups.Length();
+                    groups.AppendElement(ci);
+                    buckets.AppendElement();
+                }
+                buckets[index].AppendElement(trans);
+            }
+
+            // Interleave one transaction per load group per round.
+            for (uint32_t round = 0; ; ++round) {
+                bool found = false;
+                for (uint32_t g = 0; g < buckets.Length(); ++g) {
+                    if (round < buckets[g].Length()) {
+                        ordered.AppendElement(buckets[g][round]);
+                        found = true;
+                    }
+                }
+                if (!found)
+                    break;
+            }
+        }
+
+        bandStart = bandEnd;
+    }
+
+    MOZ_ASSERT(ordered.Length() == pendingQ.Length(), "lost a transaction");
+    pendingQ.SwapElements(ordered);
+}
+
 bool
 nsHttpConnectionMgr::ProcessPendingQForEntry(nsHttpConnectionInfo *ci)
 {
@@ -2370,6 +2521,27 @@ nsHttpConnectionMgr::OnMsgReschedTransaction(int32_t priority, void *param)
     NS_RELEASE(trans);
 }
 
+void
+nsHttpConnectionMgr::OnMsgUpdateClassOfServiceOnTransaction(int32_t arg,
+                                                            void *param)
+{
+    MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread);
+    LOG(("nsHttpConnectionMgr::OnMsgUpdateClassOfServiceOnTransaction "
+         "[trans=%p]\n", param));
+
+    uint32_t classOfService = static_cast<uint32_t>(arg);
+    nsHttpTransaction *trans = (nsHttpTransaction *) param;
+    trans->SetClassOfService(classOfService);
+
+    // If the transaction is already dispatched on a multiplexed session then
+    // give that session a chance to move the stream on the wire.
+    nsAHttpConnection *conn = trans->Connection();
+    if (conn)
+        conn->ReprioritizeTransaction(trans, classOfService);
+
+    NS_RELEASE(trans);
+}
+
 void
 nsHttpConnectionMgr::OnMsgCancelTransaction(int32_t reason, void *param)
 {
@@ -3480,6 +3652,23 @@ nsHttpConnectionMgr::nsHalfOpenSocket::OnTransportStatus(nsITransport *trans,
                  mEnt->mCoalescingKey.get()));
 
             gHttpHandler->ConnMgr()->ProcessSpdyPendingQ(mEnt);
+
+            // If all of this entry's pending transactions were just
+            // coalesced onto an established session for another
+            // hostname with the same key, this handshake no longer has
+            // a customer.  Abandon the half open before paying for the
+            // TLS handshake; the entry can open a fresh socket later if
+            // non-coalescable work shows up.
+            nsConnectionEntry *preferred =
+                gHttpHandler->ConnMgr()->GetSpdyPreferredEnt(mEnt);
+            if (preferred && preferred != mEnt && mEnt->mPendingQ.IsEmpty()) {
+                LOG(("nsHttpConnectionMgr::nsHalfOpenSocket::OnTransportStatus "
+                     "[this=%p] abandoning half open for %s - pending "
+                     "transactions coalesced onto %s", this,
+                     mEnt->mConnInfo->Host(), preferred->mConnInfo->Host()));
+                Abandon();
+                return NS_OK;
+            }
         }
     }
 
@@ -85,6 +85,11 @@ public:
     // added to the connection manager via AddTransaction.
     nsresult RescheduleTransaction(nsHttpTransaction *, int32_t priority);
 
+    // called to change the class of service of a transaction after it has
+    // been dispatched; multiplexed sessions use it to reprioritize streams
+    nsresult UpdateClassOfServiceOnTransaction(nsHttpTransaction *,
+                                               uint32_t classOfService);
+
     // cancels a transaction w/ the given reason.
     nsresult CancelTransaction(nsHttpTransaction *, nsresult reason);
     nsresult CancelTransactions(nsHttpConnectionInfo *, nsresult reason);
@@ -548,6 +553,7 @@ private:
     static PLDHashOperator VerifyTrafficCB(const nsACString &, nsAutoPtr<nsConnectionEntry> &, void *);
     static PLDHashOperator PruneNoTrafficCB(const nsACString &, nsAutoPtr<nsConnectionEntry> &, void *);
     bool     ProcessPendingQForEntry(nsConnectionEntry *, bool considerAll);
+    void     FairlyOrderPendingQ(nsTArray<nsHttpTransaction*> &pendingQ);
     bool     IsUnderPressure(nsConnectionEntry *ent,
                              nsHttpTransaction::Classifier classification);
     bool     AtActiveConnectionLimit(nsConnectionEntry *, uint32_t caps);
@@ -653,6 +659,7 @@ private:
     void OnMsgShutdownConfirm      (int32_t, void *);
     void OnMsgNewTransaction       (int32_t, void *);
     void OnMsgReschedTransaction   (int32_t, void *);
+    void OnMsgUpdateClassOfServiceOnTransaction (int32_t, void *);
     void OnMsgCancelTransaction    (int32_t, void *);
     void OnMsgCancelTransactions   (int32_t, void *);
     void OnMsgProcessPendingQ      (int32_t, void *);
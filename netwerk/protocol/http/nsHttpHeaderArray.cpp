@@ -14,6 +14,19 @@
 namespace mozilla {
 namespace net {
 
+// Store |value| into |dest|, sharing the buffer of one of the preallocated
+// common-value strings when possible so identical values across responses
+// do not each get a heap copy.
+static void
+AssignHeaderValue(nsCString &dest, const nsACString &value)
+{
+    const nsCString *shared = nsHttp::GetSharedHeaderValue(value);
+    if (shared)
+        dest = *shared;
+    else
+        dest = value;
+}
+
 //-----------------------------------------------------------------------------
 // nsHttpHeaderArray <public>
 //-----------------------------------------------------------------------------
@@ -69,7 +82,7 @@ nsHttpHeaderArray::SetHeaderFromNet(nsHttpAtom header, const nsACString &value)
         if (!entry)
             return NS_ERROR_OUT_OF_MEMORY;
         entry->header = header;
-        entry->value = value;
+        AssignHeaderValue(entry->value, value);
     } else if (!IsSingletonHeader(header)) {
         MergeHeader(header, entry, value);
     } else {
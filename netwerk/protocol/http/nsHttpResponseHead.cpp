@@ -100,6 +100,20 @@ nsHttpResponseHead::Flatten(nsACString &buf, bool pruneTransients)
     }
 }
 
+// Locate the next CRLF pair.  strchr is vectorized by the C library, so
+// scanning for the CR and checking the LF beats a substring search on the
+// header blocks this is fed.
+static char *
+FindCRLF(char *p)
+{
+    while ((p = strchr(p, '\r'))) {
+        if (p[1] == '\n')
+            return p;
+        ++p;
+    }
+    return nullptr;
+}
+
 nsresult
 nsHttpResponseHead::Parse(char *block)
 {
@@ -109,7 +123,7 @@ nsHttpResponseHead::Parse(char *block)
     // this command works on a buffer as prepared by Flatten, as such it is
     // not very forgiving ;-)
 
-    char *p = PL_strstr(block, "\r\n");
+    char *p = FindCRLF(block);
     if (!p)
         return NS_ERROR_UNEXPECTED;
 
@@ -122,7 +136,7 @@ nsHttpResponseHead::Parse(char *block)
 		if (*block == 0)
 			break;
 
-        p = PL_strstr(block, "\r\n");
+        p = FindCRLF(block);
         if (!p)
             return NS_ERROR_UNEXPECTED;
 
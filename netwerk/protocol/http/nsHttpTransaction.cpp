@@ -21,11 +21,14 @@
 #include "nsISeekableStream.h"
 #include "nsMultiplexInputStream.h"
 #include "nsStringStream.h"
+#include "mozilla/Telemetry.h"
+#include "mozilla/TraceLog.h"
 #include "mozilla/VisualEventTracer.h"
 
 #include "nsComponentManagerUtils.h" // do_CreateInstance
 #include "nsServiceManagerUtils.h"   // do_GetService
 #include "nsIHttpActivityObserver.h"
+#include "nsIStreamTransportService.h"
 #include "nsSocketTransportService2.h"
 #include "nsICancelable.h"
 #include "nsIEventTarget.h"
@@ -90,6 +93,7 @@ LogHeaders(const char *lineStart)
 nsHttpTransaction::nsHttpTransaction()
     : mLock("transaction lock")
     , mRequestSize(0)
+    , mRequestRead(0)
     , mConnection(nullptr)
     , mRequestHead(nullptr)
     , mResponseHead(nullptr)
@@ -220,6 +224,9 @@ nsHttpTransaction::Init(uint32_t caps,
     nsresult rv;
 
     LOG(("nsHttpTransaction::Init [this=%p caps=%x]\n", this, caps));
+    MOZ_TRACELOG2(eTraceLog_HttpTransactionInit, uintptr_t(this), caps);
+
+    Telemetry::IncrementPerfCounter(Telemetry::PERF_COUNTER_HTTP_TRANSACTIONS);
 
     MOZ_ASSERT(cinfo);
     MOZ_ASSERT(requestHead);
@@ -370,6 +377,30 @@ nsHttpTransaction::Init(uint32_t caps,
     rv = mRequestStream->Available(&mRequestSize);
     if (NS_FAILED(rv)) return rv;
 
+    // Reading a large request body directly would issue synchronous disk
+    // reads on the socket thread, gating upload throughput on one blocking
+    // read syscall at a time.  Route such bodies through the stream
+    // transport service instead: a background thread copies the body into
+    // a bounded pipe ahead of socket demand, the pipe's ring of reusable
+    // segments provides backpressure, and ReadSegments() already knows to
+    // AsyncWait() on the pipe should it momentarily run dry.  Bodies that
+    // fit in a single buffered segment aren't worth the thread bounce.
+    if (mHasRequestBody && mRequestSize > nsIOService::gDefaultSegmentSize) {
+        nsCOMPtr<nsIStreamTransportService> sts =
+            do_GetService(NS_STREAMTRANSPORTSERVICE_CONTRACTID, &rv);
+        if (NS_FAILED(rv)) return rv;
+
+        nsCOMPtr<nsITransport> transport;
+        rv = sts->CreateInputTransport(mRequestStream, -1, -1, true,
+                                       getter_AddRefs(transport));
+        if (NS_FAILED(rv)) return rv;
+
+        rv = transport->OpenInputStream(0, nsIOService::gDefaultSegmentSize,
+                                        nsIOService::gDefaultSegmentCount,
+                                        getter_AddRefs(mRequestStream));
+        if (NS_FAILED(rv)) return rv;
+    }
+
     // create pipe for response stream
     rv = NS_NewPipe2(getter_AddRefs(mPipeIn),
                      getter_AddRefs(mPipeOut),
@@ -472,6 +503,9 @@ nsHttpTransaction::SetConnection(nsAHttpConnection *conn)
     if (conn) {
         MOZ_EVENT_TRACER_EXEC(static_cast<nsAHttpTransaction*>(this),
                               "net::http::transaction");
+        if (TimingEnabled() && mTimings.dispatchStart.IsNull()) {
+            mTimings.dispatchStart = TimeStamp::Now();
+        }
     }
 }
 
@@ -513,6 +547,10 @@ nsHttpTransaction::OnTransportStatus(nsITransport* transport,
             mTimings.connectStart = TimeStamp::Now();
         } else if (status == NS_NET_STATUS_CONNECTED_TO) {
             mTimings.connectEnd = TimeStamp::Now();
+        } else if (status == NS_NET_STATUS_WAITING_FOR &&
+                   mTimings.requestEnd.IsNull()) {
+            // The request has been fully handed to the socket.
+            mTimings.requestEnd = TimeStamp::Now();
         }
     }
 
@@ -555,12 +593,9 @@ nsHttpTransaction::OnTransportStatus(nsITransport* transport,
         if (!mHasRequestBody)
             return;
 
-        nsCOMPtr<nsISeekableStream> seekable = do_QueryInterface(mRequestStream);
-        MOZ_ASSERT(seekable, "Request stream isn't seekable?!?");
-
-        int64_t prog = 0;
-        seekable->Tell(&prog);
-        progress = prog;
+        // mRequestStream may be a non-seekable transport pipe, so progress
+        // is tracked as the stream is consumed rather than via Tell().
+        progress = mRequestRead;
 
         // when uploading, we include the request headers in the progress
         // notifications.
@@ -631,6 +666,7 @@ nsHttpTransaction::ReadRequestSegment(nsIInputStream *stream,
     }
 
     trans->CountSentBytes(*countRead);
+    trans->mRequestRead += *countRead;
     trans->mSentData = true;
     return NS_OK;
 }
@@ -797,6 +833,8 @@ void
 nsHttpTransaction::Close(nsresult reason)
 {
     LOG(("nsHttpTransaction::Close [this=%p reason=%x]\n", this, reason));
+    MOZ_TRACELOG2(eTraceLog_HttpTransactionClose, uintptr_t(this),
+                  uint32_t(reason));
 
     MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread);
 
@@ -1114,8 +1152,16 @@ nsHttpTransaction::Restart()
 
     // rewind streams in case we already wrote out the request
     nsCOMPtr<nsISeekableStream> seekable = do_QueryInterface(mRequestStream);
-    if (seekable)
+    if (seekable) {
         seekable->Seek(nsISeekableStream::NS_SEEK_SET, 0);
+        mRequestRead = 0;
+    } else if (mSentData) {
+        // request data delivered out of a transport pipe cannot be produced
+        // again; better to fail the transaction than to resend a stream
+        // that has been partially drained.
+        LOG(("cannot rewind request stream, failing transaction @%p\n", this));
+        return NS_ERROR_NET_RESET;
+    }
 
     // clear old connection state...
     mSecurityInfo = 0;
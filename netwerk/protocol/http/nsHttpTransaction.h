@@ -215,6 +215,7 @@ private:
     nsCString                       mReqHeaderBuf;    // flattened request headers
     nsCOMPtr<nsIInputStream>        mRequestStream;
     uint64_t                        mRequestSize;
+    uint64_t                        mRequestRead;     // count of consumed request bytes
 
     nsRefPtr<nsAHttpConnection>     mConnection;
     nsRefPtr<nsHttpConnectionInfo>  mConnInfo;
@@ -398,11 +399,15 @@ private:
     void                               CountRecvBytes(uint64_t recvBytes)
     {
         mCountRecv += recvBytes;
+        if (mLoadGroupCI)
+            mLoadGroupCI->AddTransferredBytes(recvBytes);
         SaveNetworkStats(false);
     }
     void                               CountSentBytes(uint64_t sentBytes)
     {
         mCountSent += sentBytes;
+        if (mLoadGroupCI)
+            mLoadGroupCI->AddTransferredBytes(sentBytes);
         SaveNetworkStats(false);
     }
 public:
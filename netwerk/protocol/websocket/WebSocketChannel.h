@@ -29,6 +29,8 @@
 #include "nsCOMPtr.h"
 #include "nsString.h"
 #include "nsDeque.h"
+#include "nsTArray.h"
+#include "mozilla/Mutex.h"
 
 class nsIAsyncVerifyRedirectCallback;
 class nsIDashboardEventNotifier;
@@ -45,6 +47,7 @@ class OutboundEnqueuer;
 class nsWSAdmissionManager;
 class nsWSCompression;
 class CallOnMessageAvailable;
+class CallOnMessagesAvailable;
 class CallOnStop;
 class CallOnServerClose;
 class CallAcknowledge;
@@ -127,6 +130,7 @@ private:
   friend class nsWSAdmissionManager;
   friend class FailDelayManager;
   friend class CallOnMessageAvailable;
+  friend class CallOnMessagesAvailable;
   friend class CallOnStop;
   friend class CallOnServerClose;
   friend class CallAcknowledge;
@@ -161,6 +165,8 @@ private:
   void EnsureHdrOut(uint32_t size);
   void ApplyMask(uint32_t mask, uint8_t *data, uint64_t len);
 
+  void DeliverOrQueueMessage(nsCString &aData, int32_t aLen);
+
   bool     IsPersistentFramePtr();
   nsresult ProcessInput(uint8_t *buffer, uint32_t count);
   bool UpdateReadBuffer(uint8_t *buffer, uint32_t count,
@@ -222,6 +228,7 @@ private:
   uint32_t                        mCalledOnStop              : 1;
   uint32_t                        mPingOutstanding           : 1;
   uint32_t                        mAllowCompression          : 1;
+  uint32_t                        mBatchedDelivery           : 1;
   uint32_t                        mAutoFollowRedirects       : 1;
   uint32_t                        mReleaseOnTransmit         : 1;
   uint32_t                        mTCPClosed                 : 1;
@@ -253,6 +260,23 @@ private:
   nsCOMPtr<nsIStreamListener>     mInflateReader;
   nsCOMPtr<nsIStringInputStream>  mInflateStream;
 
+  // An incoming data message waiting for batched delivery to the listener
+  struct PendingMessage
+  {
+    nsCString mData;
+    int32_t   mLen;   // < 0 for text messages, else the binary length
+  };
+
+  // Batched delivery (network.websocket.batched-delivery): incoming data
+  // messages are queued on the socket thread and drained on the target
+  // thread by a single runnable, so a burst of small messages costs one
+  // event loop dispatch instead of one per message. The drain yields the
+  // target thread after kBatchedDeliveryMaxPerDrain messages.
+  const static uint32_t kBatchedDeliveryMaxPerDrain = 256;
+  Mutex                           mDeliveryQueueLock;
+  nsTArray<PendingMessage>        mDeliveryQueue;
+  bool                            mDeliveryRunnablePending;
+
   // These are for the send buffers
   const static int32_t kCopyBreak = 1000;
 
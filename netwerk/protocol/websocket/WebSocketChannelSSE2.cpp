@@ -0,0 +1,35 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set sw=2 ts=8 et tw=80 : */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <emmintrin.h>
+#include <stdint.h>
+
+namespace mozilla {
+namespace net {
+
+// WebSocket frame masking for processors with SSE2: XOR the payload with the
+// 4 byte mask, 16 bytes per iteration. |aMaskWord| is the mask in wire byte
+// order, already rotated so that its first byte lines up with |aData| (the
+// caller handles any unaligned preamble; see WebSocketChannel::ApplyMask).
+// Only whole 16 byte blocks are processed; returns the number of bytes
+// consumed so the caller can finish the tail with the scalar loop.
+uint64_t
+ApplyMaskSSE2(uint32_t aMaskWord, uint8_t *aData, uint64_t aLen)
+{
+  __m128i mask = _mm_set1_epi32(static_cast<int32_t>(aMaskWord));
+  uint64_t blocks = aLen / 16;
+  for (uint64_t i = 0; i < blocks; ++i) {
+    __m128i chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(aData));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(aData),
+                     _mm_xor_si128(chunk, mask));
+    aData += 16;
+  }
+  return blocks * 16;
+}
+
+} // namespace net
+} // namespace mozilla
@@ -1350,7 +1350,9 @@ DataChannelConnection::HandleDataMessage(uint32_t ppid,
   NS_ENSURE_TRUE_VOID(channel->mState != CLOSED);
 
   {
-    nsAutoCString recvData(buffer, length); // copies (<64) or allocates
+    // A plain nsCString allocates a refcounted heap buffer, so queuing
+    // the message for delivery below shares it instead of copying again.
+    nsCString recvData(buffer, length);
     bool is_binary = true;
 
     if (ppid == DATA_CHANNEL_PPID_DOMSTRING ||
@@ -1377,10 +1379,8 @@ DataChannelConnection::HandleDataMessage(uint32_t ppid,
              length, channel->mStream));
         if (!channel->mRecvBuffer.IsEmpty()) {
           channel->mRecvBuffer += recvData;
-          LOG(("%s: sending ON_DATA (string fragmented) for %p", __FUNCTION__, channel));
-          channel->SendOrQueue(new DataChannelOnMessageAvailable(
-                                 DataChannelOnMessageAvailable::ON_DATA, this,
-                                 channel, channel->mRecvBuffer, -1));
+          LOG(("%s: queuing ON_DATA (string fragmented) for %p", __FUNCTION__, channel));
+          channel->QueueOnData(channel->mRecvBuffer, -1);
           channel->mRecvBuffer.Truncate(0);
           return;
         }
@@ -1395,11 +1395,9 @@ DataChannelConnection::HandleDataMessage(uint32_t ppid,
              length, channel->mStream));
         if (!channel->mRecvBuffer.IsEmpty()) {
           channel->mRecvBuffer += recvData;
-          LOG(("%s: sending ON_DATA (binary fragmented) for %p", __FUNCTION__, channel));
-          channel->SendOrQueue(new DataChannelOnMessageAvailable(
-                                 DataChannelOnMessageAvailable::ON_DATA, this,
-                                 channel, channel->mRecvBuffer,
-                                 channel->mRecvBuffer.Length()));
+          LOG(("%s: queuing ON_DATA (binary fragmented) for %p", __FUNCTION__, channel));
+          channel->QueueOnData(channel->mRecvBuffer,
+                               channel->mRecvBuffer.Length());
           channel->mRecvBuffer.Truncate(0);
           return;
         }
@@ -1411,10 +1409,8 @@ DataChannelConnection::HandleDataMessage(uint32_t ppid,
         return;
     }
     /* Notify onmessage */
-    LOG(("%s: sending ON_DATA for %p", __FUNCTION__, channel));
-    channel->SendOrQueue(new DataChannelOnMessageAvailable(
-                           DataChannelOnMessageAvailable::ON_DATA, this,
-                           channel, recvData, length));
+    LOG(("%s: queuing ON_DATA for %p", __FUNCTION__, channel));
+    channel->QueueOnData(recvData, length);
   }
 }
 
@@ -2589,4 +2585,22 @@ DataChannel::SendOrQueue(DataChannelOnMessageAvailable *aMessage)
   }
 }
 
+// Called with mLock locked!
+void
+DataChannel::QueueOnData(const nsACString& aData, int32_t aLen)
+{
+  PendingOnDataMessage* msg = mPendingOnData.AppendElement();
+  msg->mData = aData; // shares the buffer when aData is a heap nsCString
+  msg->mLength = aLen;
+
+  // Only dispatch a drain runnable if one isn't already in flight; it
+  // picks up everything queued before it runs.
+  if (!mOnDataBatchPending) {
+    mOnDataBatchPending = true;
+    SendOrQueue(new DataChannelOnMessageAvailable(
+                  DataChannelOnMessageAvailable::ON_DATA_BATCH,
+                  mConnection, this));
+  }
+}
+
 } // namespace mozilla
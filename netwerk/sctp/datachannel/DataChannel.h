@@ -92,6 +92,16 @@ public:
   char     *mData;
 };
 
+// A complete incoming message awaiting batched delivery to the main
+// thread.  mLength is negative for DOMString messages, matching the
+// ON_DATA convention.
+class PendingOnDataMessage
+{
+public:
+  nsCString mData;
+  int32_t   mLength;
+};
+
 // One per PeerConnection
 class DataChannelConnection: public nsITimerCallback
 #ifdef SCTP_DTLS_SUPPORTED
@@ -328,6 +338,7 @@ public:
     , mPrValue(value)
     , mFlags(flags)
     , mIsRecvBinary(false)
+    , mOnDataBatchPending(false)
     {
       NS_ASSERTION(mConnection,"NULL connection");
     }
@@ -407,6 +418,13 @@ public:
 
   void SendOrQueue(DataChannelOnMessageAvailable *aMessage);
 
+  // Queue a complete incoming message for delivery to the main thread.
+  // Must be called with mConnection->mLock held.  A single ON_DATA_BATCH
+  // runnable drains everything queued on the channel, so a burst of
+  // small messages costs one main-thread event instead of one per
+  // message.
+  void QueueOnData(const nsACString& aData, int32_t aLen);
+
 protected:
   Mutex mListenerLock; // protects mListener and mContext
   DataChannelListener *mListener;
@@ -432,6 +450,10 @@ private:
   nsCString mRecvBuffer;
   nsTArray<nsAutoPtr<BufferedMsg> > mBufferedData;
   nsTArray<nsCOMPtr<nsIRunnable> > mQueuedMessages;
+  // Complete messages waiting for the in-flight ON_DATA_BATCH runnable
+  // to drain them; both protected by mConnection->mLock
+  nsTArray<PendingOnDataMessage> mPendingOnData;
+  bool mOnDataBatchPending;
 };
 
 // used to dispatch notifications of incoming data to the main thread
@@ -447,6 +469,7 @@ public:
     ON_CHANNEL_OPEN,
     ON_CHANNEL_CLOSED,
     ON_DATA,
+    ON_DATA_BATCH,
     START_DEFER,
   };  /* types */
 
@@ -486,6 +509,33 @@ public:
   {
     MOZ_ASSERT(NS_IsMainThread());
     switch (mType) {
+      case ON_DATA_BATCH:
+        {
+          // Drain everything the channel has queued since this runnable
+          // was dispatched, then deliver it all in one main-thread event.
+          nsTArray<PendingOnDataMessage> batch;
+          {
+            MutexAutoLock lock(mConnection->mLock);
+            batch.SwapElements(mChannel->mPendingOnData);
+            mChannel->mOnDataBatchPending = false;
+          }
+
+          MutexAutoLock lock(mChannel->mListenerLock);
+          if (!mChannel->mListener) {
+            DATACHANNEL_LOG(("DataChannelOnMessageAvailable (%d) with null Listener!",mType));
+            return NS_OK;
+          }
+          for (uint32_t i = 0; i < batch.Length(); ++i) {
+            if (batch[i].mLength < 0) {
+              mChannel->mListener->OnMessageAvailable(mChannel->mContext,
+                                                      batch[i].mData);
+            } else {
+              mChannel->mListener->OnBinaryMessageAvailable(mChannel->mContext,
+                                                            batch[i].mData);
+            }
+          }
+          break;
+        }
       case ON_DATA:
       case ON_CHANNEL_OPEN:
       case ON_CHANNEL_CLOSED:
@@ -12,12 +12,14 @@
 #include "nsStreamUtils.h"
 #include "nsStringStream.h"
 #include "nsComponentManagerUtils.h"
+#include "nsThreadUtils.h"
 
 // nsISupports implementation
 NS_IMPL_ISUPPORTS(nsHTTPCompressConv,
                   nsIStreamConverter,
                   nsIStreamListener,
-                  nsIRequestObserver)
+                  nsIRequestObserver,
+                  nsIThreadRetargetableStreamListener)
 
 // nsFTPDirListingConv methods
 nsHTTPCompressConv::nsHTTPCompressConv()
@@ -78,11 +80,27 @@ nsHTTPCompressConv::AsyncConvertData(const char *aFromType,
     return NS_OK; 
 } 
 
+NS_IMETHODIMP
+nsHTTPCompressConv::CheckListenerChain()
+{
+    NS_ASSERTION(NS_IsMainThread(), "Should be on main thread!");
+    // Decompression itself keeps no thread affinity: all inflate state is
+    // only touched from OnDataAvailable, which stays serialized wherever
+    // the channel delivers it. So we are retargetable whenever the next
+    // listener in the chain is.
+    nsCOMPtr<nsIThreadRetargetableStreamListener> listener =
+        do_QueryInterface(mListener);
+    if (!listener) {
+        return NS_ERROR_NO_INTERFACE;
+    }
+    return listener->CheckListenerChain();
+}
+
 NS_IMETHODIMP
 nsHTTPCompressConv::OnStartRequest(nsIRequest* request, nsISupports *aContext)
 {
     return mListener->OnStartRequest(request, aContext);
-} 
+}
 
 NS_IMETHODIMP
 nsHTTPCompressConv::OnStopRequest(nsIRequest* request, nsISupports *aContext, 
@@ -30,6 +30,9 @@ nsHtml5SpeculativeLoad::Perform(nsHtml5TreeOpExecutor* aExecutor)
     case eSpeculativeLoadMetaReferrer:
       aExecutor->SetSpeculationReferrerPolicy(mMetaReferrerPolicy);
       break;
+    case eSpeculativeLoadFont:
+      aExecutor->PreloadFont(mUrl, mCrossOrigin);
+      break;
     case eSpeculativeLoadImage:
       aExecutor->PreloadImage(mUrl, mCrossOrigin);
       break;
@@ -16,6 +16,7 @@ enum eHtml5SpeculativeLoad {
 #endif
   eSpeculativeLoadBase,
   eSpeculativeLoadMetaReferrer,
+  eSpeculativeLoadFont,
   eSpeculativeLoadImage,
   eSpeculativeLoadScript,
   eSpeculativeLoadScriptFromHead,
@@ -45,6 +46,22 @@ class nsHtml5SpeculativeLoad {
         nsContentUtils::TrimWhitespace<nsContentUtils::IsHTMLWhitespace>(aReferrerPolicy));
     }
 
+    /**
+     * Speculative font loads are only ever triggered by
+     * <link rel="preload" as="font">. Fonts referenced from @font-face rules
+     * are started by the style system too late to beat first paint, which is
+     * the very problem rel=preload exists to solve.
+     */
+    inline void InitFont(const nsAString& aUrl,
+                         const nsAString& aCrossOrigin)
+    {
+      NS_PRECONDITION(mOpCode == eSpeculativeLoadUninitialized,
+                      "Trying to reinitialize a speculative load!");
+      mOpCode = eSpeculativeLoadFont;
+      mUrl.Assign(aUrl);
+      mCrossOrigin.Assign(aCrossOrigin);
+    }
+
     inline void InitImage(const nsAString& aUrl,
                           const nsAString& aCrossOrigin)
     {
@@ -142,9 +159,10 @@ class nsHtml5SpeculativeLoad {
      */
     nsString mTypeOrCharsetSource;
     /**
-     * If mOpCode is eSpeculativeLoadImage or eSpeculativeLoadScript[FromHead],
-     * this is the value of the "crossorigin" attribute.  If the
-     * attribute is not set, this will be a void string.
+     * If mOpCode is eSpeculativeLoadFont, eSpeculativeLoadImage or
+     * eSpeculativeLoadScript[FromHead], this is the value of the
+     * "crossorigin" attribute.  If the attribute is not set, this will be
+     * a void string.
      */
     nsString mCrossOrigin;
 };
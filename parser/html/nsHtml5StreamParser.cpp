@@ -27,6 +27,7 @@
 #include "nsPrintfCString.h"
 #include "nsNetUtil.h"
 #include "nsXULAppAPI.h"
+#include "mozilla/Telemetry.h"
 
 #include "mozilla/dom/EncodingUtils.h"
 
@@ -1429,8 +1430,30 @@ public:
   }
 };
 
+class nsHtml5SpeculationReleaser : public nsRunnable
+{
+private:
+  nsHtml5RefPtr<nsHtml5StreamParser> mStreamParser;
+  nsTArray<nsAutoPtr<nsHtml5Speculation> > mSpeculations;
+public:
+  nsHtml5SpeculationReleaser(nsHtml5StreamParser* aStreamParser,
+                             nsTArray<nsAutoPtr<nsHtml5Speculation> >& aSpeculations)
+    : mStreamParser(aStreamParser)
+  {
+    mSpeculations.SwapElements(aSpeculations);
+  }
+  NS_IMETHODIMP Run()
+  {
+    // The tokenizer mutex guards the non-atomic refcounts of the UTF-16
+    // buffers the speculations hold references to.
+    mozilla::MutexAutoLock autoLock(mStreamParser->mTokenizerMutex);
+    mSpeculations.Clear();
+    return NS_OK;
+  }
+};
+
 void
-nsHtml5StreamParser::ContinueAfterScripts(nsHtml5Tokenizer* aTokenizer, 
+nsHtml5StreamParser::ContinueAfterScripts(nsHtml5Tokenizer* aTokenizer,
                                           nsHtml5TreeBuilder* aTreeBuilder,
                                           bool aLastWasCR)
 {
@@ -1513,14 +1536,30 @@ nsHtml5StreamParser::ContinueAfterScripts(nsHtml5Tokenizer* aTokenizer,
                                       EmptyString(),
                                       speculation->GetStartLineNumber());
 
+      // Count how much of the stream gets re-tokenized, so the cost of
+      // failed speculations on document.write-heavy pages shows up in
+      // telemetry.
+      uint32_t reparsedChars = mFirstBuffer->getEnd() - mFirstBuffer->getStart();
       nsHtml5OwningUTF16Buffer* buffer = mFirstBuffer->next;
       while (buffer) {
+        reparsedChars += buffer->getEnd();
         buffer->setStart(0);
         buffer = buffer->next;
       }
-      
-      mSpeculations.Clear(); // potentially a huge number of destructors 
-                             // run here synchronously on the main thread...
+      mozilla::Telemetry::Accumulate(
+        mozilla::Telemetry::HTML5_SPECULATION_REPARSED_CHARS, reparsedChars);
+
+      // Hand the failed speculations to the parser thread for destruction;
+      // there can be a huge number of them and running their destructors
+      // here would block the main thread. If the dispatch fails, they die
+      // with the runnable right here, which is no worse than before.
+      nsCOMPtr<nsIRunnable> releaser =
+        new nsHtml5SpeculationReleaser(this, mSpeculations);
+      if (NS_FAILED(mThread->Dispatch(releaser, nsIThread::DISPATCH_NORMAL))) {
+        NS_WARNING("Failed to dispatch nsHtml5SpeculationReleaser");
+      }
+      MOZ_ASSERT(mSpeculations.IsEmpty(),
+                 "Speculations should have moved to the releaser.");
 
       mTreeBuilder->flushCharacters(); // empty the pending buffer
       mTreeBuilder->ClearOps(); // now get rid of the failed ops
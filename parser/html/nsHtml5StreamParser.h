@@ -104,6 +104,7 @@ class nsHtml5StreamParser : public nsICharsetDetectionObserver {
   friend class nsHtml5RequestStopper;
   friend class nsHtml5DataAvailable;
   friend class nsHtml5StreamParserContinuation;
+  friend class nsHtml5SpeculationReleaser;
   friend class nsHtml5TimerKungFu;
 
   public:
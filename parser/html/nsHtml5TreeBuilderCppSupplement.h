@@ -166,6 +166,50 @@ nsHtml5TreeBuilder::createElement(int32_t aNamespace, nsIAtom* aName,
                           (charset) ? *charset : EmptyString(),
                           (crossOrigin) ? *crossOrigin : NullString());
             }
+          } else if (rel && rel->LowerCaseEqualsASCII("preload")) {
+            nsString* url = aAttributes->getValue(nsHtml5AttributeName::ATTR_HREF);
+            if (url) {
+              // The "as" attribute isn't in the generated attribute name
+              // table, so find it by scanning the attribute list.
+              nsString* as = nullptr;
+              int32_t len = aAttributes->getLength();
+              for (int32_t i = 0; i < len; ++i) {
+                if (aAttributes->getLocalNameNoBoundsCheck(i)->
+                      Equals(NS_LITERAL_STRING("as"))) {
+                  as = aAttributes->getValueNoBoundsCheck(i);
+                  break;
+                }
+              }
+              nsString* crossOrigin =
+                aAttributes->getValue(nsHtml5AttributeName::ATTR_CROSSORIGIN);
+              if (!as) {
+                // Nothing to do, an "as"-less preload doesn't identify the
+                // destination of the resource.
+              } else if (as->LowerCaseEqualsASCII("font")) {
+                mSpeculativeLoadQueue.AppendElement()->
+                  InitFont(*url,
+                           (crossOrigin) ? *crossOrigin : NullString());
+              } else if (as->LowerCaseEqualsASCII("image")) {
+                mSpeculativeLoadQueue.AppendElement()->
+                  InitImage(*url,
+                            (crossOrigin) ? *crossOrigin : NullString());
+              } else if (as->LowerCaseEqualsASCII("style")) {
+                nsString* charset = aAttributes->getValue(nsHtml5AttributeName::ATTR_CHARSET);
+                mSpeculativeLoadQueue.AppendElement()->
+                  InitStyle(*url,
+                            (charset) ? *charset : EmptyString(),
+                            (crossOrigin) ? *crossOrigin : NullString());
+              } else if (as->LowerCaseEqualsASCII("script")) {
+                nsString* charset = aAttributes->getValue(nsHtml5AttributeName::ATTR_CHARSET);
+                nsString* type = aAttributes->getValue(nsHtml5AttributeName::ATTR_TYPE);
+                mSpeculativeLoadQueue.AppendElement()->
+                  InitScript(*url,
+                             (charset) ? *charset : EmptyString(),
+                             (type) ? *type : EmptyString(),
+                             (crossOrigin) ? *crossOrigin : NullString(),
+                             mode == NS_HTML5TREE_BUILDER_IN_HEAD);
+              }
+            }
           }
         } else if (nsHtml5Atoms::video == aName) {
           nsString* url = aAttributes->getValue(nsHtml5AttributeName::ATTR_POSTER);
@@ -30,6 +30,12 @@
 #include "mozilla/Preferences.h"
 #include "nsIHTMLDocument.h"
 #include "nsILoadInfo.h"
+#include "nsIClassOfService.h"
+#include "nsISupportsPriority.h"
+#include "nsIHttpChannel.h"
+#include "nsIProtocolHandler.h"
+#include "nsStreamUtils.h"
+#include "nsCrossSiteListenerProxy.h"
 
 using namespace mozilla;
 
@@ -358,7 +364,7 @@ nsHtml5TreeOpExecutor::RunFlushLoop()
   for (;;) {
     if (!mParser) {
       // Parse has terminated.
-      mOpQueue.Clear(); // clear in order to be able to assert in destructor
+      ClearOpQueue(); // clear in order to be able to assert in destructor
       return;
     }
 
@@ -396,7 +402,7 @@ nsHtml5TreeOpExecutor::RunFlushLoop()
         iter->Perform(this);
         if (MOZ_UNLIKELY(!mParser)) {
           // An extension terminated the parser from a HTTP observer.
-          mOpQueue.Clear(); // clear in order to be able to assert in destructor
+          ClearOpQueue(); // clear in order to be able to assert in destructor
           return;
         }
       }
@@ -406,7 +412,7 @@ nsHtml5TreeOpExecutor::RunFlushLoop()
                                // URLs.
       if (MOZ_UNLIKELY(!mParser)) {
         // An extension terminated the parser from a HTTP observer.
-        mOpQueue.Clear(); // clear in order to be able to assert in destructor
+        ClearOpQueue(); // clear in order to be able to assert in destructor
         return;
       }
       // Not sure if this grip is still needed, but previously, the code
@@ -422,21 +428,22 @@ nsHtml5TreeOpExecutor::RunFlushLoop()
       }
     }
 
-    if (mOpQueue.IsEmpty()) {
-      // Avoid bothering the rest of the engine with a doc update if there's 
+    if (mOpQueueStart >= mOpQueue.Length()) {
+      // Avoid bothering the rest of the engine with a doc update if there's
       // nothing to do.
+      ClearOpQueue();
       return;
     }
 
     mFlushState = eInFlush;
 
     nsIContent* scriptElement = nullptr;
-    
+
     BeginDocUpdate();
 
-    uint32_t numberOfOpsToFlush = mOpQueue.Length();
+    uint32_t numberOfOpsToFlush = mOpQueue.Length() - mOpQueueStart;
 
-    const nsHtml5TreeOperation* first = mOpQueue.Elements();
+    const nsHtml5TreeOperation* first = mOpQueue.Elements() + mOpQueueStart;
     const nsHtml5TreeOperation* last = first + numberOfOpsToFlush - 1;
     for (nsHtml5TreeOperation* iter = const_cast<nsHtml5TreeOperation*>(first);;) {
       if (MOZ_UNLIKELY(!mParser)) {
@@ -454,10 +461,19 @@ nsHtml5TreeOpExecutor::RunFlushLoop()
       // Be sure not to check the deadline if the last op was just performed.
       if (MOZ_UNLIKELY(iter == last)) {
         break;
-      } else if (MOZ_UNLIKELY(nsContentSink::DidProcessATokenImpl() == 
+      } else if (MOZ_UNLIKELY(nsContentSink::DidProcessATokenImpl() ==
                  NS_ERROR_HTMLPARSER_INTERRUPTED)) {
-        mOpQueue.RemoveElementsAt(0, (iter - first) + 1);
-        
+        // Advance the cursor past the performed ops instead of moving
+        // the remaining ones to the front of the queue, so that being
+        // interrupted many times over a large queue stays linear in the
+        // number of ops.  Trim the performed prefix once it outgrows
+        // the remainder to keep the move cost amortized constant.
+        mOpQueueStart += (iter - first) + 1;
+        if (mOpQueueStart * 2 >= mOpQueue.Length()) {
+          mOpQueue.RemoveElementsAt(0, mOpQueueStart);
+          mOpQueueStart = 0;
+        }
+
         EndDocUpdate();
 
         mFlushState = eNotFlushing;
@@ -471,9 +487,9 @@ nsHtml5TreeOpExecutor::RunFlushLoop()
       }
       ++iter;
     }
-    
-    mOpQueue.Clear();
-    
+
+    ClearOpQueue();
+
     EndDocUpdate();
 
     mFlushState = eNotFlushing;
@@ -513,7 +529,7 @@ nsHtml5TreeOpExecutor::FlushDocumentWrite()
 
   if (MOZ_UNLIKELY(!mParser)) {
     // The parse has ended.
-    mOpQueue.Clear(); // clear in order to be able to assert in destructor
+    ClearOpQueue(); // clear in order to be able to assert in destructor
     return rv;
   }
   
@@ -539,9 +555,9 @@ nsHtml5TreeOpExecutor::FlushDocumentWrite()
   
   BeginDocUpdate();
 
-  uint32_t numberOfOpsToFlush = mOpQueue.Length();
+  uint32_t numberOfOpsToFlush = mOpQueue.Length() - mOpQueueStart;
 
-  const nsHtml5TreeOperation* start = mOpQueue.Elements();
+  const nsHtml5TreeOperation* start = mOpQueue.Elements() + mOpQueueStart;
   const nsHtml5TreeOperation* end = start + numberOfOpsToFlush;
   for (nsHtml5TreeOperation* iter = const_cast<nsHtml5TreeOperation*>(start);
        iter < end;
@@ -559,8 +575,8 @@ nsHtml5TreeOpExecutor::FlushDocumentWrite()
     }
   }
 
-  mOpQueue.Clear();
-  
+  ClearOpQueue();
+
   EndDocUpdate();
 
   mFlushState = eNotFlushing;
@@ -933,6 +949,119 @@ nsHtml5TreeOpExecutor::PreloadImage(const nsAString& aURL,
   mDocument->MaybePreLoadImage(uri, aCrossOrigin, mSpeculationReferrerPolicy);
 }
 
+namespace {
+
+/**
+ * A stream listener that throws away the data it receives. The point of a
+ * speculative font load is to get the response into the HTTP cache before
+ * the @font-face machinery asks for it; the response itself is consumed
+ * later by the real load.
+ */
+class nsHtml5FontPreloadListener : public nsIStreamListener
+{
+  public:
+    NS_DECL_ISUPPORTS
+
+    NS_IMETHOD OnStartRequest(nsIRequest* aRequest, nsISupports* aContext)
+    {
+      return NS_OK;
+    }
+
+    NS_IMETHOD OnDataAvailable(nsIRequest* aRequest, nsISupports* aContext,
+                               nsIInputStream* aStream, uint64_t aOffset,
+                               uint32_t aCount)
+    {
+      uint32_t totalRead;
+      return aStream->ReadSegments(NS_DiscardSegment, nullptr, aCount,
+                                   &totalRead);
+    }
+
+    NS_IMETHOD OnStopRequest(nsIRequest* aRequest, nsISupports* aContext,
+                             nsresult aStatus)
+    {
+      return NS_OK;
+    }
+
+  private:
+    ~nsHtml5FontPreloadListener() {}
+};
+
+NS_IMPL_ISUPPORTS(nsHtml5FontPreloadListener, nsIStreamListener,
+                  nsIRequestObserver)
+
+} // anonymous namespace
+
+void
+nsHtml5TreeOpExecutor::PreloadFont(const nsAString& aURL,
+                                   const nsAString& aCrossOrigin)
+{
+  nsCOMPtr<nsIURI> uri = ConvertIfNotPreloadedYet(aURL);
+  if (!uri) {
+    return;
+  }
+
+  nsCOMPtr<nsILoadGroup> loadGroup = mDocument->GetDocumentLoadGroup();
+  nsCOMPtr<nsIChannel> channel;
+  nsresult rv = NS_NewChannel(getter_AddRefs(channel),
+                              uri,
+                              mDocument,
+                              nsILoadInfo::SEC_NORMAL,
+                              nsIContentPolicy::TYPE_FONT,
+                              loadGroup);
+  if (NS_FAILED(rv)) {
+    return;
+  }
+
+  nsCOMPtr<nsIHttpChannel> httpChannel = do_QueryInterface(channel);
+  if (httpChannel) {
+    httpChannel->SetReferrerWithPolicy(mDocument->GetDocumentURI(),
+                                       mSpeculationReferrerPolicy);
+    // Match the Accept header the font loader sends so that the cached
+    // response can actually be reused by the @font-face load.
+    nsAutoCString accept("application/font-woff;q=0.9,*/*;q=0.8");
+    if (Preferences::GetBool("gfx.downloadable_fonts.woff2.enabled")) {
+      accept.Insert(NS_LITERAL_CSTRING("application/font-woff2;q=1.0,"), 0);
+    }
+    httpChannel->SetRequestHeader(NS_LITERAL_CSTRING("Accept"), accept, false);
+  }
+
+  // Fonts block first paint, so put the speculative fetch on a high-priority
+  // lane: unblocked by the class-of-service logic so it isn't queued behind
+  // leaders, and above image traffic in the priority dispatch order.
+  nsCOMPtr<nsIClassOfService> cos = do_QueryInterface(channel);
+  if (cos) {
+    cos->AddClassFlags(nsIClassOfService::Unblocked);
+  }
+  nsCOMPtr<nsISupportsPriority> priorityChannel = do_QueryInterface(channel);
+  if (priorityChannel) {
+    priorityChannel->AdjustPriority(nsISupportsPriority::PRIORITY_HIGH);
+  }
+
+  nsRefPtr<nsHtml5FontPreloadListener> listener =
+    new nsHtml5FontPreloadListener();
+
+  // Fonts are always loaded with CORS, anonymously unless crossorigin says
+  // "use-credentials". Load the same way here, otherwise the response would
+  // be cached with the wrong credentials mode and couldn't be reused.
+  bool inherits = false;
+  rv = NS_URIChainHasFlags(uri,
+                           nsIProtocolHandler::URI_INHERITS_SECURITY_CONTEXT,
+                           &inherits);
+  if (NS_SUCCEEDED(rv) && inherits) {
+    channel->AsyncOpen(listener, nullptr);
+  } else {
+    bool withCredentials =
+      aCrossOrigin.LowerCaseEqualsLiteral("use-credentials");
+    nsRefPtr<nsCORSListenerProxy> corsListener =
+      new nsCORSListenerProxy(listener, mDocument->NodePrincipal(),
+                              withCredentials);
+    rv = corsListener->Init(channel);
+    if (NS_SUCCEEDED(rv)) {
+      channel->AsyncOpen(corsListener, nullptr);
+    }
+  }
+}
+
 void
 nsHtml5TreeOpExecutor::AddBase(const nsAString& aURL)
 {
@@ -60,6 +60,15 @@ class nsHtml5TreeOpExecutor MOZ_FINAL : public nsHtml5DocumentBuilder,
     
     bool                                 mReadingFromStage;
     nsTArray<nsHtml5TreeOperation>       mOpQueue;
+
+    /**
+     * Index of the first op in mOpQueue that hasn't been performed yet.
+     * Non-zero only between an interrupted flush and the continuation
+     * that resumes it; keeping a cursor instead of removing the
+     * performed prefix on every interruption avoids moving the
+     * remaining ops once per main-thread slice.
+     */
+    uint32_t                             mOpQueueStart;
     nsHtml5StreamParser*                 mStreamParser;
     
     /**
@@ -264,6 +273,8 @@ class nsHtml5TreeOpExecutor MOZ_FINAL : public nsHtml5DocumentBuilder,
 
     void PreloadImage(const nsAString& aURL, const nsAString& aCrossOrigin);
 
+    void PreloadFont(const nsAString& aURL, const nsAString& aCrossOrigin);
+
     void SetSpeculationBase(const nsAString& aURL);
 
     void SetSpeculationReferrerPolicy(ReferrerPolicy aReferrerPolicy);
@@ -278,6 +289,15 @@ class nsHtml5TreeOpExecutor MOZ_FINAL : public nsHtml5DocumentBuilder,
 
     bool IsExternalViewSource();
 
+    /**
+     * Drop all queued ops (performed or not) and rewind the cursor.
+     */
+    void ClearOpQueue()
+    {
+      mOpQueue.Clear();
+      mOpQueueStart = 0;
+    }
+
     /**
      * Get a nsIURI for an nsString if the URL hasn't been preloaded yet.
      */
@@ -17,6 +17,7 @@
 #include "pkix/pkix.h"
 #include "pkix/pkixnss.h"
 #include "prerror.h"
+#include "prtime.h"
 #include "secerr.h"
 #include "sslerr.h"
 
@@ -32,6 +33,11 @@ namespace mozilla { namespace psm {
 const CertVerifier::Flags CertVerifier::FLAG_LOCAL_ONLY = 1;
 const CertVerifier::Flags CertVerifier::FLAG_MUST_BE_EV = 2;
 
+// How long a successful SSL server certificate verification may be reused.
+// Kept short so that a revocation or a trust change is picked up quickly;
+// the OCSP cache makes re-verification after expiry comparatively cheap.
+static const uint64_t VerifiedChainCacheEntryLifetimeSeconds = 10 * 60;
+
 CertVerifier::CertVerifier(ocsp_download_config odc,
                            ocsp_strict_config osc,
                            ocsp_get_config ogc,
@@ -463,6 +469,32 @@ CertVerifier::VerifySSLServerCert(CERTCertificate* peerCert,
     return SECFailure;
   }
 
+  // The policy word distinguishes verifications that would otherwise take
+  // different paths below: the verifier flags, whether intermediates are
+  // saved, and whether the caller asked for EV status.
+  uint32_t policy = flags;
+  if (saveIntermediatesInPermanentDatabase) {
+    policy |= 1u << 31;
+  }
+  if (evOidPolicy) {
+    policy |= 1u << 30;
+  }
+
+  // Entries are only cached after the entire verification below (including
+  // the hostname check) succeeded, so a cache hit can short-circuit it.
+  SECOidTag cachedEVPolicy;
+  ScopedCERTCertList cachedChain;
+  if (mVerifiedChainCache.Get(peerCert->derCert, hostname, policy, time,
+                              cachedEVPolicy, cachedChain)) {
+    if (evOidPolicy) {
+      *evOidPolicy = cachedEVPolicy;
+    }
+    if (builtChain) {
+      *builtChain = cachedChain.forget();
+    }
+    return SECSuccess;
+  }
+
   ScopedCERTCertList builtChainTemp;
   // CreateCertErrorRunnable assumes that CheckCertHostname is only called
   // if VerifyCert succeeded.
@@ -496,6 +528,25 @@ CertVerifier::VerifySSLServerCert(CERTCertificate* peerCert,
     SaveIntermediateCerts(builtChainTemp);
   }
 
+  // Remember the successful verification for a short time so that concurrent
+  // handshakes to the same origin don't each repeat the work. The entry's
+  // lifetime is additionally bounded by the certificate's own expiration.
+  Time validThrough(time);
+  if (validThrough.AddSeconds(VerifiedChainCacheEntryLifetimeSeconds)
+        == Success) {
+    PRTime notBefore;
+    PRTime notAfter;
+    if (CERT_GetCertTimes(peerCert, &notBefore, &notAfter) == SECSuccess) {
+      Time certNotAfter(TimeFromEpochInSeconds(notAfter / PR_USEC_PER_SEC));
+      if (certNotAfter < validThrough) {
+        validThrough = certNotAfter;
+      }
+      mVerifiedChainCache.Put(peerCert->derCert, hostname, policy,
+                              evOidPolicy ? *evOidPolicy : SEC_OID_UNKNOWN,
+                              validThrough, builtChainTemp.get());
+    }
+  }
+
   if (builtChain) {
     *builtChain = builtChainTemp.forget();
   }
@@ -10,6 +10,7 @@
 #include "pkix/pkixtypes.h"
 #include "OCSPCache.h"
 #include "ScopedNSSTypes.h"
+#include "VerifiedChainCache.h"
 
 namespace mozilla { namespace psm {
 
@@ -78,6 +79,7 @@ public:
   ~CertVerifier();
 
   void ClearOCSPCache() { mOCSPCache.Clear(); }
+  void ClearVerifiedChainCache() { mVerifiedChainCache.Clear(); }
 
   const bool mOCSPDownloadEnabled;
   const bool mOCSPStrict;
@@ -86,6 +88,7 @@ public:
 
 private:
   OCSPCache mOCSPCache;
+  VerifiedChainCache mVerifiedChainCache;
 };
 
 void InitCertVerifierLog();
@@ -0,0 +1,245 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "VerifiedChainCache.h"
+
+#include <string.h>
+
+#include "cert.h"
+#include "pk11pub.h"
+#include "prlog.h"
+
+#ifdef PR_LOGGING
+extern PRLogModuleInfo* gCertVerifierLog;
+#endif
+
+using namespace mozilla::pkix;
+
+namespace mozilla { namespace psm {
+
+// The value calculated is
+// SHA384(derPeerCert || hostname || policy) where policy is the
+// little-endian encoding of the 32-bit policy word. The DER encoding
+// includes the length of the data encoded, so there do not exist
+// A(derPeerCertA, hostnameA, policyA) and B(derPeerCertB, hostnameB,
+// policyB) such that the concatenation of each triplet results in the same
+// string of bytes but where each part in A is not equal to its counterpart
+// in B. As with the OCSP cache, it is thus computationally infeasible to
+// find collisions that would subvert this cache (given that SHA384 is a
+// cryptographically-secure hash function).
+static SECStatus
+VerificationKeyHash(uint8_t (&buf)[SHA384_LENGTH], const SECItem& peerCertDER,
+                    const char* hostname, uint32_t policy)
+{
+  ScopedPK11Context context(PK11_CreateDigestContext(SEC_OID_SHA384));
+  if (!context) {
+    return SECFailure;
+  }
+  SECStatus rv = PK11_DigestBegin(context.get());
+  if (rv != SECSuccess) {
+    return rv;
+  }
+  rv = PK11_DigestOp(context.get(), peerCertDER.data, peerCertDER.len);
+  if (rv != SECSuccess) {
+    return rv;
+  }
+  rv = PK11_DigestOp(context.get(),
+                     reinterpret_cast<const unsigned char*>(hostname),
+                     strlen(hostname));
+  if (rv != SECSuccess) {
+    return rv;
+  }
+  uint8_t policyBytes[4];
+  policyBytes[0] = policy & 0xff;
+  policyBytes[1] = (policy >> 8) & 0xff;
+  policyBytes[2] = (policy >> 16) & 0xff;
+  policyBytes[3] = (policy >> 24) & 0xff;
+  rv = PK11_DigestOp(context.get(), policyBytes, sizeof(policyBytes));
+  if (rv != SECSuccess) {
+    return rv;
+  }
+  uint32_t outLen = 0;
+  rv = PK11_DigestFinal(context.get(), buf, &outLen, SHA384_LENGTH);
+  if (outLen != SHA384_LENGTH) {
+    return SECFailure;
+  }
+  return rv;
+}
+
+static CERTCertList*
+DupCertChain(CERTCertList* aChain)
+{
+  ScopedCERTCertList copy(CERT_NewCertList());
+  if (!copy) {
+    return nullptr;
+  }
+  for (CERTCertListNode* node = CERT_LIST_HEAD(aChain);
+       !CERT_LIST_END(node, aChain); node = CERT_LIST_NEXT(node)) {
+    CERTCertificate* cert = CERT_DupCertificate(node->cert);
+    if (!cert) {
+      return nullptr;
+    }
+    if (CERT_AddCertToListTail(copy.get(), cert) != SECSuccess) {
+      CERT_DestroyCertificate(cert);
+      return nullptr;
+    }
+  }
+  return copy.forget();
+}
+
+SECStatus
+VerifiedChainCache::Entry::Init(const SECItem& aPeerCertDER,
+                                const char* aHostname, uint32_t aPolicy,
+                                CERTCertList* aBuiltChain)
+{
+  if (aBuiltChain) {
+    mChain = DupCertChain(aBuiltChain);
+    if (!mChain) {
+      return SECFailure;
+    }
+  }
+  return VerificationKeyHash(mKeyHash, aPeerCertDER, aHostname, aPolicy);
+}
+
+VerifiedChainCache::VerifiedChainCache()
+  : mMutex("VerifiedChainCache-mutex")
+{
+}
+
+VerifiedChainCache::~VerifiedChainCache()
+{
+  Clear();
+}
+
+// Returns false with index in an undefined state if no matching entry was
+// found.
+bool
+VerifiedChainCache::FindInternal(const SECItem& aPeerCertDER,
+                                 const char* aHostname, uint32_t aPolicy,
+                                 /*out*/ size_t& index,
+                                 const MutexAutoLock& /* aProofOfLock */)
+{
+  if (mEntries.length() == 0) {
+    return false;
+  }
+
+  uint8_t keyHash[SHA384_LENGTH];
+  if (VerificationKeyHash(keyHash, aPeerCertDER, aHostname, aPolicy)
+        != SECSuccess) {
+    return false;
+  }
+
+  // mEntries is sorted with the most-recently-used entry at the end.
+  // Thus, searching from the end will often be fastest.
+  index = mEntries.length();
+  while (index > 0) {
+    --index;
+    if (memcmp(mEntries[index]->mKeyHash, keyHash, SHA384_LENGTH) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+VerifiedChainCache::MakeMostRecentlyUsed(size_t aIndex,
+                                         const MutexAutoLock& /* aProofOfLock */)
+{
+  Entry* entry = mEntries[aIndex];
+  // Since mEntries is sorted with the most-recently-used entry at the end,
+  // aIndex is likely to be near the end, so this is likely to be fast.
+  mEntries.erase(mEntries.begin() + aIndex);
+  mEntries.append(entry);
+}
+
+bool
+VerifiedChainCache::Get(const SECItem& aPeerCertDER, const char* aHostname,
+                        uint32_t aPolicy, Time aTime,
+                        /*out*/ SECOidTag& aEVOidPolicy,
+                        /*out*/ ScopedCERTCertList& aBuiltChain)
+{
+  MutexAutoLock lock(mMutex);
+
+  size_t index;
+  if (!FindInternal(aPeerCertDER, aHostname, aPolicy, index, lock)) {
+    PR_LOG(gCertVerifierLog, PR_LOG_DEBUG,
+           ("VerifiedChainCache::Get('%s') not in cache", aHostname));
+    return false;
+  }
+  if (mEntries[index]->mValidThrough < aTime) {
+    PR_LOG(gCertVerifierLog, PR_LOG_DEBUG,
+           ("VerifiedChainCache::Get('%s') expired - evicting", aHostname));
+    delete mEntries[index];
+    mEntries.erase(mEntries.begin() + index);
+    return false;
+  }
+  PR_LOG(gCertVerifierLog, PR_LOG_DEBUG,
+         ("VerifiedChainCache::Get('%s') in cache", aHostname));
+  aEVOidPolicy = mEntries[index]->mEVOidPolicy;
+  if (mEntries[index]->mChain) {
+    aBuiltChain = DupCertChain(mEntries[index]->mChain.get());
+    if (!aBuiltChain) {
+      // Treat an out-of-memory duplication as a miss rather than failing
+      // what would otherwise be a successful verification.
+      return false;
+    }
+  }
+  MakeMostRecentlyUsed(index, lock);
+  return true;
+}
+
+void
+VerifiedChainCache::Put(const SECItem& aPeerCertDER, const char* aHostname,
+                        uint32_t aPolicy, SECOidTag aEVOidPolicy,
+                        Time aValidThrough, CERTCertList* aBuiltChain)
+{
+  MutexAutoLock lock(mMutex);
+
+  size_t index;
+  if (FindInternal(aPeerCertDER, aHostname, aPolicy, index, lock)) {
+    mEntries[index]->mEVOidPolicy = aEVOidPolicy;
+    mEntries[index]->mValidThrough = aValidThrough;
+    MakeMostRecentlyUsed(index, lock);
+    return;
+  }
+
+  if (mEntries.length() == MaxEntries) {
+    PR_LOG(gCertVerifierLog, PR_LOG_DEBUG,
+           ("VerifiedChainCache::Put('%s') too full - evicting LRU entry",
+            aHostname));
+    delete mEntries[0];
+    mEntries.erase(mEntries.begin());
+  }
+
+  Entry* entry = new (std::nothrow) Entry(aEVOidPolicy, aValidThrough);
+  if (!entry) {
+    return;
+  }
+  if (entry->Init(aPeerCertDER, aHostname, aPolicy, aBuiltChain)
+        != SECSuccess) {
+    delete entry;
+    return;
+  }
+  if (!mEntries.append(entry)) {
+    delete entry;
+    return;
+  }
+  PR_LOG(gCertVerifierLog, PR_LOG_DEBUG,
+         ("VerifiedChainCache::Put('%s') added to cache", aHostname));
+}
+
+void
+VerifiedChainCache::Clear()
+{
+  MutexAutoLock lock(mMutex);
+  PR_LOG(gCertVerifierLog, PR_LOG_DEBUG, ("VerifiedChainCache::Clear()"));
+  for (Entry** entry = mEntries.begin(); entry < mEntries.end(); entry++) {
+    delete *entry;
+  }
+  mEntries.clearAndFree();
+}
+
+} } // namespace mozilla::psm
@@ -0,0 +1,91 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_psm_VerifiedChainCache_h
+#define mozilla_psm_VerifiedChainCache_h
+
+#include "certt.h"
+#include "hasht.h"
+#include "mozilla/Mutex.h"
+#include "mozilla/Vector.h"
+#include "pkix/Time.h"
+#include "ScopedNSSTypes.h"
+#include "seccomon.h"
+#include "secoidt.h"
+
+namespace mozilla { namespace psm {
+
+// VerifiedChainCache remembers recent successful SSL server certificate
+// verifications so that many concurrent handshakes to the same origins (for
+// example, at startup) don't each pay for chain building, signature checking
+// and OCSP fetching on the certificate verification thread pool.
+//
+// Each entry is keyed on a hash of the peer certificate's DER encoding, the
+// hostname that was verified, and the verification policy (the verifier flags
+// and related call parameters), so a hit guarantees an identical verification
+// already succeeded, including the hostname check. Only successes are cached;
+// failures are always re-verified. Entries expire after a short lifetime
+// (bounded additionally by the certificate's notAfter) so a revocation or
+// trust change is picked up quickly, and the cache must be cleared outright
+// when trust settings change.
+// VerifiedChainCache is thread-safe.
+class VerifiedChainCache
+{
+public:
+  VerifiedChainCache();
+  ~VerifiedChainCache();
+
+  // Returns true and outputs the cached EV policy and a duplicate of the
+  // verified chain if an unexpired entry matches; returns false otherwise.
+  bool Get(const SECItem& aPeerCertDER, const char* aHostname,
+           uint32_t aPolicy, mozilla::pkix::Time aTime,
+           /*out*/ SECOidTag& aEVOidPolicy,
+           /*out*/ ScopedCERTCertList& aBuiltChain);
+
+  // Caches a successful verification. Takes its own references to the given
+  // chain. The entry is considered trustworthy through the given time.
+  void Put(const SECItem& aPeerCertDER, const char* aHostname,
+           uint32_t aPolicy, SECOidTag aEVOidPolicy,
+           mozilla::pkix::Time aValidThrough, CERTCertList* aBuiltChain);
+
+  // Removes everything from the cache.
+  void Clear();
+
+private:
+  class Entry
+  {
+  public:
+    Entry(SECOidTag aEVOidPolicy, mozilla::pkix::Time aValidThrough)
+      : mEVOidPolicy(aEVOidPolicy)
+      , mValidThrough(aValidThrough)
+    {
+    }
+    SECStatus Init(const SECItem& aPeerCertDER, const char* aHostname,
+                   uint32_t aPolicy, CERTCertList* aBuiltChain);
+
+    SECOidTag mEVOidPolicy;
+    mozilla::pkix::Time mValidThrough;
+    ScopedCERTCertList mChain;
+    // The SHA-384 hash of the peer certificate's DER encoding followed by
+    // the hostname and the policy word. See the documentation for
+    // VerificationKeyHash in VerifiedChainCache.cpp.
+    uint8_t mKeyHash[SHA384_LENGTH];
+  };
+
+  bool FindInternal(const SECItem& aPeerCertDER, const char* aHostname,
+                    uint32_t aPolicy, /*out*/ size_t& index,
+                    const MutexAutoLock& aProofOfLock);
+  void MakeMostRecentlyUsed(size_t aIndex, const MutexAutoLock& aProofOfLock);
+
+  Mutex mMutex;
+  static const size_t MaxEntries = 128;
+  // Sorted with the most-recently-used entry at the end.
+  Vector<Entry*, 256> mEntries;
+};
+
+} } // namespace mozilla::psm
+
+#endif // mozilla_psm_VerifiedChainCache_h
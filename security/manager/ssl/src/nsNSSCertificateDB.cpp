@@ -934,6 +934,17 @@ loser:
   return rv;
 }
 
+// A trust change invalidates any verification results memoized by the
+// default verifier, so they must be dropped along with it.
+static void
+ClearVerifiedChainCacheForTrustChange()
+{
+  RefPtr<SharedCertVerifier> certVerifier(GetDefaultCertVerifier());
+  if (certVerifier) {
+    certVerifier->ClearVerifiedChainCache();
+  }
+}
+
 /*
  * void deleteCertificate(in nsIX509Cert aCert);
  */
@@ -970,6 +981,7 @@ nsNSSCertificateDB::DeleteCertificate(nsIX509Cert *aCert)
                                cert.get(), trust.GetTrust());
   }
   PR_LOG(gPIPNSSLog, PR_LOG_DEBUG, ("cert deleted: %d", srv));
+  ClearVerifiedChainCacheForTrustChange();
   return (srv) ? NS_ERROR_FAILURE : NS_OK;
 }
 
@@ -1024,6 +1036,9 @@ nsNSSCertificateDB::SetCertTrust(nsIX509Cert *cert,
     // ignore user certs
     return NS_OK;
   }
+  if (srv == SECSuccess) {
+    ClearVerifiedChainCacheForTrustChange();
+  }
   return MapSECStatus(srv);
 }
 
@@ -1681,6 +1696,9 @@ nsNSSCertificateDB::SetCertTrustFromString(nsIX509Cert* cert,
   }
 
   srv = CERT_ChangeCertTrust(CERT_GetDefaultCertDB(), nssCert.get(), &trust);
+  if (srv == SECSuccess) {
+    ClearVerifiedChainCacheForTrustChange();
+  }
   return MapSECStatus(srv);
 }
 
@@ -1784,5 +1802,6 @@ nsNSSCertificateDB::ClearOCSPCache()
   RefPtr<SharedCertVerifier> certVerifier(GetDefaultCertVerifier());
   NS_ENSURE_TRUE(certVerifier, NS_ERROR_FAILURE);
   certVerifier->ClearOCSPCache();
+  certVerifier->ClearVerifiedChainCache();
   return NS_OK;
 }
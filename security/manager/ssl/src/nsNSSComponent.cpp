@@ -735,6 +735,15 @@ static const bool FALSE_START_ENABLED_DEFAULT = true;
 static const bool NPN_ENABLED_DEFAULT = true;
 static const bool ALPN_ENABLED_DEFAULT = false;
 
+// TLS session resumption state (session IDs and session tickets) lives in
+// NSS's in-process client session cache. That cache is already shared by
+// every tab and content process because all TLS handshakes run on the
+// parent's socket thread; necko is remoted, so content processes never
+// handshake themselves. A Gecko-level store that shares or persists
+// resumption state beyond this would need NSS to expose its resumption
+// tokens, and this version of NSS has no export/import API for them
+// (sslnonce.c keeps sslSessionID entries entirely internal), so sessions
+// cannot outlive the parent process.
 static void
 ConfigureTLSSessionIdentifiers()
 {
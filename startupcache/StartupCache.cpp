@@ -90,9 +90,6 @@ StartupCache*
 StartupCache::GetSingleton()
 {
   if (!gStartupCache) {
-    if (XRE_GetProcessType() != GeckoProcessType_Default) {
-      return nullptr;
-    }
 #ifdef MOZ_DISABLE_STARTUPCACHE
     return nullptr;
 #endif
@@ -130,7 +127,13 @@ enum StartupCache::TelemetrifyAge StartupCache::gPostFlushAgeAction = StartupCac
 NS_IMPL_ISUPPORTS(StartupCache, nsIMemoryReporter)
 
 StartupCache::StartupCache()
-  : mArchive(nullptr), mStartupWriteInitiated(false), mWriteThread(nullptr)
+  : mArchive(nullptr), mStartupWriteInitiated(false),
+    // Only the chrome process may write the cache file. Content processes
+    // open it read-only; since the archive is memory-mapped, the file's
+    // pages are shared between all processes by the OS page cache instead
+    // of being duplicated in each process's heap.
+    mReadOnly(XRE_GetProcessType() != GeckoProcessType_Default),
+    mWriteThread(nullptr)
 { }
 
 StartupCache::~StartupCache()
@@ -148,7 +151,7 @@ StartupCache::~StartupCache()
   // it on the main thread and block the shutdown we simply wont update
   // the startup cache. Always do this if the file doesn't exist since
   // we use it part of the package step.
-  if (!mArchive) {
+  if (!mArchive && !mReadOnly) {
     WriteToDisk();
   }
 
@@ -179,7 +182,7 @@ StartupCache::Init()
 
     nsCOMPtr<nsIFile> profDir;
     NS_GetSpecialDirectory("ProfDS", getter_AddRefs(profDir));
-    if (profDir) {
+    if (profDir && !mReadOnly) {
       bool same;
       if (NS_SUCCEEDED(profDir->Equals(file, &same)) && !same) {
         // We no longer store the startup cache in the main profile
@@ -195,9 +198,11 @@ StartupCache::Init()
     NS_ENSURE_SUCCESS(rv, rv);
 
     // Try to create the directory if it's not there yet
-    rv = file->Create(nsIFile::DIRECTORY_TYPE, 0777);
-    if (NS_FAILED(rv) && rv != NS_ERROR_FILE_ALREADY_EXISTS)
-      return rv;
+    if (!mReadOnly) {
+      rv = file->Create(nsIFile::DIRECTORY_TYPE, 0777);
+      if (NS_FAILED(rv) && rv != NS_ERROR_FILE_ALREADY_EXISTS)
+        return rv;
+    }
 
 #if defined(XP_WIN) && defined(MOZ_METRO)
     if (XRE_GetWindowsEnvironment() == WindowsEnvironmentType_Metro) {
@@ -230,7 +235,7 @@ StartupCache::Init()
                                      false);
   NS_ENSURE_SUCCESS(rv, rv);
 
-  rv = LoadArchive(RECORD_AGE);
+  rv = LoadArchive(mReadOnly ? IGNORE_AGE : RECORD_AGE);
 
   // Sometimes we don't have a cache yet, that's ok.
   // If it's corrupted, just remove it and start over.
@@ -350,7 +355,7 @@ StartupCache::PutBuffer(const char* id, const char* inbuf, uint32_t len)
 {
   NS_ASSERTION(NS_IsMainThread(), "Startup cache only available on main thread");
   WaitOnWriteThread();
-  if (StartupCache::gShutdownInitiated) {
+  if (StartupCache::gShutdownInitiated || mReadOnly) {
     return NS_ERROR_NOT_AVAILABLE;
   }
 
@@ -415,6 +420,10 @@ CacheCloseHelper(const nsACString& key, nsAutoPtr<CacheEntry>& data,
   nsIStringInputStream* stream = holder->stream;
   nsIZipWriter* writer = holder->writer;
 
+  // Store entries uncompressed.  nsZipItemPtr does zero-copy reads of
+  // stored members straight out of the archive's file mapping, so reads
+  // skip per-entry inflation into private heap, and the mapped pages are
+  // shared read-only with any other process that has the file mapped.
   stream->ShareData(data->data, data->size);
 
 #ifdef DEBUG
@@ -423,7 +432,8 @@ CacheCloseHelper(const nsACString& key, nsAutoPtr<CacheEntry>& data,
   NS_ASSERTION(NS_SUCCEEDED(rv) && hasEntry == false, 
                "Existing entry in disk StartupCache.");
 #endif
-  rv = writer->AddEntryStream(key, holder->time, true, stream, false);
+  rv = writer->AddEntryStream(key, holder->time, nsIZipWriter::COMPRESSION_NONE,
+                              stream, false);
   
   if (NS_FAILED(rv)) {
     NS_WARNING("cache entry deleted but not written to disk.");
@@ -437,12 +447,12 @@ CacheCloseHelper(const nsACString& key, nsAutoPtr<CacheEntry>& data,
  * to make sure there isn't a write happening on another thread
  */
 void
-StartupCache::WriteToDisk() 
+StartupCache::WriteToDisk()
 {
   nsresult rv;
   mStartupWriteInitiated = true;
 
-  if (mTable.Count() == 0)
+  if (mReadOnly || mTable.Count() == 0)
     return;
 
   nsCOMPtr<nsIZipWriter> zipW = do_CreateInstance("@mozilla.org/zipwriter;1");
@@ -494,11 +504,16 @@ StartupCache::WriteToDisk()
 }
 
 void
-StartupCache::InvalidateCache() 
+StartupCache::InvalidateCache()
 {
   WaitOnWriteThread();
   mTable.Clear();
   mArchive = nullptr;
+  if (mReadOnly) {
+    // The file belongs to the chrome process; just stop using it.
+    gIgnoreDiskCache = true;
+    return;
+  }
   nsresult rv = mFile->Remove(false);
   if (NS_FAILED(rv) && rv != NS_ERROR_FILE_TARGET_DOES_NOT_EXIST &&
       rv != NS_ERROR_FILE_NOT_FOUND) {
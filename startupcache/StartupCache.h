@@ -32,6 +32,11 @@
  * it will fail to link in non-libxul builds. The XPCOM interface is provided
  * only to allow compiled-code tests; clients should avoid using it.
  *
+ * Only the chrome process writes the cache file; content processes open it
+ * read-only (PutBuffer fails there). Entries are stored uncompressed so that
+ * reads are served directly from the archive's file mapping, whose pages the
+ * OS shares between every process that has the file mapped.
+ *
  * The API provided is very simple: GetBuffer() returns a buffer that was previously
  * stored in the cache (if any), and PutBuffer() inserts a buffer into the cache.
  * GetBuffer returns a new buffer, and the caller must take ownership of it.
@@ -172,6 +177,9 @@ private:
   nsCOMPtr<nsITimer> mTimer;
 
   bool mStartupWriteInitiated;
+  // True outside the chrome process: the cache file is used via its shared
+  // read-only mapping and is never written or invalidated on disk.
+  bool mReadOnly;
 
   static StaticRefPtr<StartupCache> gStartupCache;
   static bool gShutdownInitiated;
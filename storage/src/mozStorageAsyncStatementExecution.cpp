@@ -588,7 +588,7 @@ AsyncExecuteStatements::Run()
 
   if (statementsNeedTransaction()) {
     if (NS_SUCCEEDED(mConnection->beginTransactionInternal(mNativeConnection,
-                                                           mozIStorageConnection::TRANSACTION_IMMEDIATE))) {
+                                                           mConnection->getDefaultTransactionType()))) {
       mHasTransaction = true;
     }
 #ifdef DEBUG
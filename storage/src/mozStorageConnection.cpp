@@ -475,8 +475,10 @@ Connection::Connection(Service *aService,
 , mAsyncExecutionThreadShuttingDown(false)
 , mConnectionClosed(false)
 , mTransactionInProgress(false)
+, mDefaultTransactionType(mozIStorageConnection::TRANSACTION_IMMEDIATE)
 , mProgressHandler(nullptr)
 , mFlags(aFlags)
+, mMmapSize(Service::getDefaultMmapSize())
 , mStorageService(aService)
 , mAsyncOnly(aAsyncOnly)
 {
@@ -713,9 +715,27 @@ Connection::initializeInternal(nsIFile* aDatabaseFile)
       break;
   }
 
+  // Enable memory-mapped I/O up to the configured bound.  Mapped pages are
+  // shared with the OS page cache, reducing the private page-cache footprint
+  // of the connection.  This is best-effort: builds or filesystems without
+  // mmap support silently ignore the pragma.
+  if (mMmapSize > 0) {
+    nsAutoCString mmapSizeQuery(MOZ_STORAGE_UNIQUIFY_QUERY_STR
+                                "PRAGMA mmap_size = ");
+    mmapSizeQuery.AppendInt(mMmapSize);
+    (void)ExecuteSimpleSQL(mmapSizeQuery);
+  }
+
   return NS_OK;
 }
 
+void
+Connection::setMmapSizePolicy(int64_t aMmapSize)
+{
+  MOZ_ASSERT(!mDBConn, "The mmap_size policy must be set before initialize()");
+  mMmapSize = aMmapSize;
+}
+
 nsresult
 Connection::databaseElementExists(enum DatabaseElementType aElementType,
                                   const nsACString &aElementName,
@@ -1501,6 +1521,21 @@ Connection::GetTransactionInProgress(bool *_inProgress)
   return NS_OK;
 }
 
+NS_IMETHODIMP
+Connection::GetDefaultTransactionType(int32_t *_type)
+{
+  *_type = mDefaultTransactionType;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+Connection::SetDefaultTransactionType(int32_t aType)
+{
+  NS_ENSURE_ARG_RANGE(aType, TRANSACTION_DEFERRED, TRANSACTION_EXCLUSIVE);
+  mDefaultTransactionType = aType;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 Connection::BeginTransaction()
 {
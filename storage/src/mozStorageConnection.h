@@ -24,6 +24,7 @@
 
 #include "nsIMutableArray.h"
 #include "mozilla/Attributes.h"
+#include "mozilla/Atomics.h"
 
 #include "sqlite3.h"
 
@@ -96,6 +97,16 @@ public:
    */
   nsresult initialize(nsIFileURL *aFileURL);
 
+  /**
+   * Sets the bound, in bytes, on the amount of memory-mapped I/O SQLite may
+   * use for this database, overriding the toolkit.storage.mmapSize default.
+   * Zero disables memory-mapped I/O.  Must be called before initialize().
+   *
+   * @param aMmapSize
+   *        The mmap_size to apply to this database, in bytes.
+   */
+  void setMmapSizePolicy(int64_t aMmapSize);
+
   /**
    * Fetches runtime status information for this connection.
    *
@@ -209,6 +220,17 @@ public:
   nsresult commitTransactionInternal(sqlite3 *aNativeConnection);
   nsresult rollbackTransactionInternal(sqlite3 *aNativeConnection);
 
+  /**
+   * The transaction type asynchronous execution should use when it wraps a
+   * batch of statements in an implicit transaction.
+   *
+   * @see mozIStorageConnection::defaultTransactionType.
+   */
+  int32_t getDefaultTransactionType() const
+  {
+    return mDefaultTransactionType;
+  }
+
   bool connectionReady();
 
   /**
@@ -322,6 +344,13 @@ private:
    */
   bool mTransactionInProgress;
 
+  /**
+   * The transaction type used for implicit transactions around asynchronous
+   * batches.  Atomic because it is set on the opening thread but read from
+   * the asynchronous execution thread.
+   */
+  mozilla::Atomic<int32_t> mDefaultTransactionType;
+
   /**
    * Stores the mapping of a given function by name to its instance.  Access is
    * protected by sharedDBMutex.
@@ -339,6 +368,13 @@ private:
    */
   const int mFlags;
 
+  /**
+   * The mmap_size applied to this database on open, in bytes.  Defaults to
+   * the toolkit.storage.mmapSize preference; zero disables memory-mapped
+   * I/O.  @see setMmapSizePolicy
+   */
+  int64_t mMmapSize;
+
   // This is here for two reasons: 1) It's used to make sure that the
   // connections do not outlive the service.  2) Our custom collating functions
   // call its localeCompareStrings() method.
@@ -54,6 +54,12 @@
 // db/sqlite3/src/Makefile.in.
 #define PREF_TS_PAGESIZE_DEFAULT 32768
 
+#define PREF_TS_MMAPSIZE "toolkit.storage.mmapSize"
+
+// Disabled by default; mobile builds can enable this to trade private page
+// cache for pages shared with the OS cache.
+#define PREF_TS_MMAPSIZE_DEFAULT 0
+
 namespace mozilla {
 namespace storage {
 
@@ -274,6 +280,7 @@ Service::getSynchronousPref()
 }
 
 int32_t Service::sDefaultPageSize = PREF_TS_PAGESIZE_DEFAULT;
+int32_t Service::sDefaultMmapSize = PREF_TS_MMAPSIZE_DEFAULT;
 
 Service::Service()
 : mMutex("Service::mMutex")
@@ -553,6 +560,12 @@ Service::initialize()
   sDefaultPageSize =
       Preferences::GetInt(PREF_TS_PAGESIZE, PREF_TS_PAGESIZE_DEFAULT);
 
+  // We need to obtain the toolkit.storage.mmapSize preference on the main
+  // thread for the same reason.  When non-zero it bounds the memory-mapped
+  // I/O SQLite may use per database, unless overridden per connection.
+  sDefaultMmapSize =
+      Preferences::GetInt(PREF_TS_MMAPSIZE, PREF_TS_MMAPSIZE_DEFAULT);
+
   mozilla::RegisterWeakMemoryReporter(this);
   mozilla::RegisterStorageSQLiteDistinguishedAmount(StorageSQLiteDistinguishedAmount);
 
@@ -783,8 +796,22 @@ Service::OpenAsyncDatabase(nsIVariant *aDatabaseStore,
     }
   }
 
+  // Extract the per-database mmap_size policy; a negative value means the
+  // toolkit.storage.mmapSize default applies.
+  int64_t mmapSize = -1;
+  if (aOptions && storageFile) {
+    rv = aOptions->GetPropertyAsInt64(NS_LITERAL_STRING("mmapSize"),
+                                      &mmapSize);
+    if (NS_FAILED(rv) && rv != NS_ERROR_NOT_AVAILABLE) {
+      return NS_ERROR_INVALID_ARG;
+    }
+  }
+
   // Create connection on this thread, but initialize it on its helper thread.
   nsRefPtr<Connection> msc = new Connection(this, flags, true);
+  if (mmapSize >= 0) {
+    msc->setMmapSizePolicy(mmapSize);
+  }
   nsCOMPtr<nsIEventTarget> target = msc->getAsyncExecutionTarget();
   MOZ_ASSERT(target, "Cannot initialize a connection that has been closed already");
 
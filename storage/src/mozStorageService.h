@@ -80,6 +80,17 @@ public:
     return sDefaultPageSize;
   }
 
+  /**
+   * Obtains the default bound, in bytes, on the amount of memory-mapped I/O
+   * SQLite may use per database.  Zero disables memory-mapped I/O.  It may be
+   * overriden with the PREF_TS_MMAPSIZE hidden preference or per connection
+   * with Connection::setMmapSizePolicy.
+   */
+  static int32_t getDefaultMmapSize()
+  {
+    return sDefaultMmapSize;
+  }
+
   /**
    * Returns a boolean value indicating whether or not the given page size is
    * valid (currently understood as a power of 2 between 512 and 65536).
@@ -189,6 +200,7 @@ private:
 
   static int32_t sSynchronousPref;
   static int32_t sDefaultPageSize;
+  static int32_t sDefaultMmapSize;
 };
 
 } // namespace storage
@@ -0,0 +1,60 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * * This Source Code Form is subject to the terms of the Mozilla Public
+ * * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "MozGTestBench.h"
+#include "mozilla/TimeStamp.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+
+// Number of timed samples taken per benchmark.  Statistics over several
+// samples keep one descheduled run from poisoning a comparison; the minimum
+// in particular is a good low-noise estimate of the true cost.
+static const int kSamples = 10;
+
+namespace mozilla {
+
+void
+GTestBench(const char* aSuite, const char* aName, void (*aBody)())
+{
+  // Warm-up run: first-touch page faults, lazy initialization and cold
+  // caches belong outside the timed region.
+  aBody();
+
+  double samplesUs[kSamples];
+  for (int i = 0; i < kSamples; ++i) {
+    TimeStamp start = TimeStamp::Now();
+    aBody();
+    samplesUs[i] = (TimeStamp::Now() - start).ToMicroseconds();
+  }
+
+  std::sort(samplesUs, samplesUs + kSamples);
+
+  double mean = 0;
+  for (int i = 0; i < kSamples; ++i) {
+    mean += samplesUs[i];
+  }
+  mean /= kSamples;
+
+  double variance = 0;
+  for (int i = 0; i < kSamples; ++i) {
+    double deviation = samplesUs[i] - mean;
+    variance += deviation * deviation;
+  }
+  double stddev = sqrt(variance / kSamples);
+
+  double median = (kSamples % 2)
+    ? samplesUs[kSamples / 2]
+    : (samplesUs[kSamples / 2 - 1] + samplesUs[kSamples / 2]) / 2;
+
+  // One line per benchmark; keep the format stable, automation diffs it.
+  printf("MOZ_GTEST_BENCH_JSON: {\"suite\": \"%s\", \"name\": \"%s\", "
+         "\"samples\": %d, \"min_us\": %.3f, \"median_us\": %.3f, "
+         "\"mean_us\": %.3f, \"stddev_us\": %.3f}\n",
+         aSuite, aName, kSamples, samplesUs[0], median, mean, stddev);
+}
+
+} // namespace mozilla
@@ -0,0 +1,33 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * * This Source Code Form is subject to the terms of the Mozilla Public
+ * * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef MozGTestBench_h__
+#define MozGTestBench_h__
+
+#include "gtest/gtest.h"
+
+namespace mozilla {
+
+// Timing/statistics core shared by in-tree micro-benchmarks.  Runs aBody
+// once to warm caches and lazy initialization, then takes several timed
+// samples and prints a single MOZ_GTEST_BENCH_JSON line carrying the suite
+// and benchmark name plus min/median/mean/stddev in microseconds.
+// Automation parses these lines and compares them against a reference run;
+// locally they are ordinary test output.  The body should iterate the
+// measured primitive enough times that one sample takes a good fraction of
+// a millisecond, so scheduler noise does not dominate the numbers.
+void GTestBench(const char* aSuite, const char* aName, void (*aBody)());
+
+} // namespace mozilla
+
+// Registers a micro-benchmark as a regular gtest so it is built, listed and
+// filtered through the existing GTest target.  Use with a plain function or
+// a capture-less lambda:
+//
+//   MOZ_GTEST_BENCH(XPCOMBench, TArrayGrowth, []() { ... });
+#define MOZ_GTEST_BENCH(suite, test, body) \
+  TEST(suite, test) { mozilla::GTestBench(#suite, #test, body); }
+
+#endif // MozGTestBench_h__
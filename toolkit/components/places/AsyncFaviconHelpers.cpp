@@ -341,14 +341,30 @@ OptimizeIconSize(IconData& aIcon,
   // Even if the page provides a large image for the favicon (eg, a highres
   // image or a multiresolution .ico file), don't try to store more data than
   // needed.
+  int32_t dimension = aFaviconSvc->GetOptimizedIconDimension();
   nsAutoCString newData, newMimeType;
-  if (aIcon.data.Length() > MAX_ICON_FILESIZE(aFaviconSvc->GetOptimizedIconDimension())) {
-    nsresult rv = aFaviconSvc->OptimizeFaviconImage(TO_INTBUFFER(aIcon.data),
-                                                    aIcon.data.Length(),
-                                                    aIcon.mimeType,
-                                                    newData,
-                                                    newMimeType);
-    if (NS_SUCCEEDED(rv) && newData.Length() < aIcon.data.Length()) {
+  if (aIcon.data.Length() > MAX_ICON_FILESIZE(dimension)) {
+    // A favicon is typically shared by every page of its site, and each
+    // page association refetches it once it expires.  If this icon was
+    // optimized recently, reuse that payload instead of paying for
+    // another decode and re-encode.
+    bool cached = aFaviconSvc->GetCachedOptimizedPayload(aIcon.spec,
+                                                         dimension,
+                                                         newData,
+                                                         newMimeType);
+    if (!cached) {
+      nsresult rv = aFaviconSvc->OptimizeFaviconImage(TO_INTBUFFER(aIcon.data),
+                                                      aIcon.data.Length(),
+                                                      aIcon.mimeType,
+                                                      newData,
+                                                      newMimeType);
+      if (NS_FAILED(rv)) {
+        return NS_OK;
+      }
+      aFaviconSvc->CacheOptimizedPayload(aIcon.spec, dimension, newData,
+                                         newMimeType);
+    }
+    if (newData.Length() < aIcon.data.Length()) {
       aIcon.data = newData;
       aIcon.mimeType = newMimeType;
     }
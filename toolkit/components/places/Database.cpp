@@ -735,6 +735,11 @@ Database::InitSchema(bool* aDatabaseMigrated)
 
       // Firefox 37 uses schema version 26.
 
+      if (currentSchemaVersion < 27) {
+        rv = MigrateV27Up();
+        NS_ENSURE_SUCCESS(rv, rv);
+      }
+
       // Schema Upgrades must add migration code here.
 
       rv = UpdateBookmarkRootTitles();
@@ -798,6 +803,12 @@ Database::InitSchema(bool* aDatabaseMigrated)
     rv = mMainConn->ExecuteSimpleSQL(CREATE_MOZ_BOOKMARKS_ROOTS);
     NS_ENSURE_SUCCESS(rv, rv);
 
+    // moz_bookmarks_changes.
+    rv = mMainConn->ExecuteSimpleSQL(CREATE_MOZ_BOOKMARKS_CHANGES);
+    NS_ENSURE_SUCCESS(rv, rv);
+    rv = mMainConn->ExecuteSimpleSQL(CREATE_IDX_MOZ_BOOKMARKSCHANGES_TIME);
+    NS_ENSURE_SUCCESS(rv, rv);
+
     // moz_keywords.
     rv = mMainConn->ExecuteSimpleSQL(CREATE_MOZ_KEYWORDS);
     NS_ENSURE_SUCCESS(rv, rv);
@@ -1487,6 +1498,25 @@ Database::MigrateV26Up() {
   return NS_OK;
 }
 
+nsresult
+Database::MigrateV27Up() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  // Add the bookmarks change journal.
+  bool changesTableExists = false;
+  nsresult rv = mMainConn->TableExists(NS_LITERAL_CSTRING("moz_bookmarks_changes"),
+                                       &changesTableExists);
+  NS_ENSURE_SUCCESS(rv, rv);
+  if (!changesTableExists) {
+    rv = mMainConn->ExecuteSimpleSQL(CREATE_MOZ_BOOKMARKS_CHANGES);
+    NS_ENSURE_SUCCESS(rv, rv);
+  }
+  rv = mMainConn->ExecuteSimpleSQL(CREATE_IDX_MOZ_BOOKMARKSCHANGES_TIME);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  return NS_OK;
+}
+
 void
 Database::Shutdown()
 {
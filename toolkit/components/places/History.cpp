@@ -508,6 +508,21 @@ public:
 
     History* history = History::GetService();
     NS_ENSURE_STATE(history);
+
+    // If the visited-URI filter has never seen this URI, it is certainly
+    // not visited and we can answer without touching the database; only
+    // probable positives need the query.
+    if (history->IsDefinitelyNotVisited(aURI)) {
+      nsRefPtr<VisitedQuery> cb = new VisitedQuery(aURI, callback);
+      NS_ENSURE_TRUE(cb, NS_ERROR_OUT_OF_MEMORY);
+      // As per IHistory contract, we must notify asynchronously.
+      nsCOMPtr<nsIRunnable> event =
+        NS_NewRunnableMethod(cb, &VisitedQuery::NotifyVisitedStatus);
+      NS_DispatchToMainThread(event);
+
+      return NS_OK;
+    }
+
     nsRefPtr<VisitedQuery> cb = new VisitedQuery(aURI, callback);
     NS_ENSURE_TRUE(cb, NS_ERROR_OUT_OF_MEMORY);
     nsresult rv = history->GetIsVisitedStatement(cb);
@@ -1951,6 +1966,7 @@ History::History()
   , mShutdownMutex("History::mShutdownMutex")
   , mObservers(VISIT_OBSERVERS_INITIAL_CACHE_LENGTH)
   , mRecentlyVisitedURIsNextIndex(0)
+  , mVisitedFilterState(FILTER_NOT_LOADED)
 {
   NS_ASSERTION(!gService, "Ruh-roh!  This service has already been created!");
   gService = this;
@@ -1986,6 +2002,13 @@ History::NotifyVisited(nsIURI* aURI)
   nsAutoScriptBlocker scriptBlocker;
 
   if (XRE_GetProcessType() == GeckoProcessType_Default) {
+    // Record the visit in the negative-cache filter so future visited
+    // queries for this URI keep escalating to the database.
+    nsAutoCString spec;
+    if (NS_SUCCEEDED(aURI->GetSpec(spec))) {
+      AddVisitedURIToFilter(spec);
+    }
+
     nsTArray<ContentParent*> cplist;
     ContentParent::GetAll(cplist);
 
@@ -2098,6 +2121,45 @@ NS_IMPL_ISUPPORTS(
 , mozIStorageCompletionCallback
 )
 
+namespace {
+
+/**
+ * Seeds History's visited-URI filter with the hash of every place that has
+ * visits.  Results are delivered to the main thread in chunks, so the seed
+ * never blocks it, and the filter only starts answering queries once the
+ * whole table has been read.
+ */
+class VisitedFilterLoader MOZ_FINAL : public AsyncStatementCallback
+{
+public:
+  NS_IMETHOD HandleResult(mozIStorageResultSet* aResults)
+  {
+    History* history = History::GetService();
+    NS_ENSURE_STATE(history);
+
+    nsCOMPtr<mozIStorageRow> row;
+    while (NS_SUCCEEDED(aResults->GetNextRow(getter_AddRefs(row))) && row) {
+      nsAutoCString spec;
+      nsresult rv = row->GetUTF8String(0, spec);
+      NS_ENSURE_SUCCESS(rv, rv);
+      history->AddVisitedURIToFilter(spec);
+    }
+    return NS_OK;
+  }
+
+  NS_IMETHOD HandleCompletion(uint16_t aReason)
+  {
+    if (aReason == mozIStorageStatementCallback::REASON_FINISHED) {
+      History* history = History::GetService();
+      NS_ENSURE_STATE(history);
+      history->NotifyVisitedFilterReady();
+    }
+    return NS_OK;
+  }
+};
+
+} // anonymous namespace
+
 nsresult
 History::GetIsVisitedStatement(mozIStorageCompletionCallback* aCallback)
 {
@@ -2114,6 +2176,66 @@ History::GetIsVisitedStatement(mozIStorageCompletionCallback* aCallback)
   return NS_OK;
 }
 
+void
+History::EnsureVisitedFilter()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  if (mVisitedFilterState != FILTER_NOT_LOADED || mShuttingDown)
+    return;
+  mVisitedFilterState = FILTER_LOADING;
+
+  mozIStorageConnection* dbConn = GetDBConn();
+  if (!dbConn) {
+    mVisitedFilterState = FILTER_NOT_LOADED;
+    return;
+  }
+
+  nsCOMPtr<mozIStorageAsyncStatement> stmt = mDB->GetAsyncStatement(
+    "SELECT url FROM moz_places WHERE last_visit_date NOTNULL "
+  );
+  if (!stmt) {
+    mVisitedFilterState = FILTER_NOT_LOADED;
+    return;
+  }
+
+  nsRefPtr<VisitedFilterLoader> loader = new VisitedFilterLoader();
+  nsCOMPtr<mozIStoragePendingStatement> handle;
+  if (NS_FAILED(stmt->ExecuteAsync(loader, getter_AddRefs(handle)))) {
+    mVisitedFilterState = FILTER_NOT_LOADED;
+  }
+}
+
+bool
+History::IsDefinitelyNotVisited(nsIURI* aURI)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  EnsureVisitedFilter();
+  if (mVisitedFilterState != FILTER_READY) {
+    return false;
+  }
+
+  nsAutoCString spec;
+  if (NS_FAILED(aURI->GetSpec(spec))) {
+    return false;
+  }
+  return !mVisitedFilter.mightContain(HashString(spec));
+}
+
+void
+History::AddVisitedURIToFilter(const nsACString& aSpec)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  mVisitedFilter.add(HashString(aSpec));
+}
+
+void
+History::NotifyVisitedFilterReady()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(mVisitedFilterState == FILTER_LOADING);
+  mVisitedFilterState = FILTER_READY;
+}
+
 nsresult
 History::InsertPlace(const VisitData& aPlace)
 {
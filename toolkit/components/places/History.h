@@ -7,6 +7,7 @@
 #ifndef mozilla_places_History_h_
 #define mozilla_places_History_h_
 
+#include "mozilla/BloomFilter.h"
 #include "mozilla/IHistory.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/Mutex.h"
@@ -130,6 +131,28 @@ public:
    */
   void AppendToRecentlyVisitedURIs(nsIURI* aURI);
 
+  /**
+   * Returns true if the visited-URI filter is seeded and has never seen
+   * aURI, in which case the URI is guaranteed not to be visited and no
+   * database query is needed.  Returns false while the filter is still
+   * loading, or for probable positives, which must fall through to the
+   * database.  Main thread only.
+   */
+  bool IsDefinitelyNotVisited(nsIURI* aURI);
+
+  /**
+   * Adds the hash of a visited URI spec to the visited-URI filter.  Called
+   * for every new visit and, by VisitedFilterLoader, for every place with
+   * visits in the database.  Main thread only.
+   */
+  void AddVisitedURIToFilter(const nsACString& aSpec);
+
+  /**
+   * Called by VisitedFilterLoader once every visited place in the database
+   * has been added to the filter.
+   */
+  void NotifyVisitedFilterReady();
+
 private:
   virtual ~History();
 
@@ -198,6 +221,31 @@ private:
   RecentlyVisitedArray::index_type mRecentlyVisitedURIsNextIndex;
 
   bool IsRecentlyVisitedURI(nsIURI* aURI);
+
+  /**
+   * Kicks off the asynchronous seeding of mVisitedFilter from moz_places,
+   * if it has not started yet.
+   */
+  void EnsureVisitedFilter();
+
+  enum VisitedFilterState {
+    FILTER_NOT_LOADED,
+    FILTER_LOADING,
+    FILTER_READY
+  };
+  VisitedFilterState mVisitedFilterState;
+
+  /**
+   * Bloom filter over the hashes of every visited URI spec, used as a
+   * negative cache for visited queries: a miss means the URI is certainly
+   * not visited and can be answered without touching the database, while
+   * probable positives still run the query.  Entries are never removed, so
+   * after a history clear the filter merely over-approximates until the
+   * next session, which only costs spurious queries.  64 KiB; with a few
+   * tens of thousands of visited places most lookups on link-dense pages
+   * still miss.  Main thread only.
+   */
+  BloomFilter<16, nsACString> mVisitedFilter;
 };
 
 } // namespace places
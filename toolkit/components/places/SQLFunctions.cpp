@@ -28,6 +28,24 @@ namespace {
 
   typedef nsACString::const_char_iterator const_char_iterator;
 
+  /**
+   * Returns a string argument borrowed directly from sqlite's storage,
+   * avoiding a copy of the text.  The result is only valid for the duration
+   * of the function call.  A NULL value yields an empty string; callers that
+   * care about NULL-ness must check the argument type themselves.
+   */
+  static
+  nsDependentCSubstring
+  getSharedUTF8String(mozIStorageValueArray* aValues, uint32_t aIndex)
+  {
+    uint32_t len;
+    const char* str = aValues->AsSharedUTF8String(aIndex, &len);
+    if (!str) {
+      return nsDependentCSubstring("", uint32_t(0));
+    }
+    return nsDependentCSubstring(str, len);
+  }
+
   /**
    * Get a pointer to the word boundary after aStart if aStart points to an
    * ASCII letter (i.e. [a-zA-Z]).  Otherwise, return aNext, which we assume
@@ -202,35 +220,40 @@ namespace places {
 
   /* static */
   void
-  MatchAutoCompleteFunction::fixupURISpec(const nsCString &aURISpec,
+  MatchAutoCompleteFunction::fixupURISpec(const nsACString &aURISpec,
                                           int32_t aMatchBehavior,
-                                          nsCString &_fixedSpec)
+                                          nsACString &aSpecBuf,
+                                          nsDependentCSubstring &_fixedSpec)
   {
-    nsCString unescapedSpec;
-    (void)NS_UnescapeURL(aURISpec, esc_SkipControl | esc_AlwaysCopy,
-                         unescapedSpec);
-
-    // If this unescaped string is valid UTF-8, we'll use it.  Otherwise,
-    // we will simply use our original string.
-    NS_ASSERTION(_fixedSpec.IsEmpty(),
-                 "Passing a non-empty string as an out parameter!");
-    if (IsUTF8(unescapedSpec))
-      _fixedSpec.Assign(unescapedSpec);
-    else
-      _fixedSpec.Assign(aURISpec);
+    // Try to unescape the spec.  If it contains no escapes, or the unescaped
+    // bytes are not valid UTF-8, search the original spec; either way we
+    // avoid copying the common (unescaped) case.
+    if (NS_UnescapeURL(aURISpec.BeginReading(), aURISpec.Length(),
+                       esc_SkipControl, aSpecBuf) &&
+        IsUTF8(aSpecBuf)) {
+      _fixedSpec.Rebind(aSpecBuf, 0);
+    } else {
+      _fixedSpec.Rebind(aURISpec, 0);
+    }
 
     if (aMatchBehavior == mozIPlacesAutoComplete::MATCH_ANYWHERE_UNMODIFIED)
       return;
 
+    uint32_t offset = 0;
     if (StringBeginsWith(_fixedSpec, NS_LITERAL_CSTRING("http://")))
-      _fixedSpec.Cut(0, 7);
+      offset = 7;
     else if (StringBeginsWith(_fixedSpec, NS_LITERAL_CSTRING("https://")))
-      _fixedSpec.Cut(0, 8);
+      offset = 8;
     else if (StringBeginsWith(_fixedSpec, NS_LITERAL_CSTRING("ftp://")))
-      _fixedSpec.Cut(0, 6);
+      offset = 6;
 
-    if (StringBeginsWith(_fixedSpec, NS_LITERAL_CSTRING("www.")))
-      _fixedSpec.Cut(0, 4);
+    if (StringBeginsWith(Substring(_fixedSpec, offset),
+                         NS_LITERAL_CSTRING("www.")))
+      offset += 4;
+
+    if (offset) {
+      _fixedSpec.Rebind(_fixedSpec, offset);
+    }
   }
 
   /* static */
@@ -336,10 +359,10 @@ namespace places {
     #define HAS_BEHAVIOR(aBitName) \
       (searchBehavior & mozIPlacesAutoComplete::BEHAVIOR_##aBitName)
 
-    nsAutoCString searchString;
-    (void)aArguments->GetUTF8String(kArgSearchString, searchString);
-    nsCString url;
-    (void)aArguments->GetUTF8String(kArgIndexURL, url);
+    nsDependentCSubstring searchString =
+      getSharedUTF8String(aArguments, kArgSearchString);
+    nsDependentCSubstring url =
+      getSharedUTF8String(aArguments, kArgIndexURL);
 
     int32_t matchBehavior = aArguments->AsInt32(kArgIndexMatchBehavior);
 
@@ -387,11 +410,12 @@ namespace places {
     searchFunctionPtr searchFunction = getSearchFunction(matchBehavior);
 
     // Clean up our URI spec and prepare it for searching.
-    nsCString fixedURI;
-    fixupURISpec(url, matchBehavior, fixedURI);
+    nsCString fixedUrlBuf;
+    nsDependentCSubstring fixedURI;
+    fixupURISpec(url, matchBehavior, fixedUrlBuf, fixedURI);
 
-    nsAutoCString title;
-    (void)aArguments->GetUTF8String(kArgIndexTitle, title);
+    nsDependentCSubstring title =
+      getSharedUTF8String(aArguments, kArgIndexTitle);
 
     // Determine if every token matches either the bookmark title, tags, page
     // title, or page URL.
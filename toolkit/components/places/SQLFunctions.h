@@ -166,11 +166,15 @@ private:
    * @param aMatchBehavior
    *        The matching behavior to use defined by one of the
    *        mozIPlacesAutoComplete::MATCH_* values.
+   * @param aSpecBuf
+   *        A scratch buffer the fixed-up spec may be unescaped into.
    * @param _fixedSpec
-   *        An out parameter that is the fixed up string.
+   *        An out parameter that is the fixed up string, pointing either
+   *        into aURISpec or into aSpecBuf.
    */
-  static void fixupURISpec(const nsCString &aURISpec, int32_t aMatchBehavior,
-                           nsCString &_fixedSpec);
+  static void fixupURISpec(const nsACString &aURISpec, int32_t aMatchBehavior,
+                           nsACString &aSpecBuf,
+                           nsDependentCSubstring &_fixedSpec);
 };
 
 
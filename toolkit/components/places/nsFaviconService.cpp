@@ -49,6 +49,12 @@
 // OptimizeFaviconImage.
 #define DEFAULT_MIME_TYPE "image/png"
 
+// Optimized payloads are cached for a short while so that a favicon shared
+// by every page of a site is only decoded and re-encoded once.  The cache
+// is thrown away wholesale when it fills up; entries are cheap to rebuild.
+#define MAX_OPTIMIZED_PAYLOADS 32
+#define OPTIMIZED_PAYLOAD_EXPIRY_USEC (10 * 60 * (PRTime)PR_USEC_PER_SEC)
+
 using namespace mozilla;
 using namespace mozilla::places;
 
@@ -569,6 +575,59 @@ nsFaviconService::OptimizeFaviconImage(const uint8_t* aData, uint32_t aDataLen,
   return NS_OK;
 }
 
+static void
+BuildOptimizedPayloadKey(const nsACString& aSpec, int32_t aDimension,
+                         nsACString& aKey)
+{
+  aKey.Assign(aSpec);
+  aKey.Append('#');
+  aKey.AppendInt(aDimension);
+}
+
+bool
+nsFaviconService::GetCachedOptimizedPayload(const nsACString& aSpec,
+                                            int32_t aDimension,
+                                            nsACString& aData,
+                                            nsACString& aMimeType)
+{
+  nsAutoCString key;
+  BuildOptimizedPayloadKey(aSpec, aDimension, key);
+
+  OptimizedPayload* payload = mOptimizedPayloads.Get(key);
+  if (!payload) {
+    return false;
+  }
+
+  if (payload->expiration < PR_Now()) {
+    mOptimizedPayloads.Remove(key);
+    return false;
+  }
+
+  aData = payload->data;
+  aMimeType = payload->mimeType;
+  return true;
+}
+
+void
+nsFaviconService::CacheOptimizedPayload(const nsACString& aSpec,
+                                        int32_t aDimension,
+                                        const nsACString& aData,
+                                        const nsACString& aMimeType)
+{
+  if (mOptimizedPayloads.Count() >= MAX_OPTIMIZED_PAYLOADS) {
+    mOptimizedPayloads.Clear();
+  }
+
+  nsAutoCString key;
+  BuildOptimizedPayloadKey(aSpec, aDimension, key);
+
+  OptimizedPayload* payload = new OptimizedPayload();
+  payload->data = aData;
+  payload->mimeType = aMimeType;
+  payload->expiration = PR_Now() + OPTIMIZED_PAYLOAD_EXPIRY_USEC;
+  mOptimizedPayloads.Put(key, payload);
+}
+
 nsresult
 nsFaviconService::GetFaviconDataAsync(nsIURI* aFaviconURI,
                                       mozIStorageStatementCallback *aCallback)
@@ -11,6 +11,7 @@
 
 #include "nsCOMPtr.h"
 #include "nsString.h"
+#include "nsClassHashtable.h"
 #include "nsDataHashtable.h"
 #include "nsServiceManagerUtils.h"
 #include "nsTHashtable.h"
@@ -92,6 +93,24 @@ public:
                                 nsACString& aNewData, nsACString& aNewMimeType);
   int32_t GetOptimizedIconDimension() { return mOptimizedIconDimension; }
 
+  /**
+   * Looks up a recently optimized payload for the given icon and target
+   * dimension, so a favicon shared by every page of a site is decoded
+   * and re-encoded only once rather than once per page association.
+   * Returns true and fills aData/aMimeType on a cache hit.
+   */
+  bool GetCachedOptimizedPayload(const nsACString& aSpec, int32_t aDimension,
+                                 nsACString& aData, nsACString& aMimeType);
+
+  /**
+   * Remembers the result of OptimizeFaviconImage for an icon, keyed by
+   * icon spec and target dimension.  Entries expire after a short while
+   * and the cache is bounded in size.
+   */
+  void CacheOptimizedPayload(const nsACString& aSpec, int32_t aDimension,
+                             const nsACString& aData,
+                             const nsACString& aMimeType);
+
   /**
    * Obtains the favicon data asynchronously.
    *
@@ -149,6 +168,15 @@ private:
   uint32_t mFailedFaviconSerial;
   nsDataHashtable<nsCStringHashKey, uint32_t> mFailedFavicons;
 
+  // Recently optimized icon payloads, keyed by icon spec and target
+  // dimension.  See GetCachedOptimizedPayload.
+  struct OptimizedPayload {
+    nsCString data;
+    nsCString mimeType;
+    PRTime expiration;
+  };
+  nsClassHashtable<nsCStringHashKey, OptimizedPayload> mOptimizedPayloads;
+
   // AsyncFetchAndSetIconForPage needs access to the icon cache
   friend class mozilla::places::AsyncFetchAndSetIconForPage;
   friend class mozilla::places::RemoveIconDataCacheEntry;
@@ -342,6 +342,31 @@ nsNavBookmarks::GetUnfiledBookmarksFolder(int64_t* aRoot)
 }
 
 
+nsresult
+nsNavBookmarks::NoteItemChanged(int64_t aItemId,
+                                const nsACString& aGuid,
+                                uint16_t aChangeType)
+{
+  nsCOMPtr<mozIStorageStatement> stmt = mDB->GetStatement(
+    "INSERT INTO moz_bookmarks_changes (item_id, guid, change_type, change_time) "
+    "VALUES (:item_id, :item_guid, :change_type, :change_time)"
+  );
+  NS_ENSURE_STATE(stmt);
+  mozStorageStatementScoper scoper(stmt);
+
+  nsresult rv = stmt->BindInt64ByName(NS_LITERAL_CSTRING("item_id"), aItemId);
+  NS_ENSURE_SUCCESS(rv, rv);
+  rv = stmt->BindUTF8StringByName(NS_LITERAL_CSTRING("item_guid"), aGuid);
+  NS_ENSURE_SUCCESS(rv, rv);
+  rv = stmt->BindInt32ByName(NS_LITERAL_CSTRING("change_type"), aChangeType);
+  NS_ENSURE_SUCCESS(rv, rv);
+  rv = stmt->BindInt64ByName(NS_LITERAL_CSTRING("change_time"), RoundedPRNow());
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  return stmt->Execute();
+}
+
+
 nsresult
 nsNavBookmarks::InsertBookmarkInDB(int64_t aPlaceId,
                                    enum ItemType aItemType,
@@ -480,6 +505,9 @@ nsNavBookmarks::InsertBookmarkInDB(int64_t aPlaceId,
   bookmark.parentGuid = aParentGuid;
   bookmark.grandParentId = aGrandParentId;
 
+  rv = NoteItemChanged(*_itemId, _guid, CHANGE_ADDED);
+  NS_ENSURE_SUCCESS(rv, rv);
+
   return NS_OK;
 }
 
@@ -633,6 +661,9 @@ nsNavBookmarks::RemoveItem(int64_t aItemId)
                            bookmark.lastModified);
   NS_ENSURE_SUCCESS(rv, rv);
 
+  rv = NoteItemChanged(bookmark.id, bookmark.guid, CHANGE_REMOVED);
+  NS_ENSURE_SUCCESS(rv, rv);
+
   rv = transaction.Commit();
   NS_ENSURE_SUCCESS(rv, rv);
 
@@ -1108,6 +1139,13 @@ nsNavBookmarks::RemoveFolderChildren(int64_t aFolderId)
   rv = SetItemDateInternal(LAST_MODIFIED, folder.id, RoundedPRNow());
   NS_ENSURE_SUCCESS(rv, rv);
 
+  // Journal the removals before the transaction commits.
+  for (uint32_t i = 0; i < folderChildrenArray.Length(); ++i) {
+    BookmarkData& child = folderChildrenArray[i];
+    rv = NoteItemChanged(child.id, child.guid, CHANGE_REMOVED);
+    NS_ENSURE_SUCCESS(rv, rv);
+  }
+
   for (uint32_t i = 0; i < folderChildrenArray.Length(); i++) {
     BookmarkData& child = folderChildrenArray[i];
     if (child.type == TYPE_BOOKMARK) {
@@ -1295,6 +1333,9 @@ nsNavBookmarks::MoveItem(int64_t aItemId, int64_t aNewParent, int32_t aIndex)
   rv = SetItemDateInternal(LAST_MODIFIED, aNewParent, now);
   NS_ENSURE_SUCCESS(rv, rv);
 
+  rv = NoteItemChanged(bookmark.id, bookmark.guid, CHANGE_MOVED);
+  NS_ENSURE_SUCCESS(rv, rv);
+
   rv = transaction.Commit();
   NS_ENSURE_SUCCESS(rv, rv);
 
@@ -1551,6 +1592,9 @@ nsNavBookmarks::SetItemTitle(int64_t aItemId, const nsACString& aTitle)
   rv = statement->Execute();
   NS_ENSURE_SUCCESS(rv, rv);
 
+  rv = NoteItemChanged(bookmark.id, bookmark.guid, CHANGE_MODIFIED);
+  NS_ENSURE_SUCCESS(rv, rv);
+
   NOTIFY_OBSERVERS(mCanNotify, mCacheObservers, mObservers,
                    nsINavBookmarkObserver,
                    OnItemChanged(bookmark.id,
@@ -2019,6 +2063,9 @@ nsNavBookmarks::ChangeBookmarkURI(int64_t aBookmarkId, nsIURI* aNewURI)
   rv = statement->Execute();
   NS_ENSURE_SUCCESS(rv, rv);
 
+  rv = NoteItemChanged(bookmark.id, bookmark.guid, CHANGE_MODIFIED);
+  NS_ENSURE_SUCCESS(rv, rv);
+
   rv = transaction.Commit();
   NS_ENSURE_SUCCESS(rv, rv);
 
@@ -2195,6 +2242,68 @@ nsNavBookmarks::GetBookmarkIdsForURI(nsIURI* aURI, uint32_t* aCount,
 }
 
 
+NS_IMETHODIMP
+nsNavBookmarks::GetChangedBookmarkIds(PRTime aTime, uint32_t* aCount,
+                                      int64_t** aItemIds)
+{
+  NS_ENSURE_ARG_POINTER(aCount);
+  NS_ENSURE_ARG_POINTER(aItemIds);
+
+  *aCount = 0;
+  *aItemIds = nullptr;
+
+  nsCOMPtr<mozIStorageStatement> stmt = mDB->GetStatement(
+    "SELECT DISTINCT item_id FROM moz_bookmarks_changes "
+    "WHERE change_time >= :change_time"
+  );
+  NS_ENSURE_STATE(stmt);
+  mozStorageStatementScoper scoper(stmt);
+
+  nsresult rv = stmt->BindInt64ByName(NS_LITERAL_CSTRING("change_time"),
+                                      aTime);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsTArray<int64_t> itemIds;
+  bool hasResult;
+  while (NS_SUCCEEDED(stmt->ExecuteStep(&hasResult)) && hasResult) {
+    int64_t itemId;
+    rv = stmt->GetInt64(0, &itemId);
+    NS_ENSURE_SUCCESS(rv, rv);
+    itemIds.AppendElement(itemId);
+  }
+
+  // Copy the results into a new array for output.
+  if (itemIds.Length()) {
+    *aItemIds =
+      static_cast<int64_t*>(nsMemory::Alloc(sizeof(int64_t) * itemIds.Length()));
+    if (!*aItemIds)
+      return NS_ERROR_OUT_OF_MEMORY;
+    for (uint32_t i = 0; i < itemIds.Length(); i++)
+      (*aItemIds)[i] = itemIds[i];
+  }
+
+  *aCount = itemIds.Length();
+  return NS_OK;
+}
+
+
+NS_IMETHODIMP
+nsNavBookmarks::ForgetChangedBookmarksBefore(PRTime aTime)
+{
+  nsCOMPtr<mozIStorageStatement> stmt = mDB->GetStatement(
+    "DELETE FROM moz_bookmarks_changes WHERE change_time < :change_time"
+  );
+  NS_ENSURE_STATE(stmt);
+  mozStorageStatementScoper scoper(stmt);
+
+  nsresult rv = stmt->BindInt64ByName(NS_LITERAL_CSTRING("change_time"),
+                                      aTime);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  return stmt->Execute();
+}
+
+
 NS_IMETHODIMP
 nsNavBookmarks::GetItemIndex(int64_t aItemId, int32_t* _index)
 {
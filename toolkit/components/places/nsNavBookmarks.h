@@ -288,6 +288,23 @@ private:
                                int64_t aItemId,
                                PRTime aValue);
 
+  /**
+   * Records an item change in the moz_bookmarks_changes journal, so that
+   * consumers like Sync can read incremental deltas instead of scanning the
+   * whole bookmarks table.  Expected to be called inside the transaction
+   * that performs the change.
+   *
+   * @param aItemId
+   *        The id of the changed item.
+   * @param aGuid
+   *        The guid of the changed item.
+   * @param aChangeType
+   *        One of the nsINavBookmarksService::CHANGE_* constants.
+   */
+  nsresult NoteItemChanged(int64_t aItemId,
+                           const nsACString& aGuid,
+                           uint16_t aChangeType);
+
   // Recursive method to build an array of folder's children
   nsresult GetDescendantChildren(int64_t aFolderId,
                                  const nsACString& aFolderGuid,
@@ -94,6 +94,15 @@
     "guid_uniqueindex", "moz_bookmarks", "guid", "UNIQUE" \
   )
 
+/**
+ * moz_bookmarks_changes
+ */
+
+#define CREATE_IDX_MOZ_BOOKMARKSCHANGES_TIME \
+  CREATE_PLACES_IDX( \
+    "changetimeindex", "moz_bookmarks_changes", "change_time", "" \
+  )
+
 /**
  * moz_annos
  */
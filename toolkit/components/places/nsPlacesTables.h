@@ -117,6 +117,19 @@
   ")" \
 )
 
+/* Journal of bookmark item changes, so that consumers like Sync can read
+ * incremental deltas instead of scanning the whole moz_bookmarks table.
+ * change_type is one of the nsINavBookmarksService::CHANGE_* constants. */
+#define CREATE_MOZ_BOOKMARKS_CHANGES NS_LITERAL_CSTRING( \
+  "CREATE TABLE moz_bookmarks_changes (" \
+    "  id INTEGER PRIMARY KEY" \
+    ", item_id INTEGER NOT NULL" \
+    ", guid TEXT" \
+    ", change_type INTEGER NOT NULL" \
+    ", change_time INTEGER NOT NULL" \
+  ")" \
+)
+
 #define CREATE_MOZ_KEYWORDS NS_LITERAL_CSTRING( \
   "CREATE TABLE moz_keywords (" \
     "  id INTEGER PRIMARY KEY AUTOINCREMENT" \
@@ -10,6 +10,7 @@
 
 #include <prio.h>
 
+#include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/Likely.h"
@@ -1574,6 +1575,21 @@ static TimeStamp gRecordedShutdownStartTime;
 static bool gAlreadyFreedShutdownTimeFileName = false;
 static char *gRecordedShutdownTimeFileName = nullptr;
 
+// Performance counter storage.  One relaxed atomic per counter, so
+// incrementing from a hot path is a single uncontended add.  Snapshots
+// read the session totals without resetting them.
+static Atomic<uint32_t, Relaxed> gPerfCounters[Telemetry::PerfCounterCount];
+
+// Property names used when reflecting the counters into JS, indexed by
+// Telemetry::PerfCounterID.
+static const char* const kPerfCounterNames[] = {
+  "httpTransactions",
+  "reflows"
+};
+static_assert(MOZ_ARRAY_LENGTH(kPerfCounterNames) ==
+              Telemetry::PerfCounterCount,
+              "kPerfCounterNames must cover every PerfCounterID");
+
 static char *
 GetShutdownTimeFileName()
 {
@@ -3271,6 +3287,27 @@ TelemetryImpl::GetFileIOReports(JSContext *cx, JS::MutableHandleValue ret)
   return NS_OK;
 }
 
+NS_IMETHODIMP
+TelemetryImpl::GetPerformanceCounters(JSContext *cx, JS::MutableHandleValue ret)
+{
+  JS::Rooted<JSObject*> obj(cx, JS_NewObject(cx, nullptr, JS::NullPtr(),
+                                             JS::NullPtr()));
+  if (!obj) {
+    return NS_ERROR_FAILURE;
+  }
+
+  for (size_t i = 0; i < Telemetry::PerfCounterCount; ++i) {
+    uint32_t value = gPerfCounters[i];
+    if (!JS_DefineProperty(cx, obj, kPerfCounterNames[i], value,
+                           JSPROP_ENUMERATE)) {
+      return NS_ERROR_FAILURE;
+    }
+  }
+
+  ret.setObject(*obj);
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 TelemetryImpl::MsSinceProcessStart(double* aResult)
 {
@@ -3438,6 +3475,15 @@ AccumulateTimeDelta(ID aHistogram, TimeStamp start, TimeStamp end)
              static_cast<uint32_t>((end - start).ToMilliseconds()));
 }
 
+void
+IncrementPerfCounter(PerfCounterID aCounter, uint32_t aCount)
+{
+  MOZ_ASSERT(aCounter < PerfCounterCount);
+  // No CanRecord() check: the add is cheaper than the check, and the
+  // totals are only exposed when telemetry is read.
+  gPerfCounters[aCounter] += aCount;
+}
+
 bool
 CanRecord()
 {
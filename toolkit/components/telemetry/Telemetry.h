@@ -71,6 +71,27 @@ void Accumulate(const char* name, uint32_t sample);
  */
 void AccumulateTimeDelta(ID id, TimeStamp start, TimeStamp end = TimeStamp::Now());
 
+/**
+ * Performance counters are low-overhead event counters for paths that are
+ * too hot to afford a histogram accumulation (per HTTP transaction, per
+ * reflow, ...).  Incrementing one is a single relaxed atomic add -- no
+ * locking, no bucket math -- and is safe from any thread.  Session totals
+ * are exposed through nsITelemetry.performanceCounters.
+ */
+enum PerfCounterID {
+  PERF_COUNTER_HTTP_TRANSACTIONS = 0, // HTTP transactions initialized
+  PERF_COUNTER_REFLOWS,               // reflows processed by a pres shell
+  PerfCounterCount
+};
+
+/**
+ * Adds aCount to a performance counter.
+ *
+ * @param aCounter - performance counter id
+ * @param aCount - (optional) amount to add, defaults to 1.
+ */
+void IncrementPerfCounter(PerfCounterID aCounter, uint32_t aCount = 1);
+
 /**
  * Return a raw Histogram for direct manipulation for users who can not use Accumulate().
  */
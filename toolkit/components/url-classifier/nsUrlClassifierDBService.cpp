@@ -84,6 +84,13 @@ PRLogModuleInfo *gUrlClassifierDbServiceLog = nullptr;
 #define CONFIRM_AGE_PREF        "urlclassifier.max-complete-age"
 #define CONFIRM_AGE_DEFAULT_SEC (45 * 60)
 
+// How long a clean lookup result stays usable, and how many of them we
+// keep before throwing the cache away wholesale.  The cache is also
+// cleared whenever table data changes, so these only bound staleness
+// and memory between updates.
+#define CLEAN_RESULT_CACHE_MAX_AGE_SEC (5 * 60)
+#define CLEAN_RESULT_CACHE_MAX_ENTRIES 500
+
 class nsUrlClassifierDBServiceWorker;
 
 // Singleton instance.
@@ -842,11 +849,13 @@ public:
   NS_DECL_NSIURLCLASSIFIERHASHCOMPLETERCALLBACK
 
   nsUrlClassifierLookupCallback(nsUrlClassifierDBService *dbservice,
-                                nsIUrlClassifierCallback *c)
+                                nsIUrlClassifierCallback *c,
+                                const nsACString& lookupKey)
     : mDBService(dbservice)
     , mResults(nullptr)
     , mPendingCompletions(0)
     , mCallback(c)
+    , mLookupKey(lookupKey)
     {}
 
 private:
@@ -862,6 +871,10 @@ private:
 
   uint32_t mPendingCompletions;
   nsCOMPtr<nsIUrlClassifierCallback> mCallback;
+
+  // The canonicalized lookup key, remembered so a clean verdict can be
+  // cached against it once all completions have finished.
+  nsCString mLookupKey;
 };
 
 NS_IMPL_ISUPPORTS(nsUrlClassifierLookupCallback,
@@ -1002,6 +1015,7 @@ nsUrlClassifierLookupCallback::HandleResults()
 {
   if (!mResults) {
     // No results, this URI is clean.
+    mDBService->NoteCleanKey(mLookupKey);
     return mCallback->HandleEvent(NS_LITERAL_CSTRING(""));
   }
 
@@ -1047,6 +1061,12 @@ nsUrlClassifierLookupCallback::HandleResults()
     mDBService->CacheCompletions(mCacheResults.forget());
   }
 
+  if (tables.IsEmpty()) {
+    // Nothing was confirmed; remember that so repeat lookups of this URL
+    // can skip the worker round trip until the next update.
+    mDBService->NoteCleanKey(mLookupKey);
+  }
+
   nsAutoCString tableStr;
   for (uint32_t i = 0; i < tables.Length(); i++) {
     if (i != 0)
@@ -1325,6 +1345,56 @@ nsUrlClassifierDBService::Classify(nsIPrincipal* aPrincipal,
   return NS_OK;
 }
 
+// Discards the lookup verdict.  Used for speculative classifications,
+// where the side effects of the lookup (warming the clean-result cache
+// and completing partial hashes) are the whole point.
+class nsUrlClassifierDiscardingCallback MOZ_FINAL : public nsIUrlClassifierCallback
+{
+public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+  NS_DECL_NSIURLCLASSIFIERCALLBACK
+
+  nsUrlClassifierDiscardingCallback() {}
+
+private:
+  ~nsUrlClassifierDiscardingCallback() {}
+};
+
+NS_IMPL_ISUPPORTS(nsUrlClassifierDiscardingCallback,
+                  nsIUrlClassifierCallback)
+
+NS_IMETHODIMP
+nsUrlClassifierDiscardingCallback::HandleEvent(const nsACString& tables)
+{
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+nsUrlClassifierDBService::SpeculativeClassify(nsIPrincipal* aPrincipal,
+                                              bool aTrackingProtectionEnabled)
+{
+  NS_ENSURE_ARG(aPrincipal);
+  NS_ENSURE_TRUE(gDbBackgroundThread, NS_ERROR_NOT_INITIALIZED);
+
+  if (!(mCheckMalware || mCheckPhishing)) {
+    return NS_OK;
+  }
+
+  nsRefPtr<nsUrlClassifierDiscardingCallback> callback =
+    new nsUrlClassifierDiscardingCallback();
+
+  nsAutoCString tables;
+  BuildTables(aTrackingProtectionEnabled, tables);
+
+  bool dummy;
+  nsresult rv = LookupURI(aPrincipal, tables, callback, false, &dummy);
+  if (rv == NS_ERROR_MALFORMED_URI) {
+    // The URI had no hostname; nothing to warm up.
+    return NS_OK;
+  }
+  return rv;
+}
+
 NS_IMETHODIMP
 nsUrlClassifierDBService::ClassifyLocal(nsIPrincipal* aPrincipal,
                                         bool aTrackingProtectionEnabled,
@@ -1412,6 +1482,8 @@ nsUrlClassifierDBService::LookupURI(nsIPrincipal* aPrincipal,
     *didLookup = true;
   } else {
     bool clean = false;
+    rv = CheckClean(key, &clean);
+    NS_ENSURE_SUCCESS(rv, rv);
 
     if (!clean) {
       nsCOMPtr<nsIPermissionManager> permissionManager =
@@ -1437,7 +1509,7 @@ nsUrlClassifierDBService::LookupURI(nsIPrincipal* aPrincipal,
   // take care of confirming partial hash matches if necessary before
   // calling the client's callback.
   nsCOMPtr<nsIUrlClassifierLookupCallback> callback =
-    new nsUrlClassifierLookupCallback(this, c);
+    new nsUrlClassifierLookupCallback(this, c, key);
   if (!callback)
     return NS_ERROR_OUT_OF_MEMORY;
 
@@ -1454,6 +1526,44 @@ nsUrlClassifierDBService::LookupURI(nsIPrincipal* aPrincipal,
   return mWorkerProxy->Lookup(nullptr, dummy, nullptr);
 }
 
+nsresult
+nsUrlClassifierDBService::CheckClean(const nsACString &lookupKey,
+                                     bool *clean)
+{
+  MOZ_ASSERT(NS_IsMainThread(), "CheckClean must be on main thread");
+
+  *clean = false;
+
+  TimeStamp expiry;
+  if (!mCleanResultCache.Get(lookupKey, &expiry)) {
+    return NS_OK;
+  }
+
+  if (expiry <= TimeStamp::Now()) {
+    mCleanResultCache.Remove(lookupKey);
+    return NS_OK;
+  }
+
+  *clean = true;
+  return NS_OK;
+}
+
+void
+nsUrlClassifierDBService::NoteCleanKey(const nsACString& lookupKey)
+{
+  MOZ_ASSERT(NS_IsMainThread(), "NoteCleanKey must be on main thread");
+
+  // Rather than tracking an eviction order, just start over when the
+  // cache fills up; entries are cheap to regenerate.
+  if (mCleanResultCache.Count() >= CLEAN_RESULT_CACHE_MAX_ENTRIES) {
+    mCleanResultCache.Clear();
+  }
+
+  mCleanResultCache.Put(lookupKey,
+    TimeStamp::Now() +
+      TimeDuration::FromSeconds(CLEAN_RESULT_CACHE_MAX_AGE_SEC));
+}
+
 NS_IMETHODIMP
 nsUrlClassifierDBService::GetTables(nsIUrlClassifierCallback* c)
 {
@@ -1492,6 +1602,10 @@ nsUrlClassifierDBService::BeginUpdate(nsIUrlClassifierUpdateObserver *observer,
 
   mInUpdate = true;
 
+  // Table contents are about to change; cached clean verdicts may no
+  // longer hold.
+  mCleanResultCache.Clear();
+
   // The proxy observer uses the current thread
   nsCOMPtr<nsIUrlClassifierUpdateObserver> proxyObserver =
     new UrlClassifierUpdateObserverProxy(observer);
@@ -1530,6 +1644,10 @@ nsUrlClassifierDBService::FinishUpdate()
 
   mInUpdate = false;
 
+  // Anything noted clean while the update was streaming in was checked
+  // against the old table data.
+  mCleanResultCache.Clear();
+
   return mWorkerProxy->FinishUpdate();
 }
 
@@ -1549,6 +1667,8 @@ nsUrlClassifierDBService::ResetDatabase()
 {
   NS_ENSURE_TRUE(gDbBackgroundThread, NS_ERROR_NOT_INITIALIZED);
 
+  mCleanResultCache.Clear();
+
   return mWorkerProxy->ResetDatabase();
 }
 
@@ -9,6 +9,7 @@
 #include <nsISupportsUtils.h>
 
 #include "nsID.h"
+#include "nsDataHashtable.h"
 #include "nsInterfaceHashtable.h"
 #include "nsIObserver.h"
 #include "nsUrlClassifierPrefixSet.h"
@@ -20,6 +21,7 @@
 #include "nsICryptoHash.h"
 #include "nsICryptoHMAC.h"
 #include "mozilla/Attributes.h"
+#include "mozilla/TimeStamp.h"
 
 #include "LookupCache.h"
 
@@ -63,6 +65,11 @@ public:
   nsresult CacheCompletions(mozilla::safebrowsing::CacheResultArray *results);
   nsresult CacheMisses(mozilla::safebrowsing::PrefixArray *results);
 
+  // Note a lookup key whose lookup produced no confirmed matches, so
+  // repeated classification of the same URL can skip the worker round trip
+  // until the next update. Main thread only.
+  void NoteCleanKey(const nsACString& lookupKey);
+
   static nsIThread* BackgroundThread();
 
 private:
@@ -80,7 +87,8 @@ private:
   // Close db connection and join the background thread if it exists.
   nsresult Shutdown();
 
-  // Check if the key is on a known-clean host.
+  // Check whether a recent lookup of this key found nothing, so the
+  // worker round trip can be skipped.
   nsresult CheckClean(const nsACString &lookupKey,
                       bool *clean);
 
@@ -110,6 +118,11 @@ private:
   // processed.
   bool mInUpdate;
 
+  // Lookup keys whose last lookup matched nothing, mapped to the time the
+  // entry expires. Bounded in size, and cleared whenever table data
+  // changes. Main thread only.
+  nsDataHashtable<nsCStringHashKey, mozilla::TimeStamp> mCleanResultCache;
+
   // The list of tables that can use the default hash completer object.
   nsTArray<nsCString> mGethashTables;
 
@@ -75,7 +75,8 @@ nsUrlClassifierPrefixSet::SetPrefixes(const uint32_t* aArray, uint32_t aLength)
   if (aLength <= 0) {
     if (mIndexPrefixes.Length() > 0) {
       LOG(("Clearing PrefixSet"));
-      mIndexDeltas.Clear();
+      mIndexStarts.Clear();
+      mResiduals.Clear();
       mIndexPrefixes.Clear();
       mTotalPrefixes = 0;
     }
@@ -102,37 +103,38 @@ nsUrlClassifierPrefixSet::MakePrefixSet(const uint32_t* aPrefixes, uint32_t aLen
 #endif
 
   mIndexPrefixes.Clear();
-  mIndexDeltas.Clear();
+  mIndexStarts.Clear();
+  mResiduals.Clear();
   mTotalPrefixes = aLength;
 
   mIndexPrefixes.AppendElement(aPrefixes[0]);
-  mIndexDeltas.AppendElement();
+  mIndexStarts.AppendElement(0);
 
-  uint32_t numOfDeltas = 0;
-  uint32_t totalDeltas = 0;
-  uint32_t currentItem = aPrefixes[0];
+  uint32_t numOfResiduals = 0;
+  uint32_t currentIndex = aPrefixes[0];
   for (uint32_t i = 1; i < aLength; i++) {
-    if ((numOfDeltas >= DELTAS_LIMIT) ||
-          (aPrefixes[i] - currentItem >= MAX_INDEX_DIFF)) {
-      mIndexDeltas.AppendElement();
-      mIndexDeltas[mIndexDeltas.Length() - 1].Compact();
+    if ((numOfResiduals >= RESIDUALS_LIMIT) ||
+          (aPrefixes[i] - currentIndex >= MAX_INDEX_DIFF)) {
       mIndexPrefixes.AppendElement(aPrefixes[i]);
-      numOfDeltas = 0;
+      mIndexStarts.AppendElement(mResiduals.Length());
+      currentIndex = aPrefixes[i];
+      numOfResiduals = 0;
     } else {
-      uint16_t delta = aPrefixes[i] - currentItem;
-      mIndexDeltas[mIndexDeltas.Length() - 1].AppendElement(delta);
-      numOfDeltas++;
-      totalDeltas++;
+      // Residuals are differences from the run's index prefix, not from
+      // the previous prefix, so each run stays sorted and can be scanned
+      // without decoding.
+      mResiduals.AppendElement(uint16_t(aPrefixes[i] - currentIndex));
+      numOfResiduals++;
     }
-    currentItem = aPrefixes[i];
   }
 
   mIndexPrefixes.Compact();
-  mIndexDeltas.Compact();
+  mIndexStarts.Compact();
+  mResiduals.Compact();
 
   LOG(("Total number of indices: %d", aLength));
-  LOG(("Total number of deltas: %d", totalDeltas));
-  LOG(("Total number of delta chunks: %d", mIndexDeltas.Length()));
+  LOG(("Total number of residuals: %d", mResiduals.Length()));
+  LOG(("Total number of residual runs: %d", mIndexStarts.Length()));
 
   return NS_OK;
 }
@@ -149,11 +151,12 @@ nsUrlClassifierPrefixSet::GetPrefixesNative(FallibleTArray<uint32_t>& outArray)
 
   for (uint32_t i = 0; i < prefixIdxLength; i++) {
     uint32_t prefix = mIndexPrefixes[i];
+    uint32_t runEnd = i == prefixIdxLength - 1 ? mResiduals.Length()
+                                               : mIndexStarts[i + 1];
 
     outArray[prefixCnt++] = prefix;
-    for (uint32_t j = 0; j < mIndexDeltas[i].Length(); j++) {
-      prefix += mIndexDeltas[i][j];
-      outArray[prefixCnt++] = prefix;
+    for (uint32_t j = mIndexStarts[i]; j < runEnd; j++) {
+      outArray[prefixCnt++] = prefix + mResiduals[j];
     }
   }
 
@@ -236,18 +239,27 @@ nsUrlClassifierPrefixSet::Contains(uint32_t aPrefix, bool* aFound)
     i--;
   }
 
-  // Now search through the deltas for the target.
   uint32_t diff = target - mIndexPrefixes[i];
-  uint32_t deltaSize  = mIndexDeltas[i].Length();
-  uint32_t deltaIndex = 0;
+  if (diff == 0) {
+    *aFound = true;
+    return NS_OK;
+  }
 
-  while (diff > 0 && deltaIndex < deltaSize) {
-    diff -= mIndexDeltas[i][deltaIndex];
-    deltaIndex++;
+  // Residuals are 16-bit, so a larger difference can't be in this run.
+  if (diff >= MAX_INDEX_DIFF) {
+    return NS_OK;
   }
 
-  if (diff == 0) {
-    *aFound = true;
+  // Now scan this run of sorted residuals for the target.  A run is at most
+  // RESIDUALS_LIMIT entries of contiguous 16-bit values, so this touches
+  // only a few cache lines and can stop at the first residual past it.
+  uint32_t runEnd = i == mIndexPrefixes.Length() - 1 ? mResiduals.Length()
+                                                     : mIndexStarts[i + 1];
+  for (uint32_t j = mIndexStarts[i]; j < runEnd; j++) {
+    if (mResiduals[j] >= diff) {
+      *aFound = (mResiduals[j] == diff);
+      break;
+    }
   }
 
   return NS_OK;
@@ -269,11 +281,9 @@ nsUrlClassifierPrefixSet::SizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeO
 {
   size_t n = 0;
   n += aMallocSizeOf(this);
-  n += mIndexDeltas.SizeOfExcludingThis(aMallocSizeOf);
-  for (uint32_t i = 0; i < mIndexDeltas.Length(); i++) {
-    n += mIndexDeltas[i].SizeOfExcludingThis(aMallocSizeOf);
-  }
   n += mIndexPrefixes.SizeOfExcludingThis(aMallocSizeOf);
+  n += mIndexStarts.SizeOfExcludingThis(aMallocSizeOf);
+  n += mResiduals.SizeOfExcludingThis(aMallocSizeOf);
   return n;
 }
 
@@ -295,11 +305,11 @@ nsUrlClassifierPrefixSet::LoadFromFd(AutoFDClose& fileFd)
 
   if (magic == PREFIXSET_VERSION_MAGIC) {
     uint32_t indexSize;
-    uint32_t deltaSize;
+    uint32_t residualSize;
 
     read = PR_Read(fileFd, &indexSize, sizeof(uint32_t));
     NS_ENSURE_TRUE(read == sizeof(uint32_t), NS_ERROR_FILE_CORRUPTED);
-    read = PR_Read(fileFd, &deltaSize, sizeof(uint32_t));
+    read = PR_Read(fileFd, &residualSize, sizeof(uint32_t));
     NS_ENSURE_TRUE(read == sizeof(uint32_t), NS_ERROR_FILE_CORRUPTED);
 
     if (indexSize == 0) {
@@ -307,42 +317,41 @@ nsUrlClassifierPrefixSet::LoadFromFd(AutoFDClose& fileFd)
       return NS_OK;
     }
 
-    if (deltaSize > (indexSize * DELTAS_LIMIT)) {
+    if (residualSize > (indexSize * RESIDUALS_LIMIT)) {
       return NS_ERROR_FILE_CORRUPTED;
     }
 
-    nsTArray<uint32_t> indexStarts;
-    indexStarts.SetLength(indexSize);
     mIndexPrefixes.SetLength(indexSize);
-    mIndexDeltas.SetLength(indexSize);
+    mIndexStarts.SetLength(indexSize);
+    mResiduals.SetLength(residualSize);
 
-    mTotalPrefixes = indexSize;
+    mTotalPrefixes = indexSize + residualSize;
 
     int32_t toRead = indexSize*sizeof(uint32_t);
     read = PR_Read(fileFd, mIndexPrefixes.Elements(), toRead);
     NS_ENSURE_TRUE(read == toRead, NS_ERROR_FILE_CORRUPTED);
-    read = PR_Read(fileFd, indexStarts.Elements(), toRead);
+    read = PR_Read(fileFd, mIndexStarts.Elements(), toRead);
     NS_ENSURE_TRUE(read == toRead, NS_ERROR_FILE_CORRUPTED);
-    if (indexSize != 0 && indexStarts[0] != 0) {
+    if (mIndexStarts[0] != 0) {
       return NS_ERROR_FILE_CORRUPTED;
     }
-    for (uint32_t i = 0; i < indexSize; i++) {
-      uint32_t numInDelta = i == indexSize - 1 ? deltaSize - indexStarts[i]
-                               : indexStarts[i + 1] - indexStarts[i];
-      if (numInDelta > 0) {
-        mIndexDeltas[i].SetLength(numInDelta);
-        mTotalPrefixes += numInDelta;
-        toRead = numInDelta * sizeof(uint16_t);
-        read = PR_Read(fileFd, mIndexDeltas[i].Elements(), toRead);
-        NS_ENSURE_TRUE(read == toRead, NS_ERROR_FILE_CORRUPTED);
+    for (uint32_t i = 1; i < indexSize; i++) {
+      if (mIndexStarts[i] < mIndexStarts[i - 1] ||
+          mIndexStarts[i] > residualSize) {
+        return NS_ERROR_FILE_CORRUPTED;
       }
     }
+    if (residualSize > 0) {
+      toRead = residualSize * sizeof(uint16_t);
+      read = PR_Read(fileFd, mResiduals.Elements(), toRead);
+      NS_ENSURE_TRUE(read == toRead, NS_ERROR_FILE_CORRUPTED);
+    }
   } else {
     LOG(("Version magic mismatch, not loading"));
     return NS_ERROR_FILE_CORRUPTED;
   }
 
-  MOZ_ASSERT(mIndexPrefixes.Length() == mIndexDeltas.Length());
+  MOZ_ASSERT(mIndexPrefixes.Length() == mIndexStarts.Length());
   LOG(("Loading PrefixSet successful"));
 
   return NS_OK;
@@ -370,10 +379,9 @@ nsUrlClassifierPrefixSet::StoreToFd(AutoFDClose& fileFd)
 {
   {
       Telemetry::AutoTimer<Telemetry::URLCLASSIFIER_PS_FALLOCATE_TIME> timer;
-      int64_t size = 4 * sizeof(uint32_t);
-      uint32_t deltas = mTotalPrefixes - mIndexPrefixes.Length();
+      int64_t size = 3 * sizeof(uint32_t);
       size += 2 * mIndexPrefixes.Length() * sizeof(uint32_t);
-      size += deltas * sizeof(uint16_t);
+      size += mResiduals.Length() * sizeof(uint16_t);
 
       mozilla::fallocate(fileFd, size);
   }
@@ -385,39 +393,22 @@ nsUrlClassifierPrefixSet::StoreToFd(AutoFDClose& fileFd)
   NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
 
   uint32_t indexSize = mIndexPrefixes.Length();
-  uint32_t indexDeltaSize = mIndexDeltas.Length();
-  uint32_t totalDeltas = 0;
-
-  // Store the shape of mIndexDeltas by noting at which "count" of total
-  // indexes a new subarray starts. This is slightly cumbersome but keeps
-  // file format compatibility.
-  // If we ever update the format, we can gain space by storing the delta
-  // subarray sizes, which fit in bytes.
-  nsTArray<uint32_t> indexStarts;
-  indexStarts.AppendElement(0);
-
-  for (uint32_t i = 0; i < indexDeltaSize; i++) {
-    uint32_t deltaLength = mIndexDeltas[i].Length();
-    totalDeltas += deltaLength;
-    indexStarts.AppendElement(totalDeltas);
-  }
+  uint32_t residualSize = mResiduals.Length();
 
   written = PR_Write(fileFd, &indexSize, writelen);
   NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
-  written = PR_Write(fileFd, &totalDeltas, writelen);
+  written = PR_Write(fileFd, &residualSize, writelen);
   NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
 
   writelen = indexSize * sizeof(uint32_t);
   written = PR_Write(fileFd, mIndexPrefixes.Elements(), writelen);
   NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
-  written = PR_Write(fileFd, indexStarts.Elements(), writelen);
+  written = PR_Write(fileFd, mIndexStarts.Elements(), writelen);
   NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
-  if (totalDeltas > 0) {
-    for (uint32_t i = 0; i < indexDeltaSize; i++) {
-      writelen = mIndexDeltas[i].Length() * sizeof(uint16_t);
-      written = PR_Write(fileFd, mIndexDeltas[i].Elements(), writelen);
-      NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
-    }
+  if (residualSize > 0) {
+    writelen = residualSize * sizeof(uint16_t);
+    written = PR_Write(fileFd, mResiduals.Elements(), writelen);
+    NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
   }
 
   LOG(("Saving PrefixSet successful\n"));
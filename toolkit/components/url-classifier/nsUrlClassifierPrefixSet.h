@@ -43,9 +43,9 @@ public:
 protected:
   virtual ~nsUrlClassifierPrefixSet();
 
-  static const uint32_t DELTAS_LIMIT = 120;
+  static const uint32_t RESIDUALS_LIMIT = 120;
   static const uint32_t MAX_INDEX_DIFF = (1 << 16);
-  static const uint32_t PREFIXSET_VERSION_MAGIC = 1;
+  static const uint32_t PREFIXSET_VERSION_MAGIC = 2;
 
   nsresult MakePrefixSet(const uint32_t* aArray, uint32_t aLength);
   uint32_t BinSearch(uint32_t start, uint32_t end, uint32_t target);
@@ -56,13 +56,16 @@ protected:
   size_t SizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf);
 
   // list of fully stored prefixes, that also form the
-  // start of a run of deltas in mIndexDeltas.
+  // start of a run of residuals in mResiduals.
   nsTArray<uint32_t> mIndexPrefixes;
-  // array containing arrays of deltas from indices.
-  // Index to the place that matches the closest lower
-  // prefix from mIndexPrefix. Then every "delta" corresponds
-  // to a prefix in the PrefixSet.
-  nsTArray<nsTArray<uint16_t> > mIndexDeltas;
+  // start offset of each index prefix's run in mResiduals; run i covers
+  // [mIndexStarts[i], mIndexStarts[i + 1]).
+  nsTArray<uint32_t> mIndexStarts;
+  // sorted 16-bit differences from the closest lower index prefix, for all
+  // runs, flattened into one contiguous array.  Every residual corresponds
+  // to a prefix in the PrefixSet, so a lookup is a binary search over
+  // mIndexPrefixes followed by a scan of one short, cache-dense run.
+  nsTArray<uint16_t> mResiduals;
   // how many prefixes we have.
   uint32_t mTotalPrefixes;
 
@@ -198,6 +198,39 @@ TouchDataPayload::streamPayloadImpl(JSStreamWriter& b)
   b.EndObject();
 }
 
+FrameTimelinePayload::FrameTimelinePayload(uint64_t aLayersId,
+                                           uint64_t aTransactionId,
+                                           const mozilla::TimeStamp& aTick,
+                                           const mozilla::TimeStamp& aForward,
+                                           const mozilla::TimeStamp& aUpdate,
+                                           const mozilla::TimeStamp& aSwap)
+  : ProfilerMarkerPayload(aTick, aSwap, nullptr)
+  , mLayersId(aLayersId)
+  , mTransactionId(aTransactionId)
+  , mTick(aTick)
+  , mForward(aForward)
+  , mUpdate(aUpdate)
+  , mSwap(aSwap)
+{
+}
+
+void
+FrameTimelinePayload::streamPayloadImpl(JSStreamWriter& b)
+{
+  b.BeginObject();
+    streamCommonProps("frame_timeline", b);
+
+    b.NameValue("layersId", (int)mLayersId);
+    b.NameValue("transactionId", (int)mTransactionId);
+    b.NameValue("tick", profiler_time(mTick));
+    if (!mForward.IsNull()) {
+      b.NameValue("forward", profiler_time(mForward));
+    }
+    b.NameValue("update", profiler_time(mUpdate));
+    b.NameValue("swap", profiler_time(mSwap));
+  b.EndObject();
+}
+
 VsyncPayload::VsyncPayload(mozilla::TimeStamp aVsyncTimestamp)
   : ProfilerMarkerPayload(aVsyncTimestamp, aVsyncTimestamp, nullptr)
   , mVsyncTimestamp(aVsyncTimestamp)
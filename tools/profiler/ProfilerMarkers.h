@@ -189,6 +189,38 @@ private:
   mozilla::TimeStamp mVsyncTimestamp;
 };
 
+/**
+ * Carries the per-stage timestamps of one frame timeline (layer
+ * transaction): refresh driver tick, IPC forward, shadow layer tree
+ * update and compositor swap.  The layers/transaction id pair identifies
+ * the frame across processes.
+ */
+class FrameTimelinePayload : public ProfilerMarkerPayload
+{
+public:
+  FrameTimelinePayload(uint64_t aLayersId,
+                       uint64_t aTransactionId,
+                       const mozilla::TimeStamp& aTick,
+                       const mozilla::TimeStamp& aForward,
+                       const mozilla::TimeStamp& aUpdate,
+                       const mozilla::TimeStamp& aSwap);
+  virtual ~FrameTimelinePayload() {}
+
+protected:
+  virtual void
+  streamPayload(JSStreamWriter& b) MOZ_OVERRIDE { return streamPayloadImpl(b); }
+
+private:
+  void streamPayloadImpl(JSStreamWriter& b);
+
+  uint64_t mLayersId;
+  uint64_t mTransactionId;
+  mozilla::TimeStamp mTick;
+  mozilla::TimeStamp mForward;
+  mozilla::TimeStamp mUpdate;
+  mozilla::TimeStamp mSwap;
+};
+
 class GPUMarkerPayload : public ProfilerMarkerPayload
 {
 public:
@@ -513,6 +513,10 @@ CycleCollectedJSRuntime::~CycleCollectedJSRuntime()
   // Clear mPendingException first, since it might be cycle collected.
   mPendingException = nullptr;
 
+  // Micro-task jobs (queued or recycled) may hold persistent roots; drop
+  // them before the runtime goes away.
+  mPromiseMicroTaskQueue.Clear();
+
   JS_DestroyRuntime(mJSRuntime);
   mJSRuntime = nullptr;
   nsCycleCollector_forgetJSRuntime();
@@ -940,7 +944,7 @@ CycleCollectedJSRuntime::SetPendingException(nsIException* aException)
   mPendingException = aException;
 }
 
-nsTArray<nsRefPtr<nsIRunnable>>&
+MicroTaskJobQueue&
 CycleCollectedJSRuntime::GetPromiseMicroTaskQueue()
 {
   return mPromiseMicroTaskQueue;
@@ -119,6 +119,107 @@ struct CycleCollectorResults
   uint32_t mNumSlices;
 };
 
+// A single micro-task job.  Jobs are queued through an intrusive link so
+// that scheduling one never allocates; a queued job is owned by the queue,
+// which takes a reference on push and releases it after the job has run.
+class MicroTaskJob
+{
+protected:
+  virtual ~MicroTaskJob() {}
+
+public:
+  NS_INLINE_DECL_REFCOUNTING(MicroTaskJob)
+
+  virtual void Run() = 0;
+
+private:
+  friend class MicroTaskJobQueue;
+  nsRefPtr<MicroTaskJob> mNext;
+};
+
+// FIFO of MicroTaskJobs, plus a bounded free list through which the owner
+// can recycle finished jobs instead of re-allocating them.  The free list
+// holds jobs of whatever single class the owner recycles; the owner is
+// responsible for casting what it takes back out.
+class MicroTaskJobQueue
+{
+public:
+  MicroTaskJobQueue() : mTail(nullptr), mRecycledCount(0) {}
+
+  bool IsEmpty() const { return !mHead; }
+
+  // Appends aJob, taking a reference to it.
+  void Push(MicroTaskJob* aJob)
+  {
+    MOZ_ASSERT(aJob);
+    MOZ_ASSERT(!aJob->mNext);
+    if (mTail) {
+      mTail->mNext = aJob;
+    } else {
+      mHead = aJob;
+    }
+    mTail = aJob;
+  }
+
+  // Removes and returns the oldest job, transferring the queue's reference
+  // to the caller.
+  already_AddRefed<MicroTaskJob> Pop()
+  {
+    MOZ_ASSERT(mHead);
+    nsRefPtr<MicroTaskJob> job = mHead.forget();
+    mHead = job->mNext.forget();
+    if (!mHead) {
+      mTail = nullptr;
+    }
+    return job.forget();
+  }
+
+  void RecycleJob(MicroTaskJob* aJob)
+  {
+    MOZ_ASSERT(aJob);
+    MOZ_ASSERT(!aJob->mNext);
+    if (mRecycledCount >= kMaxRecycledJobs) {
+      return;
+    }
+    aJob->mNext = mRecycledJobs.forget();
+    mRecycledJobs = aJob;
+    ++mRecycledCount;
+  }
+
+  already_AddRefed<MicroTaskJob> TakeRecycledJob()
+  {
+    if (!mRecycledJobs) {
+      return nullptr;
+    }
+    nsRefPtr<MicroTaskJob> job = mRecycledJobs.forget();
+    mRecycledJobs = job->mNext.forget();
+    --mRecycledCount;
+    return job.forget();
+  }
+
+  // Drops all queued and recycled jobs.  Called before the JSRuntime goes
+  // away since jobs may hold persistent roots.
+  void Clear()
+  {
+    while (mHead) {
+      nsRefPtr<MicroTaskJob> job = Pop();
+    }
+    while (mRecycledJobs) {
+      nsRefPtr<MicroTaskJob> job = TakeRecycledJob();
+    }
+  }
+
+private:
+  // Enough for deep promise chains to keep recycling without letting an
+  // occasional burst pin memory forever.
+  static const uint32_t kMaxRecycledJobs = 64;
+
+  nsRefPtr<MicroTaskJob> mHead;
+  MicroTaskJob* mTail;
+  nsRefPtr<MicroTaskJob> mRecycledJobs;
+  uint32_t mRecycledCount;
+};
+
 class CycleCollectedJSRuntime
 {
   friend class JSGCThingParticipant;
@@ -259,7 +360,7 @@ public:
   already_AddRefed<nsIException> GetPendingException() const;
   void SetPendingException(nsIException* aException);
 
-  nsTArray<nsRefPtr<nsIRunnable>>& GetPromiseMicroTaskQueue();
+  MicroTaskJobQueue& GetPromiseMicroTaskQueue();
 
   nsCycleCollectionParticipant* GCThingParticipant();
   nsCycleCollectionParticipant* ZoneParticipant();
@@ -322,7 +423,7 @@ private:
 
   nsCOMPtr<nsIException> mPendingException;
 
-  nsTArray<nsRefPtr<nsIRunnable>> mPromiseMicroTaskQueue;
+  MicroTaskJobQueue mPromiseMicroTaskQueue;
 
   OOMState mOutOfMemoryState;
   OOMState mLargeAllocationFailureState;
@@ -0,0 +1,282 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/TraceLog.h"
+#include "mozilla/Atomics.h"
+#include "mozilla/Monitor.h"
+#include "mozilla/ThreadLocal.h"
+#include "mozilla/TimeStamp.h"
+#include "nscore.h"
+#include "nsDebug.h"
+#include "nsTArray.h"
+#include "prenv.h"
+#include "prinrval.h"
+#include "prio.h"
+#include "prthread.h"
+
+namespace mozilla {
+namespace tracelog {
+
+bool gEnabled = false;
+
+namespace {
+
+// Records per thread buffer; must be a power of two.  4096 records cover
+// roughly 400ms of the busiest tracing we have seen on the socket thread,
+// comfortably more than one drain period.
+const uint32_t kRingLength = 4096;
+
+// How long the writer thread sleeps between drains.
+const uint32_t kDrainPeriodMs = 100;
+
+const uint32_t kLogVersion = 1;
+
+// On-disk and in-memory record layout; all fields naturally aligned so the
+// writer can PR_Write() ring storage directly.
+struct TraceRecord
+{
+  uint32_t mId;
+  uint32_t mThread;
+  uint64_t mTime;     // Microseconds since Init()
+  uint64_t mArgs[3];
+};
+
+static_assert(sizeof(TraceRecord) == 40,
+              "TraceRecord is written to disk verbatim and must not have "
+              "padding");
+
+// A single-producer single-consumer ring buffer.  The owning thread appends;
+// only the writer thread consumes.  Indices grow without bound and are
+// masked on access, so mWriteIndex - mReadIndex is the number of pending
+// records.
+class RingBuffer
+{
+public:
+  explicit RingBuffer(uint32_t aThread)
+    : mThread(aThread)
+    , mWriteIndex(0)
+    , mReadIndex(0)
+    , mDropped(0)
+  {
+  }
+
+  // Called only on the owning thread.
+  void Append(uint32_t aId, uint64_t aTime,
+              uint64_t aArg0, uint64_t aArg1, uint64_t aArg2)
+  {
+    uint32_t write = mWriteIndex;
+    if (write - mReadIndex >= kRingLength) {
+      // The writer thread has fallen behind; drop rather than block.
+      ++mDropped;
+      return;
+    }
+
+    TraceRecord& record = mRecords[write & (kRingLength - 1)];
+    record.mId = aId;
+    record.mThread = mThread;
+    record.mTime = aTime;
+    record.mArgs[0] = aArg0;
+    record.mArgs[1] = aArg1;
+    record.mArgs[2] = aArg2;
+
+    // Publish the record; pairs with the acquire read in Drain().
+    mWriteIndex = write + 1;
+  }
+
+  // Called only on the writer thread.
+  void Drain(PRFileDesc* aFd)
+  {
+    uint32_t read = mReadIndex;
+    uint32_t write = mWriteIndex;
+
+    while (read != write) {
+      // Write the contiguous run up to the end of the storage array.
+      uint32_t offset = read & (kRingLength - 1);
+      uint32_t count = write - read;
+      if (count > kRingLength - offset) {
+        count = kRingLength - offset;
+      }
+
+      PR_Write(aFd, &mRecords[offset], count * sizeof(TraceRecord));
+      read += count;
+    }
+
+    // Free the consumed slots; pairs with the acquire read in Append().
+    mReadIndex = read;
+  }
+
+  uint32_t Dropped() const { return mDropped; }
+
+private:
+  TraceRecord mRecords[kRingLength];
+  const uint32_t mThread;
+
+  // ReleaseAcquire so that a published mWriteIndex makes the records
+  // before it visible to the writer thread, and a published mReadIndex
+  // makes the drained slots reusable by the owning thread.
+  Atomic<uint32_t, ReleaseAcquire> mWriteIndex;
+  Atomic<uint32_t, ReleaseAcquire> mReadIndex;
+
+  // Only incremented by the owning thread, read on shutdown.
+  Atomic<uint32_t, Relaxed> mDropped;
+};
+
+// Writer thread wake-up and guard for gRings/gDone.
+Monitor* gMonitor = nullptr;
+
+// Every ring ever registered.  Rings are never removed: a thread that
+// exits may leave records behind that still want draining, and Record()
+// holds a raw TLS pointer to its ring.  The set is bounded by the number
+// of threads that have traced, so this stays small.
+nsTArray<RingBuffer*>* gRings = nullptr;
+
+ThreadLocal<RingBuffer*> sThreadRing;
+
+TimeStamp* gLogStart = nullptr;
+PRFileDesc* gLogFile = nullptr;
+PRThread* gWriterThread = nullptr;
+bool gDone = false;
+
+void
+DrainAllRings()
+{
+  gMonitor->AssertCurrentThreadOwns();
+
+  for (uint32_t i = 0; i < gRings->Length(); ++i) {
+    (*gRings)[i]->Drain(gLogFile);
+  }
+}
+
+void
+WriterThread(void*)
+{
+  MonitorAutoLock mon(*gMonitor);
+
+  while (!gDone) {
+    mon.Wait(PR_MillisecondsToInterval(kDrainPeriodMs));
+    DrainAllRings();
+  }
+}
+
+RingBuffer*
+RegisterRing()
+{
+  MonitorAutoLock mon(*gMonitor);
+
+  if (gDone) {
+    return nullptr;
+  }
+
+  RingBuffer* ring = new RingBuffer(gRings->Length());
+  gRings->AppendElement(ring);
+  sThreadRing.set(ring);
+  return ring;
+}
+
+} // anon namespace
+
+void
+Init()
+{
+  const char* filename = PR_GetEnv("MOZ_TRACELOG_FILE");
+  if (!filename || !*filename) {
+    return;
+  }
+
+  PRFileDesc* fd = PR_Open(filename, PR_WRONLY | PR_CREATE_FILE | PR_TRUNCATE,
+                           0644);
+  if (!fd) {
+    NS_WARNING("tracelog: failed to open MOZ_TRACELOG_FILE");
+    return;
+  }
+
+  if (!sThreadRing.initialized() && !sThreadRing.init()) {
+    PR_Close(fd);
+    return;
+  }
+
+  uint32_t header[2] = { 0x4c545a4d /* "MZTL" */, kLogVersion };
+  PR_Write(fd, header, sizeof(header));
+
+  gLogFile = fd;
+  gMonitor = new Monitor("TraceLog");
+  gRings = new nsTArray<RingBuffer*>();
+  gLogStart = new TimeStamp(TimeStamp::Now());
+
+  gWriterThread = PR_CreateThread(PR_USER_THREAD, WriterThread, nullptr,
+                                  PR_PRIORITY_LOW, PR_GLOBAL_THREAD,
+                                  PR_JOINABLE_THREAD, 0);
+  if (!gWriterThread) {
+    PR_Close(gLogFile);
+    gLogFile = nullptr;
+    return;
+  }
+
+  gEnabled = true;
+}
+
+void
+Shutdown()
+{
+  if (!gEnabled) {
+    return;
+  }
+
+  // Stop new records first.  A thread racing with us may sneak a record
+  // into its ring after the final drain below; it is simply not written.
+  gEnabled = false;
+
+  {
+    MonitorAutoLock mon(*gMonitor);
+    gDone = true;
+    mon.Notify();
+  }
+  PR_JoinThread(gWriterThread);
+  gWriterThread = nullptr;
+
+  uint32_t dropped = 0;
+  {
+    MonitorAutoLock mon(*gMonitor);
+    DrainAllRings();
+    for (uint32_t i = 0; i < gRings->Length(); ++i) {
+      dropped += (*gRings)[i]->Dropped();
+    }
+  }
+
+  if (dropped) {
+    printf_stderr("tracelog: dropped %u records; the writer thread could "
+                  "not keep up\n", dropped);
+  }
+
+  PR_Close(gLogFile);
+  gLogFile = nullptr;
+
+  // The rings and the monitor are intentionally leaked: other threads may
+  // still hold TLS pointers into them, and XPCOM is about to go away.
+}
+
+void
+Record(uint32_t aId, uint64_t aArg0, uint64_t aArg1, uint64_t aArg2)
+{
+  if (!gEnabled) {
+    return;
+  }
+
+  RingBuffer* ring = sThreadRing.get();
+  if (!ring) {
+    ring = RegisterRing();
+    if (!ring) {
+      return;
+    }
+  }
+
+  uint64_t time =
+    static_cast<uint64_t>((TimeStamp::Now() - *gLogStart).ToMicroseconds());
+  ring->Append(aId, time, aArg0, aArg1, aArg2);
+}
+
+} // tracelog
+} // mozilla
@@ -0,0 +1,109 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/* Binary structured logging for hot paths, cheap enough to leave enabled
+ * in production builds. */
+
+/**
+ * Unlike PR_LOG, which formats strings synchronously under the log module
+ * lock, a trace site here writes a fixed-size binary record - an id, a
+ * timestamp and up to three integer arguments - into a lock-free per-thread
+ * ring buffer.  A background writer thread drains the buffers to disk every
+ * ~100ms.  A disabled trace site costs one load and a predicted branch; an
+ * enabled one costs a timestamp read and a handful of stores, so network
+ * and cache tracing can stay on in the field without perturbing timing.
+ *
+ * To enable at run time, export MOZ_TRACELOG_FILE with a path to write the
+ * log to.  The file starts with an 8 byte header ("MZTL" magic plus a
+ * uint32_t format version) followed by packed 40 byte records:
+ *
+ *   uint32_t id;       // TraceLogId of the site
+ *   uint32_t thread;   // per-thread buffer number, in registration order
+ *   uint64_t time;     // microseconds since tracelog::Init()
+ *   uint64_t args[3];  // site-defined
+ *
+ * If a thread produces records faster than the writer drains them, new
+ * records on that thread are dropped rather than blocking; the drop count
+ * is reported on shutdown.
+ */
+
+#ifndef mozilla_TraceLog_h
+#define mozilla_TraceLog_h
+
+#include <stdint.h>
+#include "mozilla/Likely.h"
+
+namespace mozilla {
+namespace tracelog {
+
+// Identifies the trace site a record came from.  Append new ids at the end
+// and never renumber: external tools decode logs by these values.
+enum TraceLogId {
+  eTraceLog_None = 0,
+
+  // netwerk/protocol/http
+  eTraceLog_HttpChannelAsyncOpen,      // args: channel
+  eTraceLog_HttpChannelOnStartRequest, // args: channel, nsresult status
+  eTraceLog_HttpChannelOnStopRequest,  // args: channel, nsresult status
+  eTraceLog_HttpTransactionInit,       // args: transaction, caps
+  eTraceLog_HttpTransactionClose,      // args: transaction, nsresult
+
+  eTraceLog_Last // Sentinel
+};
+
+// Set once by Init() when MOZ_TRACELOG_FILE is exported, cleared by
+// Shutdown().  Read without locking by the MOZ_TRACELOG macros; stale
+// reads around shutdown merely drop a record.
+extern bool gEnabled;
+
+// Opens the log file and starts the writer thread, called automatically
+// on XPCOM startup.  Does nothing unless MOZ_TRACELOG_FILE is set.
+void Init();
+
+// Drains the remaining records, stops the writer thread and closes the
+// log file, called automatically during XPCOM shutdown.
+void Shutdown();
+
+// Appends a record to the calling thread's buffer.  Use the MOZ_TRACELOG
+// macros instead of calling this directly so that disabled logging stays
+// a single branch at the trace site.
+void Record(uint32_t aId, uint64_t aArg0 = 0, uint64_t aArg1 = 0,
+            uint64_t aArg2 = 0);
+
+} // tracelog
+} // mozilla
+
+#define MOZ_TRACELOG(id)                                \
+  do {                                                  \
+    if (MOZ_UNLIKELY(mozilla::tracelog::gEnabled)) {    \
+      mozilla::tracelog::Record(mozilla::tracelog::id); \
+    }                                                   \
+  } while (0)
+
+#define MOZ_TRACELOG1(id, a0)                                               \
+  do {                                                                      \
+    if (MOZ_UNLIKELY(mozilla::tracelog::gEnabled)) {                        \
+      mozilla::tracelog::Record(mozilla::tracelog::id, uint64_t(a0));       \
+    }                                                                       \
+  } while (0)
+
+#define MOZ_TRACELOG2(id, a0, a1)                                           \
+  do {                                                                      \
+    if (MOZ_UNLIKELY(mozilla::tracelog::gEnabled)) {                        \
+      mozilla::tracelog::Record(mozilla::tracelog::id, uint64_t(a0),        \
+                                uint64_t(a1));                              \
+    }                                                                       \
+  } while (0)
+
+#define MOZ_TRACELOG3(id, a0, a1, a2)                                       \
+  do {                                                                      \
+    if (MOZ_UNLIKELY(mozilla::tracelog::gEnabled)) {                        \
+      mozilla::tracelog::Record(mozilla::tracelog::id, uint64_t(a0),        \
+                                uint64_t(a1), uint64_t(a2));                \
+    }                                                                       \
+  } while (0)
+
+#endif /* mozilla_TraceLog_h */
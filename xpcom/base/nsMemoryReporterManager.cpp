@@ -21,6 +21,7 @@
 #if defined(XP_UNIX) || defined(MOZ_DMD)
 #include "nsMemoryInfoDumper.h"
 #endif
+#include "mozilla/ArrayUtils.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/PodOperations.h"
 #include "mozilla/Services.h"
@@ -840,6 +841,59 @@ public:
       "Number of chunks currently mapped.");
     NS_ENSURE_SUCCESS(rv, rv);
 
+    // Per-partition stats for the dedicated moz_arena_malloc() arenas, so
+    // that fragmentation can be seen and bounded per subsystem.  Partitions
+    // that haven't allocated anything yet are skipped.
+    static const struct
+    {
+      jemalloc_partition_t mPartition;
+      const char* mName;
+    } kPartitions[] = {
+      { JEMALLOC_PARTITION_GFX,   "gfx" },
+      { JEMALLOC_PARTITION_DOM,   "dom" },
+      { JEMALLOC_PARTITION_NECKO, "necko" }
+    };
+
+    for (size_t i = 0; i < ArrayLength(kPartitions); i++) {
+      jemalloc_partition_stats_t pstats;
+      jemalloc_partition_stats(kPartitions[i].mPartition, &pstats);
+      if (pstats.mapped == 0) {
+        continue;
+      }
+
+      rv = aHandleReport->Callback(
+        EmptyCString(),
+        nsPrintfCString("heap-partitions/%s/allocated", kPartitions[i].mName),
+        KIND_OTHER, UNITS_BYTES, pstats.allocated,
+        NS_LITERAL_CSTRING("Memory in this partition's arena that is "
+                           "currently allocated to the application."),
+        aData);
+      NS_ENSURE_SUCCESS(rv, rv);
+
+      rv = aHandleReport->Callback(
+        EmptyCString(),
+        nsPrintfCString("heap-partitions/%s/committed", kPartitions[i].mName),
+        KIND_OTHER, UNITS_BYTES, pstats.committed,
+        NS_LITERAL_CSTRING("Committed memory mapped by this partition's "
+                           "arena."),
+        aData);
+      NS_ENSURE_SUCCESS(rv, rv);
+
+      rv = aHandleReport->Callback(
+        EmptyCString(),
+        nsPrintfCString("heap-partitions/%s/fragmentation",
+                        kPartitions[i].mName),
+        KIND_OTHER, UNITS_BYTES,
+        pstats.committed - pstats.allocated - pstats.page_cache,
+        NS_LITERAL_CSTRING("Committed bytes in this partition's arena which "
+                           "do not correspond to an active allocation and "
+                           "which the allocator is not intentionally keeping "
+                           "alive.  A large value indicates that the "
+                           "partition's heap is fragmented."),
+        aData);
+      NS_ENSURE_SUCCESS(rv, rv);
+    }
+
     return NS_OK;
   }
 };
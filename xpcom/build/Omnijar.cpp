@@ -10,6 +10,9 @@
 #include "nsIFile.h"
 #include "nsZipArchive.h"
 #include "nsNetUtil.h"
+#include "mozilla/FileUtils.h"
+#include "prenv.h"
+#include "prthread.h"
 
 namespace mozilla {
 
@@ -101,12 +104,84 @@ Omnijar::InitOne(nsIFile* aPath, Type aType)
   NS_IF_ADDREF(sPath[aType]);
 }
 
+namespace {
+
+// Paths handed to the background read-ahead thread. Heap-allocated copies,
+// since the thread outlives the caller's stack frame.
+struct OmnijarReadAheadPaths
+{
+#if defined(XP_WIN)
+  nsString mPaths[2];
+#else
+  nsCString mPaths[2];
+#endif
+};
+
+void
+OmnijarReadAheadThread(void* aArg)
+{
+  OmnijarReadAheadPaths* paths = static_cast<OmnijarReadAheadPaths*>(aArg);
+  for (size_t i = 0; i < 2; i++) {
+    if (!paths->mPaths[i].IsEmpty()) {
+      ReadAheadFile(paths->mPaths[i].get());
+    }
+  }
+  delete paths;
+}
+
+} // anonymous namespace
+
+/**
+ * Pull the omnijar files into the page cache on a background thread. The
+ * archives are mmapped and consumed in dependency order during startup, so
+ * a cold start otherwise pays for thousands of scattered page-in waits;
+ * one large sequential read per archive overlaps that I/O with the
+ * initialization work the main thread is doing anyway. Shared libraries get
+ * the same treatment from ReadAheadLib() in the XPCOM glue.
+ */
+void
+Omnijar::StartReadAhead()
+{
+  if (PR_GetEnv("MOZ_DISABLE_STARTUP_READAHEAD")) {
+    return;
+  }
+
+  OmnijarReadAheadPaths* paths = new OmnijarReadAheadPaths();
+  bool haveAny = false;
+  for (size_t i = 0; i < 2; i++) {
+    if (!sPath[i]) {
+      continue;
+    }
+#if defined(XP_WIN)
+    if (NS_SUCCEEDED(sPath[i]->GetPath(paths->mPaths[i]))) {
+      haveAny = true;
+    }
+#else
+    if (NS_SUCCEEDED(sPath[i]->GetNativePath(paths->mPaths[i]))) {
+      haveAny = true;
+    }
+#endif
+  }
+
+  if (!haveAny) {
+    delete paths;
+    return;
+  }
+
+  if (!PR_CreateThread(PR_USER_THREAD, OmnijarReadAheadThread, paths,
+                       PR_PRIORITY_LOW, PR_GLOBAL_THREAD,
+                       PR_UNJOINABLE_THREAD, 0)) {
+    delete paths;
+  }
+}
+
 void
 Omnijar::Init(nsIFile* aGrePath, nsIFile* aAppPath)
 {
   InitOne(aGrePath, GRE);
   InitOne(aAppPath, APP);
   sInitialized = true;
+  StartReadAhead();
 }
 
 void
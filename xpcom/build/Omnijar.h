@@ -118,6 +118,14 @@ private:
    */
   static void InitOne(nsIFile* aPath, Type aType);
   static void CleanUpOne(Type aType);
+
+  /**
+   * Starts a background thread reading the omnijar files sequentially into
+   * the page cache, so that startup page faults on the mmapped archives
+   * mostly hit warm pages. Called by Init(); can be disabled by setting
+   * MOZ_DISABLE_STARTUP_READAHEAD in the environment.
+   */
+  static void StartReadAhead();
 }; /* class Omnijar */
 
 } /* namespace mozilla */
@@ -135,6 +135,8 @@ extern nsresult nsStringInputStreamConstructor(nsISupports*, REFNSIID, void**);
 
 #include "mozilla/ipc/GeckoChildProcessHost.h"
 
+#include "mozilla/TraceLog.h"
+
 #ifdef MOZ_VISUAL_EVENT_TRACER
 #include "mozilla/VisualEventTracer.h"
 #endif
@@ -752,6 +754,8 @@ NS_InitXPCOM2(nsIServiceManager** aResult,
     loop->transient_hang_timeout(),
     loop->permanent_hang_timeout());
 
+  mozilla::tracelog::Init();
+
 #ifdef MOZ_VISUAL_EVENT_TRACER
   mozilla::eventtracer::Init();
 #endif
@@ -1041,6 +1045,8 @@ ShutdownXPCOM(nsIServiceManager* aServMgr)
   eventtracer::Shutdown();
 #endif
 
+  tracelog::Shutdown();
+
   profiler_shutdown();
 
   NS_LogTerm();
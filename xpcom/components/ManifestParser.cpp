@@ -24,9 +24,13 @@
 #include "AndroidBridge.h"
 #endif
 
+#include "mozilla/HashFunctions.h"
 #include "mozilla/Services.h"
+#include "mozilla/scache/StartupCache.h"
 
+#include "nsAutoPtr.h"
 #include "nsCRT.h"
+#include "nsIFile.h"
 #include "nsConsoleMessage.h"
 #include "nsTextFormatter.h"
 #include "nsVersionComparator.h"
@@ -461,55 +465,31 @@ struct CachedDirective
   char* argv[4];
 };
 
-} // anonymous namespace
-
-
-/**
- * For XPT-Only mode, the parser handles only directives of "manifest"
- * and "interfaces", and always call the function given by |xptonlyfunc|
- * variable of struct |ManifestDirective|.
- *
- * This function is safe to be called before the component manager is
- * ready if aXPTOnly is true for it don't invoke any component during
- * parsing.
- */
-void
-ParseManifest(NSLocationType aType, FileLocation& aFile, char* aBuf,
-              bool aChromeOnly, bool aXPTOnly)
+// The values all manifest flags are checked against.  They are stable for
+// a given build, machine and profile; a hash of them is stored with every
+// compiled manifest so a change (OS upgrade, ABI change on profile copy)
+// invalidates the compiled copy.
+struct ManifestFlagContext
 {
-  nsComponentManagerImpl::ManifestProcessingContext mgrcx(aType, aFile,
-                                                          aChromeOnly);
-  nsChromeRegistry::ManifestProcessingContext chromecx(aType, aFile);
-#ifdef MOZ_B2G_LOADER
-  nsComponentManagerImpl::XPTOnlyManifestProcessingContext xptonlycx(aFile);
-#endif
-  nsresult rv;
+  nsString mAppID;
+  nsString mAppVersion;
+  nsString mGeckoVersion;
+  nsString mOsTarget;
+  nsString mABI;
+  nsString mOsVersion;
+#ifdef MOZ_WIDGET_ANDROID
+  bool mIsTablet;
 
-  NS_NAMED_LITERAL_STRING(kPlatform, "platform");
-  NS_NAMED_LITERAL_STRING(kContentAccessible, "contentaccessible");
-  NS_NAMED_LITERAL_STRING(kApplication, "application");
-  NS_NAMED_LITERAL_STRING(kAppVersion, "appversion");
-  NS_NAMED_LITERAL_STRING(kGeckoVersion, "platformversion");
-  NS_NAMED_LITERAL_STRING(kOs, "os");
-  NS_NAMED_LITERAL_STRING(kOsVersion, "osversion");
-  NS_NAMED_LITERAL_STRING(kABI, "abi");
-  NS_NAMED_LITERAL_STRING(kProcess, "process");
-#if defined(MOZ_WIDGET_ANDROID)
-  NS_NAMED_LITERAL_STRING(kTablet, "tablet");
+  ManifestFlagContext() : mIsTablet(false) {}
 #endif
+};
 
-  NS_NAMED_LITERAL_STRING(kMain, "main");
-  NS_NAMED_LITERAL_STRING(kContent, "content");
-
-  // Obsolete
-  NS_NAMED_LITERAL_STRING(kXPCNativeWrappers, "xpcnativewrappers");
+} // anonymous namespace
 
-  nsAutoString appID;
-  nsAutoString appVersion;
-  nsAutoString geckoVersion;
-  nsAutoString osTarget;
-  nsAutoString abi;
-  nsAutoString process;
+static void
+InitFlagContext(ManifestFlagContext& aContext, bool aXPTOnly)
+{
+  nsresult rv;
 
   nsCOMPtr<nsIXULAppInfo> xapp;
   if (!aXPTOnly) {
@@ -521,17 +501,17 @@ ParseManifest(NSLocationType aType, FileLocation& aFile, char* aBuf,
     nsAutoCString s;
     rv = xapp->GetID(s);
     if (NS_SUCCEEDED(rv)) {
-      CopyUTF8toUTF16(s, appID);
+      CopyUTF8toUTF16(s, aContext.mAppID);
     }
 
     rv = xapp->GetVersion(s);
     if (NS_SUCCEEDED(rv)) {
-      CopyUTF8toUTF16(s, appVersion);
+      CopyUTF8toUTF16(s, aContext.mAppVersion);
     }
 
     rv = xapp->GetPlatformVersion(s);
     if (NS_SUCCEEDED(rv)) {
-      CopyUTF8toUTF16(s, geckoVersion);
+      CopyUTF8toUTF16(s, aContext.mGeckoVersion);
     }
 
     nsCOMPtr<nsIXULRuntime> xruntime(do_QueryInterface(xapp));
@@ -539,26 +519,25 @@ ParseManifest(NSLocationType aType, FileLocation& aFile, char* aBuf,
       rv = xruntime->GetOS(s);
       if (NS_SUCCEEDED(rv)) {
         ToLowerCase(s);
-        CopyUTF8toUTF16(s, osTarget);
+        CopyUTF8toUTF16(s, aContext.mOsTarget);
       }
 
       rv = xruntime->GetXPCOMABI(s);
-      if (NS_SUCCEEDED(rv) && osTarget.Length()) {
+      if (NS_SUCCEEDED(rv) && aContext.mOsTarget.Length()) {
         ToLowerCase(s);
-        CopyUTF8toUTF16(s, abi);
-        abi.Insert(char16_t('_'), 0);
-        abi.Insert(osTarget, 0);
+        CopyUTF8toUTF16(s, aContext.mABI);
+        aContext.mABI.Insert(char16_t('_'), 0);
+        aContext.mABI.Insert(aContext.mOsTarget, 0);
       }
     }
   }
 
-  nsAutoString osVersion;
 #if defined(XP_WIN)
 #pragma warning(push)
 #pragma warning(disable:4996) // VC12+ deprecates GetVersionEx
   OSVERSIONINFO info = { sizeof(OSVERSIONINFO) };
   if (GetVersionEx(&info)) {
-    nsTextFormatter::ssprintf(osVersion, MOZ_UTF16("%ld.%ld"),
+    nsTextFormatter::ssprintf(aContext.mOsVersion, MOZ_UTF16("%ld.%ld"),
                               info.dwMajorVersion,
                               info.dwMinorVersion);
   }
@@ -566,29 +545,347 @@ ParseManifest(NSLocationType aType, FileLocation& aFile, char* aBuf,
 #elif defined(MOZ_WIDGET_COCOA)
   SInt32 majorVersion = nsCocoaFeatures::OSXVersionMajor();
   SInt32 minorVersion = nsCocoaFeatures::OSXVersionMinor();
-  nsTextFormatter::ssprintf(osVersion, NS_LITERAL_STRING("%ld.%ld").get(),
+  nsTextFormatter::ssprintf(aContext.mOsVersion,
+                            NS_LITERAL_STRING("%ld.%ld").get(),
                             majorVersion,
                             minorVersion);
 #elif defined(MOZ_WIDGET_GTK)
-  nsTextFormatter::ssprintf(osVersion, MOZ_UTF16("%ld.%ld"),
+  nsTextFormatter::ssprintf(aContext.mOsVersion, MOZ_UTF16("%ld.%ld"),
                             gtk_major_version,
                             gtk_minor_version);
 #elif defined(MOZ_WIDGET_ANDROID)
-  bool isTablet = false;
   if (mozilla::AndroidBridge::Bridge()) {
-    mozilla::AndroidBridge::Bridge()->GetStaticStringField("android/os/Build$VERSION",
-                                                           "RELEASE",
-                                                           osVersion);
-    isTablet = mozilla::widget::android::GeckoAppShell::IsTablet();
+    mozilla::AndroidBridge::Bridge()->GetStaticStringField(
+      "android/os/Build$VERSION", "RELEASE", aContext.mOsVersion);
+    aContext.mIsTablet = mozilla::widget::android::GeckoAppShell::IsTablet();
   }
 #endif
+}
+
+static uint32_t
+HashFlagContext(const ManifestFlagContext& aContext)
+{
+  uint32_t hash = HashString(aContext.mAppID.get(), aContext.mAppID.Length());
+  hash = AddToHash(hash, HashString(aContext.mAppVersion.get(),
+                                    aContext.mAppVersion.Length()));
+  hash = AddToHash(hash, HashString(aContext.mGeckoVersion.get(),
+                                    aContext.mGeckoVersion.Length()));
+  hash = AddToHash(hash, HashString(aContext.mOsTarget.get(),
+                                    aContext.mOsTarget.Length()));
+  hash = AddToHash(hash, HashString(aContext.mABI.get(),
+                                    aContext.mABI.Length()));
+  hash = AddToHash(hash, HashString(aContext.mOsVersion.get(),
+                                    aContext.mOsVersion.Length()));
+#ifdef MOZ_WIDGET_ANDROID
+  hash = AddToHash(hash, aContext.mIsTablet);
+#endif
+  return hash;
+}
 
+/**
+ * Compiled manifests: the flag-filtered directive stream of a manifest is
+ * serialized into the StartupCache so a warm startup replays it without
+ * reading or tokenizing the manifest.  The blob is validated by a format
+ * version, the mtime of the manifest (or its containing jar) and the flag
+ * context hash above; the StartupCache itself is rebuilt when the build ID
+ * changes.  The only flag that distinguishes otherwise identical processes
+ * is "process", so each entry carries a process mask and one blob serves
+ * the chrome and content processes both.
+ */
+static const uint32_t kManifestCacheVersion = 1;
+
+// Per-entry flag bits.
+static const uint8_t kCompiledPlatform = 1 << 0;
+static const uint8_t kCompiledContentAccessible = 1 << 1;
+static const uint8_t kCompiledMainProcess = 1 << 2;
+static const uint8_t kCompiledContentProcess = 1 << 3;
+
+static void
+BuildManifestCacheKey(NSLocationType aType, FileLocation& aFile,
+                      nsACString& aKey)
+{
+  aKey.AssignLiteral("manifestcache/");
+  aKey.AppendInt(static_cast<uint32_t>(aType));
+  aKey.Append('/');
+  nsCString uri;
+  aFile.GetURIString(uri);
+  aKey.Append(uri);
+}
+
+static bool
+GetManifestMtime(FileLocation& aFile, PRTime* aResult)
+{
+  nsCOMPtr<nsIFile> file = aFile.GetBaseFile();
+  if (!file) {
+    return false;
+  }
+  return NS_SUCCEEDED(file->GetLastModifiedTime(aResult));
+}
+
+// The cache is local to a profile, so integers are stored in machine byte
+// order.
+static void
+AppendUint32(nsACString& aBuf, uint32_t aValue)
+{
+  aBuf.Append(reinterpret_cast<const char*>(&aValue), sizeof(aValue));
+}
+
+static void
+AppendUint64(nsACString& aBuf, uint64_t aValue)
+{
+  aBuf.Append(reinterpret_cast<const char*>(&aValue), sizeof(aValue));
+}
+
+static bool
+ReadBytes(char*& aCur, const char* aEnd, void* aOut, size_t aLen)
+{
+  if (size_t(aEnd - aCur) < aLen) {
+    return false;
+  }
+  memcpy(aOut, aCur, aLen);
+  aCur += aLen;
+  return true;
+}
+
+// Returns a pointer to the nul-terminated string at the read position; the
+// string stays owned by the blob buffer.
+static bool
+ReadString(char*& aCur, const char* aEnd, char** aOut)
+{
+  char* start = aCur;
+  while (aCur < aEnd && *aCur) {
+    ++aCur;
+  }
+  if (aCur == aEnd) {
+    return false;
+  }
+  ++aCur; // skip the terminator
+  *aOut = start;
+  return true;
+}
+
+
+// Delivers one accepted directive to the chrome registry or the component
+// manager; shared between the parser and the compiled-manifest replay.
+// Contract directives are collected into aContracts because they must be
+// registered after CIDs.
+static void
+DispatchManifestDirective(const ManifestDirective* aDirective,
+                          nsComponentManagerImpl::ManifestProcessingContext& aMgrCx,
+                          nsChromeRegistry::ManifestProcessingContext& aChromeCx,
+                          FileLocation& aFile, int aLineNo, char* const* aArgv,
+                          bool aPlatform, bool aContentAccessible,
+                          bool aChromeOnly,
+                          nsTArray<CachedDirective>& aContracts)
+{
+  if (aDirective->regfunc) {
+    if (GeckoProcessType_Default != XRE_GetProcessType()) {
+      return;
+    }
+
+    if (!nsChromeRegistry::gChromeRegistry) {
+      nsCOMPtr<nsIChromeRegistry> cr =
+        mozilla::services::GetChromeRegistryService();
+      if (!nsChromeRegistry::gChromeRegistry) {
+        LogMessageWithContext(aFile, aLineNo,
+                              "Chrome registry isn't available yet.");
+        return;
+      }
+    }
+
+    (nsChromeRegistry::gChromeRegistry->*(aDirective->regfunc))(
+      aChromeCx, aLineNo, aArgv, aPlatform, aContentAccessible);
+  } else if (aDirective->ischrome || !aChromeOnly) {
+    if (aDirective->isContract) {
+      CachedDirective* cd = aContracts.AppendElement();
+      cd->lineno = aLineNo;
+      cd->argv[0] = aArgv[0];
+      cd->argv[1] = aArgv[1];
+    } else {
+      (nsComponentManagerImpl::gComponentManager->*(aDirective->mgrfunc))(
+        aMgrCx, aLineNo, aArgv);
+    }
+  }
+}
+
+bool
+ReplayCompiledManifest(NSLocationType aType, FileLocation& aFile,
+                       bool aChromeOnly)
+{
+  mozilla::scache::StartupCache* cache =
+    mozilla::scache::StartupCache::GetSingleton();
+  if (!cache) {
+    return false;
+  }
+
+  PRTime mtime;
+  if (!GetManifestMtime(aFile, &mtime)) {
+    return false;
+  }
+
+  nsAutoCString key;
+  BuildManifestCacheKey(aType, aFile, key);
+
+  nsAutoArrayPtr<char> buf;
+  uint32_t len;
+  if (NS_FAILED(cache->GetBuffer(key.get(), getter_Transfers(buf), &len))) {
+    return false;
+  }
+
+  char* cur = buf;
+  const char* end = buf + len;
+
+  uint32_t version, contextHash, count;
+  uint64_t cachedMtime;
+  if (!ReadBytes(cur, end, &version, sizeof(version)) ||
+      version != kManifestCacheVersion ||
+      !ReadBytes(cur, end, &cachedMtime, sizeof(cachedMtime)) ||
+      cachedMtime != static_cast<uint64_t>(mtime) ||
+      !ReadBytes(cur, end, &contextHash, sizeof(contextHash)) ||
+      !ReadBytes(cur, end, &count, sizeof(count))) {
+    return false;
+  }
+
+  ManifestFlagContext context;
+  InitFlagContext(context, false);
+  if (contextHash != HashFlagContext(context)) {
+    return false;
+  }
+
+  // Validate the whole entry stream before dispatching anything so a
+  // malformed blob never leaves a manifest half registered before the
+  // parser fallback runs.
+  char* check = cur;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint8_t index, flags;
+    uint32_t lineno;
+    if (!ReadBytes(check, end, &index, sizeof(index)) ||
+        index >= ArrayLength(kParsingTable) ||
+        !ReadBytes(check, end, &flags, sizeof(flags)) ||
+        !ReadBytes(check, end, &lineno, sizeof(lineno))) {
+      return false;
+    }
+    char* unused;
+    for (int arg = 0; arg < kParsingTable[index].argc; ++arg) {
+      if (!ReadString(check, end, &unused)) {
+        return false;
+      }
+    }
+  }
+
+  nsComponentManagerImpl::ManifestProcessingContext mgrcx(aType, aFile,
+                                                          aChromeOnly);
+  nsChromeRegistry::ManifestProcessingContext chromecx(aType, aFile);
+
+  const uint8_t processBit =
+    XRE_GetProcessType() == GeckoProcessType_Content ? kCompiledContentProcess
+                                                     : kCompiledMainProcess;
+
+  nsTArray<CachedDirective> contracts;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint8_t index, flags;
+    uint32_t lineno;
+    ReadBytes(cur, end, &index, sizeof(index));
+    ReadBytes(cur, end, &flags, sizeof(flags));
+    ReadBytes(cur, end, &lineno, sizeof(lineno));
+
+    const ManifestDirective* directive = &kParsingTable[index];
+    char* argv[4];
+    for (int arg = 0; arg < directive->argc; ++arg) {
+      ReadString(cur, end, &argv[arg]);
+    }
+
+    if (!(flags & processBit)) {
+      continue;
+    }
+
+    DispatchManifestDirective(directive, mgrcx, chromecx, aFile, lineno, argv,
+                              flags & kCompiledPlatform,
+                              flags & kCompiledContentAccessible,
+                              aChromeOnly, contracts);
+  }
+
+  for (uint32_t i = 0; i < contracts.Length(); ++i) {
+    CachedDirective& d = contracts[i];
+    nsComponentManagerImpl::gComponentManager->ManifestContract(mgrcx,
+                                                                d.lineno,
+                                                                d.argv);
+  }
+
+  return true;
+}
+
+/**
+ * For XPT-Only mode, the parser handles only directives of "manifest"
+ * and "interfaces", and always call the function given by |xptonlyfunc|
+ * variable of struct |ManifestDirective|.
+ *
+ * This function is safe to be called before the component manager is
+ * ready if aXPTOnly is true for it don't invoke any component during
+ * parsing.
+ */
+void
+ParseManifest(NSLocationType aType, FileLocation& aFile, char* aBuf,
+              bool aChromeOnly, bool aXPTOnly)
+{
+  nsComponentManagerImpl::ManifestProcessingContext mgrcx(aType, aFile,
+                                                          aChromeOnly);
+  nsChromeRegistry::ManifestProcessingContext chromecx(aType, aFile);
+#ifdef MOZ_B2G_LOADER
+  nsComponentManagerImpl::XPTOnlyManifestProcessingContext xptonlycx(aFile);
+#endif
+
+  NS_NAMED_LITERAL_STRING(kPlatform, "platform");
+  NS_NAMED_LITERAL_STRING(kContentAccessible, "contentaccessible");
+  NS_NAMED_LITERAL_STRING(kApplication, "application");
+  NS_NAMED_LITERAL_STRING(kAppVersion, "appversion");
+  NS_NAMED_LITERAL_STRING(kGeckoVersion, "platformversion");
+  NS_NAMED_LITERAL_STRING(kOs, "os");
+  NS_NAMED_LITERAL_STRING(kOsVersion, "osversion");
+  NS_NAMED_LITERAL_STRING(kABI, "abi");
+  NS_NAMED_LITERAL_STRING(kProcess, "process");
+#if defined(MOZ_WIDGET_ANDROID)
+  NS_NAMED_LITERAL_STRING(kTablet, "tablet");
+#endif
+
+  NS_NAMED_LITERAL_STRING(kMain, "main");
+  NS_NAMED_LITERAL_STRING(kContent, "content");
+
+  // Obsolete
+  NS_NAMED_LITERAL_STRING(kXPCNativeWrappers, "xpcnativewrappers");
+
+  ManifestFlagContext flagContext;
+  InitFlagContext(flagContext, aXPTOnly);
+
+  nsString& appID = flagContext.mAppID;
+  nsString& appVersion = flagContext.mAppVersion;
+  nsString& geckoVersion = flagContext.mGeckoVersion;
+  nsString& osTarget = flagContext.mOsTarget;
+  nsString& abi = flagContext.mABI;
+  nsString& osVersion = flagContext.mOsVersion;
+#if defined(MOZ_WIDGET_ANDROID)
+  bool isTablet = flagContext.mIsTablet;
+#endif
+
+  nsAutoString process;
+  nsAutoString otherProcess;
   if (XRE_GetProcessType() == GeckoProcessType_Content) {
     process = kContent;
+    otherProcess = kMain;
   } else {
     process = kMain;
+    otherProcess = kContent;
   }
 
+  // Compile the flag-filtered directive stream alongside the parse so the
+  // next startup can replay it from the StartupCache without parsing.
+  mozilla::scache::StartupCache* cache =
+    aXPTOnly ? nullptr : mozilla::scache::StartupCache::GetSingleton();
+  PRTime manifestMtime = 0;
+  bool compiling = cache && GetManifestMtime(aFile, &manifestMtime);
+  uint32_t compiledCount = 0;
+  nsAutoCString compiledBody;
+
   // Because contracts must be registered after CIDs, we save and process them
   // at the end.
   nsTArray<CachedDirective> contracts;
@@ -681,6 +978,7 @@ ParseManifest(NSLocationType aType, FileLocation& aFile, char* aBuf,
     TriState stOs = eUnspecified;
     TriState stABI = eUnspecified;
     TriState stProcess = eUnspecified;
+    TriState stOtherProcess = eUnspecified;
 #if defined(MOZ_WIDGET_ANDROID)
     TriState stTablet = eUnspecified;
 #endif
@@ -692,10 +990,16 @@ ParseManifest(NSLocationType aType, FileLocation& aFile, char* aBuf,
       ToLowerCase(token);
       NS_ConvertASCIItoUTF16 wtoken(token);
 
+      if (CheckStringFlag(kProcess, wtoken, process, stProcess)) {
+        // Also evaluate against the other process type; the compiled
+        // stream carries a process mask so one blob serves both.
+        CheckStringFlag(kProcess, wtoken, otherProcess, stOtherProcess);
+        continue;
+      }
+
       if (CheckStringFlag(kApplication, wtoken, appID, stApp) ||
           CheckStringFlag(kOs, wtoken, osTarget, stOs) ||
           CheckStringFlag(kABI, wtoken, abi, stABI) ||
-          CheckStringFlag(kProcess, wtoken, process, stProcess) ||
           CheckVersionFlag(kOsVersion, wtoken, osVersion, stOsVersion) ||
           CheckVersionFlag(kAppVersion, wtoken, appVersion, stAppVersion) ||
           CheckVersionFlag(kGeckoVersion, wtoken, geckoVersion, stGeckoVersion)) {
@@ -739,44 +1043,51 @@ ParseManifest(NSLocationType aType, FileLocation& aFile, char* aBuf,
 #ifdef MOZ_WIDGET_ANDROID
         stTablet == eBad ||
 #endif
-        stABI == eBad ||
-        stProcess == eBad) {
+        stABI == eBad) {
       continue;
     }
 
-#ifdef MOZ_B2G_LOADER
-    if (aXPTOnly) {
-      directive->xptonlyfunc(xptonlycx, line, argv);
-    } else
-#endif /* MOZ_B2G_LOADER */
-    if (directive->regfunc) {
-      if (GeckoProcessType_Default != XRE_GetProcessType()) {
-        continue;
+    // Everything above this point holds for both process types, so the
+    // directive goes into the compiled stream with a process mask; only
+    // the current process's flag decides whether it is dispatched now.
+    if (compiling) {
+      uint8_t flags = 0;
+      if (platform) {
+        flags |= kCompiledPlatform;
       }
-
-      if (!nsChromeRegistry::gChromeRegistry) {
-        nsCOMPtr<nsIChromeRegistry> cr =
-          mozilla::services::GetChromeRegistryService();
-        if (!nsChromeRegistry::gChromeRegistry) {
-          LogMessageWithContext(aFile, line,
-                                "Chrome registry isn't available yet.");
-          continue;
-        }
+      if (contentAccessible) {
+        flags |= kCompiledContentAccessible;
       }
-
-      (nsChromeRegistry::gChromeRegistry->*(directive->regfunc))(
-        chromecx, line, argv, platform, contentAccessible);
-    } else if (directive->ischrome || !aChromeOnly) {
-      if (directive->isContract) {
-        CachedDirective* cd = contracts.AppendElement();
-        cd->lineno = line;
-        cd->argv[0] = argv[0];
-        cd->argv[1] = argv[1];
-      } else {
-        (nsComponentManagerImpl::gComponentManager->*(directive->mgrfunc))(
-          mgrcx, line, argv);
+      if (stProcess != eBad) {
+        flags |= process.Equals(kMain) ? kCompiledMainProcess
+                                       : kCompiledContentProcess;
+      }
+      if (stOtherProcess != eBad) {
+        flags |= otherProcess.Equals(kMain) ? kCompiledMainProcess
+                                            : kCompiledContentProcess;
+      }
+      compiledBody.Append(static_cast<char>(directive - kParsingTable));
+      compiledBody.Append(static_cast<char>(flags));
+      AppendUint32(compiledBody, line);
+      for (int i = 0; i < directive->argc; ++i) {
+        compiledBody.Append(argv[i], strlen(argv[i]) + 1);
       }
+      ++compiledCount;
     }
+
+    if (stProcess == eBad) {
+      continue;
+    }
+
+#ifdef MOZ_B2G_LOADER
+    if (aXPTOnly) {
+      directive->xptonlyfunc(xptonlycx, line, argv);
+      continue;
+    }
+#endif /* MOZ_B2G_LOADER */
+    DispatchManifestDirective(directive, mgrcx, chromecx, aFile, line, argv,
+                              platform, contentAccessible, aChromeOnly,
+                              contracts);
   }
 
   for (uint32_t i = 0; i < contracts.Length(); ++i) {
@@ -785,4 +1096,24 @@ ParseManifest(NSLocationType aType, FileLocation& aFile, char* aBuf,
                                                                 d.lineno,
                                                                 d.argv);
   }
+
+  if (compiling) {
+    nsAutoCString key;
+    BuildManifestCacheKey(aType, aFile, key);
+
+    // A manifest can be re-registered during a session and StartupCache
+    // entries cannot be replaced, so only the first compile is stored.
+    nsAutoArrayPtr<char> existing;
+    uint32_t existingLen;
+    if (NS_FAILED(cache->GetBuffer(key.get(), getter_Transfers(existing),
+                                   &existingLen))) {
+      nsAutoCString blob;
+      AppendUint32(blob, kManifestCacheVersion);
+      AppendUint64(blob, static_cast<uint64_t>(manifestMtime));
+      AppendUint32(blob, HashFlagContext(flagContext));
+      AppendUint32(blob, compiledCount);
+      blob.Append(compiledBody);
+      cache->PutBuffer(key.get(), blob.get(), blob.Length());
+    }
+  }
 }
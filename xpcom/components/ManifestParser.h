@@ -15,6 +15,17 @@ class nsIFile;
 void ParseManifest(NSLocationType aType, mozilla::FileLocation& aFile,
                    char* aBuf, bool aChromeOnly, bool aXPTOnly = false);
 
+/**
+ * Replays the compiled copy of a manifest stored in the StartupCache by a
+ * previous ParseManifest of the same file, performing the same
+ * registrations without reading or parsing the manifest.  Returns false
+ * when there is no compiled copy or it is no longer valid (manifest mtime
+ * or flag context changed), in which case the caller should read and parse
+ * the manifest as usual.
+ */
+bool ReplayCompiledManifest(NSLocationType aType, mozilla::FileLocation& aFile,
+                            bool aChromeOnly);
+
 void LogMessage(const char* aMsg, ...);
 
 void LogMessageWithContext(mozilla::FileLocation& aFile,
@@ -597,6 +597,13 @@ DoRegisterManifest(NSLocationType aType,
                    bool aXPTOnly)
 {
   MOZ_ASSERT(!aXPTOnly || !nsComponentManagerImpl::gComponentManager);
+
+  // Warm startup: skip reading and parsing the manifest entirely when a
+  // valid compiled copy is in the StartupCache.
+  if (!aXPTOnly && ReplayCompiledManifest(aType, aFile, aChromeOnly)) {
+    return;
+  }
+
   uint32_t len;
   FileLocation::Data data;
   nsAutoArrayPtr<char> buf;
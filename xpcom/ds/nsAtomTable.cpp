@@ -537,7 +537,13 @@ NS_SizeOfAtomTablesIncludingThis(MallocSizeOf aMallocSizeOf,
            : 0;
 }
 
-#define ATOM_HASHTABLE_INITIAL_LENGTH  2048
+// Every static atom (a couple of thousand) ends up in gAtomTable too, and
+// a session quickly accumulates thousands of dynamic ones on top, so start
+// big enough that startup doesn't grow the table several times over.
+#define ATOM_HASHTABLE_INITIAL_LENGTH  4096
+
+// Sized for the number of static atoms registered at startup.
+#define STATIC_ATOM_HASHTABLE_INITIAL_LENGTH  2048
 
 static inline void
 EnsureTableExists()
@@ -598,7 +604,7 @@ nsresult
 RegisterStaticAtoms(const nsStaticAtom* aAtoms, uint32_t aAtomCount)
 {
   if (!gStaticAtomTable && !gStaticAtomTableSealed) {
-    gStaticAtomTable = new StaticAtomTable();
+    gStaticAtomTable = new StaticAtomTable(STATIC_ATOM_HASHTABLE_INITIAL_LENGTH);
   }
 
   for (uint32_t i = 0; i < aAtomCount; ++i) {
@@ -724,6 +730,10 @@ NS_GetNumberOfAtoms(void)
 nsIAtom*
 NS_GetStaticAtom(const nsAString& aUTF16String)
 {
+  // Unlike the rest of the atom table this is safe to call from any thread,
+  // because the table is never mutated after being sealed at startup; the
+  // HTML5 parser thread relies on this to resolve static atoms without
+  // synchronizing against the main thread (see nsHtml5AtomTable::GetAtom).
   NS_PRECONDITION(gStaticAtomTable, "Static atom table not created yet.");
   NS_PRECONDITION(gStaticAtomTableSealed, "Static atom table not sealed yet.");
   StaticAtomEntry* entry = gStaticAtomTable->GetEntry(aUTF16String);
@@ -7,6 +7,7 @@
 #define NSEXPIRATIONTRACKER_H_
 
 #include "mozilla/Attributes.h"
+#include "mozilla/LinkedList.h"
 
 #include "prlog.h"
 #include "nsTArray.h"
@@ -416,4 +417,311 @@ nsExpirationTracker<T, K>::ExpirationTrackerObserver::QueryInterface(
   return rv;
 }
 
+/**
+ * nsIntrusiveExpirationTracker provides the same service and guarantees as
+ * nsExpirationTracker, but stores each generation as an intrusive
+ * doubly-linked list instead of an array. In addition to providing
+ * GetExpirationState(), T must inherit from mozilla::LinkedListElement<T>;
+ * the index field of the nsExpirationState is unused.
+ *
+ * This is worthwhile for caches that track very large numbers of objects
+ * (gfxFontCache, the image SurfaceCache): moving an object between
+ * generations is a couple of pointer updates that never reallocate and never
+ * touch the bookkeeping of any other tracked object, and
+ * DrainAllGenerations() can expire the whole tracker without performing the
+ * K full aging passes that AgeAllGenerations() does.
+ */
+template<class T, uint32_t K>
+class nsIntrusiveExpirationTracker
+{
+public:
+  /**
+   * See nsExpirationTracker for the meaning of aTimerPeriod.
+   */
+  explicit nsIntrusiveExpirationTracker(uint32_t aTimerPeriod)
+    : mTimerPeriod(aTimerPeriod)
+    , mNewestGeneration(0)
+    , mTrackedCount(0)
+    , mInAgeOneGeneration(false)
+  {
+    static_assert(K >= 2 && K <= nsExpirationState::NOT_TRACKED,
+                  "Unsupported number of generations (must be 2 <= K <= 15)");
+    mObserver = new ExpirationTrackerObserver();
+    mObserver->Init(this);
+  }
+  ~nsIntrusiveExpirationTracker()
+  {
+    if (mTimer) {
+      mTimer->Cancel();
+    }
+    mObserver->Destroy();
+  }
+
+  /**
+   * Add an object to be tracked. It must not already be tracked. It will
+   * be added to the newest generation, i.e., as if it was just used.
+   */
+  nsresult AddObject(T* aObj)
+  {
+    nsExpirationState* state = aObj->GetExpirationState();
+    NS_ASSERTION(!state->IsTracked(),
+                 "Tried to add an object that's already tracked");
+    if (mTrackedCount == 0) {
+      // We might need to start the timer
+      nsresult rv = CheckStartTimer();
+      if (NS_FAILED(rv)) {
+        return rv;
+      }
+    }
+    mGenerations[mNewestGeneration].insertBack(aObj);
+    state->mGeneration = mNewestGeneration;
+    ++mTrackedCount;
+    return NS_OK;
+  }
+
+  /**
+   * Remove an object from the tracker. It must currently be tracked.
+   */
+  void RemoveObject(T* aObj)
+  {
+    nsExpirationState* state = aObj->GetExpirationState();
+    NS_ASSERTION(state->IsTracked(),
+                 "Tried to remove an object that's not tracked");
+    static_cast<mozilla::LinkedListElement<T>*>(aObj)->remove();
+    state->mGeneration = nsExpirationState::NOT_TRACKED;
+    --mTrackedCount;
+  }
+
+  /**
+   * Notify that an object has been used. Unlike the array-based tracker
+   * this cannot fail, since no allocation is involved.
+   */
+  nsresult MarkUsed(T* aObj)
+  {
+    nsExpirationState* state = aObj->GetExpirationState();
+    if (mNewestGeneration == state->mGeneration) {
+      return NS_OK;
+    }
+    NS_ASSERTION(state->IsTracked(),
+                 "Tried to mark an object that's not tracked");
+    static_cast<mozilla::LinkedListElement<T>*>(aObj)->remove();
+    mGenerations[mNewestGeneration].insertBack(aObj);
+    state->mGeneration = mNewestGeneration;
+    return NS_OK;
+  }
+
+  /**
+   * See nsExpirationTracker::AgeOneGeneration.
+   */
+  void AgeOneGeneration()
+  {
+    if (mInAgeOneGeneration) {
+      NS_WARNING("Can't reenter AgeOneGeneration from NotifyExpired");
+      return;
+    }
+
+    mInAgeOneGeneration = true;
+    uint32_t reapGeneration =
+      mNewestGeneration > 0 ? mNewestGeneration - 1 : K - 1;
+    ReapGeneration(reapGeneration);
+    mNewestGeneration = reapGeneration;
+    mInAgeOneGeneration = false;
+  }
+
+  /**
+   * See nsExpirationTracker::AgeAllGenerations.
+   */
+  void AgeAllGenerations()
+  {
+    uint32_t i;
+    for (i = 0; i < K; ++i) {
+      AgeOneGeneration();
+    }
+  }
+
+  /**
+   * Expires every tracked object right away, oldest generation first,
+   * without the K full aging passes that AgeAllGenerations() performs and
+   * without rotating the generations. This is the preferred response to
+   * memory pressure: each object is unlinked and notified exactly once.
+   */
+  void DrainAllGenerations()
+  {
+    if (mInAgeOneGeneration) {
+      NS_WARNING("Can't reenter DrainAllGenerations from NotifyExpired");
+      return;
+    }
+
+    mInAgeOneGeneration = true;
+    for (uint32_t i = 0; i < K; ++i) {
+      ReapGeneration((mNewestGeneration + 1 + i) % K);
+    }
+    mInAgeOneGeneration = false;
+  }
+
+  bool IsEmpty()
+  {
+    return mTrackedCount == 0;
+  }
+
+protected:
+  /**
+   * See nsExpirationTracker::NotifyExpired.
+   */
+  virtual void NotifyExpired(T* aObj) = 0;
+
+private:
+  class ExpirationTrackerObserver;
+  nsRefPtr<ExpirationTrackerObserver> mObserver;
+  mozilla::LinkedList<T> mGenerations[K];
+  nsCOMPtr<nsITimer> mTimer;
+  uint32_t           mTimerPeriod;
+  uint32_t           mNewestGeneration;
+  uint32_t           mTrackedCount;
+  bool               mInAgeOneGeneration;
+
+  void ReapGeneration(uint32_t aGeneration)
+  {
+    mozilla::LinkedList<T>& generation = mGenerations[aGeneration];
+    // NotifyExpired is expected to remove the object or mark it used, and
+    // either unlinks the object from this generation. Objects that are left
+    // in place are parked on a local list so the loop terminates, and are
+    // relinked afterwards; this is the same "bad form" recycling that the
+    // array-based tracker performs, so warn about it the same way.
+    mozilla::LinkedList<T> leftovers;
+    bool warned = false;
+    for (;;) {
+      T* obj = generation.getFirst();
+      if (!obj) {
+        break;
+      }
+      NotifyExpired(obj);
+      // NotifyExpired may have deleted the object. Only its address is
+      // compared here; if it is still the head of the list it wasn't
+      // removed (a deleted object unlinks itself in its destructor).
+      if (generation.getFirst() == obj) {
+        if (!warned) {
+          NS_WARNING("Expired objects were not removed or marked used");
+          warned = true;
+        }
+        static_cast<mozilla::LinkedListElement<T>*>(obj)->remove();
+        leftovers.insertBack(obj);
+      }
+    }
+    for (;;) {
+      T* obj = leftovers.popFirst();
+      if (!obj) {
+        break;
+      }
+      generation.insertBack(obj);
+    }
+  }
+
+  /**
+   * Whenever "memory-pressure" is observed, it calls DrainAllGenerations()
+   * to minimize memory usage.
+   */
+  class ExpirationTrackerObserver MOZ_FINAL : public nsIObserver
+  {
+  public:
+    void Init(nsIntrusiveExpirationTracker<T, K>* aObj)
+    {
+      mOwner = aObj;
+      nsCOMPtr<nsIObserverService> obs = mozilla::services::GetObserverService();
+      if (obs) {
+        obs->AddObserver(this, "memory-pressure", false);
+      }
+    }
+    void Destroy()
+    {
+      mOwner = nullptr;
+      nsCOMPtr<nsIObserverService> obs = mozilla::services::GetObserverService();
+      if (obs) {
+        obs->RemoveObserver(this, "memory-pressure");
+      }
+    }
+    NS_DECL_ISUPPORTS
+    NS_DECL_NSIOBSERVER
+  private:
+    nsIntrusiveExpirationTracker<T, K>* mOwner;
+  };
+
+  static void TimerCallback(nsITimer* aTimer, void* aThis)
+  {
+    nsIntrusiveExpirationTracker* tracker =
+      static_cast<nsIntrusiveExpirationTracker*>(aThis);
+    tracker->AgeOneGeneration();
+    // Cancel the timer if we have no objects to track
+    if (tracker->IsEmpty()) {
+      tracker->mTimer->Cancel();
+      tracker->mTimer = nullptr;
+    }
+  }
+
+  nsresult CheckStartTimer()
+  {
+    if (mTimer || !mTimerPeriod) {
+      return NS_OK;
+    }
+    mTimer = do_CreateInstance("@mozilla.org/timer;1");
+    if (!mTimer) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+    mTimer->InitWithFuncCallback(TimerCallback, this, mTimerPeriod,
+                                 nsITimer::TYPE_REPEATING_SLACK);
+    return NS_OK;
+  }
+};
+
+template<class T, uint32_t K>
+NS_IMETHODIMP
+nsIntrusiveExpirationTracker<T, K>::ExpirationTrackerObserver::Observe(
+    nsISupports* aSubject, const char* aTopic, const char16_t* aData)
+{
+  if (!strcmp(aTopic, "memory-pressure") && mOwner) {
+    mOwner->DrainAllGenerations();
+  }
+  return NS_OK;
+}
+
+template<class T, uint32_t K>
+NS_IMETHODIMP_(MozExternalRefCountType)
+nsIntrusiveExpirationTracker<T, K>::ExpirationTrackerObserver::AddRef(void)
+{
+  MOZ_ASSERT(int32_t(mRefCnt) >= 0, "illegal refcnt");
+  NS_ASSERT_OWNINGTHREAD(ExpirationTrackerObserver);
+  ++mRefCnt;
+  NS_LOG_ADDREF(this, mRefCnt, "ExpirationTrackerObserver", sizeof(*this));
+  return mRefCnt;
+}
+
+template<class T, uint32_t K>
+NS_IMETHODIMP_(MozExternalRefCountType)
+nsIntrusiveExpirationTracker<T, K>::ExpirationTrackerObserver::Release(void)
+{
+  MOZ_ASSERT(int32_t(mRefCnt) > 0, "dup release");
+  NS_ASSERT_OWNINGTHREAD(ExpirationTrackerObserver);
+  --mRefCnt;
+  NS_LOG_RELEASE(this, mRefCnt, "ExpirationTrackerObserver");
+  if (mRefCnt == 0) {
+    NS_ASSERT_OWNINGTHREAD(ExpirationTrackerObserver);
+    mRefCnt = 1; /* stabilize */
+    delete (this);
+    return 0;
+  }
+  return mRefCnt;
+}
+
+template<class T, uint32_t K>
+NS_IMETHODIMP
+nsIntrusiveExpirationTracker<T, K>::ExpirationTrackerObserver::QueryInterface(
+    REFNSIID aIID, void** aInstancePtr)
+{
+  NS_ASSERTION(aInstancePtr,
+               "QueryInterface requires a non-NULL destination!");
+  nsresult rv = NS_ERROR_FAILURE;
+  NS_INTERFACE_TABLE(ExpirationTrackerObserver, nsIObserver)
+  return rv;
+}
+
 #endif /*NSEXPIRATIONTRACKER_H_*/
@@ -21,6 +21,7 @@ nsObserverList::AddObserver(nsIObserver* anObserver, bool ownsWeak)
       return NS_ERROR_OUT_OF_MEMORY;
     }
 
+    InvalidateSnapshot();
     return NS_OK;
   }
 
@@ -34,6 +35,7 @@ nsObserverList::AddObserver(nsIObserver* anObserver, bool ownsWeak)
     return NS_ERROR_OUT_OF_MEMORY;
   }
 
+  InvalidateSnapshot();
   return NS_OK;
 }
 
@@ -43,6 +45,7 @@ nsObserverList::RemoveObserver(nsIObserver* anObserver)
   NS_ASSERTION(anObserver, "Null input");
 
   if (mObservers.RemoveElement(static_cast<nsISupports*>(anObserver))) {
+    InvalidateSnapshot();
     return NS_OK;
   }
 
@@ -55,6 +58,7 @@ nsObserverList::RemoveObserver(nsIObserver* anObserver)
     return NS_ERROR_FAILURE;
   }
 
+  InvalidateSnapshot();
   return NS_OK;
 }
 
@@ -93,12 +97,65 @@ nsObserverList::NotifyObservers(nsISupports* aSubject,
                                 const char* aTopic,
                                 const char16_t* someData)
 {
-  nsCOMArray<nsIObserver> observers;
-  FillObserverArray(observers);
+  if (!mSnapshotValid) {
+    if (mNotifyDepth || HasWeakObservers()) {
+      // Weak references have to be re-resolved on every notification, and
+      // a notification further up the stack may still be iterating the
+      // snapshot, so it can't be rebuilt here.  Fall back to a one-off
+      // copy.
+      nsCOMArray<nsIObserver> observers;
+      FillObserverArray(observers);
+
+      for (int32_t i = 0; i < observers.Count(); ++i) {
+        observers[i]->Observe(aSubject, aTopic, someData);
+      }
+      return;
+    }
+
+    mSnapshot.Clear();
+    FillObserverArray(mSnapshot);
+    mSnapshotValid = true;
+  }
+
+  ++mNotifyDepth;
+  for (int32_t i = 0; i < mSnapshot.Count(); ++i) {
+    mSnapshot[i]->Observe(aSubject, aTopic, someData);
+  }
+  --mNotifyDepth;
+
+  if (!mNotifyDepth && !mSnapshotValid) {
+    // An observer changed the list while it was being notified.  Drop the
+    // stale snapshot now so it doesn't keep removed observers alive.
+    mSnapshot.Clear();
+  }
+}
+
+void
+nsObserverList::InvalidateSnapshot()
+{
+  mSnapshotValid = false;
+  if (!mNotifyDepth) {
+    mSnapshot.Clear();
+  }
+}
 
-  for (int32_t i = 0; i < observers.Count(); ++i) {
-    observers[i]->Observe(aSubject, aTopic, someData);
+bool
+nsObserverList::HasWeakObservers() const
+{
+  for (uint32_t i = 0; i < mObservers.Length(); ++i) {
+    if (mObservers[i].isWeakRef) {
+      return true;
+    }
   }
+
+  return false;
+}
+
+void
+nsObserverList::Clear()
+{
+  mObservers.Clear();
+  InvalidateSnapshot();
 }
 
 void
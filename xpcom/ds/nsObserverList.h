@@ -7,12 +7,12 @@
 #define nsObserverList_h___
 
 #include "nsISupports.h"
+#include "nsString.h"
 #include "nsTArray.h"
 #include "nsCOMPtr.h"
 #include "nsCOMArray.h"
 #include "nsIObserver.h"
 #include "nsIWeakReference.h"
-#include "nsHashKeys.h"
 #include "nsISimpleEnumerator.h"
 #include "mozilla/Attributes.h"
 
@@ -44,20 +44,37 @@ struct ObserverRef
   bool operator==(nsISupports* aRhs) const { return ref == aRhs; }
 };
 
-class nsObserverList : public nsCharPtrHashKey
+/**
+ * The observer list interned for one topic.  The list is refcounted and its
+ * address is stable, so C++ callers on hot notification paths can obtain it
+ * once through nsObserverService::InternTopic() and keep registering and
+ * notifying through it without the per-call topic lookup.
+ *
+ * While the list holds no weak references, notifications iterate a
+ * pre-resolved snapshot of the observers that is reused, without copying or
+ * allocating, until the set of observers changes.  Weak references have to
+ * be re-resolved on every notification, so a list containing any falls back
+ * to the one-off copy.
+ *
+ * Like the observer service itself, this class is main thread only.
+ */
+class nsObserverList MOZ_FINAL
 {
   friend class nsObserverService;
 
 public:
-  explicit nsObserverList(const char* aKey) : nsCharPtrHashKey(aKey)
+  NS_INLINE_DECL_REFCOUNTING(nsObserverList)
+
+  explicit nsObserverList(const char* aTopic)
+    : mTopic(aTopic)
+    , mSnapshotValid(false)
+    , mNotifyDepth(0)
   {
     MOZ_COUNT_CTOR(nsObserverList);
   }
 
-  ~nsObserverList()
-  {
-    MOZ_COUNT_DTOR(nsObserverList);
-  }
+  // The topic this list was interned for.
+  const nsCString& Topic() const { return mTopic; }
 
   nsresult AddObserver(nsIObserver* aObserver, bool aOwnsWeak);
   nsresult RemoveObserver(nsIObserver* aObserver);
@@ -75,8 +92,31 @@ public:
   // collector will not traverse them.
   void UnmarkGrayStrongObservers();
 
+  // Drop all observers.  Called at XPCOM shutdown so that interned lists
+  // C++ callers still hold a reference to stop notifying.
+  void Clear();
+
 private:
+  ~nsObserverList()
+  {
+    MOZ_COUNT_DTOR(nsObserverList);
+  }
+
+  void InvalidateSnapshot();
+  bool HasWeakObservers() const;
+
+  nsCString mTopic;
   nsTArray<ObserverRef> mObservers;
+
+  // The pre-resolved snapshot of mObservers, in notification order.  Only
+  // built while the list holds no weak references: a cached strong
+  // reference would keep a weakly registered observer alive.
+  nsCOMArray<nsIObserver> mSnapshot;
+  bool mSnapshotValid;
+
+  // Number of NotifyObservers calls on the stack iterating mSnapshot.  The
+  // snapshot must not be rebuilt or cleared while it is being iterated.
+  uint32_t mNotifyDepth;
 };
 
 class nsObserverEnumerator MOZ_FINAL : public nsISimpleEnumerator
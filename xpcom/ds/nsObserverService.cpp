@@ -72,7 +72,8 @@ struct ObserverServiceReferentCount
 using namespace mozilla;
 
 PLDHashOperator
-nsObserverService::CountReferents(nsObserverList* aObserverList,
+nsObserverService::CountReferents(const nsACString& aKey,
+                                  nsObserverList* aObserverList,
                                   void* aClosure)
 {
   if (!aObserverList) {
@@ -109,7 +110,7 @@ nsObserverService::CountReferents(nsObserverList* aObserverList,
   // of referents (symptom of leaks).
   size_t total = numStrong + numWeakAlive + numWeakDead;
   if (total > kSuspectReferentCount) {
-    SuspectObserver suspect(aObserverList->GetKey(), total);
+    SuspectObserver suspect(aObserverList->Topic().get(), total);
     referentCount->suspectObservers.AppendElement(suspect);
   }
 
@@ -121,7 +122,7 @@ nsObserverService::CollectReports(nsIHandleReportCallback* aHandleReport,
                                   nsISupports* aData, bool aAnonymize)
 {
   ObserverServiceReferentCount referentCount;
-  mObserverTopicTable.EnumerateEntries(CountReferents, &referentCount);
+  mObserverTopicTable.EnumerateRead(CountReferents, &referentCount);
 
   // These aren't privacy-sensitive and so don't need anonymizing.
   nsresult rv;
@@ -208,6 +209,16 @@ nsObserverService::RegisterReporter()
   RegisterWeakMemoryReporter(this);
 }
 
+static PLDHashOperator
+ClearObserverEntry(const nsACString& aKey, nsObserverList* aObserverList,
+                   void* aClosure)
+{
+  if (aObserverList) {
+    aObserverList->Clear();
+  }
+  return PL_DHASH_NEXT;
+}
+
 void
 nsObserverService::Shutdown()
 {
@@ -215,6 +226,10 @@ nsObserverService::Shutdown()
 
   mShuttingDown = true;
 
+  // Drop the observers explicitly: interned lists that C++ callers still
+  // hold a reference to must not keep notifying after shutdown.
+  mObserverTopicTable.EnumerateRead(ClearObserverEntry, nullptr);
+  mGlobalObservers = nullptr;
   mObserverTopicTable.Clear();
 }
 
@@ -266,7 +281,7 @@ nsObserverService::AddObserver(nsIObserver* aObserver, const char* aTopic,
     return NS_ERROR_NOT_IMPLEMENTED;
   }
 
-  nsObserverList* observerList = mObserverTopicTable.PutEntry(aTopic);
+  nsRefPtr<nsObserverList> observerList = InternTopic(aTopic);
   if (!observerList) {
     return NS_ERROR_OUT_OF_MEMORY;
   }
@@ -274,6 +289,29 @@ nsObserverService::AddObserver(nsIObserver* aObserver, const char* aTopic,
   return observerList->AddObserver(aObserver, aOwnsWeak);
 }
 
+already_AddRefed<nsObserverList>
+nsObserverService::InternTopic(const char* aTopic)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (mShuttingDown || NS_WARN_IF(!aTopic)) {
+    return nullptr;
+  }
+
+  nsDependentCString topic(aTopic);
+  nsRefPtr<nsObserverList> observerList = mObserverTopicTable.GetWeak(topic);
+  if (!observerList) {
+    observerList = new nsObserverList(aTopic);
+    mObserverTopicTable.Put(topic, observerList);
+
+    if (topic.EqualsLiteral("*")) {
+      mGlobalObservers = observerList;
+    }
+  }
+
+  return observerList.forget();
+}
+
 NS_IMETHODIMP
 nsObserverService::RemoveObserver(nsIObserver* aObserver, const char* aTopic)
 {
@@ -284,7 +322,8 @@ nsObserverService::RemoveObserver(nsIObserver* aObserver, const char* aTopic)
     return NS_ERROR_INVALID_ARG;
   }
 
-  nsObserverList* observerList = mObserverTopicTable.GetEntry(aTopic);
+  nsObserverList* observerList =
+    mObserverTopicTable.GetWeak(nsDependentCString(aTopic));
   if (!observerList) {
     return NS_ERROR_FAILURE;
   }
@@ -304,7 +343,8 @@ nsObserverService::EnumerateObservers(const char* aTopic,
     return NS_ERROR_INVALID_ARG;
   }
 
-  nsObserverList* observerList = mObserverTopicTable.GetEntry(aTopic);
+  nsObserverList* observerList =
+    mObserverTopicTable.GetWeak(nsDependentCString(aTopic));
   if (!observerList) {
     return NS_NewEmptyEnumerator(anEnumerator);
   }
@@ -324,15 +364,41 @@ NS_IMETHODIMP nsObserverService::NotifyObservers(nsISupports* aSubject,
     return NS_ERROR_INVALID_ARG;
   }
 
-  nsObserverList* observerList = mObserverTopicTable.GetEntry(aTopic);
+  nsObserverList* observerList =
+    mObserverTopicTable.GetWeak(nsDependentCString(aTopic));
   if (observerList) {
     observerList->NotifyObservers(aSubject, aTopic, aSomeData);
   }
 
 #ifdef NOTIFY_GLOBAL_OBSERVERS
-  observerList = mObserverTopicTable.GetEntry("*");
-  if (observerList) {
-    observerList->NotifyObservers(aSubject, aTopic, aSomeData);
+  if (mGlobalObservers) {
+    mGlobalObservers->NotifyObservers(aSubject, aTopic, aSomeData);
+  }
+#endif
+
+  return NS_OK;
+}
+
+// C++-only variant of the above for topics interned with InternTopic.
+// Saves the hashtable lookups on hot notification paths.
+nsresult
+nsObserverService::NotifyObservers(nsObserverList* aTopicList,
+                                   nsISupports* aSubject,
+                                   const char16_t* aSomeData)
+{
+  NS_ENSURE_VALIDCALL
+  if (NS_WARN_IF(!aTopicList)) {
+    return NS_ERROR_INVALID_ARG;
+  }
+
+  LOG(("nsObserverService::NotifyObservers(%s)", aTopicList->Topic().get()));
+
+  aTopicList->NotifyObservers(aSubject, aTopicList->Topic().get(), aSomeData);
+
+#ifdef NOTIFY_GLOBAL_OBSERVERS
+  if (mGlobalObservers && mGlobalObservers != aTopicList) {
+    mGlobalObservers->NotifyObservers(aSubject, aTopicList->Topic().get(),
+                                      aSomeData);
   }
 #endif
 
@@ -340,7 +406,8 @@ NS_IMETHODIMP nsObserverService::NotifyObservers(nsISupports* aSubject,
 }
 
 static PLDHashOperator
-UnmarkGrayObserverEntry(nsObserverList* aObserverList, void* aClosure)
+UnmarkGrayObserverEntry(const nsACString& aKey, nsObserverList* aObserverList,
+                        void* aClosure)
 {
   if (aObserverList) {
     aObserverList->UnmarkGrayStrongObservers();
@@ -353,7 +420,7 @@ nsObserverService::UnmarkGrayStrongObservers()
 {
   NS_ENSURE_VALIDCALL
 
-  mObserverTopicTable.EnumerateEntries(UnmarkGrayObserverEntry, nullptr);
+  mObserverTopicTable.EnumerateRead(UnmarkGrayObserverEntry, nullptr);
 
   return NS_OK;
 }
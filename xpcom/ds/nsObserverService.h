@@ -9,7 +9,7 @@
 #include "nsIObserverService.h"
 #include "nsObserverList.h"
 #include "nsIMemoryReporter.h"
-#include "nsTHashtable.h"
+#include "nsRefPtrHashtable.h"
 #include "mozilla/Attributes.h"
 
 // {D07F5195-E3D1-11d2-8ACD-00105A1B8860}
@@ -40,15 +40,37 @@ public:
   // collector will not traverse them.
   NS_IMETHOD UnmarkGrayStrongObservers();
 
+  /**
+   * Returns the interned observer list for aTopic, creating it if needed.
+   * C++ callers on hot notification paths (e.g. per HTTP transaction) can
+   * hold on to the returned list and register or notify through it, which
+   * skips the per-call topic lookup and lets the list reuse a pre-resolved
+   * snapshot of its observers across notifications; see nsObserverList.
+   * Notify interned topics through the NotifyObservers overload below so
+   * that "*" (global) observers are not skipped.
+   *
+   * Returns null during shutdown.
+   */
+  already_AddRefed<nsObserverList> InternTopic(const char* aTopic);
+
+  // C++-only variant of NotifyObservers for interned topics.
+  nsresult NotifyObservers(nsObserverList* aTopicList, nsISupports* aSubject,
+                           const char16_t* aSomeData);
+
 private:
   ~nsObserverService(void);
   void RegisterReporter();
 
   static const size_t kSuspectReferentCount = 100;
-  static PLDHashOperator CountReferents(nsObserverList* aObserverList,
+  static PLDHashOperator CountReferents(const nsACString& aKey,
+                                        nsObserverList* aObserverList,
                                         void* aClosure);
   bool mShuttingDown;
-  nsTHashtable<nsObserverList> mObserverTopicTable;
+  nsRefPtrHashtable<nsCStringHashKey, nsObserverList> mObserverTopicTable;
+
+  // The list interned for the "*" topic, which receives every notification.
+  // Cached here so the notification paths don't look it up on every call.
+  nsRefPtr<nsObserverList> mGlobalObservers;
 };
 
 NS_DEFINE_STATIC_IID_ACCESSOR(nsObserverService, NS_OBSERVERSERVICE_CID)
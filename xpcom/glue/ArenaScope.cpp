@@ -2,7 +2,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
-#include "StackArena.h"
+#include "mozilla/ArenaScope.h"
 #include "nsAlgorithm.h"
 #include "nsDebug.h"
 
@@ -36,7 +36,7 @@ struct StackMark {
   size_t mPos;
 };
 
-StackArena* AutoStackArena::gStackArena;
+StackArena* ArenaScope::gStackArena;
 
 StackArena::StackArena()
 {
@@ -49,6 +49,7 @@ StackArena::StackArena()
 
   mStackTop = 0;
   mPos = 0;
+  mTotalAllocated = 0;
 }
 
 StackArena::~StackArena()
@@ -120,6 +121,7 @@ StackArena::Allocate(size_t aSize)
 
   // Align to a multiple of 8.
   aSize = NS_ROUNDUP<size_t>(aSize, 8);
+  mTotalAllocated += aSize;
 
   // On stack overflow, grab another block.
   if (mPos + aSize >= StackBlock::MAX_USABLE_SIZE) {
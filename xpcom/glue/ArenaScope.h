@@ -2,8 +2,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
-#ifndef StackArena_h
-#define StackArena_h
+#ifndef mozilla_ArenaScope_h
+#define mozilla_ArenaScope_h
 
 #include "nsError.h"
 #include "mozilla/Assertions.h"
@@ -14,12 +14,12 @@ namespace mozilla {
 
 struct StackBlock;
 struct StackMark;
-class AutoStackArena;
+class ArenaScope;
 
-// Private helper class for AutoStackArena.
+// Private helper class for ArenaScope.
 class StackArena {
 private:
-  friend class AutoStackArena;
+  friend class ArenaScope;
   StackArena();
   ~StackArena();
 
@@ -30,6 +30,8 @@ private:
   void Push();
   void Pop();
 
+  size_t TotalAllocated() const { return mTotalAllocated; }
+
   size_t SizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf) const;
 
   // Our current position in memory.
@@ -50,22 +52,33 @@ private:
 
   // The size of the mark array.
   uint32_t mMarkLength;
+
+  // Total bytes handed out since this arena was created, including
+  // alignment padding.  Scopes snapshot this to report per-scope usage.
+  size_t mTotalAllocated;
 };
 
-// Class for stack scoped arena memory allocations.
+// Class for scoped arena memory allocations.
+//
+// Callers who wish to allocate transient memory whose lifetime
+// corresponds to the lifetime of a stack-allocated object can use this
+// class.  First, declare an ArenaScope object on the stack.  Then all
+// subsequent calls to Allocate will bump-allocate memory from an arena
+// pool that is freed wholesale when that variable goes out of scope.
+// Nesting is allowed; nested scopes reuse the outermost scope's blocks
+// instead of creating an arena of their own, so a broad scope (say,
+// around a whole reflow) makes the scopes inside it nearly free.
 //
-// Callers who wish to allocate memory whose lifetime corresponds to the
-// lifetime of a stack-allocated object can use this class.  First,
-// declare an AutoStackArena object on the stack.  Then all subsequent
-// calls to Allocate will allocate memory from an arena pool that will
-// be freed when that variable goes out of scope.  Nesting is allowed.
+// BytesAllocated() reports how much the arena handed out while this
+// scope was on the stack, including allocations made by nested scopes.
 //
+// This is not thread-safe; all scopes share one arena per process.
 // Individual allocations cannot exceed StackBlock::MAX_USABLE_SIZE
 // bytes.
 //
-class MOZ_STACK_CLASS AutoStackArena {
+class MOZ_STACK_CLASS ArenaScope {
 public:
-  AutoStackArena()
+  ArenaScope()
     : mOwnsStackArena(false)
   {
     if (!gStackArena) {
@@ -74,9 +87,10 @@ public:
       gStackArena->Init();
     }
     gStackArena->Push();
+    mBytesOnEntry = gStackArena->TotalAllocated();
   }
 
-  ~AutoStackArena() {
+  ~ArenaScope() {
     gStackArena->Pop();
     if (mOwnsStackArena) {
       delete gStackArena;
@@ -88,11 +102,18 @@ public:
     return gStackArena->Allocate(aSize);
   }
 
+  // Bytes handed out from the arena since this scope was entered,
+  // including alignment padding and any nested scopes' allocations.
+  size_t BytesAllocated() const {
+    return gStackArena->TotalAllocated() - mBytesOnEntry;
+  }
+
 private:
   static StackArena* gStackArena;
+  size_t mBytesOnEntry;
   bool mOwnsStackArena;
 };
 
 } // namespace mozilla
 
-#endif
+#endif // mozilla_ArenaScope_h
@@ -1360,6 +1360,25 @@ public:
   // @return A pointer to the newly appended element, or null on OOM.
   elem_type* AppendElement() { return AppendElements(1); }
 
+  // Append new elements without constructing them at all, leaving the new
+  // slots with whatever garbage the allocator handed back.  The caller is
+  // expected to overwrite every new element before reading it.  Only
+  // permitted for POD element types, which is also why no destructor
+  // bookkeeping is needed.
+  // @return A pointer to the newly appended elements, or null on OOM.
+  elem_type* AppendElementsUninitialized(size_type aCount)
+  {
+    static_assert(mozilla::IsPod<elem_type>::value,
+                  "only POD elements may be left uninitialized");
+    if (!Alloc::Successful(this->EnsureCapacity(Length() + aCount,
+                                                sizeof(elem_type)))) {
+      return nullptr;
+    }
+    index_type len = Length();
+    this->IncrementLength(aCount);
+    return Elements() + len;
+  }
+
   // Move all elements from another array to the end of this array without
   // calling copy constructors or destructors.
   // @return A pointer to the newly appended elements, or null on OOM.
@@ -1385,6 +1404,26 @@ public:
     return MoveElementsFrom<Item, Allocator>(aArray);
   }
 
+  // A variation on MoveElementsFrom for a source array of the very same
+  // element type: when this array is empty, the source's buffer is stolen
+  // outright instead of copying its elements.  Preferred by overload
+  // resolution whenever it applies.
+  template<class Allocator>
+  elem_type* MoveElementsFrom(nsTArray_Impl<E, Allocator>& aArray)
+  {
+    MOZ_ASSERT(&aArray != this, "argument must be different aArray");
+    if (Length() == 0) {
+      // SwapArrayElements copes with auto-array buffers on either side.
+      if (!Alloc::Successful(this->SwapArrayElements(aArray,
+                                                     sizeof(elem_type),
+                                                     MOZ_ALIGNOF(elem_type)))) {
+        return nullptr;
+      }
+      return Elements();
+    }
+    return MoveElementsFrom<E, Allocator>(aArray);
+  }
+
   // This method removes a range of elements from this array.
   // @param aStart The starting index of the elements to remove.
   // @param aCount The number of elements to remove.
@@ -1498,6 +1537,25 @@ public:
     return Alloc::ConvertBoolToResultType(true);
   }
 
+  // Like SetLength, but any new elements are left entirely unconstructed;
+  // the caller is expected to overwrite them before reading them.  Only
+  // permitted for POD element types.  This is the right call for sample
+  // and pixel buffers that are filled in immediately afterwards, where
+  // even the no-op default-construction loop of SetLength gets in the way.
+  // @param aNewLen The desired length of this array.
+  // @return True if the operation succeeded; false otherwise.
+  typename Alloc::ResultType SetLengthUninitialized(size_type aNewLen)
+  {
+    size_type oldLen = Length();
+    if (aNewLen > oldLen) {
+      return Alloc::ConvertBoolToResultType(
+        AppendElementsUninitialized(aNewLen - oldLen) != nullptr);
+    }
+
+    TruncateLength(aNewLen);
+    return Alloc::ConvertBoolToResultType(true);
+  }
+
   // This method modifies the length of the array, but may only be
   // called when the new length is shorter than the old.  It can
   // therefore be called when elem_type has no default constructor,
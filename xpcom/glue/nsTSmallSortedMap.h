@@ -0,0 +1,171 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef NS_TSMALL_SORTED_MAP_H_
+#define NS_TSMALL_SORTED_MAP_H_
+
+#include "mozilla/Attributes.h"
+#include "mozilla/MemoryReporting.h"
+#include "mozilla/TypeTraits.h"
+#include "nsTArray.h"
+
+/**
+ * A flat map backed by a sorted nsTArray of key/value entries.
+ *
+ * Lookups are O(log n) binary searches and insertions are O(n), but all of
+ * the entries live in one contiguous allocation, so for maps holding up to a
+ * few dozen entries this is both smaller and faster in practice than
+ * nsTHashtable, which pays a heap allocation for its entry store and a hash
+ * per operation.  Use a hashtable instead when maps routinely grow beyond
+ * that, or when entries cannot be memmoved.
+ *
+ * KeyType must support operator== and operator< and be cheap to copy.  If
+ * InlineEntries is nonzero, that many entries are stored in the map object
+ * itself before anything is heap-allocated; such a map cannot itself be
+ * memmoved, just like nsAutoTArray.
+ *
+ * Pointers returned by Lookup() are invalidated by any Put(), Remove() or
+ * Clear() call.
+ */
+template<class KeyType, class DataType, uint32_t InlineEntries = 0>
+class nsTSmallSortedMap
+{
+public:
+  struct Entry
+  {
+    KeyType mKey;
+    DataType mData;
+  };
+
+  nsTSmallSortedMap() {}
+
+  /**
+   * @return The number of entries in the map.
+   */
+  uint32_t Count() const { return mEntries.Length(); }
+
+  /**
+   * Looks up the entry for aKey.
+   * @return A pointer to the stored value, or null if aKey is not present.
+   * The pointer is only valid until the map is next mutated.
+   */
+  DataType* Lookup(const KeyType& aKey)
+  {
+    size_t index = mEntries.BinaryIndexOf(aKey, EntryComparator());
+    return index != mEntries.NoIndex ? &mEntries[index].mData : nullptr;
+  }
+
+  const DataType* Lookup(const KeyType& aKey) const
+  {
+    return const_cast<nsTSmallSortedMap*>(this)->Lookup(aKey);
+  }
+
+  /**
+   * Retrieves the value for aKey.
+   * @param aData Out parameter receiving a copy of the value; may be null if
+   * the caller only cares whether the key is present.
+   * @return true if aKey was found.
+   */
+  bool Get(const KeyType& aKey, DataType* aData) const
+  {
+    const DataType* data = Lookup(aKey);
+    if (!data) {
+      return false;
+    }
+    if (aData) {
+      *aData = *data;
+    }
+    return true;
+  }
+
+  /**
+   * Adds aData under aKey, replacing any existing entry for aKey.
+   */
+  void Put(const KeyType& aKey, const DataType& aData)
+  {
+    size_t index = mEntries.IndexOfFirstElementGt(aKey, EntryComparator());
+    if (index > 0 && mEntries[index - 1].mKey == aKey) {
+      mEntries[index - 1].mData = aData;
+      return;
+    }
+    Entry entry = { aKey, aData };
+    mEntries.InsertElementAt(index, entry);
+  }
+
+  /**
+   * Removes the entry for aKey, preserving the order of the other entries.
+   * @param aOldData If non-null, receives the removed value.
+   * @return true if aKey was found and removed.
+   */
+  bool Remove(const KeyType& aKey, DataType* aOldData = nullptr)
+  {
+    size_t index = mEntries.BinaryIndexOf(aKey, EntryComparator());
+    if (index == mEntries.NoIndex) {
+      return false;
+    }
+    if (aOldData) {
+      *aOldData = mEntries[index].mData;
+    }
+    mEntries.RemoveElementAt(index);
+    return true;
+  }
+
+  /**
+   * Removes all entries from the map.
+   */
+  void Clear() { mEntries.Clear(); }
+
+  /**
+   * Preallocates room for aCapacity entries.
+   */
+  void SetCapacity(uint32_t aCapacity) { mEntries.SetCapacity(aCapacity); }
+
+  /**
+   * Index access to the entries, in increasing key order.  Useful for
+   * enumeration; indices are invalidated by mutation just like Lookup()
+   * pointers.
+   */
+  const KeyType& KeyAt(uint32_t aIndex) const { return mEntries[aIndex].mKey; }
+
+  DataType& DataAt(uint32_t aIndex) { return mEntries[aIndex].mData; }
+
+  const DataType& DataAt(uint32_t aIndex) const
+  {
+    return mEntries[aIndex].mData;
+  }
+
+  size_t SizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf) const
+  {
+    return mEntries.SizeOfExcludingThis(aMallocSizeOf);
+  }
+
+private:
+  class EntryComparator
+  {
+  public:
+    bool Equals(const Entry& aEntry, const KeyType& aKey) const
+    {
+      return aEntry.mKey == aKey;
+    }
+    bool LessThan(const Entry& aEntry, const KeyType& aKey) const
+    {
+      return aEntry.mKey < aKey;
+    }
+  };
+
+  typedef typename mozilla::Conditional<InlineEntries == 0,
+                                        nsTArray<Entry>,
+                                        nsAutoTArray<Entry, InlineEntries>
+                                        >::Type EntryArray;
+
+  // Kept sorted by key so lookups can binary-search.
+  EntryArray mEntries;
+
+  nsTSmallSortedMap(const nsTSmallSortedMap&) MOZ_DELETE;
+  nsTSmallSortedMap& operator=(const nsTSmallSortedMap&) MOZ_DELETE;
+};
+
+#endif // NS_TSMALL_SORTED_MAP_H_
@@ -271,11 +271,13 @@ PLDHashTable::Init(const PLDHashTableOps* aOps, void* aData,
     return false;  // overflowed
   }
 
-  mEntryStore = (char*)aOps->allocTable(this, nbytes);
-  if (!mEntryStore) {
-    return false;
-  }
-  memset(mEntryStore, 0, nbytes);
+  /*
+   * Defer the entry storage allocation until the first add.  Thousands of
+   * small tables (observer lists, attribute maps, ...) are initialized and
+   * then never see an entry, and the malloc here used to show up in
+   * page-load profiles.
+   */
+  mEntryStore = nullptr;
   METER(memset(&mStats, 0, sizeof(mStats)));
 
 #ifdef DEBUG
@@ -310,6 +312,29 @@ PL_DHashTableInit(PLDHashTable* aTable, const PLDHashTableOps* aOps,
   }
 }
 
+/*
+ * Allocate and zero the entry storage.  Init defers this to the first
+ * PL_DHASH_ADD so that tables which never receive an entry never pay for
+ * the allocation.
+ */
+bool
+PLDHashTable::AllocEntryStorage()
+{
+  MOZ_ASSERT(!mEntryStore);
+
+  uint32_t nbytes;
+  if (!SizeOfEntryStore(Capacity(), mEntrySize, &nbytes)) {
+    return false;  // overflowed
+  }
+
+  mEntryStore = (char*)ops->allocTable(this, nbytes);
+  if (!mEntryStore) {
+    return false;
+  }
+  memset(mEntryStore, 0, nbytes);
+  return true;
+}
+
 /*
  * Double hashing needs the second hash code to be relatively prime to table
  * size, so we simply make hash2 odd.
@@ -349,22 +374,26 @@ PLDHashTable::Finish()
   ops->finalize(this);
 
   /* Clear any remaining live entries. */
-  char* entryAddr = mEntryStore;
-  char* entryLimit = entryAddr + Capacity() * mEntrySize;
-  while (entryAddr < entryLimit) {
-    PLDHashEntryHdr* entry = (PLDHashEntryHdr*)entryAddr;
-    if (ENTRY_IS_LIVE(entry)) {
-      METER(mStats.mRemoveEnums++);
-      ops->clearEntry(this, entry);
+  if (mEntryStore) {
+    char* entryAddr = mEntryStore;
+    char* entryLimit = entryAddr + Capacity() * mEntrySize;
+    while (entryAddr < entryLimit) {
+      PLDHashEntryHdr* entry = (PLDHashEntryHdr*)entryAddr;
+      if (ENTRY_IS_LIVE(entry)) {
+        METER(mStats.mRemoveEnums++);
+        ops->clearEntry(this, entry);
+      }
+      entryAddr += mEntrySize;
     }
-    entryAddr += mEntrySize;
   }
 
   DECREMENT_RECURSION_LEVEL(this);
   MOZ_ASSERT(RECURSION_LEVEL_SAFE_TO_FINISH(this));
 
   /* Free entry storage last. */
-  ops->freeTable(this, mEntryStore);
+  if (mEntryStore) {
+    ops->freeTable(this, mEntryStore);
+  }
 }
 
 void
@@ -550,6 +579,14 @@ PLDHashTable::ChangeTable(int aDeltaLog2)
   return true;
 }
 
+/*
+ * A table whose entry storage hasn't been allocated yet has no entries, so
+ * lookups on it return this permanently-free entry rather than forcing the
+ * storage into existence.  Nobody may write to it; per the PL_DHASH_LOOKUP
+ * contract a free entry may only be tested with PL_DHASH_ENTRY_IS_FREE.
+ */
+static PLDHashEntryHdr sNoStorageFreeEntry = { 0 };
+
 MOZ_ALWAYS_INLINE PLDHashEntryHdr*
 PLDHashTable::Operate(const void* aKey, PLDHashOperator aOp)
 {
@@ -568,10 +605,21 @@ PLDHashTable::Operate(const void* aKey, PLDHashOperator aOp)
   switch (aOp) {
     case PL_DHASH_LOOKUP:
       METER(mStats.mLookups++);
+      if (!mEntryStore) {
+        METER(mStats.mMisses++);
+        entry = &sNoStorageFreeEntry;
+        break;
+      }
       entry = SearchTable(aKey, keyHash, aOp);
       break;
 
     case PL_DHASH_ADD: {
+      if (!mEntryStore && !AllocEntryStorage()) {
+        METER(mStats.mAddFailures++);
+        entry = nullptr;
+        break;
+      }
+
       /*
        * If alpha is >= .75, grow or compress the table.  If aKey is already
        * in the table, we may grow once more than necessary, but only if we
@@ -631,6 +679,11 @@ PLDHashTable::Operate(const void* aKey, PLDHashOperator aOp)
     }
 
     case PL_DHASH_REMOVE:
+      if (!mEntryStore) {
+        METER(mStats.mRemoveMisses++);
+        entry = nullptr;
+        break;
+      }
       entry = SearchTable(aKey, keyHash, aOp);
       if (ENTRY_IS_LIVE(entry)) {
         /* Clear this entry and mark it as "removed". */
@@ -698,6 +751,11 @@ PLDHashTable::Enumerate(PLDHashEnumerator aEtor, void* aArg)
 {
   INCREMENT_RECURSION_LEVEL(this);
 
+  if (!mEntryStore) {
+    DECREMENT_RECURSION_LEVEL(this);
+    return 0;
+  }
+
   // Please keep this method in sync with the PLDHashTable::Iterator constructor
   // and ::NextEntry methods below in this file.
   char* entryAddr = mEntryStore;
@@ -797,7 +855,9 @@ PLDHashTable::SizeOfExcludingThis(
     MallocSizeOf aMallocSizeOf, void* aArg /* = nullptr */) const
 {
   size_t n = 0;
-  n += aMallocSizeOf(mEntryStore);
+  if (mEntryStore) {
+    n += aMallocSizeOf(mEntryStore);
+  }
   if (aSizeOfEntryExcludingThis) {
     SizeOfEntryExcludingThisArg arg2 = {
       0, aSizeOfEntryExcludingThis, aMallocSizeOf, aArg
@@ -855,7 +915,10 @@ PLDHashTable::Iterator::Iterator(const PLDHashTable* aTable)
   uint32_t tableSize = capacity * mTable->EntrySize();
   char* entryLimit = mEntryAddr + tableSize;
 
-  if (ChaosMode::isActive(ChaosMode::HashTableIteration)) {
+  // A table with unallocated entry storage has no entries to return;
+  // HasMoreEntries ensures we never walk off mEntryAddr == nullptr.
+  if (mTable->mEntryStore &&
+      ChaosMode::isActive(ChaosMode::HashTableIteration)) {
     // Start iterating at a random point in the hashtable. It would be
     // even more chaotic to iterate in fully random order, but that's a lot
     // more work.
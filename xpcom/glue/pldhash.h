@@ -199,7 +199,9 @@ private:
   uint32_t            mEntryCount;    /* number of entries in table */
   uint32_t            mRemovedCount;  /* removed entry sentinels in table */
   uint32_t            mGeneration;    /* entry storage generation number */
-  char*               mEntryStore;    /* entry storage */
+  char*               mEntryStore;    /* entry storage; allocated lazily on
+                                         the first add, so null for tables
+                                         that have never had an entry */
 
 #ifdef PL_DHASHMETER
   struct PLDHashStats
@@ -299,6 +301,8 @@ private:
 
   PLDHashEntryHdr* PL_DHASH_FASTCALL FindFreeEntry(PLDHashNumber aKeyHash);
 
+  bool AllocEntryStorage();
+
   bool ChangeTable(int aDeltaLog2);
 };
 
@@ -469,8 +473,10 @@ void PL_DHashTableDestroy(PLDHashTable* aTable);
  * without rehashing. If |aLength| is a power-of-two, this capacity will be
  * |2*length|.
  *
- * This function will crash if it can't allocate enough memory, or if
- * |aEntrySize| and/or |aLength| are too large.
+ * The entry storage itself is allocated lazily, when the first entry is
+ * added, so tables that never receive an entry never allocate.
+ *
+ * This function will crash if |aEntrySize| and/or |aLength| are too large.
  */
 void PL_DHashTableInit(
   PLDHashTable* aTable, const PLDHashTableOps* aOps, void* aData,
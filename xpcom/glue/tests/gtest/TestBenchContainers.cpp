@@ -0,0 +1,90 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/* Micro-benchmarks for the hot container primitives: nsTArray growth and
+ * PLDHashTable probing.  These guard against regressions in the growth
+ * policy and hashing/probing code; they assert only sanity, the numbers
+ * come out through the MOZ_GTEST_BENCH_JSON lines. */
+
+#include "gtest/MozGTestBench.h"
+#include "nsTArray.h"
+#include "pldhash.h"
+
+namespace TestBenchContainers {
+
+static const uint32_t kArrayElements = 100000;
+static const uint32_t kHashEntries = 10000;
+static const uint32_t kHashLookupRounds = 20;
+
+// Spread sequential indices over the key space; the stub ops hash the
+// pointer value, so sequential void* keys would probe unrealistically well.
+static const void*
+KeyFor(uint32_t aIndex)
+{
+  return reinterpret_cast<const void*>(
+    static_cast<uintptr_t>((aIndex + 1) * 0x9E3779B9U));
+}
+
+MOZ_GTEST_BENCH(XPCOMBench, TArrayGrowth, []() {
+  nsTArray<uint32_t> array;
+  for (uint32_t i = 0; i < kArrayElements; ++i) {
+    array.AppendElement(i);
+  }
+  ASSERT_EQ(kArrayElements, array.Length());
+});
+
+MOZ_GTEST_BENCH(XPCOMBench, TArrayGrowthPresized, []() {
+  nsTArray<uint32_t> array;
+  array.SetCapacity(kArrayElements);
+  for (uint32_t i = 0; i < kArrayElements; ++i) {
+    array.AppendElement(i);
+  }
+  ASSERT_EQ(kArrayElements, array.Length());
+});
+
+MOZ_GTEST_BENCH(XPCOMBench, PLDHashAddRemove, []() {
+  PLDHashTable table;
+  PL_DHashTableInit(&table, PL_DHashGetStubOps(), nullptr,
+                    sizeof(PLDHashEntryStub));
+  for (uint32_t i = 0; i < kHashEntries; ++i) {
+    PLDHashEntryHdr* entry =
+      PL_DHashTableOperate(&table, KeyFor(i), PL_DHASH_ADD);
+    ASSERT_TRUE(!!entry);
+    static_cast<PLDHashEntryStub*>(entry)->key = KeyFor(i);
+  }
+  for (uint32_t i = 0; i < kHashEntries; ++i) {
+    PL_DHashTableOperate(&table, KeyFor(i), PL_DHASH_REMOVE);
+  }
+  ASSERT_EQ(0u, table.EntryCount());
+  PL_DHashTableFinish(&table);
+});
+
+MOZ_GTEST_BENCH(XPCOMBench, PLDHashProbing, []() {
+  PLDHashTable table;
+  PL_DHashTableInit(&table, PL_DHashGetStubOps(), nullptr,
+                    sizeof(PLDHashEntryStub));
+  for (uint32_t i = 0; i < kHashEntries; ++i) {
+    PLDHashEntryHdr* entry =
+      PL_DHashTableOperate(&table, KeyFor(i), PL_DHASH_ADD);
+    ASSERT_TRUE(!!entry);
+    static_cast<PLDHashEntryStub*>(entry)->key = KeyFor(i);
+  }
+
+  // Alternate hits and misses so both probe paths get measured.
+  uint32_t hits = 0;
+  for (uint32_t round = 0; round < kHashLookupRounds; ++round) {
+    for (uint32_t i = 0; i < 2 * kHashEntries; ++i) {
+      PLDHashEntryHdr* entry =
+        PL_DHashTableOperate(&table, KeyFor(i), PL_DHASH_LOOKUP);
+      if (PL_DHASH_ENTRY_IS_BUSY(entry)) {
+        ++hits;
+      }
+    }
+  }
+  ASSERT_EQ(kHashLookupRounds * kHashEntries, hits);
+  PL_DHashTableFinish(&table);
+});
+
+} // namespace TestBenchContainers
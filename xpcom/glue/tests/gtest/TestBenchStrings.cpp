@@ -0,0 +1,84 @@
+/* vim:set ts=2 sw=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/* Micro-benchmarks for the hot string conversion primitives.  The ASCII
+ * cases cover the fast paths, the mixed cases the real converter loops;
+ * numbers come out through the MOZ_GTEST_BENCH_JSON lines. */
+
+#include "nsString.h"
+#include "nsReadableUtils.h"
+#include "gtest/MozGTestBench.h"
+
+namespace TestBenchStrings {
+
+static const uint32_t kConversionRounds = 2000;
+
+static nsCString
+BuildAsciiInput()
+{
+  nsCString input;
+  for (uint32_t i = 0; i < 16; ++i) {
+    input.AppendLiteral("The quick brown fox jumps over the lazy dog. ");
+  }
+  return input;
+}
+
+static nsCString
+BuildMixedInput()
+{
+  nsCString input;
+  for (uint32_t i = 0; i < 16; ++i) {
+    // ASCII runs interleaved with two- and three-byte sequences, like
+    // typical non-English page text.
+    input.AppendLiteral("D\xC5\x99\xC3\xADve n\xC4\x9Bkde d\xC3\xA1vno "
+                        "\xE2\x80\x9Equick\xE2\x80\x9C brown fox. ");
+  }
+  return input;
+}
+
+MOZ_GTEST_BENCH(XPCOMBench, Utf8ToUtf16Ascii, []() {
+  nsCString input = BuildAsciiInput();
+  uint32_t length = 0;
+  for (uint32_t i = 0; i < kConversionRounds; ++i) {
+    NS_ConvertUTF8toUTF16 wide(input);
+    length += wide.Length();
+  }
+  ASSERT_EQ(kConversionRounds * input.Length(), length);
+});
+
+MOZ_GTEST_BENCH(XPCOMBench, Utf8ToUtf16Mixed, []() {
+  nsCString input = BuildMixedInput();
+  uint32_t length = 0;
+  for (uint32_t i = 0; i < kConversionRounds; ++i) {
+    NS_ConvertUTF8toUTF16 wide(input);
+    length += wide.Length();
+  }
+  ASSERT_TRUE(length > 0);
+});
+
+MOZ_GTEST_BENCH(XPCOMBench, Utf16ToUtf8Mixed, []() {
+  NS_ConvertUTF8toUTF16 input(BuildMixedInput());
+  uint32_t length = 0;
+  for (uint32_t i = 0; i < kConversionRounds; ++i) {
+    NS_ConvertUTF16toUTF8 narrow(input);
+    length += narrow.Length();
+  }
+  ASSERT_TRUE(length > 0);
+});
+
+MOZ_GTEST_BENCH(XPCOMBench, AppendIntRoundTrip, []() {
+  nsAutoCString scratch;
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < kConversionRounds * 10; ++i) {
+    scratch.Truncate();
+    scratch.AppendInt(i * 7);
+    nsresult rv;
+    sum += scratch.ToInteger(&rv);
+    ASSERT_TRUE(NS_SUCCEEDED(rv));
+  }
+  ASSERT_TRUE(sum > 0);
+});
+
+} // namespace TestBenchStrings
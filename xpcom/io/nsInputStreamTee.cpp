@@ -47,10 +47,14 @@ public:
   nsInputStreamTee();
   bool SinkIsValid();
   void InvalidateSink();
+  void TakePendingData(char** aBuf, uint32_t* aCount);
 
 private:
   ~nsInputStreamTee()
   {
+    if (mPendingBuf) {
+      free(mPendingBuf);
+    }
   }
 
   nsresult TeeSegment(const char* aBuf, uint32_t aCount);
@@ -64,23 +68,21 @@ private:
   nsCOMPtr<nsIEventTarget>  mEventTarget;
   nsWriteSegmentFun         mWriter;  // for implementing ReadSegments
   void*                     mClosure; // for implementing ReadSegments
-  nsAutoPtr<Mutex>          mLock; // synchronize access to mSinkIsValid
+  nsAutoPtr<Mutex>          mLock; // synchronize access to the members below
   bool                      mSinkIsValid; // False if TeeWriteEvent fails
+  // Data teed off while a write event is in flight, delivered to the
+  // sink in one batch when the event runs.  Guarded by mLock.
+  char*                     mPendingBuf;
+  uint32_t                  mPendingCount;
+  uint32_t                  mPendingCapacity;
+  bool                      mWriteEventPending;
 };
 
 class nsInputStreamTeeWriteEvent : public nsRunnable
 {
 public:
-  // aTee's lock is held across construction of this object
-  nsInputStreamTeeWriteEvent(const char* aBuf, uint32_t aCount,
-                             nsIOutputStream* aSink, nsInputStreamTee* aTee)
+  nsInputStreamTeeWriteEvent(nsIOutputStream* aSink, nsInputStreamTee* aTee)
   {
-    // copy the buffer - will be free'd by dtor
-    mBuf = (char*)malloc(aCount);
-    if (mBuf) {
-      memcpy(mBuf, (char*)aBuf, aCount);
-    }
-    mCount = aCount;
     mSink = aSink;
     bool isNonBlocking;
     mSink->IsNonBlocking(&isNonBlocking);
@@ -90,28 +92,33 @@ public:
 
   NS_IMETHOD Run()
   {
-    if (!mBuf) {
-      NS_WARNING("nsInputStreamTeeWriteEvent::Run() "
-                 "memory not allocated\n");
+    NS_ABORT_IF_FALSE(mSink, "mSink is null!");
+
+    // Take everything teed off since this event was dispatched, so that
+    // many small segments are delivered as one write.
+    char* buf;
+    uint32_t count;
+    mTee->TakePendingData(&buf, &count);
+    if (!buf) {
       return NS_OK;
     }
-    NS_ABORT_IF_FALSE(mSink, "mSink is null!");
 
     //  The output stream could have been invalidated between when
     //  this event was dispatched and now, so check before writing.
     if (!mTee->SinkIsValid()) {
+      free(buf);
       return NS_OK;
     }
 
     LOG(("nsInputStreamTeeWriteEvent::Run() [%p]"
          "will write %u bytes to %p\n",
-         this, mCount, mSink.get()));
+         this, count, mSink.get()));
 
     uint32_t totalBytesWritten = 0;
-    while (mCount) {
+    while (count) {
       nsresult rv;
       uint32_t bytesWritten = 0;
-      rv = mSink->Write(mBuf + totalBytesWritten, mCount, &bytesWritten);
+      rv = mSink->Write(buf + totalBytesWritten, count, &bytesWritten);
       if (NS_FAILED(rv)) {
         LOG(("nsInputStreamTeeWriteEvent::Run[%p] error %x in writing",
              this, rv));
@@ -119,24 +126,19 @@ public:
         break;
       }
       totalBytesWritten += bytesWritten;
-      NS_ASSERTION(bytesWritten <= mCount, "wrote too much");
-      mCount -= bytesWritten;
+      NS_ASSERTION(bytesWritten <= count, "wrote too much");
+      count -= bytesWritten;
     }
+    free(buf);
     return NS_OK;
   }
 
 protected:
   virtual ~nsInputStreamTeeWriteEvent()
   {
-    if (mBuf) {
-      free(mBuf);
-    }
-    mBuf = nullptr;
   }
 
 private:
-  char* mBuf;
-  uint32_t mCount;
   nsCOMPtr<nsIOutputStream> mSink;
   // back pointer to the tee that created this runnable
   nsRefPtr<nsInputStreamTee> mTee;
@@ -144,6 +146,10 @@ private:
 
 nsInputStreamTee::nsInputStreamTee(): mLock(nullptr)
   , mSinkIsValid(true)
+  , mPendingBuf(nullptr)
+  , mPendingCount(0)
+  , mPendingCapacity(0)
+  , mWriteEventPending(false)
 {
 }
 
@@ -161,6 +167,19 @@ nsInputStreamTee::InvalidateSink()
   mSinkIsValid = false;
 }
 
+void
+nsInputStreamTee::TakePendingData(char** aBuf, uint32_t* aCount)
+{
+  MutexAutoLock lock(*mLock);
+  *aBuf = mPendingBuf;
+  *aCount = mPendingCount;
+  mPendingBuf = nullptr;
+  mPendingCount = 0;
+  mPendingCapacity = 0;
+  // Segments teed off from here on need a new write event.
+  mWriteEventPending = false;
+}
+
 nsresult
 nsInputStreamTee::TeeSegment(const char* aBuf, uint32_t aCount)
 {
@@ -169,14 +188,41 @@ nsInputStreamTee::TeeSegment(const char* aBuf, uint32_t aCount)
   }
   if (mLock) { // asynchronous case
     NS_ASSERTION(mEventTarget, "mEventTarget is null, mLock is not null.");
-    if (!SinkIsValid()) {
+    MutexAutoLock lock(*mLock);
+    if (!mSinkIsValid) {
       return NS_OK; // nothing to do
     }
-    nsRefPtr<nsIRunnable> event =
-      new nsInputStreamTeeWriteEvent(aBuf, aCount, mSink, this);
+    // Coalesce with data that a previously dispatched write event hasn't
+    // picked up yet, so that a burst of small segments crosses to the
+    // sink's thread as a single dispatch and a single large write.
+    if (mPendingCount + aCount > mPendingCapacity) {
+      uint32_t newCapacity = mPendingCapacity ? mPendingCapacity * 2 : 4096;
+      if (newCapacity < mPendingCount + aCount) {
+        newCapacity = mPendingCount + aCount;
+      }
+      char* newBuf = (char*)realloc(mPendingBuf, newCapacity);
+      if (!newBuf) {
+        // Match the old behavior of a failed event buffer allocation:
+        // drop the data for the sink, but don't fail the read.
+        NS_WARNING("nsInputStreamTee::TeeSegment out of memory\n");
+        return NS_OK;
+      }
+      mPendingBuf = newBuf;
+      mPendingCapacity = newCapacity;
+    }
+    memcpy(mPendingBuf + mPendingCount, aBuf, aCount);
+    mPendingCount += aCount;
+    if (mWriteEventPending) {
+      return NS_OK;
+    }
+    nsRefPtr<nsIRunnable> event = new nsInputStreamTeeWriteEvent(mSink, this);
     LOG(("nsInputStreamTee::TeeSegment [%p] dispatching write %u bytes\n",
          this, aCount));
-    return mEventTarget->Dispatch(event, NS_DISPATCH_NORMAL);
+    nsresult rv = mEventTarget->Dispatch(event, NS_DISPATCH_NORMAL);
+    if (NS_SUCCEEDED(rv)) {
+      mWriteEventPending = true;
+    }
+    return rv;
   } else { // synchronous case
     NS_ASSERTION(!mEventTarget, "mEventTarget is not null, mLock is null.");
     nsresult rv;
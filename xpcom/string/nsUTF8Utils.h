@@ -270,6 +270,25 @@ public:
 };
 
 
+#if defined(MOZILLA_MAY_SUPPORT_SSE2) && defined(MOZILLA_INTERNAL_API)
+namespace mozilla {
+/**
+ * SSE2 helpers for the UTF-8 <-> UTF-16 converter sinks below.  Each one
+ * consumes the longest leading all-ASCII run of its input, one 16-byte
+ * vector per iteration, and returns the number of code units consumed.
+ * On return, either the next unit is non-ASCII or less than a vector's
+ * worth of input remains, so the scalar loops can pick up cleanly.
+ */
+uint32_t UTF8ASCIIRunToUTF16_SSE2(const char* aSource, uint32_t aSourceLength,
+                                  char16_t* aDest);
+uint32_t UTF8ASCIIRunLength_SSE2(const char* aSource, uint32_t aSourceLength);
+uint32_t UTF16ASCIIRunToUTF8_SSE2(const char16_t* aSource,
+                                  uint32_t aSourceLength, char* aDest);
+uint32_t UTF16ASCIIRunLength_SSE2(const char16_t* aSource,
+                                  uint32_t aSourceLength);
+} // namespace mozilla
+#endif
+
 /**
  * A character sink (see |copy_string| in nsAlgorithm.h) for converting
  * UTF-8 to UTF-16
@@ -307,6 +326,18 @@ public:
     const value_type* end = aStart + aN;
     buffer_type* out = mBuffer;
     for (; p != end /* && *p */;) {
+#if defined(MOZILLA_MAY_SUPPORT_SSE2) && defined(MOZILLA_INTERNAL_API)
+      if (UTF8traits::isASCII(*p) && end - p > 15 &&
+          mozilla::supports_sse2()) {
+        uint32_t run =
+          mozilla::UTF8ASCIIRunToUTF16_SSE2(p, uint32_t(end - p), out);
+        p += run;
+        out += run;
+        if (p == end) {
+          break;
+        }
+      }
+#endif
       bool err;
       uint32_t ucs4 = UTF8CharEnumerator::NextChar(&p, end, &err);
 
@@ -369,6 +400,16 @@ public:
     const value_type* end = aStart + aN;
     for (; p < end /* && *p */; ++mLength) {
       if (UTF8traits::isASCII(*p)) {
+#if defined(MOZILLA_MAY_SUPPORT_SSE2) && defined(MOZILLA_INTERNAL_API)
+        if (end - p > 15 && mozilla::supports_sse2()) {
+          uint32_t run = mozilla::UTF8ASCIIRunLength_SSE2(p, uint32_t(end - p));
+          // run >= 1 since *p is ASCII; the loop's increment accounts for
+          // the last unit of the run.
+          p += run;
+          mLength += run - 1;
+          continue;
+        }
+#endif
         p += 1;
       } else if (UTF8traits::is2byte(*p)) {
         p += 2;
@@ -470,6 +511,17 @@ public:
     for (const value_type* p = aStart, *end = aStart + aN; p < end; ++p) {
       value_type c = *p;
       if (!(c & 0xFF80)) { // U+0000 - U+007F
+#if defined(MOZILLA_MAY_SUPPORT_SSE2) && defined(MOZILLA_INTERNAL_API)
+        if (end - p > 7 && mozilla::supports_sse2()) {
+          uint32_t run =
+            mozilla::UTF16ASCIIRunToUTF8_SSE2(p, uint32_t(end - p), out);
+          // run >= 1 since *p is ASCII; the loop's increment consumes the
+          // last unit of the run.
+          p += run - 1;
+          out += run;
+          continue;
+        }
+#endif
         *out++ = (char)c;
       } else if (!(c & 0xF800)) { // U+0100 - U+07FF
         *out++ = 0xC0 | (char)(c >> 6);
@@ -577,6 +629,15 @@ public:
     for (const value_type* p = aStart, *end = aStart + aN; p < end; ++p) {
       value_type c = *p;
       if (!(c & 0xFF80)) { // U+0000 - U+007F
+#if defined(MOZILLA_MAY_SUPPORT_SSE2) && defined(MOZILLA_INTERNAL_API)
+        if (end - p > 7 && mozilla::supports_sse2()) {
+          uint32_t run = mozilla::UTF16ASCIIRunLength_SSE2(p,
+                                                           uint32_t(end - p));
+          p += run - 1;
+          mSize += run;
+          continue;
+        }
+#endif
         mSize += 1;
       } else if (!(c & 0xF800)) { // U+0100 - U+07FF
         mSize += 2;
@@ -6,6 +6,7 @@
 
 #include "nscore.h"
 #include "nsAlgorithm.h"
+#include "mozilla/MathAlgorithms.h"
 #include <emmintrin.h>
 #include <nsUTF8Utils.h>
 
@@ -103,3 +104,115 @@ LossyConvertEncoding8to16::write_sse2(const char* aSource,
 
   mDestination += i;
 }
+
+namespace mozilla {
+
+uint32_t
+UTF8ASCIIRunToUTF16_SSE2(const char* aSource, uint32_t aSourceLength,
+                         char16_t* aDest)
+{
+  uint32_t i = 0;
+
+  // Walk 16 bytes at a time, widening them with zeroes as long as every
+  // byte in the chunk is ASCII.
+  for (; aSourceLength - i > 15; i += 16) {
+    __m128i source =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSource + i));
+
+    // The sign bit of a byte is set exactly when it's non-ASCII.
+    int mask = _mm_movemask_epi8(source);
+    if (mask) {
+      // Convert the ASCII prefix of this chunk, then stop at the first
+      // non-ASCII byte.
+      uint32_t prefix = CountTrailingZeroes32(mask);
+      for (uint32_t j = 0; j < prefix; ++j) {
+        aDest[i + j] = static_cast<unsigned char>(aSource[i + j]);
+      }
+      return i + prefix;
+    }
+
+    __m128i lo = _mm_unpacklo_epi8(source, _mm_setzero_si128());
+    __m128i hi = _mm_unpackhi_epi8(source, _mm_setzero_si128());
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(aDest + i),     lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(aDest + i + 8), hi);
+  }
+
+  return i;
+}
+
+uint32_t
+UTF8ASCIIRunLength_SSE2(const char* aSource, uint32_t aSourceLength)
+{
+  uint32_t i = 0;
+
+  for (; aSourceLength - i > 15; i += 16) {
+    __m128i source =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSource + i));
+
+    int mask = _mm_movemask_epi8(source);
+    if (mask) {
+      return i + CountTrailingZeroes32(mask);
+    }
+  }
+
+  return i;
+}
+
+uint32_t
+UTF16ASCIIRunToUTF8_SSE2(const char16_t* aSource, uint32_t aSourceLength,
+                         char* aDest)
+{
+  uint32_t i = 0;
+
+  // Walk 8 code units at a time, narrowing them as long as every unit in
+  // the chunk is ASCII (i.e. has no bits in 0xFF80 set).
+  __m128i highbits = _mm_set1_epi16(int16_t(0xFF80));
+  for (; aSourceLength - i > 7; i += 8) {
+    __m128i source =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSource + i));
+
+    // Each unit's two mask bits are set exactly when it's ASCII.
+    int mask =
+      _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(source, highbits),
+                                        _mm_setzero_si128()));
+    if (mask != 0xFFFF) {
+      // Convert the ASCII prefix of this chunk, then stop at the first
+      // non-ASCII unit.
+      uint32_t prefix = CountTrailingZeroes32(~mask & 0xFFFF) / 2;
+      for (uint32_t j = 0; j < prefix; ++j) {
+        aDest[i + j] = static_cast<char>(aSource[i + j]);
+      }
+      return i + prefix;
+    }
+
+    // All the high-order bytes are zero, so packing just grabs the
+    // low-order bytes, as in LossyConvertEncoding16to8 above.
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(aDest + i),
+                     _mm_packus_epi16(source, source));
+  }
+
+  return i;
+}
+
+uint32_t
+UTF16ASCIIRunLength_SSE2(const char16_t* aSource, uint32_t aSourceLength)
+{
+  uint32_t i = 0;
+
+  __m128i highbits = _mm_set1_epi16(int16_t(0xFF80));
+  for (; aSourceLength - i > 7; i += 8) {
+    __m128i source =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSource + i));
+
+    int mask =
+      _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(source, highbits),
+                                        _mm_setzero_si128()));
+    if (mask != 0xFFFF) {
+      return i + CountTrailingZeroes32(~mask & 0xFFFF) / 2;
+    }
+  }
+
+  return i;
+}
+
+} // namespace mozilla
@@ -0,0 +1,57 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/EventLoopLatencyLog.h"
+
+#include "plstr.h"
+
+namespace mozilla {
+
+static uint32_t
+DurationToUs(const TimeDuration& aDuration)
+{
+  double us = aDuration.ToMicroseconds();
+  if (us <= 0) {
+    return 0;
+  }
+  if (us >= double(UINT32_MAX)) {
+    return UINT32_MAX;
+  }
+  return uint32_t(us);
+}
+
+void
+EventLoopLatencyLog::Record(const char* aName, nsIRunnable* aRunnable,
+                            const TimeStamp& aDispatch,
+                            const TimeStamp& aStart, const TimeStamp& aEnd)
+{
+  Entry& entry = mEntries[mNextIndex % kEntryCount];
+
+  PL_strncpyz(entry.mName, aName ? aName : "(anonymous runnable)",
+              sizeof(entry.mName));
+  entry.mRunnable = aRunnable;
+  entry.mQueueLatencyUs =
+    aDispatch.IsNull() ? 0 : DurationToUs(aStart - aDispatch);
+  entry.mDurationUs = DurationToUs(aEnd - aStart);
+  entry.mEnd = aEnd;
+
+  mNextIndex = mNextIndex + 1;
+}
+
+uint32_t
+EventLoopLatencyLog::Snapshot(Entry* aEntries, uint32_t aCount) const
+{
+  uint32_t next = mNextIndex;
+  uint32_t available = next < kEntryCount ? next : kEntryCount;
+  uint32_t count = aCount < available ? aCount : available;
+
+  for (uint32_t i = 0; i < count; ++i) {
+    aEntries[i] = mEntries[(next - 1 - i) % kEntryCount];
+  }
+  return count;
+}
+
+} // namespace mozilla
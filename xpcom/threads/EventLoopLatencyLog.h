@@ -0,0 +1,100 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_EventLoopLatencyLog_h
+#define mozilla_EventLoopLatencyLog_h
+
+#include "mozilla/Atomics.h"
+#include "mozilla/TimeStamp.h"
+#include "nsISupports.h"
+
+class nsIRunnable;
+
+#define NS_IRUNNABLENAME_IID \
+  { 0x3d4c1788, 0x28a2, 0x4ec0, \
+    { 0x93, 0x5b, 0x71, 0x64, 0x2a, 0x0f, 0xc6, 0xe1 } }
+
+/**
+ * Runnables may implement this interface to give event-loop diagnostics a
+ * human-readable name; unnamed runnables show up as "(anonymous runnable)"
+ * with only their object address for identification.
+ *
+ * RunnableName() is called on the hot event-loop path, so it must be cheap:
+ * return a pointer to a string with static storage duration and do not
+ * allocate.
+ */
+class nsIRunnableName : public nsISupports
+{
+public:
+  NS_DECLARE_STATIC_IID_ACCESSOR(NS_IRUNNABLENAME_IID)
+
+  virtual const char* RunnableName() const = 0;
+};
+
+NS_DEFINE_STATIC_IID_ACCESSOR(nsIRunnableName, NS_IRUNNABLENAME_IID)
+
+namespace mozilla {
+
+/**
+ * A fixed-size log of the most recently executed events on a thread's event
+ * loop, recording for each event its name, the time it spent waiting in the
+ * event queue, and the time it took to run.  nsThread keeps one of these for
+ * the main thread, so that when jank is observed the runnables responsible
+ * for it can be identified after the fact.
+ *
+ * There is a single writer, the thread running the event loop, and writes
+ * never block or allocate.  Readers on other threads may call Snapshot() at
+ * any time; a snapshot can contain a torn entry for the slot being
+ * overwritten concurrently, which is acceptable for diagnostic output.
+ */
+class EventLoopLatencyLog
+{
+public:
+  struct Entry
+  {
+    // The runnable's name, null-terminated, possibly truncated.
+    char mName[56];
+    // The runnable's address.  Only an identity token; the object is
+    // typically dead by the time an entry is read, so never dereference.
+    void* mRunnable;
+    // Time spent in the event queue between dispatch and execution.
+    uint32_t mQueueLatencyUs;
+    // Time spent running the runnable.
+    uint32_t mDurationUs;
+    // When the runnable finished running.
+    TimeStamp mEnd;
+  };
+
+  // Must be a power of two; see Record().
+  static const uint32_t kEntryCount = 256;
+
+  EventLoopLatencyLog()
+    : mNextIndex(0)
+  {
+  }
+
+  // Append an entry for a runnable that just finished running.  Only the
+  // thread owning the event loop may call this.
+  void Record(const char* aName, nsIRunnable* aRunnable,
+              const TimeStamp& aDispatch, const TimeStamp& aStart,
+              const TimeStamp& aEnd);
+
+  // Copy up to aCount of the most recent entries into aEntries, newest
+  // first.  Returns the number of entries copied.  Safe to call from any
+  // thread.
+  uint32_t Snapshot(Entry* aEntries, uint32_t aCount) const;
+
+private:
+  Entry mEntries[kEntryCount];
+
+  // Total number of entries ever recorded.  The release ordering publishes
+  // each entry's fields before the index that makes it visible to readers.
+  Atomic<uint32_t, ReleaseAcquire> mNextIndex;
+};
+
+} // namespace mozilla
+
+#endif // mozilla_EventLoopLatencyLog_h
@@ -0,0 +1,316 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "WorkStealingThreadPool.h"
+#include "nsThread.h"
+#include "prlog.h"
+
+namespace mozilla {
+
+#ifdef PR_LOGGING
+static PRLogModuleInfo*
+GetWSPoolLog()
+{
+  static PRLogModuleInfo* sLog;
+  if (!sLog) {
+    sLog = PR_NewLogModule("WorkStealingThreadPool");
+  }
+  return sLog;
+}
+#endif
+#ifdef LOG
+#undef LOG
+#endif
+#define LOG(args) PR_LOG(GetWSPoolLog(), PR_LOG_DEBUG, args)
+
+NS_IMPL_ISUPPORTS(WorkStealingThreadPool, nsIEventTarget)
+
+// Bounces each worker thread into ThreadMain with its index.
+class WorkStealingThreadPool::WorkerMainEvent : public nsRunnable
+{
+public:
+  WorkerMainEvent(WorkStealingThreadPool* aPool, uint32_t aIndex)
+    : mPool(aPool)
+    , mIndex(aIndex)
+  {
+  }
+
+  NS_IMETHOD Run() MOZ_OVERRIDE
+  {
+    mPool->ThreadMain(mIndex);
+    return NS_OK;
+  }
+
+private:
+  nsRefPtr<WorkStealingThreadPool> mPool;
+  uint32_t mIndex;
+};
+
+WorkStealingThreadPool::WorkStealingThreadPool(const nsACString& aName)
+  : mName(aName)
+  , mMonitor("WorkStealingThreadPool.mMonitor")
+  , mShutdown(false)
+  , mNextQueue(0)
+{
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  MOZ_ASSERT(mShutdown || mWorkers.IsEmpty(),
+             "pool destroyed without Shutdown");
+}
+
+/* static */ already_AddRefed<WorkStealingThreadPool>
+WorkStealingThreadPool::Create(const nsACString& aName, uint32_t aThreadCount)
+{
+  nsRefPtr<WorkStealingThreadPool> pool = new WorkStealingThreadPool(aName);
+  if (NS_FAILED(pool->Init(aThreadCount ? aThreadCount : 1))) {
+    pool->Shutdown();
+    return nullptr;
+  }
+  return pool.forget();
+}
+
+nsresult
+WorkStealingThreadPool::Init(uint32_t aThreadCount)
+{
+  for (uint32_t i = 0; i < aThreadCount; ++i) {
+    mWorkers.AppendElement(new Worker());
+  }
+
+  // Spawn the threads only once every queue exists, so a worker never sees
+  // mWorkers grow under it.
+  for (uint32_t i = 0; i < aThreadCount; ++i) {
+    nsCOMPtr<nsIRunnable> event = new WorkerMainEvent(this, i);
+    nsresult rv = NS_NewThread(getter_AddRefs(mWorkers[i]->mThread), event);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return rv;
+    }
+  }
+  return NS_OK;
+}
+
+nsresult
+WorkStealingThreadPool::PutEvent(nsIRunnable* aEvent, uint32_t aIndex)
+{
+  MOZ_ASSERT(aIndex < mWorkers.Length());
+  Worker* worker = mWorkers[aIndex];
+  {
+    MutexAutoLock lock(worker->mLock);
+    // Checked under the queue lock so that Shutdown's final drain, which
+    // holds each queue lock after setting mShutdown, cannot miss this event.
+    if (NS_WARN_IF(mShutdown)) {
+      return NS_ERROR_NOT_AVAILABLE;
+    }
+    NS_ADDREF(aEvent);
+    worker->mQueue.Push(aEvent);
+  }
+
+  LOG(("WS-P(%p) put [q=%u]\n", this, aIndex));
+  MonitorAutoLock mon(mMonitor);
+  mon.Notify();
+  return NS_OK;
+}
+
+already_AddRefed<nsIRunnable>
+WorkStealingThreadPool::PopLocal(uint32_t aIndex)
+{
+  Worker* worker = mWorkers[aIndex];
+  MutexAutoLock lock(worker->mLock);
+  // Newest first: the most recently dispatched event's data is the most
+  // likely to still be in this core's cache.
+  nsCOMPtr<nsIRunnable> event =
+    dont_AddRef(static_cast<nsIRunnable*>(worker->mQueue.Pop()));
+  return event.forget();
+}
+
+already_AddRefed<nsIRunnable>
+WorkStealingThreadPool::Steal(uint32_t aIndex)
+{
+  uint32_t count = mWorkers.Length();
+  for (uint32_t i = 1; i < count; ++i) {
+    Worker* victim = mWorkers[(aIndex + i) % count];
+    MutexAutoLock lock(victim->mLock);
+    // Oldest first: steal from the cold end so the victim keeps its warm
+    // events.
+    nsCOMPtr<nsIRunnable> event =
+      dont_AddRef(static_cast<nsIRunnable*>(victim->mQueue.PopFront()));
+    if (event) {
+      LOG(("WS-P(%p) steal [%u <- %u]\n", this, aIndex,
+           (aIndex + i) % count));
+      return event.forget();
+    }
+  }
+  return nullptr;
+}
+
+bool
+WorkStealingThreadPool::HasQueuedEvent()
+{
+  for (uint32_t i = 0; i < mWorkers.Length(); ++i) {
+    MutexAutoLock lock(mWorkers[i]->mLock);
+    if (mWorkers[i]->mQueue.GetSize()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t
+WorkStealingThreadPool::CurrentThreadIndex()
+{
+  PRThread* current = PR_GetCurrentThread();
+  for (uint32_t i = 0; i < mWorkers.Length(); ++i) {
+    if (mWorkers[i]->mPRThread == current) {
+      return i;
+    }
+  }
+  return UINT32_MAX;
+}
+
+void
+WorkStealingThreadPool::ThreadMain(uint32_t aIndex)
+{
+  mThreadNaming.SetThreadPoolName(mName);
+  mWorkers[aIndex]->mPRThread = PR_GetCurrentThread();
+
+  LOG(("WS-P(%p) worker %u enter\n", this, aIndex));
+
+  for (;;) {
+    nsCOMPtr<nsIRunnable> event = PopLocal(aIndex);
+    if (!event) {
+      event = Steal(aIndex);
+    }
+    if (event) {
+      LOG(("WS-P(%p) worker %u running [%p]\n", this, aIndex, event.get()));
+      event->Run();
+      continue;
+    }
+
+    MonitorAutoLock mon(mMonitor);
+    // An event may have been dispatched between our last scan and taking the
+    // monitor; its Notify would have been lost, so look again before waiting.
+    if (HasQueuedEvent()) {
+      continue;
+    }
+    if (mShutdown) {
+      break;
+    }
+    mon.Wait();
+  }
+
+  LOG(("WS-P(%p) worker %u leave\n", this, aIndex));
+}
+
+NS_IMETHODIMP
+WorkStealingThreadPool::Dispatch(nsIRunnable* aEvent, uint32_t aFlags)
+{
+  LOG(("WS-P(%p) dispatch [%p %x]\n", this, aEvent, aFlags));
+
+  if (NS_WARN_IF(mShutdown)) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  if (aFlags & DISPATCH_SYNC) {
+    nsIThread* thread = NS_GetCurrentThread();
+    if (NS_WARN_IF(!thread)) {
+      return NS_ERROR_NOT_AVAILABLE;
+    }
+
+    nsRefPtr<nsThreadSyncDispatch> wrapper =
+      new nsThreadSyncDispatch(thread, aEvent);
+    nsresult rv = PutEvent(wrapper, mNextQueue++ % mWorkers.Length());
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+
+    while (wrapper->IsPending()) {
+      NS_ProcessNextEvent(thread);
+    }
+    return NS_OK;
+  }
+
+  NS_ASSERTION(aFlags == NS_DISPATCH_NORMAL, "unexpected dispatch flags");
+
+  // A worker dispatching to its own pool keeps the event local; it is the
+  // next thing it will pop, LIFO.  Everyone else round-robins across the
+  // queues.
+  uint32_t index = CurrentThreadIndex();
+  if (index == UINT32_MAX) {
+    index = mNextQueue++ % mWorkers.Length();
+  }
+  return PutEvent(aEvent, index);
+}
+
+nsresult
+WorkStealingThreadPool::DispatchWithAffinity(nsIRunnable* aEvent,
+                                             uint32_t aAffinityHint)
+{
+  LOG(("WS-P(%p) dispatch [%p hint=%u]\n", this, aEvent, aAffinityHint));
+
+  if (NS_WARN_IF(mShutdown)) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+  return PutEvent(aEvent, aAffinityHint % mWorkers.Length());
+}
+
+NS_IMETHODIMP
+WorkStealingThreadPool::IsOnCurrentThread(bool* aResult)
+{
+  if (NS_WARN_IF(mShutdown)) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+  *aResult = CurrentThreadIndex() != UINT32_MAX;
+  return NS_OK;
+}
+
+nsresult
+WorkStealingThreadPool::Shutdown()
+{
+  MOZ_ASSERT(CurrentThreadIndex() == UINT32_MAX,
+             "cannot shut down a pool from one of its own threads");
+
+  {
+    MonitorAutoLock mon(mMonitor);
+    if (mShutdown) {
+      return NS_OK;
+    }
+    mShutdown = true;
+    mon.NotifyAll();
+  }
+
+  // Workers drain every queue before exiting; shutting the threads down
+  // outside our locks avoids deadlocks with events that dispatch back here.
+  for (uint32_t i = 0; i < mWorkers.Length(); ++i) {
+    if (mWorkers[i]->mThread) {
+      mWorkers[i]->mThread->Shutdown();
+    }
+  }
+
+  // A dispatcher that passed the mShutdown check just as it was being set
+  // may have pushed after its queue's worker exited.  Its push and our pop
+  // order through the queue lock, so this drain is exhaustive.  Run the
+  // stragglers here, matching the "pending events run during shutdown"
+  // behavior of nsIThread.
+  for (uint32_t i = 0; i < mWorkers.Length(); ++i) {
+    for (;;) {
+      nsCOMPtr<nsIRunnable> event;
+      {
+        MutexAutoLock lock(mWorkers[i]->mLock);
+        event = dont_AddRef(
+          static_cast<nsIRunnable*>(mWorkers[i]->mQueue.PopFront()));
+      }
+      if (!event) {
+        break;
+      }
+      event->Run();
+    }
+  }
+
+  return NS_OK;
+}
+
+} // namespace mozilla
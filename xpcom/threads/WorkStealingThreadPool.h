@@ -0,0 +1,123 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_WorkStealingThreadPool_h
+#define mozilla_WorkStealingThreadPool_h
+
+#include "mozilla/Atomics.h"
+#include "mozilla/Attributes.h"
+#include "mozilla/Monitor.h"
+#include "mozilla/Mutex.h"
+#include "nsAutoPtr.h"
+#include "nsCOMPtr.h"
+#include "nsDeque.h"
+#include "nsIEventTarget.h"
+#include "nsIThread.h"
+#include "nsString.h"
+#include "nsTArray.h"
+#include "nsThreadUtils.h"
+#include "prthread.h"
+
+namespace mozilla {
+
+/**
+ * A fixed-size thread pool with a work queue per worker instead of
+ * nsThreadPool's single shared queue.  Dispatch pushes onto one worker's
+ * queue (round-robin, the dispatching worker's own queue, or the queue named
+ * by an affinity hint), touching only that queue's lock; a worker pops its
+ * own queue LIFO for cache locality and steals the oldest event from a
+ * sibling when its own queue runs dry.  This keeps short tasks from
+ * serializing every dispatch and every dequeue on one pool-wide lock.
+ *
+ * Unlike nsThreadPool the worker threads are spawned eagerly and never idle
+ * out, so this is meant for pools that see steady traffic, not for
+ * rarely-used ones.  Usable anywhere an nsIEventTarget is.
+ */
+class WorkStealingThreadPool MOZ_FINAL : public nsIEventTarget
+{
+public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+  NS_DECL_NSIEVENTTARGET
+
+  /**
+   * Creates the pool and spawns its worker threads.
+   *
+   * @param aName
+   *        The pool name, used to label the worker threads.
+   * @param aThreadCount
+   *        Number of workers to spawn.  Clamped to at least 1.
+   * @return the pool, or nullptr if thread creation failed.
+   */
+  static already_AddRefed<WorkStealingThreadPool>
+  Create(const nsACString& aName, uint32_t aThreadCount);
+
+  /**
+   * Like Dispatch(aEvent, NS_DISPATCH_NORMAL), but events dispatched with
+   * equal hints go to the same worker's queue, so related short tasks (e.g.
+   * decodes of the same image) tend to run on a warm thread.  The hint is
+   * reduced modulo the worker count; any value is valid.
+   */
+  nsresult DispatchWithAffinity(nsIRunnable* aEvent, uint32_t aAffinityHint);
+
+  /**
+   * Shuts down the pool, running any not-yet-started events first.  Must not
+   * be called from one of the pool's own threads.
+   */
+  nsresult Shutdown();
+
+private:
+  // One queue per worker.  mLock only guards mQueue; it is never held while
+  // acquiring mMonitor or another worker's lock.
+  struct Worker
+  {
+    Worker()
+      : mLock("WorkStealingThreadPool.Worker.mLock")
+      , mPRThread(nullptr)
+    {
+    }
+
+    Mutex mLock;
+    nsDeque mQueue;  // owns a reference to each queued nsIRunnable
+    nsCOMPtr<nsIThread> mThread;
+    // Written once by the worker before it starts pulling events; read to
+    // answer IsOnCurrentThread and to route same-thread dispatches.
+    Atomic<PRThread*> mPRThread;
+  };
+
+  explicit WorkStealingThreadPool(const nsACString& aName);
+  ~WorkStealingThreadPool();
+
+  nsresult Init(uint32_t aThreadCount);
+  nsresult PutEvent(nsIRunnable* aEvent, uint32_t aIndex);
+  void ThreadMain(uint32_t aIndex);
+
+  already_AddRefed<nsIRunnable> PopLocal(uint32_t aIndex);
+  already_AddRefed<nsIRunnable> Steal(uint32_t aIndex);
+  bool HasQueuedEvent();
+
+  // Returns the calling worker's index, or UINT32_MAX if the caller is not a
+  // pool thread.
+  uint32_t CurrentThreadIndex();
+
+  class WorkerMainEvent;
+  friend class WorkerMainEvent;
+
+  nsCString mName;
+  nsThreadPoolNaming mThreadNaming;
+
+  // Immutable after Init.
+  nsTArray<nsAutoPtr<Worker> > mWorkers;
+
+  // Idle workers block here; producers notify after linking an event in.
+  Monitor mMonitor;
+
+  Atomic<bool> mShutdown;
+  Atomic<uint32_t> mNextQueue;  // round-robin cursor for hintless dispatch
+};
+
+} // namespace mozilla
+
+#endif // mozilla_WorkStealingThreadPool_h
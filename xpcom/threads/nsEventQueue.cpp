@@ -29,13 +29,22 @@ GetLog()
 #endif
 #define LOG(args) PR_LOG(GetLog(), PR_LOG_DEBUG, args)
 
-nsEventQueue::nsEventQueue()
+nsEventQueue::nsEventQueue(QueueMode aMode)
   : mReentrantMonitor("nsEventQueue.mReentrantMonitor")
+  , mMode(aMode)
   , mHead(nullptr)
   , mTail(nullptr)
   , mOffsetHead(0)
   , mOffsetTail(0)
+  , mMPSCHead(nullptr)
+  , mMPSCTail(nullptr)
+  , mConsumerWaiting(false)
 {
+  if (mMode == eLockFreeMPSC) {
+    // The lock-free queue always contains at least a stub node.
+    mMPSCHead = new Node();
+    mMPSCTail = mMPSCHead;
+  }
 }
 
 nsEventQueue::~nsEventQueue()
@@ -45,14 +54,26 @@ nsEventQueue::~nsEventQueue()
   NS_ASSERTION(IsEmpty(),
                "Non-empty event queue being destroyed; events being leaked.");
 
-  if (mHead) {
+  if (mMode == eLockFreeMPSC) {
+    while (mMPSCHead) {
+      Node* dead = mMPSCHead;
+      mMPSCHead = dead->mNext;
+      NS_IF_RELEASE(dead->mEvent);
+      delete dead;
+    }
+  } else if (mHead) {
     FreePage(mHead);
   }
 }
 
 bool
-nsEventQueue::GetEvent(bool aMayWait, nsIRunnable** aResult)
+nsEventQueue::GetEvent(bool aMayWait, nsIRunnable** aResult,
+                       TimeStamp* aDispatchTime)
 {
+  if (mMode == eLockFreeMPSC) {
+    return GetEventLockFree(aMayWait, aResult, aDispatchTime);
+  }
+
   {
     ReentrantMonitorAutoEnter mon(mReentrantMonitor);
 
@@ -69,7 +90,11 @@ nsEventQueue::GetEvent(bool aMayWait, nsIRunnable** aResult)
     }
 
     if (aResult) {
-      *aResult = mHead->mEvents[mOffsetHead++];
+      Entry& entry = mHead->mEntries[mOffsetHead++];
+      *aResult = entry.mEvent;
+      if (aDispatchTime) {
+        *aDispatchTime = entry.mDispatchTime;
+      }
 
       // Check if mHead points to empty Page
       if (mOffsetHead == EVENTS_PER_PAGE) {
@@ -84,12 +109,75 @@ nsEventQueue::GetEvent(bool aMayWait, nsIRunnable** aResult)
   return true;
 }
 
+bool
+nsEventQueue::GetEventLockFree(bool aMayWait, nsIRunnable** aResult,
+                               TimeStamp* aDispatchTime)
+{
+  for (;;) {
+    Node* head = mMPSCHead;
+    Node* next = head->mNext;
+    if (next) {
+      if (aResult) {
+        // Take the event out of the next node and make that node the new
+        // stub; the old stub is done with.
+        mMPSCHead = next;
+        *aResult = next->mEvent;
+        if (aDispatchTime) {
+          *aDispatchTime = next->mDispatchTime;
+        }
+        next->mEvent = nullptr;
+        delete head;
+      }
+      return true;
+    }
+
+    if (!aMayWait) {
+      if (aResult) {
+        *aResult = nullptr;
+      }
+      return false;
+    }
+
+    LOG(("EVENTQ(%p): wait begin\n", this));
+    {
+      ReentrantMonitorAutoEnter mon(mReentrantMonitor);
+      mConsumerWaiting = true;
+      // Re-check now that producers can observe mConsumerWaiting; an event
+      // linked in just before the store above would otherwise never wake us.
+      if (!mMPSCHead->mNext) {
+        mon.Wait();
+      }
+      mConsumerWaiting = false;
+    }
+    LOG(("EVENTQ(%p): wait end\n", this));
+  }
+}
+
 void
-nsEventQueue::PutEvent(nsIRunnable* aRunnable)
+nsEventQueue::PutEventLockFree(nsIRunnable* aRunnable)
 {
-  // Avoid calling AddRef+Release while holding our monitor.
-  nsRefPtr<nsIRunnable> event(aRunnable);
+  Node* node = new Node();
+  node->mEvent = aRunnable;
+  NS_ADDREF(node->mEvent);
+  node->mDispatchTime = TimeStamp::Now();
+
+  // Publish the node.  Between the exchange and the link below the chain is
+  // momentarily disconnected: the consumer sees an empty queue and a
+  // competing producer parks its node behind ours, to become reachable once
+  // we store mNext.
+  Node* prev = mMPSCTail.exchange(node);
+  prev->mNext = node;
+
+  if (mConsumerWaiting) {
+    ReentrantMonitorAutoEnter mon(mReentrantMonitor);
+    LOG(("EVENTQ(%p): notify\n", this));
+    mon.NotifyAll();
+  }
+}
 
+void
+nsEventQueue::PutEvent(nsIRunnable* aRunnable)
+{
   if (ChaosMode::isActive(ChaosMode::ThreadScheduling)) {
     // With probability 0.5, yield so other threads have a chance to
     // dispatch events to this queue first.
@@ -98,6 +186,14 @@ nsEventQueue::PutEvent(nsIRunnable* aRunnable)
     }
   }
 
+  if (mMode == eLockFreeMPSC) {
+    PutEventLockFree(aRunnable);
+    return;
+  }
+
+  // Avoid calling AddRef+Release while holding our monitor.
+  nsRefPtr<nsIRunnable> event(aRunnable);
+
   ReentrantMonitorAutoEnter mon(mReentrantMonitor);
 
   if (!mHead) {
@@ -116,7 +212,9 @@ nsEventQueue::PutEvent(nsIRunnable* aRunnable)
     mOffsetTail = 0;
   }
 
-  event.swap(mTail->mEvents[mOffsetTail]);
+  Entry& entry = mTail->mEntries[mOffsetTail];
+  event.swap(entry.mEvent);
+  entry.mDispatchTime = TimeStamp::Now();
   ++mOffsetTail;
   LOG(("EVENTQ(%p): notify\n", this));
   mon.NotifyAll();
@@ -8,7 +8,9 @@
 #define nsEventQueue_h__
 
 #include <stdlib.h>
+#include "mozilla/Atomics.h"
 #include "mozilla/ReentrantMonitor.h"
+#include "mozilla/TimeStamp.h"
 #include "nsIRunnable.h"
 
 // A threadsafe FIFO event queue...
@@ -17,7 +19,22 @@ class nsEventQueue
   typedef mozilla::ReentrantMonitor ReentrantMonitor;
 
 public:
-  nsEventQueue();
+  enum QueueMode
+  {
+    // Any number of producers and consumers; every operation is serialized
+    // by the monitor.
+    eLockedQueue,
+    // Any number of producers, but a single consumer thread.  PutEvent is a
+    // lock-free exchange on the queue tail; the monitor is only taken to
+    // block in GetEvent(true) and to wake a blocked consumer.  Note that
+    // GetEvent(false, nullptr) may transiently report an empty queue while a
+    // producer is mid-enqueue, so emptiness checks that must be exact have
+    // to be externally synchronized against producers (as nsThread does with
+    // its lock).
+    eLockFreeMPSC
+  };
+
+  explicit nsEventQueue(QueueMode aMode = eLockedQueue);
   ~nsEventQueue();
 
   // This method adds a new event to the pending event queue.  The queue holds
@@ -30,8 +47,11 @@ public:
   // the event is null, then the method returns immediately indicating whether
   // or not an event is pending.  When the resulting event is non-null, the
   // caller is responsible for releasing the event object.  This method does
-  // not alter the reference count of the resulting event.
-  bool GetEvent(bool aMayWait, nsIRunnable** aEvent);
+  // not alter the reference count of the resulting event.  If aDispatchTime
+  // is non-null, it receives the time at which the event was put in the
+  // queue, so callers can compute how long the event sat waiting.
+  bool GetEvent(bool aMayWait, nsIRunnable** aEvent,
+                mozilla::TimeStamp* aDispatchTime = nullptr);
 
   // This method returns true if there is a pending event.
   bool HasPendingEvent()
@@ -45,7 +65,9 @@ public:
     return GetEvent(false, runnable);
   }
 
-  // Expose the event queue's monitor for "power users"
+  // Expose the event queue's monitor for "power users".  Only meaningful in
+  // eLockedQueue mode; in eLockFreeMPSC mode the monitor does not serialize
+  // access to the queue.
   ReentrantMonitor& GetReentrantMonitor()
   {
     return mReentrantMonitor;
@@ -55,12 +77,29 @@ private:
 
   bool IsEmpty()
   {
+    if (mMode == eLockFreeMPSC) {
+      return !mMPSCHead->mNext;
+    }
     return !mHead || (mHead == mTail && mOffsetHead == mOffsetTail);
   }
 
+  bool GetEventLockFree(bool aMayWait, nsIRunnable** aEvent,
+                        mozilla::TimeStamp* aDispatchTime);
+  void PutEventLockFree(nsIRunnable* aEvent);
+
+  // Each queued event carries the time it was dispatched, so the consumer
+  // can attribute queue latency to the runnables responsible for it.
+  struct Entry
+  {
+    nsIRunnable* mEvent;
+    mozilla::TimeStamp mDispatchTime;
+  };
+
   enum
   {
-    EVENTS_PER_PAGE = 255
+    // Pages are sized to (nearly) fill a page-sized allocator bucket.
+    PAGE_SIZE_BYTES = 4096,
+    EVENTS_PER_PAGE = (PAGE_SIZE_BYTES - sizeof(void*)) / sizeof(Entry)
   };
 
   // Page objects are linked together to form a simple deque.
@@ -68,11 +107,11 @@ private:
   struct Page
   {
     struct Page* mNext;
-    nsIRunnable* mEvents[EVENTS_PER_PAGE];
+    Entry mEntries[EVENTS_PER_PAGE];
   };
 
-  static_assert((sizeof(Page) & (sizeof(Page) - 1)) == 0,
-                "sizeof(Page) should be a power of two to avoid heap slop.");
+  static_assert(sizeof(Page) <= PAGE_SIZE_BYTES,
+                "sizeof(Page) should not exceed the allocator bucket size.");
 
   static Page* NewPage()
   {
@@ -84,13 +123,40 @@ private:
     free(aPage);
   }
 
+  // Nodes form a singly linked list in eLockFreeMPSC mode.  The node at
+  // mMPSCHead is a stub whose event has already been consumed; the next
+  // event, if any, lives in mMPSCHead->mNext.
+  struct Node
+  {
+    Node()
+      : mNext(nullptr)
+      , mEvent(nullptr)
+    {
+    }
+
+    mozilla::Atomic<Node*> mNext;
+    nsIRunnable* mEvent;
+    mozilla::TimeStamp mDispatchTime;
+  };
+
   ReentrantMonitor mReentrantMonitor;
 
+  const QueueMode mMode;
+
   Page* mHead;
   Page* mTail;
 
   uint16_t mOffsetHead;  // offset into mHead where next item is removed
   uint16_t mOffsetTail;  // offset into mTail where next item is added
+
+  // State for eLockFreeMPSC mode.  mMPSCHead is only touched by the consumer;
+  // producers race on mMPSCTail with an atomic exchange.
+  Node* mMPSCHead;
+  mozilla::Atomic<Node*> mMPSCTail;
+
+  // Set by the consumer (under the monitor) before blocking so producers know
+  // a wakeup is needed; producers skip taking the monitor otherwise.
+  mozilla::Atomic<bool> mConsumerWaiting;
 };
 
 #endif  // nsEventQueue_h__
@@ -22,6 +22,7 @@
 #include "pratom.h"
 #include "prlog.h"
 #include "nsIObserverService.h"
+#include "GeckoProfiler.h"
 #include "mozilla/HangMonitor.h"
 #include "mozilla/IOInterposer.h"
 #include "mozilla/ipc/MessageChannel.h"
@@ -447,6 +448,9 @@ nsThread::nsThread(MainThreadFlag aMainThread, uint32_t aStackSize)
   , mThreadStatusInfo(nullptr)
 #endif
 {
+  if (MAIN_THREAD == aMainThread) {
+    mLatencyLog = new mozilla::EventLoopLatencyLog();
+  }
 }
 
 nsThread::~nsThread()
@@ -501,8 +505,62 @@ nsThread::InitCurrentThread()
   return NS_OK;
 }
 
+// How many input lane events may run back-to-back while the normal lane has
+// events waiting.  This keeps a stream of input from starving timers and
+// other normal-priority work entirely.
+static const uint32_t kMaxInputEventRun = 8;
+
+bool
+nsThread::nsChainedEventQueue::GetEvent(bool aMayWait, nsIRunnable** aEvent,
+                                        TimeStamp* aDispatchTime)
+{
+  if (!aEvent) {
+    // The caller just wants to know whether an event is pending.
+    MOZ_ASSERT(!aMayWait);
+    return HasPendingEvent();
+  }
+
+  for (;;) {
+    // Drain the input lane first so user interaction jumps ahead of queued
+    // timer callbacks, but after kMaxInputEventRun consecutive input events
+    // give the normal lane a turn.
+    if (mInputEventRun >= kMaxInputEventRun &&
+        mQueue.GetEvent(false, aEvent, aDispatchTime)) {
+      mInputEventRun = 0;
+      return true;
+    }
+    if (mInputQueue.GetEvent(false, aEvent, aDispatchTime)) {
+      ++mInputEventRun;
+      return true;
+    }
+    mInputEventRun = 0;
+    if (mQueue.GetEvent(false, aEvent, aDispatchTime)) {
+      return true;
+    }
+
+    if (!aMayWait) {
+      *aEvent = nullptr;
+      return false;
+    }
+
+    // Both lanes were empty; block until a producer fills either one.  The
+    // flag-then-recheck dance mirrors nsEventQueue::GetEventLockFree: an
+    // event linked in just before the store below would otherwise never
+    // wake us.
+    {
+      ReentrantMonitorAutoEnter mon(mMonitor);
+      mConsumerWaiting = true;
+      if (!HasPendingEvent()) {
+        mon.Wait();
+      }
+      mConsumerWaiting = false;
+    }
+  }
+}
+
 nsresult
-nsThread::PutEvent(nsIRunnable* aEvent, nsNestedEventTarget* aTarget)
+nsThread::PutEvent(nsIRunnable* aEvent, nsNestedEventTarget* aTarget,
+                   bool aInputPriority)
 {
   nsCOMPtr<nsIThreadObserver> obs;
 
@@ -518,7 +576,7 @@ nsThread::PutEvent(nsIRunnable* aEvent, nsNestedEventTarget* aTarget)
       ReentrantMonitorAutoEnter mon(mThreadStatusMonitor);
       SetWorking();
 #endif // MOZ_NUWA_PROCESS
-      queue->PutEvent(aEvent);
+      queue->PutEvent(aEvent, aInputPriority);
 #ifdef MOZ_NUWA_PROCESS
     }
 #endif // MOZ_NUWA_PROCESS
@@ -582,8 +640,10 @@ nsThread::DispatchInternal(nsIRunnable* aEvent, uint32_t aFlags,
     return wrapper->Result();
   }
 
-  NS_ASSERTION(aFlags == NS_DISPATCH_NORMAL, "unexpected dispatch flags");
-  return PutEvent(aEvent, aTarget);
+  NS_ASSERTION(aFlags == NS_DISPATCH_NORMAL ||
+               aFlags == NS_DISPATCH_INPUT_PRIORITY,
+               "unexpected dispatch flags");
+  return PutEvent(aEvent, aTarget, aFlags == NS_DISPATCH_INPUT_PRIORITY);
 }
 
 //-----------------------------------------------------------------------------
@@ -843,7 +903,8 @@ nsThread::ProcessNextEvent(bool aMayWait, bool* aResult)
 
     // If we are shutting down, then do not wait for new events.
     nsCOMPtr<nsIRunnable> event;
-    mEvents->GetEvent(reallyWait, getter_AddRefs(event));
+    TimeStamp dispatchTime;
+    mEvents->GetEvent(reallyWait, getter_AddRefs(event), &dispatchTime);
 
     *aResult = (event.get() != nullptr);
 
@@ -851,8 +912,27 @@ nsThread::ProcessNextEvent(bool aMayWait, bool* aResult)
       LOG(("THRD(%p) running [%p]\n", this, event.get()));
       if (MAIN_THREAD == mIsMainThread) {
         HangMonitor::NotifyActivity();
+
+        // Record the event's queue latency and execution duration so the
+        // runnables responsible for jank can be identified after the fact.
+        const char* name = nullptr;
+        nsCOMPtr<nsIRunnableName> named = do_QueryInterface(event);
+        if (named) {
+          name = named->RunnableName();
+        }
+
+        profiler_tracing("Events", name ? name : "(anonymous runnable)",
+                         TRACING_INTERVAL_START);
+        TimeStamp start = TimeStamp::Now();
+        event->Run();
+        TimeStamp end = TimeStamp::Now();
+        profiler_tracing("Events", name ? name : "(anonymous runnable)",
+                         TRACING_INTERVAL_END);
+
+        mLatencyLog->Record(name, event, dispatchTime, start, end);
+      } else {
+        event->Run();
       }
-      event->Run();
     } else if (aMayWait) {
       MOZ_ASSERT(ShuttingDown(),
                  "This should only happen when shutting down");
@@ -7,6 +7,7 @@
 #ifndef nsThread_h__
 #define nsThread_h__
 
+#include "mozilla/EventLoopLatencyLog.h"
 #include "mozilla/Mutex.h"
 #include "nsIThreadInternal.h"
 #include "nsISupportsPriority.h"
@@ -66,6 +67,14 @@ public:
   static nsresult
   SetMainThreadObserver(nsIThreadObserver* aObserver);
 
+  // The log of recently executed events, or null if this thread doesn't
+  // keep one (only the main thread does).  The returned log is safe to
+  // Snapshot() from any thread for as long as this nsThread is alive.
+  mozilla::EventLoopLatencyLog* GetLatencyLog()
+  {
+    return mLatencyLog;
+  }
+
 #ifdef MOZ_NUWA_PROCESS
   void SetWorking();
   void SetIdle();
@@ -106,33 +115,53 @@ protected:
   {
     return mEvents->GetEvent(aMayWait, aEvent);
   }
-  nsresult PutEvent(nsIRunnable* aEvent, nsNestedEventTarget* aTarget);
+  nsresult PutEvent(nsIRunnable* aEvent, nsNestedEventTarget* aTarget,
+                    bool aInputPriority = false);
 
   nsresult DispatchInternal(nsIRunnable* aEvent, uint32_t aFlags,
                             nsNestedEventTarget* aTarget);
 
-  // Wrapper for nsEventQueue that supports chaining.
+  // Wrapper for nsEventQueue that supports chaining.  The queue only ever
+  // has one consumer (the thread itself), and producers are serialized
+  // against PopEventQueue and shutdown by mLock, so the lock-free MPSC queue
+  // mode is safe here and keeps cross-thread dispatch off the queue monitor.
+  //
+  // Events dispatched with NS_DISPATCH_INPUT_PRIORITY go into a separate
+  // input lane that GetEvent drains ahead of the normal lane, so user input
+  // is not stuck behind a backlog of timer callbacks and other normal work.
+  // A bound on the number of input events that may run back-to-back keeps a
+  // stream of input from starving the normal lane in turn.
   class nsChainedEventQueue
   {
   public:
     nsChainedEventQueue()
       : mNext(nullptr)
+      , mQueue(nsEventQueue::eLockFreeMPSC)
+      , mInputQueue(nsEventQueue::eLockFreeMPSC)
+      , mMonitor("nsChainedEventQueue.mMonitor")
+      , mConsumerWaiting(false)
+      , mInputEventRun(0)
     {
     }
 
-    bool GetEvent(bool aMayWait, nsIRunnable** aEvent)
-    {
-      return mQueue.GetEvent(aMayWait, aEvent);
-    }
+    bool GetEvent(bool aMayWait, nsIRunnable** aEvent,
+                  mozilla::TimeStamp* aDispatchTime = nullptr);
 
-    void PutEvent(nsIRunnable* aEvent)
+    void PutEvent(nsIRunnable* aEvent, bool aInputPriority = false)
     {
-      mQueue.PutEvent(aEvent);
+      (aInputPriority ? mInputQueue : mQueue).PutEvent(aEvent);
+      // A consumer blocked in GetEvent waits on our monitor rather than on
+      // either lane's, so that an event in one lane can wake a consumer
+      // that went to sleep with both lanes empty.
+      if (mConsumerWaiting) {
+        mozilla::ReentrantMonitorAutoEnter mon(mMonitor);
+        mon.NotifyAll();
+      }
     }
 
     bool HasPendingEvent()
     {
-      return mQueue.HasPendingEvent();
+      return mInputQueue.HasPendingEvent() || mQueue.HasPendingEvent();
     }
 
     nsChainedEventQueue* mNext;
@@ -140,6 +169,16 @@ protected:
 
   private:
     nsEventQueue mQueue;
+    nsEventQueue mInputQueue;
+
+    // Used only to block in GetEvent(true) and to wake a blocked consumer;
+    // same protocol as nsEventQueue's lock-free mode.
+    mozilla::ReentrantMonitor mMonitor;
+    mozilla::Atomic<bool> mConsumerWaiting;
+
+    // Number of consecutive input lane events returned by GetEvent; only
+    // touched by the consumer.
+    uint32_t mInputEventRun;
   };
 
   class nsNestedEventTarget MOZ_FINAL : public nsIEventTarget
@@ -180,6 +219,10 @@ protected:
   nsChainedEventQueue* mEvents;  // never null
   nsChainedEventQueue  mEventsRoot;
 
+  // Only non-null for the main thread.  Only written by the thread itself;
+  // see EventLoopLatencyLog for the cross-thread reading rules.
+  nsAutoPtr<mozilla::EventLoopLatencyLog> mLatencyLog;
+
   int32_t   mPriority;
   PRThread* mThread;
   uint32_t  mRunningEvent;  // counter
@@ -12,10 +12,14 @@
 #include "nsAutoPtr.h"
 #include "mozilla/ThreadLocal.h"
 #include "mozilla/ReentrantMonitor.h"
+#include "prenv.h"
 #ifdef MOZ_CANARY
 #include <fcntl.h>
 #include <unistd.h>
 #endif
+#ifdef XP_LINUX
+#include <sched.h>
+#endif
 
 using namespace mozilla;
 
@@ -95,6 +99,52 @@ ReleaseObject(void* aData)
   static_cast<nsISupports*>(aData)->Release();
 }
 
+// Parse a comma-separated list of logical CPU indices ("0,1,4") from the
+// environment into an allowed-CPU bitmask.  Returns 0 (no policy) if the
+// variable is unset, empty or malformed.
+static uint64_t
+ParseThreadClassCpuSet(const char* aEnvVar)
+{
+  const char* value = PR_GetEnv(aEnvVar);
+  if (!value || !*value) {
+    return 0;
+  }
+
+  uint64_t cpuSet = 0;
+  const char* p = value;
+  while (*p) {
+    char* end;
+    long cpu = strtol(p, &end, 10);
+    if (end == p || cpu < 0 || cpu >= 64) {
+      NS_WARNING("malformed thread-class CPU set; ignoring it");
+      return 0;
+    }
+    cpuSet |= uint64_t(1) << cpu;
+    p = (*end == ',') ? end + 1 : end;
+  }
+  return cpuSet;
+}
+
+// Restrict the calling thread to the CPUs in the given bitmask.  Only Linux
+// (including Android) and Windows expose a per-thread affinity call; other
+// platforms silently ignore the policy.
+static void
+ApplyThreadClassCpuSet(uint64_t aCpuSet)
+{
+#if defined(XP_LINUX)
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (uint32_t i = 0; i < 64; ++i) {
+    if (aCpuSet & (uint64_t(1) << i)) {
+      CPU_SET(i, &cpus);
+    }
+  }
+  sched_setaffinity(0, sizeof(cpus), &cpus);
+#elif defined(XP_WIN)
+  SetThreadAffinityMask(::GetCurrentThread(), static_cast<DWORD_PTR>(aCpuSet));
+#endif
+}
+
 #ifdef MOZ_NUWA_PROCESS
 void
 nsThreadManager::DeleteThreadStatusInfo(void* aData)
@@ -177,6 +227,16 @@ nsThreadManager::Init()
                    0;
 #endif
 
+  // Core-set policy for thread classes.  Deployments that care about thread
+  // placement (NUMA workstations, big.LITTLE boards) describe each class's
+  // core set in the environment; everyone else gets no pinning at all.
+  mThreadClassCpuSets[THREAD_CLASS_REALTIME_AUDIO] =
+    ParseThreadClassCpuSet("MOZ_THREAD_CLASS_AUDIO_CPUS");
+  mThreadClassCpuSets[THREAD_CLASS_COMPOSITOR] =
+    ParseThreadClassCpuSet("MOZ_THREAD_CLASS_COMPOSITOR_CPUS");
+  mThreadClassCpuSets[THREAD_CLASS_BACKGROUND_BULK] =
+    ParseThreadClassCpuSet("MOZ_THREAD_CLASS_BULK_CPUS");
+
   // Setup "main" thread
   mMainThread = new nsThread(nsThread::MAIN_THREAD, 0);
 
@@ -439,6 +499,21 @@ nsThreadManager::GetHighestNumberOfThreads()
   return mHighestNumberOfThreads;
 }
 
+void
+nsThreadManager::SetCurrentThreadClass(ThreadClass aClass)
+{
+  MOZ_ASSERT(aClass < THREAD_CLASS_COUNT);
+
+  if (!mInitialized) {
+    return;
+  }
+
+  uint64_t cpuSet = mThreadClassCpuSets[aClass];
+  if (cpuSet) {
+    ApplyThreadClassCpuSet(cpuSet);
+  }
+}
+
 #ifdef MOZ_NUWA_PROCESS
 void
 nsThreadManager::SetIgnoreThreadStatus()
@@ -34,6 +34,18 @@ public:
   };
 #endif // MOZ_NUWA_PROCESS
 
+  // Broad classes of threads that platform policy may pin to specific core
+  // sets, e.g. big cores on big.LITTLE parts for latency-sensitive work, or
+  // a single NUMA node for bulk work.  With no policy configured, the OS
+  // scheduler is left alone.
+  enum ThreadClass
+  {
+    THREAD_CLASS_REALTIME_AUDIO,
+    THREAD_CLASS_COMPOSITOR,
+    THREAD_CLASS_BACKGROUND_BULK,
+    THREAD_CLASS_COUNT
+  };
+
   NS_DECL_ISUPPORTS
   NS_DECL_NSITHREADMANAGER
 
@@ -65,6 +77,12 @@ public:
   // simultaneously during the execution of the thread manager.
   uint32_t GetHighestNumberOfThreads();
 
+  // Apply the core-set policy for the given class to the calling thread.
+  // Policy comes from the MOZ_THREAD_CLASS_{AUDIO,COMPOSITOR,BULK}_CPUS
+  // environment variables, each a comma-separated list of logical CPU
+  // indices; when a class has no policy this is a no-op.
+  void SetCurrentThreadClass(ThreadClass aClass);
+
   // This needs to be public in order to support static instantiation of this
   // class with older compilers (e.g., egcs-2.91.66).
   ~nsThreadManager()
@@ -126,6 +144,11 @@ private:
   // The highest number of threads encountered so far during the session
   uint32_t            mHighestNumberOfThreads;
 
+  // Allowed-CPU bitmask per thread class, 0 meaning no policy.  Filled in
+  // from the environment during Init and read-only afterwards, so threads
+  // applying a class need no locking.
+  uint64_t            mThreadClassCpuSets[THREAD_CLASS_COUNT];
+
 #ifdef MOZ_NUWA_PROCESS
   static void DeleteThreadStatusInfo(void *aData);
   unsigned mThreadStatusInfoIndex;
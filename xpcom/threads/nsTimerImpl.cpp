@@ -13,6 +13,7 @@
 #include "pratom.h"
 #include "GeckoProfiler.h"
 #include "mozilla/Atomics.h"
+#include "mozilla/EventLoopLatencyLog.h"
 #ifdef MOZ_NUWA_PROCESS
 #include "ipc/Nuwa.h"
 #endif
@@ -111,10 +112,17 @@ public:
 } // anonymous namespace
 
 class nsTimerEvent : public nsRunnable
+                   , public nsIRunnableName
 {
 public:
+  NS_DECL_ISUPPORTS_INHERITED
   NS_IMETHOD Run();
 
+  const char* RunnableName() const MOZ_OVERRIDE
+  {
+    return "nsTimerEvent";
+  }
+
   nsTimerEvent()
     : mTimer()
     , mGeneration(0)
@@ -178,6 +186,8 @@ TimerEventAllocator* nsTimerEvent::sAllocator = nullptr;
 Atomic<int32_t> nsTimerEvent::sAllocatorUsers;
 bool nsTimerEvent::sCanDeleteAllocator = false;
 
+NS_IMPL_ISUPPORTS_INHERITED(nsTimerEvent, nsRunnable, nsIRunnableName)
+
 namespace {
 
 void*